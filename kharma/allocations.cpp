@@ -0,0 +1,96 @@
+/* 
+ *  File: allocations.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2026, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "allocations.hpp"
+
+#include <iostream>
+#include <map>
+
+namespace Allocations {
+
+static int warmup_cycle = 0;
+static bool counting = false;
+static std::map<std::string, std::pair<long, double>> allocations;
+
+// Space names reported by Kokkos for host memory.  Everything else counts as device memory
+static bool IsHostSpace(const char *name)
+{
+    const std::string space(name);
+    return space == "Host" || space == "HostSpace" || space.find("HostPinned") != std::string::npos;
+}
+
+static void AllocateCallback(const Kokkos::Profiling::SpaceHandle handle, const char *label,
+                             const void *ptr, const uint64_t size)
+{
+    if (!counting || IsHostSpace(handle.name)) return;
+    auto &entry = allocations[std::string(label) + " (" + handle.name + ")"];
+    entry.first++;
+    entry.second += size;
+}
+
+void Start(int warmup)
+{
+    warmup_cycle = warmup;
+    counting = (warmup <= 0);
+    Kokkos::Tools::Experimental::set_allocate_data_callback(AllocateCallback);
+}
+
+void SetCycle(int ncycle)
+{
+    counting = (ncycle >= warmup_cycle);
+}
+
+void Report()
+{
+    counting = false;
+    long nlocal = 0;
+    for (const auto &entry : allocations) nlocal += entry.second.first;
+    long ntotal = nlocal;
+#ifdef MPI_PARALLEL
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &ntotal, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD));
+#endif
+    if (MPIRank0()) {
+        std::cout << "Device allocations after step " << warmup_cycle << ": " << ntotal
+                  << " over all ranks" << std::endl;
+    }
+    // Only ranks which allocated have anything to say
+    if (nlocal > 0) {
+        for (const auto &entry : allocations) {
+            std::cout << "  rank " << MPIRank() << ": " << entry.first << ": " << entry.second.first
+                      << " allocations, " << entry.second.second / entry.second.first << " bytes each on average" << std::endl;
+        }
+    }
+}
+
+}
@@ -0,0 +1,113 @@
+/* 
+ *  File: allocations.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2026, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+
+#include <string>
+#include <vector>
+
+/**
+ * Tools for keeping the step loop free of device allocations, which are slow (and on GPUs,
+ * synchronizing) compared to the kernels they usually feed.
+ *
+ * PersistentArray keeps a device array between calls, growing it only when needed.
+ * The tracker, enabled with debug/track_allocations=true, counts any device allocation made
+ * after debug/track_allocations_warmup steps, and reports them by label at the end of the run.
+ * It registers itself as a Kokkos Tools allocation callback, so it can't be used alongside
+ * a Kokkos Tools library loaded with KOKKOS_TOOLS_LIBS.
+ */
+namespace Allocations {
+
+/**
+ * Start counting device allocations once step 'warmup' is reached, see SetCycle
+ */
+void Start(int warmup);
+
+/**
+ * Record the current step.  Called from KHARMA::PostStepWork
+ */
+void SetCycle(int ncycle);
+
+/**
+ * Print the allocations made after warmup on any rank, by label.
+ * Takes the MPI sum over ranks, so must be called on all ranks.
+ */
+void Report();
+
+/**
+ * A device array kept between calls, for scratch space and short lists (e.g. of block indices)
+ * needed by kernels each step.  Only reallocated when asked for more elements than it has,
+ * so steady-state steps don't allocate.  Usually held as a mutable package Param.
+ */
+template<typename T>
+class PersistentArray {
+    public:
+        PersistentArray() = default;
+        explicit PersistentArray(const std::string& label) : label(label) {}
+
+        /**
+         * Get the array with at least n elements, contents undefined
+         */
+        const ParArray1D<T>& Get(const int n)
+        {
+            if (arr.extent_int(0) < n || arr.extent_int(0) == 0)
+                arr = ParArray1D<T>(label, m::max(n, 1));
+            return arr;
+        }
+
+        /**
+         * Get the array holding a copy of vals.  Skips the copy if vals is unchanged since
+         * the last call, as block lists usually are between remeshes.
+         */
+        const ParArray1D<T>& Set(const std::vector<T>& vals)
+        {
+            const int n = vals.size();
+            const bool grown = arr.extent_int(0) < n || arr.extent_int(0) == 0;
+            Get(n);
+            if (n > 0 && (grown || vals != last)) {
+                Kokkos::View<const T*, Kokkos::HostSpace, Kokkos::MemoryUnmanaged> vals_h(vals.data(), n);
+                Kokkos::deep_copy(Kokkos::subview(arr, std::make_pair(0, n)), vals_h);
+            }
+            last = vals;
+            return arr;
+        }
+
+    private:
+        std::string label;
+        std::vector<T> last;
+        ParArray1D<T> arr;
+};
+
+}
@@ -0,0 +1,350 @@
+/* 
+ *  File: analysis_grid.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "analysis_grid.hpp"
+
+#include "domain.hpp"
+#include "interpolation.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+/**
+ * Kerr-Schild spherical (r, th, phi) <-> Cartesian (x, y, z), as used by the CartKS embedding.
+ * With a = 0 these are the usual flat-space relations.
+ */
+KOKKOS_INLINE_FUNCTION void sph_to_cart(const GReal& a, const GReal sph[3], GReal cart[3])
+{
+    const GReal r = sph[0], sth = m::sin(sph[1]), cth = m::cos(sph[1]);
+    const GReal sph_ = m::sin(sph[2]), cph = m::cos(sph[2]);
+    cart[0] = (r * cph - a * sph_) * sth;
+    cart[1] = (r * sph_ + a * cph) * sth;
+    cart[2] = r * cth;
+}
+KOKKOS_INLINE_FUNCTION void cart_to_sph(const GReal& a, const GReal cart[3], GReal sph[3])
+{
+    const GReal R2 = cart[0]*cart[0] + cart[1]*cart[1] + cart[2]*cart[2];
+    const GReal w = R2 - a*a;
+    const GReal r = m::sqrt(m::max((w + m::sqrt(w*w + 4*a*a*cart[2]*cart[2])) / 2, 1.e-20));
+    sph[0] = r;
+    sph[1] = m::acos(m::min(m::max(cart[2] / r, -1.), 1.));
+    GReal phi = m::atan2(cart[1], cart[0]) - m::atan2(a, r);
+    if (phi < 0) phi += 2*M_PI;
+    if (phi >= 2*M_PI) phi -= 2*M_PI;
+    sph[2] = phi;
+}
+/**
+ * Jacobian d(x, y, z)/d(r, th, phi) of the above
+ */
+KOKKOS_INLINE_FUNCTION void dcart_dsph(const GReal& a, const GReal sph[3], GReal J[3][3])
+{
+    const GReal r = sph[0], sth = m::sin(sph[1]), cth = m::cos(sph[1]);
+    const GReal sph_ = m::sin(sph[2]), cph = m::cos(sph[2]);
+    J[0][0] = cph * sth; J[0][1] = (r * cph - a * sph_) * cth; J[0][2] = -(r * sph_ + a * cph) * sth;
+    J[1][0] = sph_ * sth; J[1][1] = (r * sph_ + a * cph) * cth; J[1][2] = (r * cph - a * sph_) * sth;
+    J[2][0] = cth;        J[2][1] = -r * sth;                   J[2][2] = 0.;
+}
+
+std::shared_ptr<KHARMAPackage> AnalysisGrid::Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages)
+{
+    auto pkg = std::make_shared<KHARMAPackage>("AnalysisGrid");
+    Params &params = pkg->AllParams();
+
+    // Options
+    const Real dt = pin->GetOrAddReal("analysis_grid", "dt", 10.);
+    if (dt <= 0.) throw std::invalid_argument("analysis_grid/dt must be positive!");
+    params.Add("dt", dt);
+    params.Add("file", pin->GetOrAddString("analysis_grid", "file", "analysis"));
+
+    const std::string type = pin->GetOrAddString("analysis_grid", "type", "spherical");
+    if (type != "spherical" && type != "cartesian")
+        throw std::invalid_argument("analysis_grid/type must be spherical or cartesian!");
+    params.Add("cartesian", type == "cartesian");
+
+    const int n1 = pin->GetOrAddInteger("analysis_grid", "n1", 128);
+    const int n2 = pin->GetOrAddInteger("analysis_grid", "n2", (type == "cartesian") ? 128 : 64);
+    const int n3 = pin->GetOrAddInteger("analysis_grid", "n3", (type == "cartesian") ? 128 : 64);
+    if (n1 < 1 || n2 < 1 || n3 < 1)
+        throw std::invalid_argument("analysis_grid/n1,n2,n3 must be positive!");
+    params.Add("n1", n1);
+    params.Add("n2", n2);
+    params.Add("n3", n3);
+
+    // Extent: radii for spherical grids, half-width for Cartesian ones
+    const bool has_r = pin->DoesParameterExist("coordinates", "r_out");
+    const Real r_max_default = has_r ? pin->GetReal("coordinates", "r_out") : pin->GetReal("parthenon/mesh", "x1max");
+    const Real r_min_default = pin->DoesParameterExist("coordinates", "r_in") ? pin->GetReal("coordinates", "r_in") : 1.;
+    const Real r_min = pin->GetOrAddReal("analysis_grid", "r_min", r_min_default);
+    const Real r_max = pin->GetOrAddReal("analysis_grid", "r_max", r_max_default);
+    const bool log_r = pin->GetOrAddBoolean("analysis_grid", "log_r", true);
+    if (r_max <= r_min || (log_r && r_min <= 0.))
+        throw std::invalid_argument("analysis_grid/r_min,r_max must be increasing, and positive for log_r!");
+    params.Add("r_min", r_min);
+    params.Add("r_max", r_max);
+    params.Add("log_r", log_r);
+    const Real extent = pin->GetOrAddReal("analysis_grid", "extent", r_max_default);
+    if (extent <= 0.) throw std::invalid_argument("analysis_grid/extent must be positive!");
+    params.Add("extent", extent);
+
+    // Variables, as in in_situ/variables.  prims.uvec & prims.B are transformed to the grid's basis
+    const std::string var_list = pin->GetOrAddString("analysis_grid", "variables", "prims.rho,prims.u,prims.uvec,prims.B");
+    std::vector<std::string> names;
+    std::stringstream ss(var_list);
+    std::string var;
+    while (std::getline(ss, var, ',')) {
+        var.erase(0, var.find_first_not_of(" \t"));
+        var.erase(var.find_last_not_of(" \t") + 1);
+        if (!var.empty()) names.push_back(var);
+    }
+    if (names.empty()) throw std::invalid_argument("analysis_grid/variables lists no fields!");
+    params.Add("variables", names);
+
+    // Next snapshot time & number, starting from the current time on restarts
+    params.Add("t_next", pin->GetOrAddReal("parthenon/time", "start_time", 0.), true);
+    params.Add("n_next", 0, true);
+    // Interpolated values, before the reduction to rank 0
+    params.Add("buffer", Allocations::PersistentArray<Real>("analysis_grid_buffer"), true);
+
+    pkg->PostStepWork = AnalysisGrid::PostStepWork;
+
+    return pkg;
+}
+
+void AnalysisGrid::PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+    auto& params = pmesh->packages.Get("AnalysisGrid")->AllParams();
+    // tm.time & tm.ncycle are incremented after this call
+    const Real time = tm.time + tm.dt;
+    Real t_next = params.Get<Real>("t_next");
+    if (time < t_next) return;
+
+    auto md = pmesh->mesh_data.Get().get();
+    WriteSnapshot(md, time, tm.ncycle + 1);
+
+    // Skip any snapshots we stepped over
+    const Real dt = params.Get<Real>("dt");
+    while (t_next <= time) t_next += dt;
+    params.Update<Real>("t_next", t_next);
+    params.Update<int>("n_next", params.Get<int>("n_next") + 1);
+}
+
+void AnalysisGrid::WriteSnapshot(MeshData<Real> *md, const Real time, const int ncycle)
+{
+    Flag("AnalysisGrid");
+    auto pmesh = md->GetMeshPointer();
+    auto& params = pmesh->packages.Get("AnalysisGrid")->AllParams();
+    const bool cartesian = params.Get<bool>("cartesian");
+    const int n1 = params.Get<int>("n1"), n2 = params.Get<int>("n2"), n3 = params.Get<int>("n3");
+    const GReal r_min = params.Get<Real>("r_min"), r_max = params.Get<Real>("r_max");
+    const bool log_r = params.Get<bool>("log_r");
+    const GReal extent = params.Get<Real>("extent");
+    const auto& names = params.Get<std::vector<std::string>>("variables");
+
+    // Pack everything we interpolate, and record where each variable starts & whether it's a vector
+    PackIndexMap var_map;
+    auto V = md->PackVariables(names, var_map);
+    // Labels in pack order, one per component
+    const int nvar = V.GetDim(4);
+    std::vector<std::string> labels(nvar);
+    std::vector<int> vec_starts;
+    for (auto& name : names) {
+        const auto idx = var_map[name];
+        if (idx.first < 0)
+            throw std::runtime_error("Analysis grid variable "+name+" does not exist!");
+        const int ncomp = idx.second - idx.first + 1;
+        const bool is_vector = (name == "prims.uvec" || name == "prims.B");
+        if (is_vector && ncomp != NVEC)
+            throw std::runtime_error("Analysis grid vector "+name+" must have 3 components!");
+        if (is_vector) vec_starts.push_back(idx.first);
+        for (int c = 0; c < ncomp; c++)
+            labels[idx.first + c] = (ncomp > 1) ? name + "_" + std::to_string(c + 1) : name;
+    }
+    // At most the two vectors above
+    const int nvec = vec_starts.size();
+    const int vec0 = (nvec > 0) ? vec_starts[0] : -1;
+    const int vec1 = (nvec > 1) ? vec_starts[1] : -1;
+
+    const int npts = n1 * n2 * n3;
+    // Output, as out[v * npts + n], zero where no local block holds the point
+    const auto out = params.GetMutable<Allocations::PersistentArray<Real>>("buffer")->Get(nvar * npts);
+    Kokkos::deep_copy(out, 0.);
+
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const IndexRange3 b = KDomain::GetRange(md, IndexDomain::interior);
+    const int nblocks = V.GetDim(5);
+    const bool active2 = pmesh->ndim > 1, active3 = pmesh->ndim > 2;
+
+    // Grid zone centers
+    const GReal x1l = cartesian ? -extent : (log_r ? m::log(r_min) : r_min);
+    const GReal dx1 = cartesian ? 2*extent / n1 : ((log_r ? m::log(r_max) : r_max) - x1l) / n1;
+    const GReal x2l = cartesian ? -extent : 0.;
+    const GReal dx2 = cartesian ? 2*extent / n2 : M_PI / n2;
+    const GReal x3l = cartesian ? -extent : 0.;
+    const GReal dx3 = cartesian ? 2*extent / n3 : 2*M_PI / n3;
+
+    pmb0->par_for("analysis_grid_interp", 0, npts - 1,
+        KOKKOS_LAMBDA (const int& n) {
+            const int gi = n % n1, gj = (n / n1) % n2, gk = n / (n1 * n2);
+            const auto& G0 = V.GetCoords(0);
+            const bool sph_embed = G0.coords.is_spherical();
+            const GReal a = G0.coords.get_a();
+
+            // Point in both spherical & Cartesian forms of the embedding
+            GReal sph[3], cart[3];
+            if (cartesian) {
+                cart[0] = x1l + (gi + 0.5) * dx1;
+                cart[1] = x2l + (gj + 0.5) * dx2;
+                cart[2] = x3l + (gk + 0.5) * dx3;
+                cart_to_sph(a, cart, sph);
+            } else {
+                const GReal x1 = x1l + (gi + 0.5) * dx1;
+                sph[0] = log_r ? m::exp(x1) : x1;
+                sph[1] = x2l + (gj + 0.5) * dx2;
+                sph[2] = x3l + (gk + 0.5) * dx3;
+                sph_to_cart(a, sph, cart);
+            }
+            GReal Xembed[GR_DIM] = {0.}, X[GR_DIM];
+            for (int d = 0; d < 3; d++) Xembed[d + 1] = sph_embed ? sph[d] : cart[d];
+            G0.coords.coord_to_native(Xembed, X);
+
+            // Find the block owning this point.  Inactive dimensions always match
+            for (int bl = 0; bl < nblocks; bl++) {
+                const auto& G = V.GetCoords(bl);
+                if (X[1] < G.Xf<1>(b.is) || X[1] >= G.Xf<1>(b.ie + 1)) continue;
+                if (active2 && (X[2] < G.Xf<2>(b.js) || X[2] >= G.Xf<2>(b.je + 1))) continue;
+                if (active3 && (X[3] < G.Xf<3>(b.ks) || X[3] >= G.Xf<3>(b.ke + 1))) continue;
+
+                // Interpolate from zone centers, including ghost zones at block edges
+                const GReal startx[GR_DIM] = {0., G.Xf<1>(0), G.Xf<2>(0), G.Xf<3>(0)};
+                const GReal dx[GR_DIM] = {0., G.Dxc<1>(b.is), G.Dxc<2>(b.js), G.Dxc<3>(b.ks)};
+                int i, j, k;
+                GReal del[GR_DIM];
+                Interpolation::Xtoijk(X, startx, dx, i, j, k, del);
+                if (!active2) { j = 0; del[2] = 0.; }
+                if (!active3) { k = 0; del[3] = 0.; }
+                const auto& var = V(bl);
+                for (int p = 0; p < nvar; p++)
+                    out(p * npts + n) = Interpolation::linear(i, j, k, 1, active2 ? 2 : 1, active3 ? 2 : 1, del, var, p);
+
+                // Vectors: native -> embedding -> grid basis
+                if (nvec > 0) {
+                    GReal dxdX[GR_DIM][GR_DIM], J[3][3];
+                    G.coords.dxdX(X, dxdX);
+                    const bool to_cart = cartesian && sph_embed;
+                    const bool to_sph = !cartesian && !sph_embed;
+                    if (to_cart || to_sph) dcart_dsph(a, sph, J);
+                    for (int v = 0; v < nvec; v++) {
+                        const int vs = (v == 0) ? vec0 : vec1;
+                        GReal ve[3] = {0., 0., 0.}, vg[3];
+                        for (int mu = 0; mu < 3; mu++)
+                            for (int nu = 0; nu < 3; nu++)
+                                ve[mu] += dxdX[mu + 1][nu + 1] * out((vs + nu) * npts + n);
+                        if (to_cart) {
+                            for (int mu = 0; mu < 3; mu++)
+                                vg[mu] = J[mu][0] * ve[0] + J[mu][1] * ve[1] + J[mu][2] * ve[2];
+                        } else if (to_sph) {
+                            // Solve J vg = ve by Cramer's rule
+                            const GReal det = J[0][0] * (J[1][1] * J[2][2] - J[1][2] * J[2][1])
+                                            - J[0][1] * (J[1][0] * J[2][2] - J[1][2] * J[2][0])
+                                            + J[0][2] * (J[1][0] * J[2][1] - J[1][1] * J[2][0]);
+                            for (int mu = 0; mu < 3; mu++) {
+                                GReal M[3][3];
+                                for (int r = 0; r < 3; r++)
+                                    for (int c = 0; c < 3; c++)
+                                        M[r][c] = (c == mu) ? ve[r] : J[r][c];
+                                vg[mu] = (M[0][0] * (M[1][1] * M[2][2] - M[1][2] * M[2][1])
+                                        - M[0][1] * (M[1][0] * M[2][2] - M[1][2] * M[2][0])
+                                        + M[0][2] * (M[1][0] * M[2][1] - M[1][1] * M[2][0])) / det;
+                            }
+                        } else {
+                            for (int mu = 0; mu < 3; mu++) vg[mu] = ve[mu];
+                        }
+                        for (int mu = 0; mu < 3; mu++) out((vs + mu) * npts + n) = vg[mu];
+                    }
+                }
+                // Blocks don't overlap
+                break;
+            }
+        }
+    );
+
+    // Each point was filled by exactly one rank, so a sum gathers the grid
+    auto out_h = out.GetHostMirrorAndCopy();
+    std::vector<Real> data(out_h.data(), out_h.data() + nvar * npts);
+#ifdef MPI_PARALLEL
+    if (MPIRank0()) {
+        PARTHENON_MPI_CHECK(MPI_Reduce(MPI_IN_PLACE, data.data(), data.size(), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD));
+    } else {
+        PARTHENON_MPI_CHECK(MPI_Reduce(data.data(), nullptr, data.size(), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD));
+    }
+#endif
+
+    if (MPIRank0()) {
+        std::stringstream fname;
+        fname << params.Get<std::string>("file") << "." << std::setfill('0') << std::setw(5)
+              << params.Get<int>("n_next") << ".bin";
+        std::ofstream f(fname.str(), std::ios::binary);
+        if (!f) throw std::runtime_error("Could not open analysis grid file "+fname.str()+"!");
+        auto put_int = [&f](const int x) { f.write(reinterpret_cast<const char*>(&x), sizeof(int)); };
+        auto put_double = [&f](const double x) { f.write(reinterpret_cast<const char*>(&x), sizeof(double)); };
+        put_int(0x4b414731);
+        put_int(cartesian ? 1 : 0);
+        put_int((!cartesian && log_r) ? 1 : 0);
+        put_int(ncycle);
+        put_double(time);
+        put_int(n1); put_int(n2); put_int(n3);
+        if (cartesian) {
+            for (int d = 0; d < 3; d++) { put_double(-extent); put_double(extent); }
+        } else {
+            put_double(r_min); put_double(r_max);
+            put_double(0.); put_double(M_PI);
+            put_double(0.); put_double(2*M_PI);
+        }
+        put_int(nvar);
+        for (auto& label : labels) {
+            char name[32] = {0};
+            label.copy(name, 31);
+            f.write(name, 32);
+        }
+        // Points are stored i-fastest, matching [v][k][j][i]
+        std::vector<float> buf(npts);
+        for (int v = 0; v < nvar; v++) {
+            for (int n = 0; n < npts; n++) buf[n] = data[v * npts + n];
+            f.write(reinterpret_cast<const char*>(buf.data()), npts * sizeof(float));
+        }
+    }
+
+    EndFlag();
+}
@@ -0,0 +1,78 @@
+/* 
+ *  File: analysis_grid.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+#include "types.hpp"
+
+#include <parthenon/parthenon.hpp>
+
+/**
+ * Snapshots of selected cell-centered variables interpolated onto a uniform analysis grid, e.g.
+ * for ray-tracing post-processing, without remapping dumps offline.
+ *
+ * Every analysis_grid/dt, each rank interpolates the variables listed in analysis_grid/variables
+ * (trilinearly, from any of its blocks, including after refinement) at the points of the grid which
+ * fall in its blocks, on the device.  The results are summed onto rank 0, which writes them to
+ * <analysis_grid/file>.<NNNNN>.bin.  The grid is either:
+ * 1. spherical: n1 x n2 x n3 zone centers in (r, th, phi) of the embedding (e.g. KS), over
+ *    [r_min, r_max] (log-spaced if log_r) x [0, pi] x [0, 2pi)
+ * 2. cartesian: zone centers in (x, y, z) over [-extent, extent] in each direction.  Around a black hole
+ *    these are Cartesian Kerr-Schild coordinates, x + iy = (r + ia) sin(th) e^(i phi), z = r cos(th)
+ * Vector components (prims.uvec, prims.B) are transformed to the basis of the grid.  Points outside the
+ * mesh are zero.
+ *
+ * Files hold, in native byte order: int magic 0x4b414731, int type (0 spherical, 1 cartesian),
+ * int log_r (1 if radii are log-spaced), int ncycle, double time, int n1, n2, n3, double lower & upper
+ * bounds in each direction, int nvar, then for each component a 32-byte zero-padded name, then float32
+ * data as [v][k][j][i].
+ */
+namespace AnalysisGrid {
+
+/**
+ * Initialize the analysis grid package, loaded if analysis_grid/on
+ */
+std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages);
+
+/**
+ * Interpolate & write a snapshot, if one is due
+ */
+void PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+
+/**
+ * Interpolate the variables of every local block of md onto the analysis grid, and write them from rank 0
+ */
+void WriteSnapshot(MeshData<Real> *md, const Real time, const int ncycle);
+
+}
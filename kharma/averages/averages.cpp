@@ -0,0 +1,165 @@
+/* 
+ *  File: averages.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "averages.hpp"
+
+#include "domain.hpp"
+#include "grmhd_functions.hpp"
+
+#include <sstream>
+
+std::shared_ptr<KHARMAPackage> Averages::Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages)
+{
+    auto pkg = std::make_shared<KHARMAPackage>("Averages");
+    Params &params = pkg->AllParams();
+
+    // Options
+    // Comma-separated list of quantities to average.  prims.uvec & prims.B are vectors, others scalars
+    const std::string var_list = pin->GetOrAddString("averages", "variables", "prims.rho,prims.u,bsq,mdot");
+    // Steps between samples
+    const int cadence = pin->GetOrAddInteger("averages", "cadence", 1);
+    if (cadence < 1)
+        throw std::invalid_argument("averages/cadence must be positive!");
+    params.Add("cadence", cadence);
+    // Time to start averaging, e.g. once the disk has settled
+    params.Add("t_start", pin->GetOrAddReal("averages", "t_start", 0.));
+    const bool second_moments = pin->GetOrAddBoolean("averages", "second_moments", false);
+    params.Add("second_moments", second_moments);
+
+    std::vector<std::string> sources, names;
+    std::stringstream ss(var_list);
+    std::string var;
+    while (std::getline(ss, var, ',')) {
+        // Trim any whitespace
+        var.erase(0, var.find_first_not_of(" \t"));
+        var.erase(var.find_last_not_of(" \t") + 1);
+        if (var.empty()) continue;
+        // Name after the last dot: prims.rho -> avg.rho
+        sources.push_back(var);
+        names.push_back(var.substr(var.rfind('.') + 1));
+    }
+    params.Add("sources", sources);
+    params.Add("names", names);
+
+    // Total time averaged so far, and the time of the last sample (negative before the first)
+    params.Add("weight", 0., true);
+    params.Add("t_last", -1., true);
+
+    // Fields: written to outputs & restarts, but never synchronized
+    Metadata::AddUserFlag("Averages");
+    std::vector<MetadataFlag> flags_avg = {Metadata::Real, Metadata::Cell, Metadata::Derived,
+                                           Metadata::OneCopy, Metadata::Restart, Metadata::GetUserFlag("Averages")};
+    std::vector<int> s_vector({NVEC});
+    for (int v = 0; v < names.size(); v++) {
+        const bool is_vector = (sources[v] == "prims.uvec" || sources[v] == "prims.B");
+        const Metadata m = (is_vector) ? Metadata(flags_avg, s_vector) : Metadata(flags_avg);
+        pkg->AddField("avg." + names[v], m);
+        if (second_moments) pkg->AddField("avg2." + names[v], m);
+    }
+
+    pkg->PostStepWork = Averages::PostStepWork;
+
+    return pkg;
+}
+
+void Averages::PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+    auto& params = pmesh->packages.Get("Averages")->AllParams();
+    // tm.time is incremented after this call
+    const Real time = tm.time + tm.dt;
+    const Real t_start = params.Get<Real>("t_start");
+    if (time <= t_start || (tm.ncycle + 1) % params.Get<int>("cadence") != 0) return;
+    Flag("UpdateAverages");
+
+    // Weight each sample by the time since the last, so the cadence can be coarse
+    Real t_last = params.Get<Real>("t_last");
+    if (t_last < 0.) t_last = m::max(t_start, tm.time);
+    const Real w = time - t_last;
+    const Real weight = params.Get<Real>("weight") + w;
+    params.Update<Real>("t_last", time);
+    params.Update<Real>("weight", weight);
+    if (weight <= 0.) {
+        EndFlag();
+        return;
+    }
+    // Running means: <q> += (q - <q>) * w / W, which takes the first sample whole
+    const Real frac = w / weight;
+
+    const auto& sources = params.Get<std::vector<std::string>>("sources");
+    const auto& names = params.Get<std::vector<std::string>>("names");
+    const bool second_moments = params.Get<bool>("second_moments");
+
+    auto md = pmesh->mesh_data.Get().get();
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    PackIndexMap prims_map;
+    auto P = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    const VarMap m_p(prims_map, false);
+
+    const IndexRange3 b = KDomain::GetRange(md, IndexDomain::interior);
+    const IndexRange block = IndexRange{0, P.GetDim(5) - 1};
+
+    for (int v = 0; v < names.size(); v++) {
+        auto avg = md->PackVariables(std::vector<std::string>{"avg." + names[v]});
+        // Empty unless averages/second_moments
+        auto avg2 = md->PackVariables(std::vector<std::string>{"avg2." + names[v]});
+        if (sources[v] == "bsq" || sources[v] == "mdot") {
+            const bool is_bsq = (sources[v] == "bsq");
+            pmb0->par_for("average_" + names[v], block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+                KOKKOS_LAMBDA (const int& bl, const int &k, const int &j, const int &i) {
+                    const auto& G = P.GetCoords(bl);
+                    FourVectors D;
+                    GRMHD::calc_4vecs(G, P(bl), m_p, k, j, i, Loci::center, D);
+                    const Real q = (is_bsq) ? dot(D.bcon, D.bcov)
+                                            : G.gdet(Loci::center, j, i) * P(bl, m_p.RHO, k, j, i) * D.ucon[1];
+                    avg(bl, 0, k, j, i) += (q - avg(bl, 0, k, j, i)) * frac;
+                    if (second_moments) avg2(bl, 0, k, j, i) += (q*q - avg2(bl, 0, k, j, i)) * frac;
+                }
+            );
+        } else {
+            auto src = md->PackVariables(std::vector<std::string>{sources[v]});
+            // A source which doesn't exist in this run packs empty, and is skipped here
+            const int nvar = m::min(src.GetDim(4), avg.GetDim(4));
+            if (nvar < 1) continue;
+            pmb0->par_for("average_" + names[v], block.s, block.e, 0, nvar - 1, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+                KOKKOS_LAMBDA (const int& bl, const int &p, const int &k, const int &j, const int &i) {
+                    const Real q = src(bl, p, k, j, i);
+                    avg(bl, p, k, j, i) += (q - avg(bl, p, k, j, i)) * frac;
+                    if (second_moments) avg2(bl, p, k, j, i) += (q*q - avg2(bl, p, k, j, i)) * frac;
+                }
+            );
+        }
+    }
+
+    EndFlag();
+}
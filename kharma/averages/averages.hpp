@@ -0,0 +1,65 @@
+/* 
+ *  File: averages.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+#include "types.hpp"
+
+#include <parthenon/parthenon.hpp>
+
+/**
+ * Running time averages of selected fields, accumulated on the device so that long runs
+ * need not write dumps at high cadence just to average them afterward.
+ *
+ * Each quantity listed in averages/variables gets a field "avg.<name>" (e.g. avg.rho for prims.rho),
+ * and with averages/second_moments also "avg2.<name>", the mean of its square.  Quantities are any
+ * cell-centered variable, or one of the derived "bsq" (b^2) and "mdot" (gdet rho u^1).
+ * Every averages/cadence steps after averages/t_start, the means are updated in place, weighting each
+ * sample by the time since the last.  List the fields in an output block with a long dt: they
+ * are always written in the final output at the end of the run.
+ * The fields are restarted, so Parthenon restarts continue the averages, other restarts begin them anew.
+ */
+namespace Averages {
+
+/**
+ * Initialize the averaged fields and options
+ */
+std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages);
+
+/**
+ * Fold the state at the end of the step into the averages, if a sample is due
+ */
+void PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+
+}
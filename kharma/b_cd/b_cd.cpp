@@ -56,7 +56,7 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
     // Accumulator for maximum ctop within an MPI process
     // That is, this value does NOT generally reflect the actual maximum
     params.Add("ctop_max", 0.0, true);
-    // Maximum between MPI processes, updated after each step; that is, always a maximum.
+    // Maximum between MPI processes, updated with the global timestep after each step; that is, always a maximum.
     params.Add("ctop_max_last", 0.0, true);
 
     std::vector<int> s_vector({NVEC});
@@ -88,9 +88,9 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
     pkg->AddSource = B_CD::AddSource;
 
     pkg->BlockUtoP = B_CD::BlockUtoP;
+    pkg->MeshUtoP = B_CD::MeshUtoP;
 
     pkg->PostStepDiagnosticsMesh = B_CD::PostStepDiagnostics;
-    pkg->PostStepWork = B_CD::UpdateCtopMax;
 
     // List (vector) of HistoryOutputVar that will all be enrolled as output variables
     parthenon::HstVar_list hst_vars = {};
@@ -128,6 +128,32 @@ void BlockUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse)
     );
 }
 
+void MeshUtoP(MeshData<Real> *md, IndexDomain domain, bool coarse)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+
+    const auto& B_U = md->PackVariables(std::vector<std::string>{"cons.B"});
+    const auto& B_P = md->PackVariables(std::vector<std::string>{"prims.B"});
+    const auto& psi_U = md->PackVariables(std::vector<std::string>{"cons.psi_cd"});
+    const auto& psi_P = md->PackVariables(std::vector<std::string>{"prims.psi_cd"});
+
+    auto bounds = coarse ? pmb0->c_cellbounds : pmb0->cellbounds;
+    IndexRange ib = bounds.GetBoundsI(domain);
+    IndexRange jb = bounds.GetBoundsJ(domain);
+    IndexRange kb = bounds.GetBoundsK(domain);
+    IndexRange block = IndexRange{0, B_U.GetDim(5)-1};
+    pmb0->par_for("UtoP_B", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int &b, const int &k, const int &j, const int &i) {
+            const auto& G = B_U.GetCoords(b);
+            // Update the primitive B-fields
+            Real gdet = G.gdet(Loci::center, j, i);
+            VLOOP B_P(b, v, k, j, i) = B_U(b, v, k, j, i) / gdet;
+            // Update psi as well
+            psi_P(b, 0, k, j, i) = psi_U(b, 0, k, j, i) / gdet;
+        }
+    );
+}
+
 TaskStatus AddSource(MeshData<Real> *md, MeshData<Real> *mdudt)
 {
     auto pmesh = md->GetMeshPointer();
@@ -268,19 +294,12 @@ void FillOutput(MeshBlock *pmb, ParameterInput *pin)
     );
 }
 
-void UpdateCtopMax(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+void UpdateCtopMax(Mesh *pmesh, const Real& ctop_max_global)
 {
-    // TODO use new Reductions stuff for this
-    // Reduce and record the maximum sound speed on the grid, to propagate
-    // phi at that speed next step.
-    // Just needs to run after every step, so we use the KHARMA callback at that point.
-    // auto& params = pmesh->packages.Get("B_CD")->AllParams();
-    // static AllReduce<Real> ctop_max_last_r;
-    // ctop_max_last_r.val = params.Get<Real>("ctop_max");
-    // ctop_max_last_r.StartReduce(MPI_MAX);
-    // while (ctop_max_last_r.CheckReduce() == TaskStatus::incomplete);
-    // params.Update<Real>("ctop_max_last", ctop_max_last_r.val);
-    // params.Update<Real>("ctop_max", 0.0); // Reset for next max calculation
+    // Propagate phi at the maximum sound speed on the grid next step
+    auto& params = pmesh->packages.Get("B_CD")->AllParams();
+    params.Update<Real>("ctop_max_last", ctop_max_global);
+    params.Update<Real>("ctop_max", 0.0); // Reset for next max calculation
 }
 
 } // namespace B_CD
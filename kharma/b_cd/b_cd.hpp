@@ -66,6 +66,7 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
  * output: Primitive B = B^i
  */
 void BlockUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse=false);
+void MeshUtoP(MeshData<Real> *md, IndexDomain domain, bool coarse=false);
 
 /**
  * Add the source term to dUdt, before it is applied to U
@@ -81,10 +82,11 @@ TaskStatus AddSource(MeshData<Real> *md, MeshData<Real> *mdudt);
 Real MaxDivB(MeshData<Real> *md);
 
 /**
- * Find the maximum wavespeed across the whole grid, to use in propagating
- * the phi field.
+ * Record the maximum wavespeed across the whole grid, to use in propagating
+ * the phi field next step, and reset the per-process accumulator.
+ * The global maximum is taken alongside the timestep, in KHARMADriver::SetGlobalTimeStep
  */
-void UpdateCtopMax(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+void UpdateCtopMax(Mesh *pmesh, const Real& ctop_max_global);
 
 /**
  * Diagnostics printed/computed after each step
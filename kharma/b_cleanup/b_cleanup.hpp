@@ -72,6 +72,19 @@ bool CleanupThisStep(Mesh* pmesh, int nstep);
  */
 TaskStatus CornerLaplacian(MeshData<Real>* md, const std::string& p_var, MeshData<Real>* md_again, const std::string& lap_var);
 
+/**
+ * Fill diag_var with the diagonal of the operator applied by CornerLaplacian,
+ * for preconditioning the solve (see b_cleanup/precondition_sweeps)
+ */
+TaskStatus CornerLaplacianDiagonal(MeshData<Real>* md, const std::string& diag_var);
+
+/**
+ * Fill solve_mask for a local solve (see b_cleanup/local): 1 on corners of blocks with divB
+ * over local_threshold and local_halo_blocks layers of their neighbors, 0 elsewhere and on the edge.
+ * RHS_divB must hold the raw divergence.
+ */
+TaskStatus SetSolveMask(std::shared_ptr<MeshData<Real>>& msolve);
+
 /**
  * Apply B -= grad(P) to subtract divergence from the magnetic field
  */
@@ -47,11 +47,17 @@ class BiCGStabSolver : BiCGStabCounter {
         sp_accessor(sp), max_iters(pkg->Param<int>("bicgstab_max_iterations")),
         check_interval(pkg->Param<int>("bicgstab_check_interval")),
         fail_flag(pkg->Param<bool>("bicgstab_abort_on_fail")),
-        warn_flag(pkg->Param<bool>("bicgstab_warn_on_fail")), aux_vars(aux_vars) {
+        warn_flag(pkg->Param<bool>("bicgstab_warn_on_fail")),
+        precon_sweeps(pkg->Param<int>("bicgstab_precondition_sweeps")),
+        precon_weight(pkg->Param<Real>("bicgstab_precondition_weight")),
+        warm_start(pkg->Param<bool>("bicgstab_warm_start")),
+        pipelined(pkg->Param<bool>("bicgstab_pipelined")), aux_vars(aux_vars) {
     Init(pkg, user_flags);
   }
   std::vector<std::string> SolverState() const {
     std::vector<std::string> vars{spm_name, rhs_name, res, res0, vk, pk, tk, temp};
+    if (precon_sweeps > 0) vars.insert(vars.end(), {pkhat, skhat, az, diag});
+    if (pipelined) vars.insert(vars.end(), {wk, sk, zk, qk, yk});
     vars.insert(vars.end(), aux_vars.begin(), aux_vars.end());
     return vars;
   }
@@ -81,6 +87,9 @@ class BiCGStabSolver : BiCGStabCounter {
   FMatVec user_precomm_MatVec;
   FScale user_precomm_scale;
   FScale user_postcomm_scale;
+  // Fills the named variable with the diagonal of the operator applied by user_MatVec.
+  // Required if bicgstab_precondition_sweeps > 0, see Precondition below
+  FScale user_Diagonal;
 
   std::vector<std::string> aux_vars;
 
@@ -118,6 +127,38 @@ class BiCGStabSolver : BiCGStabCounter {
     pkg->AddField(res, meta);
     pkg->AddField(temp, meta);
 
+    // Preconditioned search directions, which the operator is applied to,
+    // and the operator's diagonal & a temporary for the smoothing sweeps
+    pkhat = "pkhat" + bicg_id;
+    skhat = "skhat" + bicg_id;
+    az = "az" + bicg_id;
+    diag = "diag" + bicg_id;
+    if (precon_sweeps > 0) {
+      pkg->AddField(pkhat, meta);
+      pkg->AddField(skhat, meta);
+      meta = Metadata(base_flags);
+      pkg->AddField(az, meta);
+      pkg->AddField(diag, meta);
+    }
+
+    // Extra recurrences of the pipelined variant: w = A r, s = A p, z = A s, and q, y.
+    // Only w & z are operands of the Laplacian, and need ghost zones
+    wk = "wk" + bicg_id;
+    sk = "sk" + bicg_id;
+    zk = "zk" + bicg_id;
+    qk = "qk" + bicg_id;
+    yk = "yk" + bicg_id;
+    if (pipelined) {
+      PARTHENON_REQUIRE_THROWS(precon_sweeps == 0, "Pipelined BiCGStab does not support preconditioning!");
+      meta = Metadata(ghost_flags);
+      pkg->AddField(wk, meta);
+      pkg->AddField(zk, meta);
+      meta = Metadata(base_flags);
+      pkg->AddField(sk, meta);
+      pkg->AddField(qk, meta);
+      pkg->AddField(yk, meta);
+    }
+
     global_num_bicgstab_solvers++;
   }
 
@@ -138,6 +179,9 @@ class BiCGStabSolver : BiCGStabCounter {
     r0_dot_vk.val = 0.0;
     t_dot_s.val = 0.0;
     t_dot_t.val = 0.0;
+    init_dots.val = std::vector<Real>(2, 0.0);
+    qy_dots.val = std::vector<Real>(2, 0.0);
+    r_dots.val = std::vector<Real>(5, 0.0);
 
     auto MatVec = [this](auto &task_list, const TaskID &init_depend,
                          std::shared_ptr<MeshData<Real>> &spmd,
@@ -200,7 +244,33 @@ class BiCGStabSolver : BiCGStabCounter {
       return update_rhs;
     };
 
-    auto get_init = MatVec(tl, begin, md, rhs_name, vk);
+    // Right preconditioning by a fixed number of damped Jacobi sweeps on A z = r, starting from z = 0.
+    // This is a fixed polynomial in D^{-1} A, so BiCGStab sees a constant preconditioned operator.
+    // Each sweep past the first costs a MatVec, but the sweeps need no global reductions.
+    auto Precondition = [this, &MatVec](auto &task_list, const TaskID &init_depend,
+                                        std::shared_ptr<MeshData<Real>> &spmd,
+                                        const std::string &name_in, const std::string &name_out) {
+      auto sweep = task_list.AddTask(init_depend, &Solver_t::JacobiSweep<MD_t>, this,
+                                     spmd.get(), name_in, name_out, true);
+      for (int n = 1; n < this->precon_sweeps; ++n) {
+        auto get_az = MatVec(task_list, sweep, spmd, name_out, this->az);
+        sweep = task_list.AddTask(get_az, &Solver_t::JacobiSweep<MD_t>, this,
+                                  spmd.get(), name_in, name_out, false);
+      }
+      return sweep;
+    };
+    const bool precon = precon_sweeps > 0;
+    const std::string &pk_dir = precon ? pkhat : pk;
+    const std::string &sk_dir = precon ? skhat : res;
+
+    auto get_diag = begin;
+    if (precon) {
+      PARTHENON_REQUIRE_THROWS(user_Diagonal, "BiCGStab preconditioning requires a user_Diagonal function!");
+      get_diag = tl.AddTask(begin, user_Diagonal, md.get(), diag);
+    }
+
+    // When warm-starting, the initial residual needs A x_0.  Note this requires md == mout
+    auto get_init = MatVec(tl, get_diag, md, warm_start ? sol_name : rhs_name, vk);
 
     auto init_bicgstab = tl.AddTask(get_init, &Solver_t::InitializeBiCGStab<MD_t>, this,
                                     md.get(), mout.get(), &global_res0.val);
@@ -214,6 +284,10 @@ class BiCGStabSolver : BiCGStabCounter {
         tl.AddTask(start_global_res0, &AllReduce<Real>::CheckReduce, &global_res0);
     tr.AddRegionalDependencies(reg.ID(), i, finish_global_res0);
 
+    if (pipelined)
+      return CreatePipelinedTaskList(init_bicgstab | finish_global_res0, i, tr, solver, md,
+                                     mout, reg, MatVec);
+
     // 1. \hat{r}_0 \cdot r_{i-1}
     auto get_rhoi = solver.AddTask(init_bicgstab, &Solver_t::DotProduct<MD_t>, this,
                                    md.get(), res0, res, &rhoi.val);
@@ -229,8 +303,9 @@ class BiCGStabSolver : BiCGStabCounter {
     auto update_pk =
         solver.AddTask(finish_global_rhoi, &Solver_t::Compute_pk<MD_t>, this, md.get());
 
-    // 4. v = A p
-    auto get_v = MatVec(solver, update_pk, md, pk, vk);
+    // 4. v = A M^{-1} p
+    auto get_phat = precon ? Precondition(solver, update_pk, md, pk, pkhat) : update_pk;
+    auto get_v = MatVec(solver, get_phat, md, pk_dir, vk);
 
     // 5. alpha = rho_i / (\hat{r}_0 \cdot v_i) [Actually just calculate \hat{r}_0 \cdot
     // v_i]
@@ -249,10 +324,11 @@ class BiCGStabSolver : BiCGStabCounter {
     // 7. check for convergence [Not actually done]
     // 8. s = r_{i-1} - alpha v
     auto get_s = solver.AddTask(finish_global_r0dotv, &Solver_t::Update_h_and_s<MD_t>,
-                                this, md.get(), mout.get());
+                                this, md.get(), mout.get(), pk_dir);
 
-    // 9. t = A s
-    auto get_t = MatVec(solver, get_s, md, res, tk);
+    // 9. t = A M^{-1} s
+    auto get_shat = precon ? Precondition(solver, get_s, md, res, skhat) : get_s;
+    auto get_t = MatVec(solver, get_shat, md, sk_dir, tk);
 
     // 10. omega = (t \cdot s) / (t \cdot t)
     auto get_tdots = solver.AddTask(get_t, &Solver_t::OmegaDotProd<MD_t>, this, md.get(),
@@ -275,7 +351,7 @@ class BiCGStabSolver : BiCGStabCounter {
     // 11. update x and residual
     auto update_x = solver.AddTask(finish_global_tdots | finish_global_tdott,
                                    &Solver_t::Update_x_res<MD_t>, this, md.get(),
-                                   mout.get(), &global_res.val);
+                                   mout.get(), sk_dir, &global_res.val);
     tr.AddRegionalDependencies(reg.ID(), i, update_x);
     auto start_global_res =
         (i == 0 ? solver.AddTask(update_x, &AllReduce<Real>::StartReduce, &global_res,
@@ -292,6 +368,88 @@ class BiCGStabSolver : BiCGStabCounter {
     return check;
   }
 
+  // Pipelined BiCGStab (Cools & Vanroose 2017), without preconditioning.  Extra recurrences for
+  // w = A r, s = A p, z = A s let each iteration's dot products be merged into two reductions,
+  // each started before, and overlapped with, one of the two Laplacians
+  template <typename FMatVecTasks>
+  TaskID CreatePipelinedTaskList(const TaskID &begin, const int i, TaskRegion &tr,
+                                 IterativeTasks &solver, std::shared_ptr<MeshData<Real>> md,
+                                 std::shared_ptr<MeshData<Real>> mout, RegionCounter &reg,
+                                 FMatVecTasks &MatVec) {
+    using Solver_t = BiCGStabSolver<SPType>;
+    using MD_t = MeshData<Real>;
+    using AllReduceVec = AllReduce<std::vector<Real>>;
+    TaskList &tl = tr[i];
+
+    // w_0 = A r_0, then (r_0, r_0) & (r_0, w_0) overlapped with t_0 = A w_0
+    auto get_w = MatVec(tl, begin, md, res, wk);
+    auto init_dots_local = tl.AddTask(get_w, &Solver_t::InitializePipelined<MD_t>, this,
+                                      md.get(), &init_dots.val);
+    tr.AddRegionalDependencies(reg.ID(), i, init_dots_local);
+    auto start_init_dots =
+        (i == 0 ? tl.AddTask(init_dots_local, &AllReduceVec::StartReduce, &init_dots, MPI_SUM)
+                : init_dots_local);
+    auto finish_init_dots =
+        tl.AddTask(start_init_dots, &AllReduceVec::CheckReduce, &init_dots);
+    auto get_t0 = MatVec(tl, init_dots_local, md, wk, tk);
+
+    // 1. p, s, z recurrences; q = r - alpha s, y = w - alpha z
+    // 2. (q, y) & (y, y), overlapped with v = A z
+    auto update_q = solver.AddTask(finish_init_dots | get_t0, &Solver_t::Update_pszqy<MD_t>,
+                                   this, md.get(), &qy_dots.val);
+    tr.AddRegionalDependencies(reg.ID(), i, update_q);
+    auto start_qy =
+        (i == 0 ? solver.AddTask(update_q, &AllReduceVec::StartReduce, &qy_dots, MPI_SUM)
+                : update_q);
+    auto finish_qy = solver.AddTask(start_qy, &AllReduceVec::CheckReduce, &qy_dots);
+    auto get_v = MatVec(solver, update_q, md, zk, vk);
+
+    // 3. omega = (q, y) / (y, y); update x, r = q - omega y, w = y - omega (t - alpha v)
+    // 4. (r_0, r), (r_0, w), (r_0, s), (r_0, z) and (r, r), overlapped with t = A w
+    auto update_x = solver.AddTask(finish_qy | get_v, &Solver_t::Update_xrw<MD_t>, this,
+                                   md.get(), mout.get(), &r_dots.val);
+    tr.AddRegionalDependencies(reg.ID(), i, update_x);
+    auto start_r =
+        (i == 0 ? solver.AddTask(update_x, &AllReduceVec::StartReduce, &r_dots, MPI_SUM)
+                : update_x);
+    auto finish_r = solver.AddTask(start_r, &AllReduceVec::CheckReduce, &r_dots);
+    auto get_t = MatVec(solver, update_x, md, wk, tk);
+
+    // 5. beta & the next alpha, check for convergence
+    auto check = solver.SetCompletionTask(finish_r | get_t,
+                                          &Solver_t::CheckConvergencePipelined, this, i, true);
+    tr.AddGlobalDependencies(reg.ID(), i, check);
+
+    return check;
+  }
+
+  // Local part of (vec1, vec2), over the same nodes as DotProduct
+  template <typename T>
+  Real LocalDot(T *u, const std::string &vec1, const std::string &vec2) {
+    const auto &ibi = u->GetBoundsI(IndexDomain::interior);
+    const auto &jbi = u->GetBoundsJ(IndexDomain::interior);
+    const auto &kbi = u->GetBoundsK(IndexDomain::interior);
+    const int ndim = u->GetMeshPointer()->ndim;
+    const auto ib = IndexRange{ibi.s, ibi.e + (ndim > 0)};
+    const auto jb = IndexRange{jbi.s, jbi.e + (ndim > 1)};
+    const auto kb = IndexRange{kbi.s, kbi.e + (ndim > 2)};
+
+    PackIndexMap imap;
+    auto &v = u->PackVariables(std::vector<std::string>({vec1, vec2}), imap);
+    const int iv1 = imap[vec1].first;
+    const int iv2 = imap[vec2].first;
+
+    Real gsum(0);
+    par_reduce(
+        loop_pattern_mdrange_tag, "LocalDot", DevExecSpace(), 0, v.GetDim(5) - 1, kb.s,
+        kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int b, const int k, const int j, const int i, Real &lsum) {
+          lsum += v(b, iv1, k, j, i) * v(b, iv2, k, j, i);
+        },
+        Kokkos::Sum<Real>(gsum));
+    return gsum;
+  }
+
  public:
   template <typename T>
   TaskStatus InitializeBiCGStab(T *u, T *du, Real *gres0) {
@@ -318,14 +476,16 @@ class BiCGStabSolver : BiCGStabCounter {
     alpha_old = 1.0;
     omega_old = 1.0;
     Real err(0);
-    const Real fac0 = 0.0;
-    const Real fac = 0.0;
+    // With warm_start, keep the existing solution as the initial guess: vk holds A x_0
+    const bool warm = warm_start;
+    const Real fac0 = warm ? 1.0 : 0.0;
+    const Real fac = warm ? 1.0 : 0.0;
     par_reduce(
         loop_pattern_mdrange_tag, "initialize bicgstab", DevExecSpace(), 0,
         v.GetDim(5) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA(const int b, const int k, const int j, const int i, Real &lerr) {
           // initialize guess for solution
-          dv(b, 0, k, j, i) = fac * v(b, irhs, k, j, i);
+          if (!warm) dv(b, 0, k, j, i) = 0.0;
 
           v(b, ires, k, j, i) = v(b, irhs, k, j, i) - fac * v(b, ivk, k, j, i);
           v(b, ires0, k, j, i) = v(b, irhs, k, j, i) - fac0 * v(b, ivk, k, j, i);
@@ -466,7 +626,7 @@ class BiCGStabSolver : BiCGStabCounter {
   }
 
   template <typename T>
-  TaskStatus Update_h_and_s(T *u, T *du) {
+  TaskStatus Update_h_and_s(T *u, T *du, const std::string &pk_dir) {
     const auto &ibi = u->GetBoundsI(IndexDomain::interior);
     const auto &jbi = u->GetBoundsJ(IndexDomain::interior);
     const auto &kbi = u->GetBoundsK(IndexDomain::interior);
@@ -476,10 +636,10 @@ class BiCGStabSolver : BiCGStabCounter {
     const auto kb = IndexRange{kbi.s, kbi.e + (ndim > 2)};
 
     PackIndexMap imap;
-    auto &v = u->PackVariables(std::vector<std::string>({res, pk, vk}), imap);
+    auto &v = u->PackVariables(std::vector<std::string>({res, pk_dir, vk}), imap);
     auto &dv = du->PackVariables(std::vector<std::string>({sol_name}));
     const int ires = imap[res].first;
-    const int ipk = imap[pk].first;
+    const int ipk = imap[pk_dir].first;
     const int ivk = imap[vk].first;
 
     Real alpha = rhoi.val / r0_dot_vk.val;
@@ -583,7 +743,7 @@ class BiCGStabSolver : BiCGStabCounter {
   }
 
   template <typename T>
-  TaskStatus Update_x_res(T *u, T *du, Real *gres) {
+  TaskStatus Update_x_res(T *u, T *du, const std::string &sk_dir, Real *gres) {
     const auto &ibi = u->GetBoundsI(IndexDomain::interior);
     const auto &jbi = u->GetBoundsJ(IndexDomain::interior);
     const auto &kbi = u->GetBoundsK(IndexDomain::interior);
@@ -593,9 +753,10 @@ class BiCGStabSolver : BiCGStabCounter {
     const auto kb = IndexRange{kbi.s, kbi.e + (ndim > 2)};
 
     PackIndexMap imap;
-    auto &v = u->PackVariables(std::vector<std::string>({res, tk}), imap);
+    auto &v = u->PackVariables(std::vector<std::string>({res, tk, sk_dir}), imap);
     const int ires = imap[res].first;
     const int itk = imap[tk].first;
+    const int isk = imap[sk_dir].first;
     auto &dv = du->PackVariables(std::vector<std::string>({sol_name}));
     Real omega = t_dot_s.val / t_dot_t.val;
     if (std::abs(t_dot_t.val) < 1.e-200) omega = 0.0;
@@ -604,7 +765,8 @@ class BiCGStabSolver : BiCGStabCounter {
         loop_pattern_mdrange_tag, "Update_x", DevExecSpace(), 0, v.GetDim(5) - 1, kb.s,
         kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA(const int b, const int k, const int j, const int i, Real &lerr) {
-          dv(b, 0, k, j, i) += omega * v(b, ires, k, j, i);
+          // Read before res is updated: with no preconditioner sk_dir is res itself
+          dv(b, 0, k, j, i) += omega * v(b, isk, k, j, i);
           v(b, ires, k, j, i) -= omega * v(b, itk, k, j, i);
           lerr += v(b, ires, k, j, i) * v(b, ires, k, j, i);
         },
@@ -613,6 +775,182 @@ class BiCGStabSolver : BiCGStabCounter {
     return TaskStatus::complete;
   }
 
+  template <typename T>
+  TaskStatus JacobiSweep(T *u, const std::string &in_vec, const std::string &out_vec,
+                         const bool first) {
+    const auto &ibi = u->GetBoundsI(IndexDomain::interior);
+    const auto &jbi = u->GetBoundsJ(IndexDomain::interior);
+    const auto &kbi = u->GetBoundsK(IndexDomain::interior);
+    const int ndim = u->GetMeshPointer()->ndim;
+    const auto ib = IndexRange{ibi.s, ibi.e + (ndim > 0)};
+    const auto jb = IndexRange{jbi.s, jbi.e + (ndim > 1)};
+    const auto kb = IndexRange{kbi.s, kbi.e + (ndim > 2)};
+
+    PackIndexMap imap;
+    auto &v = u->PackVariables(std::vector<std::string>({in_vec, out_vec, az, diag}), imap);
+    const int iin = imap[in_vec].first;
+    const int iout = imap[out_vec].first;
+    const int iaz = imap[az].first;
+    const int idiag = imap[diag].first;
+    const Real w = precon_weight;
+
+    // z = z + w D^{-1} (r - A z), where z = 0 on the first sweep
+    par_for(
+        DEFAULT_LOOP_PATTERN, "JacobiSweep", DevExecSpace(), 0, v.GetDim(5) - 1, kb.s,
+        kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
+          const Real d = v(b, idiag, k, j, i);
+          const Real dinv = (std::abs(d) > 1.e-200) ? 1. / d : 0.;
+          if (first) {
+            v(b, iout, k, j, i) = w * dinv * v(b, iin, k, j, i);
+          } else {
+            v(b, iout, k, j, i) += w * dinv * (v(b, iin, k, j, i) - v(b, iaz, k, j, i));
+          }
+        });
+    return TaskStatus::complete;
+  }
+
+  template <typename T>
+  TaskStatus InitializePipelined(T *u, std::vector<Real> *dots) {
+    const auto &ibi = u->GetBoundsI(IndexDomain::interior);
+    const auto &jbi = u->GetBoundsJ(IndexDomain::interior);
+    const auto &kbi = u->GetBoundsK(IndexDomain::interior);
+    const int ndim = u->GetMeshPointer()->ndim;
+    const auto ib = IndexRange{ibi.s, ibi.e + (ndim > 0)};
+    const auto jb = IndexRange{jbi.s, jbi.e + (ndim > 1)};
+    const auto kb = IndexRange{kbi.s, kbi.e + (ndim > 2)};
+
+    PackIndexMap imap;
+    auto &v = u->PackVariables(std::vector<std::string>({sk, zk}), imap);
+    const int isk = imap[sk].first;
+    const int izk = imap[zk].first;
+
+    // beta_{-1} = 0, but keep old solves' values out of the recurrences anyway
+    par_for(
+        DEFAULT_LOOP_PATTERN, "initialize pipelined", DevExecSpace(), 0, v.GetDim(5) - 1,
+        kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
+          v(b, isk, k, j, i) = 0.0;
+          v(b, izk, k, j, i) = 0.0;
+        });
+    (*dots)[0] += LocalDot(u, res0, res);
+    (*dots)[1] += LocalDot(u, res0, wk);
+    return TaskStatus::complete;
+  }
+
+  template <typename T>
+  TaskStatus Update_pszqy(T *u, std::vector<Real> *dots) {
+    const auto &ibi = u->GetBoundsI(IndexDomain::interior);
+    const auto &jbi = u->GetBoundsJ(IndexDomain::interior);
+    const auto &kbi = u->GetBoundsK(IndexDomain::interior);
+    const int ndim = u->GetMeshPointer()->ndim;
+    const auto ib = IndexRange{ibi.s, ibi.e + (ndim > 0)};
+    const auto jb = IndexRange{jbi.s, jbi.e + (ndim > 1)};
+    const auto kb = IndexRange{kbi.s, kbi.e + (ndim > 2)};
+
+    // First iteration: alpha_0 = (r_0, r_0) / (r_0, w_0)
+    if (bicgstab_cntr == 0) {
+      rhoi_old = init_dots.val[0];
+      alpha_p = (std::abs(init_dots.val[1]) < 1.e-200) ? 0.0 : init_dots.val[0] / init_dots.val[1];
+      beta_p = 0.0;
+      omega_p = 0.0;
+    }
+
+    PackIndexMap imap;
+    auto &v = u->PackVariables(
+        std::vector<std::string>({res, pk, vk, tk, wk, sk, zk, qk, yk}), imap);
+    const int ires = imap[res].first;
+    const int ipk = imap[pk].first;
+    const int ivk = imap[vk].first;
+    const int itk = imap[tk].first;
+    const int iwk = imap[wk].first;
+    const int isk = imap[sk].first;
+    const int izk = imap[zk].first;
+    const int iqk = imap[qk].first;
+    const int iyk = imap[yk].first;
+
+    const Real alpha = alpha_p, beta = beta_p, w_o = omega_p;
+    par_for(
+        DEFAULT_LOOP_PATTERN, "Update_pszqy", DevExecSpace(), 0, v.GetDim(5) - 1, kb.s,
+        kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
+          v(b, ipk, k, j, i) = v(b, ires, k, j, i) +
+                               beta * (v(b, ipk, k, j, i) - w_o * v(b, isk, k, j, i));
+          v(b, isk, k, j, i) = v(b, iwk, k, j, i) +
+                               beta * (v(b, isk, k, j, i) - w_o * v(b, izk, k, j, i));
+          v(b, izk, k, j, i) = v(b, itk, k, j, i) +
+                               beta * (v(b, izk, k, j, i) - w_o * v(b, ivk, k, j, i));
+          v(b, iqk, k, j, i) = v(b, ires, k, j, i) - alpha * v(b, isk, k, j, i);
+          v(b, iyk, k, j, i) = v(b, iwk, k, j, i) - alpha * v(b, izk, k, j, i);
+        });
+    (*dots)[0] += LocalDot(u, qk, yk);
+    (*dots)[1] += LocalDot(u, yk, yk);
+    return TaskStatus::complete;
+  }
+
+  template <typename T>
+  TaskStatus Update_xrw(T *u, T *du, std::vector<Real> *dots) {
+    const auto &ibi = u->GetBoundsI(IndexDomain::interior);
+    const auto &jbi = u->GetBoundsJ(IndexDomain::interior);
+    const auto &kbi = u->GetBoundsK(IndexDomain::interior);
+    const int ndim = u->GetMeshPointer()->ndim;
+    const auto ib = IndexRange{ibi.s, ibi.e + (ndim > 0)};
+    const auto jb = IndexRange{jbi.s, jbi.e + (ndim > 1)};
+    const auto kb = IndexRange{kbi.s, kbi.e + (ndim > 2)};
+
+    PackIndexMap imap;
+    auto &v = u->PackVariables(std::vector<std::string>({res, pk, vk, tk, wk, qk, yk}), imap);
+    const int ires = imap[res].first;
+    const int ipk = imap[pk].first;
+    const int ivk = imap[vk].first;
+    const int itk = imap[tk].first;
+    const int iwk = imap[wk].first;
+    const int iqk = imap[qk].first;
+    const int iyk = imap[yk].first;
+    auto &dv = du->PackVariables(std::vector<std::string>({sol_name}));
+
+    const Real alpha = alpha_p;
+    const Real omega = (std::abs(qy_dots.val[1]) < 1.e-200) ? 0.0 : qy_dots.val[0] / qy_dots.val[1];
+    par_for(
+        DEFAULT_LOOP_PATTERN, "Update_xrw", DevExecSpace(), 0, v.GetDim(5) - 1, kb.s,
+        kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
+          dv(b, 0, k, j, i) += alpha * v(b, ipk, k, j, i) + omega * v(b, iqk, k, j, i);
+          v(b, ires, k, j, i) = v(b, iqk, k, j, i) - omega * v(b, iyk, k, j, i);
+          v(b, iwk, k, j, i) = v(b, iyk, k, j, i) -
+                               omega * (v(b, itk, k, j, i) - alpha * v(b, ivk, k, j, i));
+        });
+    (*dots)[0] += LocalDot(u, res0, res);
+    (*dots)[1] += LocalDot(u, res0, wk);
+    (*dots)[2] += LocalDot(u, res0, sk);
+    (*dots)[3] += LocalDot(u, res0, zk);
+    (*dots)[4] += LocalDot(u, res, res);
+    return TaskStatus::complete;
+  }
+
+  TaskStatus CheckConvergencePipelined(const int &i, bool report) {
+    if (i != 0) return TaskStatus::complete;
+    // Scalars for the next iteration, from the single merged reduction
+    const Real omega = (std::abs(qy_dots.val[1]) < 1.e-200) ? 0.0 : qy_dots.val[0] / qy_dots.val[1];
+    const Real r0_dot_r = r_dots.val[0];
+    const Real beta = (std::abs(omega * rhoi_old) < 1.e-200) ? 0.0
+                      : (alpha_p / omega) * (r0_dot_r / rhoi_old);
+    const Real denom = r_dots.val[1] + beta * r_dots.val[2] - beta * omega * r_dots.val[3];
+    alpha_p = (std::abs(denom) < 1.e-200) ? 0.0 : r0_dot_r / denom;
+    beta_p = beta;
+    omega_p = omega;
+    global_res.val = r_dots.val[4];
+
+    // Reported as for the classical iteration
+    rhoi.val = r0_dot_r;
+    r0_dot_vk.val = (std::abs(alpha_p) < 1.e-200) ? 1.0 : r0_dot_r / alpha_p;
+    t_dot_s.val = qy_dots.val[0];
+    t_dot_t.val = qy_dots.val[1];
+    qy_dots.val = std::vector<Real>(2, 0.0);
+    r_dots.val = std::vector<Real>(5, 0.0);
+    return CheckConvergence(i, report);
+  }
+
   TaskStatus CheckConvergence(const int &i, bool report) {
     if (i != 0) return TaskStatus::complete;
     bicgstab_cntr++;
@@ -658,9 +996,17 @@ class BiCGStabSolver : BiCGStabCounter {
   SparseMatrixAccessor sp_accessor;
   int max_iters, check_interval, bicgstab_cntr;
   bool fail_flag, warn_flag;
+  int precon_sweeps;
+  Real precon_weight;
+  bool warm_start;
+  bool pipelined;
   std::string spm_name, sol_name, rhs_name, res, res0, vk, pk, tk, temp, solver_name;
+  std::string pkhat, skhat, az, diag;
+  std::string wk, sk, zk, qk, yk;
 
   Real rhoi_old, alpha_old, omega_old, res_old;
+  // Pipelined variant: alpha_i, beta_{i-1}, omega_{i-1}
+  Real alpha_p, beta_p, omega_p;
 
   AllReduce<Real> global_res0;
   AllReduce<Real> global_res;
@@ -668,6 +1014,11 @@ class BiCGStabSolver : BiCGStabCounter {
   AllReduce<Real> r0_dot_vk;
   AllReduce<Real> t_dot_s;
   AllReduce<Real> t_dot_t;
+  // Pipelined variant: {(r_0, r_0), (r_0, w_0)}, then per iteration {(q, y), (y, y)}
+  // and {(r_0, r), (r_0, w), (r_0, s), (r_0, z), (r, r)}
+  AllReduce<std::vector<Real>> init_dots;
+  AllReduce<std::vector<Real>> qy_dots;
+  AllReduce<std::vector<Real>> r_dots;
 };
 
 } // namespace solvers
@@ -67,6 +67,10 @@ std::shared_ptr<KHARMAPackage> B_CT::Initialize(ParameterInput *pin, std::shared
     params.Add("kill_on_large_divb", kill_on_large_divb);
     Real kill_on_divb_over = pin->GetOrAddReal("b_field", "kill_on_divb_over", 1.e-3);
     params.Add("kill_on_divb_over", kill_on_divb_over);
+    // Print/check the divB maximum from the previous step, rather than blocking on this step's,
+    // so that the global reduction overlaps the next step
+    bool lagged_divb_check = pin->GetOrAddBoolean("b_field", "lagged_divb_check", true);
+    params.Add("lagged_divb_check", lagged_divb_check);
 
     // Currently bs99, gs05_c, gs05_0
     // TODO gs05_alpha, LDZ04 UCT1, LDZ07 UCT2
@@ -111,20 +115,15 @@ std::shared_ptr<KHARMAPackage> B_CT::Initialize(ParameterInput *pin, std::shared
     m = Metadata(flags_emf);
     pkg->AddField("B_CT.emf", m);
 
-    if (ct_scheme != "bs99") {
-        std::vector<MetadataFlag> flags_emf_c = {Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy};
-        m = Metadata(flags_emf_c, s_vector);
-        pkg->AddField("B_CT.cemf", m);
-    }
-
     // CALLBACKS
 
     // We implement a source term replacement, rather than addition,
     // but same difference really
     pkg->AddSource = B_CT::AddSource;
 
-    // Also ensure that prims get filled, both during step and on boundaries
-    //pkg->MeshUtoP = B_CT::MeshUtoP;
+    // Also ensure that prims get filled, both during step and on boundaries.
+    // During the step this is usually done by the inverter instead, see Inverter::FusesBCT
+    pkg->MeshUtoP = B_CT::MeshUtoP;
     pkg->BlockUtoP = B_CT::BlockUtoP;
     pkg->BoundaryUtoP = B_CT::BlockUtoP;
 
@@ -157,9 +156,24 @@ std::shared_ptr<KHARMAPackage> B_CT::Initialize(ParameterInput *pin, std::shared
 
 TaskStatus B_CT::MeshUtoP(MeshData<Real> *md, IndexDomain domain, bool coarse)
 {
-    // TODO later
-    for (int i=0; i < md->NumBlocks(); i++)
-        B_CT::BlockUtoP(md->GetBlockData(i).get(), domain, coarse);
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const int ndim = pmb0->pmy_mesh->ndim;
+    auto B_Uf = md->PackVariables(std::vector<std::string>{"cons.fB"});
+    auto B_U = md->PackVariables(std::vector<std::string>{"cons.B"});
+    auto B_P = md->PackVariables(std::vector<std::string>{"prims.B"});
+    // Return if we're not syncing U & P at all (e.g. edges)
+    if (B_Uf.GetDim(4) == 0) return TaskStatus::complete;
+
+    const IndexRange3 bc = KDomain::GetRange(md, domain, coarse);
+    const IndexRange block = IndexRange{0, B_Uf.GetDim(5) - 1};
+
+    pmb0->par_for("UtoP_B_center_mesh", block.s, block.e, bc.ks, bc.ke, bc.js, bc.je, bc.is, bc.ie,
+        KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) {
+            const auto& G = B_Uf.GetCoords(b);
+            B_CT::face_to_center(G, B_Uf(b), B_P(b), B_U(b), ndim, k, j, i);
+        }
+    );
+
     return TaskStatus::complete;
 }
 
@@ -176,163 +190,152 @@ TaskStatus B_CT::BlockUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coa
 
     const IndexRange3 bc = KDomain::GetRange(rc, domain, coarse);
 
-    // Average the primitive vals to zone centers
+    // Average the primitive vals to zone centers, and recover conserved B there
     pmb->par_for("UtoP_B_center", bc.ks, bc.ke, bc.js, bc.je, bc.is, bc.ie,
         KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-            B_P(V1, k, j, i) = (B_Uf(F1, 0, k, j, i) / G.gdet(Loci::face1, j, i)
-                              + B_Uf(F1, 0, k, j, i + 1) / G.gdet(Loci::face1, j, i + 1)) / 2;
-            B_P(V2, k, j, i) = (ndim > 1) ? (B_Uf(F2, 0, k, j, i) / G.gdet(Loci::face2, j, i)
-                                           + B_Uf(F2, 0, k, j + 1, i) / G.gdet(Loci::face2, j + 1, i)) / 2
-                                           : B_Uf(F2, 0, k, j, i) / G.gdet(Loci::face2, j, i);
-            B_P(V3, k, j, i) = (ndim > 2) ? (B_Uf(F3, 0, k, j, i) / G.gdet(Loci::face3, j, i)
-                                           + B_Uf(F3, 0, k + 1, j, i) / G.gdet(Loci::face3, j, i)) / 2
-                                          : B_Uf(F3, 0, k, j, i) / G.gdet(Loci::face3, j, i);
-        }
-    );
-    // Recover conserved B at centers
-    pmb->par_for("UtoP_B_centerPtoU", 0, NVEC-1, bc.ks, bc.ke, bc.js, bc.je, bc.is, bc.ie,
-        KOKKOS_LAMBDA (const int &v, const int &k, const int &j, const int &i) {
-            B_U(v, k, j, i) = B_P(v, k, j, i) * G.gdet(Loci::center, j, i);
+            B_CT::face_to_center(G, B_Uf, B_P, B_U, ndim, k, j, i);
         }
     );
 
     return TaskStatus::complete;
 }
 
-TaskStatus B_CT::CalculateEMF(MeshData<Real> *md)
+/**
+ * EMF calculation for a given mesh dimension, so the branches on ndim in the kernel resolve at compile time.
+ * See CalculateEMF for the dispatch.
+ */
+template<int NDIM>
+TaskStatus CalculateEMFImpl(MeshData<Real> *md, const int scheme_id)
 {
-    auto pmesh = md->GetMeshPointer();
-    const int ndim = pmesh->ndim;
-
     // EMF temporary
     auto& emf_pack = md->PackVariables(std::vector<std::string>{"B_CT.emf"});
 
     // Figure out indices
-    const IndexRange3 b = KDomain::GetRange(md, IndexDomain::interior, 0, 0);
     const IndexRange3 b1 = KDomain::GetRange(md, IndexDomain::interior, 0, 1);
     const IndexRange block = IndexRange{0, emf_pack.GetDim(5)-1};
 
     auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
 
-    // Calculate circulation by averaging fluxes
-    // This is the base of most other schemes, which make corrections
-    // It is the entirety of B&S '99
+    // Each scheme is computed in one pass over edges: the averaged fluxes are held in registers
+    // and corrected immediately, and the cell-centered EMF -v x B is evaluated when needed
+    // (center_emf) rather than stored.
     auto& B_U = md->PackVariablesAndFluxes(std::vector<std::string>{"cons.B"});
-    pmb0->par_for("B_CT_emf_BS", block.s, block.e, b1.ks, b1.ke, b1.js, b1.je, b1.is, b1.ie,
+    // Only used by the gs05 schemes, but cheap to pack
+    auto& uvec = md->PackVariables(std::vector<std::string>{"prims.uvec"});
+    // Primitive velocity at face (on right side) (TODO do we need some average?)
+    auto& uvecf = md->PackVariables(std::vector<std::string>{"Flux.vr"});
+    constexpr int kd = NDIM > 2 ? 1 : 0;
+    constexpr int jd = NDIM > 1 ? 1 : 0;
+    constexpr int id = NDIM > 0 ? 1 : 0;
+    Flag("B_CT_emf");
+    // Static estimates for the timing report: bs99 reads 4 fluxes & writes each of 3 EMF components,
+    // gs05_0 adds 4 cell-centered EMFs per component, gs05_c 4 upwinded differences
+    const double emf_bytes[3] = {15, 15 + 72, 15 + 96}, emf_flops[3] = {12, 12 + 120, 12 + 160};
+    Timers::CountKernel("B_CT_emf", static_cast<double>(block.e - block.s + 1) * (b1.ke - b1.ks + 1) * (b1.je - b1.js + 1) * (b1.ie - b1.is + 1),
+                        emf_bytes[scheme_id] * sizeof(Real), emf_flops[scheme_id]);
+    pmb0->par_for("B_CT_emf", block.s, block.e, b1.ks, b1.ke, b1.js, b1.je, b1.is, b1.ie,
         KOKKOS_LAMBDA (const int &bl, const int &k, const int &j, const int &i) {
+            // Calculate circulation by averaging fluxes
+            // This is the base of most other schemes, which make corrections
+            // It is the entirety of B&S '99
             // The basic EMF per length along edges is the B field flux
             // We use this form rather than multiply by edge length here,
             // since the default restriction op averages values
-            const auto& G = B_U.GetCoords(bl);
-            if (ndim > 2) {
-                emf_pack(bl, E1, 0, k, j, i) =
-                    0.25*(B_U(bl).flux(X2DIR, V3, k - 1, j, i) + B_U(bl).flux(X2DIR, V3, k, j, i)
-                        - B_U(bl).flux(X3DIR, V2, k, j - 1, i) - B_U(bl).flux(X3DIR, V2, k, j, i));
-                emf_pack(bl, E2, 0, k, j, i) =
-                    0.25*(B_U(bl).flux(X3DIR, V1, k, j, i - 1) + B_U(bl).flux(X3DIR, V1, k, j, i)
-                        - B_U(bl).flux(X1DIR, V3, k - 1, j, i) - B_U(bl).flux(X1DIR, V3, k, j, i));
-                emf_pack(bl, E3, 0, k, j, i) =
-                    0.25*(B_U(bl).flux(X1DIR, V2, k, j - 1, i) + B_U(bl).flux(X1DIR, V2, k, j, i)
-                        - B_U(bl).flux(X2DIR, V1, k, j, i - 1) - B_U(bl).flux(X2DIR, V1, k, j, i));
-            } else if (ndim > 1) {
-                emf_pack(bl, E1, 0, k, j, i) =  B_U(bl).flux(X2DIR, V3, k, j, i);
-                emf_pack(bl, E2, 0, k, j, i) = -B_U(bl).flux(X1DIR, V3, k, j, i);
-                emf_pack(bl, E3, 0, k, j, i) =
-                    0.25*(B_U(bl).flux(X1DIR, V2, k, j - 1, i) + B_U(bl).flux(X1DIR, V2, k, j, i)
-                        - B_U(bl).flux(X2DIR, V1, k, j, i - 1) - B_U(bl).flux(X2DIR, V1, k, j, i));
+            Real emf1, emf2, emf3;
+            if constexpr (NDIM > 2) {
+                emf1 = 0.25*(B_U(bl).flux(X2DIR, V3, k - 1, j, i) + B_U(bl).flux(X2DIR, V3, k, j, i)
+                           - B_U(bl).flux(X3DIR, V2, k, j - 1, i) - B_U(bl).flux(X3DIR, V2, k, j, i));
+                emf2 = 0.25*(B_U(bl).flux(X3DIR, V1, k, j, i - 1) + B_U(bl).flux(X3DIR, V1, k, j, i)
+                           - B_U(bl).flux(X1DIR, V3, k - 1, j, i) - B_U(bl).flux(X1DIR, V3, k, j, i));
+                emf3 = 0.25*(B_U(bl).flux(X1DIR, V2, k, j - 1, i) + B_U(bl).flux(X1DIR, V2, k, j, i)
+                           - B_U(bl).flux(X2DIR, V1, k, j, i - 1) - B_U(bl).flux(X2DIR, V1, k, j, i));
+            } else if constexpr (NDIM > 1) {
+                emf1 =  B_U(bl).flux(X2DIR, V3, k, j, i);
+                emf2 = -B_U(bl).flux(X1DIR, V3, k, j, i);
+                emf3 = 0.25*(B_U(bl).flux(X1DIR, V2, k, j - 1, i) + B_U(bl).flux(X1DIR, V2, k, j, i)
+                           - B_U(bl).flux(X2DIR, V1, k, j, i - 1) - B_U(bl).flux(X2DIR, V1, k, j, i));
             } else {
-                emf_pack(bl, E1, 0, k, j, i) = 0;
-                emf_pack(bl, E2, 0, k, j, i) = -B_U(bl).flux(X1DIR, V3, k, j, i);
-                emf_pack(bl, E3, 0, k, j, i) =  B_U(bl).flux(X1DIR, V2, k, j, i);
+                emf1 = 0;
+                emf2 = -B_U(bl).flux(X1DIR, V3, k, j, i);
+                emf3 =  B_U(bl).flux(X1DIR, V2, k, j, i);
             }
-        }
-    );
 
-    std::string scheme = pmesh->packages.Get("B_CT")->Param<std::string>("ct_scheme");
-    if (scheme == "bs99") {
-        // Nothing more to do
-    } else if (scheme == "gs05_0" || scheme == "gs05_c") {
-        // Additional terms for Stone & Gardiner '09
-        // Average fluxes and derivatives
-        auto& uvec = md->PackVariables(std::vector<std::string>{"prims.uvec"});
-        auto& emfc = md->PackVariables(std::vector<std::string>{"B_CT.cemf"});
-        auto& B_U = md->PackVariablesAndFluxes(std::vector<std::string>{"cons.B"});
-        auto& B_P = md->PackVariables(std::vector<std::string>{"prims.B"});
-        // emf in center == -v x B
-        pmb0->par_for("B_CT_emfc", block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
-            KOKKOS_LAMBDA (const int &bl, const int &k, const int &j, const int &i) {
-                VLOOP emfc(bl, v, k, j, i) = 0.;
-                VLOOP3 emfc(bl, x, k, j, i) -= antisym(v, w, x) * uvec(bl, v, k, j, i) * B_U(bl, w, k, j, i);
-            }
-        );
-
-        if (scheme == "gs05_0") {
-            const int kd = ndim > 2 ? 1 : 0;
-            const int jd = ndim > 1 ? 1 : 0;
-            const int id = ndim > 0 ? 1 : 0;
-            pmb0->par_for("B_CT_emf_GS05_0", block.s, block.e, b1.ks, b1.ke, b1.js, b1.je, b1.is, b1.ie,
-                KOKKOS_LAMBDA (const int &bl, const int &k, const int &j, const int &i) {
-                    const auto& G = B_U.GetCoords(bl);
-                    // Just subtract centered emf from twice the face version
-                    // More stable for planar flows even without anything fancy
-                    emf_pack(bl, E1, 0, k, j, i) = 2 * emf_pack(bl, E1, 0, k, j, i)
-                        - 0.25*(emfc(bl, V1, k, j, i)      + emfc(bl, V1, k, j - jd, i)
-                              + emfc(bl, V1, k, j - jd, i) + emfc(bl, V1, k - kd, j - jd, i));
-                    emf_pack(bl, E2, 0, k, j, i) = 2 * emf_pack(bl, E2, 0, k, j, i)
-                        - 0.25*(emfc(bl, V2, k, j, i)      + emfc(bl, V2, k, j, i - id)
-                              + emfc(bl, V2, k - kd, j, i) + emfc(bl, V2, k - kd, j, i - id));
-                    emf_pack(bl, E3, 0, k, j, i) = 2 * emf_pack(bl, E3, 0, k, j, i)
-                        - 0.25*(emfc(bl, V3, k, j, i)      + emfc(bl, V3, k, j, i - id)
-                              + emfc(bl, V3, k, j - jd, i) + emfc(bl, V3, k, j - jd, i - id));
-                }
-            );
-        } else if (scheme == "gs05_c") {
-            // Get primitive velocity at face (on right side) (TODO do we need some average?)
-            auto& uvecf = md->PackVariables(std::vector<std::string>{"Flux.vr"});
-
-            pmb0->par_for("B_CT_emf_GS05_c", block.s, block.e, b1.ks, b1.ke, b1.js, b1.je, b1.is, b1.ie,
-                KOKKOS_LAMBDA (const int &bl, const int &k, const int &j, const int &i) {
-                    const auto& G = B_U.GetCoords(bl);
-                    // "simple" flux + upwinding method, Stone & Gardiner '09 but also in Stone+08 etc.
-                    // Upwinded differences take in order (1-indexed):
-                    // 1. EMF component direction to calculate
-                    // 2. Direction of derivative
-                    // 3. Direction of upwinding
-                    // ...then zone number...
-                    // and finally, a boolean indicating a leftward (e.g., i-3/4) vs rightward (i-1/4) position
-                    // TODO(BSP) This doesn't properly support 2D. Yell when it's chosen?
-                    if (ndim > 2) {
-                        emf_pack(bl, E1, 0, k, j, i) +=
-                              0.25*(upwind_diff(B_U(bl), emfc(bl), uvecf(bl), 1, 3, 2, k, j, i, false)
-                                  - upwind_diff(B_U(bl), emfc(bl), uvecf(bl), 1, 3, 2, k, j, i, true))
-                            + 0.25*(upwind_diff(B_U(bl), emfc(bl), uvecf(bl), 1, 2, 3, k, j, i, false)
-                                  - upwind_diff(B_U(bl), emfc(bl), uvecf(bl), 1, 2, 3, k, j, i, true));
-                        emf_pack(bl, E2, 0, k, j, i) +=
-                              0.25*(upwind_diff(B_U(bl), emfc(bl), uvecf(bl), 2, 1, 3, k, j, i, false)
-                                  - upwind_diff(B_U(bl), emfc(bl), uvecf(bl), 2, 1, 3, k, j, i, true))
-                            + 0.25*(upwind_diff(B_U(bl), emfc(bl), uvecf(bl), 2, 3, 1, k, j, i, false)
-                                  - upwind_diff(B_U(bl), emfc(bl), uvecf(bl), 2, 3, 1, k, j, i, true));
-                    }
-                    emf_pack(bl, E3, 0, k, j, i) +=
-                          0.25*(upwind_diff(B_U(bl), emfc(bl), uvecf(bl), 3, 2, 1, k, j, i, false)
-                              - upwind_diff(B_U(bl), emfc(bl), uvecf(bl), 3, 2, 1, k, j, i, true))
-                        + 0.25*(upwind_diff(B_U(bl), emfc(bl), uvecf(bl), 3, 1, 2, k, j, i, false)
-                              - upwind_diff(B_U(bl), emfc(bl), uvecf(bl), 3, 1, 2, k, j, i, true));
+            if (scheme_id == 1) {
+                // Additional terms for Stone & Gardiner '09
+                // Just subtract centered emf from twice the face version
+                // More stable for planar flows even without anything fancy
+                emf1 = 2 * emf1
+                    - 0.25*(center_emf(uvec(bl), B_U(bl), V1, k, j, i)      + center_emf(uvec(bl), B_U(bl), V1, k, j - jd, i)
+                          + center_emf(uvec(bl), B_U(bl), V1, k - kd, j, i) + center_emf(uvec(bl), B_U(bl), V1, k - kd, j - jd, i));
+                emf2 = 2 * emf2
+                    - 0.25*(center_emf(uvec(bl), B_U(bl), V2, k, j, i)      + center_emf(uvec(bl), B_U(bl), V2, k, j, i - id)
+                          + center_emf(uvec(bl), B_U(bl), V2, k - kd, j, i) + center_emf(uvec(bl), B_U(bl), V2, k - kd, j, i - id));
+                emf3 = 2 * emf3
+                    - 0.25*(center_emf(uvec(bl), B_U(bl), V3, k, j, i)      + center_emf(uvec(bl), B_U(bl), V3, k, j, i - id)
+                          + center_emf(uvec(bl), B_U(bl), V3, k, j - jd, i) + center_emf(uvec(bl), B_U(bl), V3, k, j - jd, i - id));
+            } else if (scheme_id == 2) {
+                // "simple" flux + upwinding method, Stone & Gardiner '09 but also in Stone+08 etc.
+                // Upwinded differences take in order (1-indexed):
+                // 1. EMF component direction to calculate
+                // 2. Direction of derivative
+                // 3. Direction of upwinding
+                // ...then zone number...
+                // and finally, a boolean indicating a leftward (e.g., i-3/4) vs rightward (i-1/4) position
+                // TODO(BSP) This doesn't properly support 2D. Yell when it's chosen?
+                if constexpr (NDIM > 2) {
+                    emf1 +=
+                          0.25*(upwind_diff(B_U(bl), uvec(bl), uvecf(bl), 1, 3, 2, k, j, i, false)
+                              - upwind_diff(B_U(bl), uvec(bl), uvecf(bl), 1, 3, 2, k, j, i, true))
+                        + 0.25*(upwind_diff(B_U(bl), uvec(bl), uvecf(bl), 1, 2, 3, k, j, i, false)
+                              - upwind_diff(B_U(bl), uvec(bl), uvecf(bl), 1, 2, 3, k, j, i, true));
+                    emf2 +=
+                          0.25*(upwind_diff(B_U(bl), uvec(bl), uvecf(bl), 2, 1, 3, k, j, i, false)
+                              - upwind_diff(B_U(bl), uvec(bl), uvecf(bl), 2, 1, 3, k, j, i, true))
+                        + 0.25*(upwind_diff(B_U(bl), uvec(bl), uvecf(bl), 2, 3, 1, k, j, i, false)
+                              - upwind_diff(B_U(bl), uvec(bl), uvecf(bl), 2, 3, 1, k, j, i, true));
                 }
-            );
+                emf3 +=
+                      0.25*(upwind_diff(B_U(bl), uvec(bl), uvecf(bl), 3, 2, 1, k, j, i, false)
+                          - upwind_diff(B_U(bl), uvec(bl), uvecf(bl), 3, 2, 1, k, j, i, true))
+                    + 0.25*(upwind_diff(B_U(bl), uvec(bl), uvecf(bl), 3, 1, 2, k, j, i, false)
+                          - upwind_diff(B_U(bl), uvec(bl), uvecf(bl), 3, 1, 2, k, j, i, true));
+            }
+
+            emf_pack(bl, E1, 0, k, j, i) = emf1;
+            emf_pack(bl, E2, 0, k, j, i) = emf2;
+            emf_pack(bl, E3, 0, k, j, i) = emf3;
         }
-    } else {
-        throw std::invalid_argument("Invalid CT scheme specified!  Must be one of bs99, gs05_0, gs05_c!");
-    }
+    );
+    EndFlag();
 
     return TaskStatus::complete;
 }
 
-TaskStatus B_CT::AddSource(MeshData<Real> *md, MeshData<Real> *mdudt)
+TaskStatus B_CT::CalculateEMF(MeshData<Real> *md)
 {
     auto pmesh = md->GetMeshPointer();
-    const int ndim = pmesh->ndim;
 
+    std::string scheme = pmesh->packages.Get("B_CT")->Param<std::string>("ct_scheme");
+    if (scheme != "bs99" && scheme != "gs05_0" && scheme != "gs05_c")
+        throw std::invalid_argument("Invalid CT scheme specified!  Must be one of bs99, gs05_0, gs05_c!");
+    const int scheme_id = (scheme == "bs99") ? 0 : ((scheme == "gs05_0") ? 1 : 2);
+
+    switch (pmesh->ndim) {
+    case 1:
+        return CalculateEMFImpl<1>(md, scheme_id);
+    case 2:
+        return CalculateEMFImpl<2>(md, scheme_id);
+    default:
+        return CalculateEMFImpl<3>(md, scheme_id);
+    }
+}
+
+/**
+ * Face updates from the EMF circulation, for a given mesh dimension.  See AddSource for the dispatch.
+ */
+template<int NDIM>
+TaskStatus AddSourceImpl(MeshData<Real> *md, MeshData<Real> *mdudt)
+{
     // EMF temporary
     auto& emf_pack = md->PackVariables(std::vector<std::string>{"B_CT.emf"});
 
@@ -351,7 +354,7 @@ TaskStatus B_CT::AddSource(MeshData<Real> *md, MeshData<Real> *mdudt)
             const auto& G = dB_Uf_dt.GetCoords(bl);
             dB_Uf_dt(bl, F1, 0, k, j, i) = (G.Volume<E3>(k, j + 1, i) * emf_pack(bl, E3, 0, k, j + 1, i)
                                           - G.Volume<E3>(k, j, i)     * emf_pack(bl, E3, 0, k, j, i));
-            if (ndim > 2)
+            if constexpr (NDIM > 2)
                 dB_Uf_dt(bl, F1, 0, k, j, i) += (-G.Volume<E2>(k + 1, j, i) * emf_pack(bl, E2, 0, k + 1, j, i)
                                                 + G.Volume<E2>(k, j, i)     * emf_pack(bl, E2, 0, k, j, i));
             dB_Uf_dt(bl, F1, 0, k, j, i) /= G.Volume<F1>(k, j, i);
@@ -362,7 +365,7 @@ TaskStatus B_CT::AddSource(MeshData<Real> *md, MeshData<Real> *mdudt)
             const auto& G = dB_Uf_dt.GetCoords(bl);
             dB_Uf_dt(bl, F2, 0, k, j, i) = (-G.Volume<E3>(k, j, i + 1) * emf_pack(bl, E3, 0, k, j, i + 1)
                                            + G.Volume<E3>(k, j, i)     * emf_pack(bl, E3, 0, k, j, i));
-            if (ndim > 2)
+            if constexpr (NDIM > 2)
                 dB_Uf_dt(bl, F2, 0, k, j, i) +=  (G.Volume<E1>(k + 1, j, i) * emf_pack(bl, E1, 0, k + 1, j, i)
                                                 - G.Volume<E1>(k, j, i)     * emf_pack(bl, E1, 0, k, j, i));
             dB_Uf_dt(bl, F2, 0, k, j, i) /= G.Volume<F2>(k, j, i);
@@ -381,6 +384,16 @@ TaskStatus B_CT::AddSource(MeshData<Real> *md, MeshData<Real> *mdudt)
     return TaskStatus::complete;
 }
 
+TaskStatus B_CT::AddSource(MeshData<Real> *md, MeshData<Real> *mdudt)
+{
+    // Circulation kernels only differ in whether they include the X3 edges
+    if (md->GetMeshPointer()->ndim > 2) {
+        return AddSourceImpl<3>(md, mdudt);
+    } else {
+        return AddSourceImpl<2>(md, mdudt);
+    }
+}
+
 double B_CT::MaxDivB(MeshData<Real> *md)
 {
     auto pmesh = md->GetMeshPointer();
@@ -452,7 +465,14 @@ TaskStatus B_CT::PrintGlobalMaxDivB(MeshData<Real> *md, bool kill_on_large_divb)
     const bool print = pmb0->packages.Get("Globals")->Param<int>("verbose") >= 1;
     if (print || kill_on_large_divb) {
         // Calculate the maximum from/on all nodes
-        const double divb_max = B_CT::GlobalMaxDivB(md);
+        double divb_max;
+        if (pmb0->packages.Get("B_CT")->Param<bool>("lagged_divb_check")) {
+            // Reduction channel 3 is reserved for this, see Reductions::LaggedMaxToAll
+            if (!Reductions::LaggedMaxToAll(md, 3, MaxDivB(md), divb_max))
+                return TaskStatus::complete;
+        } else {
+            divb_max = B_CT::GlobalMaxDivB(md);
+        }
         // Print on rank zero
         if (MPIRank0() && print) {
             printf("Max DivB: %g\n", divb_max); // someday I'll learn stream options
@@ -171,7 +171,39 @@ KOKKOS_INLINE_FUNCTION void curl_2D(const GRCoordinates& G, const GridVector& A,
     B_U(F3, 0, k, j, i) = 0.;
 }
 
-KOKKOS_INLINE_FUNCTION Real upwind_diff(const VariableFluxPack<Real>& B_U, const VariablePack<Real>& emfc, const VariablePack<Real>& uvec,
+/**
+ * Average face-centered conserved B to the zone center, setting both prims.B and cons.B.
+ * Shared by B_CT's UtoP and the fused version in Inverter::MeshUtoP.
+ * Note gdet is not a function of X3, so face3 uses the same (j, i) on each side.
+ */
+KOKKOS_INLINE_FUNCTION void face_to_center(const GRCoordinates& G, const VariablePack<Real>& B_Uf,
+                                           const VariablePack<Real>& B_P, const VariablePack<Real>& B_U,
+                                           const int& ndim, const int& k, const int& j, const int& i)
+{
+    B_P(V1, k, j, i) = (B_Uf(F1, 0, k, j, i) / G.gdet(Loci::face1, j, i)
+                      + B_Uf(F1, 0, k, j, i + 1) / G.gdet(Loci::face1, j, i + 1)) / 2;
+    B_P(V2, k, j, i) = (ndim > 1) ? (B_Uf(F2, 0, k, j, i) / G.gdet(Loci::face2, j, i)
+                                   + B_Uf(F2, 0, k, j + 1, i) / G.gdet(Loci::face2, j + 1, i)) / 2
+                                   : B_Uf(F2, 0, k, j, i) / G.gdet(Loci::face2, j, i);
+    B_P(V3, k, j, i) = (ndim > 2) ? (B_Uf(F3, 0, k, j, i) + B_Uf(F3, 0, k + 1, j, i)) / (2 * G.gdet(Loci::face3, j, i))
+                                   : B_Uf(F3, 0, k, j, i) / G.gdet(Loci::face3, j, i);
+    // Recover conserved B at centers
+    const Real gdet_c = G.gdet(Loci::center, j, i);
+    VLOOP B_U(v, k, j, i) = B_P(v, k, j, i) * gdet_c;
+}
+
+/**
+ * Cell-centered EMF, -v x B, component comp (0-indexed)
+ */
+KOKKOS_FORCEINLINE_FUNCTION Real center_emf(const VariablePack<Real>& uvec, const VariableFluxPack<Real>& B_U,
+                                            const int& comp, const int& k, const int& j, const int& i)
+{
+    Real emfc = 0.;
+    VLOOP2 emfc -= antisym(v, w, comp) * uvec(v, k, j, i) * B_U(w, k, j, i);
+    return emfc;
+}
+
+KOKKOS_INLINE_FUNCTION Real upwind_diff(const VariableFluxPack<Real>& B_U, const VariablePack<Real>& uvec_c, const VariablePack<Real>& uvec,
                                         const int& comp, const int& dir, const int& vdir,
                                         const int& k, const int& j, const int& i, const bool& left_deriv)
 {
@@ -201,14 +233,14 @@ KOKKOS_INLINE_FUNCTION Real upwind_diff(const VariableFluxPack<Real>& B_U, const
 
     if (contact_vel > 0) {
         // Forward: difference at i
-        return return_sign * (emfc(comp-1, k_cent, j_cent, i_cent) - emf_sign * B_U.flux(dir, vdir-1, k, j, i));
+        return return_sign * (center_emf(uvec_c, B_U, comp-1, k_cent, j_cent, i_cent) - emf_sign * B_U.flux(dir, vdir-1, k, j, i));
     } else if (contact_vel < 0) {
         // Back: twice difference at i-1
-        return return_sign * (emfc(comp-1, k_cent_up, j_cent_up, i_cent_up) - emf_sign * B_U.flux(dir, vdir-1, k_up, j_up, i_up));
+        return return_sign * (center_emf(uvec_c, B_U, comp-1, k_cent_up, j_cent_up, i_cent_up) - emf_sign * B_U.flux(dir, vdir-1, k_up, j_up, i_up));
     } else {
         // Half and half
-        return return_sign*0.5*(emfc(comp-1, k_cent, j_cent, i_cent) - emf_sign * B_U.flux(dir, vdir-1, k, j, i) +
-                    emfc(comp-1, k_cent_up, j_cent_up, i_cent_up) - emf_sign * B_U.flux(dir, vdir-1, k_up, j_up, i_up));
+        return return_sign*0.5*(center_emf(uvec_c, B_U, comp-1, k_cent, j_cent, i_cent) - emf_sign * B_U.flux(dir, vdir-1, k, j, i) +
+                    center_emf(uvec_c, B_U, comp-1, k_cent_up, j_cent_up, i_cent_up) - emf_sign * B_U.flux(dir, vdir-1, k_up, j_up, i_up));
     }
 }
 
@@ -293,6 +325,13 @@ struct ProlongateInternalOlivares {
                                   {1 - a[next], 3 + a[next], 3 - a[third], 1 + a[third]},
                                   {1 - a[next], 3 + a[next], 1 + a[third], 3 - a[third]}};
 
+        // The four flux differences are the same for every sub-face, only their weights differ.
+        // They read only the other two face components, so they can be computed once, up front
+        const Real Fs[4] = {F<next, me,   -1,DIM>(fine, coords, l, m, n, fk, fj, fi),
+                            F<next, me,third,DIM>(fine, coords, l, m, n, fk, fj, fi),
+                            F<third,me,  -1,DIM>(fine, coords, l, m, n, fk, fj, fi),
+                            F<third,me,next,DIM>(fine, coords, l, m, n, fk, fj, fi)};
+
         constexpr int diff_k = (me == V3 && DIM > 2), diff_j = (me == V2 && DIM > 1), diff_i = (me == V1 && DIM > 0);
 
         // Iterate through the 4 sub-faces
@@ -308,10 +347,8 @@ struct ProlongateInternalOlivares {
                    * coords.Volume<fel>(fk+off_k-diff_k, fj+off_j-diff_j, fi+off_i-diff_i)
                    + fine(me, l, m, n, fk+off_k+diff_k, fj+off_j+diff_j, fi+off_i+diff_i)
                    * coords.Volume<fel>(fk+off_k+diff_k, fj+off_j+diff_j, fi+off_i+diff_i)) +
-                1./16*(coeff[elem][0]*F<next, me,   -1,DIM>(fine, coords, l, m, n, fk, fj, fi)
-                     + coeff[elem][1]*F<next, me,third,DIM>(fine, coords, l, m, n, fk, fj, fi)
-                     + coeff[elem][2]*F<third,me,  -1,DIM>(fine, coords, l, m, n, fk, fj, fi)
-                     + coeff[elem][3]*F<third,me,next,DIM>(fine, coords, l, m, n, fk, fj, fi))
+                1./16*(coeff[elem][0]*Fs[0] + coeff[elem][1]*Fs[1]
+                     + coeff[elem][2]*Fs[2] + coeff[elem][3]*Fs[3])
                 ) / coords.Volume<fel>(fk+off_k, fj+off_j, fi+off_i);
         }
     }
@@ -85,6 +85,10 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
     params.Add("kill_on_large_divb", kill_on_large_divb);
     Real kill_on_divb_over = pin->GetOrAddReal("b_field", "kill_on_divb_over", 1.e-3);
     params.Add("kill_on_divb_over", kill_on_divb_over);
+    // Print/check the divB maximum from the previous step, rather than blocking on this step's,
+    // so that the global reduction overlaps the next step
+    bool lagged_divb_check = pin->GetOrAddBoolean("b_field", "lagged_divb_check", true);
+    params.Add("lagged_divb_check", lagged_divb_check);
 
     // Driver type & implicit marker
     // By default, solve B explicitly
@@ -119,9 +123,14 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
 
     // Declare EMF temporary variables, to avoid malloc/free during each step
     // Technically these are edge-centered but we only need the interior + 1-zone halo anyway, so we store as a vector
-    std::vector<MetadataFlag> flags_emf = {Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy};
-    m = Metadata(flags_emf, s_vector);
-    pkg->AddField("emf", m);
+    // Optionally, borrow a shared scratch array for these instead, see KHARMA::GetScratch
+    bool emf_scratch = pin->GetOrAddBoolean("b_field", "emf_scratch", false);
+    params.Add("emf_scratch", emf_scratch);
+    if (!emf_scratch) {
+        std::vector<MetadataFlag> flags_emf = {Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy};
+        m = Metadata(flags_emf, s_vector);
+        pkg->AddField("emf", m);
+    }
 
     // CALLBACKS
 
@@ -255,38 +264,138 @@ void BlockPtoU(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse)
     );
 }
 
-void FixFlux(MeshData<Real> *md)
+// INTERNAL
+
+/**
+ * Which faces of each block in md are physical ("user") boundaries, for the mesh-wide
+ * boundary flux kernels: column b holds {inner_x1, outer_x1, inner_x2, outer_x2} of block b.
+ */
+inline ParArray2D<int> GetUserBoundaries(MeshData<Real> *md)
 {
-    // TODO flags here
-    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
-    auto& params = pmb0->packages.Get("B_FluxCT")->AllParams();
-    if (params.Get<bool>("fix_polar_flux")) {
-        FixBoundaryFlux(md, IndexDomain::inner_x2, false);
-        FixBoundaryFlux(md, IndexDomain::outer_x2, false);
-    }
-    if (params.Get<bool>("fix_flux_inner_x1")) {
-        FixBoundaryFlux(md, IndexDomain::inner_x1, false);
-    }
-    if (params.Get<bool>("fix_flux_outer_x1")) {
-        FixBoundaryFlux(md, IndexDomain::outer_x1, false);
+    const int nblocks = md->NumBlocks();
+    ParArray2D<int> user_bnds("user_boundaries", nblocks, 4);
+    auto user_bnds_h = Kokkos::create_mirror_view(Kokkos::HostSpace(), user_bnds);
+    const BoundaryFace faces[4] = {BoundaryFace::inner_x1, BoundaryFace::outer_x1,
+                                   BoundaryFace::inner_x2, BoundaryFace::outer_x2};
+    for (int b=0; b < nblocks; ++b) {
+        auto pmb = md->GetBlockData(b)->GetBlockPointer();
+        for (int f=0; f < 4; ++f)
+            user_bnds_h(b, f) = (pmb->boundary_flag[faces[f]] == BoundaryFlag::user);
     }
-    FluxCT(md);
+    Kokkos::deep_copy(user_bnds, user_bnds_h);
+    return user_bnds;
 }
 
-// INTERNAL
+/**
+ * Polar boundary fix, for the inner and/or outer X2 faces of every block in md in one launch.
+ * The two faces never touch the same fluxes, so they can be handled by the same kernel.
+ */
+template<int NDIM, typename FluxPack>
+inline void FixBoundaryFluxX2(MeshData<Real> *md, const FluxPack& B_F, const ParArray2D<int>& user_bnds,
+                              const bool& inner, const bool& outer)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
 
-void FluxCT(MeshData<Real> *md)
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    const IndexRange block = IndexRange{0, B_F.GetDim(5)-1};
+    // See FixBoundaryFlux for these ranges
+    const IndexRange jbf = IndexRange{jb.s, jb.e + 1};
+    const IndexRange ibs = IndexRange{ib.s - 1, ib.e + 1};
+    const IndexRange kbs = IndexRange{kb.s - (NDIM > 2), kb.e + (NDIM > 2)};
+
+    // Make sure the polar EMFs are 0 when performing fluxCT
+    // Compare this section with calculation of emf3 in FluxCT:
+    // these changes ensure that boundary emfs emf3(i,js,k)=0, etc.
+    pmb0->par_for("fix_flux_b_x2", block.s, block.e, kbs.s, kbs.e, 0, 1, ibs.s, ibs.e,
+        KOKKOS_LAMBDA (const int& b, const int &k, const int &side, const int &i) {
+            if (side == 0 && inner && user_bnds(b, 2)) {
+                const int j = jbf.s;
+                B_F(b).flux(X2DIR, V1, k, j, i) = 0.;
+                B_F(b).flux(X2DIR, V3, k, j, i) = 0.;
+                B_F(b).flux(X1DIR, V2, k, j - 1, i) = -B_F(b).flux(X1DIR, V2, k, j, i);
+                if constexpr (NDIM > 2) B_F(b).flux(X3DIR, V2, k, j - 1, i) = -B_F(b).flux(X3DIR, V2, k, j, i);
+            } else if (side == 1 && outer && user_bnds(b, 3)) {
+                const int j = jbf.e;
+                B_F(b).flux(X2DIR, V1, k, j, i) = 0.;
+                B_F(b).flux(X2DIR, V3, k, j, i) = 0.;
+                B_F(b).flux(X1DIR, V2, k, j, i) = -B_F(b).flux(X1DIR, V2, k, j - 1, i);
+                if constexpr (NDIM > 2) B_F(b).flux(X3DIR, V2, k, j, i) = -B_F(b).flux(X3DIR, V2, k, j - 1, i);
+            }
+        }
+    );
+}
+
+/**
+ * Radial boundary fix, for the inner and/or outer X1 faces of every block in md in one launch.
+ * As with X2, the two faces are independent.  This must run *after* any polar fix,
+ * as the two touch the same fluxes at the domain's corners.
+ */
+template<int NDIM, typename FluxPack>
+inline void FixBoundaryFluxX1(MeshData<Real> *md, const FluxPack& B_F, const ParArray2D<int>& user_bnds,
+                              const bool& inner, const bool& outer)
 {
-    // Pointers
-    auto pmesh = md->GetMeshPointer();
     auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
-    // Exit on trivial operations
-    const int ndim = pmesh->ndim;
-    if (ndim < 2) return;
 
-    // Pack variables
-    const auto& B_F = md->PackVariablesAndFluxes(std::vector<std::string>{"cons.B"});
-    const auto& emf_pack = md->PackVariables(std::vector<std::string>{"emf"});
+    // Option for old, pre-Bflux0
+    const bool use_old_x1_fix = pmb0->packages.Get("B_FluxCT")->Param<bool>("use_old_x1_fix");
+
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    const IndexRange block = IndexRange{0, B_F.GetDim(5)-1};
+    // See FixBoundaryFlux for these ranges
+    const IndexRange ibf = IndexRange{ib.s, ib.e + 1};
+    const IndexRange jbs = IndexRange{jb.s - (NDIM > 1), jb.e + (NDIM > 1)};
+    const IndexRange kbs = IndexRange{kb.s - (NDIM > 2), kb.e + (NDIM > 2)};
+
+    // TODO(BSP) could check here we're operating with the right boundaries: Dirichlet for Bflux0,
+    // reflecting/B1 reflect for old stuff
+    pmb0->par_for("fix_flux_b_x1", block.s, block.e, kbs.s, kbs.e, jbs.s, jbs.e, 0, 1,
+        KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &side) {
+            if (side == 0 && !(inner && user_bnds(b, 0))) return;
+            if (side == 1 && !(outer && user_bnds(b, 1))) return;
+            const int i = (side == 0) ? ibf.s : ibf.e;
+            // Offset of the ghost-side faces from the face at the boundary
+            const int ig = (side == 0) ? i - 1 : i;
+            const int ip = (side == 0) ? i : i - 1;
+            if (!use_old_x1_fix) {
+                // "Bflux0" prescription for keeping divB~=0 on zone corners of the interior & exterior X1 faces
+                // Courtesy of & implemented by Hyerin Cho
+                // Allows nonzero flux across X1 boundary but still keeps divB=0 (turns out effectively to have 0 flux)
+                // Usable only for Dirichlet conditions
+                if constexpr (NDIM > 1) B_F(b).flux(X2DIR, V1, k, j, ig) = -B_F(b).flux(X2DIR, V1, k, j, ip)
+                                                                          + B_F(b).flux(X1DIR, V2, k, j, i) + B_F(b).flux(X1DIR, V2, k, j-1, i);
+                if constexpr (NDIM > 2) B_F(b).flux(X3DIR, V1, k, j, ig) = -B_F(b).flux(X3DIR, V1, k, j, ip)
+                                                                          + B_F(b).flux(X1DIR, V3, k, j, i) + B_F(b).flux(X1DIR, V3, k-1, j, i);
+            } else {
+                // These boundary conditions need to arrange for B1 to be inverted in ghost cells.
+                // This is no longer pure outflow, but might be thought of as a "nicer" version of
+                // reflecting conditions:
+                // 1. Since B1 is inverted, B1 on the domain face will tend to 0 (it's not quite reflected, but basically)
+                //    (obviously don't enable this for monopole test problems!)
+                // 2. However, B2 and B3 are normal outflow conditions -- despite the fluxes here, the outflow
+                //    conditions will set them equal to the last zone.
+                B_F(b).flux(X1DIR, V2, k, j, i) = 0.;
+                B_F(b).flux(X1DIR, V3, k, j, i) = 0.;
+                B_F(b).flux(X2DIR, V1, k, j, ig) = -B_F(b).flux(X2DIR, V1, k, j, ip);
+                if constexpr (NDIM > 2) B_F(b).flux(X3DIR, V1, k, j, ig) = -B_F(b).flux(X3DIR, V1, k, j, ip);
+            }
+        }
+    );
+}
+
+/**
+ * FluxCT, using an existing pack of cons.B and its fluxes, and an EMF array
+ * indexed as emf_pack(b, v, k, j, i).
+ * Templated on the mesh dimension (2 or 3), so the 3D-only terms compile out of 2D kernels
+ */
+template<int NDIM, typename FluxPack, typename EMFArray>
+inline void FluxCTWithEMF(MeshData<Real> *md, const FluxPack& B_F, const EMFArray& emf_pack)
+{
+    // Pointers
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
 
     // Get sizes
     const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
@@ -296,12 +405,12 @@ void FluxCT(MeshData<Real> *md)
     // One zone halo on the *right only*, except for k in 2D
     const IndexRange il = IndexRange{ib.s, ib.e + 1};
     const IndexRange jl = IndexRange{jb.s, jb.e + 1};
-    const IndexRange kl = (ndim > 2) ? IndexRange{kb.s, kb.e + 1} : kb;
+    const IndexRange kl = (NDIM > 2) ? IndexRange{kb.s, kb.e + 1} : kb;
 
     // Calculate emf around each face
     pmb0->par_for("flux_ct_emf", block.s, block.e, kl.s, kl.e, jl.s, jl.e, il.s, il.e,
         KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) {
-            if (ndim > 2) {
+            if constexpr (NDIM > 2) {
                 emf_pack(b, V1, k, j, i) =  0.25 * (B_F(b).flux(X2DIR, V3, k, j, i) + B_F(b).flux(X2DIR, V3, k-1, j, i) -
                                             B_F(b).flux(X3DIR, V2, k, j, i) - B_F(b).flux(X3DIR, V2, k, j-1, i));
                 emf_pack(b, V2, k, j, i) = 0.25 * (B_F(b).flux(X3DIR, V1, k, j, i) + B_F(b).flux(X3DIR, V1, k, j, i-1) -
@@ -314,47 +423,91 @@ void FluxCT(MeshData<Real> *md)
 
     // Rewrite EMFs as fluxes, after Toth (2000)
     // Note that zeroing FX(BX) is *necessary* -- this flux gets filled by GetFlux
-    // Note these each have different domains, eg il vs ib.  The former extends one index farther if appropriate
-    pmb0->par_for("flux_ct_1", block.s, block.e, kb.s, kb.e, jb.s, jb.e, il.s, il.e,
+    // All three directions are rewritten in one launch over the union of their domains.
+    // Each has a different domain, eg il vs ib: each extends one index farther in its own direction only
+    pmb0->par_for("flux_ct", block.s, block.e, kl.s, kl.e, jl.s, jl.e, il.s, il.e,
         KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) {
-            B_F(b).flux(X1DIR, V1, k, j, i) =  0.0;
-            B_F(b).flux(X1DIR, V2, k, j, i) =  0.5 * (emf_pack(b, V3, k, j, i) + emf_pack(b, V3, k, j+1, i));
-            if (ndim > 2) B_F(b).flux(X1DIR, V3, k, j, i) = -0.5 * (emf_pack(b, V2, k, j, i) + emf_pack(b, V2, k+1, j, i));
-        }
-    );
-    pmb0->par_for("flux_ct_2", block.s, block.e, kb.s, kb.e, jl.s, jl.e, ib.s, ib.e,
-        KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) {
-            B_F(b).flux(X2DIR, V1, k, j, i) = -0.5 * (emf_pack(b, V3, k, j, i) + emf_pack(b, V3, k, j, i+1));
-            B_F(b).flux(X2DIR, V2, k, j, i) =  0.0;
-            if (ndim > 2) B_F(b).flux(X2DIR, V3, k, j, i) =  0.5 * (emf_pack(b, V1, k, j, i) + emf_pack(b, V1, k+1, j, i));
+            const bool k_in = k <= kb.e, j_in = j <= jb.e, i_in = i <= ib.e;
+            if (k_in && j_in) {
+                B_F(b).flux(X1DIR, V1, k, j, i) =  0.0;
+                B_F(b).flux(X1DIR, V2, k, j, i) =  0.5 * (emf_pack(b, V3, k, j, i) + emf_pack(b, V3, k, j+1, i));
+                if constexpr (NDIM > 2) B_F(b).flux(X1DIR, V3, k, j, i) = -0.5 * (emf_pack(b, V2, k, j, i) + emf_pack(b, V2, k+1, j, i));
+            }
+            if (k_in && i_in) {
+                B_F(b).flux(X2DIR, V1, k, j, i) = -0.5 * (emf_pack(b, V3, k, j, i) + emf_pack(b, V3, k, j, i+1));
+                B_F(b).flux(X2DIR, V2, k, j, i) =  0.0;
+                if constexpr (NDIM > 2) B_F(b).flux(X2DIR, V3, k, j, i) =  0.5 * (emf_pack(b, V1, k, j, i) + emf_pack(b, V1, k+1, j, i));
+            }
+            if constexpr (NDIM > 2) {
+                if (j_in && i_in) {
+                    B_F(b).flux(X3DIR, V1, k, j, i) =  0.5 * (emf_pack(b, V2, k, j, i) + emf_pack(b, V2, k, j, i+1));
+                    B_F(b).flux(X3DIR, V2, k, j, i) = -0.5 * (emf_pack(b, V1, k, j, i) + emf_pack(b, V1, k, j+1, i));
+                    B_F(b).flux(X3DIR, V3, k, j, i) =  0.0;
+                }
+            }
         }
     );
-    if (ndim > 2) {
-        pmb0->par_for("flux_ct_3", block.s, block.e, kl.s, kl.e, jb.s, jb.e, ib.s, ib.e,
-            KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) {
-                B_F(b).flux(X3DIR, V1, k, j, i) =  0.5 * (emf_pack(b, V2, k, j, i) + emf_pack(b, V2, k, j, i+1));
-                B_F(b).flux(X3DIR, V2, k, j, i) = -0.5 * (emf_pack(b, V1, k, j, i) + emf_pack(b, V1, k, j+1, i));
-                B_F(b).flux(X3DIR, V3, k, j, i) =  0.0;
-            }
-        );
-    }
 }
 
-void FixBoundaryFlux(MeshData<Real> *md, IndexDomain domain, bool coarse)
+/**
+ * FluxCT, using an existing pack of cons.B and its fluxes
+ */
+template<typename FluxPack>
+inline void FluxCTImpl(MeshData<Real> *md, const FluxPack& B_F)
 {
     auto pmesh = md->GetMeshPointer();
-    auto pmb0 = pmesh->block_list[0];
-    const int ndim = pmesh->ndim;
-    if (ndim < 2) return;
+    // Exit on trivial operations
+    if (pmesh->ndim < 2) return;
+
+    if (pmesh->packages.Get("B_FluxCT")->Param<bool>("emf_scratch")) {
+        const IndexRange ib = md->GetBoundsI(IndexDomain::entire);
+        const IndexRange jb = md->GetBoundsJ(IndexDomain::entire);
+        const IndexRange kb = md->GetBoundsK(IndexDomain::entire);
+        const auto emf = KHARMA::GetScratch(pmesh, "emf", B_F.GetDim(5), NVEC, kb.e + 1, jb.e + 1, ib.e + 1);
+        if (pmesh->ndim > 2) FluxCTWithEMF<3>(md, B_F, emf);
+        else                 FluxCTWithEMF<2>(md, B_F, emf);
+    } else {
+        const auto& emf = md->PackVariables(std::vector<std::string>{"emf"});
+        if (pmesh->ndim > 2) FluxCTWithEMF<3>(md, B_F, emf);
+        else                 FluxCTWithEMF<2>(md, B_F, emf);
+    }
+}
 
-    // Option for old, pre-Bflux0 
-    const bool use_old_x1_fix = pmb0->packages.Get("B_FluxCT")->Param<bool>("use_old_x1_fix");
+void FixFlux(MeshData<Real> *md)
+{
+    // TODO flags here
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    auto& params = pmb0->packages.Get("B_FluxCT")->AllParams();
+    // Pack the fluxes once, for all the corrections below
+    const auto& B_F = md->PackVariablesAndFluxes(std::vector<std::string>{"cons.B"});
 
-    auto bounds = coarse ? pmb0->c_cellbounds : pmb0->cellbounds;
-    const IndexRange ib = bounds.GetBoundsI(IndexDomain::interior);
-    const IndexRange jb = bounds.GetBoundsJ(IndexDomain::interior);
-    const IndexRange kb = bounds.GetBoundsK(IndexDomain::interior);
+    const int ndim = md->GetMeshPointer()->ndim;
+    if (ndim > 1) {
+        const bool fix_polar = params.Get<bool>("fix_polar_flux");
+        const bool fix_inner_x1 = params.Get<bool>("fix_flux_inner_x1");
+        const bool fix_outer_x1 = params.Get<bool>("fix_flux_outer_x1");
+        if (fix_polar || fix_inner_x1 || fix_outer_x1) {
+            const auto user_bnds = GetUserBoundaries(md);
+            if (fix_polar) {
+                if (ndim > 2) FixBoundaryFluxX2<3>(md, B_F, user_bnds, true, true);
+                else          FixBoundaryFluxX2<2>(md, B_F, user_bnds, true, true);
+            }
+            if (fix_inner_x1 || fix_outer_x1) {
+                if (ndim > 2) FixBoundaryFluxX1<3>(md, B_F, user_bnds, fix_inner_x1, fix_outer_x1);
+                else          FixBoundaryFluxX1<2>(md, B_F, user_bnds, fix_inner_x1, fix_outer_x1);
+            }
+        }
+    }
+    FluxCTImpl(md, B_F);
+}
+
+void FluxCT(MeshData<Real> *md)
+{
+    FluxCTImpl(md, md->PackVariablesAndFluxes(std::vector<std::string>{"cons.B"}));
+}
 
+void FixBoundaryFlux(MeshData<Real> *md, IndexDomain domain, bool coarse)
+{
     // Imagine a corner of the domain, with ghost and physical zones
     // as below, denoted w/'g' and 'p' respectively.
     //    ...
@@ -369,112 +522,22 @@ void FixBoundaryFlux(MeshData<Real> *md, IndexDomain domain, bool coarse)
     // nearby fluxes, two of which affect physical zones.
     // Therefore in e.g. X1 faces, we need to update fluxes on the domain:
     // [0,N1+1],[-1,N2+1],[-1,N3+1]
-    // These indices arrange for that.
-
-    // For faces
-    const IndexRange ibf = IndexRange{ib.s, ib.e + 1};
-    const IndexRange jbf = IndexRange{jb.s, jb.e + 1};
-    // Won't need X3 faces
-    //const IndexRange kbf = IndexRange{kb.s, kb.e + (ndim > 2)};
-    // For sides
-    const IndexRange ibs = IndexRange{ib.s - 1, ib.e + 1};
-    const IndexRange jbs = IndexRange{jb.s - (ndim > 1), jb.e + (ndim > 1)};
-    const IndexRange kbs = IndexRange{kb.s - (ndim > 2), kb.e + (ndim > 2)};
-
-    // Make sure the polar EMFs are 0 when performing fluxCT
-    // Compare this section with calculation of emf3 in FluxCT:
-    // these changes ensure that boundary emfs emf3(i,js,k)=0, etc.
-    for (auto &pmb : pmesh->block_list) {
-        auto& rc = pmb->meshblock_data.Get();
-        auto& B_F = rc->PackVariablesAndFluxes(std::vector<std::string>{"cons.B"});
-
-        if (domain == IndexDomain::inner_x2 &&
-            pmb->boundary_flag[BoundaryFace::inner_x2] == BoundaryFlag::user) {
-            pmb->par_for("fix_flux_b_l", kbs.s, kbs.e, jbf.s, jbf.s, ibs.s, ibs.e,
-                KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-                    B_F.flux(X2DIR, V1, k, j, i) = 0.;
-                    B_F.flux(X2DIR, V3, k, j, i) = 0.;
-                    B_F.flux(X1DIR, V2, k, j - 1, i) = -B_F.flux(X1DIR, V2, k, j, i);
-                    if (ndim > 2) B_F.flux(X3DIR, V2, k, j - 1, i) = -B_F.flux(X3DIR, V2, k, j, i);
-                }
-            );
-        }
-
-        if (domain == IndexDomain::outer_x2 &&
-            pmb->boundary_flag[BoundaryFace::outer_x2] == BoundaryFlag::user) {
-            pmb->par_for("fix_flux_b_r", kbs.s, kbs.e, jbf.e, jbf.e, ibs.s, ibs.e,
-                KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-                    B_F.flux(X2DIR, V1, k, j, i) = 0.;
-                    B_F.flux(X2DIR, V3, k, j, i) = 0.;
-                    B_F.flux(X1DIR, V2, k, j, i) = -B_F.flux(X1DIR, V2, k, j - 1, i);
-                    if (ndim > 2) B_F.flux(X3DIR, V2, k, j, i) = -B_F.flux(X3DIR, V2, k, j - 1, i);
-                }
-            );
-        }
-
-        // TODO(BSP) could check here we're operating with the right boundaries: Dirichlet for Bflux0,
-        // reflecting/B1 reflect for old stuff
-        if (!use_old_x1_fix) {
-            // "Bflux0" prescription for keeping divB~=0 on zone corners of the interior & exterior X1 faces
-            // Courtesy of & implemented by Hyerin Cho
-            // Allows nonzero flux across X1 boundary but still keeps divB=0 (turns out effectively to have 0 flux)
-            // Usable only for Dirichlet conditions
-            if (domain == IndexDomain::inner_x1 &&
-                pmb->boundary_flag[BoundaryFace::inner_x1] == BoundaryFlag::user)
-            {
-                pmb->par_for("fix_flux_b_in", kbs.s, kbs.e, jbs.s, jbs.e, ibf.s, ibf.s, // Hyerin (12/28/22) for 1st & 2nd prescription
-                    KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-                        // Allows nonzero flux across X1 boundary but still keeps divB=0 (turns out effectively to have 0 flux)
-                        if (ndim > 1) B_F.flux(X2DIR, V1, k, j, i-1) = -B_F.flux(X2DIR, V1, k, j, i) + B_F.flux(X1DIR, V2, k, j, i) + B_F.flux(X1DIR, V2, k, j-1, i);
-                        if (ndim > 2) B_F.flux(X3DIR, V1, k, j, i-1) = -B_F.flux(X3DIR, V1, k, j, i) + B_F.flux(X1DIR, V3, k, j, i) + B_F.flux(X1DIR, V3, k-1, j, i);
-                    }
-                );
-
-            }
-            if (domain == IndexDomain::outer_x1 &&
-                pmb->boundary_flag[BoundaryFace::outer_x1] == BoundaryFlag::user)
-            {
-                pmb->par_for("fix_flux_b_out", kbs.s, kbs.e, jbs.s, jbs.e, ibf.e, ibf.e, // Hyerin (12/28/22) for 1st & 2nd prescription
-                    KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-                        // (02/06/23) 2nd prescription that allows nonzero flux across X1 boundary but still keeps divB=0
-                        if (ndim > 1) B_F.flux(X2DIR, V1, k, j, i) = -B_F.flux(X2DIR, V1, k, j, i-1) + B_F.flux(X1DIR, V2, k, j, i) + B_F.flux(X1DIR, V2, k, j-1, i);
-                        if (ndim > 2) B_F.flux(X3DIR, V1, k, j, i) = -B_F.flux(X3DIR, V1, k, j, i-1) + B_F.flux(X1DIR, V3, k, j, i) + B_F.flux(X1DIR, V3, k-1, j, i);
-                    }
-                );
-            }
-        } else {
-            // These boundary conditions need to arrange for B1 to be inverted in ghost cells.
-            // This is no longer pure outflow, but might be thought of as a "nicer" version of
-            // reflecting conditions:
-            // 1. Since B1 is inverted, B1 on the domain face will tend to 0 (it's not quite reflected, but basically)
-            //    (obviously don't enable this for monopole test problems!)
-            // 2. However, B2 and B3 are normal outflow conditions -- despite the fluxes here, the outflow
-            //    conditions will set them equal to the last zone.
-            if (domain == IndexDomain::inner_x1 &&
-                pmb->boundary_flag[BoundaryFace::inner_x1] == BoundaryFlag::user) {
-                pmb->par_for("fix_flux_b_in_old", kbs.s, kbs.e, jbs.s, jbs.e, ibf.s, ibf.s,
-                    KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-                        B_F.flux(X1DIR, V2, k, j, i) = 0.;
-                        B_F.flux(X1DIR, V3, k, j, i) = 0.;
-                        B_F.flux(X2DIR, V1, k, j, i - 1) = -B_F.flux(X2DIR, V1, k, j, i);
-                        if (ndim > 2) B_F.flux(X3DIR, V1, k, j, i - 1) = -B_F.flux(X3DIR, V1, k, j, i);
-                    }
-                );
-            }
-
-            if (domain == IndexDomain::outer_x1 &&
-                pmb->boundary_flag[BoundaryFace::outer_x1] == BoundaryFlag::user) {
-                pmb->par_for("fix_flux_b_out_old", kbs.s, kbs.e, jbs.s, jbs.e, ibf.e, ibf.e,
-                    KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-                        B_F.flux(X1DIR, V2, k, j, i) = 0.;
-                        B_F.flux(X1DIR, V3, k, j, i) = 0.;
-                        B_F.flux(X2DIR, V1, k, j, i) = -B_F.flux(X2DIR, V1, k, j, i - 1);
-                        if (ndim > 2) B_F.flux(X3DIR, V1, k, j, i) = -B_F.flux(X3DIR, V1, k, j, i - 1);
-                    }
-                );
-            }
-        }
+    // The ranges in FixBoundaryFluxX1/X2 arrange for that.
+    // Coarse buffers are never fixed, see FixFlux
+    const int ndim = md->GetMeshPointer()->ndim;
+    if (coarse || ndim < 2) return;
 
+    const auto& B_F = md->PackVariablesAndFluxes(std::vector<std::string>{"cons.B"});
+    const auto user_bnds = GetUserBoundaries(md);
+    const bool in_x2 = domain == IndexDomain::inner_x2, out_x2 = domain == IndexDomain::outer_x2;
+    const bool in_x1 = domain == IndexDomain::inner_x1, out_x1 = domain == IndexDomain::outer_x1;
+    if (in_x2 || out_x2) {
+        if (ndim > 2) FixBoundaryFluxX2<3>(md, B_F, user_bnds, in_x2, out_x2);
+        else          FixBoundaryFluxX2<2>(md, B_F, user_bnds, in_x2, out_x2);
+    }
+    if (in_x1 || out_x1) {
+        if (ndim > 2) FixBoundaryFluxX1<3>(md, B_F, user_bnds, in_x1, out_x1);
+        else          FixBoundaryFluxX1<2>(md, B_F, user_bnds, in_x1, out_x1);
     }
 }
 
@@ -553,7 +616,14 @@ TaskStatus PrintGlobalMaxDivB(MeshData<Real> *md, bool kill_on_large_divb)
     const bool print = pmb0->packages.Get("Globals")->Param<int>("verbose") >= 1;
     if (print || kill_on_large_divb) {
         // Calculate the maximum from/on all nodes
-        const double divb_max = B_FluxCT::GlobalMaxDivB(md);
+        double divb_max;
+        if (pmb0->packages.Get("B_FluxCT")->Param<bool>("lagged_divb_check")) {
+            // Reduction channel 3 is reserved for this, see Reductions::LaggedMaxToAll
+            if (!Reductions::LaggedMaxToAll(md, 3, MaxDivB(md), divb_max))
+                return TaskStatus::complete;
+        } else {
+            divb_max = B_FluxCT::GlobalMaxDivB(md);
+        }
         // Print on rank zero
         if (MPIRank0() && print) {
             // someday I'll learn stream options
@@ -74,7 +74,9 @@ void BlockPtoU(MeshBlockData<Real> *md, IndexDomain domain, bool coarse=false);
 void MeshPtoU(MeshData<Real> *md, IndexDomain domain, bool coarse=false);
 
 /**
- * All flux corrections required by this package
+ * All flux corrections required by this package.
+ * Packs the B fluxes once, then runs at most one polar and one radial boundary
+ * fix launch over every block in md, followed by FluxCT.
  */
 void FixFlux(MeshData<Real> *md);
 /**
@@ -0,0 +1,238 @@
+/* 
+ *  File: kernel_benchmark.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2026, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// KHARMA Headers
+#include "decs.hpp"
+
+#include "b_ct.hpp"
+#include "boundaries.hpp"
+#include "floors.hpp"
+#include "get_flux.hpp"
+#include "grmhd.hpp"
+#include "implicit.hpp"
+#include "inverter.hpp"
+#include "kharma.hpp"
+#include "kharma_driver.hpp"
+#include "kharma_package.hpp"
+#include "post_initialize.hpp"
+#include "problem.hpp"
+
+// Parthenon headers
+#include <parthenon/parthenon.hpp>
+#include <interface/update.hpp>
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+// Single globals for proper indentation when tracing execution, usually in main.cpp
+#if TRACE
+int kharma_debug_trace_indent = 0;
+int kharma_debug_trace_mutex = 0;
+#endif
+
+using namespace parthenon;
+
+/**
+ * A single kernel to time: a name, a function which runs it once over the MeshData,
+ * and the number of Reals per zone it must read or write at minimum, for a bandwidth estimate
+ */
+struct BenchKernel {
+    std::string name;
+    std::function<void()> run;
+    int reals_per_zone;
+};
+
+/**
+ * Add the flux calculation in each direction, for the reconstruction in use.
+ * As in KHARMADriver::AddFluxCalculations, each template must be spelled out.
+ */
+template<KReconstruction::Type Recon>
+void AddFluxKernels(std::vector<BenchKernel> &kernels, MeshData<Real> *md, int nvar)
+{
+    const int ndim = md->GetMeshPointer()->ndim;
+    // Prims in, fluxes out
+    kernels.push_back({"GetFlux X1", [md]() { Flux::GetFlux<Recon, X1DIR>(md); }, 2 * nvar});
+    if (ndim > 1) kernels.push_back({"GetFlux X2", [md]() { Flux::GetFlux<Recon, X2DIR>(md); }, 2 * nvar});
+    if (ndim > 2) kernels.push_back({"GetFlux X3", [md]() { Flux::GetFlux<Recon, X3DIR>(md); }, 2 * nvar});
+}
+
+void AddFluxKernels(std::vector<BenchKernel> &kernels, KReconstruction::Type recon, MeshData<Real> *md, int nvar)
+{
+    using RType = KReconstruction::Type;
+    switch (recon) {
+    case RType::donor_cell:
+        AddFluxKernels<RType::donor_cell>(kernels, md, nvar);
+        break;
+    case RType::linear_mc:
+        AddFluxKernels<RType::linear_mc>(kernels, md, nvar);
+        break;
+    case RType::weno5:
+        AddFluxKernels<RType::weno5>(kernels, md, nvar);
+        break;
+    case RType::ppm:
+        AddFluxKernels<RType::ppm>(kernels, md, nvar);
+        break;
+    case RType::mp5:
+        AddFluxKernels<RType::mp5>(kernels, md, nvar);
+        break;
+    default:
+        if (MPIRank0())
+            std::cout << "Reconstruction not benchmarked, skipping GetFlux. Use donor_cell, linear_mc, weno5, ppm or mp5." << std::endl;
+    }
+}
+
+/**
+ * Micro-benchmarks for KHARMA's hot kernels.
+ *
+ * Sets up the problem in the given parameter file exactly as KHARMA would (e.g. the torus in
+ * pars/benchmark/sane_perf.par), then times each kernel in isolation over the first mesh partition,
+ * reporting zone-updates/second and the effective bandwidth.  The state is not evolved.
+ *
+ * Usage: kharma_bench -i pars/benchmark/sane_perf.par [benchmark/nrep=N] [other parameters]
+ */
+int main(int argc, char *argv[])
+{
+    ParthenonManager pman;
+
+    // Same callbacks as KHARMA proper, see main.cpp
+    pman.app_input->ProcessPackages = KHARMA::ProcessPackages;
+    pman.app_input->MeshProblemGenerator = KHARMA::MeshProblemGenerator;
+    pman.app_input->MeshBlockUserWorkBeforeOutput = Packages::UserWorkBeforeOutput;
+    pman.app_input->PreStepMeshUserWorkInLoop = Packages::PreStepWork;
+    pman.app_input->PostStepMeshUserWorkInLoop = Packages::PostStepWork;
+    pman.app_input->PostStepDiagnosticsInLoop = Packages::PostStepDiagnostics;
+    pman.app_input->boundary_conditions[parthenon::BoundaryFace::inner_x1] = KBoundaries::ApplyBoundaryTemplate<IndexDomain::inner_x1>;
+    pman.app_input->boundary_conditions[parthenon::BoundaryFace::outer_x1] = KBoundaries::ApplyBoundaryTemplate<IndexDomain::outer_x1>;
+    pman.app_input->boundary_conditions[parthenon::BoundaryFace::inner_x2] = KBoundaries::ApplyBoundaryTemplate<IndexDomain::inner_x2>;
+    pman.app_input->boundary_conditions[parthenon::BoundaryFace::outer_x2] = KBoundaries::ApplyBoundaryTemplate<IndexDomain::outer_x2>;
+    pman.app_input->boundary_conditions[parthenon::BoundaryFace::inner_x3] = KBoundaries::ApplyBoundaryTemplate<IndexDomain::inner_x3>;
+    pman.app_input->boundary_conditions[parthenon::BoundaryFace::outer_x3] = KBoundaries::ApplyBoundaryTemplate<IndexDomain::outer_x3>;
+
+    auto manager_status = pman.ParthenonInitEnv(argc, argv);
+    if (manager_status == ParthenonStatus::complete) {
+        pman.ParthenonFinalize();
+        return 0;
+    }
+    if (manager_status == ParthenonStatus::error) {
+        pman.ParthenonFinalize();
+        return 1;
+    }
+    auto pin = pman.pinput.get();
+    KHARMA::FixParameters(pin);
+    pman.ParthenonInitPackagesAndMesh();
+    auto pmesh = pman.pmesh.get();
+    auto prob = pin->GetString("parthenon/job", "problem_id");
+    bool is_restart = (prob == "resize_restart") || (prob == "resize_restart_kharma") || (prob == "checkpoint") || pman.IsRestart();
+    KHARMA::PostInitialize(pin, pmesh, is_restart);
+
+    const int nrep = pin->GetOrAddInteger("benchmark", "nrep", 20);
+
+    {
+        auto &md = pmesh->mesh_data.GetOrAdd("base", 0);
+        auto &pkgs = pmesh->packages.AllPackages();
+        auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+        const IndexRange ib = pmb0->cellbounds.GetBoundsI(IndexDomain::interior);
+        const IndexRange jb = pmb0->cellbounds.GetBoundsJ(IndexDomain::interior);
+        const IndexRange kb = pmb0->cellbounds.GetBoundsK(IndexDomain::interior);
+        const long long zones = (long long) md->NumBlocks() * (ib.e - ib.s + 1) * (jb.e - jb.s + 1) * (kb.e - kb.s + 1);
+
+        const int ncons = md->PackVariables(std::vector<MetadataFlag>{Metadata::Conserved, Metadata::Cell}).GetDim(4);
+        const int nprim = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive"), Metadata::Cell}).GetDim(4);
+
+        std::vector<BenchKernel> kernels;
+        const KReconstruction::Type recon = pkgs.at("Driver")->Param<KReconstruction::Type>("recon");
+        AddFluxKernels(kernels, recon, md.get(), nprim);
+        if (pkgs.count("B_CT")) {
+            // Face fluxes in, edge EMFs out
+            kernels.push_back({"B_CT::CalculateEMF", [&md]() { B_CT::CalculateEMF(md.get()); }, 9});
+        }
+        kernels.push_back({"Inverter::BlockUtoP", [&md]() {
+            for (int b = 0; b < md->NumBlocks(); b++)
+                Inverter::BlockUtoP(md->GetBlockData(b).get(), IndexDomain::interior, false);
+        }, ncons + nprim});
+        if (pkgs.count("Floors")) {
+            kernels.push_back({"Floors::ApplyGRMHDFloors", [&md]() {
+                for (int b = 0; b < md->NumBlocks(); b++)
+                    Floors::ApplyGRMHDFloors(md->GetBlockData(b).get(), IndexDomain::interior);
+            }, 2 * (ncons + nprim)});
+        }
+        if (pkgs.count("Implicit")) {
+            // Solve from the current state with no explicit update, into scratch containers
+            // so that every repetition starts from the same guess
+            auto &md_solver = pmesh->mesh_data.Add("bench_solver");
+            auto &md_dudt = pmesh->mesh_data.Add("bench_dUdt");
+            Update::WeightedSumData<std::vector<MetadataFlag>, MeshData<Real>>(std::vector<MetadataFlag>({Metadata::Cell}),
+                                        md_dudt.get(), md_dudt.get(), 0., 0., md_dudt.get());
+            const Real dt = GRMHD::MeshEstimateTimestep(md.get());
+            kernels.push_back({"Implicit::Step", [&md, &md_solver, &md_dudt, dt]() {
+                KHARMADriver::Copy<MeshData<Real>>({Metadata::Cell}, md.get(), md_solver.get());
+                Implicit::Step(md.get(), md.get(), md_dudt.get(), md_solver.get(), md_solver.get(), dt,
+                               Implicit::SolveRegion::all);
+            }, 6 * ncons});
+        }
+
+        if (MPIRank0()) {
+            std::cout << "Timing " << nrep << " repetitions over " << zones << " zones per rank ("
+                      << md->NumBlocks() << " blocks)" << std::endl;
+            std::cout << std::left << std::setw(28) << "kernel" << std::right << std::setw(14) << "ms/call"
+                      << std::setw(16) << "zone-updates/s" << std::setw(12) << "GB/s" << std::endl;
+        }
+        for (auto &kernel : kernels) {
+            // One untimed call to compile/allocate anything lazily, then average
+            kernel.run();
+            Kokkos::fence();
+            Kokkos::Timer timer;
+            for (int rep = 0; rep < nrep; rep++) kernel.run();
+            Kokkos::fence();
+            Real time = timer.seconds() / nrep;
+            Real total_zones = zones;
+            // Report the slowest rank, over all ranks' zones
+#ifdef MPI_PARALLEL
+            PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_PARTHENON_REAL, MPI_MAX, MPI_COMM_WORLD));
+            PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &total_zones, 1, MPI_PARTHENON_REAL, MPI_SUM, MPI_COMM_WORLD));
+#endif
+            if (MPIRank0()) {
+                const Real bytes = total_zones * kernel.reals_per_zone * sizeof(Real);
+                std::cout << std::left << std::setw(28) << kernel.name << std::right
+                          << std::setw(14) << std::setprecision(4) << time * 1.e3
+                          << std::setw(16) << std::setprecision(4) << total_zones / time
+                          << std::setw(12) << std::setprecision(4) << bytes / time / 1.e9 << std::endl;
+            }
+        }
+    }
+
+    pman.ParthenonFinalize();
+    return 0;
+}
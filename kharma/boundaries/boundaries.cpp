@@ -68,6 +68,11 @@ std::shared_ptr<KHARMAPackage> KBoundaries::Initialize(ParameterInput *pin, std:
     bool domain_bounds_on_conserved = pin->GetOrAddBoolean("boundaries", "domain_bounds_on_conserved", false);
     params.Add("domain_bounds_on_conserved", domain_bounds_on_conserved);
 
+    // Apply boundaries over all blocks of a MeshData object at once, see ApplyBoundariesMD.
+    // Otherwise, each block's faces are applied separately by Parthenon
+    bool mesh_boundaries = pin->GetOrAddBoolean("boundaries", "mesh_boundaries", true);
+    params.Add("mesh_boundaries", mesh_boundaries);
+
     // Fix the X1/X2 corner by replacing the reflecting condition with the inflow
     // Never use this if not in spherical coordinates
     // Activates by default only with reflecting X2/outflow X1 and interior boundary inside EH
@@ -86,34 +91,11 @@ std::shared_ptr<KHARMAPackage> KBoundaries::Initialize(ParameterInput *pin, std:
     params.Add("fix_corner_inner", fix_corner);
     params.Add("fix_corner_outer", pin->GetOrAddBoolean("boundaries", "fix_corner_outer", false));
 
-    Metadata m_x1, m_x2, m_x3;
-    {
-        // We can't use GetVariablesByFlag yet, so ask the packages
-        // These flags get anything that needs a physical boundary during the run
-        using FC = Metadata::FlagCollection;
-        FC ghost_vars = FC({Metadata::FillGhost, Metadata::Conserved})
-                    + FC({Metadata::FillGhost, Metadata::GetUserFlag("Primitive")})
-                    - FC({Metadata::GetUserFlag("StartupOnly")});
-        int nvar = KHARMA::PackDimension(packages.get(), ghost_vars);
-
-        // We also don't know the mesh size, since it's not constructed.  We infer.
-        const int ng = pin->GetInteger("parthenon/mesh", "nghost");
-        const int nx1 = pin->GetInteger("parthenon/meshblock", "nx1");
-        const int n1 = nx1 + 2 * ng;
-        const int nx2 = pin->GetInteger("parthenon/meshblock", "nx2");
-        const int n2 = (nx2 == 1) ? nx2 : nx2 + 2 * ng;
-        const int nx3 = pin->GetInteger("parthenon/meshblock", "nx3");
-        const int n3 = (nx3 == 1) ? nx3 : nx3 + 2 * ng;
-
-        // These are declared *backward* from how they will be indexed
-        std::vector<int> s_x1({ng, n2, n3, nvar});
-        std::vector<int> s_x2({n1, ng, n3, nvar});
-        std::vector<int> s_x3({n1, n2, ng, nvar});
-        // Dirichlet conditions must be restored when restarting!  Needs Metadata::Restart when this works!
-        m_x1 = Metadata({Metadata::Real, Metadata::Derived, Metadata::OneCopy}, s_x1);
-        m_x2 = Metadata({Metadata::Real, Metadata::Derived, Metadata::OneCopy}, s_x2);
-        m_x3 = Metadata({Metadata::Real, Metadata::Derived, Metadata::OneCopy}, s_x3);
-    }
+    // Frozen values for any Dirichlet boundaries, kept only for blocks on each face. See dirichlet.hpp
+    std::vector<DirichletBuffer> dirichlet_buffers(BOUNDARY_NFACES);
+    params.Add("dirichlet_buffers", dirichlet_buffers, true);
+    // Which blocks need each fix, cached per MeshData object. See GetBoundaryMasks
+    params.Add("boundary_masks", std::map<MeshData<Real>*, KBoundaries::BoundaryMasks>(), true);
 
     // Set options for each boundary
     for (int i = 0; i < BOUNDARY_NFACES; i++) {
@@ -139,6 +121,9 @@ std::shared_ptr<KHARMAPackage> KBoundaries::Initialize(ParameterInput *pin, std:
         bool outflow_EMHD = pin->GetOrAddBoolean("boundaries", "outflow_EMHD_" + bname, false);
         params.Add("outflow_EMHD_" + bname, outflow_EMHD);
 
+        // Device list of blocks on this face for ApplyBoundariesMD, kept between steps
+        params.Add("face_blocks_" + bname, Allocations::PersistentArray<int>("face_blocks_" + bname), true);
+
         // BOUNDARY TYPES
         // Get the boundary type we specified in kharma
         auto btype = pin->GetString("boundaries", bname);
@@ -156,8 +141,7 @@ std::shared_ptr<KHARMAPackage> KBoundaries::Initialize(ParameterInput *pin, std:
             // Register the actual boundaries with the package, which our wrapper will use
             // when called via Parthenon's "user" conditions
             if (btype == "dirichlet") {
-                // Dirichlet boundaries: allocate
-                pkg->AddField("Boundaries." + bname, (bdir == X1DIR) ? m_x1 : ((bdir == X2DIR) ? m_x2 : m_x3));
+                // Dirichlet boundaries: buffers are allocated when first frozen
                 switch (bface) {
                 case BoundaryFace::inner_x1:
                     pkg->KBoundaries[bface] = KBoundaries::Dirichlet<BoundaryFace::inner_x1>;
@@ -238,6 +222,103 @@ std::shared_ptr<KHARMAPackage> KBoundaries::Initialize(ParameterInput *pin, std:
     return pkg;
 }
 
+/**
+ * Copy EMHD variables outward from the last physical zone, in otherwise Dirichlet boundaries
+ */
+static void OutflowEMHD(std::shared_ptr<MeshBlockData<Real>> &rc, IndexDomain domain, bool coarse)
+{
+    auto pmb = rc->GetBlockPointer();
+    const auto bface = BoundaryFaceOf(domain);
+    const auto bdir = BoundaryDirection(bface);
+    const bool binner = BoundaryIsInner(bface);
+
+    auto EMHDg = rc->PackVariables({Metadata::GetUserFlag("EMHDVar"), Metadata::FillGhost});
+    const auto &bounds = coarse ? pmb->c_cellbounds : pmb->cellbounds;
+    const auto &range = (bdir == 1) ? bounds.GetBoundsI(IndexDomain::interior)
+                            : (bdir == 2 ? bounds.GetBoundsJ(IndexDomain::interior)
+                                : bounds.GetBoundsK(IndexDomain::interior));
+    const int ref = binner ? range.s : range.e;
+    pmb->par_for_bndry(
+        "outflow_EMHD", IndexRange{0,EMHDg.GetDim(4)-1}, domain, CC, coarse,
+        KOKKOS_LAMBDA (const int &v, const int &k, const int &j, const int &i) {
+            EMHDg(v, k, j, i) = EMHDg(v, (bdir == 3) ? ref : k, (bdir == 2) ? ref : j, (bdir == 1) ? ref : i);
+        }
+    );
+}
+
+/**
+ * Fill whichever of primitive/conserved variables were not set by the boundary condition itself
+ */
+static void FillBoundaryState(std::shared_ptr<MeshBlockData<Real>> &rc, IndexDomain domain, bool coarse)
+{
+    auto pmb = rc->GetBlockPointer();
+    auto& params = pmb->packages.Get("Boundaries")->AllParams();
+
+    bool sync_prims = pmb->packages.Get("Driver")->Param<bool>("sync_prims");
+    // There are two modes of operation here:
+    if (sync_prims) {
+        // 1. Exchange/prolongate/restrict PRIMITIVE variables: (ImEx driver)
+        //    Primitive variables and conserved B field are marked FillGhost
+        //    Explicitly run UtoP on B field, then PtoU on everything
+        // TODO there should be a set of B field wrappers that dispatch this
+        auto pkgs = pmb->packages.AllPackages();
+        if (pkgs.count("B_FluxCT")) {
+            B_FluxCT::BlockUtoP(rc.get(), domain, coarse);
+        } else if (pkgs.count("B_CT")) {
+            B_CT::BlockUtoP(rc.get(), domain, coarse);
+        }
+        Flux::BlockPtoU(rc.get(), domain, coarse);
+    } else {
+        // 2. Exchange/prolongate/restrict CONSERVED variables: (KHARMA driver, maybe ImEx+AMR)
+        //    Conserved variables are marked FillGhost, plus FLUID PRIMITIVES.
+        if (!params.Get<bool>("domain_bounds_on_conserved")) {
+            // To apply primitive boundaries to GRMHD, we run PtoU on that ONLY,
+            // and UtoP on EVERYTHING ELSE
+            Packages::BoundaryPtoUElseUtoP(rc.get(), domain, coarse);
+        } else {
+            // If we want to apply boundaries to conserved vars, just run UtoP on EVERYTHING
+            Packages::BoundaryUtoP(rc.get(), domain, coarse);
+        }
+    }
+}
+
+/**
+ * Outflow boundary condition in X1, optionally followed by the inflow check,
+ * and then GRMHD PtoU, for each ghost zone of the first n_blocks listed blocks in a single kernel.
+ * Equivalent to Parthenon's outflow, CheckInflow and Flux::BlockPtoUMHD in turn,
+ * for runs with only cell-centered FillGhost variables.
+ */
+static void OutflowCheckInflowPtoU(MeshData<Real> *md, IndexDomain domain, const ParArray1D<int> &blocks, int n_blocks, bool check)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const auto& pars = pmb0->packages.Get("GRMHD")->AllParams();
+    const Real gam = pars.Get<Real>("gamma");
+    const EMHD::EMHD_parameters& emhd_params = EMHD::GetEMHDParameters(pmb0->packages);
+
+    // Everything Parthenon would fill, then the packs Flux::BlockPtoUMHD uses
+    auto& Q = md->PackVariables(std::vector<MetadataFlag>{Metadata::FillGhost, Metadata::Cell});
+    PackIndexMap prims_map, cons_map;
+    const auto& P = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    const auto& U = md->PackVariables(std::vector<MetadataFlag>{Metadata::Conserved}, cons_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+    const int nq = Q.GetDim(4);
+
+    const auto bc = KDomain::GetRange(md, domain);
+    const IndexRange ib = pmb0->cellbounds.GetBoundsI(IndexDomain::interior);
+    const int ref = BoundaryIsInner(BoundaryFaceOf(domain)) ? ib.s : ib.e;
+    pmb0->par_for("outflow_inflow_ptou", 0, n_blocks - 1, bc.ks, bc.ke, bc.js, bc.je, bc.is, bc.ie,
+        KOKKOS_LAMBDA (const int &n, const int &k, const int &j, const int &i) {
+            const int b = blocks(n);
+            for (int v = 0; v < nq; v++)
+                if (Q.IsAllocated(b, v)) Q(b, v, k, j, i) = Q(b, v, k, j, ref);
+            const auto& G = P.GetCoords(b);
+            if (check)
+                KBoundaries::check_inflow(G, P(b), domain, m_p.U1, k, j, i);
+            Flux::p_to_u_mhd(G, P(b), m_p, emhd_params, gam, k, j, i, U(b), m_u);
+        }
+    );
+}
+
 void KBoundaries::ApplyBoundary(std::shared_ptr<MeshBlockData<Real>> &rc, IndexDomain domain, bool coarse)
 {
     Flag("ApplyBoundary"); // this is not a callback, flag for ourselves
@@ -263,7 +344,7 @@ void KBoundaries::ApplyBoundary(std::shared_ptr<MeshBlockData<Real>> &rc, IndexD
     const auto bdir = BoundaryDirection(bface);
     const bool binner = BoundaryIsInner(bface);
 
-    Flag("Apply "+bname+" boundary: "+btype_name);
+    Flag("Apply ", bname, " boundary: ", btype_name);
     pkg->KBoundaries[bface](rc, coarse);
     EndFlag();
 
@@ -279,7 +360,7 @@ void KBoundaries::ApplyBoundary(std::shared_ptr<MeshBlockData<Real>> &rc, IndexD
     if (bdir == X2DIR &&
         pmb->coords.coords.is_spherical() &&
         emfpack.GetDim(4) > 0) {
-        Flag("BoundaryEdge_"+bname);
+        Flag("BoundaryEdge_", bname);
         for (TE el : {TE::E1, TE::E3}) {
             int off = (binner) ? 1 : -1;
             pmb->par_for_bndry(
@@ -297,7 +378,7 @@ void KBoundaries::ApplyBoundary(std::shared_ptr<MeshBlockData<Real>> &rc, IndexD
     if (bdir == X2DIR &&
         pmb->coords.coords.is_spherical() &&
         fpack.GetDim(4) > 0) {
-        Flag("BoundaryFace_"+bname);
+        Flag("BoundaryFace_", bname);
         // Zero face fluxes
         auto b = KDomain::GetRange(rc, domain, coarse);
         // "domain" is the boundary here
@@ -331,7 +412,7 @@ void KBoundaries::ApplyBoundary(std::shared_ptr<MeshBlockData<Real>> &rc, IndexD
     // Prevent inflow of material by changing fluid speeds,
     // anywhere we've specified.
     if (params.Get<bool>("check_inflow_" + bname)) {
-        Flag("CheckInflow_"+bname);
+        Flag("CheckInflow_", bname);
         CheckInflow(rc, domain, coarse);
         EndFlag();
     }
@@ -340,19 +421,8 @@ void KBoundaries::ApplyBoundary(std::shared_ptr<MeshBlockData<Real>> &rc, IndexD
     // Only used for viscous_bondi problem
     // TODO make this more general?
     if (params.Get<bool>("outflow_EMHD_" + bname)) {
-        Flag("OutflowEMHD_"+bname);
-        auto EMHDg = rc->PackVariables({Metadata::GetUserFlag("EMHDVar"), Metadata::FillGhost});
-        const auto &bounds = coarse ? pmb->c_cellbounds : pmb->cellbounds;
-        const auto &range = (bdir == 1) ? bounds.GetBoundsI(IndexDomain::interior)
-                                : (bdir == 2 ? bounds.GetBoundsJ(IndexDomain::interior)
-                                    : bounds.GetBoundsK(IndexDomain::interior));
-        const int ref = binner ? range.s : range.e;
-        pmb->par_for_bndry(
-            "outflow_EMHD", IndexRange{0,EMHDg.GetDim(4)-1}, domain, CC, coarse,
-            KOKKOS_LAMBDA (const int &v, const int &k, const int &j, const int &i) {
-                EMHDg(v, k, j, i) = EMHDg(v, (bdir == 3) ? ref : k, (bdir == 2) ? ref : j, (bdir == 1) ? ref : i);
-            }
-        );
+        Flag("OutflowEMHD_", bname);
+        OutflowEMHD(rc, domain, coarse);
         EndFlag();
     }
 
@@ -388,34 +458,158 @@ void KBoundaries::ApplyBoundary(std::shared_ptr<MeshBlockData<Real>> &rc, IndexD
         }
     }
 
-    bool sync_prims = rc->GetBlockPointer()->packages.Get("Driver")->Param<bool>("sync_prims");
-    // There are two modes of operation here:
-    if (sync_prims) {
-        // 1. Exchange/prolongate/restrict PRIMITIVE variables: (ImEx driver)
-        //    Primitive variables and conserved B field are marked FillGhost
-        //    Explicitly run UtoP on B field, then PtoU on everything
-        // TODO there should be a set of B field wrappers that dispatch this
-        auto pkgs = pmb->packages.AllPackages();
-        if (pkgs.count("B_FluxCT")) {
-            B_FluxCT::BlockUtoP(rc.get(), domain, coarse);
-        } else if (pkgs.count("B_CT")) {
-            B_CT::BlockUtoP(rc.get(), domain, coarse);
+    FillBoundaryState(rc, domain, coarse);
+
+    EndFlag();
+}
+
+TaskStatus KBoundaries::ApplyBoundariesMD(std::shared_ptr<MeshData<Real>> &md, bool coarse)
+{
+    auto pmesh = md->GetMeshPointer();
+    auto pkg = pmesh->packages.Get<KHARMAPackage>("Boundaries");
+    auto& params = pkg->AllParams();
+    if (!params.Get<bool>("mesh_boundaries") || coarse)
+        return parthenon::ApplyBoundaryConditionsOnCoarseOrFineMD(md, coarse);
+
+    Flag("ApplyBoundariesMD");
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const int ndim = pmesh->ndim;
+    const bool spherical = pmb0->coords.coords.is_spherical();
+
+    auto& emfpack = md->PackVariables(std::vector<std::string>{"B_CT.emf"});
+    auto& fpack = md->PackVariables(std::vector<MetadataFlag>{Metadata::Face, Metadata::FillGhost});
+    PackIndexMap prims_map;
+    auto P = GRMHD::PackMHDPrims(md.get(), prims_map);
+    const VarMap m_p(prims_map, false);
+    const bool have_prims = P.GetDim(4) > 0;
+    const auto& corner_mask = GetBoundaryMasks(md.get()).corner;
+
+    // Outflow X1 boundaries can be filled, checked for inflow, and converted to conserved variables
+    // in one kernel, when the latter is just the GRMHD PtoU (see FillBoundaryState).
+    // Parthenon's outflow also fills any face/edge fields, so we leave those runs alone.
+    const bool sync_prims = pmesh->packages.Get("Driver")->Param<bool>("sync_prims");
+    const bool can_fuse_outflow = have_prims && !sync_prims && !params.Get<bool>("domain_bounds_on_conserved") &&
+        pmesh->packages.AllPackages().count("GRMHD") &&
+        md->PackVariables(std::vector<MetadataFlag>{Metadata::FillGhost, Metadata::Face}).GetDim(4) == 0 &&
+        md->PackVariables(std::vector<MetadataFlag>{Metadata::FillGhost, Metadata::Edge}).GetDim(4) == 0;
+
+    for (int f = 0; f < BOUNDARY_NFACES; f++) {
+        const auto bface = (BoundaryFace) f;
+        const auto domain = BoundaryDomain(bface);
+        const auto bname = BoundaryName(bface);
+        const auto bdir = BoundaryDirection(bface);
+        const bool binner = BoundaryIsInner(bface);
+        // Parthenon only applies boundaries in active dimensions
+        if (bdir > ndim) continue;
+
+        // Blocks of this MeshData on this face of the domain
+        std::vector<int> face_blocks;
+        for (int b = 0; b < md->NumBlocks(); b++)
+            if (md->GetBlockData(b)->GetBlockPointer()->boundary_flag[bface] == BoundaryFlag::user)
+                face_blocks.push_back(b);
+        const int n_face = face_blocks.size();
+        if (n_face == 0) continue;
+        const auto blocks = params.GetMutable<Allocations::PersistentArray<int>>("face_blocks_" + bname)->Set(face_blocks);
+
+        if (can_fuse_outflow && bdir == X1DIR && params.Get<std::string>(bname) == "outflow" &&
+            !params.Get<bool>("outflow_EMHD_" + bname)) {
+            Flag("FusedOutflow_", bname);
+            OutflowCheckInflowPtoU(md.get(), domain, blocks, n_face, params.Get<bool>("check_inflow_" + bname));
+            // Any other packages still need their boundary UtoP
+            for (int b : face_blocks)
+                Packages::BoundaryPtoUElseUtoP(md->GetBlockData(b).get(), domain, coarse, true);
+            EndFlag();
+            continue;
         }
-        Flux::BlockPtoU(rc.get(), domain, coarse);
-    } else {
-        // 2. Exchange/prolongate/restrict CONSERVED variables: (KHARMA driver, maybe ImEx+AMR)
-        //    Conserved variables are marked FillGhost, plus FLUID PRIMITIVES.
-        if (!params.Get<bool>("domain_bounds_on_conserved")) {
-            // To apply primitive boundaries to GRMHD, we run PtoU on that ONLY,
-            // and UtoP on EVERYTHING ELSE
-            Packages::BoundaryPtoUElseUtoP(rc.get(), domain, coarse);
+
+        // The boundary conditions themselves are Parthenon's, applied per-block,
+        // except Dirichlet conditions which are copied from their buffer all at once
+        Flag("Apply ", bname, " boundary: ", params.Get<std::string>(bname));
+        if (params.Get<std::string>(bname) == "dirichlet") {
+            DirichletMD(md.get(), bface, face_blocks);
         } else {
-            // If we want to apply boundaries to conserved vars, just run UtoP on EVERYTHING
-            Packages::BoundaryUtoP(rc.get(), domain, coarse);
+            for (int b : face_blocks) {
+                auto rc = md->GetBlockData(b);
+                pkg->KBoundaries[bface](rc, coarse);
+            }
+        }
+        EndFlag();
+
+        // KHARMA's fixups are then applied to all blocks on the face at once.  See ApplyBoundary
+        if (bdir == X2DIR && spherical && emfpack.GetDim(4) > 0) {
+            Flag("BoundaryEdge_", bname);
+            const int off = (binner) ? 1 : -1;
+            for (TE el : {TE::E1, TE::E3}) {
+                const IndexRange ib = pmb0->cellbounds.GetBoundsI(domain, el);
+                const IndexRange jb = pmb0->cellbounds.GetBoundsJ(domain, el);
+                const IndexRange kb = pmb0->cellbounds.GetBoundsK(domain, el);
+                pmb0->par_for("zero_EMF_md", 0, n_face - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+                    KOKKOS_LAMBDA (const int &n, const int &k, const int &j, const int &i) {
+                        emfpack(blocks(n), el, 0, k, j + off, i) = 0;
+                    }
+                );
+            }
+            EndFlag();
+        }
+        if (bdir == X2DIR && spherical && fpack.GetDim(4) > 0) {
+            Flag("BoundaryFace_", bname);
+            const int nvar = fpack.GetDim(4);
+            // Zero the polar faces themselves
+            const auto bc = KDomain::GetRange(md.get(), domain, coarse);
+            const int jf = (binner) ? bc.je + 1 : bc.js;
+            pmb0->par_for("zero_polar_md_" + bname, 0, n_face - 1, bc.ks, bc.ke, jf, jf, bc.is, bc.ie,
+                KOKKOS_LAMBDA (const int &n, const int &k, const int &j, const int &i) {
+                    fpack(blocks(n), F2, 0, k, j, i) = 0.;
+                }
+            );
+            // Invert F2 in the ghost zones
+            const IndexRange ib = pmb0->cellbounds.GetBoundsI(domain, F2);
+            const IndexRange jb = pmb0->cellbounds.GetBoundsJ(domain, F2);
+            const IndexRange kb = pmb0->cellbounds.GetBoundsK(domain, F2);
+            pmb0->par_for("invert_F2_md_" + bname, 0, n_face - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+                KOKKOS_LAMBDA (const int &n, const int &k, const int &j, const int &i) {
+                    for (int v = 0; v < nvar; v++)
+                        fpack(blocks(n), F2, v, k, j, i) *= -1;
+                }
+            );
+            EndFlag();
+        }
+
+        // As in ApplyBoundary, skip the rest when not syncing the fluid
+        if (!have_prims) continue;
+
+        if (params.Get<bool>("check_inflow_" + bname)) {
+            Flag("CheckInflow_", bname);
+            const auto bc = KDomain::GetRange(md.get(), domain, coarse);
+            pmb0->par_for("check_inflow_md", 0, n_face - 1, bc.ks, bc.ke, bc.js, bc.je, bc.is, bc.ie,
+                KOKKOS_LAMBDA (const int &n, const int &k, const int &j, const int &i) {
+                    const int b = blocks(n);
+                    const auto& G = P.GetCoords(b);
+                    KBoundaries::check_inflow(G, P(b), domain, m_p.U1, k, j, i);
+                }
+            );
+            EndFlag();
+        }
+
+        // The remainder are per-block, as they are rare (EMHD outflow, corners)
+        // or dispatch to each package's boundary UtoP/PtoU
+        for (int b : face_blocks) {
+            auto rc = md->GetBlockData(b);
+            if (params.Get<bool>("outflow_EMHD_" + bname)) {
+                OutflowEMHD(rc, domain, coarse);
+            }
+            if (bdir == X2DIR) {
+                if (corner_mask[b] & CORNER_MASK_INNER)
+                    ApplyBoundary(rc, IndexDomain::inner_x1, coarse);
+                if (corner_mask[b] & CORNER_MASK_OUTER)
+                    ApplyBoundary(rc, IndexDomain::outer_x1, coarse);
+            }
+            FillBoundaryState(rc, domain, coarse);
         }
     }
 
     EndFlag();
+    return TaskStatus::complete;
 }
 
 void KBoundaries::CheckInflow(std::shared_ptr<MeshBlockData<Real>> &rc, IndexDomain domain, bool coarse)
@@ -438,12 +632,53 @@ void KBoundaries::CheckInflow(std::shared_ptr<MeshBlockData<Real>> &rc, IndexDom
     );
 }
 
+const KBoundaries::BoundaryMasks& KBoundaries::GetBoundaryMasks(MeshData<Real> *md)
+{
+    auto pmesh = md->GetMeshPointer();
+    auto& params = pmesh->packages.Get("Boundaries")->AllParams();
+    auto& all_masks = *params.GetMutable<std::map<MeshData<Real>*, BoundaryMasks>>("boundary_masks");
+    auto& masks = all_masks[md];
+
+    const int nb = md->NumBlocks();
+    std::vector<MeshBlock*> blocks(nb);
+    for (int b = 0; b < nb; b++) blocks[b] = &(*md->GetBlockData(b)->GetBlockPointer());
+    if (masks.blocks == blocks) return masks;
+
+    masks.blocks = blocks;
+    masks.flux = ParArray2D<int>("flux_masks", nb, BOUNDARY_NFACES);
+    masks.any_flux = false;
+    masks.corner = std::vector<int>(nb, 0);
+    auto flux_h = masks.flux.GetHostMirror();
+    for (int b = 0; b < nb; b++) {
+        auto pmb = blocks[b];
+        for (int f = 0; f < BOUNDARY_NFACES; f++) {
+            const auto bface = (BoundaryFace) f;
+            const auto bname = BoundaryName(bface);
+            int mask = 0;
+            if (BoundaryDirection(bface) <= pmesh->ndim && pmb->boundary_flag[bface] == BoundaryFlag::user) {
+                if (params.Get<bool>("check_inflow_" + bname)) mask |= FLUX_MASK_INFLOW;
+                if (params.Get<bool>("zero_flux_" + bname)) mask |= FLUX_MASK_ZERO;
+            }
+            flux_h(b, f) = mask;
+            masks.any_flux = masks.any_flux || mask;
+        }
+        if (params.Get<bool>("fix_corner_inner") && pmb->boundary_flag[BoundaryFace::inner_x1] == BoundaryFlag::user)
+            masks.corner[b] |= CORNER_MASK_INNER;
+        if (params.Get<bool>("fix_corner_outer") && pmb->boundary_flag[BoundaryFace::outer_x1] == BoundaryFlag::user)
+            masks.corner[b] |= CORNER_MASK_OUTER;
+    }
+    masks.flux.DeepCopy(flux_h);
+    return masks;
+}
+
 TaskStatus KBoundaries::FixFlux(MeshData<Real> *md)
 {
     auto pmesh = md->GetMeshPointer();
     auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
 
-    auto& params = pmb0->packages.Get("Boundaries")->AllParams();
+    const auto& masks = GetBoundaryMasks(md);
+    if (!masks.any_flux) return TaskStatus::complete;
+    const auto flux_mask = masks.flux;
 
     // Fluxes are defined at faces, so there is one more valid flux than
     // valid cell in the face direction.  That is, e.g. F1 is valid on
@@ -460,72 +695,49 @@ TaskStatus KBoundaries::FixFlux(MeshData<Real> *md)
     const IndexRange jbs = pmb0->cellbounds.GetBoundsJ(IndexDomain::interior);
     const IndexRange kbs = pmb0->cellbounds.GetBoundsK(IndexDomain::interior);
     // Ranges for faces
-    const IndexRange ibf = IndexRange{ibs.s, ibs.e + 1};
-    const IndexRange jbf = IndexRange{jbs.s, jbs.e + (ndim > 1)};
-    const IndexRange kbf = IndexRange{kbs.s, kbs.e + (ndim > 2)};
-
-    for (auto &pmb : pmesh->block_list) {
-        auto &rc = pmb->meshblock_data.Get();
-
-        for (int i = 0; i < BOUNDARY_NFACES; i++) {
-            BoundaryFace bface = (BoundaryFace)i;
-            auto bname = BoundaryName(bface);
-            auto bdir = BoundaryDirection(bface);
-            auto binner = BoundaryIsInner(bface);
-
-            if (bdir > ndim) continue;
-
-            // Set ranges for entire width.  Probably not needed for fluxes but won't hurt
-            IndexRange ib = ibe, jb = jbe, kb = kbe;
-            // Range for inner_x1 bounds is first face only, etc.
-            if (bdir == 1) {
-                ib.s = ib.e = (binner) ? ibf.s : ibf.e;
-            } else if (bdir == 2) {
-                jb.s = jb.e = (binner) ? jbf.s : jbf.e;
+    const int i_face[2] = {ibs.s, ibs.e + 1};
+    const int j_face[2] = {jbs.s, jbs.e + (ndim > 1)};
+    const int k_face[2] = {kbs.s, kbs.e + (ndim > 2)};
+
+    PackIndexMap cons_map;
+    auto& F = md->PackVariablesAndFluxes(std::vector<MetadataFlag>{Metadata::WithFluxes}, cons_map);
+    const int m_rho = cons_map["cons.rho"].first;
+    const int nvar = F.GetDim(4);
+
+    // Every face of every block, in one kernel.  Each face is indexed by its two transverse
+    // coordinates (x, y): (k, j) for X1 faces, (k, i) for X2, (j, i) for X3.
+    // Faces past the mesh dimension are never masked, so they are left out of the launch.
+    // Set ranges for entire width.  Probably not needed for fluxes but won't hurt
+    const int nfaces = 2 * ndim;
+    const int xmax = m::max(kbe.e, jbe.e);
+    const int ymax = m::max(jbe.e, ibe.e);
+    pmb0->par_for("fix_boundary_flux", 0, F.GetDim(5) - 1, 0, nfaces - 1, 0, xmax, 0, ymax,
+        KOKKOS_LAMBDA (const int &b, const int &f, const int &x, const int &y) {
+            const int mask = flux_mask(b, f);
+            if (!mask) return;
+            const int bdir = f/2 + 1;
+            const int side = f % 2;
+            int k, j, i;
+            if (bdir == X1DIR) {
+                if (x > kbe.e || y > jbe.e) return;
+                k = x; j = y; i = i_face[side];
+            } else if (bdir == X2DIR) {
+                if (x > kbe.e || y > ibe.e) return;
+                k = x; j = j_face[side]; i = y;
             } else {
-                kb.s = kb.e = (binner) ? kbf.s : kbf.e;
+                if (x > jbe.e || y > ibe.e) return;
+                k = k_face[side]; j = x; i = y;
             }
-
-            PackIndexMap cons_map;
-            auto &F = rc->PackVariablesAndFluxes({Metadata::WithFluxes}, cons_map);
-
-            // If we should check inflow on this face...
-            if (params.Get<bool>("check_inflow_" + bname)) {
-                const int m_rho = cons_map["cons.rho"].first;
-                // ...and if this face of the block corresponds to a global boundary...
-                if (pmb->boundary_flag[bface] == BoundaryFlag::user) {
-                    if (binner) {
-                        pmb->par_for(
-                            "zero_inflow_flux_" + bname, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-                            KOKKOS_LAMBDA(const int &k, const int &j, const int &i) {
-                                F.flux(bdir, m_rho, k, j, i) = m::min(F.flux(bdir, m_rho, k, j, i), 0.);
-                            }
-                        );
-                    } else {
-                        pmb->par_for(
-                            "zero_inflow_flux_" + bname, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-                            KOKKOS_LAMBDA(const int &k, const int &j, const int &i) {
-                                F.flux(bdir, m_rho, k, j, i) = m::max(F.flux(bdir, m_rho, k, j, i), 0.);
-                            }
-                        );
-                    }
-                }
-            }
-
-            // If we should zero flux through this face...
-            if (params.Get<bool>("zero_flux_" + bname)) {
-                // ...and if this face of the block corresponds to a global boundary...
-                if (pmb->boundary_flag[bface] == BoundaryFlag::user) {
-                    pmb->par_for(
-                        "zero_flux_" + bname, 0, F.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.s, ib.s, ib.e,
-                        KOKKOS_LAMBDA(const int &p, const int &k, const int &j, const int &i) {
-                            F.flux(bdir, p, k, j, i) = 0.;
-                        }
-                    );
-                }
+            if (mask & FLUX_MASK_ZERO) {
+                for (int p = 0; p < nvar; p++)
+                    if (F.IsAllocated(b, p)) F.flux(b, bdir, p, k, j, i) = 0.;
+            } else if ((mask & FLUX_MASK_INFLOW) && m_rho >= 0) {
+                // Inner faces may only have outgoing (negative) flux, outer faces positive
+                F.flux(b, bdir, m_rho, k, j, i) = (side == 0) ? m::min(F.flux(b, bdir, m_rho, k, j, i), 0.)
+                                                              : m::max(F.flux(b, bdir, m_rho, k, j, i), 0.);
             }
         }
-    }
+    );
 
     return TaskStatus::complete;
 }
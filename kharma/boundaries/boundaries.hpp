@@ -68,14 +68,47 @@ template <IndexDomain domain>
 inline void ApplyBoundaryTemplate(std::shared_ptr<MeshBlockData<Real>> &rc, bool coarse)
 { ApplyBoundary(rc, domain, coarse); }
 
+/**
+ * Apply domain boundary conditions over all blocks of a MeshData object, as a replacement
+ * for Parthenon's ApplyBoundaryConditionsOnCoarseOrFineMD.
+ * The boundary conditions themselves are still applied per-block, but KHARMA's additions
+ * (EMF/face fixes at the poles, inflow checks) run once per face for all the blocks on it,
+ * rather than once per block per face.
+ * Outflow X1 boundaries are filled, checked for inflow and converted to conserved variables
+ * in a single kernel, where possible.
+ * Falls back to Parthenon's version for coarse buffers, or with boundaries/mesh_boundaries=false
+ */
+TaskStatus ApplyBoundariesMD(std::shared_ptr<MeshData<Real>> &md, bool coarse);
+
 /**
  * Fix fluxes on physical boundaries.
  * 1. Ensure no inflow of density onto the domain
  * 2. Ensure flux through the size-zero faces on poles is zero
  * The latter may be unnecessary
+ * All faces of all blocks are fixed in one kernel, using the masks below
  */
 TaskStatus FixFlux(MeshData<Real> *rc);
 
+/**
+ * Which boundary fixes apply to each block of a MeshData object, combining the options
+ * with each block's boundary flags.  Built the first time they're needed, and again
+ * only when the blocks in the MeshData change, e.g. after remeshing.
+ */
+struct BoundaryMasks {
+    // Identifies the blocks these masks were built for
+    std::vector<MeshBlock*> blocks;
+    // Per (block, face): FLUX_MASK_INFLOW to prevent inflow, FLUX_MASK_ZERO to zero all fluxes
+    ParArray2D<int> flux;
+    bool any_flux;
+    // Per block: CORNER_MASK_INNER/OUTER to re-apply the inner/outer X1 boundary after X2
+    std::vector<int> corner;
+};
+#define FLUX_MASK_INFLOW 1
+#define FLUX_MASK_ZERO 2
+#define CORNER_MASK_INNER 1
+#define CORNER_MASK_OUTER 2
+const BoundaryMasks& GetBoundaryMasks(MeshData<Real> *md);
+
 // INTERNAL FUNCTIONS
 
 /**
@@ -40,55 +40,129 @@
 
 using namespace parthenon;
 
-// TODO TODO unify getter/setter when we add face support
+// Get all ghosts, minus those in the B_Cleanup package if it is present
+// TODO TODO this won't do face fields, need a separate loop over (present) faces
+// and more logic for bounds buffer size
+inline Metadata::FlagCollection DirichletVars()
+{
+    using FC = Metadata::FlagCollection;
+    return FC({Metadata::FillGhost, Metadata::Conserved})
+         + FC({Metadata::FillGhost, Metadata::GetUserFlag("Primitive")})
+         - FC({Metadata::GetUserFlag("StartupOnly")});
+}
+
+int KBoundaries::DirichletSlot(const DirichletBuffer& buffer, int gid)
+{
+    const auto found = buffer.slots.find(gid);
+    return (found == buffer.slots.end()) ? -1 : found->second;
+}
+
+/**
+ * Get the buffer for a face, allocating it for all boundary blocks of the mesh on this rank
+ * if it doesn't yet cover the given block.  Any previous values are discarded when reallocating.
+ */
+template<typename T>
+static KBoundaries::DirichletBuffer& GetDirichletBuffer(T pmb, BoundaryFace bface, int nvar)
+{
+    auto& params = pmb->packages.Get("Boundaries")->AllParams();
+    auto& buffer = params.GetMutable<std::vector<KBoundaries::DirichletBuffer>>("dirichlet_buffers")->at(bface);
+    if (buffer.slots.count(pmb->gid) && buffer.data.extent_int(1) == nvar) return buffer;
+
+    buffer.slots.clear();
+    for (auto &pmb_other : pmb->pmy_mesh->block_list)
+        if (pmb_other->boundary_flag[bface] == BoundaryFlag::user) {
+            const int slot = buffer.slots.size();
+            buffer.slots[pmb_other->gid] = slot;
+        }
+    const auto domain = BoundaryDomain(bface);
+    const auto& bounds = pmb->cellbounds;
+    buffer.data = ParArray5D<Real>("Boundaries.dirichlet_" + BoundaryName(bface), buffer.slots.size(), nvar,
+                                   bounds.GetBoundsK(domain).e - bounds.GetBoundsK(domain).s + 1,
+                                   bounds.GetBoundsJ(domain).e - bounds.GetBoundsJ(domain).s + 1,
+                                   bounds.GetBoundsI(domain).e - bounds.GetBoundsI(domain).s + 1);
+    return buffer;
+}
+
 void KBoundaries::DirichletImpl(std::shared_ptr<MeshBlockData<Real>> &rc, BoundaryFace bface, bool coarse)
 {
     auto pmb = rc->GetBlockPointer();
-    const Real gam = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
 
-    // Get all ghosts, minus those in the B_Cleanup package if it is present
-    // TODO TODO this won't do face fields, need a separate loop over (present) faces
-    // and more logic for bounds buffer size
-    using FC = Metadata::FlagCollection;
-    FC ghost_vars = FC({Metadata::FillGhost, Metadata::Conserved})
-                  + FC({Metadata::FillGhost, Metadata::GetUserFlag("Primitive")})
-                  - FC({Metadata::GetUserFlag("StartupOnly")});
     PackIndexMap ghostmap;
-    auto q = rc->PackVariables(ghost_vars, ghostmap, coarse);
+    auto q = rc->PackVariables(DirichletVars(), ghostmap, coarse);
 
     // We're sometimes called without any variables to sync (e.g. syncing flags, EMFs), just return
     if (q.GetDim(4) == 0) return;
 
-    auto bound = rc->Get("Boundaries." + BoundaryName(bface)).data;
-    if (q.GetDim(4) != bound.GetDim(4)) {
-        std::cerr << "Dirichlet boundary mismatch! Boundary cache: " << bound.GetDim(4) << " for pack: " << q.GetDim(4) << std::endl;
+    auto& params = pmb->packages.Get("Boundaries")->AllParams();
+    const auto& buffer = params.Get<std::vector<DirichletBuffer>>("dirichlet_buffers")[bface];
+    auto bound = buffer.data;
+    if (q.GetDim(4) != bound.extent_int(1)) {
+        std::cerr << "Dirichlet boundary mismatch! Boundary cache: " << bound.extent_int(1) << " for pack: " << q.GetDim(4) << std::endl;
         std::cerr << "Variables with ghost zones:" << std::endl;
         ghostmap.print();
     }
+    const int slot = DirichletSlot(buffer, pmb->gid);
+    if (slot < 0) return;
 
     // Indices
     const IndexRange vars = IndexRange{0, q.GetDim(4) - 1};
-    const bool right = !BoundaryIsInner(bface);
-    // Subtract off the starting index if we're on the right
+    // Subtract off the start of the boundary domain
+    const auto domain = BoundaryDomain(bface);
     const auto bounds = coarse ? pmb->c_cellbounds : pmb->cellbounds;
-    const int dir = BoundaryDirection(bface);
-    const int ie = (dir == 1) ? bounds.ie(IndexDomain::interior) + 1 : 0;
-    const int je = (dir == 2) ? bounds.je(IndexDomain::interior) + 1 : 0;
-    const int ke = (dir == 3) ? bounds.ke(IndexDomain::interior) + 1 : 0;
-
-    const auto &G = pmb->coords;
+    const int is = bounds.GetBoundsI(domain).s;
+    const int js = bounds.GetBoundsJ(domain).s;
+    const int ks = bounds.GetBoundsK(domain).s;
 
-    // const int q_index = ghostmap["prims.q"].first;
-    const auto domain = BoundaryDomain(bface);
     pmb->par_for_bndry(
         "dirichlet_boundary", vars, domain, CC, coarse,
         KOKKOS_LAMBDA(const int &p, const int &k, const int &j, const int &i) {
-            if (right) {
-                q(p, k, j, i) = bound(p, k - ke, j - je, i - ie);
-            } else {
-                q(p, k, j, i) = bound(p, k, j, i);
-            }
-            // if (p == q_index) printf("%g ", q(p, k, j, i));
+            if (q.IsAllocated(p)) q(p, k, j, i) = bound(slot, p, k - ks, j - js, i - is);
+        }
+    );
+}
+
+void KBoundaries::DirichletMD(MeshData<Real> *md, BoundaryFace bface, const std::vector<int>& face_blocks)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+
+    PackIndexMap ghostmap;
+    auto q = md->PackVariables(DirichletVars(), ghostmap);
+    if (q.GetDim(4) == 0) return;
+    const int nvar = q.GetDim(4);
+
+    auto& params = pmb0->packages.Get("Boundaries")->AllParams();
+    const auto& buffer = params.Get<std::vector<DirichletBuffer>>("dirichlet_buffers")[bface];
+    auto bound = buffer.data;
+    if (nvar != bound.extent_int(1)) {
+        std::cerr << "Dirichlet boundary mismatch! Boundary cache: " << bound.extent_int(1) << " for pack: " << nvar << std::endl;
+        std::cerr << "Variables with ghost zones:" << std::endl;
+        ghostmap.print();
+    }
+
+    // Block index & buffer slot of each block on the face with frozen values
+    std::vector<std::pair<int, int>> frozen;
+    for (int b : face_blocks) {
+        const int slot = DirichletSlot(buffer, md->GetBlockData(b)->GetBlockPointer()->gid);
+        if (slot >= 0) frozen.push_back(std::make_pair(b, slot));
+    }
+    const int n_face = frozen.size();
+    if (n_face == 0) return;
+    ParArray2D<int> block_slots("dirichlet_slots", n_face, 2);
+    auto block_slots_h = block_slots.GetHostMirror();
+    for (int n = 0; n < n_face; n++) {
+        block_slots_h(n, 0) = frozen[n].first;
+        block_slots_h(n, 1) = frozen[n].second;
+    }
+    block_slots.DeepCopy(block_slots_h);
+
+    const auto domain = BoundaryDomain(bface);
+    const IndexRange ib = pmb0->cellbounds.GetBoundsI(domain);
+    const IndexRange jb = pmb0->cellbounds.GetBoundsJ(domain);
+    const IndexRange kb = pmb0->cellbounds.GetBoundsK(domain);
+    pmb0->par_for("dirichlet_boundary_md", 0, n_face - 1, 0, nvar - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int &n, const int &p, const int &k, const int &j, const int &i) {
+            if (q.IsAllocated(block_slots(n, 0), p))
+                q(block_slots(n, 0), p, k, j, i) = bound(block_slots(n, 1), p, k - kb.s, j - jb.s, i - ib.s);
         }
     );
 }
@@ -96,50 +170,34 @@ void KBoundaries::DirichletImpl(std::shared_ptr<MeshBlockData<Real>> &rc, Bounda
 void KBoundaries::SetDomainDirichlet(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse)
 {
     auto pmb = rc->GetBlockPointer();
-    const Real gam = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
     const BoundaryFace bface = BoundaryFaceOf(domain);
+    // Only blocks on the domain boundary keep values
+    if (pmb->boundary_flag[bface] != BoundaryFlag::user) return;
 
-    using FC = Metadata::FlagCollection;
-    FC ghost_vars = FC({Metadata::FillGhost, Metadata::Conserved}) + FC({Metadata::FillGhost, Metadata::GetUserFlag("Primitive")});
-    FC main_ghosts = ghost_vars - FC({Metadata::GetUserFlag("StartupOnly")});
     PackIndexMap ghostmap;
-    auto q = rc->PackVariables(main_ghosts, ghostmap, coarse);
-    const int q_index = ghostmap["prims.q"].first;
+    auto q = rc->PackVariables(DirichletVars(), ghostmap, coarse);
 
     // We're sometimes called without any variables to sync (e.g. syncing flags, EMFs), just return
     if (q.GetDim(4) == 0) return;
 
-    auto bound = rc->Get("Boundaries." + BoundaryName(bface)).data;
-    if (q.GetDim(4) != bound.GetDim(4)) {
-        std::cerr << "Dirichlet boundary mismatch! Boundary cache: " << bound.GetDim(4) << " for pack: " << q.GetDim(4) << std::endl;
-        std::cerr << "Variables with ghost zones:" << std::endl;
-        ghostmap.print();
-    }
+    auto& buffer = GetDirichletBuffer(pmb, bface, q.GetDim(4));
+    auto bound = buffer.data;
+    const int slot = DirichletSlot(buffer, pmb->gid);
 
     const IndexRange vars = IndexRange{0, q.GetDim(4) - 1};
-    const bool right = !BoundaryIsInner(domain);
-
-    // Subtract off the starting index if we're on the right
+    // Subtract off the start of the boundary domain
     const auto bounds = coarse ? pmb->c_cellbounds : pmb->cellbounds;
-    const int dir = BoundaryDirection(bface);
-    const int ie = (dir == 1) ? bounds.ie(IndexDomain::interior) + 1 : 0;
-    const int je = (dir == 2) ? bounds.je(IndexDomain::interior) + 1 : 0;
-    const int ke = (dir == 3) ? bounds.ke(IndexDomain::interior) + 1 : 0;
-
-    const auto &G = pmb->coords;
+    const int is = bounds.GetBoundsI(domain).s;
+    const int js = bounds.GetBoundsJ(domain).s;
+    const int ks = bounds.GetBoundsK(domain).s;
 
     pmb->par_for_bndry(
         "dirichlet_boundary", vars, domain, CC, coarse,
         KOKKOS_LAMBDA(const int &p, const int &k, const int &j, const int &i) {
-            if (right) {
-                bound(p, k - ke, j - je, i - ie) = q(p, k, j, i);
-            } else {
-                bound(p, k, j, i) = q(p, k, j, i);
-            }
+            bound(slot, p, k - ks, j - js, i - is) = q.IsAllocated(p) ? q(p, k, j, i) : 0.;
         }
     );
 }
-
 void KBoundaries::FreezeDirichlet(std::shared_ptr<MeshData<Real>> &md)
 {
     // For each face...
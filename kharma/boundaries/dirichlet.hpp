@@ -37,6 +37,29 @@
 
 namespace KBoundaries {
 
+/**
+ * Frozen Dirichlet values for one face of the domain, for only the blocks on that face.
+ * Values of all blocks are kept contiguously, indexed (slot, var, k, j, i), where the
+ * ghost zones (of the fine buffers) are numbered from 0.
+ */
+struct DirichletBuffer {
+    ParArray5D<Real> data;
+    // Slot in data for the block with each global ID
+    std::map<int, int> slots;
+};
+
+/**
+ * Slot of a block in the Dirichlet buffer of its face, or -1 if the block's values
+ * were never frozen (e.g. before initialization, or if it was created by remeshing).
+ * Such blocks are left alone when applying boundaries.
+ */
+int DirichletSlot(const DirichletBuffer& buffer, int gid);
+
+/**
+ * Apply Dirichlet boundaries on the given face to the listed blocks (indices in md) at once
+ */
+void DirichletMD(MeshData<Real> *md, BoundaryFace bface, const std::vector<int>& face_blocks);
+
 void DirichletImpl(std::shared_ptr<MeshBlockData<Real>> &rc, BoundaryFace bface, bool coarse);
 
 template <BoundaryFace bface>
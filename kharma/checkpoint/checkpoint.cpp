@@ -0,0 +1,801 @@
+/* 
+ *  File: checkpoint.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "checkpoint.hpp"
+
+#include "kharma.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <set>
+#include <thread>
+
+using HostArray = decltype(std::declval<GridScalar>().GetHostMirror());
+
+// Host copies of this rank's blocks for the checkpoint being written.
+// Only touched by the writer thread between a snapshot and the next join
+static struct {
+    std::thread writer;
+    std::string fname;
+    Real time, dt;
+    int ncycle, nranks;
+    std::vector<std::string> names;
+    std::vector<int> gids;
+    std::vector<std::vector<HostArray>> data;
+} staging;
+
+// Aggregated checkpoints: each group of ranks (by default, a node) gathers its serialized blocks
+// to the group's first rank, which writes them as one file.  The gather is started after staging
+// and checked each step, and only the writer thread waits on the filesystem
+static struct {
+    int group_size = 1;
+    int group = 0, ngroups = 1;
+#ifdef MPI_PARALLEL
+    MPI_Comm comm = MPI_COMM_NULL;
+    MPI_Datatype word;
+    MPI_Request request;
+#endif
+    bool pending = false;
+    std::string fname;
+    Real time, dt;
+    int ncycle, nblocks;
+    std::vector<std::string> names;
+    // This rank's blocks, and on the writer, every member's at displs (in words) with byte counts sizes
+    std::vector<char> mine, all;
+    std::vector<long> sizes;
+    std::vector<int> counts, displs;
+} aggregate;
+
+// Aggregated buffers are sent in 8-byte words, so counts & displacements in int reach 16GB per group
+static constexpr int word_size = 8;
+
+// Index of a checkpoint for restarting: file and offset of each block's data, by gid
+static struct {
+    bool read = false;
+    std::vector<std::string> names;
+    std::map<int, std::pair<std::string, long>> blocks;
+} restart_index;
+
+// Blocks of an in-memory checkpoint gathered onto this rank for restarting, by gid.
+// Each holds the block's variables exactly as laid out in a checkpoint file
+static struct {
+    bool assembled = false;
+    int ncycle = -1;
+    std::vector<std::string> names;
+    std::vector<std::string> files;
+    std::map<int, std::vector<char>> blocks;
+} memory_restart;
+
+static constexpr char magic[8] = {'K', 'H', 'A', 'R', 'M', 'A', 'C', 'K'};
+
+static std::string RankFileName(const std::string& base, int rank)
+{
+    return base + "." + std::to_string(rank) + ".bin";
+}
+
+// In-memory checkpoints: <dir>/<file>.mem<generation>.<rank>.bin, for the blocks of 'rank'
+static std::string MemoryFileName(const std::string& dir, const std::string& base, int generation, int rank)
+{
+    return RankFileName(dir + "/" + base + ".mem" + std::to_string(generation), rank);
+}
+
+std::shared_ptr<KHARMAPackage> Checkpoint::Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages)
+{
+    auto pkg = std::make_shared<KHARMAPackage>("Checkpoint");
+    Params &params = pkg->AllParams();
+
+    // Options
+    Real dt = pin->GetOrAddReal("checkpoint", "dt", -1.);
+    params.Add("dt", dt);
+    // Files are <file>.<number>.<rank>.bin, numbered by time so restarts continue the sequence
+    std::string file = pin->GetOrAddString("checkpoint", "file", "checkpoint");
+    params.Add("file", file);
+    // Write in a background thread.  Otherwise, block until each checkpoint is written
+    bool async = pin->GetOrAddBoolean("checkpoint", "async", true);
+    params.Add("async", async);
+    // Ranks per checkpoint file.  The first rank of each group gathers & writes its members' blocks,
+    // making fewer, larger writes.  0 gathers each node's ranks, default 1 writes a file per rank.
+    // Files are then numbered by group rather than rank, which restarts don't need to know
+    int aggregate_ranks = pin->GetOrAddInteger("checkpoint", "aggregate", 1);
+    params.Add("aggregate", aggregate_ranks);
+#ifdef MPI_PARALLEL
+    if (aggregate_ranks != 1 && aggregate.comm == MPI_COMM_NULL) {
+        if (aggregate_ranks == 0) {
+            PARTHENON_MPI_CHECK(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &aggregate.comm));
+        } else {
+            PARTHENON_MPI_CHECK(MPI_Comm_split(MPI_COMM_WORLD, MPIRank() / aggregate_ranks, 0, &aggregate.comm));
+        }
+        PARTHENON_MPI_CHECK(MPI_Comm_size(aggregate.comm, &aggregate.group_size));
+        // Number the groups in order of their writers
+        int group_rank;
+        PARTHENON_MPI_CHECK(MPI_Comm_rank(aggregate.comm, &group_rank));
+        std::vector<int> writers(MPINumRanks());
+        int is_writer = (group_rank == 0);
+        PARTHENON_MPI_CHECK(MPI_Allgather(&is_writer, 1, MPI_INT, writers.data(), 1, MPI_INT, MPI_COMM_WORLD));
+        aggregate.ngroups = std::count(writers.begin(), writers.end(), 1);
+        int writer_rank = MPIRank();
+        PARTHENON_MPI_CHECK(MPI_Bcast(&writer_rank, 1, MPI_INT, 0, aggregate.comm));
+        aggregate.group = std::count(writers.begin(), writers.begin() + writer_rank, 1);
+        PARTHENON_MPI_CHECK(MPI_Type_contiguous(word_size, MPI_BYTE, &aggregate.word));
+        PARTHENON_MPI_CHECK(MPI_Type_commit(&aggregate.word));
+    }
+#endif
+
+    // Simulation time of the next checkpoint
+    params.Add("next_time", (Real) 0., true);
+
+    // Every memory_interval steps, also keep a checkpoint in node memory (memory_dir, a tmpfs), plus
+    // a replica of a partner rank's on another node.  Two generations are kept, so one is always complete.
+    // After a node failure, restart with checkpoint/restart_from_memory=true on the surviving nodes (plus
+    // replacements, same number of ranks per node), without reading the parallel filesystem
+    int memory_interval = pin->GetOrAddInteger("checkpoint", "memory_interval", 0);
+    params.Add("memory_interval", memory_interval);
+    std::string memory_dir = pin->GetOrAddString("checkpoint", "memory_dir", "/dev/shm");
+    params.Add("memory_dir", memory_dir);
+    // Each rank replicates to rank + partner_offset.  Default is the number of ranks per node,
+    // so that the partner is on the next node
+    int partner_offset = pin->GetOrAddInteger("checkpoint", "partner_offset", -1);
+    if (partner_offset < 0) {
+        partner_offset = 1;
+#ifdef MPI_PARALLEL
+        MPI_Comm node_comm;
+        PARTHENON_MPI_CHECK(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm));
+        PARTHENON_MPI_CHECK(MPI_Comm_size(node_comm, &partner_offset));
+        PARTHENON_MPI_CHECK(MPI_Comm_free(&node_comm));
+#endif
+    }
+    if (memory_interval > 0 && partner_offset % MPINumRanks() == 0 && MPIRank0())
+        std::cout << "WARNING: in-memory checkpoints have no partner on another node, and will not survive a node failure!" << std::endl;
+    params.Add("partner_offset", partner_offset);
+    // Number of in-memory checkpoints taken, for alternating generations
+    params.Add("memory_count", 0, true);
+
+    pkg->PostStepDiagnosticsMesh = Checkpoint::PostStepDiagnostics;
+    pkg->PostExecute = Checkpoint::PostExecute;
+
+    return pkg;
+}
+
+// Header of a checkpoint file.  'nfiles' is the number of files in the set, one per rank or group
+static void WriteHeaderTo(FILE *fp, Real time, Real dt, int ncycle, int nfiles, int nblocks,
+                          const std::vector<std::string>& names)
+{
+    const int nvars = names.size();
+    fwrite(magic, sizeof(char), 8, fp);
+    fwrite(&time, sizeof(Real), 1, fp);
+    fwrite(&dt, sizeof(Real), 1, fp);
+    fwrite(&ncycle, sizeof(int), 1, fp);
+    fwrite(&nfiles, sizeof(int), 1, fp);
+    fwrite(&nblocks, sizeof(int), 1, fp);
+    fwrite(&nvars, sizeof(int), 1, fp);
+    for (auto& name : names) {
+        const int len = name.size();
+        fwrite(&len, sizeof(int), 1, fp);
+        fwrite(name.c_str(), sizeof(char), len, fp);
+    }
+}
+
+static void WriteBlocksTo(FILE *fp)
+{
+    const int nblocks = staging.gids.size();
+    for (int b = 0; b < nblocks; b++) {
+        fwrite(&staging.gids[b], sizeof(int), 1, fp);
+        for (auto& var : staging.data[b]) {
+            const long n = var.GetSize();
+            fwrite(&n, sizeof(long), 1, fp);
+            fwrite(var.data(), sizeof(Real), n, fp);
+        }
+    }
+}
+
+static void WriteStagedTo(FILE *fp)
+{
+    WriteHeaderTo(fp, staging.time, staging.dt, staging.ncycle, staging.nranks, staging.gids.size(), staging.names);
+    WriteBlocksTo(fp);
+}
+
+static void WriteStaged()
+{
+    FILE *fp = fopen(staging.fname.c_str(), "wb");
+    if (fp == nullptr) {
+        // Can't throw from the writer thread, so just yell
+        fprintf(stderr, "Could not open checkpoint file %s!\n", staging.fname.c_str());
+        return;
+    }
+    WriteStagedTo(fp);
+    fclose(fp);
+}
+
+// On a group's writer, write every member's gathered blocks after one header
+static void WriteAggregated()
+{
+    FILE *fp = fopen(aggregate.fname.c_str(), "wb");
+    if (fp == nullptr) {
+        fprintf(stderr, "Could not open checkpoint file %s!\n", aggregate.fname.c_str());
+        return;
+    }
+    WriteHeaderTo(fp, aggregate.time, aggregate.dt, aggregate.ncycle, aggregate.ngroups, aggregate.nblocks, aggregate.names);
+    for (int m = 0; m < aggregate.sizes.size(); m++)
+        fwrite(aggregate.all.data() + (long) aggregate.displs[m] * word_size, sizeof(char), aggregate.sizes[m], fp);
+    fclose(fp);
+}
+
+// Check on (or with wait, finish) any gather in flight, starting the write once the writer has everything
+static void ProgressAggregation(bool wait, bool async)
+{
+    if (!aggregate.pending) return;
+#ifdef MPI_PARALLEL
+    int done = 0;
+    if (wait) {
+        PARTHENON_MPI_CHECK(MPI_Wait(&aggregate.request, MPI_STATUS_IGNORE));
+        done = 1;
+    } else {
+        PARTHENON_MPI_CHECK(MPI_Test(&aggregate.request, &done, MPI_STATUS_IGNORE));
+    }
+    if (!done) return;
+#endif
+    aggregate.pending = false;
+    if (aggregate.sizes.empty()) return; // not the writer
+    if (async) {
+        staging.writer = std::thread(WriteAggregated);
+    } else {
+        WriteAggregated();
+    }
+}
+
+#ifdef MPI_PARALLEL
+// Serialize the staged blocks, and start gathering them to the group's writer
+static void StartAggregation(const std::string& fname)
+{
+    char *ptr = nullptr;
+    size_t size = 0;
+    FILE *fp = open_memstream(&ptr, &size);
+    WriteBlocksTo(fp);
+    fclose(fp);
+    const long nbytes = size;
+    aggregate.mine.assign(ptr, ptr + size);
+    free(ptr);
+    aggregate.mine.resize((nbytes + word_size - 1) / word_size * word_size);
+
+    int group_rank;
+    PARTHENON_MPI_CHECK(MPI_Comm_rank(aggregate.comm, &group_rank));
+    const bool writer = (group_rank == 0);
+    std::vector<long> sizes(writer ? aggregate.group_size : 0);
+    PARTHENON_MPI_CHECK(MPI_Gather(&nbytes, 1, MPI_LONG, sizes.data(), 1, MPI_LONG, 0, aggregate.comm));
+    int nblocks = staging.gids.size();
+    PARTHENON_MPI_CHECK(MPI_Reduce(&nblocks, &aggregate.nblocks, 1, MPI_INT,
+                                   MPI_SUM, 0, aggregate.comm));
+
+    aggregate.sizes = sizes;
+    aggregate.counts.assign(sizes.size(), 0);
+    aggregate.displs.assign(sizes.size(), 0);
+    long total = 0;
+    for (int m = 0; m < sizes.size(); m++) {
+        aggregate.counts[m] = (sizes[m] + word_size - 1) / word_size;
+        aggregate.displs[m] = total;
+        total += aggregate.counts[m];
+    }
+    if (total > std::numeric_limits<int>::max())
+        throw std::runtime_error("Ranks' blocks are too large to aggregate: use a smaller checkpoint/aggregate!");
+    if (writer) {
+        aggregate.all.resize(total * word_size);
+        aggregate.fname = fname;
+        aggregate.time = staging.time;
+        aggregate.dt = staging.dt;
+        aggregate.ncycle = staging.ncycle;
+        aggregate.names = staging.names;
+    }
+    PARTHENON_MPI_CHECK(MPI_Igatherv(aggregate.mine.data(), aggregate.mine.size() / word_size, aggregate.word,
+                                     aggregate.all.data(), aggregate.counts.data(), aggregate.displs.data(),
+                                     aggregate.word, 0, aggregate.comm, &aggregate.request));
+    aggregate.pending = true;
+}
+#endif
+
+// Copy the restart variables of each local block to host
+static void StageBlocks(Mesh *pmesh, Real time, Real dt, int ncycle)
+{
+    staging.time = time;
+    staging.dt = dt;
+    staging.ncycle = ncycle;
+    staging.nranks = MPINumRanks();
+
+    // Only the state needed to resume, as in Parthenon restarts: the independent (conserved) variables
+    // including any face fields, and the GRMHD primitives flagged Restart to seed UtoP.
+    // Anything else is rebuilt in PostInitialize, see ReadBlockVars
+    using FC = Metadata::FlagCollection;
+    if (staging.names.empty()) {
+        auto flags = FC({Metadata::Independent, Metadata::Restart}, true);
+        if (pmesh->packages.AllPackages().count("StartupOnly"))
+            flags = flags - Metadata::GetUserFlag("StartupOnly");
+        staging.names = KHARMA::GetVariableNames(&(pmesh->packages), flags);
+    }
+
+    // Copy each block to host, reusing buffers unless the blocks changed (e.g. after remeshing)
+    const int nblocks = pmesh->block_list.size();
+    bool same_blocks = (staging.gids.size() == nblocks);
+    for (int b = 0; same_blocks && b < nblocks; b++)
+        same_blocks = (staging.gids[b] == pmesh->block_list[b]->gid);
+    if (!same_blocks) {
+        staging.gids.clear();
+        staging.data.clear();
+    }
+    for (int b = 0; b < nblocks; b++) {
+        auto& pmb = pmesh->block_list[b];
+        auto rc = pmb->meshblock_data.Get();
+        if (!same_blocks) {
+            staging.gids.push_back(pmb->gid);
+            staging.data.emplace_back();
+            for (auto& name : staging.names)
+                staging.data[b].push_back(rc->Get(name).data.GetHostMirror());
+        }
+        for (int v = 0; v < staging.names.size(); v++)
+            staging.data[b][v].DeepCopy(rc->Get(staging.names[v]).data);
+    }
+    Kokkos::fence();
+}
+
+// Write a buffer to a file in memory_dir, replacing any old one only once it's complete
+static void WriteMemoryFile(const std::string& fname, const std::vector<char>& buf)
+{
+    const std::string tmp = fname + ".tmp";
+    FILE *fp = fopen(tmp.c_str(), "wb");
+    if (fp == nullptr) throw std::runtime_error("Could not open in-memory checkpoint file "+tmp);
+    const bool ok = fwrite(buf.data(), sizeof(char), buf.size(), fp) == buf.size();
+    fclose(fp);
+    if (!ok) throw std::runtime_error("Could not write in-memory checkpoint file "+tmp+": out of memory?");
+    std::rename(tmp.c_str(), fname.c_str());
+}
+
+// Serialize the local blocks, swap with the partner ranks, and keep both copies in memory_dir
+static void MemoryCheckpoint(Mesh *pmesh, Real time, Real dt, int ncycle)
+{
+    auto& pars = pmesh->packages.Get("Checkpoint")->AllParams();
+    const std::string dir = pars.Get<std::string>("memory_dir");
+    const std::string base = pars.Get<std::string>("file");
+    const int nranks = MPINumRanks(), rank = MPIRank();
+    const int offset = pars.Get<int>("partner_offset") % nranks;
+    const int count = pars.Get<int>("memory_count");
+    pars.Update<int>("memory_count", count + 1);
+    const int generation = count % 2;
+
+    Flag("MemoryCheckpoint");
+    // Staging buffers are shared with disk checkpoints
+    if (staging.writer.joinable()) staging.writer.join();
+    StageBlocks(pmesh, time, dt, ncycle);
+
+    char *ptr = nullptr;
+    size_t size = 0;
+    FILE *fp = open_memstream(&ptr, &size);
+    WriteStagedTo(fp);
+    fclose(fp);
+    std::vector<char> mine(ptr, ptr + size);
+    free(ptr);
+    WriteMemoryFile(MemoryFileName(dir, base, generation, rank), mine);
+
+    if (offset != 0) {
+#ifdef MPI_PARALLEL
+        const int dest = (rank + offset) % nranks, src = (rank - offset + nranks) % nranks;
+        if (mine.size() > std::numeric_limits<int>::max())
+            throw std::runtime_error("Rank's blocks are too large for an in-memory checkpoint!");
+        long my_size = mine.size(), their_size = 0;
+        PARTHENON_MPI_CHECK(MPI_Sendrecv(&my_size, 1, MPI_LONG, dest, 0, &their_size, 1, MPI_LONG, src, 0,
+                                         MPI_COMM_WORLD, MPI_STATUS_IGNORE));
+        std::vector<char> theirs(their_size);
+        PARTHENON_MPI_CHECK(MPI_Sendrecv(mine.data(), my_size, MPI_BYTE, dest, 1, theirs.data(), their_size, MPI_BYTE, src, 1,
+                                         MPI_COMM_WORLD, MPI_STATUS_IGNORE));
+        WriteMemoryFile(MemoryFileName(dir, base, generation, src), theirs);
+#endif
+    }
+    EndFlag();
+}
+
+TaskStatus Checkpoint::PostStepDiagnostics(const SimTime& tm, MeshData<Real> *md)
+{
+    auto pmesh = md->GetMeshPointer();
+    auto& pars = pmesh->packages.Get("Checkpoint")->AllParams();
+    const bool async = pars.Get<bool>("async");
+    // Start writing an aggregated checkpoint once its gather completes
+    ProgressAggregation(false, async);
+
+    const int memory_interval = pars.Get<int>("memory_interval");
+    if (memory_interval > 0 && (tm.ncycle + 1) % memory_interval == 0) {
+        // Diagnostics run at the end of the step, so checkpoint the next cycle number
+        MemoryCheckpoint(pmesh, tm.time, tm.dt, tm.ncycle + 1);
+    }
+
+    const Real dt = pars.Get<Real>("dt");
+    if (dt <= 0. || tm.time < pars.Get<Real>("next_time")) return TaskStatus::complete;
+    // Schedule from the current time, so restarts don't write a burst of checkpoints
+    pars.Update<Real>("next_time", (m::floor(tm.time / dt) + 1) * dt);
+
+    Flag("Checkpoint");
+    // The only barrier: the last checkpoint must be written before we overwrite its buffers
+    ProgressAggregation(true, async);
+    if (staging.writer.joinable()) staging.writer.join();
+
+    const int num = static_cast<int>(m::floor(tm.time / dt + 1.e-6));
+    char numstr[16];
+    snprintf(numstr, 16, "%05d", num);
+    const std::string base = pars.Get<std::string>("file") + "." + numstr;
+    StageBlocks(pmesh, tm.time, tm.dt, tm.ncycle);
+
+#ifdef MPI_PARALLEL
+    if (pars.Get<int>("aggregate") != 1) {
+        StartAggregation(RankFileName(base, aggregate.group));
+        if (!async) ProgressAggregation(true, async);
+        EndFlag();
+        return TaskStatus::complete;
+    }
+#endif
+    staging.fname = RankFileName(base, MPIRank());
+    if (async) {
+        staging.writer = std::thread(WriteStaged);
+    } else {
+        WriteStaged();
+    }
+
+    EndFlag();
+    return TaskStatus::complete;
+}
+
+void Checkpoint::PostExecute(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+    if (staging.writer.joinable()) staging.writer.join();
+    ProgressAggregation(true, false);
+}
+
+// Read the header of a rank's checkpoint file, leaving fp at the first block
+static FILE *OpenCheckpoint(const std::string& fname, Real& time, Real& dt, int& ncycle, int& nranks,
+                            int& nblocks, std::vector<std::string>& names)
+{
+    FILE *fp = fopen(fname.c_str(), "rb");
+    if (fp == nullptr) throw std::runtime_error("Could not open checkpoint file "+fname);
+    char file_magic[8];
+    int nvars;
+    bool ok = fread(file_magic, sizeof(char), 8, fp) == 8 && std::equal(file_magic, file_magic + 8, magic);
+    ok = ok && fread(&time, sizeof(Real), 1, fp) == 1 && fread(&dt, sizeof(Real), 1, fp) == 1;
+    ok = ok && fread(&ncycle, sizeof(int), 1, fp) == 1 && fread(&nranks, sizeof(int), 1, fp) == 1;
+    ok = ok && fread(&nblocks, sizeof(int), 1, fp) == 1 && fread(&nvars, sizeof(int), 1, fp) == 1;
+    if (!ok) throw std::runtime_error("Not a KHARMA checkpoint file: "+fname);
+    names.clear();
+    for (int v = 0; v < nvars; v++) {
+        int len;
+        if (fread(&len, sizeof(int), 1, fp) != 1) throw std::runtime_error("Corrupt checkpoint file: "+fname);
+        std::string name(len, ' ');
+        if (fread(&name[0], sizeof(char), len, fp) != len) throw std::runtime_error("Corrupt checkpoint file: "+fname);
+        names.push_back(name);
+    }
+    return fp;
+}
+
+// Find the newest in-memory checkpoint with a copy of every rank's blocks somewhere, and its time
+static void FindMemoryCheckpoint(ParameterInput *pin, Real& time, Real& dt, int& ncycle)
+{
+    const std::string dir = pin->GetOrAddString("checkpoint", "memory_dir", "/dev/shm");
+    const std::string base = pin->GetOrAddString("checkpoint", "file", "checkpoint");
+
+    // Headers of every copy in this node's memory_dir: (ncycle, source rank, number of ranks)
+    std::vector<int> local;
+    std::map<int, std::vector<std::string>> local_files;
+    std::map<int, std::pair<Real, Real>> local_times;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        const std::string fname = entry.path().filename().string();
+        if (fname.rfind(base + ".mem", 0) != 0 || fname.size() < 4 || fname.substr(fname.size() - 4) != ".bin") continue;
+        Real f_time, f_dt;
+        int f_ncycle, f_nranks, f_nblocks, src;
+        std::vector<std::string> names;
+        try {
+            FILE *fp = OpenCheckpoint(entry.path().string(), f_time, f_dt, f_ncycle, f_nranks, f_nblocks, names);
+            fclose(fp);
+            // Source rank is the last field of the name
+            const std::string stem = fname.substr(0, fname.size() - 4);
+            src = std::stoi(stem.substr(stem.rfind('.') + 1));
+        } catch (const std::exception& e) {
+            // Partial copies from a failure mid-write are expected, just skip them
+            continue;
+        }
+        local.insert(local.end(), {f_ncycle, src, f_nranks});
+        local_files[f_ncycle].push_back(entry.path().string());
+        local_times[f_ncycle] = {f_time, f_dt};
+    }
+
+    std::vector<int> all = local;
+#ifdef MPI_PARALLEL
+    const int nranks_now = MPINumRanks();
+    int nlocal = local.size();
+    std::vector<int> counts(nranks_now), displs(nranks_now, 0);
+    PARTHENON_MPI_CHECK(MPI_Allgather(&nlocal, 1, MPI_INT, counts.data(), 1, MPI_INT, MPI_COMM_WORLD));
+    for (int r = 1; r < nranks_now; r++) displs[r] = displs[r-1] + counts[r-1];
+    all.resize(displs[nranks_now-1] + counts[nranks_now-1]);
+    PARTHENON_MPI_CHECK(MPI_Allgatherv(local.data(), nlocal, MPI_INT, all.data(), counts.data(), displs.data(),
+                                       MPI_INT, MPI_COMM_WORLD));
+#endif
+
+    // Newest cycle for which every source rank survives somewhere
+    std::map<int, std::set<int>> sources;
+    std::map<int, int> nranks_of;
+    for (int i = 0; i < all.size(); i += 3) {
+        sources[all[i]].insert(all[i+1]);
+        nranks_of[all[i]] = all[i+2];
+    }
+    ncycle = -1;
+    for (auto it = sources.rbegin(); it != sources.rend(); ++it) {
+        if (it->second.size() == nranks_of[it->first]) {
+            ncycle = it->first;
+            break;
+        }
+    }
+    if (ncycle < 0)
+        throw std::runtime_error("No complete in-memory checkpoint found in "+dir+": restart from disk instead!");
+
+    memory_restart.ncycle = ncycle;
+    memory_restart.files = local_files[ncycle];
+    time = local_times.count(ncycle) ? local_times[ncycle].first : std::numeric_limits<Real>::lowest();
+    dt = local_times.count(ncycle) ? local_times[ncycle].second : std::numeric_limits<Real>::lowest();
+#ifdef MPI_PARALLEL
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_PARTHENON_REAL, MPI_MAX, MPI_COMM_WORLD));
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &dt, 1, MPI_PARTHENON_REAL, MPI_MAX, MPI_COMM_WORLD));
+#endif
+    if (MPIRank0())
+        std::cout << "Restarting from in-memory checkpoint at cycle " << ncycle << ", time " << time << std::endl;
+}
+
+void Checkpoint::ReadCheckpointHeader(std::string fname, ParameterInput *pin)
+{
+    Real time, dt;
+    int ncycle;
+    if (pin->GetOrAddBoolean("checkpoint", "restart_from_memory", false)) {
+        FindMemoryCheckpoint(pin, time, dt, ncycle);
+    } else {
+        // Read from rank 0 only, rather than opening the same file from every rank
+        if (MPIRank0()) {
+            int nranks, nblocks;
+            std::vector<std::string> names;
+            FILE *fp = OpenCheckpoint(RankFileName(fname, 0), time, dt, ncycle, nranks, nblocks, names);
+            fclose(fp);
+        }
+#ifdef MPI_PARALLEL
+        PARTHENON_MPI_CHECK(MPI_Bcast(&time, 1, MPI_PARTHENON_REAL, 0, MPI_COMM_WORLD));
+        PARTHENON_MPI_CHECK(MPI_Bcast(&dt, 1, MPI_PARTHENON_REAL, 0, MPI_COMM_WORLD));
+        PARTHENON_MPI_CHECK(MPI_Bcast(&ncycle, 1, MPI_INT, 0, MPI_COMM_WORLD));
+#endif
+    }
+
+    pin->SetReal("parthenon/time", "start_time", time);
+    pin->SetReal("parthenon/time", "dt", dt);
+    pin->SetInteger("parthenon/time", "ncycle", ncycle);
+}
+
+// Read each variable of one block from fp, positioned just after its gid
+static void ReadBlockVars(FILE *fp, const std::string& fname, const std::vector<std::string>& names,
+                          std::shared_ptr<MeshBlockData<Real>> rc)
+{
+    auto pmb = rc->GetBlockPointer();
+    using FC = Metadata::FlagCollection;
+    // Older checkpoints recorded all primitive & conserved variables, and still load: any derived
+    // variables they contain are read, then overwritten when PostInitialize recovers them
+    const auto names_here = KHARMA::GetVariableNames(&(pmb->packages),
+                                FC({Metadata::Independent, Metadata::Restart,
+                                    Metadata::GetUserFlag("Primitive"), Metadata::Conserved}, true));
+    for (auto& name : names) {
+        long n;
+        if (fread(&n, sizeof(long), 1, fp) != 1) throw std::runtime_error("Corrupt checkpoint file: "+fname);
+        // Variables not present in this run are skipped, sizes must match otherwise
+        if (std::find(names_here.begin(), names_here.end(), name) == names_here.end()) {
+            fseek(fp, n * sizeof(Real), SEEK_CUR);
+            continue;
+        }
+        auto host = rc->Get(name).data.GetHostMirror();
+        if (host.GetSize() != n)
+            throw std::runtime_error("Checkpoint variable "+name+" has the wrong size: mesh or blocks changed?");
+        if (fread(host.data(), sizeof(Real), n, fp) != n)
+            throw std::runtime_error("Corrupt checkpoint file: "+fname);
+        rc->Get(name).data.DeepCopy(host);
+    }
+}
+
+// Collect the blocks this rank needs from the surviving in-memory copies on every rank.
+// Collective: called once from the first ReadCheckpoint on each rank
+static void AssembleMemoryCheckpoint(Mesh *pmesh)
+{
+    // Every block in this node's copies of the chosen cycle, duplicates from replication included once
+    std::map<int, std::vector<char>> available;
+    for (auto& fname : memory_restart.files) {
+        Real time, dt;
+        int ncycle, nranks, nblocks;
+        FILE *fp = OpenCheckpoint(fname, time, dt, ncycle, nranks, nblocks, memory_restart.names);
+        for (int b = 0; b < nblocks; b++) {
+            int gid;
+            if (fread(&gid, sizeof(int), 1, fp) != 1) throw std::runtime_error("Corrupt checkpoint file: "+fname);
+            const long start = ftell(fp);
+            for (int v = 0; v < memory_restart.names.size(); v++) {
+                long n;
+                if (fread(&n, sizeof(long), 1, fp) != 1) throw std::runtime_error("Corrupt checkpoint file: "+fname);
+                fseek(fp, n * sizeof(Real), SEEK_CUR);
+            }
+            const long end = ftell(fp);
+            if (available.count(gid)) continue;
+            std::vector<char> buf(end - start);
+            fseek(fp, start, SEEK_SET);
+            if (fread(buf.data(), sizeof(char), buf.size(), fp) != buf.size())
+                throw std::runtime_error("Corrupt checkpoint file: "+fname);
+            available[gid] = std::move(buf);
+        }
+        fclose(fp);
+    }
+
+    std::vector<int> needed;
+    for (auto& pmb : pmesh->block_list) needed.push_back(pmb->gid);
+
+#ifdef MPI_PARALLEL
+    // Where is each block, and where does it need to go?  Blocks are sent by the lowest rank holding them
+    const int nranks = MPINumRanks(), rank = MPIRank();
+    auto allgather = [nranks](const std::vector<int>& mine, std::vector<int>& owner) {
+        int n = mine.size();
+        std::vector<int> counts(nranks), displs(nranks, 0);
+        PARTHENON_MPI_CHECK(MPI_Allgather(&n, 1, MPI_INT, counts.data(), 1, MPI_INT, MPI_COMM_WORLD));
+        for (int r = 1; r < nranks; r++) displs[r] = displs[r-1] + counts[r-1];
+        std::vector<int> all(displs[nranks-1] + counts[nranks-1]);
+        PARTHENON_MPI_CHECK(MPI_Allgatherv(mine.data(), n, MPI_INT, all.data(), counts.data(), displs.data(),
+                                           MPI_INT, MPI_COMM_WORLD));
+        // owner[i] = rank of entry i
+        owner.resize(all.size());
+        for (int r = 0; r < nranks; r++)
+            for (int i = displs[r]; i < displs[r] + counts[r]; i++) owner[i] = r;
+        return all;
+    };
+    std::vector<int> have;
+    for (auto& kv : available) have.push_back(kv.first);
+    std::vector<int> have_rank, need_rank;
+    const auto all_have = allgather(have, have_rank);
+    const auto all_need = allgather(needed, need_rank);
+    std::map<int, int> provider, destination;
+    for (int i = 0; i < all_have.size(); i++)
+        if (!provider.count(all_have[i])) provider[all_have[i]] = have_rank[i];
+    for (int i = 0; i < all_need.size(); i++) destination[all_need[i]] = need_rank[i];
+
+    // Sizes, then payloads, each posted in gid order so messages match between each pair of ranks
+    std::vector<MPI_Request> requests;
+    std::map<int, long> sizes;
+    for (auto& kv : destination) {
+        const int gid = kv.first, dest = kv.second;
+        if (!provider.count(gid)) continue;
+        const int src = provider[gid];
+        if (src == rank && dest != rank) {
+            sizes[gid] = available[gid].size();
+            requests.emplace_back();
+            PARTHENON_MPI_CHECK(MPI_Isend(&sizes[gid], 1, MPI_LONG, dest, 0, MPI_COMM_WORLD, &requests.back()));
+        } else if (dest == rank && src != rank) {
+            requests.emplace_back();
+            PARTHENON_MPI_CHECK(MPI_Irecv(&sizes[gid], 1, MPI_LONG, src, 0, MPI_COMM_WORLD, &requests.back()));
+        }
+    }
+    PARTHENON_MPI_CHECK(MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE));
+    requests.clear();
+    for (auto& kv : destination) {
+        const int gid = kv.first, dest = kv.second;
+        if (!provider.count(gid)) continue;
+        const int src = provider[gid];
+        if (src == rank && dest != rank) {
+            requests.emplace_back();
+            PARTHENON_MPI_CHECK(MPI_Isend(available[gid].data(), sizes[gid], MPI_BYTE, dest, 1, MPI_COMM_WORLD, &requests.back()));
+        } else if (dest == rank && src != rank) {
+            available[gid].resize(sizes[gid]);
+            requests.emplace_back();
+            PARTHENON_MPI_CHECK(MPI_Irecv(available[gid].data(), sizes[gid], MPI_BYTE, src, 1, MPI_COMM_WORLD, &requests.back()));
+        }
+    }
+    PARTHENON_MPI_CHECK(MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE));
+#endif
+
+    for (int gid : needed)
+        if (available.count(gid)) memory_restart.blocks[gid] = std::move(available[gid]);
+    memory_restart.assembled = true;
+}
+
+TaskStatus Checkpoint::ReadCheckpoint(std::shared_ptr<MeshBlockData<Real>> rc, ParameterInput *pin)
+{
+    auto pmb = rc->GetBlockPointer();
+
+    if (pin->GetOrAddBoolean("checkpoint", "restart_from_memory", false)) {
+        if (!memory_restart.assembled) AssembleMemoryCheckpoint(pmb->pmy_mesh);
+        if (!memory_restart.blocks.count(pmb->gid))
+            throw std::runtime_error("Block "+std::to_string(pmb->gid)+" not found in in-memory checkpoint");
+        auto& buf = memory_restart.blocks.at(pmb->gid);
+        FILE *fp = fmemopen(buf.data(), buf.size(), "rb");
+        ReadBlockVars(fp, "in-memory block "+std::to_string(pmb->gid), memory_restart.names, rc);
+        fclose(fp);
+        return TaskStatus::complete;
+    }
+
+    const std::string fname = pin->GetString("checkpoint", "restart_file");
+
+    // Index every file once: headers & block IDs only, skipping the data.
+    // Each rank indexes a share of the files, then the index is shared, so no file is opened by every rank.
+    // Collective: called on the first ReadCheckpoint of every rank
+    if (!restart_index.read) {
+        Real time, dt;
+        int ncycle, nfiles, nblocks;
+        FILE *fp = OpenCheckpoint(RankFileName(fname, 0), time, dt, ncycle, nfiles, nblocks, restart_index.names);
+        fclose(fp);
+        // (gid, file, offset) of each block this rank found
+        std::vector<long> local;
+        for (int f = MPIRank(); f < nfiles; f += MPINumRanks()) {
+            const std::string rank_fname = RankFileName(fname, f);
+            std::vector<std::string> names;
+            int nfiles_f;
+            fp = OpenCheckpoint(rank_fname, time, dt, ncycle, nfiles_f, nblocks, names);
+            for (int b = 0; b < nblocks; b++) {
+                int gid;
+                if (fread(&gid, sizeof(int), 1, fp) != 1) throw std::runtime_error("Corrupt checkpoint file: "+rank_fname);
+                local.insert(local.end(), {(long) gid, (long) f, ftell(fp)});
+                for (int v = 0; v < names.size(); v++) {
+                    long n;
+                    if (fread(&n, sizeof(long), 1, fp) != 1) throw std::runtime_error("Corrupt checkpoint file: "+rank_fname);
+                    fseek(fp, n * sizeof(Real), SEEK_CUR);
+                }
+            }
+            fclose(fp);
+        }
+        std::vector<long> all = local;
+#ifdef MPI_PARALLEL
+        const int nranks_now = MPINumRanks();
+        int nlocal = local.size();
+        std::vector<int> counts(nranks_now), displs(nranks_now, 0);
+        PARTHENON_MPI_CHECK(MPI_Allgather(&nlocal, 1, MPI_INT, counts.data(), 1, MPI_INT, MPI_COMM_WORLD));
+        for (int r = 1; r < nranks_now; r++) displs[r] = displs[r-1] + counts[r-1];
+        all.resize(displs[nranks_now-1] + counts[nranks_now-1]);
+        PARTHENON_MPI_CHECK(MPI_Allgatherv(local.data(), nlocal, MPI_LONG, all.data(), counts.data(), displs.data(),
+                                           MPI_LONG, MPI_COMM_WORLD));
+#endif
+        for (int e = 0; e < all.size(); e += 3)
+            restart_index.blocks[all[e]] = {RankFileName(fname, all[e+1]), all[e+2]};
+        restart_index.read = true;
+    }
+
+    if (!restart_index.blocks.count(pmb->gid))
+        throw std::runtime_error("Block "+std::to_string(pmb->gid)+" not found in checkpoint "+fname);
+    const auto& entry = restart_index.blocks.at(pmb->gid);
+    FILE *fp = fopen(entry.first.c_str(), "rb");
+    fseek(fp, entry.second, SEEK_SET);
+    ReadBlockVars(fp, entry.first, restart_index.names, rc);
+    fclose(fp);
+
+    return TaskStatus::complete;
+}
@@ -0,0 +1,92 @@
+/* 
+ *  File: checkpoint.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+#include "types.hpp"
+
+#include <parthenon/parthenon.hpp>
+
+/**
+ * Checkpoints written by KHARMA rather than Parthenon, optionally in the background.
+ *
+ * Every checkpoint/dt, the restart variables of each local block are copied to host buffers,
+ * then written by a separate thread while the simulation continues.  The only wait is for the
+ * previous checkpoint to finish writing, before the next one (or the end of the run).
+ *
+ * Like Parthenon restarts, these contain only variables flagged Independent or Restart: the conserved
+ * state, any face-centered field, and the GRMHD primitives as a UtoP guess.  Fluxes, flags, EMFs etc.
+ * are not written, and the remaining primitives/cell-centered fields are recovered on load.
+ *
+ * Each rank writes its own raw binary file <checkpoint/file>.<NNNNN>.<rank>.bin, so no MPI
+ * or HDF5 calls are made off the main thread.  Restart from one with problem_id = checkpoint,
+ * setting checkpoint/restart_file = <file>.<NNNNN>, on the same mesh & blocks (any number of ranks).
+ *
+ * With checkpoint/aggregate = N (or 0, for every rank on a node), each group of ranks instead writes one
+ * file <file>.<NNNNN>.<group>.bin.  Members' serialized blocks are gathered to the group's first rank with
+ * a non-blocking MPI gather, checked each step, which then writes them in the background as one large write.
+ *
+ * With checkpoint/memory_interval = N, every N steps each rank also keeps its blocks in node memory
+ * (checkpoint/memory_dir, default /dev/shm), and swaps a copy with a partner rank on another node.
+ * After losing a node, restart with checkpoint/restart_from_memory = true: the newest cycle with a surviving
+ * copy of every rank's blocks is found, and each block is sent to the rank which now owns it.
+ */
+namespace Checkpoint {
+
+/**
+ * Initialize the checkpoint package, loaded if checkpoint/dt > 0 or checkpoint/memory_interval > 0
+ */
+std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages);
+
+/**
+ * Stage and write (or start writing) a checkpoint, and/or replicate an in-memory checkpoint, if one is due
+ */
+TaskStatus PostStepDiagnostics(const SimTime& tm, MeshData<Real> *md);
+
+/**
+ * Wait for any checkpoint still being written
+ */
+void PostExecute(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+
+/**
+ * Read the time, timestep & cycle number of a checkpoint into the input deck, before the mesh is built
+ */
+void ReadCheckpointHeader(std::string fname, ParameterInput *pin);
+
+/**
+ * Restore all staged variables of a block from a checkpoint, matching blocks by their global ID
+ */
+TaskStatus ReadCheckpoint(std::shared_ptr<MeshBlockData<Real>> rc, ParameterInput *pin);
+
+}
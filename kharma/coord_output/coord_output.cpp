@@ -35,14 +35,19 @@
 
 #include "domain.hpp"
 
+#include <limits>
+#include <sstream>
+
 std::shared_ptr<KHARMAPackage> CoordinateOutput::Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages)
 {
     auto pkg = std::make_shared<KHARMAPackage>("CoordinateOutput");
     Params &params = pkg->AllParams();
 
     // Options
-    //Real n = pin->GetOrAddReal("wind", "ne", 2.e-4);
-    //params.Add("ne", n);
+    // Write geometry once, to its own "grid" output, rather than alongside every dump
+    bool grid_file = pin->GetOrAddBoolean("coordinate_output", "grid_file", false);
+    params.Add("grid_file", grid_file);
+    if (grid_file) CoordinateOutput::MoveToGridOutput(pin);
 
     // Fields: cell-center values for geometry only
     // TODO test faces when available, optional lists of locations?
@@ -84,79 +89,115 @@ std::shared_ptr<KHARMAPackage> CoordinateOutput::Initialize(ParameterInput *pin,
     pkg->AddField("coords.conn", m3);
 
     // Register our output.  This will be called before *any* output,
-    // but we will only fill the fields before the first.
-    // This is all that's needed unless:
-    // 1. Someone wants geometry in an AMR sim with remeshing
-    // 2. Parthenon decides to include a way to delete fields, which we would want to do here
+    // but fills each block's fields only once, see BlockUserWorkBeforeOutput.
+    // If Parthenon ever includes a way to delete fields, we would want to do it here
     pkg->BlockUserWorkBeforeOutput = CoordinateOutput::BlockUserWorkBeforeOutput;
 
     return pkg;
 }
 
-TaskStatus CoordinateOutput::BlockUserWorkBeforeOutput(MeshBlock *pmb, ParameterInput *pin)
+void CoordinateOutput::MoveToGridOutput(ParameterInput *pin)
 {
-    auto& globals = pmb->packages.Get("Globals")->AllParams();
-    if (!globals.Get<bool>("in_loop")) {
-        auto rc = pmb->meshblock_data.Get();
-
-        PackIndexMap geom_map;
-        auto Geom = rc->PackVariables({Metadata::GetUserFlag("Geometry")}, geom_map);
-
-        const auto& G = pmb->coords;
-
-        const int mXnative = geom_map["coords.Xnative"].first;
-        const int mX1 = geom_map["coords.X1"].first;
-        const int mX2 = geom_map["coords.X2"].first;
-        const int mX3 = geom_map["coords.X3"].first;
-
-        const int mXcart = geom_map["coords.Xcart"].first;
-        const int mx = geom_map["coords.x"].first;
-        const int my = geom_map["coords.y"].first;
-        const int mz = geom_map["coords.z"].first;
-
-        const int mXsph = geom_map["coords.Xsph"].first;
-        const int mr = geom_map["coords.r"].first;
-        const int mth = geom_map["coords.th"].first;
-        const int mphi = geom_map["coords.phi"].first;
-
-        const int mgcov = geom_map["coords.gcov"].first;
-        const int mgcon = geom_map["coords.gcon"].first;
-        const int mgdet = geom_map["coords.gdet"].first;
-        const int mlapse = geom_map["coords.lapse"].first;
-        const int mconn = geom_map["coords.conn"].first;
-
-        IndexRange3 b = KDomain::GetRange(rc, IndexDomain::entire);
-        pmb->par_for("set_geometry", b.ks, b.ke, b.js, b.je, b.is, b.ie,
-            KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-                // Native
-                GReal Xnative[GR_DIM];
-                G.coord(k, j, i, Loci::center, Xnative);
-                Geom(mXnative+1, k, j, i) = Geom(mX1, k, j, i) = Xnative[1];
-                Geom(mXnative+2, k, j, i) = Geom(mX2, k, j, i) = Xnative[2];
-                Geom(mXnative+3, k, j, i) = Geom(mX3, k, j, i) = Xnative[3];
-                // Cartesian
-                Geom(mXcart+1, k, j, i) = Geom(mx, k, j, i) = G.x(k, j, i);
-                Geom(mXcart+2, k, j, i) = Geom(my, k, j, i) = G.y(k, j, i);
-                Geom(mXcart+3, k, j, i) = Geom(mz, k, j, i) = G.z(k, j, i);
-                // Spherical
-                Geom(mXsph+1, k, j, i) = Geom(mr, k, j, i) = G.r(k, j, i);
-                Geom(mXsph+2, k, j, i) = Geom(mth, k, j, i) = G.th(k, j, i);
-                Geom(mXsph+3, k, j, i) = Geom(mphi, k, j, i) = G.phi(k, j, i);
-
-                // Metric
-                DLOOP2 Geom(mgcov+GR_DIM*mu+nu, k, j, i) = G.gcov(Loci::center, j, i, mu, nu);
-                DLOOP2 Geom(mgcon+GR_DIM*mu+nu, k, j, i) = G.gcon(Loci::center, j, i, mu, nu);
-                Geom(mgdet, k, j, i) = G.gdet(Loci::center, j, i);
-                Geom(mlapse, k, j, i) = 1. / m::sqrt(-G.gcon(Loci::center, j, i, 0, 0));
-                // shift? = G.gcon(Loci::center, j, i, 0, 1) * alpha * alpha;
-                // Connection
-                DLOOP3 Geom(mconn+GR_DIM*GR_DIM*mu+GR_DIM*nu+lam, k, j, i) = G.conn(j, i, mu, nu, lam);
-
+    std::string grid_vars;
+    int last_output = -1;
+    InputBlock *pib = pin->pfirst_block;
+    while (pib != nullptr) {
+        const std::string bname = pib->block_name;
+        if (bname.find("parthenon/output") != std::string::npos) {
+            last_output = m::max(last_output, std::stoi(bname.substr(bname.find("output") + 6)));
+            if (pin->DoesParameterExist(bname, "variables")) {
+                // Split off any coords. entries from the list
+                std::stringstream ss(pin->GetString(bname, "variables"));
+                std::string var, other_vars, these_grid_vars;
+                while (std::getline(ss, var, ',')) {
+                    std::string& list = (var.find("coords.") != std::string::npos) ? these_grid_vars : other_vars;
+                    list += (list.empty()) ? var : "," + var;
+                }
+                // Leave any output of *only* geometry alone, it's already a grid file
+                if (!these_grid_vars.empty() && !other_vars.empty()) {
+                    pin->SetString(bname, "variables", other_vars);
+                    if (grid_vars.find(these_grid_vars) == std::string::npos)
+                        grid_vars += (grid_vars.empty()) ? these_grid_vars : "," + these_grid_vars;
+                }
             }
-        );
-
+        }
+        pib = pib->pnext;
+    }
 
+    if (!grid_vars.empty()) {
+        // Parthenon writes every output at the start, and this one would never come due again
+        const std::string bname = "parthenon/output" + std::to_string(last_output + 1);
+        pin->SetString(bname, "file_type", "hdf5");
+        pin->SetString(bname, "id", "grid");
+        pin->SetString(bname, "variables", grid_vars);
+        pin->SetReal(bname, "dt", std::numeric_limits<Real>::max());
     }
+}
+
+TaskStatus CoordinateOutput::BlockUserWorkBeforeOutput(MeshBlock *pmb, ParameterInput *pin)
+{
+    auto rc = pmb->meshblock_data.Get();
+
+    PackIndexMap geom_map;
+    auto Geom = rc->PackVariables({Metadata::GetUserFlag("Geometry")}, geom_map);
+
+    const auto& G = pmb->coords;
+
+    const int mXnative = geom_map["coords.Xnative"].first;
+    const int mX1 = geom_map["coords.X1"].first;
+    const int mX2 = geom_map["coords.X2"].first;
+    const int mX3 = geom_map["coords.X3"].first;
+
+    const int mXcart = geom_map["coords.Xcart"].first;
+    const int mx = geom_map["coords.x"].first;
+    const int my = geom_map["coords.y"].first;
+    const int mz = geom_map["coords.z"].first;
+
+    const int mXsph = geom_map["coords.Xks"].first;
+    const int mr = geom_map["coords.r"].first;
+    const int mth = geom_map["coords.th"].first;
+    const int mphi = geom_map["coords.phi"].first;
+
+    const int mgcov = geom_map["coords.gcov"].first;
+    const int mgcon = geom_map["coords.gcon"].first;
+    const int mgdet = geom_map["coords.gdet"].first;
+    const int mlapse = geom_map["coords.lapse"].first;
+    const int mconn = geom_map["coords.conn"].first;
+
+    // Geometry is static for the life of a block, so fill each zone only once.
+    // Fields are zero-initialized and gdet > 0 at zone centers, so any zone with
+    // gdet == 0 is in a new block (at startup, or after remeshing) and needs filling
+    IndexRange3 b = KDomain::GetRange(rc, IndexDomain::entire);
+    pmb->par_for("set_geometry", b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
+            if (Geom(mgdet, k, j, i) > 0.) return;
+
+            // Native
+            GReal Xnative[GR_DIM];
+            G.coord(k, j, i, Loci::center, Xnative);
+            Geom(mXnative+1, k, j, i) = Geom(mX1, k, j, i) = Xnative[1];
+            Geom(mXnative+2, k, j, i) = Geom(mX2, k, j, i) = Xnative[2];
+            Geom(mXnative+3, k, j, i) = Geom(mX3, k, j, i) = Xnative[3];
+            // Cartesian
+            Geom(mXcart+1, k, j, i) = Geom(mx, k, j, i) = G.x(k, j, i);
+            Geom(mXcart+2, k, j, i) = Geom(my, k, j, i) = G.y(k, j, i);
+            Geom(mXcart+3, k, j, i) = Geom(mz, k, j, i) = G.z(k, j, i);
+            // Spherical
+            Geom(mXsph+1, k, j, i) = Geom(mr, k, j, i) = G.r(k, j, i);
+            Geom(mXsph+2, k, j, i) = Geom(mth, k, j, i) = G.th(k, j, i);
+            Geom(mXsph+3, k, j, i) = Geom(mphi, k, j, i) = G.phi(k, j, i);
+
+            // Metric
+            DLOOP2 Geom(mgcov+GR_DIM*mu+nu, k, j, i) = G.gcov(Loci::center, j, i, mu, nu);
+            DLOOP2 Geom(mgcon+GR_DIM*mu+nu, k, j, i) = G.gcon(Loci::center, j, i, mu, nu);
+            Geom(mlapse, k, j, i) = 1. / m::sqrt(-G.gcon(Loci::center, j, i, 0, 0));
+            // shift? = G.gcon(Loci::center, j, i, 0, 1) * alpha * alpha;
+            // Connection
+            DLOOP3 Geom(mconn+GR_DIM*GR_DIM*mu+GR_DIM*nu+lam, k, j, i) = G.conn(j, i, mu, nu, lam);
+            // Last, as it marks the zone filled
+            Geom(mgdet, k, j, i) = G.gdet(Loci::center, j, i);
+        }
+    );
 
     return TaskStatus::complete;
 }
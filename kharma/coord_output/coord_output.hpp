@@ -40,12 +40,20 @@
 namespace CoordinateOutput {
 
 /**
- * Initialize the wind package with several options from the input deck
+ * Initialize the coordinate output package with several options from the input deck
  */
 std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages);
 
 /**
- * Fill the geometry output variables with quantities from the GRCoordinates object over a block
+ * Move any coords. variables out of the output blocks in the input deck, into
+ * a new output "grid" written only once at startup.
+ * Outputs listing only geometry are left untouched.
+ */
+void MoveToGridOutput(ParameterInput *pin);
+
+/**
+ * Fill the geometry output variables with quantities from the GRCoordinates object over a block.
+ * Each zone is filled only once, so this is cheap after the first output of any block output variables with quantities from the GRCoordinates object over a block
  */
 TaskStatus BlockUserWorkBeforeOutput(MeshBlock *pmb, ParameterInput *pin);
 
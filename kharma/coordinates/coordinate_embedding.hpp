@@ -46,9 +46,166 @@
 // Because who needs those?
 // TODO(BSP) try to switch to std:: unless using SYCL
 #include <mpark/variant.hpp>
+#include <type_traits>
 //#include <variant>
 //namespace mpark = std;
 
+/**
+ * Metric functions derived from the interface of an embedding: gcov_embed, coord_to_embed, dxdX,
+ * and dgcov_embed/d2xdX2/has_analytic_derivs for the connection.
+ * Shared by the general CoordinateEmbedding, which resolves its systems at runtime through mpark::visit,
+ * and by FixedEmbedding below, which fixes them at compile time.
+ */
+template<typename Embedding>
+class MetricFunctions {
+    public:
+        KOKKOS_FORCEINLINE_FUNCTION const Embedding& self() const { return *static_cast<const Embedding*>(this); }
+
+        KOKKOS_INLINE_FUNCTION void cov_tensor_to_native(const GReal Xnative[GR_DIM], const GReal tcov_embed[GR_DIM][GR_DIM], GReal tcov_native[GR_DIM][GR_DIM]) const
+        {
+            GReal dxdX_temp[GR_DIM][GR_DIM];
+            self().dxdX(Xnative, dxdX_temp);
+
+            DLOOP2 {
+                tcov_native[mu][nu] = 0;
+                for (int lam = 0; lam < GR_DIM; lam++) {
+                    for (int kap = 0; kap < GR_DIM; kap++) {
+                        tcov_native[mu][nu] += tcov_embed[lam][kap]*dxdX_temp[lam][mu]*dxdX_temp[kap][nu];
+                    }
+                }
+            }
+        }
+
+        // And then derived metric properties
+        KOKKOS_INLINE_FUNCTION void gcov_native(const GReal Xnative[GR_DIM], GReal gcov[GR_DIM][GR_DIM]) const
+        {
+            GReal gcov_em[GR_DIM][GR_DIM];
+            GReal Xembed[GR_DIM];
+            // Get coordinates in embedding system
+            self().coord_to_embed(Xnative, Xembed);
+
+            // Get metric in embedding coordinates
+            self().gcov_embed(Xembed, gcov_em);
+
+            // Transform to native coordinates
+            cov_tensor_to_native(Xnative, gcov_em, gcov);
+        }
+        KOKKOS_INLINE_FUNCTION GReal gcon_native(const GReal X[GR_DIM], GReal gcon[GR_DIM][GR_DIM]) const
+        {
+            GReal gcov[GR_DIM][GR_DIM];
+            gcov_native(X, gcov);
+            return gcon_native(gcov, gcon);
+        }
+        KOKKOS_INLINE_FUNCTION GReal gcon_native(const GReal gcov[GR_DIM][GR_DIM], GReal gcon[GR_DIM][GR_DIM]) const
+        {
+            GReal gdet = invert(&gcov[0][0], &gcon[0][0]);
+            return m::sqrt(m::abs(gdet));
+        }
+        KOKKOS_INLINE_FUNCTION GReal gdet_native(const GReal X[GR_DIM]) const
+        {
+            GReal gcov[GR_DIM][GR_DIM], gcon[GR_DIM][GR_DIM];
+            gcov_native(X, gcov);
+            return gcon_native(gcov, gcon);
+        }
+
+        /**
+         * Derivatives of the native metric, dg[mu][nu][lam] = d_lam g_mu_nu, by the chain rule:
+         * d_c (J^m_a J^n_b g_mn) = d_c J^m_a J^n_b g_mn + J^m_a d_c J^n_b g_mn + J^m_a J^n_b J^p_c d_p g_mn
+         * Requires has_analytic_derivs()
+         */
+        KOKKOS_INLINE_FUNCTION void dgcov_native(const GReal Xnative[GR_DIM], GReal dg[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            GReal Xembed[GR_DIM];
+            self().coord_to_embed(Xnative, Xembed);
+            GReal g[GR_DIM][GR_DIM], dg_em[GR_DIM][GR_DIM][GR_DIM];
+            self().gcov_embed(Xembed, g);
+            self().dgcov_embed(Xembed, dg_em);
+            GReal J[GR_DIM][GR_DIM], dJ[GR_DIM][GR_DIM][GR_DIM];
+            self().dxdX(Xnative, J);
+            self().d2xdX2(Xnative, dJ);
+
+            // Embedding metric derivatives along native directions, and contracted with one J
+            GReal dg_c[GR_DIM][GR_DIM][GR_DIM], gJ[GR_DIM][GR_DIM];
+            DLOOP3 {
+                dg_c[mu][nu][lam] = 0.;
+                for (int kap = 0; kap < GR_DIM; kap++)
+                    dg_c[mu][nu][lam] += dg_em[mu][nu][kap] * J[kap][lam];
+            }
+            DLOOP2 {
+                gJ[mu][nu] = 0.;
+                for (int kap = 0; kap < GR_DIM; kap++)
+                    gJ[mu][nu] += g[mu][kap] * J[kap][nu];
+            }
+
+            DLOOP3 {
+                GReal sum = 0.;
+                for (int m = 0; m < GR_DIM; m++) {
+                    for (int n = 0; n < GR_DIM; n++) {
+                        sum += J[m][mu] * J[n][nu] * dg_c[m][n][lam];
+                    }
+                    // g symmetric: both Jacobian-derivative terms are dJ . (g J)
+                    sum += dJ[m][mu][lam] * gJ[m][nu] + dJ[m][nu][lam] * gJ[m][mu];
+                }
+                dg[mu][nu][lam] = sum;
+            }
+        }
+
+        KOKKOS_INLINE_FUNCTION void conn_native(const GReal X[GR_DIM], const GReal delta, GReal conn[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            GReal tmp[GR_DIM][GR_DIM][GR_DIM];
+            GReal gcon[GR_DIM][GR_DIM];
+
+            if (self().has_analytic_derivs()) {
+                dgcov_native(X, conn);
+            } else {
+                GReal Xh[GR_DIM], Xl[GR_DIM];
+                GReal gh[GR_DIM][GR_DIM];
+                GReal gl[GR_DIM][GR_DIM];
+
+                for (int nu = 0; nu < GR_DIM; nu++) {
+                    DLOOP1 Xl[mu] = X[mu] - delta*(mu == nu);
+                    DLOOP1 Xh[mu] = X[mu] + delta*(mu == nu);
+                    gcov_native(Xh, gh);
+                    gcov_native(Xl, gl);
+
+                    for (int lam = 0; lam < GR_DIM; lam++) {
+                        for (int kap = 0; kap < GR_DIM; kap++) {
+                            conn[lam][kap][nu] = (gh[lam][kap] - gl[lam][kap])/
+                                                            (Xh[nu] - Xl[nu]);
+                        }
+                    }
+                }
+            }
+
+            // Rearrange to find \Gamma_{lam nu mu}
+            for (int lam = 0; lam < GR_DIM; lam++) {
+                for (int nu = 0; nu < GR_DIM; nu++) {
+                    for (int mu = 0; mu < GR_DIM; mu++) {
+                        tmp[lam][nu][mu] = 0.5 * (conn[nu][lam][mu] +
+                                                  conn[mu][lam][nu] -
+                                                  conn[mu][nu][lam]);
+                    }
+                }
+            }
+
+            // Need gcon for raising index
+            gcon_native(X, gcon);
+
+            // Raise index to get \Gamma^lam_{nu mu}
+            for (int lam = 0; lam < GR_DIM; lam++) {
+                for (int nu = 0; nu < GR_DIM; nu++) {
+                    for (int mu = 0; mu < GR_DIM; mu++) {
+                        conn[lam][nu][mu] = 0.;
+
+                        for (int kap = 0; kap < GR_DIM; kap++)
+                            conn[lam][nu][mu] += gcon[lam][kap] * tmp[kap][nu][mu];
+                    }
+                }
+            }
+        }
+
+};
+
 /**
  * Coordinates in HARM are logically Cartesian -- that is, in some coordinate system, here dubbed "native"
  * coordinates, each cell is a rectangular prism of exactly the same shape as all the others.
@@ -72,12 +229,14 @@
  * * coord_to_native
  * * dxdX_to_embed
  * * dxdX_to_native
+ * Both also declare analytic_derivs, and if it is true, implement dgcov_embed or d2xdX2 respectively.
+ * Connection coefficients are then computed analytically rather than by finite differences of gcov.
  * 
  * Each possible class is added to a couple of mpark::variant containers, and then to the chains of if statements below.
  *
  * TODO convenience functions.  Intelligent r/th/phi, x/y/z, KS and BL, a, etc by auto-translating contents
  */
-class CoordinateEmbedding {
+class CoordinateEmbedding : public MetricFunctions<CoordinateEmbedding> {
     public:
         SomeBaseCoords base;
         SomeTransform transform;
@@ -98,10 +257,14 @@ class CoordinateEmbedding {
                 base.emplace<SphKSExtG>(mpark::get<SphKSExtG>(base_in));
             } else if (mpark::holds_alternative<SphBLExtG>(base_in)) {
                 base.emplace<SphBLExtG>(mpark::get<SphBLExtG>(base_in));
+            } else if (mpark::holds_alternative<CartKSCoords>(base_in)) {
+                base.emplace<CartKSCoords>(mpark::get<CartKSCoords>(base_in));
             }
 
             if (mpark::holds_alternative<NullTransform>(transform_in)) {
                 transform.emplace<NullTransform>(mpark::get<NullTransform>(transform_in));
+            } else if (mpark::holds_alternative<SphNullTransform>(transform_in)) {
+                transform.emplace<SphNullTransform>(mpark::get<SphNullTransform>(transform_in));
             } else if (mpark::holds_alternative<ExponentialTransform>(transform_in)) {
                 transform.emplace<ExponentialTransform>(mpark::get<ExponentialTransform>(transform_in));
             } else if (mpark::holds_alternative<SuperExponentialTransform>(transform_in)) {
@@ -136,6 +299,9 @@ class CoordinateEmbedding {
                 } else {
                     base.emplace<SphKSCoords>(SphKSCoords(a));
                 }
+            } else if (base_str == "cartesian_ks" || base_str == "cart_ks") {
+                GReal a = pin->GetReal("coordinates", "a");
+                base.emplace<CartKSCoords>(CartKSCoords(a));
             } else if (base_str == "spherical_bl" || base_str == "bl" ||
                         base_str == "spherical_bl_extg" || base_str == "bl_extg") {
                 GReal a = pin->GetReal("coordinates", "a");
@@ -231,6 +397,12 @@ class CoordinateEmbedding {
                 return self.spherical;
             }, base);
         }
+        KOKKOS_INLINE_FUNCTION bool is_axisymmetric() const
+        {
+            return mpark::visit( [&](const auto& self) {
+                return self.axisymmetric;
+            }, base);
+        }
         KOKKOS_INLINE_FUNCTION bool is_transformed() const
         {
             return !mpark::holds_alternative<NullTransform>(transform);
@@ -240,7 +412,8 @@ class CoordinateEmbedding {
             if (mpark::holds_alternative<SphKSCoords>(base) ||
                 mpark::holds_alternative<SphBLCoords>(base) ||
                 mpark::holds_alternative<SphKSExtG>(base) ||
-                mpark::holds_alternative<SphBLExtG>(base)) {
+                mpark::holds_alternative<SphBLExtG>(base) ||
+                mpark::holds_alternative<CartKSCoords>(base)) {
                 const GReal a = get_a();
                 return 1 + m::sqrt(1 - a * a);
             } else {
@@ -277,7 +450,7 @@ class CoordinateEmbedding {
 
         // Spell out the interface we take from BaseCoords
         // TODO add a gcon_embed, gdet_embed
-        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], Real gcov[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], GReal gcov[GR_DIM][GR_DIM]) const
         {
             mpark::visit( [&Xembed, &gcov](const auto& self) {
                 self.gcov_embed(Xembed, gcov);
@@ -296,18 +469,43 @@ class CoordinateEmbedding {
                 self.coord_to_native(Xembed, Xnative);
             }, transform);
         }
-        KOKKOS_INLINE_FUNCTION void dxdX(const GReal Xnative[GR_DIM], Real dxdX[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void dxdX(const GReal Xnative[GR_DIM], GReal dxdX[GR_DIM][GR_DIM]) const
         {
             mpark::visit( [&Xnative, &dxdX](const auto& self) {
                 self.dxdX(Xnative, dxdX);
             }, transform);
         }
-        KOKKOS_INLINE_FUNCTION void dXdx(const GReal Xnative[GR_DIM], Real dXdx[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void dXdx(const GReal Xnative[GR_DIM], GReal dXdx[GR_DIM][GR_DIM]) const
         {
             mpark::visit( [&Xnative, &dXdx](const auto& self) {
                 self.dXdx(Xnative, dXdx);
             }, transform);
         }
+        // Analytic derivatives, where the system and transform both provide them
+        KOKKOS_INLINE_FUNCTION bool has_analytic_derivs() const
+        {
+            const bool base_analytic = mpark::visit( [&](const auto& self) {
+                return self.analytic_derivs;
+            }, base);
+            const bool transform_analytic = mpark::visit( [&](const auto& self) {
+                return self.analytic_derivs;
+            }, transform);
+            return base_analytic && transform_analytic;
+        }
+        KOKKOS_INLINE_FUNCTION void dgcov_embed(const GReal Xembed[GR_DIM], GReal dg[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            mpark::visit( [&Xembed, &dg](const auto& self) {
+                using T = std::decay_t<decltype(self)>;
+                if constexpr (T::analytic_derivs) self.dgcov_embed(Xembed, dg);
+            }, base);
+        }
+        KOKKOS_INLINE_FUNCTION void d2xdX2(const GReal Xnative[GR_DIM], GReal d2[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            mpark::visit( [&Xnative, &d2](const auto& self) {
+                using T = std::decay_t<decltype(self)>;
+                if constexpr (T::analytic_derivs) self.d2xdX2(Xnative, d2);
+            }, transform);
+        }
 
         // Coordinate convenience functions:
         // transform the radial coordinate alone without len-4 arrays
@@ -410,7 +608,7 @@ class CoordinateEmbedding {
         // Contravariant vectors:
         KOKKOS_INLINE_FUNCTION void con_vec_to_embed(const GReal Xnative[GR_DIM], const GReal vcon_native[GR_DIM], GReal vcon_embed[GR_DIM]) const
         {
-            Real dxdX_temp[GR_DIM][GR_DIM];
+            GReal dxdX_temp[GR_DIM][GR_DIM];
             dxdX(Xnative, dxdX_temp);
             DLOOP1 {
                 vcon_embed[mu] = 0;
@@ -420,7 +618,7 @@ class CoordinateEmbedding {
         }
         KOKKOS_INLINE_FUNCTION void con_vec_to_native(const GReal Xnative[GR_DIM], const GReal vcon_embed[GR_DIM], GReal vcon_native[GR_DIM]) const
         {
-            Real dXdx_temp[GR_DIM][GR_DIM];
+            GReal dXdx_temp[GR_DIM][GR_DIM];
             dXdx(Xnative, dXdx_temp);
             DLOOP1 { // TODO is this faster, or DLOOP1/2?
                 vcon_native[mu] = 0;
@@ -438,7 +636,7 @@ class CoordinateEmbedding {
         // Covariant first
         KOKKOS_INLINE_FUNCTION void cov_tensor_to_embed(const GReal Xnative[GR_DIM], const GReal tcov_native[GR_DIM][GR_DIM], GReal tcov_embed[GR_DIM][GR_DIM]) const
         {
-            Real dXdx_temp[GR_DIM][GR_DIM];
+            GReal dXdx_temp[GR_DIM][GR_DIM];
             dXdx(Xnative, dXdx_temp);
 
             DLOOP2 {
@@ -450,113 +648,18 @@ class CoordinateEmbedding {
                 }
             }
         }
-        KOKKOS_INLINE_FUNCTION void cov_tensor_to_native(const GReal Xnative[GR_DIM], const GReal tcov_embed[GR_DIM][GR_DIM], GReal tcov_native[GR_DIM][GR_DIM]) const
-        {
-            Real dxdX_temp[GR_DIM][GR_DIM];
-            dxdX(Xnative, dxdX_temp);
-
-            DLOOP2 {
-                tcov_native[mu][nu] = 0;
-                for (int lam = 0; lam < GR_DIM; lam++) {
-                    for (int kap = 0; kap < GR_DIM; kap++) {
-                        tcov_native[mu][nu] += tcov_embed[lam][kap]*dxdX_temp[lam][mu]*dxdX_temp[kap][nu];
-                    }
-                }
-            }
-        }
         // Con are opposite
         KOKKOS_INLINE_FUNCTION void con_tensor_to_embed(const GReal Xnative[GR_DIM], const GReal tcon_native[GR_DIM][GR_DIM], GReal tcon_embed[GR_DIM][GR_DIM]) const
             {cov_tensor_to_native(Xnative, tcon_native, tcon_embed);}
         KOKKOS_INLINE_FUNCTION void con_tensor_to_native(const GReal Xnative[GR_DIM], const GReal tcon_embed[GR_DIM][GR_DIM], GReal tcon_native[GR_DIM][GR_DIM]) const
             {cov_tensor_to_embed(Xnative, tcon_embed, tcon_native);}
 
-        // And then derived metric properties
-        KOKKOS_INLINE_FUNCTION void gcov_native(const GReal Xnative[GR_DIM], Real gcov[GR_DIM][GR_DIM]) const
-        {
-            Real gcov_em[GR_DIM][GR_DIM];
-            GReal Xembed[GR_DIM];
-            // Get coordinates in embedding system
-            coord_to_embed(Xnative, Xembed);
-
-            // Get metric in embedding coordinates
-            gcov_embed(Xembed, gcov_em);
-
-            // Transform to native coordinates
-            cov_tensor_to_native(Xnative, gcov_em, gcov);
-        }
-        KOKKOS_INLINE_FUNCTION Real gcon_native(const GReal X[GR_DIM], Real gcon[GR_DIM][GR_DIM]) const
-        {
-            Real gcov[GR_DIM][GR_DIM];
-            gcov_native(X, gcov);
-            return gcon_native(gcov, gcon);
-        }
-        KOKKOS_INLINE_FUNCTION Real gcon_native(const Real gcov[GR_DIM][GR_DIM], Real gcon[GR_DIM][GR_DIM]) const
-        {
-            Real gdet = invert(&gcov[0][0], &gcon[0][0]);
-            return m::sqrt(m::abs(gdet));
-        }
-        KOKKOS_INLINE_FUNCTION Real gdet_native(const GReal X[GR_DIM]) const
-        {
-            Real gcov[GR_DIM][GR_DIM], gcon[GR_DIM][GR_DIM];
-            gcov_native(X, gcov);
-            return gcon_native(gcov, gcon);
-        }
-
-        KOKKOS_INLINE_FUNCTION void conn_native(const GReal X[GR_DIM], const GReal delta, Real conn[GR_DIM][GR_DIM][GR_DIM]) const
-        {
-            GReal tmp[GR_DIM][GR_DIM][GR_DIM];
-            GReal gcon[GR_DIM][GR_DIM];
-            GReal Xh[GR_DIM], Xl[GR_DIM];
-            GReal gh[GR_DIM][GR_DIM];
-            GReal gl[GR_DIM][GR_DIM];
-
-            for (int nu = 0; nu < GR_DIM; nu++) {
-                DLOOP1 Xl[mu] = X[mu] - delta*(mu == nu);
-                DLOOP1 Xh[mu] = X[mu] + delta*(mu == nu);
-                gcov_native(Xh, gh);
-                gcov_native(Xl, gl);
-
-                for (int lam = 0; lam < GR_DIM; lam++) {
-                    for (int kap = 0; kap < GR_DIM; kap++) {
-                        conn[lam][kap][nu] = (gh[lam][kap] - gl[lam][kap])/
-                                                        (Xh[nu] - Xl[nu]);
-                    }
-                }
-            }
-
-            // Rearrange to find \Gamma_{lam nu mu}
-            for (int lam = 0; lam < GR_DIM; lam++) {
-                for (int nu = 0; nu < GR_DIM; nu++) {
-                    for (int mu = 0; mu < GR_DIM; mu++) {
-                        tmp[lam][nu][mu] = 0.5 * (conn[nu][lam][mu] +
-                                                  conn[mu][lam][nu] -
-                                                  conn[mu][nu][lam]);
-                    }
-                }
-            }
-
-            // Need gcon for raising index
-            gcon_native(X, gcon);
-
-            // Raise index to get \Gamma^lam_{nu mu}
-            for (int lam = 0; lam < GR_DIM; lam++) {
-                for (int nu = 0; nu < GR_DIM; nu++) {
-                    for (int mu = 0; mu < GR_DIM; mu++) {
-                        conn[lam][nu][mu] = 0.;
-
-                        for (int kap = 0; kap < GR_DIM; kap++)
-                            conn[lam][nu][mu] += gcon[lam][kap] * tmp[kap][nu][mu];
-                    }
-                }
-            }
-        }
-
         /**
          * Takes a velocity in Boyer-Lindquist coordinates (optionally without time component) and converts it
          * to KS, and then to native coordinates.
          * Not guaranteed to be fast.
          */
-        KOKKOS_INLINE_FUNCTION void bl_fourvel_to_native(const Real Xnative[GR_DIM], const Real ucon_bl[GR_DIM], Real ucon_native[GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void bl_fourvel_to_native(const GReal Xnative[GR_DIM], const GReal ucon_bl[GR_DIM], GReal ucon_native[GR_DIM]) const
         {
             GReal Xembed[GR_DIM];
             coord_to_embed(Xnative, Xembed);
@@ -571,12 +674,12 @@ class CoordinateEmbedding {
                 SphBLExtG(get_a()).gcov_embed(Xembed, gcov_bl);
             }
 
-            Real ucon_bl_fourv[GR_DIM];
+            GReal ucon_bl_fourv[GR_DIM];
             DLOOP1 ucon_bl_fourv[mu] = ucon_bl[mu];
             set_ut(gcov_bl, ucon_bl_fourv);
 
             // Then transform that 4-vector to KS (or not, if we're using BL base coords)
-            Real ucon_base[GR_DIM];
+            GReal ucon_base[GR_DIM];
             if (mpark::holds_alternative<SphKSCoords>(base)) {
                 mpark::get<SphKSCoords>(base).vec_from_bl(Xembed, ucon_bl_fourv, ucon_base);
             } else if (mpark::holds_alternative<SphKSExtG>(base)) {
@@ -589,3 +692,74 @@ class CoordinateEmbedding {
             con_vec_to_native(Xnative, ucon_base, ucon_native);
         }
 };
+
+/**
+ * A CoordinateEmbedding with its base system and transform fixed at compile time.
+ * Provides the same metric interface, without any runtime dispatch, so kernels
+ * templated on their coordinate object compile to branch-free geometry code.
+ * Get one for a particular CoordinateEmbedding with with_fixed_embedding, below.
+ */
+template<typename Base, typename Transform>
+class FixedEmbedding : public MetricFunctions<FixedEmbedding<Base, Transform>> {
+    public:
+        Base base;
+        Transform transform;
+
+        KOKKOS_FUNCTION FixedEmbedding(const Base& base_in, const Transform& transform_in):
+            base(base_in), transform(transform_in) {}
+
+        KOKKOS_INLINE_FUNCTION constexpr bool is_spherical() const { return Base::spherical; }
+        KOKKOS_INLINE_FUNCTION constexpr bool has_analytic_derivs() const
+        { return Base::analytic_derivs && Transform::analytic_derivs; }
+        KOKKOS_INLINE_FUNCTION GReal get_a() const { return base.a; }
+
+        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], GReal gcov[GR_DIM][GR_DIM]) const
+            { base.gcov_embed(Xembed, gcov); }
+        KOKKOS_INLINE_FUNCTION void coord_to_embed(const GReal Xnative[GR_DIM], GReal Xembed[GR_DIM]) const
+            { transform.coord_to_embed(Xnative, Xembed); }
+        KOKKOS_INLINE_FUNCTION void coord_to_native(const GReal Xembed[GR_DIM], GReal Xnative[GR_DIM]) const
+            { transform.coord_to_native(Xembed, Xnative); }
+        KOKKOS_INLINE_FUNCTION void dxdX(const GReal Xnative[GR_DIM], GReal dxdX[GR_DIM][GR_DIM]) const
+            { transform.dxdX(Xnative, dxdX); }
+        KOKKOS_INLINE_FUNCTION void dXdx(const GReal Xnative[GR_DIM], GReal dXdx[GR_DIM][GR_DIM]) const
+            { transform.dXdx(Xnative, dXdx); }
+        KOKKOS_INLINE_FUNCTION void dgcov_embed(const GReal Xembed[GR_DIM], GReal dg[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            if constexpr (Base::analytic_derivs) base.dgcov_embed(Xembed, dg);
+        }
+        KOKKOS_INLINE_FUNCTION void d2xdX2(const GReal Xnative[GR_DIM], GReal d2[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            if constexpr (Transform::analytic_derivs) transform.d2xdX2(Xnative, d2);
+        }
+};
+
+/**
+ * Call f (host-side) with a FixedEmbedding equivalent to coords, if it is one of the
+ * common combinations we specialize, otherwise with coords itself.
+ * f should be generic over its argument, and launch any kernels itself: e.g. call
+ * a function template which captures the embedding by value.
+ * Each specialization compiles a copy of the kernels f launches, so keep this list short.
+ */
+template<typename Function>
+void with_fixed_embedding(const CoordinateEmbedding& coords, Function&& f)
+{
+    if (mpark::holds_alternative<SphKSCoords>(coords.base)) {
+        const auto& base = mpark::get<SphKSCoords>(coords.base);
+        if (mpark::holds_alternative<FunkyTransform>(coords.transform)) {
+            f(FixedEmbedding<SphKSCoords, FunkyTransform>(base, mpark::get<FunkyTransform>(coords.transform)));
+            return;
+        } else if (mpark::holds_alternative<ModifyTransform>(coords.transform)) {
+            f(FixedEmbedding<SphKSCoords, ModifyTransform>(base, mpark::get<ModifyTransform>(coords.transform)));
+            return;
+        } else if (mpark::holds_alternative<ExponentialTransform>(coords.transform)) {
+            f(FixedEmbedding<SphKSCoords, ExponentialTransform>(base, mpark::get<ExponentialTransform>(coords.transform)));
+            return;
+        }
+    } else if (mpark::holds_alternative<CartMinkowskiCoords>(coords.base) &&
+               mpark::holds_alternative<NullTransform>(coords.transform)) {
+        f(FixedEmbedding<CartMinkowskiCoords, NullTransform>(mpark::get<CartMinkowskiCoords>(coords.base),
+                                                              mpark::get<NullTransform>(coords.transform)));
+        return;
+    }
+    f(coords);
+}
@@ -0,0 +1,157 @@
+/* 
+ *  File: coordinate_inverse.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2026, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+
+#include "coordinate_embedding.hpp"
+
+/**
+ * Tabulated inverse of the X2 map for transforms which can only be inverted by root finding
+ * (MKS & FMKS, see ROOT_FIND in root_find.hpp).
+ * Built once per run on the host, using the root finder only to fill the table.
+ * Lookups are then O(1): a monotone cubic Hermite spline in theta, linear in X1 for FMKS
+ * (whose theta depends on X1), then a single Newton step against the true coord_to_embed.
+ *
+ * Other transforms are analytically invertible, and are passed straight through.
+ */
+class CoordinateInverse {
+    public:
+        bool tabulated = false;
+        int n1 = 1, n2 = 0;
+        GReal x1min = 0., dx1 = 0., dth = 0.;
+        // X2 & dX2/dth at each (X1, th) node.  Rows in X1, uniform in th over [0, pi]
+        ParArray2D<GReal> X2, dX2;
+
+        CoordinateInverse() = default;
+
+        /**
+         * Build the table over X1 in [x1min_in, x1max_in].  n2_in nodes in theta, and n1_in nodes
+         * in X1 if the transform needs them.  Must be called on the host.
+         */
+        CoordinateInverse(const CoordinateEmbedding& coords, const GReal x1min_in, const GReal x1max_in,
+                          const int n2_in, const int n1_in)
+        {
+            const bool mks = mpark::holds_alternative<ModifyTransform>(coords.transform);
+            const bool fmks = mpark::holds_alternative<FunkyTransform>(coords.transform);
+            tabulated = (mks || fmks) && n2_in > 1;
+            if (!tabulated) return;
+
+            n2 = n2_in;
+            n1 = (fmks) ? m::max(n1_in, 2) : 1;
+            x1min = x1min_in;
+            dx1 = (n1 > 1) ? (x1max_in - x1min_in) / (n1 - 1) : 0.;
+            dth = M_PI / (n2 - 1);
+
+            X2 = ParArray2D<GReal>("coord_inverse_X2", n1, n2);
+            dX2 = ParArray2D<GReal>("coord_inverse_dX2", n1, n2);
+            auto X2_h = Kokkos::create_mirror_view(Kokkos::HostSpace(), X2);
+            auto dX2_h = Kokkos::create_mirror_view(Kokkos::HostSpace(), dX2);
+            for (int r=0; r < n1; ++r) {
+                for (int n=0; n < n2; ++n) {
+                    const GReal Xembed[GR_DIM] = {0., m::exp(x1min + r*dx1), n*dth, 0.};
+                    GReal Xnative[GR_DIM], dxdX[GR_DIM][GR_DIM];
+                    coords.coord_to_native(Xembed, Xnative);
+                    coords.dxdX(Xnative, dxdX);
+                    X2_h(r, n) = Xnative[2];
+                    dX2_h(r, n) = 1. / dxdX[2][2];
+                }
+                // Fritsch-Carlson limiting, so the spline stays monotone like the map itself
+                for (int n=0; n < n2 - 1; ++n) {
+                    const GReal delta = (X2_h(r, n+1) - X2_h(r, n)) / dth;
+                    if (delta <= 0.) {
+                        dX2_h(r, n) = dX2_h(r, n+1) = 0.;
+                        continue;
+                    }
+                    const GReal alpha = dX2_h(r, n) / delta, beta = dX2_h(r, n+1) / delta;
+                    if (SQR(alpha) + SQR(beta) > 9.) {
+                        const GReal tau = 3. / m::sqrt(SQR(alpha) + SQR(beta));
+                        dX2_h(r, n) = tau * alpha * delta;
+                        dX2_h(r, n+1) = tau * beta * delta;
+                    }
+                }
+            }
+            Kokkos::deep_copy(X2, X2_h);
+            Kokkos::deep_copy(dX2, dX2_h);
+        }
+
+        /**
+         * Same interface as CoordinateEmbedding::coord_to_native.
+         * Falls back to coords' own inversion outside the tabulated X1 range.
+         */
+        KOKKOS_INLINE_FUNCTION void coord_to_native(const CoordinateEmbedding& coords,
+                                                    const GReal Xembed[GR_DIM], GReal Xnative[GR_DIM]) const
+        {
+            if (!tabulated) {
+                coords.coord_to_native(Xembed, Xnative);
+                return;
+            }
+            Xnative[0] = Xembed[0];
+            Xnative[1] = m::log(Xembed[1]);
+            Xnative[3] = Xembed[3];
+
+            GReal w = 0.;
+            int r = 0;
+            if (n1 > 1) {
+                const GReal s = (Xnative[1] - x1min) / dx1;
+                if (s < 0. || s > n1 - 1) {
+                    coords.coord_to_native(Xembed, Xnative);
+                    return;
+                }
+                r = m::min((int) s, n1 - 2);
+                w = s - r;
+            }
+
+            const GReal th = m::min(m::max(Xembed[2], 0.), M_PI);
+            const GReal u = th / dth;
+            const int n = m::min((int) u, n2 - 2);
+            const GReal t = u - n;
+            Xnative[2] = (1. - w) * hermite(r, n, t);
+            if (w > 0.) Xnative[2] += w * hermite(r + 1, n, t);
+
+            // Polish against the real map
+            GReal Xtmp[GR_DIM], dxdX[GR_DIM][GR_DIM];
+            coords.coord_to_embed(Xnative, Xtmp);
+            coords.dxdX(Xnative, dxdX);
+            Xnative[2] -= (Xtmp[2] - Xembed[2]) / dxdX[2][2];
+        }
+
+    private:
+        KOKKOS_INLINE_FUNCTION GReal hermite(const int& r, const int& n, const GReal& t) const
+        {
+            const GReal t2 = t*t, t3 = t2*t;
+            return (2*t3 - 3*t2 + 1) * X2(r, n) + (t3 - 2*t2 + t) * dth * dX2(r, n)
+                 + (-2*t3 + 3*t2) * X2(r, n+1) + (t3 - t2) * dth * dX2(r, n+1);
+        }
+};
@@ -49,14 +49,14 @@
 /**
  * Embedding/Base systems implemented:
  * Minkowski space: Cartesian and Spherical coordinates
- * Kerr Space: Spherical KS and BL coordinates
+ * Kerr Space: Spherical KS and BL coordinates, Cartesian KS coordinates (2D only, see GRCoordinates)
  * 
  * Transformations:
  * Nulls in Cartesian and Spherical coordinates
  * "Modified": r=exp(x1), th=pi*x2 + (1-hslope)*etc
  * "Funky" modified: additional non-invertible cylindrization of th
  * 
- * TODO Cartesian KS base
+ * TODO 3D geometry caches for Cartesian KS, analytic derivatives
  * TODO snake coordinate transform for Cartesian Minkowski
  * TODO CMKS, MKS3 transforms, proper Cartesian<->Spherical functions stolen from e.g. coordinate_utils.hpp
  * TODO overhaul the LEGACY_TH stuff
@@ -68,6 +68,9 @@
  * EMBEDDING SYSTEMS:
  * These are the usual systems of coordinates for different spacetimes.
  * Each system/class must define at least gcov_embed, returning the metric in terms of their own coordinates Xembed
+ * Systems with analytic_derivs also define dgcov_embed, returning dg[mu][nu][lam] = d_lam g_mu_nu,
+ * used to compute the connection coefficients without finite differences.
+ * Systems are axisymmetric if the metric is independent of X3, which the geometry caches assume.
  * Some extra convenience classes have been defined for some systems.
  */
 
@@ -78,11 +81,17 @@ class CartMinkowskiCoords {
     public:
         static constexpr char name[] = "CartMinkowskiCoords";
         static constexpr bool spherical = false;
+        static constexpr bool axisymmetric = true;
+        static constexpr bool analytic_derivs = true;
         static constexpr GReal a = 0.0;
-        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], Real gcov[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], GReal gcov[GR_DIM][GR_DIM]) const
         {
             DLOOP2 gcov[mu][nu] = (mu == nu) - 2*(mu == 0 && nu == 0);
         }
+        KOKKOS_INLINE_FUNCTION void dgcov_embed(const GReal Xembed[GR_DIM], GReal dg[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            DLOOP3 dg[mu][nu][lam] = 0.;
+        }
 };
 
 /**
@@ -92,8 +101,10 @@ class SphMinkowskiCoords {
     public:
         static constexpr char name[] = "SphMinkowskiCoords";
         static constexpr bool spherical = true;
+        static constexpr bool axisymmetric = true;
+        static constexpr bool analytic_derivs = true;
         static constexpr GReal a = 0.0;
-        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], Real gcov[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], GReal gcov[GR_DIM][GR_DIM]) const
         {
             const GReal r = m::max(Xembed[1], SMALL);
             const GReal th = excise(excise(Xembed[2], 0.0, SMALL), M_PI, SMALL);
@@ -105,6 +116,18 @@ class SphMinkowskiCoords {
             gcov[2][2] = r*r;
             gcov[3][3] = sth*sth*r*r;
         }
+        KOKKOS_INLINE_FUNCTION void dgcov_embed(const GReal Xembed[GR_DIM], GReal dg[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            const GReal r = m::max(Xembed[1], SMALL);
+            const GReal th = excise(excise(Xembed[2], 0.0, SMALL), M_PI, SMALL);
+            const GReal cth = m::cos(th);
+            const GReal sth = m::sin(th);
+
+            DLOOP3 dg[mu][nu][lam] = 0.;
+            dg[2][2][1] = 2.*r;
+            dg[3][3][1] = 2.*r*sth*sth;
+            dg[3][3][2] = 2.*sth*cth*r*r;
+        }
 };
 
 /**
@@ -116,10 +139,12 @@ class SphKSCoords {
         // BH Spin is a property of KS
         const GReal a;
         static constexpr bool spherical = true;
+        static constexpr bool axisymmetric = true;
+        static constexpr bool analytic_derivs = true;
 
         KOKKOS_FUNCTION SphKSCoords(GReal spin): a(spin) {};
 
-        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], Real gcov[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], GReal gcov[GR_DIM][GR_DIM]) const
         {
             const GReal r = Xembed[1];
             const GReal th = excise(excise(Xembed[2], 0.0, SMALL), M_PI, SMALL);
@@ -149,12 +174,45 @@ class SphKSCoords {
             gcov[3][2] = 0.;
             gcov[3][3] = sin2*(rho2 + a*a*sin2*(1. + 2.*r/rho2));
         }
+        KOKKOS_INLINE_FUNCTION void dgcov_embed(const GReal Xembed[GR_DIM], GReal dg[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            const GReal r = Xembed[1];
+            const GReal th = excise(excise(Xembed[2], 0.0, SMALL), M_PI, SMALL);
+
+            const GReal cth = m::cos(th);
+            const GReal sth = m::sin(th);
+            const GReal sin2 = sth*sth;
+            const GReal rho2 = r*r + a*a*cth*cth;
+            // Everything is written in terms of rho2, q = 2r/rho2 and sin^2(th)
+            const GReal q = 2.*r/rho2;
+
+            DLOOP3 dg[mu][nu][lam] = 0.;
+            // Derivatives in r (lam=1) and th (lam=2)
+            const GReal drho2[2] = {2.*r, -2.*a*a*cth*sth};
+            const GReal dq[2] = {2.*(rho2 - 2.*r*r)/(rho2*rho2), 4.*r*a*a*cth*sth/(rho2*rho2)};
+            const GReal dsin2[2] = {0., 2.*sth*cth};
+            for (int d = 0; d < 2; d++) {
+                const int lam = d + 1;
+                dg[0][0][lam] = dq[d];
+                dg[0][1][lam] = dq[d];
+                dg[0][3][lam] = -a*(dsin2[d]*q + sin2*dq[d]);
+                dg[1][1][lam] = dq[d];
+                dg[1][3][lam] = -a*(dsin2[d]*(1. + q) + sin2*dq[d]);
+                dg[2][2][lam] = drho2[d];
+                dg[3][3][lam] = dsin2[d]*(rho2 + a*a*sin2*(1. + q))
+                                + sin2*(drho2[d] + a*a*(dsin2[d]*(1. + q) + sin2*dq[d]));
+                // Symmetric counterparts
+                dg[1][0][lam] = dg[0][1][lam];
+                dg[3][0][lam] = dg[0][3][lam];
+                dg[3][1][lam] = dg[1][3][lam];
+            }
+        }
 
         // For converting from BL
-        KOKKOS_INLINE_FUNCTION void vec_from_bl(const GReal Xembed[GR_DIM], const Real vcon_bl[GR_DIM], Real vcon[GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void vec_from_bl(const GReal Xembed[GR_DIM], const GReal vcon_bl[GR_DIM], GReal vcon[GR_DIM]) const
         {
             GReal r = Xembed[1];
-            Real trans[GR_DIM][GR_DIM];
+            GReal trans[GR_DIM][GR_DIM];
             DLOOP2 trans[mu][nu] = (mu == nu);
             trans[0][1] = 2.*r/(r*r - 2.*r + a*a);
             trans[3][1] = a/(r*r - 2.*r + a*a);
@@ -163,7 +221,7 @@ class SphKSCoords {
             DLOOP2 vcon[mu] += trans[mu][nu]*vcon_bl[nu];
         }
 
-        KOKKOS_INLINE_FUNCTION void vec_to_bl(const GReal Xembed[GR_DIM], const Real vcon_bl[GR_DIM], Real vcon[GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void vec_to_bl(const GReal Xembed[GR_DIM], const GReal vcon_bl[GR_DIM], GReal vcon[GR_DIM]) const
         {
             GReal r = Xembed[1];
             GReal rtrans[GR_DIM][GR_DIM], trans[GR_DIM][GR_DIM];
@@ -178,6 +236,41 @@ class SphKSCoords {
         }
 };
 
+/**
+ * Cartesian Kerr-Schild coordinates, with the BH spin along z.
+ * g_mu_nu = eta_mu_nu + f l_mu l_nu, with r the KS radius satisfying
+ * (x^2 + y^2)/(r^2 + a^2) + z^2/r^2 = 1
+ * The metric depends on all of x,y,z, so this system is not axisymmetric.
+ */
+class CartKSCoords {
+    public:
+        static constexpr char name[] = "CartKSCoords";
+        // BH Spin is a property of KS
+        const GReal a;
+        static constexpr bool spherical = false;
+        static constexpr bool axisymmetric = false;
+        static constexpr bool analytic_derivs = false;
+
+        KOKKOS_FUNCTION CartKSCoords(GReal spin): a(spin) {};
+
+        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], GReal gcov[GR_DIM][GR_DIM]) const
+        {
+            const GReal x = Xembed[1];
+            const GReal y = Xembed[2];
+            const GReal z = Xembed[3];
+            const GReal R2 = x*x + y*y + z*z;
+            const GReal a2 = a*a;
+            // Floor r away from the ring singularity
+            const GReal r = m::max(m::sqrt((R2 - a2 + m::sqrt(SQR(R2 - a2) + 4.*a2*z*z)) / 2.), SMALL);
+            const GReal r2 = r*r;
+
+            const GReal f = 2.*r2*r / (r2*r2 + a2*z*z);
+            const GReal l[GR_DIM] = {1., (r*x + a*y)/(r2 + a2), (r*y - a*x)/(r2 + a2), z/r};
+
+            DLOOP2 gcov[mu][nu] = (mu == nu) - 2*(mu == 0 && nu == 0) + f*l[mu]*l[nu];
+        }
+};
+
 /**
  * Spherical Kerr-Schild coordinates w/ external gravity term
  */
@@ -187,13 +280,15 @@ class SphKSExtG {
         // BH Spin is a property of KS
         const GReal a;
         static constexpr bool spherical = true;
+        static constexpr bool axisymmetric = true;
+        static constexpr bool analytic_derivs = false;
 
         static constexpr GReal A = 1.46797639e-8;
         static constexpr GReal B = 1.29411117;
 
         KOKKOS_FUNCTION SphKSExtG(GReal spin): a(spin) {};
 
-        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], Real gcov[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], GReal gcov[GR_DIM][GR_DIM]) const
         {
             const GReal r = Xembed[1];
             const GReal th = excise(excise(Xembed[2], 0.0, SMALL), M_PI, SMALL);
@@ -228,10 +323,10 @@ class SphKSExtG {
 
         // For converting from BL
         // TODO will we ever need a from_ks?
-        KOKKOS_INLINE_FUNCTION void vec_from_bl(const GReal Xembed[GR_DIM], const Real vcon_bl[GR_DIM], Real vcon[GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void vec_from_bl(const GReal Xembed[GR_DIM], const GReal vcon_bl[GR_DIM], GReal vcon[GR_DIM]) const
         {
             GReal r = Xembed[1];
-            Real trans[GR_DIM][GR_DIM];
+            GReal trans[GR_DIM][GR_DIM];
             DLOOP2 trans[mu][nu] = (mu == nu);
 
             // external gravity from GIZMO
@@ -244,7 +339,7 @@ class SphKSExtG {
             DLOOP2 vcon[mu] += trans[mu][nu]*vcon_bl[nu];
         }
 
-        KOKKOS_INLINE_FUNCTION void vec_to_bl(const GReal Xembed[GR_DIM], const Real vcon_bl[GR_DIM], Real vcon[GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void vec_to_bl(const GReal Xembed[GR_DIM], const GReal vcon_bl[GR_DIM], GReal vcon[GR_DIM]) const
         {
             GReal r = Xembed[1];
             GReal rtrans[GR_DIM][GR_DIM], trans[GR_DIM][GR_DIM];
@@ -271,10 +366,12 @@ class SphBLCoords {
         // BH Spin is a property of BL
         const GReal a;
         static constexpr bool spherical = true;
+        static constexpr bool axisymmetric = true;
+        static constexpr bool analytic_derivs = false;
 
         KOKKOS_FUNCTION SphBLCoords(GReal spin): a(spin) {}
 
-        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], Real gcov[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], GReal gcov[GR_DIM][GR_DIM]) const
         {
             const GReal r = Xembed[1];
             const GReal th = excise(excise(Xembed[2], 0.0, SMALL), M_PI, SMALL);
@@ -308,13 +405,15 @@ class SphBLExtG {
         // BH Spin is a property of BL
         const GReal a;
         static constexpr bool spherical = true;
+        static constexpr bool axisymmetric = true;
+        static constexpr bool analytic_derivs = false;
 
         static constexpr GReal A = 1.46797639e-8;
         static constexpr GReal B = 1.29411117;
 
         KOKKOS_FUNCTION SphBLExtG(GReal spin): a(spin) {}
 
-        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], Real gcov[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void gcov_embed(const GReal Xembed[GR_DIM], GReal gcov[GR_DIM][GR_DIM]) const
         {
             const GReal r = Xembed[1];
             const GReal th = excise(excise(Xembed[2], 0.0, SMALL), M_PI, SMALL);
@@ -343,6 +442,7 @@ class SphBLExtG {
  * Each class must define enough functions to apply the transform to coordinates and vectors,
  * both forward and in reverse.
  * That comes out to 4 functions: coord_to_embed, coord_to_native, dXdx, dxdX
+ * Transforms with analytic_derivs also define d2xdX2, d2[mu][nu][lam] = d_lam dxdX[mu][nu]
  */
 
 /**
@@ -353,6 +453,7 @@ class NullTransform {
         static constexpr char name[] = "NullTransform";
         static constexpr GReal startx[3] = {-1, -1, -1};
         static constexpr GReal stopx[3] = {-1, -1, -1};
+        static constexpr bool analytic_derivs = true;
         // Coordinate transformations
         // Any coordinate value protections (th < 0, th > pi, phi > 2pi) should be in the base system
         KOKKOS_INLINE_FUNCTION void coord_to_embed(const GReal Xnative[GR_DIM], GReal Xembed[GR_DIM]) const
@@ -364,14 +465,18 @@ class NullTransform {
             DLOOP1 Xnative[mu] = Xembed[mu];
         }
         // Tangent space transformation matrices
-        KOKKOS_INLINE_FUNCTION void dxdX(const GReal X[GR_DIM], Real dxdX[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void dxdX(const GReal X[GR_DIM], GReal dxdX[GR_DIM][GR_DIM]) const
         {
             DLOOP2 dxdX[mu][nu] = (mu == nu);
         }
-        KOKKOS_INLINE_FUNCTION void dXdx(const GReal X[GR_DIM], Real dXdx[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void dXdx(const GReal X[GR_DIM], GReal dXdx[GR_DIM][GR_DIM]) const
         {
             DLOOP2 dXdx[mu][nu] = (mu == nu);
         }
+        KOKKOS_INLINE_FUNCTION void d2xdX2(const GReal X[GR_DIM], GReal d2[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            DLOOP3 d2[mu][nu][lam] = 0.;
+        }
 };
 // This only exists separately to define startx & stopx. Could fall back on base coords for these?
 class SphNullTransform {
@@ -379,6 +484,7 @@ class SphNullTransform {
         static constexpr char name[] = "SphNullTransform";
         static constexpr GReal startx[3] = {-1, 0., 0.};
         static constexpr GReal stopx[3] = {-1, M_PI, 2*M_PI};
+        static constexpr bool analytic_derivs = true;
         // Coordinate transformations
         // Any coordinate value protections (th < 0, th > pi, phi > 2pi) should be in the base system
         KOKKOS_INLINE_FUNCTION void coord_to_embed(const GReal Xnative[GR_DIM], GReal Xembed[GR_DIM]) const
@@ -390,14 +496,18 @@ class SphNullTransform {
             DLOOP1 Xnative[mu] = Xembed[mu];
         }
         // Tangent space transformation matrices
-        KOKKOS_INLINE_FUNCTION void dxdX(const GReal X[GR_DIM], Real dxdX[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void dxdX(const GReal X[GR_DIM], GReal dxdX[GR_DIM][GR_DIM]) const
         {
             DLOOP2 dxdX[mu][nu] = (mu == nu);
         }
-        KOKKOS_INLINE_FUNCTION void dXdx(const GReal X[GR_DIM], Real dXdx[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void dXdx(const GReal X[GR_DIM], GReal dXdx[GR_DIM][GR_DIM]) const
         {
             DLOOP2 dXdx[mu][nu] = (mu == nu);
         }
+        KOKKOS_INLINE_FUNCTION void d2xdX2(const GReal X[GR_DIM], GReal d2[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            DLOOP3 d2[mu][nu][lam] = 0.;
+        }
 };
 
 /**
@@ -409,6 +519,7 @@ class ExponentialTransform {
         static constexpr char name[] = "ExponentialTransform";
         static constexpr GReal startx[3] = {-1, 0., 0.};
         static constexpr GReal stopx[3] = {-1, M_PI, 2*M_PI};
+        static constexpr bool analytic_derivs = true;
 
         // Coordinate transformations
         KOKKOS_INLINE_FUNCTION void coord_to_embed(const GReal Xnative[GR_DIM], GReal Xembed[GR_DIM]) const
@@ -432,7 +543,7 @@ class ExponentialTransform {
         /**
          * Transformation matrix for contravariant vectors to embedding, or covariant vectors to native
          */
-        KOKKOS_INLINE_FUNCTION void dxdX(const GReal Xnative[GR_DIM], Real dxdX[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void dxdX(const GReal Xnative[GR_DIM], GReal dxdX[GR_DIM][GR_DIM]) const
         {
             gzero2(dxdX);
             dxdX[0][0] = 1.;
@@ -443,7 +554,7 @@ class ExponentialTransform {
         /**
          * Transformation matrix for contravariant vectors to native, or covariant vectors to embedding
          */
-        KOKKOS_INLINE_FUNCTION void dXdx(const GReal Xnative[GR_DIM], Real dXdx[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void dXdx(const GReal Xnative[GR_DIM], GReal dXdx[GR_DIM][GR_DIM]) const
         {
             gzero2(dXdx);
             dXdx[0][0] = 1.;
@@ -451,6 +562,14 @@ class ExponentialTransform {
             dXdx[2][2] = 1.;
             dXdx[3][3] = 1.;
         }
+        /**
+         * Derivatives of dxdX, d2[mu][nu][lam] = d_lam dxdX[mu][nu]
+         */
+        KOKKOS_INLINE_FUNCTION void d2xdX2(const GReal Xnative[GR_DIM], GReal d2[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            DLOOP3 d2[mu][nu][lam] = 0.;
+            d2[1][1][1] = m::exp(Xnative[1]);
+        }
 };
 
 /**
@@ -462,6 +581,7 @@ class SuperExponentialTransform {
         static constexpr char name[] = "SuperExponentialTransform";
         static constexpr GReal startx[3] = {-1, 0., 0.};
         static constexpr GReal stopx[3] = {-1, M_PI, 2*M_PI};
+        static constexpr bool analytic_derivs = true;
 
         const GReal xe1br, xn1br;
         const double npow2, cpow2;
@@ -494,7 +614,7 @@ class SuperExponentialTransform {
         /**
          * Transformation matrix for contravariant vectors to embedding, or covariant vectors to native
          */
-        KOKKOS_INLINE_FUNCTION void dxdX(const GReal Xnative[GR_DIM], Real dxdX[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void dxdX(const GReal Xnative[GR_DIM], GReal dxdX[GR_DIM][GR_DIM]) const
         {
             gzero2(dxdX);
             dxdX[0][0] = 1.;
@@ -507,7 +627,7 @@ class SuperExponentialTransform {
         /**
          * Transformation matrix for contravariant vectors to native, or covariant vectors to embedding
          */
-        KOKKOS_INLINE_FUNCTION void dXdx(const GReal Xnative[GR_DIM], Real dXdx[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void dXdx(const GReal Xnative[GR_DIM], GReal dXdx[GR_DIM][GR_DIM]) const
         {
             gzero2(dXdx);
             dXdx[0][0] = 1.;
@@ -517,6 +637,23 @@ class SuperExponentialTransform {
             dXdx[2][2] = 1.;
             dXdx[3][3] = 1.;
         }
+        /**
+         * Derivatives of dxdX, d2[mu][nu][lam] = d_lam dxdX[mu][nu]
+         */
+        KOKKOS_INLINE_FUNCTION void d2xdX2(const GReal Xnative[GR_DIM], GReal d2[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            DLOOP3 d2[mu][nu][lam] = 0.;
+            const GReal super_dist = Xnative[1] - xn1br;
+            if (super_dist > 0) {
+                const GReal r = m::exp(Xnative[1] + cpow2 * m::pow(super_dist, npow2));
+                const GReal dlogr = 1 + cpow2 * npow2 * m::pow(super_dist, npow2-1);
+                // The second term vanishes for npow2 == 1, avoid 0*inf near the break
+                const GReal d2logr = (npow2 == 1) ? 0. : cpow2 * npow2 * (npow2-1) * m::pow(super_dist, npow2-2);
+                d2[1][1][1] = r * (dlogr*dlogr + d2logr);
+            } else {
+                d2[1][1][1] = m::exp(Xnative[1]);
+            }
+        }
 };
 
 /**
@@ -528,6 +665,7 @@ class ModifyTransform {
         static constexpr char name[] = "ModifyTransform";
         static constexpr GReal startx[3] = {-1, 0., 0.};
         static constexpr GReal stopx[3] = {-1, 1., 2*M_PI};
+        static constexpr bool analytic_derivs = true;
 
         const GReal hslope;
 
@@ -558,7 +696,7 @@ class ModifyTransform {
         /**
          * Transformation matrix for contravariant vectors to embedding, or covariant vectors to native
          */
-        KOKKOS_INLINE_FUNCTION void dxdX(const GReal Xnative[GR_DIM], Real dxdX[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void dxdX(const GReal Xnative[GR_DIM], GReal dxdX[GR_DIM][GR_DIM]) const
         {
             gzero2(dxdX);
             dxdX[0][0] = 1.;
@@ -569,7 +707,7 @@ class ModifyTransform {
         /**
          * Transformation matrix for contravariant vectors to native, or covariant vectors to embedding
          */
-        KOKKOS_INLINE_FUNCTION void dXdx(const GReal Xnative[GR_DIM], Real dXdx[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void dXdx(const GReal Xnative[GR_DIM], GReal dXdx[GR_DIM][GR_DIM]) const
         {
             gzero2(dXdx);
             dXdx[0][0] = 1.;
@@ -577,6 +715,15 @@ class ModifyTransform {
             dXdx[2][2] = 1 / (M_PI - (hslope - 1.)*M_PI*m::cos(2.*M_PI*Xnative[2]));
             dXdx[3][3] = 1.;
         }
+        /**
+         * Derivatives of dxdX, d2[mu][nu][lam] = d_lam dxdX[mu][nu]
+         */
+        KOKKOS_INLINE_FUNCTION void d2xdX2(const GReal Xnative[GR_DIM], GReal d2[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            DLOOP3 d2[mu][nu][lam] = 0.;
+            d2[1][1][1] = m::exp(Xnative[1]);
+            d2[2][2][2] = 2.*M_PI*M_PI*(hslope - 1.)*m::sin(2.*M_PI*Xnative[2]);
+        }
 };
 
 /**
@@ -588,6 +735,7 @@ class FunkyTransform {
         static constexpr char name[] = "FunkyTransform";
         static constexpr GReal startx[3] = {-1, 0., 0.};
         static constexpr GReal stopx[3] = {-1, 1., 2*M_PI};
+        static constexpr bool analytic_derivs = true;
 
         const GReal startx1;
         const GReal hslope, poly_xt, poly_alpha, mks_smooth;
@@ -627,7 +775,7 @@ class FunkyTransform {
         /**
          * Transformation matrix for contravariant vectors to embedding, or covariant vectors to native
          */
-        KOKKOS_INLINE_FUNCTION void dxdX(const GReal Xnative[GR_DIM], Real dxdX[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void dxdX(const GReal Xnative[GR_DIM], GReal dxdX[GR_DIM][GR_DIM]) const
         {
             gzero2(dxdX);
             dxdX[0][0] = 1.;
@@ -657,17 +805,41 @@ class FunkyTransform {
         /**
          * Transformation matrix for contravariant vectors to native, or covariant vectors to embedding
          */
-        KOKKOS_INLINE_FUNCTION void dXdx(const GReal Xnative[GR_DIM], Real dXdx[GR_DIM][GR_DIM]) const
+        KOKKOS_INLINE_FUNCTION void dXdx(const GReal Xnative[GR_DIM], GReal dXdx[GR_DIM][GR_DIM]) const
         {
             // Okay this one should probably stay numerical
-            Real dxdX_tmp[GR_DIM][GR_DIM];
+            GReal dxdX_tmp[GR_DIM][GR_DIM];
             dxdX(Xnative, dxdX_tmp);
             invert(&dxdX_tmp[0][0],&dXdx[0][0]);
         }
+        /**
+         * Derivatives of dxdX, d2[mu][nu][lam] = d_lam dxdX[mu][nu]
+         * Writing th = thG + E*(thJ - thG), with E = exp(mks_smooth*(startx1 - X1))
+         */
+        KOKKOS_INLINE_FUNCTION void d2xdX2(const GReal Xnative[GR_DIM], GReal d2[GR_DIM][GR_DIM][GR_DIM]) const
+        {
+            const GReal E = m::exp(mks_smooth * (startx1 - Xnative[1]));
+            const GReal y = 2.*Xnative[2] - 1.;
+
+            const GReal thG = M_PI*Xnative[2] + ((1. - hslope)/2.)*m::sin(2.*M_PI*Xnative[2]);
+            const GReal dthG = M_PI + (1. - hslope)*M_PI*m::cos(2.*M_PI*Xnative[2]);
+            const GReal d2thG = -2.*M_PI*M_PI*(1. - hslope)*m::sin(2.*M_PI*Xnative[2]);
+
+            const GReal thJ = poly_norm * y * (1. + m::pow(y/poly_xt, poly_alpha) / (poly_alpha + 1.)) + 0.5 * M_PI;
+            const GReal dthJ = 2.*poly_norm * (1. + m::pow(y/poly_xt, poly_alpha));
+            const GReal d2thJ = 4.*poly_norm*poly_alpha/poly_xt * m::pow(y/poly_xt, poly_alpha - 1.);
+
+            DLOOP3 d2[mu][nu][lam] = 0.;
+            d2[1][1][1] = m::exp(Xnative[1]);
+            d2[2][1][1] = mks_smooth*mks_smooth * E * (thJ - thG);
+            d2[2][1][2] = -mks_smooth * E * (dthJ - dthG);
+            d2[2][2][1] = d2[2][1][2];
+            d2[2][2][2] = d2thG + E * (d2thJ - d2thG);
+        }
 };
 
 // Bundle coordinates and transforms into umbrella variant types
 // These act as a wannabe "interface" or "parent class" with the exception that access requires "mpark::visit"
 // See coordinate_embedding.hpp
-using SomeBaseCoords = mpark::variant<SphMinkowskiCoords, CartMinkowskiCoords, SphBLCoords, SphKSCoords, SphBLExtG, SphKSExtG>;
+using SomeBaseCoords = mpark::variant<SphMinkowskiCoords, CartMinkowskiCoords, SphBLCoords, SphKSCoords, SphBLExtG, SphKSExtG, CartKSCoords>;
 using SomeTransform = mpark::variant<NullTransform, SphNullTransform, ExponentialTransform, SuperExponentialTransform, ModifyTransform, FunkyTransform>;
@@ -42,6 +42,9 @@
 // types, which are not available when importing this file's header
 #include "types.hpp"
 
+#include <map>
+#include <tuple>
+
 using Kokkos::MDRangePolicy;
 using Kokkos::Rank;
 
@@ -70,8 +73,28 @@ GRCoordinates::GRCoordinates(const RegionSize &rs, ParameterInput *pin): Uniform
     n3 = rs.nx(X3DIR) > 1 ? rs.nx(X3DIR) + 2*Globals::nghost : 1;
     //cout << "Initialized coordinates with nghost " << Globals::nghost << std::endl;
 
+    // Geometry is stored and looked up by (j,i) alone.  Metrics depending on X3 (e.g. Cartesian KS)
+    // are fine so long as each block has just one plane in X3, i.e. in 2D
+    if (!coords.is_axisymmetric() && n3 > 1) {
+        throw std::invalid_argument("Coordinate system "+coords.variant_names()+" depends on X3, and is only supported in 2D!");
+    }
+
     connection_average_points = pin->GetOrAddInteger("coordinates", "connection_average_points", 1);
     correct_connections = pin->GetOrAddBoolean("coordinates", "correct_connections", false);
+    share_cache = pin->GetOrAddBoolean("coordinates", "share_geometry_cache", true);
+    compute_metric = pin->GetOrAddBoolean("coordinates", "compute_metric", false);
+    cache_embed = pin->GetOrAddBoolean("coordinates", "cache_embedding", true) && coords.is_spherical();
+    geom_pool_size = pin->GetOrAddInteger("coordinates", "geometry_pool_size", 16);
+    if (geom_pool_size < 1) throw std::invalid_argument("Geometry pool size must be at least 1!");
+    const std::string precision = pin->GetOrAddString("coordinates", "geometry_precision", "double");
+    if (precision != "double" && precision != "single")
+        throw std::invalid_argument("Unknown geometry precision "+precision+"! Use double or single.");
+    // Nothing to store if the metric is computed on the fly
+    single_metric = (precision == "single") && !compute_metric;
+    if (compute_metric && connection_average_points > 1) {
+        // On-the-fly values are point values, which would disagree with the averaged gdet
+        throw std::invalid_argument("Computing the metric on the fly is incompatible with connection_average_points > 1!");
+    }
 
     init_GRCoordinates(*this);
 }
@@ -79,43 +102,138 @@ GRCoordinates::GRCoordinates(const RegionSize &rs, ParameterInput *pin): Uniform
 GRCoordinates::GRCoordinates(const GRCoordinates &src, int coarsen): UniformCartesian(src, coarsen),
     coords(src.coords), n1(src.n1/coarsen), n2(src.n2/coarsen), n3(src.n3/coarsen),
     connection_average_points(src.connection_average_points),
-    correct_connections(src.correct_connections)
+    correct_connections(src.correct_connections), share_cache(src.share_cache),
+    compute_metric(src.compute_metric), cache_embed(src.cache_embed),
+    single_metric(src.single_metric), geom_pool_size(src.geom_pool_size)
 {
     //std::cerr << "Calling coarsen constructor" << std::endl;
     init_GRCoordinates(*this);
 }
 
+// Blocks' geometry caches, keyed on everything the contents depend on:
+// the corners of the (j,i) plane including ghost zones, its size, and the averaging options
+using GeomCacheKey = std::tuple<GReal, GReal, GReal, GReal, int, int, int, bool, bool, bool, bool>;
+// An entry is also what a pool of caches holds, plus the slot in it
+struct GeomCacheEntry {
+    GeomTensor2 gcon, gcov;
+    GeomTensor2F gcon_single, gcov_single;
+    GeomScalar gdet;
+    GeomTensor3 conn, gdet_conn;
+    GeomTensor2 embed;
+    int slot = 0;
+};
+static std::map<GeomCacheKey, GeomCacheEntry>& geom_cache()
+{
+    // Views must be freed before Kokkos is finalized, not at static destruction
+    static std::map<GeomCacheKey, GeomCacheEntry> cache;
+    static bool hooked = false;
+    if (!hooked) {
+        Kokkos::push_finalize_hook([]() { geom_cache().clear(); });
+        hooked = true;
+    }
+    return cache;
+}
+
+// Pools of caches, allocated geom_pool_size blocks at a time so that bursts of new
+// blocks (e.g. on regrid) don't each allocate (and zero-fill, and fence) their own arrays.
+// Keyed on everything the array sizes depend on
+using GeomPoolKey = std::tuple<int, int, bool, bool, bool>;
+struct GeomPool {
+    GeomCacheEntry arrays;
+    int size = 0;
+};
+static std::map<GeomPoolKey, GeomPool>& geom_pools()
+{
+    static std::map<GeomPoolKey, GeomPool> pools;
+    static bool hooked = false;
+    if (!hooked) {
+        Kokkos::push_finalize_hook([]() { geom_pools().clear(); });
+        hooked = true;
+    }
+    return pools;
+}
+
 /**
- * Initialize any cached geometry that GRCoordinates will need to return. While
- * GRCoordinates objects will be moved device-side, this can be run only on the
- * host.
- *
- * This needs to be defined *outside* of the GRCoordinates object, because of some
- * fun issues with C++ Lambda capture, which Kokkos brings to the fore
+ * Point G's caches at a free slot in a pool of the right size, allocating a new pool if needed.
+ * Slots are never returned: like the shared caches, they're kept for the whole run.
+ * On OpenMP builds, note the pages of a pool are placed by Kokkos's zero-fill at allocation, not by init_geom:
+ * the fill splits the pool evenly over threads in slot order, as kernels over a pack split its blocks,
+ * so with bound threads (see print_thread_binding) each block's geometry lands near the threads stepping it.
  */
-void init_GRCoordinates(GRCoordinates& G) {
+static void assign_geom_slot(GRCoordinates& G)
+{
     const int n1 = G.n1;
     const int n2 = G.n2;
-    const int n3 = G.n3;
-    const bool correct_connections = G.correct_connections;
-    const int connection_average_points = G.connection_average_points;
+    auto& pool = geom_pools()[GeomPoolKey{n1, n2, G.compute_metric, G.cache_embed, G.single_metric}];
+    if (pool.size == 0 || pool.arrays.slot >= pool.size) {
+        const int np = G.geom_pool_size;
+        pool.size = np;
+        pool.arrays.slot = 0;
+        // gcon/gcov are left unallocated if they'll be computed on the fly,
+        // and only allocated in the precision they'll be read in otherwise
+#if PACKED_GEOM_CACHE
+        if (G.single_metric) {
+            pool.arrays.gcon_single = GeomTensor2F("gcon", np*NLOC, n2+1, n1+1, GR_SYM);
+            pool.arrays.gcov_single = GeomTensor2F("gcov", np*NLOC, n2+1, n1+1, GR_SYM);
+        } else if (!G.compute_metric) {
+            pool.arrays.gcon = GeomTensor2("gcon", np*NLOC, n2+1, n1+1, GR_SYM);
+            pool.arrays.gcov = GeomTensor2("gcov", np*NLOC, n2+1, n1+1, GR_SYM);
+        }
+#else
+        if (G.single_metric) {
+            pool.arrays.gcon_single = GeomTensor2F("gcon", np*NLOC, n2+1, n1+1, GR_DIM, GR_DIM);
+            pool.arrays.gcov_single = GeomTensor2F("gcov", np*NLOC, n2+1, n1+1, GR_DIM, GR_DIM);
+        } else if (!G.compute_metric) {
+            pool.arrays.gcon = GeomTensor2("gcon", np*NLOC, n2+1, n1+1, GR_DIM, GR_DIM);
+            pool.arrays.gcov = GeomTensor2("gcov", np*NLOC, n2+1, n1+1, GR_DIM, GR_DIM);
+        }
+#endif
+        pool.arrays.gdet = GeomScalar("gdet", np*NLOC, n2+1, n1+1);
+#if PACKED_GEOM_CACHE
+        pool.arrays.conn = GeomTensor3("conn", np, n2, n1, GR_DIM, GR_SYM);
+        pool.arrays.gdet_conn = GeomTensor3("conn", np, n2, n1, GR_DIM, GR_SYM);
+#else
+        pool.arrays.conn = GeomTensor3("conn", np, n2, n1, GR_DIM, GR_DIM, GR_DIM);
+        pool.arrays.gdet_conn = GeomTensor3("conn", np, n2, n1, GR_DIM, GR_DIM, GR_DIM);
+#endif
+        if (G.cache_embed)
+            pool.arrays.embed = GeomTensor2("embed", np*NLOC, n2+1, n1+1, 2);
+    }
+    G.gcon_direct = pool.arrays.gcon;
+    G.gcov_direct = pool.arrays.gcov;
+    G.gcon_single = pool.arrays.gcon_single;
+    G.gcov_single = pool.arrays.gcov_single;
+    G.gdet_direct = pool.arrays.gdet;
+    G.conn_direct = pool.arrays.conn;
+    G.gdet_conn_direct = pool.arrays.gdet_conn;
+    G.embed_direct = pool.arrays.embed;
+    G.geom_slot = pool.arrays.slot++;
+}
 
-    //cerr << "Creating GRCoordinate cache size " << n1 << " " << n2 << std::endl;
-    // Cache geometry.  May be faster than re-computing. May not be.
-    G.gcon_direct = GeomTensor2("gcon", NLOC, n2+1, n1+1, GR_DIM, GR_DIM);
-    G.gcov_direct = GeomTensor2("gcov", NLOC, n2+1, n1+1, GR_DIM, GR_DIM);
-    G.gdet_direct = GeomScalar("gdet", NLOC, n2+1, n1+1);
-    G.conn_direct = GeomTensor3("conn", n2, n1, GR_DIM, GR_DIM, GR_DIM);
-    G.gdet_conn_direct = GeomTensor3("conn", n2, n1, GR_DIM, GR_DIM, GR_DIM);
+/**
+ * Fill the geometry caches of G, evaluating the metric with coords,
+ * which is either G.coords or an equivalent FixedEmbedding
+ */
+template<typename Embedding>
+void init_geom_cache(const GRCoordinates& G, const Embedding& coords)
+{
+    const int n1 = G.n1;
+    const int n2 = G.n2;
+    const int connection_average_points = G.connection_average_points;
+    const bool compute_metric = G.compute_metric;
+    const bool cache_embed = G.cache_embed;
+    const bool single_metric = G.single_metric;
+    const int slot = G.geom_slot;
 
-    // Member variables have an implicit this->
-    // C++ Lambdas (and therefore Kokkos Lambdas) capture pointers to objects, not full objects
-    // Hence, you *CANNOT* use this->, or members, from inside kernels
+    // See init_GRCoordinates re: captures
     auto gcon_local = G.gcon_direct;
     auto gcov_local = G.gcov_direct;
+    auto gcon_single_local = G.gcon_single;
+    auto gcov_single_local = G.gcov_single;
     auto gdet_local = G.gdet_direct;
     auto conn_local = G.conn_direct;
     auto gdet_conn_local = G.gdet_conn_direct;
+    auto embed_local = G.embed_direct;
 
     Kokkos::parallel_for("init_geom", MDRangePolicy<Rank<2>>({0,0}, {n2+1, n1+1}),
         KOKKOS_LAMBDA (const int& j, const int& i) {
@@ -123,10 +241,21 @@ void init_GRCoordinates(GRCoordinates& G) {
             // this highlights what's actually going on.
             for (int iloc =0; iloc < NLOC; iloc++) {
                 Loci loc = (Loci) iloc;
+                const int lslot = slot*NLOC + iloc;
+                if (cache_embed) {
+                    GReal X[GR_DIM], Xembed[GR_DIM];
+                    G.coord(0, j, i, loc, X);
+                    coords.coord_to_embed(X, Xembed);
+                    embed_local(lslot, j, i, 0) = Xembed[1];
+                    embed_local(lslot, j, i, 1) = Xembed[2];
+                }
                 // radius of points to sample, floor(npoints/2)
                 const int radius = connection_average_points / 2;
                 const int diameter = connection_average_points;
                 const int square = connection_average_points*connection_average_points;
+                // Averages are summed in double precision and stored at the end,
+                // so that single_metric rounds each element just once
+                GReal gdet_sum = 0., gcov_sum[GR_DIM][GR_DIM] = {0}, gcon_sum[GR_DIM][GR_DIM] = {0};
                 if (loc == Loci::center || loc == Loci::face3) {
                     // This prevents overstepping conn's bounds by halting in the last zone
                     if (i >= n1 || j >= n2) continue;
@@ -144,21 +273,21 @@ void init_GRCoordinates(GRCoordinates& G) {
                             X[2] += (Xn2[2] - X[2])/connection_average_points * l;
                             // Get geometry at points
                             GReal gcov_loc[GR_DIM][GR_DIM], gcon_loc[GR_DIM][GR_DIM];
-                            G.coords.gcov_native(X, gcov_loc);
-                            const GReal gdet = G.coords.gcon_native(gcov_loc, gcon_loc);
+                            coords.gcov_native(X, gcov_loc);
+                            const GReal gdet = coords.gcon_native(gcov_loc, gcon_loc);
                             // Add to running averages
-                            gdet_local(loc, j, i) += gdet / square;
+                            gdet_sum += gdet / square;
                             DLOOP2 {
-                                gcov_local(loc, j, i, mu, nu) += gcov_loc[mu][nu] / square;
-                                gcon_local(loc, j, i, mu, nu) += gcon_loc[mu][nu] / square;
+                                gcov_sum[mu][nu] += gcov_loc[mu][nu] / square;
+                                gcon_sum[mu][nu] += gcon_loc[mu][nu] / square;
                             }
                             if (loc == Loci::center) {
                                 // In the center, get the connection and gdet*connection
-                                Real conn_loc[GR_DIM][GR_DIM][GR_DIM];
-                                G.coords.conn_native(X, DELTA, conn_loc);
-                                DLOOP3 {
-                                    conn_local(j, i, mu, nu, lam) += conn_loc[mu][nu][lam] / square;
-                                    gdet_conn_local(j, i, mu, nu, lam) += gdet*conn_loc[mu][nu][lam] / square;
+                                GReal conn_loc[GR_DIM][GR_DIM][GR_DIM];
+                                coords.conn_native(X, DELTA, conn_loc);
+                                DLOOP3 if (geom_stored(nu, lam)) {
+                                    geom3_at(conn_local, slot, j, i, mu, nu, lam) += conn_loc[mu][nu][lam] / square;
+                                    geom3_at(gdet_conn_local, slot, j, i, mu, nu, lam) += gdet*conn_loc[mu][nu][lam] / square;
                                 }
                             }
                         }
@@ -176,13 +305,13 @@ void init_GRCoordinates(GRCoordinates& G) {
                         X[avg_dir] += (Xn1[avg_dir] - X[avg_dir])/diameter * k;
                         // Get geometry at the point
                         GReal gcov_loc[GR_DIM][GR_DIM], gcon_loc[GR_DIM][GR_DIM];
-                        G.coords.gcov_native(X, gcov_loc);
-                        const GReal gdet = G.coords.gcon_native(gcov_loc, gcon_loc);
+                        coords.gcov_native(X, gcov_loc);
+                        const GReal gdet = coords.gcon_native(gcov_loc, gcon_loc);
                         // Add to running averages
-                        gdet_local(loc, j, i) += gdet / diameter;
+                        gdet_sum += gdet / diameter;
                         DLOOP2 {
-                            gcov_local(loc, j, i, mu, nu) += gcov_loc[mu][nu] / diameter;
-                            gcon_local(loc, j, i, mu, nu) += gcon_loc[mu][nu] / diameter;
+                            gcov_sum[mu][nu] += gcov_loc[mu][nu] / diameter;
+                            gcon_sum[mu][nu] += gcon_loc[mu][nu] / diameter;
                         }
                     }
                 } else { // corner
@@ -191,18 +320,86 @@ void init_GRCoordinates(GRCoordinates& G) {
                     G.coord(0, j, i, loc, X);
                     // Get geometry
                     GReal gcov_loc[GR_DIM][GR_DIM], gcon_loc[GR_DIM][GR_DIM];
-                    G.coords.gcov_native(X, gcov_loc);
-                    const GReal gdet = G.coords.gcon_native(gcov_loc, gcon_loc);
-                    // Set geometry
-                    gdet_local(loc, j, i) = gdet;
+                    coords.gcov_native(X, gcov_loc);
+                    const GReal gdet = coords.gcon_native(gcov_loc, gcon_loc);
+                    gdet_sum = gdet;
                     DLOOP2 {
-                        gcov_local(loc, j, i, mu, nu) = gcov_loc[mu][nu];
-                        gcon_local(loc, j, i, mu, nu) = gcon_loc[mu][nu];
+                        gcov_sum[mu][nu] = gcov_loc[mu][nu];
+                        gcon_sum[mu][nu] = gcon_loc[mu][nu];
+                    }
+                }
+                // Set geometry
+                gdet_local(lslot, j, i) = gdet_sum;
+                if (single_metric) {
+                    DLOOP2 if (geom_stored(mu, nu)) {
+                        geom2_at(gcov_single_local, lslot, j, i, mu, nu) = (float) gcov_sum[mu][nu];
+                        geom2_at(gcon_single_local, lslot, j, i, mu, nu) = (float) gcon_sum[mu][nu];
+                    }
+                } else if (!compute_metric) {
+                    DLOOP2 if (geom_stored(mu, nu)) {
+                        geom2_at(gcov_local, lslot, j, i, mu, nu) = gcov_sum[mu][nu];
+                        geom2_at(gcon_local, lslot, j, i, mu, nu) = gcon_sum[mu][nu];
                     }
                 }
             }
         }
     );
+}
+
+/**
+ * Initialize any cached geometry that GRCoordinates will need to return. While
+ * GRCoordinates objects will be moved device-side, this can be run only on the
+ * host.
+ *
+ * This needs to be defined *outside* of the GRCoordinates object, because of some
+ * fun issues with C++ Lambda capture, which Kokkos brings to the fore
+ */
+void init_GRCoordinates(GRCoordinates& G) {
+    const int n1 = G.n1;
+    const int n2 = G.n2;
+    const int n3 = G.n3;
+    const bool correct_connections = G.correct_connections;
+    const int connection_average_points = G.connection_average_points;
+    const bool compute_metric = G.compute_metric;
+
+    // Reuse caches from an identical block if we can.
+    // Note entries are kept for the whole run, even once their blocks are gone
+    GReal Xlo[GR_DIM], Xhi[GR_DIM];
+    G.coord(0, 0, 0, Loci::corner, Xlo);
+    G.coord(0, n2, n1, Loci::corner, Xhi);
+    const GeomCacheKey key{Xlo[1], Xlo[2], Xhi[1], Xhi[2], n1, n2, connection_average_points,
+                          correct_connections, compute_metric, G.cache_embed, G.single_metric};
+    if (G.share_cache) {
+        auto& cache = geom_cache();
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            G.gcon_direct = it->second.gcon;
+            G.gcov_direct = it->second.gcov;
+            G.gcon_single = it->second.gcon_single;
+            G.gcov_single = it->second.gcov_single;
+            G.gdet_direct = it->second.gdet;
+            G.conn_direct = it->second.conn;
+            G.gdet_conn_direct = it->second.gdet_conn;
+            G.embed_direct = it->second.embed;
+            G.geom_slot = it->second.slot;
+            return;
+        }
+    }
+
+    //cerr << "Creating GRCoordinate cache size " << n1 << " " << n2 << std::endl;
+    // Cache geometry.  May be faster than re-computing. May not be.
+    assign_geom_slot(G);
+
+    // Member variables have an implicit this->
+    // C++ Lambdas (and therefore Kokkos Lambdas) capture pointers to objects, not full objects
+    // Hence, you *CANNOT* use this->, or members, from inside kernels
+    auto gdet_local = G.gdet_direct;
+    auto gdet_conn_local = G.gdet_conn_direct;
+    const int slot = G.geom_slot;
+
+    // Evaluate the metric through a compile-time embedding if possible
+    with_fixed_embedding(G.coords, [&G](const auto& coords) { init_geom_cache(G, coords); });
+
     if (correct_connections) {
         Kokkos::parallel_for("geom_corrections", MDRangePolicy<Rank<2>>({0,0}, {n2, n1}),
             KOKKOS_LAMBDA (const int& j, const int& i) {
@@ -219,16 +416,16 @@ void init_GRCoordinates(GRCoordinates& G) {
                         GReal Xfm[GR_DIM], Xfp[GR_DIM];
                         G.coord(0, j, i, loc, Xfm);
                         G.coord(0, j + (lam == X2DIR), i + (lam == X1DIR), loc, Xfp);
-                        double gdetfm = gdet_local(loc, j, i);
-                        double gdetfp = gdet_local(loc, j + (lam == X2DIR), i + (lam == X1DIR));
+                        double gdetfm = gdet_local(slot*NLOC + (int) loc, j, i);
+                        double gdetfp = gdet_local(slot*NLOC + (int) loc, j + (lam == X2DIR), i + (lam == X1DIR));
                         GReal target = (gdetfp - gdetfm) / (Xfp[lam] - Xfm[lam] + SMALL);
 
                         // Then sum the coefficients and record nonzero ones for modification
                         GReal test_sum = 0;
                         GReal sum_portions, portions[GR_DIM] = {0};
                         DLOOP1 {
-                            test_sum += gdet_conn_local(j, i, mu, mu, lam);
-                            portions[mu] = m::abs(gdet_conn_local(j, i, mu, mu, lam));
+                            test_sum += geom3_at(gdet_conn_local, slot, j, i, mu, mu, lam);
+                            portions[mu] = m::abs(geom3_at(gdet_conn_local, slot, j, i, mu, mu, lam));
                             sum_portions += portions[mu];
                         }
                         DLOOP1 portions[mu] /= sum_portions;
@@ -236,14 +433,19 @@ void init_GRCoordinates(GRCoordinates& G) {
 
                         // Add the difference among components equally
                         const GReal diff = test_sum - target;
-                        DLOOP1 gdet_conn_local(j, i, mu, mu, lam) = gdet_conn_local(j, i, mu, mu, lam) - diff*portions[mu];
+                        DLOOP1 geom3_at(gdet_conn_local, slot, j, i, mu, mu, lam) = geom3_at(gdet_conn_local, slot, j, i, mu, mu, lam) - diff*portions[mu];
 
                         // This is separated and set equal, as there will be one self-assignment
-                        DLOOP1 gdet_conn_local(j, i, mu, lam, mu) = gdet_conn_local(j, i, mu, mu, lam);
+                        DLOOP1 geom3_at(gdet_conn_local, slot, j, i, mu, lam, mu) = geom3_at(gdet_conn_local, slot, j, i, mu, mu, lam);
                     }
                 }
             }
         );
     }
+
+    if (G.share_cache)
+        geom_cache()[key] = GeomCacheEntry{G.gcon_direct, G.gcov_direct, G.gcon_single, G.gcov_single,
+                                           G.gdet_direct, G.conn_direct, G.gdet_conn_direct,
+                                           G.embed_direct, G.geom_slot};
 }
 #endif // FAST_CARTESIAN
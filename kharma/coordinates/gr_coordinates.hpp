@@ -54,6 +54,95 @@
 #define FAST_CARTESIAN 0
 // Don't cache values of the metric, etc, just call into CoordinateEmbedding directly
 #define NO_CACHE 0
+// Store only the independent elements of the cached symmetric tensors:
+// 10 of 16 for gcon/gcov, and 40 of 64 for conn/gdet_conn, which are
+// symmetric in their lower two indices.  Cuts the cache about 40%.
+#define PACKED_GEOM_CACHE 0
+
+// Number of independent elements of a symmetric GR_DIM x GR_DIM tensor
+#define GR_SYM 10
+
+/**
+ * Index of element (mu, nu) of a symmetric tensor in packed storage,
+ * upper triangle stored row by row: 00,01,02,03,11,12,13,22,23,33
+ */
+KOKKOS_FORCEINLINE_FUNCTION int sym_index(const int mu, const int nu)
+{
+    const int a = (mu < nu) ? mu : nu;
+    const int b = (mu < nu) ? nu : mu;
+    return a*GR_DIM - a*(a-1)/2 + b - a;
+}
+
+/**
+ * Element references into the geometry caches, independent of their layout.
+ * Caches are slots in pools shared by several blocks: arrays over locations are indexed
+ * by lslot = slot*NLOC + loc, and the connections by the slot itself.
+ * With PACKED_GEOM_CACHE, (mu, nu) and (nu, mu) refer to the same element,
+ * so writers should only loop over one of them (see geom_stored).
+ * geom2_at takes the float metric caches too, see GRCoordinates::single_metric
+ */
+template<typename Array>
+KOKKOS_FORCEINLINE_FUNCTION auto& geom2_at(const Array& A, const int& lslot, const int& j, const int& i,
+                                           const int mu, const int nu)
+{
+#if PACKED_GEOM_CACHE
+    return A(lslot, j, i, sym_index(mu, nu));
+#else
+    return A(lslot, j, i, mu, nu);
+#endif
+}
+KOKKOS_FORCEINLINE_FUNCTION GReal& geom3_at(const GeomTensor3& A, const int& slot, const int& j, const int& i,
+                                           const int mu, const int nu, const int lam)
+{
+#if PACKED_GEOM_CACHE
+    return A(slot, j, i, mu, sym_index(nu, lam));
+#else
+    return A(slot, j, i, mu, nu, lam);
+#endif
+}
+// Whether the element (mu, nu) of a symmetric pair has its own storage
+KOKKOS_FORCEINLINE_FUNCTION bool geom_stored(const int mu, const int nu)
+{ return !PACKED_GEOM_CACHE || mu <= nu; }
+
+/**
+ * Local copy of the geometry at a single point (usually a face), loaded once
+ * per point with GRCoordinates::face_geom.
+ * Flux kernels touch the metric at the same face many times (two calc_4vecs,
+ * four prim_to_flux, two vchar); this keeps those reads in registers.
+ * Provides the same accessors as GRCoordinates, ignoring the location arguments,
+ * so it can stand in for G in the templated "Local" GRMHD/Flux device functions.
+ */
+struct FaceGeom
+{
+    GReal gcon_l[GR_DIM][GR_DIM];
+    GReal gcov_l[GR_DIM][GR_DIM];
+    GReal gdet_l;
+    // Lapse, 1/sqrt(-g^00)
+    GReal alpha;
+
+    KOKKOS_FORCEINLINE_FUNCTION GReal gcon(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
+    { return gcon_l[mu][nu]; }
+    KOKKOS_FORCEINLINE_FUNCTION GReal gcov(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
+    { return gcov_l[mu][nu]; }
+    KOKKOS_FORCEINLINE_FUNCTION GReal gdet(const Loci loc, const int& j, const int& i) const
+    { return gdet_l; }
+    // Shift vector beta^i = alpha^2 g^0i
+    KOKKOS_FORCEINLINE_FUNCTION GReal beta(const int& v) const
+    { return gcon_l[0][v+1] * alpha * alpha; }
+
+    KOKKOS_FORCEINLINE_FUNCTION void lower(const Real vcon[GR_DIM], Real vcov[GR_DIM],
+                                           const int& k, const int& j, const int& i, const Loci loc) const
+    {
+        gzero(vcov);
+        DLOOP2 vcov[mu] += gcov_l[mu][nu] * vcon[nu];
+    }
+    KOKKOS_FORCEINLINE_FUNCTION void raise(const Real vcov[GR_DIM], Real vcon[GR_DIM],
+                                           const int& k, const int& j, const int& i, const Loci loc) const
+    {
+        gzero(vcon);
+        DLOOP2 vcon[mu] += gcon_l[mu][nu] * vcov[nu];
+    }
+};
 
 /**
  * Replacement/extension coordinate class for Parthenon
@@ -82,12 +171,40 @@ public:
     // metric determinant derivatives discretized at faces
     bool correct_connections = false;
 
+    // Whether to share geometry caches with any other block having the same
+    // x1/x2 extents and size.  The caches depend only on (j,i), so e.g. all
+    // blocks in a ring in x3 can use one copy
+    bool share_cache = true;
+
+    // Whether to compute gcon/gcov from the CoordinateEmbedding on every access,
+    // rather than loading them from cache.  gdet and the connections are still cached.
+    // Trades 32 loads per zone for a metric evaluation & inversion, which can win on GPUs
+    bool compute_metric = false;
+
+    // Whether to cache the embedding coordinates X1,X2 (e.g. r,th) at each (loc,j,i),
+    // making coord_embed and r()/th()/etc. array loads.  Only used for spherical systems.
+    // Relies on all transforms leaving X3 (phi) alone and not mixing it into X1,X2
+    bool cache_embed = false;
+
+    // Whether to store gcon/gcov in single precision (coordinates/geometry_precision = single),
+    // halving the bandwidth of metric loads.  gdet & the connections are kept in double:
+    // they multiply into the conserved variables and source terms, where the rounding would
+    // show up directly as truncation of e.g. the pole balance in correct_connections
+    bool single_metric = false;
+
     // Caches for geometry values at zone centers/faces/etc
 #if !FAST_CARTESIAN && !NO_CACHE
     GeomTensor2 gcon_direct, gcov_direct;
+    GeomTensor2F gcon_single, gcov_single;
     GeomScalar gdet_direct;
     GeomTensor3 conn_direct, gdet_conn_direct;
+    GeomTensor2 embed_direct;
+    // This block's slot in the above
+    int geom_slot = 0;
+    KOKKOS_FORCEINLINE_FUNCTION int lslot(const Loci loc) const { return geom_slot*NLOC + (int) loc; }
 #endif
+    // Number of blocks' caches to allocate at once, host-side only
+    int geom_pool_size = 1;
 
     // "Full" constructors which generate new geometry caches
     // these call Kokkos internally so we must ensure they're only called host-side
@@ -102,15 +219,21 @@ public:
     KOKKOS_FUNCTION GRCoordinates(const GRCoordinates &src): UniformCartesian(src),
         n1(src.n1), n2(src.n2), n3(src.n3), coords(src.coords),
         connection_average_points(src.connection_average_points),
-        correct_connections(src.correct_connections)
+        correct_connections(src.correct_connections), share_cache(src.share_cache),
+        compute_metric(src.compute_metric), cache_embed(src.cache_embed),
+        single_metric(src.single_metric), geom_pool_size(src.geom_pool_size)
     {
         //std::cerr << "Calling copy constructor size " << src.n1 << " " << src.n2 << std::endl;
 #if !FAST_CARTESIAN && !NO_CACHE
         gcon_direct = src.gcon_direct;
         gcov_direct = src.gcov_direct;
+        gcon_single = src.gcon_single;
+        gcov_single = src.gcov_single;
         gdet_direct = src.gdet_direct;
         conn_direct = src.conn_direct;
         gdet_conn_direct = src.gdet_conn_direct;
+        embed_direct = src.embed_direct;
+        geom_slot = src.geom_slot;
 #endif
     };
 
@@ -125,12 +248,21 @@ public:
         n3 = src.n3;
         connection_average_points = src.connection_average_points;
         correct_connections = src.correct_connections;
+        share_cache = src.share_cache;
+        compute_metric = src.compute_metric;
+        cache_embed = src.cache_embed;
+        single_metric = src.single_metric;
+        geom_pool_size = src.geom_pool_size;
 #if !FAST_CARTESIAN && !NO_CACHE
         gcon_direct = src.gcon_direct;
         gcov_direct = src.gcov_direct;
+        gcon_single = src.gcon_single;
+        gcov_single = src.gcov_single;
         gdet_direct = src.gdet_direct;
         conn_direct = src.conn_direct;
         gdet_conn_direct = src.gdet_conn_direct;
+        embed_direct = src.embed_direct;
+        geom_slot = src.geom_slot;
 #endif
         return *this;
     };
@@ -148,22 +280,24 @@ public:
     }
 
     // TODO Test these vs going all-in on full-matrix versions and computing on the fly
-    KOKKOS_INLINE_FUNCTION Real gcon(const Loci loc, const int& j, const int& i, const int mu, const int nu) const;
-    KOKKOS_INLINE_FUNCTION Real gcov(const Loci loc, const int& j, const int& i, const int mu, const int nu) const;
-    KOKKOS_INLINE_FUNCTION Real gdet(const Loci loc, const int& j, const int& i) const;
-    KOKKOS_INLINE_FUNCTION Real conn(const int& j, const int& i, const int mu, const int nu, const int lam) const;
-    KOKKOS_INLINE_FUNCTION Real gdet_conn(const int& j, const int& i, const int mu, const int nu, const int lam) const;
+    KOKKOS_INLINE_FUNCTION GReal gcon(const Loci loc, const int& j, const int& i, const int mu, const int nu) const;
+    KOKKOS_INLINE_FUNCTION GReal gcov(const Loci loc, const int& j, const int& i, const int mu, const int nu) const;
+    KOKKOS_INLINE_FUNCTION GReal gdet(const Loci loc, const int& j, const int& i) const;
+    KOKKOS_INLINE_FUNCTION GReal conn(const int& j, const int& i, const int mu, const int nu, const int lam) const;
+    KOKKOS_INLINE_FUNCTION GReal gdet_conn(const int& j, const int& i, const int mu, const int nu, const int lam) const;
 
     KOKKOS_INLINE_FUNCTION void gcon(const Loci loc, const int& j, const int& i, Real gcon[GR_DIM][GR_DIM]) const;
     KOKKOS_INLINE_FUNCTION void gcov(const Loci loc, const int& j, const int& i, Real gcov[GR_DIM][GR_DIM]) const;
     KOKKOS_INLINE_FUNCTION void conn(const int& j, const int& i, Real conn[GR_DIM][GR_DIM][GR_DIM]) const;
     KOKKOS_INLINE_FUNCTION void gdet_conn(const int& j, const int& i, Real conn[GR_DIM][GR_DIM][GR_DIM]) const;
+    // Load everything flux kernels need at one point into a FaceGeom
+    KOKKOS_INLINE_FUNCTION void face_geom(const Loci loc, const int& j, const int& i, FaceGeom& fg) const;
 
     // Coordinates of the GRCoordinates, i.e. "native"
     KOKKOS_INLINE_FUNCTION void coord(const int& k, const int& j, const int& i, const Loci& loc, GReal X[GR_DIM]) const;
     // Coordinates of the embedding system, usually r,th,phi[KS] or x1,x2,x3[Cartesian]
     KOKKOS_INLINE_FUNCTION void coord_embed(const int& k, const int& j, const int& i, const Loci& loc, GReal Xembed[GR_DIM]) const;
-    // Coordinates in specific systems (slow!)
+    // Coordinates in specific systems (slow, unless cache_embed is set)
     KOKKOS_INLINE_FUNCTION GReal r(const int& k, const int& j, const int& i, const Loci& loc=Loci::center) const;
     KOKKOS_INLINE_FUNCTION GReal th(const int& k, const int& j, const int& i, const Loci& loc=Loci::center) const;
     KOKKOS_INLINE_FUNCTION GReal phi(const int& k, const int& j, const int& i, const Loci& loc=Loci::center) const;
@@ -181,7 +315,7 @@ public:
 /**
  * Function to return native coordinates on the GRCoordinates
  */
-KOKKOS_INLINE_FUNCTION void GRCoordinates::coord(const int& k, const int& j, const int& i, const Loci& loc, Real X[GR_DIM]) const
+KOKKOS_INLINE_FUNCTION void GRCoordinates::coord(const int& k, const int& j, const int& i, const Loci& loc, GReal X[GR_DIM]) const
 {
     X[0] = 0;
     switch(loc)
@@ -232,15 +366,15 @@ KOKKOS_INLINE_FUNCTION void GRCoordinates::raise(const Real vcov[GR_DIM], Real v
 // NO_CACHE: Re-calculate from coordinates object on every access
 // NORMAL: Cache each zone center and return cached value thereafter
 #if FAST_CARTESIAN
-KOKKOS_INLINE_FUNCTION Real GRCoordinates::gcon(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
+KOKKOS_INLINE_FUNCTION GReal GRCoordinates::gcon(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
 { return -2*(mu == 0 && nu == 0) + (mu == nu); }
-KOKKOS_INLINE_FUNCTION Real GRCoordinates::gcov(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
+KOKKOS_INLINE_FUNCTION GReal GRCoordinates::gcov(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
 { return -2*(mu == 0 && nu == 0) + (mu == nu); }
-KOKKOS_INLINE_FUNCTION Real GRCoordinates::gdet(const Loci loc, const int& j, const int& i) const
+KOKKOS_INLINE_FUNCTION GReal GRCoordinates::gdet(const Loci loc, const int& j, const int& i) const
 { return 1; }
-KOKKOS_INLINE_FUNCTION Real GRCoordinates::conn(const int& j, const int& i, const int mu, const int nu, const int lam) const
+KOKKOS_INLINE_FUNCTION GReal GRCoordinates::conn(const int& j, const int& i, const int mu, const int nu, const int lam) const
 { return 0; }
-KOKKOS_INLINE_FUNCTION Real GRCoordinates::gdet_conn(const int& j, const int& i, const int mu, const int nu, const int lam) const
+KOKKOS_INLINE_FUNCTION GReal GRCoordinates::gdet_conn(const int& j, const int& i, const int mu, const int nu, const int lam) const
 { return 0; }
 
 KOKKOS_INLINE_FUNCTION void GRCoordinates::gcon(const Loci loc, const int& j, const int& i, Real gcon[GR_DIM][GR_DIM]) const
@@ -254,27 +388,27 @@ KOKKOS_INLINE_FUNCTION void GRCoordinates::gdet_conn(const int& j, const int& i,
 #elif NO_CACHE
 // TODO these are currently VERY SLOW.  Rework them to generate just the desired component. (TODO gdet?...)
 // Except conn.  We never need conn fast.
-KOKKOS_INLINE_FUNCTION Real GRCoordinates::gcon(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
+KOKKOS_INLINE_FUNCTION GReal GRCoordinates::gcon(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
 {
     GReal X[GR_DIM], gcon[GR_DIM][GR_DIM];
     coord(0, j, i, loc, X);
     coords.gcon_native(X, gcon);
     return gcon[mu][nu];
 }
-KOKKOS_INLINE_FUNCTION Real GRCoordinates::gcov(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
+KOKKOS_INLINE_FUNCTION GReal GRCoordinates::gcov(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
 {
     GReal X[GR_DIM], gcov[GR_DIM][GR_DIM];
     coord(0, j, i, loc, X);
     coords.gcov_native(X, gcov);
     return gcov[mu][nu];
 }
-KOKKOS_INLINE_FUNCTION Real GRCoordinates::gdet(const Loci loc, const int& j, const int& i) const
+KOKKOS_INLINE_FUNCTION GReal GRCoordinates::gdet(const Loci loc, const int& j, const int& i) const
 {
     GReal X[GR_DIM], gcon[GR_DIM][GR_DIM];
     coord(0, j, i, loc, X);
     return coords.gcon_native(X, gcon);
 }
-KOKKOS_INLINE_FUNCTION Real GRCoordinates::conn(const int& j, const int& i, const int mu, const int nu, const int lam) const
+KOKKOS_INLINE_FUNCTION GReal GRCoordinates::conn(const int& j, const int& i, const int mu, const int nu, const int lam) const
 {
     GReal X[GR_DIM], conn[GR_DIM][GR_DIM][GR_DIM];
     coord(0, j, i, Loci::center, X);
@@ -284,44 +418,111 @@ KOKKOS_INLINE_FUNCTION Real GRCoordinates::conn(const int& j, const int& i, cons
 
 KOKKOS_INLINE_FUNCTION void GRCoordinates::gcon(const Loci loc, const int& j, const int& i, Real gcon[GR_DIM][GR_DIM]) const
 {
-    GReal X[GR_DIM];
+    GReal X[GR_DIM], gcon_g[GR_DIM][GR_DIM];
     coord(0, j, i, loc, X);
-    coords.gcon_native(X, gcon);
+    coords.gcon_native(X, gcon_g);
+    DLOOP2 gcon[mu][nu] = gcon_g[mu][nu];
 }
 KOKKOS_INLINE_FUNCTION void GRCoordinates::gcov(const Loci loc, const int& j, const int& i, Real gcov[GR_DIM][GR_DIM]) const
 {
-    GReal X[GR_DIM];
+    GReal X[GR_DIM], gcov_g[GR_DIM][GR_DIM];
     coord(0, j, i, loc, X);
-    coords.gcov_native(X, gcov);
+    coords.gcov_native(X, gcov_g);
+    DLOOP2 gcov[mu][nu] = gcov_g[mu][nu];
 }
 KOKKOS_INLINE_FUNCTION void GRCoordinates::conn(const int& j, const int& i, Real conn[GR_DIM][GR_DIM][GR_DIM]) const
 {
-    GReal X[GR_DIM];
+    GReal X[GR_DIM], conn_g[GR_DIM][GR_DIM][GR_DIM];
     coord(0, j, i, Loci::center, X);
-    coords.conn_native(X, conn);
+    coords.conn_native(X, conn_g);
+    DLOOP3 conn[mu][nu][lam] = conn_g[mu][nu][lam];
 }
 #else
-KOKKOS_INLINE_FUNCTION Real GRCoordinates::gcon(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
-{ return gcon_direct(loc, j, i, mu, nu); }
-KOKKOS_INLINE_FUNCTION Real GRCoordinates::gcov(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
-{ return gcov_direct(loc, j, i, mu, nu); }
-KOKKOS_INLINE_FUNCTION Real GRCoordinates::gdet(const Loci loc, const int& j, const int& i) const
-{ return gdet_direct(loc, j, i); }
-KOKKOS_INLINE_FUNCTION Real GRCoordinates::conn(const int& j, const int& i, const int mu, const int nu, const int lam) const
-{ return conn_direct(j, i, mu, nu, lam); }
-KOKKOS_INLINE_FUNCTION Real GRCoordinates::gdet_conn(const int& j, const int& i, const int mu, const int nu, const int lam) const
-{ return gdet_conn_direct(j, i, mu, nu, lam); }
+KOKKOS_INLINE_FUNCTION GReal GRCoordinates::gcon(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
+{
+    if (compute_metric) {
+        GReal X[GR_DIM], gcov[GR_DIM][GR_DIM], gcon[GR_DIM][GR_DIM];
+        coord(0, j, i, loc, X);
+        coords.gcov_native(X, gcov);
+        coords.gcon_native(gcov, gcon);
+        return gcon[mu][nu];
+    }
+    if (single_metric) return geom2_at(gcon_single, lslot(loc), j, i, mu, nu);
+    return geom2_at(gcon_direct, lslot(loc), j, i, mu, nu);
+}
+KOKKOS_INLINE_FUNCTION GReal GRCoordinates::gcov(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
+{
+    if (compute_metric) {
+        GReal X[GR_DIM], gcov[GR_DIM][GR_DIM];
+        coord(0, j, i, loc, X);
+        coords.gcov_native(X, gcov);
+        return gcov[mu][nu];
+    }
+    if (single_metric) return geom2_at(gcov_single, lslot(loc), j, i, mu, nu);
+    return geom2_at(gcov_direct, lslot(loc), j, i, mu, nu);
+}
+KOKKOS_INLINE_FUNCTION GReal GRCoordinates::gdet(const Loci loc, const int& j, const int& i) const
+{ return gdet_direct(lslot(loc), j, i); }
+KOKKOS_INLINE_FUNCTION GReal GRCoordinates::conn(const int& j, const int& i, const int mu, const int nu, const int lam) const
+{ return geom3_at(conn_direct, geom_slot, j, i, mu, nu, lam); }
+KOKKOS_INLINE_FUNCTION GReal GRCoordinates::gdet_conn(const int& j, const int& i, const int mu, const int nu, const int lam) const
+{ return geom3_at(gdet_conn_direct, geom_slot, j, i, mu, nu, lam); }
 
 KOKKOS_INLINE_FUNCTION void GRCoordinates::gcon(const Loci loc, const int& j, const int& i, Real gcon[GR_DIM][GR_DIM]) const
-{ DLOOP2 gcon[mu][nu] = gcon_direct(loc, j, i, mu, nu); }
+{
+    if (compute_metric) {
+        // Compute in geometry precision, see decs.hpp
+        GReal X[GR_DIM], gcov[GR_DIM][GR_DIM], gcon_g[GR_DIM][GR_DIM];
+        coord(0, j, i, loc, X);
+        coords.gcov_native(X, gcov);
+        coords.gcon_native(gcov, gcon_g);
+        DLOOP2 gcon[mu][nu] = gcon_g[mu][nu];
+    } else if (single_metric) {
+        DLOOP2 gcon[mu][nu] = geom2_at(gcon_single, lslot(loc), j, i, mu, nu);
+    } else {
+        DLOOP2 gcon[mu][nu] = geom2_at(gcon_direct, lslot(loc), j, i, mu, nu);
+    }
+}
 KOKKOS_INLINE_FUNCTION void GRCoordinates::gcov(const Loci loc, const int& j, const int& i, Real gcov[GR_DIM][GR_DIM]) const
-{ DLOOP2 gcov[mu][nu] = gcov_direct(loc, j, i, mu, nu); }
+{
+    if (compute_metric) {
+        GReal X[GR_DIM], gcov_g[GR_DIM][GR_DIM];
+        coord(0, j, i, loc, X);
+        coords.gcov_native(X, gcov_g);
+        DLOOP2 gcov[mu][nu] = gcov_g[mu][nu];
+    } else if (single_metric) {
+        DLOOP2 gcov[mu][nu] = geom2_at(gcov_single, lslot(loc), j, i, mu, nu);
+    } else {
+        DLOOP2 gcov[mu][nu] = geom2_at(gcov_direct, lslot(loc), j, i, mu, nu);
+    }
+}
 KOKKOS_INLINE_FUNCTION void GRCoordinates::conn(const int& j, const int& i, Real conn[GR_DIM][GR_DIM][GR_DIM]) const
-{ DLOOP3 conn[mu][nu][lam] = conn_direct(j, i, mu, nu, lam); }
+{ DLOOP3 conn[mu][nu][lam] = geom3_at(conn_direct, geom_slot, j, i, mu, nu, lam); }
 KOKKOS_INLINE_FUNCTION void GRCoordinates::gdet_conn(const int& j, const int& i, Real gdet_conn[GR_DIM][GR_DIM][GR_DIM]) const
-{ DLOOP3 gdet_conn[mu][nu][lam] = gdet_conn_direct(j, i, mu, nu, lam); }
+{ DLOOP3 gdet_conn[mu][nu][lam] = geom3_at(gdet_conn_direct, geom_slot, j, i, mu, nu, lam); }
+
+#endif
 
+KOKKOS_INLINE_FUNCTION void GRCoordinates::face_geom(const Loci loc, const int& j, const int& i, FaceGeom& fg) const
+{
+#if !FAST_CARTESIAN && !NO_CACHE
+    if (compute_metric) {
+        // One metric evaluation for both
+        GReal X[GR_DIM];
+        coord(0, j, i, loc, X);
+        coords.gcov_native(X, fg.gcov_l);
+        coords.gcon_native(fg.gcov_l, fg.gcon_l);
+    } else
 #endif
+    {
+        DLOOP2 {
+            fg.gcon_l[mu][nu] = gcon(loc, j, i, mu, nu);
+            fg.gcov_l[mu][nu] = gcov(loc, j, i, mu, nu);
+        }
+    }
+    fg.gdet_l = gdet(loc, j, i);
+    fg.alpha = 1. / m::sqrt(-fg.gcon_l[0][0]);
+}
 
 // Two implementations: Fast Cartesian can skip some things
 #if FAST_CARTESIAN
@@ -363,46 +564,78 @@ KOKKOS_INLINE_FUNCTION void GRCoordinates::coord_embed(const int& k, const int&
 {
     GReal Xnative[GR_DIM];
     coord(k, j, i, loc, Xnative);
+#if !NO_CACHE
+    if (cache_embed) {
+        Xembed[0] = Xnative[0];
+        Xembed[1] = embed_direct(lslot(loc), j, i, 0);
+        Xembed[2] = embed_direct(lslot(loc), j, i, 1);
+        Xembed[3] = Xnative[3];
+        return;
+    }
+#endif
     coords.coord_to_embed(Xnative, Xembed);
 }
 
-// These are basically just call-throughs with coord()
-// TODO should we cache, esp for e.g. floors?
+// These go through coord_embed, so they're cheap if the embedding coordinates are cached
 KOKKOS_INLINE_FUNCTION GReal GRCoordinates::r(const int& k, const int& j, const int& i, const Loci& loc) const
 {
-    GReal Xnative[GR_DIM];
-    coord(k, j, i, loc, Xnative);
-    return coords.r_of(Xnative);
+    GReal Xembed[GR_DIM];
+    coord_embed(k, j, i, loc, Xembed);
+    if (coords.is_spherical()) {
+        return Xembed[1];
+    } else {
+        return m::sqrt(SQR(Xembed[1]) + SQR(Xembed[2]) + SQR(Xembed[3]));
+    }
 }
 KOKKOS_INLINE_FUNCTION GReal GRCoordinates::th(const int& k, const int& j, const int& i, const Loci& loc) const
 {
-    GReal Xnative[GR_DIM];
-    coord(k, j, i, loc, Xnative);
-    return coords.th_of(Xnative);
+    GReal Xembed[GR_DIM];
+    coord_embed(k, j, i, loc, Xembed);
+    if (coords.is_spherical()) {
+        return Xembed[2];
+    } else {
+        return m::atan2(m::sqrt(SQR(Xembed[1]) + SQR(Xembed[2])), Xembed[3]);
+    }
 }
 KOKKOS_INLINE_FUNCTION GReal GRCoordinates::phi(const int& k, const int& j, const int& i, const Loci& loc) const
 {
-    GReal Xnative[GR_DIM];
-    coord(k, j, i, loc, Xnative);
-    return coords.phi_of(Xnative);
+    GReal Xembed[GR_DIM];
+    coord_embed(k, j, i, loc, Xembed);
+    if (coords.is_spherical()) {
+        return Xembed[3];
+    } else {
+        return m::atan2(Xembed[2], Xembed[1]);
+    }
 }
 KOKKOS_INLINE_FUNCTION GReal GRCoordinates::x(const int& k, const int& j, const int& i, const Loci& loc) const
 {
-    GReal Xnative[GR_DIM];
-    coord(k, j, i, loc, Xnative);
-    return coords.x_of(Xnative);
+    GReal Xembed[GR_DIM];
+    coord_embed(k, j, i, loc, Xembed);
+    if (!coords.is_spherical()) {
+        return Xembed[1];
+    } else {
+        return Xembed[1] * m::sin(Xembed[2]) * m::cos(Xembed[3]);
+    }
 }
 KOKKOS_INLINE_FUNCTION GReal GRCoordinates::y(const int& k, const int& j, const int& i, const Loci& loc) const
 {
-    GReal Xnative[GR_DIM];
-    coord(k, j, i, loc, Xnative);
-    return coords.y_of(Xnative);
+    GReal Xembed[GR_DIM];
+    coord_embed(k, j, i, loc, Xembed);
+    if (!coords.is_spherical()) {
+        return Xembed[2];
+    } else {
+        return Xembed[1] * m::sin(Xembed[2]) * m::sin(Xembed[3]);
+    }
 }
 KOKKOS_INLINE_FUNCTION GReal GRCoordinates::z(const int& k, const int& j, const int& i, const Loci& loc) const
 {
-    GReal Xnative[GR_DIM];
-    coord(k, j, i, loc, Xnative);
-    return coords.z_of(Xnative);
+    GReal Xembed[GR_DIM];
+    coord_embed(k, j, i, loc, Xembed);
+    if (!coords.is_spherical()) {
+        return Xembed[3];
+    } else {
+        return Xembed[1] * m::cos(Xembed[2]);
+    }
 }
 
 #endif
@@ -48,19 +48,20 @@
 /**
  * Dot, avoid for loops. NOT GR AWARE
  */
-KOKKOS_INLINE_FUNCTION Real dot(const Real v1[GR_DIM], const Real v2[GR_DIM])
+template<typename T>
+KOKKOS_INLINE_FUNCTION T dot(const T v1[GR_DIM], const T v2[GR_DIM])
 {
     return v1[0]*v2[0] + v1[1]*v2[1] + v1[2]*v2[2] + v1[3]*v2[3];
 }
 
-KOKKOS_INLINE_FUNCTION Real MINOR(const Real m[16], int r0, int r1, int r2, int c0, int c1, int c2)
+KOKKOS_INLINE_FUNCTION GReal MINOR(const GReal m[16], int r0, int r1, int r2, int c0, int c1, int c2)
 {
   return m[4*r0+c0]*(m[4*r1+c1]*m[4*r2+c2] - m[4*r2+c1]*m[4*r1+c2]) -
          m[4*r0+c1]*(m[4*r1+c0]*m[4*r2+c2] - m[4*r2+c0]*m[4*r1+c2]) +
          m[4*r0+c2]*(m[4*r1+c0]*m[4*r2+c1] - m[4*r2+c0]*m[4*r1+c1]);
 }
 
-KOKKOS_INLINE_FUNCTION void adjoint(const Real m[16], Real adjOut[16])
+KOKKOS_INLINE_FUNCTION void adjoint(const GReal m[16], GReal adjOut[16])
 {
   adjOut[ 0] =  MINOR(m,1,2,3,1,2,3);
   adjOut[ 1] = -MINOR(m,0,2,3,1,2,3);
@@ -83,7 +84,7 @@ KOKKOS_INLINE_FUNCTION void adjoint(const Real m[16], Real adjOut[16])
   adjOut[15] =  MINOR(m,0,1,2,0,1,2);
 }
 
-KOKKOS_INLINE_FUNCTION Real determinant(const Real m[16])
+KOKKOS_INLINE_FUNCTION GReal determinant(const GReal m[16])
 {
   return m[0]*MINOR(m,1,2,3,1,2,3) -
          m[1]*MINOR(m,1,2,3,0,2,3) +
@@ -94,12 +95,12 @@ KOKKOS_INLINE_FUNCTION Real determinant(const Real m[16])
 /**
  * Matrix inversion. Call with pointers, i.e. &matrix_name[0][0]
  */
-KOKKOS_INLINE_FUNCTION Real invert(const Real *m, Real *invOut)
+KOKKOS_INLINE_FUNCTION GReal invert(const GReal *m, GReal *invOut)
 {
   adjoint(m, invOut);
 
-  Real det = determinant(m);
-  Real inv_det = 1. / det;
+  GReal det = determinant(m);
+  GReal inv_det = 1. / det;
   for (int i = 0; i < 16; ++i) {
     invOut[i] *= inv_det;
   }
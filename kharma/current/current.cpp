@@ -44,95 +44,158 @@ std::shared_ptr<KHARMAPackage> Current::Initialize(ParameterInput *pin, std::sha
     auto m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy}, s_fourvector);
     pkg->AddField("jcon", m);
 
-    // Temporaries
-    std::vector<int> s_vector({NVEC});
-    m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy}, s_vector);
-    pkg->AddField("Current.uvec_c", m);
-    pkg->AddField("Current.B_P_c", m);
+    // Options
+    // Preserve the state for jcon only on steps which end in an output of it,
+    // rather than every step
+    bool output_cadence = pin->GetOrAddBoolean("current", "output_cadence", true);
+    params.Add("output_cadence", output_cadence);
+    // Whether the state at the start of this step is preserved, set in PreStepWork
+    params.Add("preserve_this_step", true, true);
+
+    // Times (or cycles) of any outputs which include jcon, to predict when we'll need it
+    std::vector<Real> out_dt;
+    std::vector<int> out_dn;
+    InputBlock *pib = pin->pfirst_block;
+    while (pib != nullptr) {
+        if (pib->block_name.find("parthenon/output") != std::string::npos &&
+            pin->DoesParameterExist(pib->block_name, "variables") &&
+            pin->GetString(pib->block_name, "variables").find("jcon") != std::string::npos) {
+            out_dt.push_back(pin->GetOrAddReal(pib->block_name, "dt", -1.));
+            out_dn.push_back(pin->GetOrAddInteger(pib->block_name, "dn", -1));
+        }
+        pib = pib->pnext;
+    }
+    params.Add("out_dt", out_dt);
+    params.Add("out_dn", out_dn);
+    params.Add("start_time", pin->GetOrAddReal("parthenon/time", "start_time", 0.));
+    params.Add("tlim", pin->GetOrAddReal("parthenon/time", "tlim", -1.));
+
+    pkg->PreStepWork = Current::PreStepWork;
 
     pkg->BlockUserWorkBeforeOutput = Current::FillOutput;
 
     return pkg;
 }
 
-TaskStatus Current::CalculateCurrent(MeshBlockData<Real> *rc0, MeshBlockData<Real> *rc1, const double& dt)
+TaskStatus Current::CalculateCurrent(MeshData<Real> *md0, MeshData<Real> *md1, const double& dt)
 {
-    auto pmb = rc0->GetBlockPointer();
-    GridVector uvec_old = rc0->Get("prims.uvec").data;
-    GridVector B_P_old = rc0->Get("prims.B").data;
-    GridVector uvec_new = rc1->Get("prims.uvec").data;
-    GridVector B_P_new = rc1->Get("prims.B").data;
-    GridVector jcon = rc1->Get("jcon").data;
-
-    GridVector uvec_c = rc1->Get("Current.uvec_c").data;
-    GridVector B_P_c = rc1->Get("Current.B_P_c").data;
-
-    const auto& G = pmb->coords;
-    const int ndim = pmb->pmy_mesh->ndim;
-
-    // Calculate time-centered primitives
-    // We could pack, but we just need the vectors, U1,2,3 and B1,2,3
-    // Apply over the whole grid, as calculating j requires neighbors
-    const IndexRange ib = pmb->cellbounds.GetBoundsI(IndexDomain::entire);
-    const IndexRange jb = pmb->cellbounds.GetBoundsJ(IndexDomain::entire);
-    const IndexRange kb = pmb->cellbounds.GetBoundsK(IndexDomain::entire);
-    const IndexRange nv = IndexRange{0, NVEC-1};
-    pmb->par_for("get_center", nv.s, nv.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-        KOKKOS_LAMBDA (const int &p, const int &k, const int &j, const int &i) {
-            uvec_c(p, k, j, i) = 0.5*(uvec_old(p, k, j, i) + uvec_new(p, k, j, i));
-            B_P_c(p, k, j, i) = 0.5*(B_P_old(p, k, j, i) + B_P_new(p, k, j, i));
-        }
-    );
-
-    // Calculate j^{\mu} using centered differences for active zones
-    const IndexRange ib_i = pmb->cellbounds.GetBoundsI(IndexDomain::interior);
-    const IndexRange jb_i = pmb->cellbounds.GetBoundsJ(IndexDomain::interior);
-    const IndexRange kb_i = pmb->cellbounds.GetBoundsK(IndexDomain::interior);
-    const IndexRange n4v = IndexRange{0, GR_DIM-1};
-    pmb->par_for("jcon_calc", n4v.s, n4v.e, kb_i.s, kb_i.e, jb_i.s, jb_i.e, ib_i.s, ib_i.e,
-        KOKKOS_LAMBDA (const int &mu, const int &k, const int &j, const int &i) {
-            // Get sqrt{-g}*F^{mu nu} at neighboring points
-            // TODO(BSP) this recalculates Fcon a lot...
-            const Real gF0p = get_gdet_Fcon(G, uvec_new, B_P_new, 0, mu, k, j, i);
-            const Real gF0m = get_gdet_Fcon(G, uvec_old, B_P_old, 0, mu, k, j, i);
-            const Real gF1p = get_gdet_Fcon(G, uvec_c, B_P_c, 1, mu, k, j, i+1);
-            const Real gF1m = get_gdet_Fcon(G, uvec_c, B_P_c, 1, mu, k, j, i-1);
-            const Real gF2p = (ndim > 1) ? get_gdet_Fcon(G, uvec_c, B_P_c, 2, mu, k, j+1, i) : 0.;
-            const Real gF2m = (ndim > 1) ? get_gdet_Fcon(G, uvec_c, B_P_c, 2, mu, k, j-1, i) : 0.;
-            const Real gF3p = (ndim > 2) ? get_gdet_Fcon(G, uvec_c, B_P_c, 3, mu, k+1, j, i) : 0.;
-            const Real gF3m = (ndim > 2) ? get_gdet_Fcon(G, uvec_c, B_P_c, 3, mu, k-1, j, i) : 0.;
+    auto pmb0 = md1->GetBlockData(0)->GetBlockPointer();
+    const std::vector<std::string> vars({"prims.uvec", "prims.B"});
+    PackIndexMap old_map, new_map;
+    const auto& P_old = md0->PackVariables(vars, old_map);
+    const auto& P_new = md1->PackVariables(vars, new_map);
+    const int m_u_old = old_map["prims.uvec"].first, m_B_old = old_map["prims.B"].first;
+    const int m_u_new = new_map["prims.uvec"].first, m_B_new = new_map["prims.B"].first;
+    const auto& jcon = md1->PackVariables(std::vector<std::string>{"jcon"});
+
+    const int ndim = pmb0->pmy_mesh->ndim;
+
+    // Calculate j^{\mu} using centered differences for active zones, in one pass over all blocks.
+    // Time-centered primitives are averaged on the fly at each point of the stencil,
+    // and each point's 4-vectors are shared by all four components of jcon
+    const IndexRange ib = md1->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md1->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md1->GetBoundsK(IndexDomain::interior);
+    const IndexRange block = IndexRange{0, jcon.GetDim(5) - 1};
+    pmb0->par_for("jcon_calc", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int &b, const int &k, const int &j, const int &i) {
+            const auto& G = jcon.GetCoords(b);
+            // Primitives at the end, start, or center of the step, at a neighbor of this zone
+            auto get_prims = [&](const Real w_new, const int &kk, const int &jj, const int &ii,
+                                 Real uvec[NVEC], Real B_P[NVEC]) {
+                VLOOP {
+                    uvec[v] = w_new * P_new(b, m_u_new + v, kk, jj, ii) + (1. - w_new) * P_old(b, m_u_old + v, kk, jj, ii);
+                    B_P[v] = w_new * P_new(b, m_B_new + v, kk, jj, ii) + (1. - w_new) * P_old(b, m_B_old + v, kk, jj, ii);
+                }
+            };
+
+            // Sum of differences of sqrt{-g}*F^{mu nu}, for each mu
+            Real dF[GR_DIM] = {0};
+            Real uvec[NVEC], B_P[NVEC], gFp[GR_DIM], gFm[GR_DIM];
+            // Time
+            get_prims(1., k, j, i, uvec, B_P);
+            get_gdet_Fcon(G, uvec, B_P, 0, k, j, i, gFp);
+            get_prims(0., k, j, i, uvec, B_P);
+            get_gdet_Fcon(G, uvec, B_P, 0, k, j, i, gFm);
+            DLOOP1 dF[mu] += (gFp[mu] - gFm[mu]) / dt;
+            // Space
+            for (int dir = 1; dir <= ndim; dir++) {
+                const int di = (dir == 1), dj = (dir == 2), dk = (dir == 3);
+                get_prims(0.5, k+dk, j+dj, i+di, uvec, B_P);
+                get_gdet_Fcon(G, uvec, B_P, dir, k+dk, j+dj, i+di, gFp);
+                get_prims(0.5, k-dk, j-dj, i-di, uvec, B_P);
+                get_gdet_Fcon(G, uvec, B_P, dir, k-dk, j-dj, i-di, gFm);
+                const Real dx = (dir == 1) ? G.Dxc<1>(i) : ((dir == 2) ? G.Dxc<2>(j) : G.Dxc<3>(k));
+                DLOOP1 dF[mu] += (gFp[mu] - gFm[mu]) / (2 * dx);
+            }
 
             // Difference: D_mu F^{mu nu} = 4 \pi j^nu
-            jcon(mu, k, j, i) = 1. / (m::sqrt(4. * M_PI) * G.gdet(Loci::center, j, i)) *
-                                ((gF0p - gF0m) / dt +
-                                (gF1p - gF1m) / (2 * G.Dxc<1>(i)) +
-                                (gF2p - gF2m) / (2 * G.Dxc<2>(j)) +
-                                (gF3p - gF3m) / (2 * G.Dxc<3>(k)));
+            DLOOP1 jcon(b, mu, k, j, i) = dF[mu] / (m::sqrt(4. * M_PI) * G.gdet(Loci::center, j, i));
         }
     );
 
     return TaskStatus::complete;
 }
 
+void Current::PreStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+    auto& params = pmesh->packages.Get("Current")->AllParams();
+    if (!params.Get<bool>("output_cadence")) return;
+
+    // Will this step end with an output of jcon?
+    // Parthenon writes outputs when the time passes each multiple of dt from the start, or at the end
+    const Real t_end = tm.time + tm.dt;
+    const Real t0 = params.Get<Real>("start_time");
+    const Real tlim = params.Get<Real>("tlim");
+    const auto& out_dt = params.Get<std::vector<Real>>("out_dt");
+    const auto& out_dn = params.Get<std::vector<int>>("out_dn");
+    bool preserve = (tlim > 0. && t_end >= tlim);
+    for (int o = 0; o < out_dt.size(); o++) {
+        if (out_dt[o] > 0.) {
+            const Real next = t0 + (m::floor((tm.time - t0) / out_dt[o] + 1.e-10) + 1) * out_dt[o];
+            preserve = preserve || (t_end >= next * (1. - 1.e-10));
+        }
+        if (out_dn[o] > 0) {
+            preserve = preserve || ((tm.ncycle + 1) % out_dn[o] == 0);
+        }
+    }
+    params.Update<bool>("preserve_this_step", preserve);
+}
+
+// Blocks filled since jcon was last calculated.  The first block's call computes
+// jcon over the whole mesh, the rest just count.
+static int jcon_nblocks_done = 0;
+
 void Current::FillOutput(MeshBlock *pmb, ParameterInput *pin)
 {
+    auto pmesh = pmb->pmy_mesh;
+    const int nblocks = pmesh->block_list.size();
+    if (jcon_nblocks_done++ > 0) {
+        if (jcon_nblocks_done >= nblocks) jcon_nblocks_done = 0;
+        return;
+    }
+    if (nblocks == 1) jcon_nblocks_done = 0;
+
     // The "preserve" container will only exist after we've taken a step,
     // catch that situation
-    auto& rc1 = pmb->meshblock_data.Get();
-    auto rc0 = rc1; // Avoid writing rc0's type when initializing. Still light.
+    auto& md1 = pmesh->mesh_data.Get();
+    auto md0 = md1; // Avoid writing md0's type when initializing. Still light.
     try {
         // Get the state at beginning of the step
-        rc0 = pmb->meshblock_data.Get("preserve");
+        md0 = pmesh->mesh_data.Get("preserve");
     } catch (const std::runtime_error& e) {
         // We expect this to happen the first step
         // We just don't need to fill jcon the first time around
-        //std::cerr << "This should only happen once: " << e.what() << std::endl;
         return;
     }
 
+    // Any output not predicted by PreStepWork (e.g. on a signal) has no valid
+    // start-of-step state, so it gets jcon from the last output
+    if (!pmb->packages.Get("Current")->Param<bool>("preserve_this_step")) return;
+
     // Get the duration of the last timestep from the "Globals" package
     // (see kharma.cpp)
     Real dt_last = pmb->packages.Get("Globals")->Param<Real>("dt_last");
 
-    Current::CalculateCurrent(rc0.get(), rc1.get(), dt_last);
+    Current::CalculateCurrent(md0.get(), md1.get(), dt_last);
 }
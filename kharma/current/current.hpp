@@ -47,36 +47,43 @@ namespace Current
 std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages);
 
 /**
- * Fill outputs, namely jcon.  Just calls CalculateCurrent below.
+ * Fill outputs, namely jcon.  Just calls CalculateCurrent below, over the whole mesh
+ * on the first block's call before each output.
  */
 void FillOutput(MeshBlock *pmb, ParameterInput *pin);
 
 /**
- * Calculate the 4-current j^nu (jcon), given the MeshBlockData at the beginning and end of a step,
- * and the time between them.
+ * Predict whether the coming step ends with an output including jcon, and thus whether the driver
+ * needs to preserve the state at its start.  Always true unless current/output_cadence is set.
  */
-TaskStatus CalculateCurrent(MeshBlockData<Real> *rc0, MeshBlockData<Real> *rc1, const double& dt);
+void PreStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
 
 /**
- * Return mu, nu component of contravarient Maxwell tensor at grid zone i, j, k, multiplied by the
- * root negative metric determinant sqrt(-g).
+ * Calculate the 4-current j^nu (jcon), given the MeshData at the beginning and end of a step,
+ * and the time between them.  Uses the time-centered primitives for spatial derivatives.
+ */
+TaskStatus CalculateCurrent(MeshData<Real> *md0, MeshData<Real> *md1, const double& dt);
+
+/**
+ * Return row mu of the contravarient Maxwell tensor at grid zone i, j, k, multiplied by the
+ * root negative metric determinant sqrt(-g), given the primitive velocity & field there.
  * Easier to calculate than the regular version as I needn't divide by gdet.
  */
-KOKKOS_INLINE_FUNCTION double get_gdet_Fcon(const GRCoordinates& G, GridVector uvec, GridVector B_P,
-                                        const int& mu, const int& nu, const int& k, const int& j, const int& i)
+KOKKOS_INLINE_FUNCTION void get_gdet_Fcon(const GRCoordinates& G, const Real uvec[NVEC], const Real B_P[NVEC],
+                                          const int& mu, const int& k, const int& j, const int& i,
+                                          Real Fcon[GR_DIM])
 {
-    if (mu == nu) return 0.;
-
     FourVectors Dtmp;
     GRMHD::calc_4vecs(G, uvec, B_P, k, j, i, Loci::center, Dtmp);
-    double Fcon = 0.;
-    for (int kap = 0; kap < GR_DIM; kap++) {
-        for (int lam = 0; lam < GR_DIM; lam++) {
-            Fcon -= antisym(mu, nu, kap, lam) * Dtmp.ucov[kap] * Dtmp.bcov[lam];
+    for (int nu = 0; nu < GR_DIM; nu++) {
+        Fcon[nu] = 0.;
+        if (mu == nu) continue;
+        for (int kap = 0; kap < GR_DIM; kap++) {
+            for (int lam = 0; lam < GR_DIM; lam++) {
+                Fcon[nu] -= antisym(mu, nu, kap, lam) * Dtmp.ucov[kap] * Dtmp.bcov[lam];
+            }
         }
     }
-
-    return Fcon;
 }
 
 } // namespace GRMHD
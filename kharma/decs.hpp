@@ -74,7 +74,10 @@ namespace m = std;
 // KHARMA DEFINITIONS
 
 // Parthenon stole our type names
-// Lots of work will need to be done for Real != double
+// Real is the precision of evolved state, fluxes and boundary buffers: float if KHARMA is built
+// with KHARMA_SINGLE_PRECISION (i.e. "./make.sh single"), otherwise double.
+// GReal is the precision of the geometry, the 1D_W inverter's internal arithmetic,
+// and the accumulators in global reductions, and is always double.
 using parthenon::Real;
 using GReal = double;
 
@@ -168,6 +171,8 @@ inline int MPIBarrier()
 using GridScalar = parthenon::ParArrayND<parthenon::Real>;
 using GridVector = parthenon::ParArrayND<parthenon::Real>;
 // Shape+2D ("Geom") versions for symmetric geometry
-using GeomScalar = parthenon::ParArrayND<parthenon::Real>;
-using GeomTensor2 = parthenon::ParArrayND<parthenon::Real>;
-using GeomTensor3 = parthenon::ParArrayND<parthenon::Real>;
+using GeomScalar = parthenon::ParArrayND<GReal>;
+using GeomTensor2 = parthenon::ParArrayND<GReal>;
+using GeomTensor3 = parthenon::ParArrayND<GReal>;
+// Reduced-precision storage for the metric, see coordinates/geometry_precision
+using GeomTensor2F = parthenon::ParArrayND<float>;
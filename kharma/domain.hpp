@@ -160,6 +160,33 @@ inline IndexRange3 GetPhysicalRange(MeshBlockData<T>* rc)
                                     : (uint) bounds.ke(IndexDomain::entire)};
 }
 
+/**
+ * GetPhysicalRange of each block in a MeshData object, copied to the device for
+ * use by mesh-wide kernels: column b holds {ks, ke, js, je, is, ie} of block b.
+ * Check against it with inside(k, j, i, ranges, b)
+ */
+inline ParArray2D<int> GetPhysicalRanges(MeshData<Real>* md)
+{
+    const int nblocks = md->NumBlocks();
+    ParArray2D<int> ranges("physical_ranges", nblocks, 6);
+    auto ranges_h = Kokkos::create_mirror_view(Kokkos::HostSpace(), ranges);
+    for (int b=0; b < nblocks; ++b) {
+        const IndexRange3 bb = GetPhysicalRange(md->GetBlockData(b).get());
+        ranges_h(b, 0) = bb.ks; ranges_h(b, 1) = bb.ke;
+        ranges_h(b, 2) = bb.js; ranges_h(b, 3) = bb.je;
+        ranges_h(b, 4) = bb.is; ranges_h(b, 5) = bb.ie;
+    }
+    Kokkos::deep_copy(ranges, ranges_h);
+    return ranges;
+}
+KOKKOS_INLINE_FUNCTION bool inside(const int& k, const int& j, const int& i,
+                                   const ParArray2D<int>& ranges, const int& b)
+{
+    return k >= ranges(b, 0) && k <= ranges(b, 1) &&
+           j >= ranges(b, 2) && j <= ranges(b, 3) &&
+           i >= ranges(b, 4) && i <= ranges(b, 5);
+}
+
 template<typename T>
 inline IndexSize3 GetBlockSize(T data, IndexDomain domain=IndexDomain::entire)
 {
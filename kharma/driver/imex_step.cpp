@@ -41,10 +41,12 @@
 #include "b_ct.hpp"
 #include "b_flux_ct.hpp"
 #include "electrons.hpp"
+#include "emhd.hpp"
 #include "grmhd.hpp"
 #include "wind.hpp"
 // Other headers
 #include "boundaries.hpp"
+#include "float_halo.hpp"
 #include "flux.hpp"
 #include "kharma.hpp"
 #include "resize_restart.hpp"
@@ -70,7 +72,7 @@ TaskCollection KHARMADriver::MakeImExTaskCollection(BlockList_t &blocks, int sta
     const bool use_electrons = pkgs.count("Electrons");
     const bool use_implicit = pkgs.count("Implicit");
     const bool use_jcon = pkgs.count("Current");
-    const bool use_linesearch = (use_implicit) ? pkgs.at("Implicit")->Param<bool>("linesearch") : false;
+    const bool overlap_sync = (use_implicit) ? pkgs.at("Implicit")->Param<bool>("overlap_sync") : false;
 
     // Allocate/copy the things we need
     // TODO these can now be reduced by including the var lists/flags which actually need to be allocated
@@ -82,7 +84,8 @@ TaskCollection KHARMADriver::MakeImExTaskCollection(BlockList_t &blocks, int sta
         for (int i = 1; i < integrator->nstages; i++)
             pmesh->mesh_data.Add(integrator->stage_name[i]);
         // Preserve state for time derivatives if we need to output current
-        if (use_jcon) {
+        // Only on steps which end in an output of jcon, see Current::PreStepWork
+        if (use_jcon && pkgs.at("Current")->Param<bool>("preserve_this_step")) {
             pmesh->mesh_data.Add("preserve");
             // Above only copies on allocate -- ensure we copy every step
             Copy<MeshData<Real>>({Metadata::Cell}, base.get(), pmesh->mesh_data.Get("preserve").get());
@@ -91,10 +94,6 @@ TaskCollection KHARMADriver::MakeImExTaskCollection(BlockList_t &blocks, int sta
             // When solving, we need a temporary copy with any explicit updates,
             // but not overwriting the beginning- or mid-step values
             pmesh->mesh_data.Add("solver");
-            if (use_linesearch) {
-                // Need an additional state for linesearch
-                pmesh->mesh_data.Add("linesearch");
-            }
         }
     }
 
@@ -107,6 +106,8 @@ TaskCollection KHARMADriver::MakeImExTaskCollection(BlockList_t &blocks, int sta
         auto sync_flags = FC({Metadata::GetUserFlag("Primitive"), Metadata::Conserved,
                               Metadata::Face, Metadata::GetUserFlag("Boundaries")}, true);
         sync_vars = KHARMA::GetVariableNames(&(pmesh->packages), sync_flags);
+        if (pmesh->packages.AllPackages().count("FloatHalo"))
+            sync_vars.push_back("halo.packed");
     }
 
     // Flux region: calculate and apply fluxes to update conserved values
@@ -120,19 +121,23 @@ TaskCollection KHARMADriver::MakeImExTaskCollection(BlockList_t &blocks, int sta
         // '_sub_step_final' refers to the fluid state at the end of the sub step (Sf in iharm3d)
         // '_flux_src' refers to the mesh object corresponding to -divF + S
         // '_solver' refers to the fluid state passed to the Implicit solver. At the end of the solve
-        // '_linesearch' refers to the fluid state updated while performing a linesearch in the solver
         // copy P and U from solver state to sub_step_final state.
         auto &md_full_step_init = pmesh->mesh_data.GetOrAdd("base", i);
         auto &md_sub_step_init  = pmesh->mesh_data.GetOrAdd(integrator->stage_name[stage - 1], i);
         auto &md_sub_step_final = pmesh->mesh_data.GetOrAdd(integrator->stage_name[stage], i);
         auto &md_flux_src       = pmesh->mesh_data.GetOrAdd("dUdt", i);
         // Normally we put explicit update in md_solver, then add implicitly-evolved variables and copy back.
-        // If we're not doing an implicit solve at all, just write straight to sub_step_final
-        std::shared_ptr<MeshData<Real>> &md_solver = (use_implicit) ? pmesh->mesh_data.GetOrAdd("solver", i) : md_sub_step_final;
+        // If we're not doing an implicit solve at all, just write straight to sub_step_final.
+        // We can also solve directly into sub_step_final when the solver doesn't read it, i.e., when
+        // it is neither the full-step or sub-step initial state (intermediate stages)
+        const bool solve_in_place = !use_implicit || (integrator->stage_name[stage] != "base" &&
+                                                      integrator->stage_name[stage] != integrator->stage_name[stage - 1]);
+        std::shared_ptr<MeshData<Real>> &md_solver = (solve_in_place) ? md_sub_step_final : pmesh->mesh_data.GetOrAdd("solver", i);
         auto &md_sync = pmesh->mesh_data.AddShallow("sync"+integrator->stage_name[stage]+std::to_string(i), md_sub_step_final, sync_vars);
 
         // Start receiving flux corrections and ghost cells
-        auto t_start_recv_bound = tl.AddTask(t_none, parthenon::StartReceiveBoundBufs<parthenon::BoundaryType::any>, md_sub_step_final);
+        auto t_start_recv_bound = tl.AddTask(t_none, parthenon::StartReceiveBoundBufs<parthenon::BoundaryType::any>,
+                                              FloatHalo::ExchangeData(md_sub_step_final));
         auto t_start_recv_flux = t_start_recv_bound;
         if (pmesh->multilevel || use_b_ct)
             t_start_recv_flux = tl.AddTask(t_none, parthenon::StartReceiveFluxCorrections, md_sub_step_init);
@@ -160,12 +165,12 @@ TaskCollection KHARMADriver::MakeImExTaskCollection(BlockList_t &blocks, int sta
                 t_emf = KHARMADriver::AddBoundarySync(t_emf_local, tl, md_emf_only);
             }
             auto t_load_send_flux = tl.AddTask(t_emf, parthenon::LoadAndSendFluxCorrections, md_sub_step_init);
-            auto t_recv_flux = tl.AddTask(t_load_send_flux, parthenon::ReceiveFluxCorrections, md_sub_step_init);
+            auto t_recv_flux = tl.AddTask(t_load_send_flux, KHARMADriver::ReceiveFluxCorrectionsTimed, md_sub_step_init);
             t_flux_bounds = tl.AddTask(t_recv_flux, parthenon::SetFluxCorrections, md_sub_step_init);
         }
 
         // Apply the fluxes to calculate a change in cell-centered values "md_flux_src"
-        auto t_flux_div = tl.AddTask(t_flux_bounds, Update::FluxDivergence<MeshData<Real>>, md_sub_step_init.get(), md_flux_src.get());
+        auto t_flux_div = KHARMADriver::AddFluxDivergence(t_flux_bounds, tl, md_sub_step_init.get(), md_flux_src.get());
 
         // Add any source terms: geometric \Gamma * T, wind, damping, etc etc
         auto t_sources = tl.AddTask(t_flux_div, Packages::AddSource, md_sub_step_init.get(), md_flux_src.get());
@@ -177,32 +182,20 @@ TaskCollection KHARMADriver::MakeImExTaskCollection(BlockList_t &blocks, int sta
         // of the "guess" for the implicit solve
 
         // Update the explicitly-evolved variables using the source term
-        // Add any proportion of the step start required by the integrator (e.g., RK2)
-        auto t_avg_data_c = tl.AddTask(t_sources, Update::WeightedSumData<std::vector<MetadataFlag>, MeshData<Real>>,
+        // Add any proportion of the step start required by the integrator (e.g., RK2), in the same pass
+        auto t_update_c = tl.AddTask(t_sources, StageUpdate,
                                     std::vector<MetadataFlag>({Metadata::GetUserFlag("Explicit"), Metadata::Independent, Metadata::Cell}),
                                     md_sub_step_init.get(), md_full_step_init.get(),
                                     integrator->gam0[stage-1], integrator->gam1[stage-1],
-                                    md_solver.get());
-        auto t_avg_data = t_avg_data_c;
-        if (use_b_ct) {
-            t_avg_data = tl.AddTask(t_avg_data_c, WeightedSumDataFace,
-                                    std::vector<MetadataFlag>({Metadata::GetUserFlag("Explicit"), Metadata::Independent, Metadata::Face}),
-                                    md_sub_step_init.get(), md_full_step_init.get(),
-                                    integrator->gam0[stage-1], integrator->gam1[stage-1],
-                                    md_solver.get());
-        }
-        // apply du/dt to the result
-        auto t_update_c = tl.AddTask(t_sources, Update::WeightedSumData<std::vector<MetadataFlag>, MeshData<Real>>,
-                                    std::vector<MetadataFlag>({Metadata::GetUserFlag("Explicit"), Metadata::Independent, Metadata::Cell}),
-                                    md_solver.get(), md_flux_src.get(),
-                                    1.0, integrator->beta[stage-1] * integrator->dt,
+                                    md_flux_src.get(), integrator->beta[stage-1] * integrator->dt,
                                     md_solver.get());
         auto t_update = t_update_c;
         if (use_b_ct) {
-            t_update = tl.AddTask(t_update_c, WeightedSumDataFace,
+            t_update = tl.AddTask(t_update_c, StageUpdateFace,
                                   std::vector<MetadataFlag>({Metadata::GetUserFlag("Explicit"), Metadata::Independent, Metadata::Face}),
-                                  md_solver.get(), md_flux_src.get(),
-                                  1.0, integrator->beta[stage-1] * integrator->dt,
+                                  md_sub_step_init.get(), md_full_step_init.get(),
+                                  integrator->gam0[stage-1], integrator->gam1[stage-1],
+                                  md_flux_src.get(), integrator->beta[stage-1] * integrator->dt,
                                   md_solver.get());
         }
 
@@ -213,56 +206,82 @@ TaskCollection KHARMADriver::MakeImExTaskCollection(BlockList_t &blocks, int sta
                                       md_sub_step_init.get(), md_solver.get());
         }
 
+        // If only the EMHD scalars are implicit, the explicit fluid inversion must not see their
+        // contribution to the stress-energy.  Remove it using the sub-step starting state
+        auto t_explicit_ready = t_copy_prims | t_update;
+        if (pkgs.count("EMHD") && !pkgs.at("GRMHD")->Param<bool>("implicit")) {
+            auto t_stress = tl.AddTask(t_update, EMHD::SubtractStress, md_solver.get(), md_sub_step_init.get());
+            t_explicit_ready = t_copy_prims | t_stress;
+        }
+
         // Make sure the primitive values of *explicitly-evolved* variables are updated.
         // Packages with implicitly-evolved vars should only register BoundaryUtoP or BoundaryPtoU
-        auto t_explicit_UtoP = tl.AddTask(t_copy_prims | t_update, Packages::MeshUtoP, md_solver.get(), IndexDomain::entire, false);
+        auto t_explicit_UtoP = tl.AddTask(t_explicit_ready, Packages::MeshUtoP, md_solver.get(), IndexDomain::entire, false);
 
         // Done with explicit update
         auto t_explicit = t_explicit_UtoP;
 
         auto t_implicit = t_explicit;
         if (use_implicit) {
-            // Extra containers for implicit solve
-            std::shared_ptr<MeshData<Real>> &md_linesearch = (use_linesearch) ? pmesh->mesh_data.GetOrAdd("linesearch", i) : md_solver;
+            // The linesearch state lives entirely in scratch: Step needs only the package parameters
+            // attached to md_linesearch, so we pass the solver state rather than keeping a copy
+            std::shared_ptr<MeshData<Real>> &md_linesearch = md_solver;
 
-            // Copy the current state of any implicitly-evolved vars (at least the prims) in as a guess.
-            // This sets md_solver = md_sub_step_init
-            auto t_copy_guess = tl.AddTask(t_sources, Copy<MeshData<Real>>, std::vector<MetadataFlag>({Metadata::GetUserFlag("Implicit")}),
+            // Implicit::Step takes its guess for the implicit primitives from md_sub_step_init directly.
+            // Copy the conserved forms only, so md_solver agrees with md_sub_step_init for all implicit vars
+            auto t_copy_guess = tl.AddTask(t_sources, Copy<MeshData<Real>>, std::vector<MetadataFlag>({Metadata::GetUserFlag("Implicit"), Metadata::Conserved}),
                                         md_sub_step_init.get(), md_solver.get());
 
-            auto t_guess_ready = t_explicit | t_copy_guess;
-
-            // The `solver` MeshData object now has the implicit primitives corresponding to initial/half step and
+            // The `solver` MeshData object now has the implicit variables corresponding to initial/half step and
             // explicit variables have been updated to match the current step.
-            // Copy the primitives to the `linesearch` MeshData object if linesearch was enabled.
-            auto t_copy_linesearch = t_guess_ready;
-            if (use_linesearch) {
-                t_copy_linesearch = tl.AddTask(t_guess_ready, Copy<MeshData<Real>>, std::vector<MetadataFlag>({Metadata::GetUserFlag("Primitive")}),
-                                                md_solver.get(), md_linesearch.get());
-            }
+            auto t_guess_ready = t_explicit | t_copy_guess;
 
 
             // Time-step implicit variables by root-finding the residual.
             // This calculates the primitive values after the substep for all "isImplicit" variables --
             // no need for separately adding the flux divergence or calling UtoP
-            auto t_implicit_step = tl.AddTask(t_copy_linesearch, Implicit::Step, md_full_step_init.get(), md_sub_step_init.get(), 
-                                         md_flux_src.get(), md_linesearch.get(), md_solver.get(), integrator->beta[stage-1] * integrator->dt);
+            // With overlap_sync, solve only the zones we'll send to neighbors first
+            const auto first_region = (overlap_sync) ? Implicit::SolveRegion::shell : Implicit::SolveRegion::all;
+            auto t_implicit_step = tl.AddTask(t_guess_ready, Implicit::Step, md_full_step_init.get(), md_sub_step_init.get(), 
+                                         md_flux_src.get(), md_linesearch.get(), md_solver.get(), integrator->beta[stage-1] * integrator->dt,
+                                         first_region);
 
             // Copy the entire solver state (everything defined on the grid, incl. our new Face variables) into the final state md_sub_step_final
-            // If we're entirely explicit, we just declare these equal
-            auto t_implicit_c = tl.AddTask(t_implicit_step, Copy<MeshData<Real>>, std::vector<MetadataFlag>({Metadata::Cell}),
-                                    md_solver.get(), md_sub_step_final.get());
-            t_implicit = tl.AddTask(t_implicit_step, WeightedSumDataFace, std::vector<MetadataFlag>({Metadata::Face}),
-                                    md_solver.get(), md_solver.get(), 1.0, 0.0, md_sub_step_final.get());
+            // If we solved in place (or are entirely explicit), these are already the same
+            t_implicit = t_implicit_step;
+            if (!solve_in_place) {
+                auto t_implicit_c = tl.AddTask(t_implicit_step, Copy<MeshData<Real>>, std::vector<MetadataFlag>({Metadata::Cell}),
+                                        md_solver.get(), md_sub_step_final.get());
+                auto t_implicit_f = tl.AddTask(t_implicit_step, WeightedSumDataFace, std::vector<MetadataFlag>({Metadata::Face}),
+                                        md_solver.get(), md_solver.get(), 1.0, 0.0, md_sub_step_final.get());
+                t_implicit = t_implicit_c | t_implicit_f;
+            }
         }
 
-        // Apply all floors & limits (GRMHD,EMHD,etc), but do *not* immediately correct UtoP failures with FixUtoP --
-        // rather, we will synchronize (including pflags!) first.
-        // With an extra ghost zone, this *should* still allow binary-similar evolution between numbers of mesh blocks,
-        // but hasn't been tested to do so yet.
-        auto t_floors = tl.AddTask(t_implicit, Packages::MeshApplyFloors, md_sub_step_final.get(), IndexDomain::interior);
-
-        KHARMADriver::AddBoundarySync(t_floors, tl, md_sync);
+        if (overlap_sync) {
+            // Start syncing the solved shell zones right away, then solve the block cores while it's in flight.
+            // The core is at least nghost from any face, so it's disjoint from both what we send and receive.
+            // Floors are applied afterward over the ghost zones too: they're per-zone, so flooring the received
+            // values matches flooring them on the neighboring block before sending.
+            auto t_sync = KHARMADriver::AddBoundarySync(t_implicit, tl, md_sync);
+            auto t_core_step = tl.AddTask(t_implicit, Implicit::Step, md_full_step_init.get(), md_sub_step_init.get(),
+                                          md_flux_src.get(), md_solver.get(), md_solver.get(), integrator->beta[stage-1] * integrator->dt,
+                                          Implicit::SolveRegion::core);
+            auto t_core_copy = t_core_step;
+            if (!solve_in_place) {
+                t_core_copy = tl.AddTask(t_core_step, Implicit::CopyRegion, md_solver.get(), md_sub_step_final.get(),
+                                         Implicit::SolveRegion::core);
+            }
+            tl.AddTask(t_sync | t_core_copy, Packages::MeshApplyFloors, md_sub_step_final.get(), IndexDomain::entire);
+        } else {
+            // Apply all floors & limits (GRMHD,EMHD,etc), but do *not* immediately correct UtoP failures with FixUtoP --
+            // rather, we will synchronize (including pflags!) first.
+            // With an extra ghost zone, this *should* still allow binary-similar evolution between numbers of mesh blocks,
+            // but hasn't been tested to do so yet.
+            auto t_floors = tl.AddTask(t_implicit, Packages::MeshApplyFloors, md_sub_step_final.get(), IndexDomain::interior);
+
+            KHARMADriver::AddBoundarySync(t_floors, tl, md_sync);
+        }
     }
 
     // Fix Region: prims/cons sync, floors, fixes, boundary conditions which need primitives
@@ -289,7 +308,7 @@ TaskCollection KHARMADriver::MakeImExTaskCollection(BlockList_t &blocks, int sta
         }
 
         // Re-apply boundary conditions to reflect fixes
-        auto t_set_bc = tl.AddTask(t_fix_solve, parthenon::ApplyBoundaryConditionsOnCoarseOrFineMD, md_sync, false);
+        auto t_set_bc = tl.AddTask(t_fix_solve, KBoundaries::ApplyBoundariesMD, md_sync, false);
 
         // Any package- (likely, problem-) specific source terms which must be applied to primitive variables
         // Apply these only after the final step so they're operator-split
@@ -305,7 +324,7 @@ TaskCollection KHARMADriver::MakeImExTaskCollection(BlockList_t &blocks, int sta
         }
 
         // Make sure *all* conserved vars are synchronized at step end
-        auto t_ptou = tl.AddTask(t_heat_electrons, Flux::MeshPtoU, md_sub_step_final.get(), IndexDomain::entire, false);
+        auto t_ptou = tl.AddTask(t_heat_electrons, Flux::MeshPtoU, md_sub_step_final.get(), IndexDomain::entire, false, false);
 
         auto t_step_done = t_ptou;
 
@@ -337,11 +356,15 @@ TaskCollection KHARMADriver::MakeImExTaskCollection(BlockList_t &blocks, int sta
     // ensure that primitive variables in ghost zones are *exactly*
     // identical to their physical counterparts, now that they have been
     // modified on each rank.
+    // Face fields are left out unless they were just cleaned, see GetResyncVars
     const auto &two_sync = pkgs.at("Driver")->Param<bool>("two_sync");
     if (two_sync) {
+        const bool cleaned = use_b_cleanup && (stage == integrator->nstages) && B_Cleanup::CleanupThisStep(pmesh, tm.ncycle);
+        const auto resync_vars = KHARMADriver::GetResyncVars(pmesh, sync_vars, cleaned);
+        const std::string resync_name = (resync_vars.size() == sync_vars.size()) ? "sync" : "resync";
         for (int i = 0; i < num_partitions; i++) {
             auto &md_sub_step_final = pmesh->mesh_data.GetOrAdd(integrator->stage_name[stage], i);
-            auto &md_sync = pmesh->mesh_data.AddShallow("sync"+integrator->stage_name[stage]+std::to_string(i), md_sub_step_final, sync_vars);
+            auto &md_sync = pmesh->mesh_data.AddShallow(resync_name+integrator->stage_name[stage]+std::to_string(i), md_sub_step_final, resync_vars);
             KHARMADriver::AddFullSyncRegion(tc, md_sync);
         }
     }
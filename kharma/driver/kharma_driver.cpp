@@ -34,10 +34,26 @@
  */
 #include "kharma_driver.hpp"
 
+#include "b_cd.hpp"
 #include "b_ct.hpp"
 #include "boundaries.hpp"
+#include "float_halo.hpp"
 #include "flux.hpp"
 #include "get_flux.hpp"
+#include "inverter.hpp"
+#include "kharma.hpp"
+#include "kharma_package.hpp"
+
+#include <utils/partition_stl_containers.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <set>
+#if defined(MPI_PARALLEL) && defined(OPEN_MPI)
+#include <mpi-ext.h>
+#endif
 
 std::shared_ptr<KHARMAPackage> KHARMADriver::Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages)
 {
@@ -56,7 +72,8 @@ std::shared_ptr<KHARMAPackage> KHARMADriver::Initialize(ParameterInput *pin, std
     // The two current drivers are "kharma" or "imex", with the former being the usual KHARMA
     // driver (formerly HARM driver), and the latter supporting implicit stepping of some or all variables
     // Mostly, packages should react to e.g. the "sync_prims" option rather than the driver name
-    bool do_emhd = pin->GetOrAddBoolean("emhd", "on", false);
+    // EMHD defaults to ImEx, unless its sources are subcycled explicitly (see EMHD::SubcycleSources)
+    bool do_emhd = pin->GetOrAddBoolean("emhd", "on", false) && !pin->GetOrAddBoolean("emhd", "subcycle", false);
     std::string driver_type_s = pin->GetOrAddString("driver", "type", (do_emhd) ? "imex" : "kharma");
     DriverType driver_type;
     if (driver_type_s == "harm" || driver_type_s == "kharma") {
@@ -71,18 +88,56 @@ std::shared_ptr<KHARMAPackage> KHARMADriver::Initialize(ParameterInput *pin, std
     params.Add("type", driver_type);
     params.Add("name", driver_type_s);
 
-    // Synchronize boundary variables twice. Ensures KHARMA is agnostic to the breakdown
-    // of meshblocks, at the cost of twice the MPI overhead, for potentially worse strong scaling.
-    // On by default, disable only after testing that, e.g., divB meets your requirements
-    bool two_sync = pin->GetOrAddBoolean("driver", "two_sync", true);
-    params.Add("two_sync", two_sync);
-
-    // Don't even error on this. Use LLF unless the user is very clear otherwise.
+    // Time integrator.  Parthenon provides these in "low-storage" form, each stage being a weighted
+    // sum of the previous stage and the step start, plus the stage's flux divergence.
+    // SSPRK3 ("rk3") is stable to CFL 1 per stage, where the second-order methods need CFL 0.5-0.9
+    std::vector<std::string> allowed_integrators = {"rk1", "rk2", "vl2", "rk3"};
+    std::string integrator = pin->GetOrAddString("parthenon/time", "integrator", "rk2", allowed_integrators);
+    if (integrator == "rk3" && driver_type == DriverType::imex)
+        throw std::invalid_argument("The ImEx driver supports only rk1, rk2 or vl2 integrators!");
+    // With more than two stages, write intermediate stages over the same container rather than
+    // allocating one per stage: each stage depends only on the stage before and the step start,
+    // and the divergence is kept separately in "dUdt".  Unused with electrons, as the heating
+    // calculation needs the state at both ends of the sub-step.
+    bool low_storage = pin->GetOrAddBoolean("driver", "low_storage", true);
+    params.Add("low_storage", low_storage);
+
+    // Take this many cheap first-order steps to relax the initial conditions before stepping normally.
+    // See MakeRelaxTaskCollection
+    int relax_steps = pin->GetOrAddInteger("driver", "relax_steps", 0);
+    if (relax_steps > 0 && driver_type != DriverType::kharma)
+        throw std::invalid_argument("Relaxation steps are only supported with the kharma driver!");
+    params.Add("relax_steps", relax_steps);
+
+    // Riemann solver.  Use LLF unless the user is very clear otherwise.
+    // HLLD/HLLC-type solvers need the face states in a locally flat frame aligned with the face,
+    // which GetFlux does not construct (yet), so error rather than silently using LLF
     std::string flux = pin->GetOrAddString("driver", "flux", "llf");
+    if (flux == "hlld" || flux == "hllc")
+        throw std::invalid_argument("Riemann solver "+flux+" is not supported yet! Use llf or hlle");
     params.Add("use_hlle", (flux == "hlle"));
 
+    // Compute fluxes in one kernel per direction, keeping reconstructed states in scratch
+    // rather than writing them to the mesh-sized Flux.* fields
+    bool fused_flux = pin->GetOrAddBoolean("driver", "fused_flux", false);
+    params.Add("fused_flux", fused_flux);
+    // In the fused kernel, compute X2/X3 reconstructions once per zone by streaming through
+    // "pencils" of pencil_length rows, rather than separately for each side of each face
+    bool pencil_recon = pin->GetOrAddBoolean("driver", "pencil_recon", false);
+    if (pencil_recon && !fused_flux)
+        throw std::invalid_argument("Pencil reconstruction requires driver/fused_flux!");
+    params.Add("pencil_recon", pencil_recon);
+    int pencil_length = pin->GetOrAddInteger("driver", "pencil_length", 8);
+    if (pencil_length < 1)
+        throw std::invalid_argument("driver/pencil_length must be positive!");
+    params.Add("pencil_length", pencil_length);
+    // Launch the flux calculations in each direction on separate execution space instances,
+    // so they can run concurrently.  Most useful with many small blocks
+    bool flux_streams = pin->GetOrAddBoolean("driver", "flux_streams", false);
+    params.Add("flux_streams", flux_streams);
+
     // Reconstruction scheme.  TODO bunch more here, PPM esp...
-    std::vector<std::string> allowed_vals = {"donor_cell", "linear_mc", "weno5"};
+    std::vector<std::string> allowed_vals = {"donor_cell", "linear_mc", "ppm", "mp5", "weno5", "weno5_batched", "weno5z"};
     std::string recon = pin->GetOrAddString("driver", "reconstruction", "weno5", allowed_vals);
     bool lower_edges = pin->GetOrAddBoolean("driver", "lower_edges", false);
     bool lower_poles = pin->GetOrAddBoolean("driver", "lower_poles", false);
@@ -110,13 +165,58 @@ std::shared_ptr<KHARMAPackage> KHARMADriver::Initialize(ParameterInput *pin, std
     } else if (recon == "weno5") {
         params.Add("recon", KReconstruction::Type::weno5);
         stencil = 5;
+    } else if (recon == "weno5_batched") {
+        // Same scheme as weno5, vectorized over zones.  Mostly useful on CPUs
+        params.Add("recon", KReconstruction::Type::weno5_batched);
+        stencil = 5;
+    } else if (recon == "weno5z") {
+        params.Add("recon", KReconstruction::Type::weno5z);
+        stencil = 5;
+    } else if (recon == "ppm") {
+        params.Add("recon", KReconstruction::Type::ppm);
+        stencil = 5;
+    } else if (recon == "mp5") {
+        params.Add("recon", KReconstruction::Type::mp5);
+        stencil = 5;
     } // we only allow these options
+    // Fall back to linear/MC reconstruction only on faces near zones which hit floors
+    // or failed inversion at the last UtoP.  Applies on top of any reconstruction.
+    bool troubled_fallback = pin->GetOrAddBoolean("driver", "troubled_fallback", false);
+    params.Add("troubled_fallback", troubled_fallback);
+
+    // Execution policy of the split (not fused) flux kernels.  "team" runs a team per row of zones,
+    // reconstructing the row in scratch.  "flat" launches them flattened over zones, reconstructing in
+    // registers without scratch, which keeps a device busy when rows are short.
+    // "auto" uses "flat" on GPUs, for blocks at most driver/flat_flux_max_n1 zones wide
+    std::vector<std::string> flux_policy_vals = {"auto", "team", "flat"};
+    std::string flux_policy = pin->GetOrAddString("driver", "flux_policy", "auto", flux_policy_vals);
+    const int flat_flux_max_n1 = pin->GetOrAddInteger("driver", "flat_flux_max_n1", 32);
+    const int block_n1 = pin->DoesParameterExist("parthenon/meshblock", "nx1") ? pin->GetInteger("parthenon/meshblock", "nx1")
+                                                                               : pin->GetInteger("parthenon/mesh", "nx1");
+    const bool on_device = !std::is_same<DevExecSpace, Kokkos::DefaultHostExecutionSpace>::value;
+    const bool can_flatten = !fused_flux && KReconstruction::has_face_recon(params.Get<KReconstruction::Type>("recon"));
+    if (flux_policy == "flat" && !can_flatten)
+        throw std::invalid_argument("Flattened flux kernels require driver/fused_flux=false, and no lowered reconstruction!");
+    params.Add("flat_flux", can_flatten && (flux_policy == "flat" ||
+                                            (flux_policy == "auto" && on_device && block_n1 <= flat_flux_max_n1)));
+
     // Warn if using less than 3 ghost zones w/WENO etc, 2 w/Linear, etc.
     // SMR/AMR independently requires an even number of zones, so we usually use 4
     if (Globals::nghost < (stencil/2 + 1)) {
         throw std::runtime_error("Not enough ghost zones for specified reconstruction!");
     }
 
+    // Synchronize boundary variables twice. Ensures KHARMA is agnostic to the breakdown
+    // of meshblocks, at the cost of twice the MPI overhead, for potentially worse strong scaling.
+    // The KHARMA driver recomputes UtoP, floors and fixups over the ghost zones after its first sync.
+    // These match the neighboring block's physical zones except in the outermost ghost layer,
+    // where fixups lack neighbors.  So given one more ghost zone than reconstruction needs,
+    // (i.e. the usual 4 for WENO5), the second sync changes nothing the next stage reads, and is off by default.
+    // The ImEx driver's fixups depend on solver flags which are not sync'd, so it always syncs twice by default.
+    const bool extra_ghost = Globals::nghost >= (stencil/2 + 2);
+    bool two_sync = pin->GetOrAddBoolean("driver", "two_sync", !(driver_type == DriverType::kharma && extra_ghost));
+    params.Add("two_sync", two_sync);
+
     // When using the Implicit package we need to globally distinguish implicit & explicit vars
     // All independent variables should be marked one or the other,
     // so we define the flags here to avoid loading order issues
@@ -146,9 +246,452 @@ std::shared_ptr<KHARMAPackage> KHARMADriver::Initialize(ParameterInput *pin, std
         params.Add("cons_flags", std::vector<MetadataFlag>{Metadata::Real, Metadata::Independent, Metadata::Restart, Metadata::FillGhost, Metadata::WithFluxes, Metadata::Conserved});
     }
 
+    // Time the flux & UtoP kernels at several pack sizes on startup, and after regrids which
+    // substantially change the number of blocks, and report the fastest.
+    bool autotune = pin->GetOrAddBoolean("driver", "autotune_pack_size", false);
+    params.Add("autotune_pack_size", autotune);
+    if (autotune) {
+        int autotune_steps = pin->GetOrAddInteger("driver", "autotune_steps", 3);
+        if (autotune_steps < 1)
+            throw std::invalid_argument("driver/autotune_steps must be positive!");
+        params.Add("autotune_steps", autotune_steps);
+        // Number of blocks at the last tuning, 0 to tune on the first step
+        params.Add("autotune_nblocks", 0, true);
+        // Optionally record the fastest pack size for each configuration in a file, one per machine.
+        // Configurations found there are applied before the Mesh is built (see KHARMA::FixParameters)
+        // and not re-tuned, so only the first run on each machine pays for the search
+        params.Add("autotune_file", pin->GetOrAddString("driver", "autotune_file", ""));
+    }
+
+    // Sync only the variables the KHARMA driver can't reconstruct after a sync: conserved & face-centered variables.
+    // Skips the primitives, which are recovered in ghost zones by UtoP anyway.  However, they
+    // then seed UtoP with values that vary with the mesh decomposition, so results are no longer
+    // independent of it (to within the inversion tolerance). No effect for drivers syncing primitives.
+    bool minimal_sync = pin->GetOrAddBoolean("driver", "minimal_sync", false);
+    params.Add("minimal_sync", minimal_sync);
+    // Time this many boundary exchanges before the first step and report the effective bandwidth
+    int benchmark_sync = pin->GetOrAddInteger("driver", "benchmark_sync", 0);
+    params.Add("benchmark_sync", benchmark_sync);
+    params.Add("benchmarked_sync", false, true);
+
+    // After each regrid, recover primitives, apply floors & fixups, and re-apply domain boundaries
+    // in all blocks new to this rank at once, before their first fluxes.  Otherwise new blocks start
+    // from their prolongated primitives, which only approximately match their prolongated conserved
+    // variables, and are left consistent by the end of the first stage.  KHARMA driver only
+    bool refresh_new_blocks = pin->GetOrAddBoolean("driver", "refresh_new_blocks", false) &&
+                              driver_type == DriverType::kharma;
+    params.Add("refresh_new_blocks", refresh_new_blocks);
+    if (refresh_new_blocks) {
+        // Logical locations (level, lx1, lx2, lx3) of the blocks on this rank at the last step
+        params.Add("block_locations", std::set<std::array<long long, 4>>(), true);
+        // Reused for the new blocks, so that caches keyed by MeshData stay bounded
+        params.Add("new_blocks_md", std::make_shared<MeshData<Real>>(), true);
+    }
+
+    if (autotune || benchmark_sync > 0 || refresh_new_blocks)
+        pkg->PreStepWork = KHARMADriver::PreStepWork;
+
+    // Throughput metrics every parthenon/time/ncycle_out steps: zone-cycles/s, the fraction of
+    // time spent in boundary & flux correction receives, and the load imbalance between ranks.
+    // Optionally also appended to a CSV file for job monitoring
+    bool metrics = pin->GetOrAddBoolean("driver", "metrics", false);
+    params.Add("metrics", metrics);
+    if (metrics) {
+        params.Add("metrics_ncycle", m::max(pin->GetOrAddInteger("parthenon/time", "ncycle_out", 1), 1));
+        params.Add("metrics_file", pin->GetOrAddString("driver", "metrics_file", ""));
+        // Accumulated over the reporting interval, see ReceiveBoundBufsTimed
+        params.Add("recv_time", 0.0, true);
+        params.Add("metrics_last_wall", MetricsClock(), true);
+        params.Add("metrics_last_ncycle", 0, true);
+    }
+    // See KHARMA::FixParameters for what benchmark mode disables
+    bool benchmark = pin->GetOrAddBoolean("driver", "benchmark", false);
+    params.Add("benchmark", benchmark);
+    if (benchmark) {
+        params.Add("benchmark_warmup", m::max(pin->GetOrAddInteger("driver", "benchmark_warmup", 10), 1));
+        params.Add("benchmark_start_wall", 0.0, true);
+        params.Add("benchmark_start_ncycle", -1, true);
+    }
+    if (metrics || benchmark)
+        pkg->PostStepWork = KHARMADriver::PostStepWork;
+
     return pkg;
 }
 
+void KHARMADriver::PreStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+    auto &params = pmesh->packages.Get("Driver")->AllParams();
+    if (params.Get<int>("benchmark_sync") > 0 && !params.Get<bool>("benchmarked_sync")) {
+        BenchmarkSync(pmesh, params.Get<int>("benchmark_sync"));
+        params.Update<bool>("benchmarked_sync", true);
+    }
+    if (params.Get<bool>("refresh_new_blocks"))
+        RefreshNewBlocks(pmesh);
+    if (params.Get<bool>("autotune_pack_size"))
+        TunePackSize(pmesh, pin, tm);
+}
+
+void KHARMADriver::RefreshNewBlocks(Mesh *pmesh)
+{
+    auto &params = pmesh->packages.Get("Driver")->AllParams();
+    auto &last_locations = *params.GetMutable<std::set<std::array<long long, 4>>>("block_locations");
+
+    // Blocks at locations this rank didn't hold last step: refined, derefined, or moved here
+    std::set<std::array<long long, 4>> locations;
+    BlockList_t new_blocks;
+    for (auto &pmb : pmesh->block_list) {
+        const std::array<long long, 4> loc = {pmb->loc.level(), pmb->loc.lx1(), pmb->loc.lx2(), pmb->loc.lx3()};
+        locations.insert(loc);
+        if (!last_locations.count(loc)) new_blocks.push_back(pmb);
+    }
+    // The first step needs nothing: PostInitialize leaves every block consistent
+    const bool first = last_locations.empty();
+    last_locations = locations;
+    if (first || new_blocks.empty()) return;
+    Flag("RefreshNewBlocks");
+
+    // By now Parthenon has prolongated the conserved variables (including face B with the
+    // divergence-preserving operator) and filled the coarse-fine ghost zones.  Everything else
+    // mirrors the fix region of MakeDefaultTaskCollection, over all the new blocks at once
+    auto md = *params.GetMutable<std::shared_ptr<MeshData<Real>>>("new_blocks_md");
+    md->Set(new_blocks, pmesh);
+    auto& pkgs = pmesh->packages.AllPackages();
+    const bool fuse_floors = pkgs.count("Inverter") && pkgs.count("Floors") &&
+                             pkgs.at("Inverter")->Param<bool>("fuse_floors") &&
+                             !pkgs.count("Electrons") && !pkgs.count("EMHD");
+    if (fuse_floors) {
+        Packages::MeshUtoPFloors(md.get(), IndexDomain::entire, false);
+    } else {
+        Packages::MeshUtoP(md.get(), IndexDomain::entire, false);
+        Packages::MeshApplyFloors(md.get(), IndexDomain::entire);
+    }
+    Inverter::MeshFixUtoP(md.get());
+    KBoundaries::ApplyBoundariesMD(md, false);
+
+    EndFlag();
+}
+
+double KHARMADriver::MetricsClock()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TaskStatus KHARMADriver::ReceiveBoundBufsTimed(std::shared_ptr<MeshData<Real>> &md)
+{
+    const double start = MetricsClock();
+    auto status = parthenon::ReceiveBoundBufs<parthenon::BoundaryType::any>(md);
+    auto &params = md->GetMeshPointer()->packages.Get("Driver")->AllParams();
+    params.Update<double>("recv_time", params.Get<double>("recv_time") + MetricsClock() - start);
+    return status;
+}
+
+TaskStatus KHARMADriver::ReceiveFluxCorrectionsTimed(std::shared_ptr<MeshData<Real>> &md)
+{
+    const double start = MetricsClock();
+    auto status = parthenon::ReceiveFluxCorrections(md);
+    auto &params = md->GetMeshPointer()->packages.Get("Driver")->AllParams();
+    if (params.Get<bool>("metrics"))
+        params.Update<double>("recv_time", params.Get<double>("recv_time") + MetricsClock() - start);
+    return status;
+}
+
+// Total interior zones on this rank
+static long long LocalZones(Mesh *pmesh)
+{
+    long long zones = 0;
+    for (auto &pmb : pmesh->block_list) {
+        const auto &cb = pmb->cellbounds;
+        zones += cb.ncellsi(IndexDomain::interior) * cb.ncellsj(IndexDomain::interior) * cb.ncellsk(IndexDomain::interior);
+    }
+    return zones;
+}
+
+void KHARMADriver::PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+    auto &params = pmesh->packages.Get("Driver")->AllParams();
+    // tm.ncycle is incremented after this call
+    const int ncycle = tm.ncycle + 1;
+    // Start the benchmark clock once warmup steps are done
+    if (params.Get<bool>("benchmark") && ncycle == params.Get<int>("benchmark_warmup")) {
+        Kokkos::fence();
+        params.Update<double>("benchmark_start_wall", MetricsClock());
+        params.Update<int>("benchmark_start_ncycle", ncycle);
+    }
+    if (params.Get<bool>("metrics"))
+        ReportMetrics(pmesh, tm);
+}
+
+void KHARMADriver::ReportMetrics(Mesh *pmesh, const SimTime &tm)
+{
+    auto &params = pmesh->packages.Get("Driver")->AllParams();
+    const int ncycle = tm.ncycle + 1;
+    const int ncycles = ncycle - params.Get<int>("metrics_last_ncycle");
+    if (ncycle % params.Get<int>("metrics_ncycle") != 0 || ncycles < 1) return;
+
+    const double now = MetricsClock();
+    const double wall = now - params.Get<double>("metrics_last_wall");
+    const double recv = params.Get<double>("recv_time");
+    params.Update<double>("metrics_last_wall", now);
+    params.Update<int>("metrics_last_ncycle", ncycle);
+    params.Update<double>("recv_time", 0.0);
+
+    const long long zones = LocalZones(pmesh);
+
+    // Time outside receives is the work each rank must do; ranks waiting on the slowest one
+    // show up as time in receives
+    const double busy = wall - recv;
+    // Sums: zone-cycles/s, receive fraction, busy time.  Maxes: receive fraction, busy time
+    std::vector<double> sums = {zones * ncycles / wall, recv / wall, busy};
+    std::vector<double> maxes = {recv / wall, busy};
+#ifdef MPI_PARALLEL
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, sums.data(), sums.size(), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD));
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, maxes.data(), maxes.size(), MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD));
+#endif
+    if (!MPIRank0()) return;
+    const int nranks = MPINumRanks();
+    const double zcps_global = sums[0];
+    const double recv_frac_mean = sums[1] / nranks;
+    const double imbalance = (sums[2] > 0.) ? maxes[1] / (sums[2] / nranks) : 1.;
+
+    std::cout << "Performance over cycles " << ncycle - ncycles << "-" << ncycle << ": "
+              << zcps_global << " zone-cycles/s, " << zcps_global / nranks << " per rank; "
+              << "receive wait " << 100. * recv_frac_mean << "% mean, " << 100. * maxes[0] << "% max; "
+              << "load imbalance " << imbalance << std::endl;
+
+    const std::string &fname = params.Get<std::string>("metrics_file");
+    if (fname != "") {
+        const bool exists = std::ifstream(fname).good();
+        std::ofstream out(fname, std::ios::app);
+        if (!exists)
+            out << "ncycle,time,wall_seconds,nranks,zone_cycles_per_second,zone_cycles_per_second_per_rank,"
+                << "recv_fraction_mean,recv_fraction_max,load_imbalance" << std::endl;
+        out << ncycle << "," << tm.time + tm.dt << "," << wall << "," << nranks << "," << zcps_global << ","
+            << zcps_global / nranks << "," << recv_frac_mean << "," << maxes[0] << "," << imbalance << std::endl;
+    }
+}
+
+std::vector<std::string> KHARMADriver::GetSyncVars(Mesh *pmesh)
+{
+    // Build the universe of variables to let Parthenon see when exchanging boundaries.
+    // This is built to exclude incidental variables like B field initialization stuff, EMFs, etc.
+    // "Boundaries" packs in buffers e.g. Dirichlet boundaries
+    using FC = Metadata::FlagCollection;
+    auto &params = pmesh->packages.Get("Driver")->AllParams();
+    std::vector<std::string> names;
+    if (params.Get<bool>("minimal_sync") && !params.Get<bool>("sync_prims")) {
+        names = KHARMA::GetVariableNames(&(pmesh->packages), FC({Metadata::Conserved, Metadata::Face,
+                                                                Metadata::GetUserFlag("Boundaries")}, true));
+    } else {
+        names = KHARMA::GetVariableNames(&(pmesh->packages), FC({Metadata::GetUserFlag("Primitive"), Metadata::Conserved,
+                                                                Metadata::Face, Metadata::GetUserFlag("Boundaries")}, true));
+    }
+    // Carry the packed halo field, which stands in for any reduced-precision variables, see float_halo.hpp
+    if (pmesh->packages.AllPackages().count("FloatHalo"))
+        names.push_back("halo.packed");
+    return names;
+}
+
+std::vector<std::string> KHARMADriver::GetResyncVars(Mesh *pmesh, const std::vector<std::string>& sync_vars,
+                                                    bool cleaned)
+{
+    if (cleaned) return sync_vars;
+    using FC = Metadata::FlagCollection;
+    const auto face_vars = KHARMA::GetVariableNames(&(pmesh->packages), FC({Metadata::Face}, true));
+    std::vector<std::string> names;
+    for (auto& name : sync_vars)
+        if (std::find(face_vars.begin(), face_vars.end(), name) == face_vars.end())
+            names.push_back(name);
+    return names;
+}
+
+void KHARMADriver::BenchmarkSync(Mesh *pmesh, int nsync)
+{
+    Flag("BenchmarkSync");
+    auto &md = pmesh->mesh_data.Get();
+    auto &md_sync = pmesh->mesh_data.AddShallow("benchmark_sync", md, GetSyncVars(pmesh));
+
+    // Bytes received per exchange, counted as the ghost fraction of each synchronized variable.
+    // Includes physical boundaries and can double-count edges/corners, so this is an estimate
+    double bytes = 0.;
+    for (int b = 0; b < md_sync->NumBlocks(); b++) {
+        auto &rc = md_sync->GetBlockData(b);
+        const auto &cb = rc->GetBlockPointer()->cellbounds;
+        const double n_entire = cb.ncellsi(IndexDomain::entire) * cb.ncellsj(IndexDomain::entire) * cb.ncellsk(IndexDomain::entire);
+        const double n_interior = cb.ncellsi(IndexDomain::interior) * cb.ncellsj(IndexDomain::interior) * cb.ncellsk(IndexDomain::interior);
+        for (auto &var : rc->GetVariableVector()) {
+            if (var->IsAllocated())
+                bytes += (1. - n_interior / n_entire) * var->data.size() * sizeof(Real);
+        }
+    }
+
+    Kokkos::fence();
+    MPIBarrier();
+    Kokkos::Timer timer;
+    for (int n = 0; n < nsync; n++)
+        SyncAllBounds(md_sync);
+    Kokkos::fence();
+    Real time = timer.seconds();
+
+#ifdef MPI_PARALLEL
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &bytes, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD));
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_PARTHENON_REAL, MPI_MAX, MPI_COMM_WORLD));
+#endif
+
+    if (MPIRank0()) {
+        std::cout << "Boundary sync benchmark: " << GetSyncVars(pmesh).size() << " variables, "
+                  << bytes / 1.e6 << " MB per exchange, " << time / nsync * 1.e3 << " ms per exchange, "
+                  << bytes * nsync / time / 1.e9 << " GB/s" << std::endl;
+#if defined(MPI_PARALLEL) && defined(MPIX_CUDA_AWARE_SUPPORT)
+        // Parthenon passes device buffers straight to MPI unless built with host communication buffers,
+        // which requires a GPU-aware MPI.  Report what the MPI library claims, where it can tell us
+        std::cout << "MPI library reports CUDA-aware support: " << (MPIX_Query_cuda_support() ? "yes" : "no") << std::endl;
+#endif
+    }
+
+    EndFlag();
+}
+
+void KHARMADriver::TunePackSize(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+    auto &params = pmesh->packages.Get("Driver")->AllParams();
+    const int nblocks = pmesh->block_list.size();
+    const int last_nblocks = params.Get<int>("autotune_nblocks");
+    // Only re-tune when the number of local blocks has at least doubled or halved
+    if (last_nblocks > 0 && nblocks < 2 * last_nblocks && 2 * nblocks > last_nblocks) return;
+    Flag("TunePackSize");
+    params.Update<int>("autotune_nblocks", nblocks);
+
+    const int nsteps = params.Get<int>("autotune_steps");
+    const KReconstruction::Type recon = params.Get<KReconstruction::Type>("recon");
+
+    // Skip the search if this configuration has been tuned before, and that result is in use.
+    // Key on the largest local block count, so every rank makes the same choice
+    const std::string &cache_file = params.Get<std::string>("autotune_file");
+    int max_nblocks = nblocks;
+#ifdef MPI_PARALLEL
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &max_nblocks, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD));
+#endif
+    const std::string key = PackSizeKey(pin, max_nblocks);
+    if (!cache_file.empty()) {
+        const int cached = CachedPackSize(cache_file, key);
+        if (cached == pmesh->DefaultPackSize()) {
+            if (MPIRank0())
+                std::cout << "Using tuned pack_size " << cached << " for " << key << " from " << cache_file << std::endl;
+            EndFlag();
+            return;
+        }
+    }
+
+    // Candidates: all blocks in one pack, then halving down to one block per pack
+    std::vector<int> sizes;
+    for (int size = nblocks; size > 1; size = (size + 1) / 2)
+        sizes.push_back(size);
+    sizes.push_back(1);
+
+    std::vector<Real> times;
+    for (const int size : sizes) {
+        // Build the partitions directly, since Parthenon's own are fixed at the mesh's pack_size
+        auto partitions = partition::ToSizeN(pmesh->block_list, size);
+        std::vector<std::shared_ptr<MeshData<Real>>> mds;
+        for (auto &partition : partitions) {
+            auto md = std::make_shared<MeshData<Real>>();
+            md->Set(partition, pmesh);
+            mds.push_back(md);
+        }
+
+        // One untimed pass to warm up, then average over nsteps.
+        // UtoP only re-solves the current state, so this leaves the fluid unchanged
+        Kokkos::Timer timer;
+        for (int step = 0; step <= nsteps; step++) {
+            if (step == 1) {
+                Kokkos::fence();
+                timer.reset();
+            }
+            TaskID t_none(0);
+            TaskCollection tc;
+            TaskRegion &tr = tc.AddRegion(mds.size());
+            for (int i = 0; i < mds.size(); i++) {
+                auto t_fluxes = AddFluxCalculations(t_none, tr[i], recon, mds[i].get());
+                tr[i].AddTask(t_fluxes, Packages::MeshUtoP, mds[i].get(), IndexDomain::interior, false);
+            }
+            while (!tr.Execute());
+        }
+        Kokkos::fence();
+        times.push_back(timer.seconds() / nsteps);
+    }
+
+    // Ranks step together, so the slowest rank determines the time
+#ifdef MPI_PARALLEL
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, times.data(), times.size(), MPI_PARTHENON_REAL, MPI_MAX,
+                                      MPI_COMM_WORLD));
+#endif
+    const int ibest = std::min_element(times.begin(), times.end()) - times.begin();
+    const int best = sizes[ibest];
+
+    // Parthenon's partitions are built from the pack size at Mesh construction, so record the choice
+    // for restarts (which re-read these parameters from the file) as well as reporting it
+    pin->SetInteger("parthenon/mesh", "pack_size", best);
+    if (MPIRank0()) {
+        std::cout << "Pack size autotuning at step " << tm.ncycle << ", " << nblocks << " local blocks:" << std::endl;
+        for (int i = 0; i < sizes.size(); i++) {
+            std::cout << "  pack_size " << sizes[i] << ": " << times[i] * 1.e3 << " ms per flux+UtoP pass"
+                      << ((i == ibest) ? " (fastest)" : "") << std::endl;
+        }
+        if (best != pmesh->DefaultPackSize()) {
+            std::cout << "Current pack_size is " << pmesh->DefaultPackSize() << ", set parthenon/mesh/pack_size="
+                      << best << " (used on restart) for best performance" << std::endl;
+        }
+        if (!cache_file.empty()) {
+            StorePackSize(cache_file, key, best);
+            std::cout << "Recorded pack_size " << best << " for " << key << " in " << cache_file << std::endl;
+        }
+    }
+
+    EndFlag();
+}
+
+std::string KHARMADriver::PackSizeKey(ParameterInput *pin, int nblocks)
+{
+    // The device, reconstruction, block shape & number of local blocks determine the fastest pack size
+    std::string key = std::string(DevExecSpace::name()) + "/" + pin->GetString("driver", "reconstruction") + "/";
+    for (int d = 1; d <= 3; d++) {
+        const std::string nx = "nx" + std::to_string(d);
+        const int n = pin->DoesParameterExist("parthenon/meshblock", nx) ? pin->GetInteger("parthenon/meshblock", nx)
+                                                                         : pin->GetInteger("parthenon/mesh", nx);
+        key += std::to_string(n) + ((d < 3) ? "x" : "/");
+    }
+    return key + std::to_string(nblocks);
+}
+
+int KHARMADriver::CachedPackSize(const std::string &fname, const std::string &key)
+{
+    // One "key pack_size" pair per line, the last entry for a key wins
+    std::ifstream file(fname);
+    std::string entry;
+    int size, found = -1;
+    while (file >> entry >> size)
+        if (entry == key) found = size;
+    return found;
+}
+
+void KHARMADriver::StorePackSize(const std::string &fname, const std::string &key, int size)
+{
+    // Rewrite the file with this entry replacing any earlier one
+    std::vector<std::pair<std::string, int>> entries;
+    {
+        std::ifstream file(fname);
+        std::string entry;
+        int entry_size;
+        while (file >> entry >> entry_size)
+            if (entry != key) entries.emplace_back(entry, entry_size);
+    }
+    entries.emplace_back(key, size);
+    std::ofstream file(fname, std::ios::trunc);
+    if (!file) throw std::runtime_error("Could not write pack size tuning file "+fname);
+    for (auto &e : entries)
+        file << e.first << " " << e.second << std::endl;
+}
+
 void KHARMADriver::AddFullSyncRegion(TaskCollection& tc, std::shared_ptr<MeshData<Real>> &md_sync)
 {
     const TaskID t_none(0);
@@ -173,10 +716,40 @@ TaskID KHARMADriver::AddBoundarySync(const TaskID t_start, TaskList &tl, std::sh
     auto &params = pmesh->packages.Get("Driver")->AllParams();
     bool multilevel = pmesh->multilevel;
 
+    // Variables exchanged in float32 travel packed into a stand-in field, in a shallow copy of mc1.
+    // Physical boundaries are then applied to everything in mc1, see float_halo.hpp
+    auto &md_exchange = FloatHalo::ExchangeData(mc1);
+    const bool float_halo = (md_exchange != mc1);
+
     // The Parthenon exchange tasks include applying physical boundary conditions now.
     // We generally do not take advantage of this yet, but good to know when reasoning about initialization.
     Flag("ParthenonAddSync");
-    auto t_sync_done = parthenon::AddBoundaryExchangeTasks(t_start_sync, tl, mc1, multilevel);
+    TaskID t_sync_done;
+    if (float_halo) {
+        const auto any = parthenon::BoundaryType::any;
+        auto t_pack = tl.AddTask(t_start_sync, FloatHalo::PackHalo, mc1.get());
+        auto t_send = tl.AddTask(t_pack, parthenon::SendBoundBufs<any>, md_exchange);
+        auto t_recv = (params.Get<bool>("metrics")) ?
+                        tl.AddTask(t_start_sync, KHARMADriver::ReceiveBoundBufsTimed, md_exchange) :
+                        tl.AddTask(t_start_sync, parthenon::ReceiveBoundBufs<any>, md_exchange);
+        auto t_set = tl.AddTask(t_recv, parthenon::SetBounds<any>, md_exchange);
+        auto t_unpack = tl.AddTask(t_set, FloatHalo::UnpackHalo, mc1.get());
+        t_sync_done = tl.AddTask(t_unpack, parthenon::ApplyBoundaryConditionsOnCoarseOrFineMD, mc1, false);
+    } else if (params.Get<bool>("metrics")) {
+        // Spelled out as in AddBoundaryExchangeTasks, in order to time the receives
+        const auto any = parthenon::BoundaryType::any;
+        auto t_send = tl.AddTask(t_start_sync, parthenon::SendBoundBufs<any>, mc1);
+        auto t_recv = tl.AddTask(t_start_sync, KHARMADriver::ReceiveBoundBufsTimed, mc1);
+        auto t_set = tl.AddTask(t_recv, parthenon::SetBounds<any>, mc1);
+        auto t_pro = t_set;
+        if (multilevel) {
+            auto t_cbound = tl.AddTask(t_set, parthenon::ApplyBoundaryConditionsOnCoarseOrFineMD, mc1, true);
+            t_pro = tl.AddTask(t_cbound, parthenon::ProlongateBounds<any>, mc1);
+        }
+        t_sync_done = tl.AddTask(t_pro, parthenon::ApplyBoundaryConditionsOnCoarseOrFineMD, mc1, false);
+    } else {
+        t_sync_done = parthenon::AddBoundaryExchangeTasks(t_start_sync, tl, mc1, multilevel);
+    }
     auto t_bounds = t_sync_done;
     EndFlag();
 
@@ -261,6 +834,26 @@ TaskID KHARMADriver::AddFluxCalculations(TaskID& t_start, TaskList& tl, KReconst
         t_calculate_flux2 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::weno5, X2DIR>, md);
         t_calculate_flux3 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::weno5, X3DIR>, md);
         break;
+    case RType::weno5_batched:
+        t_calculate_flux1 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::weno5_batched, X1DIR>, md);
+        t_calculate_flux2 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::weno5_batched, X2DIR>, md);
+        t_calculate_flux3 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::weno5_batched, X3DIR>, md);
+        break;
+    case RType::ppm:
+        t_calculate_flux1 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::ppm, X1DIR>, md);
+        t_calculate_flux2 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::ppm, X2DIR>, md);
+        t_calculate_flux3 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::ppm, X3DIR>, md);
+        break;
+    case RType::mp5:
+        t_calculate_flux1 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::mp5, X1DIR>, md);
+        t_calculate_flux2 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::mp5, X2DIR>, md);
+        t_calculate_flux3 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::mp5, X3DIR>, md);
+        break;
+    case RType::weno5z:
+        t_calculate_flux1 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::weno5z, X1DIR>, md);
+        t_calculate_flux2 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::weno5z, X2DIR>, md);
+        t_calculate_flux3 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::weno5z, X3DIR>, md);
+        break;
     case RType::weno5_lower_edges:
         t_calculate_flux1 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::weno5_lower_edges, X1DIR>, md);
         t_calculate_flux2 = tl.AddTask(t_start_fluxes, Flux::GetFlux<RType::weno5_lower_edges, X2DIR>, md);
@@ -273,10 +866,16 @@ TaskID KHARMADriver::AddFluxCalculations(TaskID& t_start, TaskList& tl, KReconst
         break;
     default:
         std::cerr << "Reconstruction type not supported!  Main supported reconstructions:" << std::endl
-                  << "donor_cell, linear_mc, weno5" << std::endl;
+                  << "donor_cell, linear_mc, ppm, mp5, weno5, weno5_batched, weno5z" << std::endl;
         throw std::invalid_argument("Unsupported reconstruction algorithm!");
     }
     auto t_calc_fluxes = t_calculate_flux1 | t_calculate_flux2 | t_calculate_flux3;
+    // Each direction may have been launched on its own instance, wait for all of them
+    if (md->GetMeshPointer()->packages.Get("Driver")->Param<bool>("flux_streams"))
+        t_calc_fluxes = tl.AddTask(t_calc_fluxes, Flux::FenceFluxStreams, md);
+    // Point fluxes to face averages, before anything else reads or modifies them
+    if (md->GetMeshPointer()->packages.Get("Flux")->Param<bool>("fourth_order"))
+        t_calc_fluxes = tl.AddTask(t_calc_fluxes, Flux::FourthOrderCorrection, md);
 
     auto t_ctop = t_calc_fluxes;
     if (md->GetMeshPointer()->packages.Get("Globals")->Param<int>("extra_checks") > 0) {
@@ -286,6 +885,16 @@ TaskID KHARMADriver::AddFluxCalculations(TaskID& t_start, TaskList& tl, KReconst
     return t_ctop;
 }
 
+TaskID KHARMADriver::AddFluxDivergence(TaskID& t_start, TaskList& tl, MeshData<Real> *md, MeshData<Real> *mdudt)
+{
+    // The fused version also adds the geometric source term, which Flux then leaves out of AddSource
+    if (md->GetMeshPointer()->packages.Get("Flux")->Param<bool>("fused_geo_source")) {
+        return tl.AddTask(t_start, Flux::FluxDivergenceGeoSource, md, mdudt);
+    } else {
+        return tl.AddTask(t_start, Update::FluxDivergence<MeshData<Real>>, md, mdudt);
+    }
+}
+
 void KHARMADriver::SetGlobalTimeStep()
 {
   // TODO TODO apply the limits from GRMHD package here
@@ -298,19 +907,56 @@ void KHARMADriver::SetGlobalTimeStep()
     pmb->SetAllowedDt(big);
   }
 
+  // Constraint damping needs the global maximum ctop, which rides along in the same reduction:
+  // the minimum of -ctop is the maximum ctop
+  const bool use_b_cd = pmesh->packages.AllPackages().count("B_CD");
+  Real reduce_vals[2] = {tm.dt, (use_b_cd) ? -pmesh->packages.Get("B_CD")->Param<Real>("ctop_max") : 0.};
+
     // TODO start reduce at the end of the per-meshblock stuff, check here
 #ifdef MPI_PARALLEL
-  PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &tm.dt, 1, MPI_PARTHENON_REAL, MPI_MIN,
+  PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, reduce_vals, 1 + use_b_cd, MPI_PARTHENON_REAL, MPI_MIN,
                                     MPI_COMM_WORLD));
 #endif
+  tm.dt = reduce_vals[0];
+  if (use_b_cd) B_CD::UpdateCtopMax(pmesh, -reduce_vals[1]);
 
   if (tm.time < tm.tlim &&
       (tm.tlim - tm.time) < tm.dt) // timestep would take us past desired endpoint
     tm.dt = tm.tlim - tm.time;
 }
 
+void KHARMADriver::ReportBenchmark()
+{
+    auto &params = pmesh->packages.Get("Driver")->AllParams();
+    const int start_ncycle = params.Get<int>("benchmark_start_ncycle");
+    if (start_ncycle < 0 || tm.ncycle <= start_ncycle) {
+        if (MPIRank0())
+            std::cout << "Benchmark: not enough steps to time after " << params.Get<int>("benchmark_warmup")
+                      << " warmup steps" << std::endl;
+        return;
+    }
+    Kokkos::fence();
+    const double wall = MetricsClock() - params.Get<double>("benchmark_start_wall");
+    const int ncycles = tm.ncycle - start_ncycle;
+    double zones = LocalZones(pmesh);
+    double max_wall = wall;
+#ifdef MPI_PARALLEL
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &zones, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD));
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &max_wall, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD));
+#endif
+    if (MPIRank0()) {
+        const double zcps = zones * ncycles / max_wall;
+        // One line, for scripts/scaling.sh and the like
+        std::cout << "Benchmark: ranks=" << MPINumRanks() << " zones=" << (long long) zones
+                  << " cycles=" << ncycles << " seconds=" << max_wall << " zone-cycles/s=" << zcps
+                  << " zone-cycles/s/rank=" << zcps / MPINumRanks() << std::endl;
+    }
+}
+
 void KHARMADriver::PostExecute(DriverStatus status)
 {
+    if (pmesh->packages.Get("Driver")->Param<bool>("benchmark"))
+        ReportBenchmark();
     Packages::PostExecute(pmesh, pinput, tm);
     EvolutionDriver::PostExecute(status);
 }
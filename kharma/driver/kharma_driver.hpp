@@ -59,9 +59,95 @@ class KHARMADriver : public MultiStageDriver {
 
         static std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages);
 
+        /**
+         * Name of the container holding the state at the end of a given stage.  With low_storage, every
+         * intermediate stage uses the first intermediate container, since that stage's old state is
+         * no longer needed once its flux divergence has been computed.
+         */
+        std::string StageName(int stage, bool low_storage) const
+        {
+            if (low_storage && stage > 1 && stage < integrator->nstages)
+                return integrator->stage_name[1];
+            return integrator->stage_name[stage];
+        }
+
         // Eliminate Parthenon's print statements when starting up the driver, we have a bunch of our own
         void PreExecute() override { timer_main.reset(); }
 
+        /**
+         * Driver package PreStepWork: sync benchmark, new block refresh and pack size tuning, if enabled
+         */
+        static void PreStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+
+        /**
+         * After a regrid, recover the primitives of every block new to this rank, apply floors & fixups
+         * and re-apply domain boundaries, over all of them at once.  Enabled with driver/refresh_new_blocks
+         */
+        static void RefreshNewBlocks(Mesh *pmesh);
+
+        /**
+         * The variables exchanged in each boundary sync, see driver/minimal_sync
+         */
+        static std::vector<std::string> GetSyncVars(Mesh *pmesh);
+
+        /**
+         * The variables of sync_vars to exchange again in the second sync (driver/two_sync).
+         * Face fields aren't modified after the first sync unless B is cleaned, so they're left out
+         */
+        static std::vector<std::string> GetResyncVars(Mesh *pmesh, const std::vector<std::string>& sync_vars,
+                                                      bool cleaned);
+
+        /**
+         * Time nsync boundary exchanges of the current state, and report the effective bandwidth
+         */
+        static void BenchmarkSync(Mesh *pmesh, int nsync);
+
+        /**
+         * Time the flux calculation & UtoP over a few candidate pack sizes, and report the fastest.
+         * Run before the first step and after any regrid which doubles or halves the local block count.
+         */
+        static void TunePackSize(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+
+        /**
+         * Name a tuning configuration in driver/autotune_file: device, reconstruction, block shape & local block count
+         */
+        static std::string PackSizeKey(ParameterInput *pin, int nblocks);
+        /**
+         * Look up the tuned pack size for a configuration, or -1 if it hasn't been tuned
+         */
+        static int CachedPackSize(const std::string &fname, const std::string &key);
+        /**
+         * Record the tuned pack size for a configuration, replacing any earlier result
+         */
+        static void StorePackSize(const std::string &fname, const std::string &key, int size);
+
+        /**
+         * Driver package PostStepWork: start the benchmark clock after warmup, and report metrics
+         */
+        static void PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+
+        /**
+         * Print (and optionally record) throughput metrics every ncycle_out steps, see driver/metrics
+         */
+        static void ReportMetrics(Mesh *pmesh, const SimTime &tm);
+
+        /**
+         * Print the steady-state throughput measured in benchmark mode, see driver/benchmark
+         */
+        void ReportBenchmark();
+
+        /**
+         * Parthenon's receive tasks, timed to measure the time ranks spend waiting on messages.
+         * Time accumulates in the Driver parameter "recv_time" when driver/metrics is enabled.
+         */
+        static TaskStatus ReceiveBoundBufsTimed(std::shared_ptr<MeshData<Real>> &md);
+        static TaskStatus ReceiveFluxCorrectionsTimed(std::shared_ptr<MeshData<Real>> &md);
+
+        /**
+         * Wall clock in seconds, for the metrics above
+         */
+        static double MetricsClock();
+
         // Also override the timestep calculation, so we can start moving options etc out of GRMHD package
         void SetGlobalTimeStep();
 
@@ -102,6 +188,12 @@ class KHARMADriver : public MultiStageDriver {
          */
         TaskCollection MakeImExTaskCollection(BlockList_t &blocks, int stage);
 
+        /**
+         * A cheap first-order step for relaxing initial conditions, run for the first driver/relax_steps steps
+         * in place of the default step.  Single forward-Euler stage, donor-cell reconstruction, normal-observer floors.
+         */
+        TaskCollection MakeRelaxTaskCollection(BlockList_t &blocks, int stage);
+
         /**
          * A simple step for experimentation/new implementations.  Does NOT support MPI, or much of anything optional.
          */
@@ -115,6 +207,12 @@ class KHARMADriver : public MultiStageDriver {
          */
         static TaskID AddFluxCalculations(TaskID& t_start, TaskList& tl, KReconstruction::Type recon, MeshData<Real> *md);
 
+        /**
+         * Add the flux divergence dUdt = -div(F), either with Parthenon's Update::FluxDivergence
+         * or fused with the geometric source term (flux/fused_geo_source)
+         */
+        static TaskID AddFluxDivergence(TaskID& t_start, TaskList& tl, MeshData<Real> *md, MeshData<Real> *mdudt);
+
         /**
          * Add a synchronization retion to an existing TaskCollection tc.
          * Since the region is self-contained, does not return a TaskID
@@ -186,4 +284,54 @@ class KHARMADriver : public MultiStageDriver {
             return TaskStatus::complete;
         }
 
+        /**
+         * The full stage update out = w1 * in1 + w2 * in2 + wdu * dudt, for cell-centered variables.
+         * Replaces a WeightedSumData call to average the sub-step and full-step states, followed by another
+         * to add the flux divergence, with a single pass.  out may be in1 (e.g. for low-storage stages)
+         */
+        static TaskStatus StageUpdate(const std::vector<MetadataFlag> &flags, MeshData<Real> *in1, MeshData<Real> *in2,
+                                      const Real w1, const Real w2, MeshData<Real> *dudt, const Real wdu, MeshData<Real> *out)
+        {
+            Kokkos::Profiling::pushRegion("Task_StageUpdate");
+            const auto &x = in1->PackVariables(flags);
+            const auto &y = in2->PackVariables(flags);
+            const auto &du = dudt->PackVariables(flags);
+            const auto &z = out->PackVariables(flags);
+            parthenon::par_for(
+                DEFAULT_LOOP_PATTERN, "StageUpdate", DevExecSpace(), 0, x.GetDim(5) - 1, 0,
+                x.GetDim(4) - 1, 0, x.GetDim(3) - 1, 0, x.GetDim(2) - 1, 0, x.GetDim(1) - 1,
+                KOKKOS_LAMBDA(const int b, const int l, const int k, const int j, const int i) {
+                    if (x.IsAllocated(b, l) && y.IsAllocated(b, l) && du.IsAllocated(b, l) && z.IsAllocated(b, l)) {
+                        z(b, l, k, j, i) = w1 * x(b, l, k, j, i) + w2 * y(b, l, k, j, i) + wdu * du(b, l, k, j, i);
+                    }
+                });
+            Kokkos::Profiling::popRegion(); // Task_StageUpdate
+            return TaskStatus::complete;
+        }
+
+        /**
+         * As StageUpdate, for face-centered variables
+         */
+        static TaskStatus StageUpdateFace(const std::vector<MetadataFlag> &flags, MeshData<Real> *in1, MeshData<Real> *in2,
+                                          const Real w1, const Real w2, MeshData<Real> *dudt, const Real wdu, MeshData<Real> *out)
+        {
+            Kokkos::Profiling::pushRegion("Task_StageUpdateFace");
+            const auto &x = in1->PackVariables(flags);
+            const auto &y = in2->PackVariables(flags);
+            const auto &du = dudt->PackVariables(flags);
+            const auto &z = out->PackVariables(flags);
+            parthenon::par_for(
+                DEFAULT_LOOP_PATTERN, "StageUpdateFace", DevExecSpace(), 0, x.GetDim(5) - 1, 0,
+                x.GetDim(4) - 1, 0, x.GetDim(3) - 1, 0, x.GetDim(2) - 1, 0, x.GetDim(1) - 1,
+                KOKKOS_LAMBDA(const int b, const int l, const int k, const int j, const int i) {
+                    if (x.IsAllocated(b, l) && y.IsAllocated(b, l) && du.IsAllocated(b, l) && z.IsAllocated(b, l)) {
+                        z(b, F1, l, k, j, i) = w1 * x(b, F1, l, k, j, i) + w2 * y(b, F1, l, k, j, i) + wdu * du(b, F1, l, k, j, i);
+                        z(b, F2, l, k, j, i) = w1 * x(b, F2, l, k, j, i) + w2 * y(b, F2, l, k, j, i) + wdu * du(b, F2, l, k, j, i);
+                        z(b, F3, l, k, j, i) = w1 * x(b, F3, l, k, j, i) + w2 * y(b, F3, l, k, j, i) + wdu * du(b, F3, l, k, j, i);
+                    }
+                });
+            Kokkos::Profiling::popRegion(); // Task_StageUpdateFace
+            return TaskStatus::complete;
+        }
+
 };
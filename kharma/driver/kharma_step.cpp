@@ -40,12 +40,15 @@
 #include "b_cleanup.hpp"
 #include "b_ct.hpp"
 #include "electrons.hpp"
+#include "emhd.hpp"
 #include "grmhd.hpp"
 #include "wind.hpp"
 // Other headers
 #include "boundaries.hpp"
+#include "float_halo.hpp"
 #include "flux.hpp"
 #include "kharma.hpp"
+#include "kharma_config.hpp"
 #include "implicit.hpp"
 #include "resize_restart.hpp"
 
@@ -58,6 +61,20 @@ TaskCollection KHARMADriver::MakeTaskCollection(BlockList_t &blocks, int stage)
     DriverType driver_type = blocks[0]->packages.Get("Driver")->Param<DriverType>("type");
     Flag("MakeTaskCollection");
     TaskCollection tc;
+
+    // Relax the initial conditions with a cheaper step, then switch to the chosen driver
+    const int relax_steps = blocks[0]->packages.Get("Driver")->Param<int>("relax_steps");
+    if (relax_steps > 0 && stage == 1 && pmesh->packages.AllPackages().count("Floors")) {
+        KHARMA::SetFloorsRelaxed(pmesh->packages, tm.ncycle < relax_steps);
+    }
+    if (tm.ncycle < relax_steps) {
+        tc = MakeRelaxTaskCollection(blocks, stage);
+        EndFlag();
+        return tc;
+    } else if (relax_steps > 0 && tm.ncycle == relax_steps && stage == 1 && MPIRank0()) {
+        std::cout << "Finished " << relax_steps << " relaxation steps, switching to "
+                  << blocks[0]->packages.Get("Driver")->Param<std::string>("name") << " driver" << std::endl;
+    }
     switch (driver_type) {
     case DriverType::kharma:
         tc = MakeDefaultTaskCollection(blocks, stage);
@@ -91,6 +108,26 @@ TaskCollection KHARMADriver::MakeDefaultTaskCollection(BlockList_t &blocks, int
     const bool use_b_ct = pkgs.count("B_CT");
     const bool use_electrons = pkgs.count("Electrons");
     const bool use_jcon = pkgs.count("Current");
+    // EMHD with explicit q/dP, see EMHD::SubcycleSources
+    const bool use_emhd_subcycle = pkgs.count("EMHD") && pkgs.at("EMHD")->Param<bool>("subcycle");
+    // Optionally apply floors in the UtoP kernel.  Only the GRMHD floors can be fused, and only
+    // when no other package needs its primitives filled by UtoP before floors are applied
+    const bool fuse_floors = pkgs.count("Inverter") && pkgs.count("Floors") &&
+                             pkgs.at("Inverter")->Param<bool>("fuse_floors") &&
+                             !use_electrons && !pkgs.count("EMHD");
+    // Optionally run the end-of-stage PtoU only where FixUtoP replaced primitives, see Flux::MeshPtoU.
+    // Electron heating & primitive-variable sources change P everywhere, requiring the full PtoU
+    bool has_prim_source = false;
+    for (auto kpackage : pmesh->packages.AllPackagesOfType<KHARMAPackage>())
+        has_prim_source |= (kpackage.second->MeshApplyPrimSource != nullptr ||
+                            kpackage.second->BlockApplyPrimSource != nullptr);
+    const bool ptou_changed_only = pkgs.at("Flux")->Param<bool>("ptou_changed_only") &&
+                                   pkgs.count("Inverter") && !use_electrons && !pkgs.count("EMHD") &&
+                                   !(stage == integrator->nstages && has_prim_source);
+    // Optionally keep the final four-vectors of each stage, see GRMHD::FillFourVectors
+    const bool cache_4vecs = pkgs.at("GRMHD")->Param<bool>("cache_4vecs");
+    // Reuse one container for the intermediate stages of 3+ stage integrators, see StageName
+    const bool low_storage = driver_pkg.Get<bool>("low_storage") && !use_electrons;
 
     // Allocate/copy the things we need
     // TODO these can now be reduced by including the var lists/flags which actually need to be allocated
@@ -100,9 +137,11 @@ TaskCollection KHARMADriver::MakeDefaultTaskCollection(BlockList_t &blocks, int
         // Fluxes
         pmesh->mesh_data.Add("dUdt");
         for (int i = 1; i < integrator->nstages; i++)
-            pmesh->mesh_data.Add(integrator->stage_name[i]);
+            if (StageName(i, low_storage) == integrator->stage_name[i])
+                pmesh->mesh_data.Add(integrator->stage_name[i]);
         // Preserve state for time derivatives if we need to output current
-        if (use_jcon) {
+        // Only on steps which end in an output of jcon, see Current::PreStepWork
+        if (use_jcon && pkgs.at("Current")->Param<bool>("preserve_this_step")) {
             pmesh->mesh_data.Add("preserve");
             // Above only copies on allocate -- ensure we copy every step
             Copy<MeshData<Real>>({Metadata::Cell}, base.get(), pmesh->mesh_data.Get("preserve").get());
@@ -113,13 +152,7 @@ TaskCollection KHARMADriver::MakeDefaultTaskCollection(BlockList_t &blocks, int
 
     static std::vector<std::string> sync_vars;
     if (sync_vars.size() == 0) {
-        // Build the universe of variables to let Parthenon see when exchanging boundaries.
-        // This is built to exclude incidental variables like B field initialization stuff, EMFs, etc.
-        // "Boundaries" packs in buffers e.g. Dirichlet boundaries
-        using FC = Metadata::FlagCollection;
-        auto sync_flags = FC({Metadata::GetUserFlag("Primitive"), Metadata::Conserved,
-                              Metadata::Face, Metadata::GetUserFlag("Boundaries")}, true);
-        sync_vars = KHARMA::GetVariableNames(&(pmesh->packages), sync_flags);
+        sync_vars = KHARMADriver::GetSyncVars(pmesh);
     }
 
     // Flux region: calculate and apply fluxes to update conserved values
@@ -133,14 +166,15 @@ TaskCollection KHARMADriver::MakeDefaultTaskCollection(BlockList_t &blocks, int
         // '_sub_step_final' refers to the fluid state at the end of the sub step (Sf in iharm3d)
         // '_flux_src' refers to the mesh object corresponding to -divF + S
         auto &md_full_step_init = pmesh->mesh_data.GetOrAdd("base", i);
-        auto &md_sub_step_init  = pmesh->mesh_data.GetOrAdd(integrator->stage_name[stage - 1], i);
-        auto &md_sub_step_final = pmesh->mesh_data.GetOrAdd(integrator->stage_name[stage], i);
+        auto &md_sub_step_init  = pmesh->mesh_data.GetOrAdd(StageName(stage - 1, low_storage), i);
+        auto &md_sub_step_final = pmesh->mesh_data.GetOrAdd(StageName(stage, low_storage), i);
         auto &md_flux_src       = pmesh->mesh_data.GetOrAdd("dUdt", i);
         // TODO this doesn't work still for some reason, even if the shallow copy has all variables
-        auto &md_sync = pmesh->mesh_data.AddShallow("sync"+integrator->stage_name[stage]+std::to_string(i), md_sub_step_final, sync_vars);
+        auto &md_sync = pmesh->mesh_data.AddShallow("sync"+StageName(stage, low_storage)+std::to_string(i), md_sub_step_final, sync_vars);
 
         // Start receiving flux corrections and ghost cells
-        auto t_start_recv_bound = tl.AddTask(t_none, parthenon::StartReceiveBoundBufs<parthenon::BoundaryType::any>, md_sync);
+        auto t_start_recv_bound = tl.AddTask(t_none, parthenon::StartReceiveBoundBufs<parthenon::BoundaryType::any>,
+                                              FloatHalo::ExchangeData(md_sync));
         auto t_start_recv_flux = t_start_recv_bound;
         if (pmesh->multilevel || use_b_ct)
             t_start_recv_flux = tl.AddTask(t_none, parthenon::StartReceiveFluxCorrections, md_sub_step_init);
@@ -159,6 +193,12 @@ TaskCollection KHARMADriver::MakeDefaultTaskCollection(BlockList_t &blocks, int
 
         // If we're in AMR, correct fluxes from neighbors
         auto t_flux_bounds = t_fix_flux;
+        // Optionally start the divergence away from block faces while corrections are in flight
+        const bool overlap_flux_comm = (pmesh->multilevel || use_b_ct) &&
+                                       pkgs.at("Flux")->Param<bool>("overlap_flux_comm");
+        auto t_flux_div_interior = t_none;
+        if (overlap_flux_comm)
+            t_flux_div_interior = tl.AddTask(t_fix_flux, Flux::FluxDivergenceInterior, md_sub_step_init.get(), md_flux_src.get());
         if (pmesh->multilevel || use_b_ct) {
             auto t_emf = t_flux_bounds;
             if (use_b_ct) {
@@ -168,53 +208,55 @@ TaskCollection KHARMADriver::MakeDefaultTaskCollection(BlockList_t &blocks, int
                 t_emf = KHARMADriver::AddBoundarySync(t_emf_local, tl, md_emf_only);
             }
             auto t_load_send_flux = tl.AddTask(t_emf, parthenon::LoadAndSendFluxCorrections, md_sub_step_init);
-            auto t_recv_flux = tl.AddTask(t_load_send_flux, parthenon::ReceiveFluxCorrections, md_sub_step_init);
+            auto t_recv_flux = tl.AddTask(t_load_send_flux, KHARMADriver::ReceiveFluxCorrectionsTimed, md_sub_step_init);
             t_flux_bounds = tl.AddTask(t_recv_flux, parthenon::SetFluxCorrections, md_sub_step_init);
         }
 
         // Apply the fluxes to calculate a change in cell-centered values "md_flux_src"
-        auto t_flux_div = tl.AddTask(t_flux_bounds, Update::FluxDivergence<MeshData<Real>>, md_sub_step_init.get(), md_flux_src.get());
+        auto t_flux_div = t_none;
+        if (overlap_flux_comm) {
+            t_flux_div = tl.AddTask(t_flux_bounds | t_flux_div_interior, Flux::FluxDivergenceBoundary,
+                                    md_sub_step_init.get(), md_flux_src.get());
+        } else {
+            t_flux_div = KHARMADriver::AddFluxDivergence(t_flux_bounds, tl, md_sub_step_init.get(), md_flux_src.get());
+        }
 
         // Add any source terms: geometric \Gamma * T, wind, damping, etc etc
         // Also where CT sets the change in face fields
         auto t_sources = tl.AddTask(t_flux_div, Packages::AddSource, md_sub_step_init.get(), md_flux_src.get());
 
         // Perform the update using the source term
-        // Add any proportion of the step start required by the integrator (e.g., RK2)
-        // TODO splitting this is stupid, dig into Parthenon & fix
-        auto t_avg_data_c = tl.AddTask(t_sources, Update::WeightedSumData<std::vector<MetadataFlag>, MeshData<Real>>,
+        // Add any proportion of the step start required by the integrator (e.g., RK2), in the same pass
+        auto t_update_c = tl.AddTask(t_sources, StageUpdate,
                                     std::vector<MetadataFlag>({Metadata::Independent, Metadata::Cell}),
                                     md_sub_step_init.get(), md_full_step_init.get(),
                                     integrator->gam0[stage-1], integrator->gam1[stage-1],
+                                    md_flux_src.get(), integrator->beta[stage-1] * integrator->dt,
                                     md_sub_step_final.get());
-        auto t_avg_data = t_avg_data_c;
+        auto t_update = t_update_c;
         if (use_b_ct) {
-            t_avg_data = tl.AddTask(t_avg_data_c, WeightedSumDataFace,
+            t_update = tl.AddTask(t_update_c, StageUpdateFace,
                                     std::vector<MetadataFlag>({Metadata::Independent, Metadata::Face}),
                                     md_sub_step_init.get(), md_full_step_init.get(),
                                     integrator->gam0[stage-1], integrator->gam1[stage-1],
+                                    md_flux_src.get(), integrator->beta[stage-1] * integrator->dt,
                                     md_sub_step_final.get());
         }
-        // apply du/dt to the result
-        auto t_update_c = tl.AddTask(t_avg_data, Update::WeightedSumData<std::vector<MetadataFlag>, MeshData<Real>>,
-                                    std::vector<MetadataFlag>({Metadata::Independent, Metadata::Cell}),
-                                    md_sub_step_final.get(), md_flux_src.get(),
-                                    1.0, integrator->beta[stage-1] * integrator->dt,
-                                    md_sub_step_final.get());
-        auto t_update = t_update_c;
-        if (use_b_ct) {
-            t_update = tl.AddTask(t_update_c, WeightedSumDataFace,
-                                    std::vector<MetadataFlag>({Metadata::Independent, Metadata::Face}),
-                                    md_sub_step_final.get(), md_flux_src.get(),
-                                    1.0, integrator->beta[stage-1] * integrator->dt,
-                                    md_sub_step_final.get());
+        // Average conserved variables around the poles in X3, if enabled
+        if (pkgs.at("GRMHD")->Param<int>("pole_average_zones") > 0) {
+            t_update = tl.AddTask(t_update, GRMHD::AveragePoles, md_sub_step_final.get());
+        }
+        // As in the ImEx driver, the fluid inversion must not see the EMHD stress-energy
+        if (use_emhd_subcycle) {
+            t_update = tl.AddTask(t_update, EMHD::SubtractStress, md_sub_step_final.get(), md_sub_step_init.get());
         }
 
         // UtoP needs a guess in order to converge, so we copy in sc0
         // (but only the fluid primitives!)  Copying and syncing ensures that solves of the same zone
         // on adjacent ranks are seeded with the same value, which keeps them (more) similar
         auto t_copy_prims = t_update;
-        if (integrator->nstages > 1) {
+        // With low_storage, intermediate stages are updated in place and already hold the guess
+        if (integrator->nstages > 1 && md_sub_step_init != md_sub_step_final) {
             t_copy_prims = tl.AddTask(t_none, Copy<MeshData<Real>>, std::vector<MetadataFlag>({Metadata::GetUserFlag("HD"), Metadata::GetUserFlag("Primitive")}),
                                                 md_sub_step_init.get(), md_sub_step_final.get());
         }
@@ -225,13 +267,20 @@ TaskCollection KHARMADriver::MakeDefaultTaskCollection(BlockList_t &blocks, int
     EndFlag();
     Flag("MakeTaskCollection::fixes");
 
+    // Time elapsed between the step start and the end of this stage, for EMHD time derivatives.
+    // Each stage's state sits at gam0 * (the last stage's time) + beta * dt
+    Real stage_dt_since_init = 0.;
+    for (int s = 0; s < stage; ++s)
+        stage_dt_since_init = integrator->gam0[s] * stage_dt_since_init + integrator->beta[s] * integrator->dt;
+
     // Fix Region: prims/cons sync, floors, fixes, boundary conditions which need primitives
     TaskRegion &fix_region = tc.AddRegion(num_partitions);
     for (int i = 0; i < num_partitions; i++) {
         auto &tl = fix_region[i];
-        auto &md_sub_step_init  = pmesh->mesh_data.GetOrAdd(integrator->stage_name[stage-1], i);
-        auto &md_sub_step_final = pmesh->mesh_data.GetOrAdd(integrator->stage_name[stage], i);
-        auto &md_sync = pmesh->mesh_data.AddShallow("sync"+integrator->stage_name[stage]+std::to_string(i), md_sub_step_final, sync_vars);
+        auto &md_full_step_init = pmesh->mesh_data.GetOrAdd("base", i);
+        auto &md_sub_step_init  = pmesh->mesh_data.GetOrAdd(StageName(stage - 1, low_storage), i);
+        auto &md_sub_step_final = pmesh->mesh_data.GetOrAdd(StageName(stage, low_storage), i);
+        auto &md_sync = pmesh->mesh_data.AddShallow("sync"+StageName(stage, low_storage)+std::to_string(i), md_sub_step_final, sync_vars);
 
         // At this point, we've sync'd all internal boundaries using the conserved
         // variables. The physical boundaries (pole, inner/outer) are trickier,
@@ -243,23 +292,34 @@ TaskCollection KHARMADriver::MakeDefaultTaskCollection(BlockList_t &blocks, int
         // This relies on the primitives being calculated identically in MPI boundaries, vs their corresponding
         // physical zones in the adjacent mesh block.  To ensure this, we seed the solver with the same values
         // in each case, by synchronizing them along with the conserved values above.
-        auto t_utop = tl.AddTask(t_none, Packages::MeshUtoP, md_sub_step_final.get(), IndexDomain::entire, false);
-        // As soon as we have primitive variables, apply floors
-        auto t_floors = tl.AddTask(t_utop, Packages::MeshApplyFloors, md_sub_step_final.get(), IndexDomain::entire);
+        // As soon as we have primitive variables, apply floors, either separately or within UtoP
+        TaskID t_floors;
+        if (fuse_floors) {
+            t_floors = tl.AddTask(t_none, Packages::MeshUtoPFloors, md_sub_step_final.get(), IndexDomain::entire, false);
+        } else {
+            auto t_utop = tl.AddTask(t_none, Packages::MeshUtoP, md_sub_step_final.get(), IndexDomain::entire, false);
+            t_floors = tl.AddTask(t_utop, Packages::MeshApplyFloors, md_sub_step_final.get(), IndexDomain::entire);
+        }
 
         // Then, fix any inversions which failed. Fixups average the adjacent zones, so we want to work from
         // post-floor data. Floors are re-applied after fixups.
         auto t_fix_p = tl.AddTask(t_floors, Inverter::MeshFixUtoP, md_sub_step_final.get());
 
+        // With corrected fluid primitives, relax the EMHD scalars over the stage
+        if (use_emhd_subcycle) {
+            t_fix_p = tl.AddTask(t_fix_p, EMHD::SubcycleSources, md_full_step_init.get(), md_sub_step_final.get(),
+                                 integrator->beta[stage-1] * integrator->dt, stage_dt_since_init);
+        }
+
         // Domain (non-internal) boundary conditions:
-        // This is a parthenon call, but in spherical coordinates it will call the KHARMA functions in
-        // boundaries.cpp, which apply physical boundary conditions based on the primitive variables of GRHD,
+        // This replaces Parthenon's call, applying KHARMA's boundary fixups over all blocks at once (see
+        // KBoundaries::ApplyBoundariesMD).  Like the per-block functions in boundaries.cpp, it will apply physical boundary conditions based on the primitive variables of GRHD,
         // and based on the conserved forms for everything else.  Note that because this is called *after*
         // UtoP (since it needs bulk fluid primitives to apply GRMHD boundaries), this function
         // must call UtoP *again* (for everything except the GRHD variables) to fill P in the ghost zones.
         // This is why KHARMA packages need to implement their UtoP functions in the form
         // UtoP(rc, domain, coarse): so that they can be run over just the boundary domains here.
-        auto t_set_bc = tl.AddTask(t_fix_p, parthenon::ApplyBoundaryConditionsOnCoarseOrFineMD, md_sync, false);
+        auto t_set_bc = tl.AddTask(t_fix_p, KBoundaries::ApplyBoundariesMD, md_sync, false);
 
         // Add primitive-variable source terms:
         // In order to calculate dissipation, we must know the entropy at the beginning and end of the substep,
@@ -283,9 +343,13 @@ TaskCollection KHARMADriver::MakeDefaultTaskCollection(BlockList_t &blocks, int
         }
 
         // Make sure *all* conserved vars are synchronized at step end
-        auto t_ptou = tl.AddTask(t_heat_electrons, Flux::MeshPtoU, md_sub_step_final.get(), IndexDomain::entire, false);
+        auto t_ptou = tl.AddTask(t_heat_electrons, Flux::MeshPtoU, md_sub_step_final.get(), IndexDomain::entire, false,
+                                 ptou_changed_only);
 
         auto t_step_done = t_ptou;
+        if (cache_4vecs) {
+            t_step_done = tl.AddTask(t_ptou, GRMHD::FillFourVectors, md_sub_step_final.get());
+        }
 
         // Estimate next time step based on ctop
         if (stage == integrator->nstages) {
@@ -297,6 +361,12 @@ TaskCollection KHARMADriver::MakeDefaultTaskCollection(BlockList_t &blocks, int
                 auto tag_refine = tl.AddTask(
                     t_step_done, parthenon::Refinement::Tag<MeshData<Real>>, md_sub_step_final.get());
             }
+
+            // Free electron temperatures on blocks where heating zeroed them everywhere.
+            // Blocks re-allocate them when nonzero ghost data arrives from a neighbor
+            if (use_electrons && pkgs.at("Electrons")->Param<bool>("sparse")) {
+                auto t_dealloc = tl.AddTask(t_step_done, parthenon::SparseDealloc, md_sub_step_final.get());
+            }
         }
     }
 
@@ -308,8 +378,12 @@ TaskCollection KHARMADriver::MakeDefaultTaskCollection(BlockList_t &blocks, int
     if (use_b_cleanup && (stage == integrator->nstages) && B_Cleanup::CleanupThisStep(pmesh, tm.ncycle)) {
         TaskRegion &cleanup_region = tc.AddRegion(1);
         auto &tl = cleanup_region[0];
-        auto &md_sub_step_final = pmesh->mesh_data.Get(integrator->stage_name[stage]);
-        tl.AddTask(t_none, B_Cleanup::CleanupDivergence, md_sub_step_final);
+        auto &md_sub_step_final = pmesh->mesh_data.Get(StageName(stage, low_storage));
+        auto t_cleanup = tl.AddTask(t_none, B_Cleanup::CleanupDivergence, md_sub_step_final);
+        // Cleanup recomputes the primitive field
+        if (cache_4vecs) {
+            tl.AddTask(t_cleanup, GRMHD::FillFourVectors, md_sub_step_final.get());
+        }
     }
 
     // TODO TODO make faster for large num_partitions, also this should be shared whole between drivers
@@ -317,11 +391,15 @@ TaskCollection KHARMADriver::MakeDefaultTaskCollection(BlockList_t &blocks, int
     // ensure that primitive variables in ghost zones are *exactly*
     // identical to their physical counterparts, now that they have been
     // modified on each rank.
+    // Face fields are left out unless they were just cleaned, see GetResyncVars
     const auto &two_sync = pkgs.at("Driver")->Param<bool>("two_sync");
     if (two_sync) {
+        const bool cleaned = use_b_cleanup && (stage == integrator->nstages) && B_Cleanup::CleanupThisStep(pmesh, tm.ncycle);
+        const auto resync_vars = KHARMADriver::GetResyncVars(pmesh, sync_vars, cleaned);
+        const std::string resync_name = (resync_vars.size() == sync_vars.size()) ? "sync" : "resync";
         for (int i = 0; i < num_partitions; i++) {
-            auto &md_sub_step_final = pmesh->mesh_data.GetOrAdd(integrator->stage_name[stage], i);
-            auto &md_sync = pmesh->mesh_data.AddShallow("sync"+integrator->stage_name[stage]+std::to_string(i), md_sub_step_final, sync_vars);
+            auto &md_sub_step_final = pmesh->mesh_data.GetOrAdd(StageName(stage, low_storage), i);
+            auto &md_sync = pmesh->mesh_data.AddShallow(resync_name+StageName(stage, low_storage)+std::to_string(i), md_sub_step_final, resync_vars);
             KHARMADriver::AddFullSyncRegion(tc, md_sync);
         }
     }
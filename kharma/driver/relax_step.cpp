@@ -0,0 +1,162 @@
+/* 
+ *  File: relax_step.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "kharma_driver.hpp"
+
+// Packages
+#include "b_ct.hpp"
+#include "floors.hpp"
+#include "grmhd.hpp"
+#include "inverter.hpp"
+// Other headers
+#include "boundaries.hpp"
+#include "float_halo.hpp"
+#include "flux.hpp"
+#include "kharma.hpp"
+
+#include <parthenon/parthenon.hpp>
+#include <interface/update.hpp>
+#include <amr_criteria/refinement_package.hpp>
+
+TaskCollection KHARMADriver::MakeRelaxTaskCollection(BlockList_t &blocks, int stage)
+{
+    // A cheap step for relaxing initial conditions: a single forward-Euler update with donor-cell
+    // reconstruction, written back into the "base" state.  The integrator's later stages are empty.
+    // Otherwise this follows MakeDefaultTaskCollection; see there for details of each task.
+    TaskCollection tc;
+    const TaskID t_none(0);
+    if (stage > 1) return tc;
+
+    auto& pkgs = pmesh->packages.AllPackages();
+    const bool use_b_ct = pkgs.count("B_CT");
+    const bool use_jcon = pkgs.count("Current");
+
+    pmesh->mesh_data.Add("dUdt");
+    if (use_jcon && pkgs.at("Current")->Param<bool>("preserve_this_step")) {
+        pmesh->mesh_data.Add("preserve");
+        Copy<MeshData<Real>>({Metadata::Cell}, pmesh->mesh_data.Get().get(), pmesh->mesh_data.Get("preserve").get());
+    }
+
+    static std::vector<std::string> sync_vars;
+    if (sync_vars.size() == 0) {
+        sync_vars = KHARMADriver::GetSyncVars(pmesh);
+    }
+
+    // Flux region: calculate -divF + S only.  The update happens in place, so it must wait until
+    // every block has read its ghost zones, i.e. until the next region
+    const int num_partitions = pmesh->DefaultNumPartitions();
+    TaskRegion &flux_region = tc.AddRegion(num_partitions);
+    for (int i = 0; i < num_partitions; i++) {
+        auto &tl = flux_region[i];
+        auto &md_base     = pmesh->mesh_data.GetOrAdd("base", i);
+        auto &md_flux_src = pmesh->mesh_data.GetOrAdd("dUdt", i);
+
+        auto t_start_recv_flux = t_none;
+        if (pmesh->multilevel || use_b_ct)
+            t_start_recv_flux = tl.AddTask(t_none, parthenon::StartReceiveFluxCorrections, md_base);
+
+        auto t_fluxes = KHARMADriver::AddFluxCalculations(t_start_recv_flux, tl, KReconstruction::Type::donor_cell, md_base.get());
+        auto t_fix_flux = tl.AddTask(t_fluxes, Packages::FixFlux, md_base.get());
+
+        auto t_flux_bounds = t_fix_flux;
+        if (pmesh->multilevel || use_b_ct) {
+            auto t_emf = t_flux_bounds;
+            if (use_b_ct) {
+                auto &md_emf_only = pmesh->mesh_data.AddShallow("EMF", std::vector<std::string>{"B_CT.emf"});
+                auto t_emf_local = tl.AddTask(t_flux_bounds, B_CT::CalculateEMF, md_base.get());
+                t_emf = KHARMADriver::AddBoundarySync(t_emf_local, tl, md_emf_only);
+            }
+            auto t_load_send_flux = tl.AddTask(t_emf, parthenon::LoadAndSendFluxCorrections, md_base);
+            auto t_recv_flux = tl.AddTask(t_load_send_flux, KHARMADriver::ReceiveFluxCorrectionsTimed, md_base);
+            t_flux_bounds = tl.AddTask(t_recv_flux, parthenon::SetFluxCorrections, md_base);
+        }
+
+        auto t_flux_div = KHARMADriver::AddFluxDivergence(t_flux_bounds, tl, md_base.get(), md_flux_src.get());
+        tl.AddTask(t_flux_div, Packages::AddSource, md_base.get(), md_flux_src.get());
+    }
+
+    // Update region: U += dt * dU/dt, then sync
+    TaskRegion &update_region = tc.AddRegion(num_partitions);
+    for (int i = 0; i < num_partitions; i++) {
+        auto &tl = update_region[i];
+        auto &md_base     = pmesh->mesh_data.GetOrAdd("base", i);
+        auto &md_flux_src = pmesh->mesh_data.GetOrAdd("dUdt", i);
+        auto &md_sync = pmesh->mesh_data.AddShallow("syncrelax"+std::to_string(i), md_base, sync_vars);
+
+        auto t_start_recv_bound = tl.AddTask(t_none, parthenon::StartReceiveBoundBufs<parthenon::BoundaryType::any>,
+                                              FloatHalo::ExchangeData(md_sync));
+        auto t_update = tl.AddTask(t_start_recv_bound, StageUpdate, std::vector<MetadataFlag>({Metadata::Independent, Metadata::Cell}),
+                                   md_base.get(), md_base.get(), 1.0, 0.0, md_flux_src.get(), integrator->dt, md_base.get());
+        if (use_b_ct) {
+            t_update = tl.AddTask(t_update, StageUpdateFace, std::vector<MetadataFlag>({Metadata::Independent, Metadata::Face}),
+                                  md_base.get(), md_base.get(), 1.0, 0.0, md_flux_src.get(), integrator->dt, md_base.get());
+        }
+        if (pkgs.at("GRMHD")->Param<int>("pole_average_zones") > 0) {
+            t_update = tl.AddTask(t_update, GRMHD::AveragePoles, md_base.get());
+        }
+        KHARMADriver::AddBoundarySync(t_update, tl, md_sync);
+    }
+
+    // Fix region: recover primitives, floors, fixes, boundaries, new timestep.
+    // Electron heating is skipped, as it needs the state at both ends of the step
+    TaskRegion &fix_region = tc.AddRegion(num_partitions);
+    for (int i = 0; i < num_partitions; i++) {
+        auto &tl = fix_region[i];
+        auto &md_base = pmesh->mesh_data.GetOrAdd("base", i);
+        auto &md_sync = pmesh->mesh_data.AddShallow("syncrelax"+std::to_string(i), md_base, sync_vars);
+
+        auto t_utop = tl.AddTask(t_none, Packages::MeshUtoP, md_base.get(), IndexDomain::entire, false);
+        auto t_floors = tl.AddTask(t_utop, Packages::MeshApplyFloors, md_base.get(), IndexDomain::entire);
+        auto t_fix_p = tl.AddTask(t_floors, Inverter::MeshFixUtoP, md_base.get());
+        auto t_set_bc = tl.AddTask(t_fix_p, KBoundaries::ApplyBoundariesMD, md_sync, false);
+        auto t_prim_source = tl.AddTask(t_set_bc, Packages::MeshApplyPrimSource, md_base.get());
+        auto t_ptou = tl.AddTask(t_prim_source, Flux::MeshPtoU, md_base.get(), IndexDomain::entire, false, false);
+        // Keep any cached four-vectors current for the step which follows, see GRMHD::FillFourVectors
+        tl.AddTask(t_ptou, GRMHD::FillFourVectors, md_base.get());
+
+        tl.AddTask(t_ptou, Update::EstimateTimestep<MeshData<Real>>, md_base.get());
+        if (pmesh->adaptive) {
+            tl.AddTask(t_ptou, parthenon::Refinement::Tag<MeshData<Real>>, md_base.get());
+        }
+    }
+
+    if (pkgs.at("Driver")->Param<bool>("two_sync")) {
+        for (int i = 0; i < num_partitions; i++) {
+            auto &md_base = pmesh->mesh_data.GetOrAdd("base", i);
+            auto &md_sync = pmesh->mesh_data.AddShallow("syncrelax"+std::to_string(i), md_base, sync_vars);
+            KHARMADriver::AddFullSyncRegion(tc, md_sync);
+        }
+    }
+
+    return tc;
+}
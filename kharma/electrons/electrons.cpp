@@ -54,6 +54,69 @@ using namespace parthenon;
 namespace Electrons
 {
 
+/**
+ * Electron heating fractions for the models which depend on the electron temperature,
+ * as functions of the temperature ratio Tp/Te and plasma beta
+ */
+KOKKOS_INLINE_FUNCTION Real fel_howes(const Real& Trat, const Real& beta)
+{
+    const Real logTrat = log10(Trat);
+    const Real mbeta = 2. - 0.2*logTrat;
+
+    const Real c2 = (Trat <= 1.) ? 1.6/Trat : 1.2/Trat;
+    const Real c3 = (Trat <= 1.) ? 18. + 5.*logTrat : 18.;
+
+    const Real beta_pow = m::pow(beta, mbeta);
+    const Real qrat = 0.92 * (c2*c2 + beta_pow)/(c3*c3 + beta_pow) * m::exp(-1./beta) * m::sqrt(MP/ME * Trat);
+    return 1./(1. + qrat);
+}
+KOKKOS_INLINE_FUNCTION Real fel_kawazura(const Real& Trat, const Real& beta)
+{
+    // Equation (2) in http://www.pnas.org/lookup/doi/10.1073/pnas.1812491116
+    const Real QiQe = 35. / (1. + m::pow(beta/15., -1.4) * m::exp(-0.1 / Trat));
+    return 1./(1. + QiQe);
+}
+KOKKOS_INLINE_FUNCTION Real fel_sharma(const Real& Trat, const Real& beta)
+{
+    // Equation for \delta on  pg. 719 (Section 4) in https://iopscience.iop.org/article/10.1086/520800
+    const Real QeQi = 0.33 * m::sqrt(1. / Trat);
+    return 1./(1.+1./QeQi);
+}
+
+/**
+ * Heat one electron entropy implicitly, i.e. with the heating fraction evaluated at the *new* electron temperature:
+ * solve kel = kel_adv + fel(Tp/Te(kel)) * diss by a few Newton iterations, starting from the explicit value.
+ * This avoids the step-to-step oscillation of the explicit update when fel depends steeply on Te.
+ */
+enum class TeModel{howes, kawazura, sharma};
+template<TeModel model>
+KOKKOS_INLINE_FUNCTION Real heat_kel_implicit(const Real& kel_adv, const Real& kel_old, const Real& diss,
+                                              const Real& rho_fac, const Real& Tpr, const Real& beta,
+                                              const Real& kel_min, const Real& kel_max, const int& iters)
+{
+    // rho_fac = rho^(game-1), the factor from kel to Te
+    auto fel_of = [&](const Real& kel) {
+        const Real Tel = m::max(kel * rho_fac, SMALL);
+        if constexpr (model == TeModel::howes) {
+            return fel_howes(Tpr / Tel, beta);
+        } else if constexpr (model == TeModel::kawazura) {
+            return fel_kawazura(Tpr / Tel, beta);
+        } else {
+            return fel_sharma(Tpr / Tel, beta);
+        }
+    };
+    // Explicit solution as a guess
+    Real kel = clip(kel_adv + fel_of(kel_old) * diss, kel_min, kel_max);
+    for (int it = 0; it < iters; ++it) {
+        const Real res  = kel - kel_adv - fel_of(kel) * diss;
+        const Real dkel = 1.e-6 * m::max(m::abs(kel), SMALL);
+        const Real dres = 1. - (fel_of(kel + dkel) - fel_of(kel)) * diss / dkel;
+        if (m::abs(dres) < SMALL) break;
+        kel = clip(kel - res / dres, kel_min, kel_max);
+    }
+    return kel;
+}
+
 std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages)
 {
     auto pkg = std::make_shared<KHARMAPackage>("Electrons");
@@ -116,12 +179,37 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
         }
     }
 
+    // Heat electrons using the heating fraction at the end-of-step electron temperature, for the
+    // models where it depends on Te (Howes, Kawazura, Sharma).  This is a cheap per-zone Newton solve
+    // in the heating step, independent of the driver, rather than implicit evolution of the entropies
+    bool implicit_heating = pin->GetOrAddBoolean("electrons", "implicit_heating", false);
+    params.Add("implicit_heating", implicit_heating);
+    int implicit_heating_iters = pin->GetOrAddInteger("electrons", "implicit_heating_iters", 3);
+    params.Add("implicit_heating_iters", implicit_heating_iters);
+
     // Evolving e- implicitly is not tested.  Shouldn't be necessary even in EMHD
     auto& driver = packages->Get("Driver")->AllParams();
     auto driver_type = driver.Get<DriverType>("type");
     bool implicit_e = (driver_type == DriverType::imex && pin->GetOrAddBoolean("electrons", "implicit", false));
     params.Add("implicit", implicit_e);
 
+    // Allocate the model electron entropies (not Ktot) as Parthenon sparse fields.  Zones above
+    // sparse_sigma have their entropies zeroed when heating, so blocks entirely in e.g. the funnel
+    // deallocate them, and neither store nor communicate them until nonzero values arrive in their ghost zones.
+    // Entropies which are zero or newly allocated are then reset to the fel_0 fraction, as at initialization.
+    // In this mode the fields are named by model number instead, prims.Kel_0 (Constant) to prims.Kel_5 (Sharma)
+    bool sparse = pin->GetOrAddBoolean("electrons", "sparse", false);
+    params.Add("sparse", sparse);
+    Real sparse_sigma = pin->GetOrAddReal("electrons", "sparse_sigma", 10.);
+    params.Add("sparse_sigma", sparse_sigma);
+    if (sparse) {
+        // The implicit solver and Parthenon's donor-cell reconstruction assume every variable is allocated
+        if (driver_type != DriverType::kharma)
+            throw std::invalid_argument("Sparse electrons are only supported with the KHARMA driver!");
+        if (pin->GetString("driver", "reconstruction") == "donor_cell")
+            throw std::invalid_argument("Sparse electrons are not supported with donor-cell reconstruction!");
+    }
+
     Metadata::AddUserFlag("Elec");
     MetadataFlag areWeImplicit = (implicit_e) ? Metadata::GetUserFlag("Implicit")
                                               : Metadata::GetUserFlag("Explicit");
@@ -137,6 +225,17 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
     pkg->AddField("cons.Ktot", flags_cons);
     pkg->AddField("prims.Ktot", flags_prim);
 
+    // Sparse pools of the model entropies, numbered in the order below
+    std::vector<int> sparse_ids;
+    auto add_model = [&](const std::string& name, const int id) {
+        if (sparse) {
+            sparse_ids.push_back(id);
+        } else {
+            pkg->AddField("cons.Kel_" + name, flags_cons);
+            pkg->AddField("prims.Kel_" + name, flags_prim);
+        }
+    };
+
     // Individual models
     // TO ADD A MODEL:
     // 1. Define fields here
@@ -145,33 +244,38 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
     // 4. Add heating model in ApplyElectronHeating, below
     if (do_constant) {
         nKs += 1;
-        pkg->AddField("cons.Kel_Constant", flags_cons);
-        pkg->AddField("prims.Kel_Constant", flags_prim);
+        add_model("Constant", 0);
     }
     if (do_howes) {
         nKs += 1;
-        pkg->AddField("cons.Kel_Howes", flags_cons);
-        pkg->AddField("prims.Kel_Howes", flags_prim);
+        add_model("Howes", 1);
     }
     if (do_kawazura) {
         nKs += 1;
-        pkg->AddField("cons.Kel_Kawazura", flags_cons);
-        pkg->AddField("prims.Kel_Kawazura", flags_prim);
+        add_model("Kawazura", 2);
     }
     if (do_werner) {
         nKs += 1;
-        pkg->AddField("cons.Kel_Werner", flags_cons);
-        pkg->AddField("prims.Kel_Werner", flags_prim);
+        add_model("Werner", 3);
     }
     if (do_rowan) {
         nKs += 1;
-        pkg->AddField("cons.Kel_Rowan", flags_cons);
-        pkg->AddField("prims.Kel_Rowan", flags_prim);
+        add_model("Rowan", 4);
     }
     if (do_sharma) {
         nKs += 1;
-        pkg->AddField("cons.Kel_Sharma", flags_cons);
-        pkg->AddField("prims.Kel_Sharma", flags_prim);
+        add_model("Sharma", 5);
+    }
+    if (sparse_ids.size() > 0) {
+        // Allocate on any nonzero value, deallocate once a block is entirely zero.
+        // Primitives follow the allocation of the conserved entropies
+        flags_cons.push_back(Metadata::Sparse);
+        flags_prim.push_back(Metadata::Sparse);
+        Metadata m_cons(flags_cons), m_prim(flags_prim);
+        m_cons.SetSparseThresholds(0., 0., 0.);
+        m_prim.SetSparseThresholds(0., 0., 0.);
+        pkg->AddSparsePool("cons.Kel", m_cons, sparse_ids);
+        pkg->AddSparsePool("prims.Kel", m_prim, std::string("cons.Kel"), sparse_ids);
     }
     // TODO if nKs == 1 then rename Kel_Whatever -> Kel?
     // TODO record nKs and find a nice way to loop/vector the device-side layout?
@@ -186,6 +290,7 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
     }
 
     pkg->BlockUtoP = Electrons::BlockUtoP;
+    pkg->MeshUtoP = Electrons::MeshUtoP;
     pkg->BoundaryUtoP = Electrons::BlockUtoP;
 
     return pkg;
@@ -219,6 +324,7 @@ TaskStatus InitElectrons(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterInpu
     int ks = pmb->cellbounds.ks(domain), ke = pmb->cellbounds.ke(domain);
     pmb->par_for("UtoP_electrons", 0, e_P.GetDim(4)-1, ks, ke, js, je, is, ie,
         KOKKOS_LAMBDA (const int &p, const int &k, const int &j, const int &i) {
+            if (!e_P.IsAllocated(p)) return;
             if (p == ktot_index) {
                 // Initialize total entropy by definition,
                 e_P(p, k, j, i) = (gam - 1.) * u(k, j, i) * m::pow(rho(k, j, i), -gam);
@@ -253,7 +359,29 @@ void BlockUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse)
     int ks = bounds.ks(domain), ke = bounds.ke(domain);
     pmb->par_for("UtoP_electrons", 0, e_P.GetDim(4)-1, ks, ke, js, je, is, ie,
         KOKKOS_LAMBDA (const int &p, const int &k, const int &j, const int &i) {
-            e_P(p, k, j, i) = e_U(p, k, j, i) / rho_U(k, j, i);
+            if (e_P.IsAllocated(p))
+                e_P(p, k, j, i) = e_U(p, k, j, i) / rho_U(k, j, i);
+        }
+    );
+}
+
+void MeshUtoP(MeshData<Real> *md, IndexDomain domain, bool coarse)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+
+    auto e_P = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Elec"), Metadata::GetUserFlag("Primitive")});
+    auto e_U = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Elec"), Metadata::Conserved});
+    auto rho_U = md->PackVariables(std::vector<std::string>{"cons.rho"});
+
+    auto bounds = coarse ? pmb0->c_cellbounds : pmb0->cellbounds;
+    const IndexRange ib = bounds.GetBoundsI(domain);
+    const IndexRange jb = bounds.GetBoundsJ(domain);
+    const IndexRange kb = bounds.GetBoundsK(domain);
+    const IndexRange block = IndexRange{0, e_P.GetDim(5)-1};
+    pmb0->par_for("UtoP_electrons", block.s, block.e, 0, e_P.GetDim(4)-1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int &b, const int &p, const int &k, const int &j, const int &i) {
+            if (e_P.IsAllocated(b, p))
+                e_P(b, p, k, j, i) = e_U(b, p, k, j, i) / rho_U(b, 0, k, j, i);
         }
     );
 }
@@ -280,20 +408,19 @@ void BlockPtoU(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse)
     );
 }
 
-TaskStatus ApplyElectronHeating(MeshBlockData<Real> *rc_old, MeshBlockData<Real> *rc)
+TaskStatus MeshApplyElectronHeating(MeshData<Real> *md_old, MeshData<Real> *md)
 {
+    Flag("MeshApplyElectronHeating");
     // Need to distinguish different electron models
     // So far, Parthenon's maps of the same sets of variables are consistent,
     // so we only bother with one map of the primitives
     // TODO Parthenon can definitely build a pack from a map, though
-    PackIndexMap prims_map, cons_map;
-    auto& P = rc_old->PackVariables({Metadata::GetUserFlag("Primitive")}, prims_map);
-    auto& P_new = rc->PackVariables({Metadata::GetUserFlag("Primitive")}, prims_map);
-    auto& U_new = rc->PackVariables({Metadata::Conserved}, cons_map);
-    const VarMap m_p(prims_map, false), m_u(cons_map, true);
+    PackIndexMap prims_map;
+    auto P = md_old->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    auto P_new = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    const VarMap m_p(prims_map, false);
 
-    auto pmb = rc->GetBlockPointer();
-    const auto& G = pmb->coords;
+    auto pmb = md->GetBlockData(0)->GetBlockPointer();
 
     const Real gam = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
     const Real gamp = pmb->packages.Get("Electrons")->Param<Real>("gamma_p");
@@ -305,51 +432,75 @@ TaskStatus ApplyElectronHeating(MeshBlockData<Real> *rc_old, MeshBlockData<Real>
     const Real tptemax = pmb->packages.Get("Electrons")->Param<Real>("tp_over_te_max");
     const bool enforce_positive_diss = pmb->packages.Get("Electrons")->Param<bool>("enforce_positive_dissipation");
     const bool limit_kel = pmb->packages.Get("Electrons")->Param<bool>("limit_kel");
+    const bool implicit_heating = pmb->packages.Get("Electrons")->Param<bool>("implicit_heating");
+    const int heating_iters = pmb->packages.Get("Electrons")->Param<int>("implicit_heating_iters");
+    const bool sparse = pmb->packages.Get("Electrons")->Param<bool>("sparse");
+    const Real sparse_sigma = pmb->packages.Get("Electrons")->Param<Real>("sparse_sigma");
+    const Real fel0 = pmb->packages.Get("Electrons")->Param<Real>("fel_0");
+    // Constant parts of the entropy limits
+    const Real kel_max_fac = 1. / (tptemin * (gam - 1.) / (gamp-1.) + (gam-1.) / (game-1.));
+    const Real kel_min_fac = 1. / (tptemax * (gam - 1.) / (gamp-1.) + (gam-1.) / (game-1.));
 
     // This function (and any primitive-variable sources) needs to be run over the entire domain,
     // because the boundary zones have already been updated and so the same calculations must be applied
     // in order to keep them consistent.
     // See kharma_step.cpp for the full picture of what gets updated when.
-    const IndexRange ib = rc->GetBoundsI(IndexDomain::entire);
-    const IndexRange jb = rc->GetBoundsJ(IndexDomain::entire);
-    const IndexRange kb = rc->GetBoundsK(IndexDomain::entire);
-    pmb->par_for("heat_electrons", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-        KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
+    const IndexRange ib = md->GetBoundsI(IndexDomain::entire);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::entire);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::entire);
+    const IndexRange block = IndexRange{0, P.GetDim(5)-1};
+    pmb->par_for("heat_electrons", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) {
+            const auto& G = P.GetCoords(b);
             FourVectors Dtmp;
-            GRMHD::calc_4vecs(G, P, m_p, k, j, i, Loci::center, Dtmp);
+            GRMHD::calc_4vecs(G, P(b), m_p, k, j, i, Loci::center, Dtmp);
             Real bsq = dot(Dtmp.bcon, Dtmp.bcov);
 
+            // Quantities shared between all the models
+            const Real& rho_old = P(b, m_p.RHO, k, j, i);
+            const Real rho_gam_game = m::pow(rho_old, gam - game);
+            const Real rho_game1 = m::pow(rho_old, game - 1);
+            const Real sigma = bsq / rho_old;
+
             // Calculate the new total entropy in this cell considering heating
-            const Real k_energy_conserving = (gam-1.) * P_new(m_p.UU, k, j, i) / m::pow(P_new(m_p.RHO, k, j, i), gam);
+            const Real k_energy_conserving = (gam-1.) * P_new(b, m_p.UU, k, j, i) / m::pow(P_new(b, m_p.RHO, k, j, i), gam);
 
             // Dissipation is the real entropy k_energy_conserving minus any advected entropy from the previous (sub-)step P_new(KTOT)
-            Real diss_tmp = (game-1.) / (gam-1.) * m::pow(P(m_p.RHO, k, j, i), gam - game) * (k_energy_conserving - P_new(m_p.KTOT, k, j, i));
+            Real diss_tmp = (game-1.) / (gam-1.) * rho_gam_game * (k_energy_conserving - P_new(b, m_p.KTOT, k, j, i));
             //this is eq27                  ratio of heating: Qi/Qe                           advected entropy from prev step
             // ^ denotes the solution corresponding to entropy conservation
 
             // Under the flag "suppress_highb_heat", we set all dissipation to zero at sigma > 1.
-            diss_tmp = (suppress_highb_heat && (bsq / P(m_p.RHO, k, j, i) > 1.)) ? 0.0 : diss_tmp;
+            diss_tmp = (suppress_highb_heat && (sigma > 1.)) ? 0.0 : diss_tmp;
 
             // Default is True diss_sign == Enforce nonnegative
             // Due to floors we can end up with diss==0 or even *slightly* <0, so we require it to be positive here
             const Real diss = enforce_positive_diss ? m::max(diss_tmp, 0.0) : diss_tmp;
 
             // Reset the entropy to measure next (sub-)step's dissipation
-            P_new(m_p.KTOT, k, j, i) = k_energy_conserving;
+            P_new(b, m_p.KTOT, k, j, i) = k_energy_conserving;
 
             // We'll be applying floors inline as we heat electrons, so
             // we cache the floors as entropy limits so they'll be cheaper to apply.
             // Note tp_te_min -> kel_max & vice versa
-            const Real kel_max = P(m_p.KTOT, k, j, i) * m::pow(P(m_p.RHO, k, j, i), gam - game) /
-                                    (tptemin * (gam - 1.) / (gamp-1.) + (gam-1.) / (game-1.)); //0.001
-            const Real kel_min = P(m_p.KTOT, k, j, i) * m::pow(P(m_p.RHO, k, j, i), gam - game) /
-                                    (tptemax * (gam - 1.) / (gamp-1.) + (gam-1.) / (game-1.)); //1000
+            const Real kel_max = P(b, m_p.KTOT, k, j, i) * rho_gam_game * kel_max_fac; // tptemin
+            const Real kel_min = P(b, m_p.KTOT, k, j, i) * rho_gam_game * kel_min_fac; // tptemax
             // Note this differs a little from Ressler '15, who ensure u_e/u_g > 0.01 rather than use temperatures
 
             // The ion temperature is useful for a few models, cache it too.
             // The minimum values on Tpr & Tel here ensure that for un-initialized zones,
             // Tpr/Tel == Tel/Tpr == 1 != NaN.  This condition should not be hit after step 1
-            const Real Tpr = m::max((gamp - 1.) * P(m_p.UU, k, j, i) / P(m_p.RHO, k, j, i), SMALL);
+            const Real Tpr = m::max((gamp - 1.) * P(b, m_p.UU, k, j, i) / P(b, m_p.RHO, k, j, i), SMALL);
+
+            // Sparse entropies: skip any not allocated on this block, and restart any which
+            // are zero (newly allocated, or flowing out of an inactive zone) from fel_0, as in InitElectrons
+            const int8_t kels[6] = {m_p.K_CONSTANT, m_p.K_HOWES, m_p.K_KAWAZURA, m_p.K_WERNER, m_p.K_ROWAN, m_p.K_SHARMA};
+            bool kel_on[6];
+            for (int n = 0; n < 6; n++) {
+                kel_on[n] = kels[n] >= 0 && P.IsAllocated(b, kels[n]) && P_new.IsAllocated(b, kels[n]);
+                if (sparse && kel_on[n] && P_new(b, kels[n], k, j, i) <= 0.)
+                    P_new(b, kels[n], k, j, i) = (game - 1.) * fel0 * P_new(b, m_p.UU, k, j, i) * m::pow(P_new(b, m_p.RHO, k, j, i), -game);
+            }
 
             // Heat different electron passives based on different dissipation fraction models
             // Expressions here closely adapted (read: stolen) from implementation in iharm3d
@@ -357,75 +508,73 @@ TaskStatus ApplyElectronHeating(MeshBlockData<Real> *rc_old, MeshBlockData<Real>
             
             // In all of these the electron entropy stored value is the entropy conserving solution 
                                  // and then when updated it becomes the energy conserving solution
-            if (m_p.K_CONSTANT >= 0) {
+            if (kel_on[0]) {
                 const Real fel = fel_const;
                 // Default is true then enforce kel limits with clamp/clip, else no restrictions on kel
                 if (limit_kel) {
-                    P_new(m_p.K_CONSTANT, k, j, i) = clip(P_new(m_p.K_CONSTANT, k, j, i) + fel * diss, kel_min, kel_max);
+                    P_new(b, m_p.K_CONSTANT, k, j, i) = clip(P_new(b, m_p.K_CONSTANT, k, j, i) + fel * diss, kel_min, kel_max);
                 } else {
-                    P_new(m_p.K_CONSTANT, k, j, i) += fel * diss;
+                    P_new(b, m_p.K_CONSTANT, k, j, i) += fel * diss;
                 }
             }
-            if (m_p.K_HOWES >= 0) {
-                const Real Tel = m::max(P(m_p.K_HOWES, k, j, i) * m::pow(P(m_p.RHO, k, j, i), game-1), SMALL);
-
-                const Real Trat = Tpr / Tel;
-                const Real pres = P(m_p.RHO, k, j, i) * Tpr; // Proton pressure
-                const Real beta = m::min(pres / bsq * 2, 1.e20);// If somebody enables electrons in a GRHD sim
-
-                const Real logTrat = log10(Trat);
-                const Real mbeta = 2. - 0.2*logTrat;
-
-                const Real c2 = (Trat <= 1.) ? 1.6/Trat : 1.2/Trat;
-                const Real c3 = (Trat <= 1.) ? 18. + 5.*logTrat : 18.;
-
-                const Real beta_pow = m::pow(beta, mbeta);
-                const Real qrat = 0.92 * (c2*c2 + beta_pow)/(c3*c3 + beta_pow) * m::exp(-1./beta) * m::sqrt(MP/ME * Trat);
-                const Real fel = 1./(1. + qrat);
-                P_new(m_p.K_HOWES, k, j, i) = clip(P_new(m_p.K_HOWES, k, j, i) + fel * diss, kel_min, kel_max);
+            // Proton pressure & beta for the models below
+            const Real pres = rho_old * Tpr;
+            const Real beta = m::min(pres / bsq * 2, 1.e20);// If somebody enables electrons in a GRHD sim
+            if (kel_on[1]) {
+                if (implicit_heating) {
+                    P_new(b, m_p.K_HOWES, k, j, i) = heat_kel_implicit<TeModel::howes>(P_new(b, m_p.K_HOWES, k, j, i), P(b, m_p.K_HOWES, k, j, i),
+                                                    diss, rho_game1, Tpr, beta, kel_min, kel_max, heating_iters);
+                } else {
+                    const Real Tel = m::max(P(b, m_p.K_HOWES, k, j, i) * rho_game1, SMALL);
+                    const Real fel = fel_howes(Tpr / Tel, beta);
+                    P_new(b, m_p.K_HOWES, k, j, i) = clip(P_new(b, m_p.K_HOWES, k, j, i) + fel * diss, kel_min, kel_max);
+                }
             }
-            if (m_p.K_KAWAZURA >= 0) {
-                // Equation (2) in http://www.pnas.org/lookup/doi/10.1073/pnas.1812491116
-                const Real Tel = m::max(P(m_p.K_KAWAZURA, k, j, i) * m::pow(P(m_p.RHO, k, j, i), game-1), SMALL);
-
-                const Real Trat = Tpr / Tel;
-                const Real pres = P(m_p.RHO, k, j, i) * Tpr; // Proton pressure
-                const Real beta = m::min(pres / bsq * 2, 1.e20);// If somebody enables electrons in a GRHD sim
-
-                const Real QiQe = 35. / (1. + m::pow(beta/15., -1.4) * m::exp(-0.1 / Trat));
-                const Real fel = 1./(1. + QiQe);
-                P_new(m_p.K_KAWAZURA, k, j, i) = clip(P_new(m_p.K_KAWAZURA, k, j, i) + fel * diss, kel_min, kel_max);
+            if (kel_on[2]) {
+                if (implicit_heating) {
+                    P_new(b, m_p.K_KAWAZURA, k, j, i) = heat_kel_implicit<TeModel::kawazura>(P_new(b, m_p.K_KAWAZURA, k, j, i), P(b, m_p.K_KAWAZURA, k, j, i),
+                                                    diss, rho_game1, Tpr, beta, kel_min, kel_max, heating_iters);
+                } else {
+                    const Real Tel = m::max(P(b, m_p.K_KAWAZURA, k, j, i) * rho_game1, SMALL);
+                    const Real fel = fel_kawazura(Tpr / Tel, beta);
+                    P_new(b, m_p.K_KAWAZURA, k, j, i) = clip(P_new(b, m_p.K_KAWAZURA, k, j, i) + fel * diss, kel_min, kel_max);
+                }
             }
             // TODO KAWAZURA 19/20/21 separately?
-            if (m_p.K_WERNER >= 0) {
+            if (kel_on[3]) {
                 // Equation (3) in http://academic.oup.com/mnras/article/473/4/4840/4265350
-                const Real sigma = bsq / P(m_p.RHO, k, j, i);
                 const Real fel = 0.25 * (1 + m::sqrt((sigma/5.) / (2 + (sigma/5.))));
-                P_new(m_p.K_WERNER, k, j, i) = clip(P_new(m_p.K_WERNER, k, j, i) + fel * diss, kel_min, kel_max);
+                P_new(b, m_p.K_WERNER, k, j, i) = clip(P_new(b, m_p.K_WERNER, k, j, i) + fel * diss, kel_min, kel_max);
             }
-            if (m_p.K_ROWAN >= 0) {
+            if (kel_on[4]) {
                 // Equation (34) in https://iopscience.iop.org/article/10.3847/1538-4357/aa9380
-                const Real pres = (gamp - 1.) * P(m_p.UU, k, j, i); // Proton pressure
-                const Real pg = (gam - 1) * P(m_p.UU, k, j, i);
+                const Real pres = (gamp - 1.) * P(b, m_p.UU, k, j, i); // Proton pressure
+                const Real pg = (gam - 1) * P(b, m_p.UU, k, j, i);
                 const Real beta = pres / bsq * 2;
-                const Real sigma = bsq / (P(m_p.RHO, k, j, i) + P(m_p.UU, k, j, i) + pg);
-                const Real betamax = 0.25 / sigma;
-                const Real fel = 0.5 * m::exp(-m::pow(1 - beta/betamax, 3.3) / (1 + 1.2*m::pow(sigma, 0.7)));
-                P_new(m_p.K_ROWAN, k, j, i) = clip(P_new(m_p.K_ROWAN, k, j, i) + fel * diss, kel_min, kel_max);
+                const Real sigma_w = bsq / (P(b, m_p.RHO, k, j, i) + P(b, m_p.UU, k, j, i) + pg);
+                const Real betamax = 0.25 / sigma_w;
+                const Real fel = 0.5 * m::exp(-m::pow(1 - beta/betamax, 3.3) / (1 + 1.2*m::pow(sigma_w, 0.7)));
+                P_new(b, m_p.K_ROWAN, k, j, i) = clip(P_new(b, m_p.K_ROWAN, k, j, i) + fel * diss, kel_min, kel_max);
             }
-            if (m_p.K_SHARMA >= 0) {
-                // Equation for \delta on  pg. 719 (Section 4) in https://iopscience.iop.org/article/10.1086/520800
-                const Real Tel = m::max(P(m_p.K_SHARMA, k, j, i) * m::pow(P(m_p.RHO, k, j, i), game-1), SMALL);
-
-                const Real Trat_inv = Tel / Tpr; // Inverse of the temperature ratio in KAWAZURA
-                const Real QeQi = 0.33 * m::sqrt(Trat_inv);
-                const Real fel = 1./(1.+1./QeQi);
-                P_new(m_p.K_SHARMA, k, j, i) = clip(P_new(m_p.K_SHARMA, k, j, i) + fel * diss, kel_min, kel_max);
+            if (kel_on[5]) {
+                if (implicit_heating) {
+                    P_new(b, m_p.K_SHARMA, k, j, i) = heat_kel_implicit<TeModel::sharma>(P_new(b, m_p.K_SHARMA, k, j, i), P(b, m_p.K_SHARMA, k, j, i),
+                                                    diss, rho_game1, Tpr, beta, kel_min, kel_max, heating_iters);
+                } else {
+                    const Real Tel = m::max(P(b, m_p.K_SHARMA, k, j, i) * rho_game1, SMALL);
+                    const Real fel = fel_sharma(Tpr / Tel, beta);
+                    P_new(b, m_p.K_SHARMA, k, j, i) = clip(P_new(b, m_p.K_SHARMA, k, j, i) + fel * diss, kel_min, kel_max);
+                }
             }
+            // Electrons in inactive zones are zeroed, so that blocks entirely above sparse_sigma deallocate them
+            if (sparse && sigma > sparse_sigma)
+                for (int n = 0; n < 6; n++)
+                    if (kel_on[n]) P_new(b, kels[n], k, j, i) = 0.;
             // Conserved variables are updated at the end of the step
         }
     );
 
+    EndFlag();
     return TaskStatus::complete;
 }
 
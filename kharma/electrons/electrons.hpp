@@ -84,6 +84,7 @@ TaskStatus InitElectrons(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterInpu
  * Function in this package: Get the specific entropy primitive value, by dividing the total entropy K/(rho*u^0)
  */
 void BlockUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse=false);
+void MeshUtoP(MeshData<Real> *md, IndexDomain domain, bool coarse=false);
 
 /**
  * This heating step is custom for this package.  It is added manually to any task list in the KHARMADriver,
@@ -94,23 +95,16 @@ void BlockUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse=false);
  * It applies any or all of several different esimates for this split, to each of the several different
  * primitive variables "prims.Kel_X"
  * Finally, it checks the results against a minimum and maximum temperature ratio T_protons/T_electrons
+ * All blocks in the MeshData are updated in one kernel launch.
  * 
  * To recap re: floors:
- * This function expects two sets of values {rho0, u0, Ktot0} from rc_old and {rho1, u1} from rc,
+ * This function expects two sets of values {rho0, u0, Ktot0} from md_old and {rho1, u1} from md,
  * all of which obey all given floors.
  * It produces end-of-substep values {Ktot1, Kel_X1, Kel_Y1, etc}, which are also guaranteed to obey floors
  * 
  * TODO this function should update fflag to reflect temperature ratio floor hits
  */
-TaskStatus ApplyElectronHeating(MeshBlockData<Real> *rc_old, MeshBlockData<Real> *rc);
-inline TaskStatus MeshApplyElectronHeating(MeshData<Real> *md_old, MeshData<Real> *md)
-{
-    Flag("MeshApplyElectronHeating");
-    for (int i=0; i < md->NumBlocks(); ++i)
-        ApplyElectronHeating(md_old->GetBlockData(i).get(), md->GetBlockData(i).get());
-    EndFlag();
-    return TaskStatus::complete;
-}
+TaskStatus MeshApplyElectronHeating(MeshData<Real> *md_old, MeshData<Real> *md);
 
 /**
  * KHARMA requires some method for getting conserved variables from primitives, as well.
@@ -128,18 +122,42 @@ KOKKOS_FORCEINLINE_FUNCTION void p_to_u(const GRCoordinates& G, const VariablePa
     const Real rho_ut = P(m_p.RHO, k, j, i) * ut * G.gdet(loc, j, i);
 
     flux(m_u.KTOT, k, j, i) = rho_ut * P(m_p.KTOT, k, j, i);
-    if (m_p.K_CONSTANT >= 0)
+    if (m_p.K_CONSTANT >= 0 && P.IsAllocated(m_p.K_CONSTANT))
         flux(m_u.K_CONSTANT, k, j, i) = rho_ut * P(m_p.K_CONSTANT, k, j, i);
-    if (m_p.K_HOWES >= 0)
+    if (m_p.K_HOWES >= 0 && P.IsAllocated(m_p.K_HOWES))
         flux(m_u.K_HOWES, k, j, i) = rho_ut * P(m_p.K_HOWES, k, j, i);
-    if (m_p.K_KAWAZURA >= 0)
+    if (m_p.K_KAWAZURA >= 0 && P.IsAllocated(m_p.K_KAWAZURA))
         flux(m_u.K_KAWAZURA, k, j, i) = rho_ut * P(m_p.K_KAWAZURA, k, j, i);
-    if (m_p.K_WERNER >= 0)
+    if (m_p.K_WERNER >= 0 && P.IsAllocated(m_p.K_WERNER))
         flux(m_u.K_WERNER, k, j, i) = rho_ut * P(m_p.K_WERNER, k, j, i);
-    if (m_p.K_ROWAN >= 0)
+    if (m_p.K_ROWAN >= 0 && P.IsAllocated(m_p.K_ROWAN))
         flux(m_u.K_ROWAN, k, j, i) = rho_ut * P(m_p.K_ROWAN, k, j, i);
-    if (m_p.K_SHARMA >= 0)
+    if (m_p.K_SHARMA >= 0 && P.IsAllocated(m_p.K_SHARMA))
         flux(m_u.K_SHARMA, k, j, i) = rho_ut * P(m_p.K_SHARMA, k, j, i);
 }
 
+/**
+ * Recover the entropies in one zone from their conserved forms, as BlockUtoP does.
+ * Called from the inverter's kernel when inverter/fuse_electrons is set, see Inverter::FusesElectrons
+ */
+KOKKOS_FORCEINLINE_FUNCTION void u_to_p(const VariablePack<Real>& U, const VarMap& m_u,
+                                         const int& k, const int& j, const int& i,
+                                         const VariablePack<Real>& P, const VarMap& m_p)
+{
+    const Real rho_ut = U(m_u.RHO, k, j, i);
+    P(m_p.KTOT, k, j, i) = U(m_u.KTOT, k, j, i) / rho_ut;
+    if (var_allocated(P, m_p.K_CONSTANT))
+        P(m_p.K_CONSTANT, k, j, i) = U(m_u.K_CONSTANT, k, j, i) / rho_ut;
+    if (var_allocated(P, m_p.K_HOWES))
+        P(m_p.K_HOWES, k, j, i) = U(m_u.K_HOWES, k, j, i) / rho_ut;
+    if (var_allocated(P, m_p.K_KAWAZURA))
+        P(m_p.K_KAWAZURA, k, j, i) = U(m_u.K_KAWAZURA, k, j, i) / rho_ut;
+    if (var_allocated(P, m_p.K_WERNER))
+        P(m_p.K_WERNER, k, j, i) = U(m_u.K_WERNER, k, j, i) / rho_ut;
+    if (var_allocated(P, m_p.K_ROWAN))
+        P(m_p.K_ROWAN, k, j, i) = U(m_u.K_ROWAN, k, j, i) / rho_ut;
+    if (var_allocated(P, m_p.K_SHARMA))
+        P(m_p.K_SHARMA, k, j, i) = U(m_u.K_SHARMA, k, j, i) / rho_ut;
+}
+
 }
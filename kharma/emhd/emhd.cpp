@@ -124,11 +124,33 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
     // Only enable limits internally if we're actually doing EMHD
     params.Add("enable_emhd_limits", enable_emhd_limits);
 
+    // Evolve q/dP explicitly with the KHARMA driver, rather than implicitly with ImEx.
+    // Their relaxation sources are integrated after each stage's update, subcycled in each block
+    // to keep the sub-step below subcycle_cfl * tau, see SubcycleSources.  Only worthwhile for
+    // mildly stiff closures: past subcycle_max subcycles per stage, use the ImEx driver instead
+    bool subcycle = pin->GetOrAddBoolean("emhd", "subcycle", false);
+    if (subcycle && packages->Get("Driver")->Param<DriverType>("type") != DriverType::kharma)
+        throw std::invalid_argument("Subcycled EMHD sources require driver/type=kharma!");
+    params.Add("subcycle", subcycle);
+    Real subcycle_cfl = pin->GetOrAddReal("emhd", "subcycle_cfl", 0.5);
+    if (subcycle_cfl <= 0. || subcycle_cfl >= 2.)
+        throw std::invalid_argument("emhd/subcycle_cfl must be in (0, 2) for a stable explicit relaxation!");
+    params.Add("subcycle_cfl", subcycle_cfl);
+    int subcycle_max = pin->GetOrAddInteger("emhd", "subcycle_max", 64);
+    if (subcycle_max < 1)
+        throw std::invalid_argument("emhd/subcycle_max must be positive!");
+    params.Add("subcycle_max", subcycle_max);
+    // Minimum tau of each block, kept between steps
+    params.Add("subcycle_tau_min", Allocations::PersistentArray<Real>("subcycle_tau_min"), true);
+
     // General options for primitive and conserved scalar variables in ImEx driver
-    // EMHD is supported only with imex driver and implicit evolution,
-    // synchronizing primitive variables
+    // EMHD is supported with the imex driver and implicit evolution of q/dP,
+    // synchronizing primitive variables.  The GRMHD variables may be explicit, see SubtractStress.
+    // With subcycle, q/dP are instead explicit variables of the KHARMA driver
     Metadata::AddUserFlag("EMHDVar"); // "EMHD" name now taken by Parthenon for general flag, we want this one specific
-    std::vector<MetadataFlag> emhd_flags = {Metadata::Cell, Metadata::GetUserFlag("Implicit"), Metadata::GetUserFlag("EMHDVar")};
+    MetadataFlag areWeImplicit = (subcycle) ? Metadata::GetUserFlag("Explicit")
+                                            : Metadata::GetUserFlag("Implicit");
+    std::vector<MetadataFlag> emhd_flags = {Metadata::Cell, areWeImplicit, Metadata::GetUserFlag("EMHDVar")};
 
     auto flags_prim = packages->Get("Driver")->Param<std::vector<MetadataFlag>>("prim_flags");
     flags_prim.insert(flags_prim.end(), emhd_flags.begin(), emhd_flags.end());
@@ -167,6 +189,10 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
 
     // UtoP function specifically for boundary sync (KHARMA must sync cons for AMR) and output
     pkg->BoundaryUtoP = EMHD::BlockUtoP;
+    // Explicitly-evolved q/dP are recovered along with everything else
+    if (subcycle) {
+        pkg->MeshUtoP = EMHD::MeshUtoP;
+    }
     // If we wanted to apply the domian boundaries to primitive EMHD variables
     //pkg->DomainBoundaryPtoU = EMHD::BlockPtoU;
 
@@ -191,8 +217,6 @@ void MeshUtoP(MeshData<Real> *md, IndexDomain domain, bool coarse)
     auto P   = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
     const VarMap m_p(prims_map, false), m_u(cons_map, true);
 
-    const auto& G = pmb->coords;
-
     auto bounds      = coarse ? pmb->c_cellbounds : pmb->cellbounds;
     IndexRange ib    = bounds.GetBoundsI(domain);
     IndexRange jb    = bounds.GetBoundsJ(domain);
@@ -201,6 +225,7 @@ void MeshUtoP(MeshData<Real> *md, IndexDomain domain, bool coarse)
 
     pmb->par_for("UtoP_EMHD", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) { 
+            const auto& G        = U_E.GetCoords(b);
             const Real gamma     = GRMHD::lorentz_calc(G, P(b), m_p, k, j, i, Loci::center);
             const Real inv_alpha = m::sqrt(-G.gcon(Loci::center, j, i, 0, 0));
             const Real ucon0     = gamma * inv_alpha;
@@ -294,6 +319,8 @@ TaskStatus AddSource(MeshData<Real> *md, MeshData<Real> *mdudt)
     const auto& gpars = pmb0->packages.Get("GRMHD")->AllParams();
     const Real gam    = gpars.Get<Real>("gamma");
     const int ndim    = pmesh->ndim;
+    // All connection coefficients are zero in Cartesian Minkowski space
+    const bool flat   = pmb0->coords.coords.is_cart_minkowski();
     // Options: Local
     const auto& pars                   = pmb0->packages.Get("EMHD")->AllParams();
     const EMHD_parameters& emhd_params = pars.Get<EMHD_parameters>("emhd_params");
@@ -352,7 +379,7 @@ TaskStatus AddSource(MeshData<Real> *md, MeshData<Real> *mdudt)
             // Compute gradient of ucov and Theta
             Real grad_ucov[GR_DIM][GR_DIM], grad_Theta[GR_DIM];
             // TODO thread the limiter selection through to call
-            EMHD::gradient_calc<KReconstruction::Type::linear_mc>(G, Temps(b), m_ucov, m_theta, b, k, j, i, (ndim > 2), (ndim > 1), grad_ucov, grad_Theta);
+            EMHD::gradient_calc<KReconstruction::Type::linear_mc>(G, Temps(b), m_ucov, m_theta, b, k, j, i, (ndim > 2), (ndim > 1), flat, grad_ucov, grad_Theta);
 
             // Compute div of ucon (all terms but the time-derivative ones are nonzero)
             Real div_ucon    = 0;
@@ -396,4 +423,128 @@ TaskStatus AddSource(MeshData<Real> *md, MeshData<Real> *mdudt)
     return TaskStatus::complete;
 }
 
+TaskStatus SubcycleSources(MeshData<Real> *md_full_step_init, MeshData<Real> *md, const Real& dt_stage, const Real& dt_since_init)
+{
+    Flag("EMHD::SubcycleSources");
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const Real gam = pmb0->packages.Get("GRMHD")->Param<Real>("gamma");
+    auto& pars = pmb0->packages.Get("EMHD")->AllParams();
+    const EMHD_parameters& emhd_params = pars.Get<EMHD_parameters>("emhd_params");
+    const Real subcycle_cfl = pars.Get<Real>("subcycle_cfl");
+    const int subcycle_max  = pars.Get<int>("subcycle_max");
+
+    PackIndexMap prims_map, cons_map;
+    auto P_full_step_init = md_full_step_init->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    auto P   = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    auto U_E = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("EMHDVar"), Metadata::Conserved}, cons_map);
+    const VarMap m_p(prims_map, false), m_u(cons_map, true);
+
+    const IndexRange ib = md->GetBoundsI(IndexDomain::entire);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::entire);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::entire);
+    const IndexRange block = IndexRange{0, U_E.GetDim(5) - 1};
+
+    // Relaxation time bounding the explicit sub-step in each block
+    const auto tau_min = pars.GetMutable<Allocations::PersistentArray<Real>>("subcycle_tau_min")->Get(block.e + 1);
+    Kokkos::deep_copy(tau_min, std::numeric_limits<Real>::max());
+    pmb0->par_for("emhd_subcycle_tau", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) {
+            const auto& G = U_E.GetCoords(b);
+            Real tau, chi_e, nu_e;
+            EMHD::set_parameters(G, P(b), m_p, emhd_params, gam, k, j, i, tau, chi_e, nu_e);
+            Kokkos::atomic_min(&tau_min(b), tau);
+        }
+    );
+
+    // Integrate d(U_E)/dt = -gdet q/tau + (time-derivative sources), the latter held fixed over the stage.
+    // These are the terms the implicit solver would otherwise handle, with the closure evaluated
+    // at the updated state and the time derivatives taken against the step start, as in the
+    // solver's non-stiff path.  The spatial terms were already applied in the update by AddSource
+    pmb0->par_for("emhd_subcycle", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) {
+            const auto& G = U_E.GetCoords(b);
+            auto P_old = Kokkos::subview(P_full_step_init(b), Kokkos::ALL(), k, j, i);
+            auto P_new = Kokkos::subview(P(b), Kokkos::ALL(), k, j, i);
+
+            SourceTerms s;
+            EMHD::source_terms(G, P_old, P_new, m_p, emhd_params, gam, j, i, s);
+            Real dUq_t = 0., dUdP_t = 0.;
+            EMHD::time_derivative_sources(G, P_new, m_p, emhd_params, s, gam, dt_since_init, j, i, dUq_t, dUdP_t);
+
+            const int nsub = m::min(m::max((int) m::ceil(dt_stage / (subcycle_cfl * tau_min(b))), 1), subcycle_max);
+            const Real dt_sub = dt_stage / nsub;
+            const Real gdet = G.gdet(Loci::center, j, i);
+            const Real inv_norm = 1. / (GRMHD::lorentz_calc(G, P_new, m_p, j, i, Loci::center)
+                                        * m::sqrt(-G.gcon(Loci::center, j, i, 0, 0)) * gdet);
+            if (emhd_params.conduction) {
+                Real Uq = U_E(b, m_u.Q, k, j, i);
+                for (int n = 0; n < nsub; ++n)
+                    Uq += dt_sub * (dUq_t - gdet * (Uq * inv_norm) / s.tau);
+                U_E(b, m_u.Q, k, j, i) = Uq;
+                P(b, m_p.Q, k, j, i) = Uq * inv_norm;
+            }
+            if (emhd_params.viscosity) {
+                Real UdP = U_E(b, m_u.DP, k, j, i);
+                for (int n = 0; n < nsub; ++n)
+                    UdP += dt_sub * (dUdP_t - gdet * (UdP * inv_norm) / s.tau);
+                U_E(b, m_u.DP, k, j, i) = UdP;
+                P(b, m_p.DP, k, j, i) = UdP * inv_norm;
+            }
+        }
+    );
+
+    EndFlag();
+    return TaskStatus::complete;
+}
+
+TaskStatus SubtractStress(MeshData<Real> *md_U, MeshData<Real> *md_P)
+{
+    auto pmb0 = md_U->GetBlockData(0)->GetBlockPointer();
+    const Real gam = pmb0->packages.Get("GRMHD")->Param<Real>("gamma");
+    const EMHD_parameters& emhd_params = pmb0->packages.Get("EMHD")->Param<EMHD_parameters>("emhd_params");
+    // Nothing to remove if q & dP don't feed back on the fluid
+    if (!emhd_params.feedback) return TaskStatus::complete;
+    // Same tensor, minus the q & dP terms
+    EMHD_parameters ideal_params = emhd_params;
+    ideal_params.feedback = false;
+
+    PackIndexMap prims_map, cons_map;
+    auto P = md_P->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    auto U = md_U->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("HD"), Metadata::Conserved}, cons_map);
+    const VarMap m_p(prims_map, false), m_u(cons_map, true);
+
+    const IndexRange ib = md_U->GetBoundsI(IndexDomain::entire);
+    const IndexRange jb = md_U->GetBoundsJ(IndexDomain::entire);
+    const IndexRange kb = md_U->GetBoundsK(IndexDomain::entire);
+    const IndexRange block = IndexRange{0, U.GetDim(5) - 1};
+
+    pmb0->par_for("emhd_subtract_stress", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) {
+            const auto& G = U.GetCoords(b);
+            FourVectors D;
+            GRMHD::calc_4vecs(G, P(b), m_p, k, j, i, Loci::center, D);
+
+            const Real& rho    = P(b, m_p.RHO, k, j, i);
+            const Real& u      = P(b, m_p.UU, k, j, i);
+            const Real pgas    = (gam - 1) * u;
+            const Real Theta   = pgas / rho;
+            const Real cs2     = gam * pgas / (rho + gam * u);
+            const Real qtilde  = (m_p.Q >= 0) ? P(b, m_p.Q, k, j, i) : 0.;
+            const Real dPtilde = (m_p.DP >= 0) ? P(b, m_p.DP, k, j, i) : 0.;
+            Real q, dP;
+            EMHD::convert_prims_to_q_dP(qtilde, dPtilde, rho, Theta, cs2, emhd_params, q, dP);
+
+            Real T[GR_DIM], T_ideal[GR_DIM];
+            EMHD::calc_tensor(rho, u, pgas, emhd_params, q, dP, D, 0, T);
+            EMHD::calc_tensor(rho, u, pgas, ideal_params, q, dP, D, 0, T_ideal);
+
+            const Real gdet = G.gdet(Loci::center, j, i);
+            U(b, m_u.UU, k, j, i) -= (T[0] - T_ideal[0]) * gdet;
+            VLOOP U(b, m_u.U1 + v, k, j, i) -= (T[v+1] - T_ideal[v+1]) * gdet;
+        }
+    );
+
+    return TaskStatus::complete;
+}
+
 } // namespace EMHD
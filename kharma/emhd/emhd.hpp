@@ -97,6 +97,24 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
  */
 TaskStatus AddSource(MeshData<Real> *md, MeshData<Real> *mdudt);
 
+/**
+ * Remove the EMHD contribution to the stress-energy from the conserved GRMHD variables in md_U,
+ * evaluated using the primitives in md_P.
+ * Used when evolving GRMHD explicitly, so that the ideal inversion sees only the ideal part of T^0_mu.
+ * The correction is lagged: md_P should be the sub-step starting state.  The full U is recomputed
+ * from the final primitives at the end of the step.
+ */
+TaskStatus SubtractStress(MeshData<Real> *md_U, MeshData<Real> *md_P);
+
+/**
+ * Apply the relaxation & time-derivative sources for q/dP to the state md after an explicit
+ * stage update of length dt_stage, with emhd/subcycle.  These are the "implicit" sources,
+ * integrated explicitly in nsub steps per block, nsub=ceil(dt_stage/(subcycle_cfl*tau_min)).
+ * Time derivatives are taken against md_full_step_init, dt_since_init before the stage's end.
+ * Updates both the conserved & primitive q/dP, in all zones: fluid primitives must be current.
+ */
+TaskStatus SubcycleSources(MeshData<Real> *md_full_step_init, MeshData<Real> *md, const Real& dt_stage, const Real& dt_since_init);
+
 /**
  * Set q and dP to sensible starting values if they are not initialized by the problem.
  * Currently a no-op as sensible values are zeros.
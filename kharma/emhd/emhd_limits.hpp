@@ -136,6 +136,9 @@ inline void ApplyEMHDLimits(MeshBlockData<Real> *mbd, IndexDomain domain)
 {
     auto pmb                 = mbd->GetBlockPointer();
     auto packages            = pmb->packages;
+    // With the Floors package, the limits are applied in the same pass as the ceilings,
+    // see Floors::ApplyGRMHDFloors
+    if (packages.AllPackages().count("Floors")) return;
 
     PackIndexMap prims_map, cons_map;
     auto P = mbd->PackVariables({Metadata::GetUserFlag("Primitive")}, prims_map);
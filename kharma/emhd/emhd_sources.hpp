@@ -133,4 +133,108 @@ KOKKOS_INLINE_FUNCTION void time_derivative_sources(const GRCoordinates& G, cons
     }
 }
 
+/**
+ * Parts of the sources above which don't depend on the trial primitives P_new/P:
+ * closure parameters and 4-vectors of the sub-step initial state, and the previous state.
+ * Computing these once lets the implicit solver evaluate many residuals in a zone,
+ * as when building the Jacobian, at the cost of only the trial-dependent terms.
+ */
+struct SourceTerms {
+    Real tau, chi_e, nu_e;
+    Real bcon[GR_DIM];
+    Real ucon0, bsq, mag_b;
+    Real ucov_old[GR_DIM];
+    Real Theta_old;
+    Real rho, Theta, qtilde, dPtilde;
+};
+
+/**
+ * Fill a SourceTerms struct, given the previous state P_old and the state P
+ * used for the closure parameters (P_tau in implicit_sources)
+ */
+template<typename Local>
+KOKKOS_INLINE_FUNCTION void source_terms(const GRCoordinates& G, const Local& P_old, const Local& P,
+                                         const VarMap& m_p, const EMHD_parameters& emhd_params,
+                                         const Real& gam, const int& j, const int& i, SourceTerms& s)
+{
+    EMHD::set_parameters(G, P, m_p, emhd_params, gam, j, i, s.tau, s.chi_e, s.nu_e);
+
+    FourVectors Dtmp;
+    GRMHD::calc_4vecs(G, P, m_p, j, i, Loci::center, Dtmp);
+    s.bsq   = m::max(dot(Dtmp.bcon, Dtmp.bcov), SMALL);
+    s.mag_b = m::sqrt(s.bsq);
+    DLOOP1 s.bcon[mu] = Dtmp.bcon[mu];
+    s.ucon0 = Dtmp.ucon[0];
+
+    Real ucon[GR_DIM];
+    GRMHD::calc_ucon(G, P_old, m_p, j, i, Loci::center, ucon);
+    G.lower(ucon, s.ucov_old, 0, j, i, Loci::center);
+    s.Theta_old = m::max((gam-1) * P_old(m_p.UU) / P_old(m_p.RHO), SMALL);
+
+    s.rho     = P(m_p.RHO);
+    s.Theta   = (gam-1) * P(m_p.UU) / P(m_p.RHO);
+    s.qtilde  = (m_p.Q >= 0) ? P(m_p.Q) : 0.;
+    s.dPtilde = (m_p.DP >= 0) ? P(m_p.DP) : 0.;
+}
+
+/**
+ * implicit_sources, using a SourceTerms struct computed from P_tau
+ */
+template<typename Local>
+KOKKOS_INLINE_FUNCTION void implicit_sources(const GRCoordinates& G, const Local& P, const VarMap& m_p,
+                                             const int& j, const int& i, const EMHD_parameters& emhd_params_tau,
+                                             const SourceTerms& s, Real& dUq, Real& dUdP)
+{
+    if (emhd_params_tau.conduction)
+        dUq = -G.gdet(Loci::center, j, i) * (P(m_p.Q) / s.tau);
+    if (emhd_params_tau.viscosity)
+        dUdP = -G.gdet(Loci::center, j, i) * (P(m_p.DP) / s.tau);
+}
+
+/**
+ * time_derivative_sources, using a SourceTerms struct computed from P_old & P.
+ * Only P_new is the trial state.
+ */
+template<typename Local>
+KOKKOS_INLINE_FUNCTION void time_derivative_sources(const GRCoordinates& G, const Local& P_new,
+                                                    const VarMap& m_p, const EMHD_parameters& emhd_params,
+                                                    const SourceTerms& s, const Real& gam, const Real& dt,
+                                                    const int& j, const int& i, Real& dUq, Real& dUdP)
+{
+    Real ucon[GR_DIM], ucov_new[GR_DIM];
+    GRMHD::calc_ucon(G, P_new, m_p, j, i, Loci::center, ucon);
+    G.lower(ucon, ucov_new, 0, j, i, Loci::center);
+    Real dt_ucov[GR_DIM];
+    DLOOP1 dt_ucov[mu] = (ucov_new[mu] - s.ucov_old[mu]) / dt;
+
+    Real div_ucon    = 0;
+    DLOOP1 div_ucon += G.gcon(Loci::center, j, i, 0, mu) * dt_ucov[mu];
+    const Real Theta_new = m::max((gam-1) * P_new(m_p.UU) / P_new(m_p.RHO), SMALL);
+    const Real dt_Theta  = (Theta_new - s.Theta_old) / dt;
+
+    if (emhd_params.conduction) {
+        Real q0             = -s.rho * s.chi_e * (s.bcon[0] / s.mag_b) * dt_Theta;
+        DLOOP1 q0          -= s.rho * s.chi_e * (s.bcon[mu] / s.mag_b) * s.Theta * s.ucon0 * dt_ucov[mu];
+        Real q0_tilde       = q0;
+        if (emhd_params.higher_order_terms)
+            q0_tilde *= (s.chi_e != 0) ? m::sqrt(s.tau / (s.chi_e * s.rho * s.Theta * s.Theta)) : 0.0;
+
+        dUq  = G.gdet(Loci::center, j, i) * (q0_tilde / s.tau);
+        if (emhd_params.higher_order_terms)
+            dUq += G.gdet(Loci::center, j, i) * (s.qtilde / 2.) * div_ucon;
+    }
+
+    if (emhd_params.viscosity) {
+        Real dP0            = -s.rho * s.nu_e * div_ucon;
+        DLOOP1 dP0         += 3. * s.rho * s.nu_e * (s.bcon[0] * s.bcon[mu] / s.bsq) * dt_ucov[mu];
+        Real dP0_tilde      = dP0;
+        if (emhd_params.higher_order_terms)
+            dP0_tilde *= (s.nu_e != 0) ? m::sqrt(s.tau / (s.nu_e * s.rho * s.Theta)) : 0.0;
+
+        dUdP = G.gdet(Loci::center, j, i) * (dP0_tilde / s.tau);
+        if (emhd_params.higher_order_terms)
+            dUdP += G.gdet(Loci::center, j, i) * (s.dPtilde / 2.) * div_ucon;
+    }
+}
+
 } // namespace EMHD
@@ -51,12 +51,14 @@ using KReconstruction::slope_calc;
 namespace EMHD {
 
 // Compute gradient of four velocities and temperature
-// Called by emhd_explicit_sources
+// Called once per zone per sub-step by EMHD::AddSource.  The implicit solver only needs the time derivatives,
+// so the spatial terms reach it through the explicit source dUdt rather than being recomputed.
+// Pass flat=true in Cartesian Minkowski coordinates to skip the (zero) connection terms
 template<KReconstruction::Type recon>
 KOKKOS_INLINE_FUNCTION void gradient_calc(const GRCoordinates& G, const VariablePack<Real>& Temps,
                                           const int& uvec_index, const int& theta_index,
                                           const int& b, const int& k, const int& j, const int& i, 
-                                          const bool& do_3d, const bool& do_2d,
+                                          const bool& do_3d, const bool& do_2d, const bool& flat,
                                           Real grad_ucov[GR_DIM][GR_DIM], Real grad_Theta[GR_DIM])
 {
     // Compute gradient of ucov
@@ -67,8 +69,8 @@ KOKKOS_INLINE_FUNCTION void gradient_calc(const GRCoordinates& G, const Variable
         grad_ucov[2][mu] = (do_2d) ? slope_calc<recon, X2DIR>(G, Temps, uvec_index + mu, k, j, i) : 0.;
         grad_ucov[3][mu] = (do_3d) ? slope_calc<recon, X3DIR>(G, Temps, uvec_index + mu, k, j, i) : 0.;
     }
-    // TODO skip this if flat space?
-    DLOOP3 grad_ucov[mu][nu] -= G.conn(j, i, lam, mu, nu) * Temps(uvec_index + lam, k, j, i);
+    if (!flat)
+        DLOOP3 grad_ucov[mu][nu] -= G.conn(j, i, lam, mu, nu) * Temps(uvec_index + lam, k, j, i);
 
     // Compute temperature gradient
     // Time derivative component is computed in time_derivative_sources
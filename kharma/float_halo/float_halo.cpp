@@ -0,0 +1,169 @@
+/* 
+ *  File: float_halo.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "float_halo.hpp"
+
+#include "domain.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+std::shared_ptr<KHARMAPackage> FloatHalo::Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages)
+{
+    auto pkg = std::make_shared<KHARMAPackage>("FloatHalo");
+    Params &params = pkg->AllParams();
+
+    if (sizeof(Real) != sizeof(double))
+        throw std::invalid_argument("float_halo only makes sense when KHARMA is compiled in double precision!");
+    if (pin->GetOrAddString("parthenon/mesh", "refinement", "none") != "none")
+        throw std::invalid_argument("float_halo cannot be used with mesh refinement!");
+
+    // Options
+    // Comma-separated list of cell-centered variables to exchange in float32.  *.uvec & *.B are vectors, others scalars
+    const std::string var_list = pin->GetOrAddString("float_halo", "variables", "");
+
+    std::vector<std::string> names;
+    int nvar = 0;
+    std::stringstream ss(var_list);
+    std::string var;
+    while (std::getline(ss, var, ',')) {
+        // Trim any whitespace
+        var.erase(0, var.find_first_not_of(" \t"));
+        var.erase(var.find_last_not_of(" \t") + 1);
+        if (var.empty()) continue;
+        names.push_back(var);
+        const std::string name = var.substr(var.rfind('.') + 1);
+        nvar += (name == "uvec" || name == "B") ? NVEC : 1;
+    }
+    if (nvar == 0)
+        throw std::invalid_argument("float_halo/variables must list at least one variable!");
+    params.Add("names", names);
+    params.Add("nvar", nvar);
+    // Shallow copies made for each synchronized MeshData object, see ExchangeData
+    params.Add("exchange_data", std::map<MeshData<Real>*, std::shared_ptr<MeshData<Real>>>(), true);
+
+    // Field: never output or restarted, only meaningful in ghost zones just after an exchange
+    Metadata::AddUserFlag("FloatHalo");
+    std::vector<MetadataFlag> flags_halo = {Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy,
+                                            Metadata::FillGhost, Metadata::GetUserFlag("FloatHalo")};
+    std::vector<int> s_packed({(nvar + 1) / 2});
+    pkg->AddField("halo.packed", Metadata(flags_halo, s_packed));
+
+    return pkg;
+}
+
+std::shared_ptr<MeshData<Real>>& FloatHalo::ExchangeData(std::shared_ptr<MeshData<Real>>& md)
+{
+    auto pmesh = md->GetMeshPointer();
+    if (!pmesh->packages.AllPackages().count("FloatHalo")) return md;
+    auto &params = pmesh->packages.Get("FloatHalo")->AllParams();
+    const auto& names = params.Get<std::vector<std::string>>("names");
+
+    // Only substitute where we can: md must carry the packed field as well as the variables
+    if (md->PackVariables(std::vector<std::string>{"halo.packed"}).GetDim(4) == 0) return md;
+    const int nvar = md->PackVariables(names).GetDim(4);
+    if (nvar == 0) return md;
+    if (nvar != params.Get<int>("nvar"))
+        throw std::runtime_error("float_halo/variables must all be allocated, cell-centered fields!");
+    if (pmesh->multilevel)
+        throw std::runtime_error("float_halo cannot be used with a multilevel mesh!");
+
+    auto exchange_data = params.GetMutable<std::map<MeshData<Real>*, std::shared_ptr<MeshData<Real>>>>("exchange_data");
+    if (!exchange_data->count(md.get())) {
+        Flag("FloatHalo::ExchangeData");
+        // Everything in md besides the listed variables
+        std::vector<std::string> exchange_vars;
+        for (auto &v : md->GetBlockData(0)->GetVariableVector())
+            if (std::find(names.begin(), names.end(), v->label()) == names.end())
+                exchange_vars.push_back(v->label());
+        const std::string label = "float_halo" + std::to_string(exchange_data->size());
+        (*exchange_data)[md.get()] = pmesh->mesh_data.AddShallow(label, md, exchange_vars);
+        EndFlag();
+    }
+    return exchange_data->at(md.get());
+}
+
+TaskStatus FloatHalo::PackHalo(MeshData<Real> *md)
+{
+    Flag("FloatHalo::PackHalo");
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const auto& names = pmb0->packages.Get("FloatHalo")->Param<std::vector<std::string>>("names");
+
+    auto& Q = md->PackVariables(names);
+    auto& H = md->PackVariables(std::vector<std::string>{"halo.packed"});
+    const int nvar = Q.GetDim(4);
+    const int npacked = H.GetDim(4);
+
+    // Neighbors only read a few zones from each face, but a pass over the interior
+    // is cheap next to the exchange, and simpler than one kernel per face
+    const IndexRange3 b = KDomain::GetRange(md, IndexDomain::interior);
+    const IndexRange block = IndexRange{0, md->NumBlocks() - 1};
+    pmb0->par_for("pack_float_halo", block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        KOKKOS_LAMBDA (const int &bl, const int &k, const int &j, const int &i) {
+            for (int p = 0; p < npacked; p++) {
+                const Real hi = (2*p + 1 < nvar) ? Q(bl, 2*p + 1, k, j, i) : 0.;
+                H(bl, p, k, j, i) = pack_floats(Q(bl, 2*p, k, j, i), hi);
+            }
+        }
+    );
+
+    EndFlag();
+    return TaskStatus::complete;
+}
+
+TaskStatus FloatHalo::UnpackHalo(MeshData<Real> *md)
+{
+    Flag("FloatHalo::UnpackHalo");
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const auto& names = pmb0->packages.Get("FloatHalo")->Param<std::vector<std::string>>("names");
+
+    auto& Q = md->PackVariables(names);
+    auto& H = md->PackVariables(std::vector<std::string>{"halo.packed"});
+    const int nvar = Q.GetDim(4);
+
+    // Physical boundaries are unpacked too, then overwritten when they're applied after this
+    const IndexRange3 b = KDomain::GetRange(md, IndexDomain::entire);
+    const IndexRange3 bi = KDomain::GetRange(md, IndexDomain::interior);
+    const IndexRange block = IndexRange{0, md->NumBlocks() - 1};
+    pmb0->par_for("unpack_float_halo", block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        KOKKOS_LAMBDA (const int &bl, const int &k, const int &j, const int &i) {
+            if (k >= bi.ks && k <= bi.ke && j >= bi.js && j <= bi.je && i >= bi.is && i <= bi.ie) return;
+            for (int v = 0; v < nvar; v++)
+                Q(bl, v, k, j, i) = unpack_float(H(bl, v / 2, k, j, i), v % 2);
+        }
+    );
+
+    EndFlag();
+    return TaskStatus::complete;
+}
@@ -0,0 +1,104 @@
+/* 
+ *  File: float_halo.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+#include "types.hpp"
+
+#include <parthenon/parthenon.hpp>
+
+/**
+ * Reduced-precision ghost zone exchange for selected variables.
+ *
+ * Each variable listed in float_halo/variables is rounded to float32 and packed two values
+ * per double into a single field "halo.packed", which is exchanged in place of the listed
+ * variables: their part of each message, over MPI or between local blocks, is halved.
+ * After the exchange, the ghost zones of halo.packed are unpacked back into the listed
+ * variables, and physical boundaries are applied to the full set of variables as usual.
+ *
+ * Only the boundary values are rounded: each block's interior stays in full precision.
+ * The packed bits mean nothing to prolongation/restriction, so this needs a uniform mesh.
+ */
+namespace FloatHalo {
+
+/**
+ * Initialize the packed exchange field and options
+ */
+std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages);
+
+/**
+ * The MeshData object Parthenon should exchange in order to sync md:
+ * a shallow copy with the listed variables replaced by halo.packed, or md itself
+ * if the package isn't loaded or md doesn't carry both.
+ * Use this for StartReceiveBoundBufs, so that receives match what KHARMADriver::AddBoundarySync sends.
+ */
+std::shared_ptr<MeshData<Real>>& ExchangeData(std::shared_ptr<MeshData<Real>>& md);
+
+/**
+ * Round & pack the listed variables' interior values into halo.packed, before sending
+ */
+TaskStatus PackHalo(MeshData<Real> *md);
+
+/**
+ * Unpack the ghost zones of halo.packed back into the listed variables, after receiving.
+ * Interior values are left untouched.
+ */
+TaskStatus UnpackHalo(MeshData<Real> *md);
+
+/**
+ * Bits of two float32s, as one double
+ */
+KOKKOS_INLINE_FUNCTION Real pack_floats(const Real lo, const Real hi)
+{
+    union { float f; uint32_t u; } l, h;
+    l.f = (float) lo;
+    h.f = (float) hi;
+    union { uint64_t u; double d; } val;
+    val.u = (uint64_t) l.u | ((uint64_t) h.u << 32);
+    return val.d;
+}
+
+/**
+ * Recover the float32 in half 0 (low) or 1 (high) of a packed double
+ */
+KOKKOS_INLINE_FUNCTION Real unpack_float(const Real packed, const int half)
+{
+    union { uint64_t u; double d; } val;
+    val.d = packed;
+    union { float f; uint32_t u; } out;
+    out.u = (uint32_t) (val.u >> (32 * half));
+    return (Real) out.f;
+}
+
+}
@@ -34,8 +34,11 @@
 #include "floors.hpp"
 #include "floors_functions.hpp"
 
+#include "emhd_limits.hpp"
+
 #include "grmhd.hpp"
 #include "grmhd_functions.hpp"
+#include "implicit.hpp"
 #include "pack.hpp"
 
 // Floors.  Apply limits to fluid values to maintain integrable state
@@ -134,10 +137,22 @@ std::shared_ptr<KHARMAPackage> Floors::Initialize(ParameterInput *pin, std::shar
     bool disable_floors = pin->GetOrAddBoolean("floors", "disable_floors", false);
     params.Add("disable_floors", disable_floors);
 
+    // Set by the driver during relaxation steps, to use cheaper normal-observer floors
+    params.Add("relaxed", false, true);
+
     // Temporary fix just for being able to save field values
     // Should switch these to "Integer" fields when Parthenon supports it
     Metadata m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy});
     pkg->AddField("fflag", m);
+
+    // Cache the geometric floor values, which need r and usually a pow() in each zone.
+    // Only useful (and only used) in spherical coordinates. Costs 3 cell fields
+    bool cache_geom = pin->GetOrAddBoolean("floors", "cache_geom", pin->GetBoolean("coordinates", "spherical"));
+    params.Add("cache_geom", cache_geom);
+    if (cache_geom && pin->GetBoolean("coordinates", "spherical")) {
+        std::vector<int> s_cache({3});
+        pkg->AddField("floors_geom", Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy}, s_cache));
+    }
     // When not using UtoP, we still need a dummy copy of pflag, too
     // TODO we shouldn't require pflag
     if (!packages->AllPackages().count("Inverter")) {
@@ -152,34 +167,30 @@ std::shared_ptr<KHARMAPackage> Floors::Initialize(ParameterInput *pin, std::shar
     // Count total floors as a history item
     hst_vars.emplace_back(parthenon::HistoryOutputVar(UserHistoryOperation::max, CountFFlags, "FFlags"));
     // TODO Domain::entire version?
-    // TODO entries for each individual flag?
+    // Optionally, zones hit by each individual floor, to correlate slow steps with floor activity
+    if (pin->GetOrAddBoolean("debug", "history_counters", false)) {
+        for (const auto &flag : FFlag::flag_names) {
+            const int flag_val = flag.first;
+            hst_vars.emplace_back(parthenon::HistoryOutputVar(UserHistoryOperation::sum,
+                [flag_val](MeshData<Real> *md) -> Real {
+                    return Reductions::CountFlag(md, "fflag", flag_val, IndexDomain::interior, true);
+                }, "FFlag_" + flag.second));
+        }
+    }
     // add callbacks for HST output to the Params struct, identified by the `hist_param_key`
     pkg->AddParam<>(parthenon::hist_param_key, hst_vars);
 
     return pkg;
 }
 
-TaskStatus Floors::ApplyInitialFloors(ParameterInput *pin, MeshBlockData<Real> *mbd, IndexDomain domain)
+// Floors used for initialization: the run's floors if enabled, otherwise just rho & u geometric
+static Floors::Prescription InitialFloorsPrescription(ParameterInput *pin, Packages_t &packages)
 {
-    Flag("ApplyInitialFloors");
-
-    auto pmb = mbd->GetBlockPointer();
-
-    PackIndexMap prims_map, cons_map;
-    auto P = mbd->PackVariables({Metadata::GetUserFlag("Primitive"), Metadata::Cell}, prims_map);
-    auto U = mbd->PackVariables(std::vector<MetadataFlag>{Metadata::Conserved, Metadata::Cell}, cons_map);
-    const VarMap m_u(cons_map, true), m_p(prims_map, false);
-
-    const auto& G = pmb->coords;
-
-    const Real gam = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
-
-
     // If we're going to apply floors through the run, apply the same ones at init
     // Otherwise stick to specified/default geometric floors
     Floors::Prescription floors_tmp;
-    if (pmb->packages.AllPackages().count("Floors")) {
-        floors_tmp = Floors::Prescription(pmb->packages.Get("Floors")->AllParams());
+    if (packages.AllPackages().count("Floors")) {
+        floors_tmp = Floors::Prescription(packages.Get("Floors")->AllParams());
     } else {
             // JUST rho & u geometric
             floors_tmp.rho_min_geom = pin->GetOrAddReal("floors", "rho_min_geom", 1e-6);
@@ -202,7 +213,25 @@ TaskStatus Floors::ApplyInitialFloors(ParameterInput *pin, MeshBlockData<Real> *
             floors_tmp.frame_switch  = 0.; //unused
             floors_tmp.drift_frame   = false;
     }
-    const Floors::Prescription floors = floors_tmp;
+    return floors_tmp;
+}
+
+TaskStatus Floors::ApplyInitialFloors(ParameterInput *pin, MeshBlockData<Real> *mbd, IndexDomain domain)
+{
+    Flag("ApplyInitialFloors");
+
+    auto pmb = mbd->GetBlockPointer();
+
+    PackIndexMap prims_map, cons_map;
+    auto P = mbd->PackVariables({Metadata::GetUserFlag("Primitive"), Metadata::Cell}, prims_map);
+    auto U = mbd->PackVariables(std::vector<MetadataFlag>{Metadata::Conserved, Metadata::Cell}, cons_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+
+    const auto& G = pmb->coords;
+
+    const Real gam = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
+
+    const Floors::Prescription floors = InitialFloorsPrescription(pin, pmb->packages);
 
     const EMHD::EMHD_parameters& emhd_params = EMHD::GetEMHDParameters(pmb->packages);
 
@@ -224,7 +253,46 @@ TaskStatus Floors::ApplyInitialFloors(ParameterInput *pin, MeshBlockData<Real> *
     return TaskStatus::complete;
 }
 
-TaskStatus Floors::ApplyGRMHDFloors(MeshBlockData<Real> *mbd, IndexDomain domain)
+TaskStatus Floors::ApplyInitialFloors(ParameterInput *pin, MeshData<Real> *md, IndexDomain domain)
+{
+    Flag("ApplyInitialFloorsMesh");
+
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+
+    PackIndexMap prims_map, cons_map;
+    auto P = md->PackVariables({Metadata::GetUserFlag("Primitive"), Metadata::Cell}, prims_map);
+    auto U = md->PackVariables(std::vector<MetadataFlag>{Metadata::Conserved, Metadata::Cell}, cons_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+
+    const Real gam = pmb0->packages.Get("GRMHD")->Param<Real>("gamma");
+
+    const Floors::Prescription floors = InitialFloorsPrescription(pin, pmb0->packages);
+
+    const EMHD::EMHD_parameters& emhd_params = EMHD::GetEMHDParameters(pmb0->packages);
+
+    const IndexRange ib = md->GetBoundsI(domain);
+    const IndexRange jb = md->GetBoundsJ(domain);
+    const IndexRange kb = md->GetBoundsK(domain);
+    const IndexRange block = IndexRange{0, P.GetDim(5) - 1};
+    pmb0->par_for("apply_initial_floors_mesh", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int &b, const int &k, const int &j, const int &i) {
+            const auto& G = P.GetCoords(b);
+            apply_floors(G, P(b), m_p, gam, emhd_params, k, j, i, floors, U(b), m_u);
+            apply_ceilings(G, P(b), m_p, gam, k, j, i, floors, U(b), m_u);
+        }
+    );
+
+    EndFlag();
+    return TaskStatus::complete;
+}
+
+namespace Floors {
+
+/**
+ * ApplyGRMHDFloors for a single floor frame, so the floor kernel carries only that frame's code path
+ */
+template<Frame frame>
+TaskStatus ApplyGRMHDFloorsImpl(MeshBlockData<Real> *mbd, IndexDomain domain)
 {
     auto pmb = mbd->GetBlockPointer();
 
@@ -237,10 +305,18 @@ TaskStatus Floors::ApplyGRMHDFloors(MeshBlockData<Real> *mbd, IndexDomain domain
 
     GridScalar pflag = mbd->Get("pflag").data;
     GridScalar fflag = mbd->Get("fflag").data;
+    // Empty unless floors/cache_geom is set
+    auto geom_cache = mbd->PackVariables(std::vector<std::string>{"floors_geom"});
+    const bool use_cache = geom_cache.GetDim(4) > 0;
 
     const Real gam = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
     const Floors::Prescription floors(pmb->packages.Get("Floors")->AllParams());
     const EMHD::EMHD_parameters& emhd_params = EMHD::GetEMHDParameters(pmb->packages);
+    // The EMHD instability limits are applied in the ceiling pass below, rather than in their own kernel
+    const bool emhd_limits = pmb->packages.AllPackages().count("EMHD") &&
+                             pmb->packages.Get("EMHD")->Param<bool>("enable_emhd_limits");
+    GridScalar eflag;
+    if (emhd_limits) eflag = mbd->Get("eflag").data;
 
     // Apply floors over the same zones we just updated with UtoP
     // This selects the entire domain, but we then require pflag >= 0,
@@ -249,43 +325,82 @@ TaskStatus Floors::ApplyGRMHDFloors(MeshBlockData<Real> *mbd, IndexDomain domain
     const IndexRange ib = mbd->GetBoundsI(domain);
     const IndexRange jb = mbd->GetBoundsJ(domain);
     const IndexRange kb = mbd->GetBoundsK(domain);
-    
-    pmb->par_for("apply_floors", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-        KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-            if (((int) pflag(k, j, i)) >= (int) Inverter::Status::success) {
-                // apply_floors can involve another U_to_P call.  Hide the pflag in bottom 5 bits and retrieve both
-                int comboflag = apply_floors(G, P, m_p, gam, emhd_params, k, j, i, floors, U, m_u);
-                fflag(k, j, i) = (comboflag / FFlag::MINIMUM) * FFlag::MINIMUM;
-
-                // Record the pflag as well.  KHARMA did not traditionally do this,
-                // because floors were run over uninitialized zones, and thus wrote
-                // garbage pflags.  We now prevent this.
-                // Note that the pflag is recorded only if inversion failed,
-                // so that a zone is flagged if *either* the initial inversion or
-                // post-floor inversion failed.
-                // Zones next to the sharp edge of the initial torus, for example,
-                // can produce negative u when inverted, then magically stay invertible
-                // after floors when they should be diffused.
-                if (comboflag % FFlag::MINIMUM) {
-                    pflag(k, j, i) = comboflag % FFlag::MINIMUM;
-                }
 
-#if !FUSE_FLOOR_KERNELS
+    // Most zones hit no floors.  Mark those which do with a cheap first pass (needs_floors),
+    // so that the full apply_floors is only evaluated there, and launched only if any are marked.
+    // Marked zones hold fflag -1 until they are floored below
+    int n_marked = 0;
+    Kokkos::Sum<int> sum_reducer(n_marked);
+    pmb->par_reduce("mark_floors", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int &k, const int &j, const int &i, int &local_result) {
+            bool marked = false;
+            if (((int) pflag(k, j, i)) >= (int) Inverter::Status::success) {
+                Real rhoflr_geom, uflr_geom;
+                bool use_ff;
+                if (use_cache) geo_floor_values(G, gam, k, j, i, floors, geom_cache, rhoflr_geom, uflr_geom, use_ff);
+                else geo_floor_values(G, gam, k, j, i, floors, Loci::center, rhoflr_geom, uflr_geom, use_ff);
+                marked = needs_floors(G, P, m_p, gam, k, j, i, floors, rhoflr_geom, uflr_geom);
             }
+            fflag(k, j, i) = -marked;
+            local_result += marked;
         }
-    );
-    pmb->par_for("apply_ceilings", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-        KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-            if (((int) pflag(k, j, i)) >= (int) Inverter::Status::success) {
+    , sum_reducer);
+
+    if (n_marked > 0) {
+        pmb->par_for("apply_floors", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
+                if (fflag(k, j, i) < 0) {
+                    // apply_floors can involve another U_to_P call.  Hide the pflag in bottom 5 bits and retrieve both
+                    Real rhoflr_geom, uflr_geom;
+                    bool use_ff;
+                    if (use_cache) geo_floor_values(G, gam, k, j, i, floors, geom_cache, rhoflr_geom, uflr_geom, use_ff);
+                    else geo_floor_values(G, gam, k, j, i, floors, Loci::center, rhoflr_geom, uflr_geom, use_ff);
+                    int comboflag = apply_floors<frame>(G, P, m_p, gam, emhd_params, k, j, i, floors,
+                                                        rhoflr_geom, uflr_geom, use_ff, U, m_u);
+                    fflag(k, j, i) = (comboflag / FFlag::MINIMUM) * FFlag::MINIMUM;
+
+                    // Record the pflag as well.  KHARMA did not traditionally do this,
+                    // because floors were run over uninitialized zones, and thus wrote
+                    // garbage pflags.  We now prevent this.
+                    // Note that the pflag is recorded only if inversion failed,
+                    // so that a zone is flagged if *either* the initial inversion or
+                    // post-floor inversion failed.
+                    // Zones next to the sharp edge of the initial torus, for example,
+                    // can produce negative u when inverted, then magically stay invertible
+                    // after floors when they should be diffused.
+                    if (comboflag % FFlag::MINIMUM) {
+                        pflag(k, j, i) = comboflag % FFlag::MINIMUM;
+                    }
+                }
+#if FUSE_FLOOR_KERNELS
+                if (((int) pflag(k, j, i)) >= (int) Inverter::Status::success) {
+                    fflag(k, j, i) = ((int) fflag(k, j, i)) | apply_ceilings(G, P, m_p, gam, k, j, i, floors, U, m_u,
+                                                                             Loci::center, !emhd_limits);
+                }
+                // The limits end with p_to_u, covering the ceilings too
+                if (emhd_limits)
+                    eflag(k, j, i) = EMHD::apply_instability_limits(G, P, m_p, gam, emhd_params, k, j, i, U, m_u);
 #endif
-                // Apply ceilings *after* floors, to make the temperature ceiling better-behaved
-                // Ceilings never involve a u_to_p call
-                int addflag = fflag(k, j, i);
-                addflag |= apply_ceilings(G, P, m_p, gam, k, j, i, floors, U, m_u);
-                fflag(k, j, i) = addflag;
             }
-        }
-    );
+        );
+    }
+
+    // Otherwise, ceilings get their own kernel
+    if (!FUSE_FLOOR_KERNELS || n_marked == 0) {
+        pmb->par_for("apply_ceilings", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
+                if (((int) pflag(k, j, i)) >= (int) Inverter::Status::success) {
+                    // Apply ceilings *after* floors, to make the temperature ceiling better-behaved
+                    // Ceilings never involve a u_to_p call
+                    int addflag = fflag(k, j, i);
+                    addflag |= apply_ceilings(G, P, m_p, gam, k, j, i, floors, U, m_u, Loci::center, !emhd_limits);
+                    fflag(k, j, i) = addflag;
+                }
+                if (emhd_limits)
+                    eflag(k, j, i) = EMHD::apply_instability_limits(G, P, m_p, gam, emhd_params, k, j, i, U, m_u);
+            }
+        );
+    }
 
     //if (flag_verbose)
     //Reductions::StartFlagReduce(md, "fflag", FFlag::flag_names, IndexDomain::interior, true, 0);
@@ -293,6 +408,24 @@ TaskStatus Floors::ApplyGRMHDFloors(MeshBlockData<Real> *mbd, IndexDomain domain
     return TaskStatus::complete;
 }
 
+} // namespace Floors
+
+TaskStatus Floors::ApplyGRMHDFloors(MeshBlockData<Real> *mbd, IndexDomain domain)
+{
+    // Frame is fixed for the run, except relaxation steps, which use normal observer frame
+    const Floors::Prescription floors(mbd->GetBlockPointer()->packages.Get("Floors")->AllParams());
+    switch (floors.frame()) {
+    case Frame::fluid:
+        return ApplyGRMHDFloorsImpl<Frame::fluid>(mbd, domain);
+    case Frame::mixed:
+        return ApplyGRMHDFloorsImpl<Frame::mixed>(mbd, domain);
+    case Frame::drift:
+        return ApplyGRMHDFloorsImpl<Frame::drift>(mbd, domain);
+    default:
+        return ApplyGRMHDFloorsImpl<Frame::normal>(mbd, domain);
+    }
+}
+
 TaskStatus Floors::PostStepDiagnostics(const SimTime& tm, MeshData<Real> *md)
 {
     auto pmesh = md->GetMeshPointer();
@@ -304,9 +437,16 @@ TaskStatus Floors::PostStepDiagnostics(const SimTime& tm, MeshData<Real> *md)
     // Debugging/diagnostic info about floor flags
     if (flag_verbose > 0) {
         // TODO this should move to ApplyGRMHDFloors when everything goes MeshData
-        Reductions::StartFlagReduce(md, "fflag", FFlag::flag_names, IndexDomain::interior, true, 0);
-        // Debugging/diagnostic info about floor and inversion flags
-        Reductions::CheckFlagReduceAndPrintHits(md, "fflag", FFlag::flag_names, IndexDomain::interior, true, 0);
+        // Count pflags & solver failures in the same pass if we'll want them, and send every count
+        // in one reduction.  See Inverter::PostStepDiagnostics, Implicit::PostStepDiagnostics
+        std::vector<Reductions::FlagField> fields = {{"fflag", FFlag::flag_names, true}};
+        if (pmesh->packages.AllPackages().count("Inverter"))
+            fields.push_back({"pflag", Inverter::status_names, false});
+        if (pmesh->packages.AllPackages().count("Implicit"))
+            fields.push_back({"solve_fail", Implicit::status_names, false});
+        Reductions::StartFlagCensus(md, fields, IndexDomain::interior, 0);
+        // Debugging/diagnostic info about floor, inversion and solver flags
+        Reductions::CheckFlagCensusAndPrintHits(md, fields, IndexDomain::interior, 0);
     }
 
     // Anything else (energy conservation? Added material stats?)
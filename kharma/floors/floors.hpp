@@ -86,6 +86,13 @@ static const std::map<int, std::string> flag_names = {
 
 namespace Floors {
 
+/**
+ * Frame in which material is added by apply_floors.  Used as a template parameter,
+ * so that each floor kernel contains only the paths it can take.
+ * Mixed uses the fluid frame outside frame_switch, and the normal observer frame inside.
+ */
+enum class Frame{normal, fluid, mixed, drift};
+
 /**
  * Struct to hold floor values without cumbersome dictionary/string logistics.
  * Hopefully faster than dragging the full Params object device side,
@@ -126,6 +133,19 @@ class Prescription {
             fluid_frame   = params.Get<bool>("fluid_frame");
             mixed_frame   = params.Get<bool>("mixed_frame");
             drift_frame   = params.Get<bool>("drift_frame");
+
+            // Relaxation steps use normal observer frame floors, see KHARMADriver::MakeRelaxTaskCollection
+            if (params.Get<bool>("relaxed")) {
+                fluid_frame = mixed_frame = drift_frame = false;
+            }
+        }
+
+        KOKKOS_INLINE_FUNCTION Frame frame() const
+        {
+            if (fluid_frame) return Frame::fluid;
+            if (mixed_frame) return Frame::mixed;
+            if (drift_frame) return Frame::drift;
+            return Frame::normal;
         }
 };
 
@@ -153,6 +173,7 @@ TaskStatus ApplyGRMHDFloors(MeshBlockData<Real> *rc, IndexDomain domain);
  * This function can be called even if the Floors package is not initialized.
  */
 TaskStatus ApplyInitialFloors(ParameterInput *pin, MeshBlockData<Real> *mbd, IndexDomain domain);
+TaskStatus ApplyInitialFloors(ParameterInput *pin, MeshData<Real> *md, IndexDomain domain);
 
 /**
  * Print a summary of floors hit
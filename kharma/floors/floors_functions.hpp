@@ -50,7 +50,8 @@ namespace Floors {
  */
 KOKKOS_INLINE_FUNCTION int apply_ceilings(const GRCoordinates& G, const VariablePack<Real>& P, const VarMap& m_p,
                                           const Real& gam, const int& k, const int& j, const int& i, const Floors::Prescription& floors,
-                                          const VariablePack<Real>& U, const VarMap& m_u, const Loci loc=Loci::center)
+                                          const VariablePack<Real>& U, const VarMap& m_u, const Loci loc=Loci::center,
+                                          const bool update_u=true)
 {
     int fflag = 0;
     // First apply ceilings:
@@ -89,8 +90,8 @@ KOKKOS_INLINE_FUNCTION int apply_ceilings(const GRCoordinates& G, const Variable
         P(m_p.UU, k, j, i) = floors.u_over_rho_max * P(m_p.RHO, k, j, i);
     }
 
-    if (fflag) {
-        // Keep lockstep!
+    // Keep lockstep!  Unless the caller will do so anyway, e.g. after the EMHD limits
+    if (fflag && update_u) {
         GRMHD::p_to_u(G, P, m_p, gam, k, j, i, U, m_u, loc);
     }
 
@@ -98,24 +99,13 @@ KOKKOS_INLINE_FUNCTION int apply_ceilings(const GRCoordinates& G, const Variable
 }
 
 /**
- * Apply floors of several types in determining how to add mass and internal energy to preserve stability.
- * All floors which might apply are recorded separately, then mass/energy are added *in normal observer frame*
- * 
- * @return fflag + pflag: fflag is a flagset starting at the sixth bit from the right.  pflag is a number <32.
- * This returns the sum, with the caller responsible for separating what's desired.
- * 
- * LOCKSTEP: this function respects P and ignores U in order to return consistent P<->U
+ * Geometric floor values for rho and u in a zone, and whether floors there should be applied in the fluid frame.
+ * Shared by apply_floors and the cheap check needs_floors
  */
-KOKKOS_INLINE_FUNCTION int apply_floors(const GRCoordinates& G, const VariablePack<Real>& P, const VarMap& m_p,
-                                        const Real& gam, const EMHD::EMHD_parameters& emhd_params,
-                                        const int& k, const int& j, const int& i, const Floors::Prescription& floors,
-                                        const VariablePack<Real>& U, const VarMap& m_u, const Loci loc=Loci::center)
+KOKKOS_INLINE_FUNCTION void geo_floor_values(const GRCoordinates& G, const Real& gam,
+                                             const int& k, const int& j, const int& i, const Floors::Prescription& floors,
+                                             const Loci loc, Real& rhoflr_geom, Real& uflr_geom, bool& use_ff)
 {
-    int fflag = 0;
-    // Then apply floors:
-    // 1. Geometric hard floors, not based on fluid relationships
-    Real rhoflr_geom, uflr_geom;
-    bool use_ff, use_df;
     if(G.coords.is_spherical()) {
         GReal Xembed[GR_DIM];
         G.coord_embed(k, j, i, loc, Xembed);
@@ -125,8 +115,6 @@ KOKKOS_INLINE_FUNCTION int apply_floors(const GRCoordinates& G, const VariablePa
 
         // Use the fluid frame if specified, or in outer domain
         use_ff = floors.fluid_frame || (floors.mixed_frame && r > floors.frame_switch);
-        // Use the drift frame if specified
-        use_df = floors.drift_frame;
 
         if (floors.use_r_char) {
             // Steeper floor from iharm3d
@@ -143,8 +131,110 @@ KOKKOS_INLINE_FUNCTION int apply_floors(const GRCoordinates& G, const VariablePa
         rhoflr_geom = floors.rho_min_geom;
         uflr_geom   = floors.u_min_geom;
         use_ff      = floors.fluid_frame;
-        use_df      = floors.drift_frame;
     }
+}
+
+/**
+ * As geo_floor_values at zone centers, reading values from a cache field if present.
+ * Fields are zero-initialized, so zones are filled on first use, including in any new blocks after remeshing.
+ * The cache holds rho & u floors and the choice of frame, see "floors_geom" in Floors::Initialize
+ */
+template<typename Global>
+KOKKOS_INLINE_FUNCTION void geo_floor_values(const GRCoordinates& G, const Real& gam,
+                                             const int& k, const int& j, const int& i, const Floors::Prescription& floors,
+                                             const Global& cache, Real& rhoflr_geom, Real& uflr_geom, bool& use_ff)
+{
+    if (cache(0, k, j, i) > 0.) {
+        rhoflr_geom = cache(0, k, j, i);
+        uflr_geom   = cache(1, k, j, i);
+        use_ff      = cache(2, k, j, i) > 0.;
+    } else {
+        geo_floor_values(G, gam, k, j, i, floors, Loci::center, rhoflr_geom, uflr_geom, use_ff);
+        cache(0, k, j, i) = rhoflr_geom;
+        cache(1, k, j, i) = uflr_geom;
+        cache(2, k, j, i) = use_ff;
+    }
+}
+
+/**
+ * Whether apply_floors would change anything in a zone.  Evaluates the same floors,
+ * but computes only bsq rather than the full set of 4-vectors:
+ * with u_i = gcov_ij utilde^j and b^0 = B^i u_i, bsq = (gcov_ij B^i B^j + (b^0)^2) / (u^0)^2
+ * 
+ * Used to skip the (large) apply_floors kernel in zones and blocks which don't hit any floor
+ */
+template<typename Global>
+KOKKOS_INLINE_FUNCTION bool needs_floors(const GRCoordinates& G, const Global& P, const VarMap& m_p,
+                                         const Real& gam, const int& k, const int& j, const int& i,
+                                         const Floors::Prescription& floors, const Real& rhoflr_geom, const Real& uflr_geom,
+                                         const Loci loc=Loci::center)
+{
+    const Real rho = P(m_p.RHO, k, j, i);
+    const Real u   = P(m_p.UU, k, j, i);
+
+    Real bsq = 0.;
+    if (m_p.B1 >= 0) {
+        Real ucov[NVEC] = {0}, BB = 0., Bu = 0., qsq = 0.;
+        VLOOP2 {
+            const Real gvw = G.gcov(loc, j, i, v+1, w+1);
+            ucov[v] += gvw * P(m_p.U1 + w, k, j, i);
+            BB      += gvw * P(m_p.B1 + v, k, j, i) * P(m_p.B1 + w, k, j, i);
+        }
+        VLOOP {
+            qsq += ucov[v] * P(m_p.U1 + v, k, j, i);
+            Bu  += ucov[v] * P(m_p.B1 + v, k, j, i);
+        }
+        // (u^0)^2 = gamma^2 / alpha^2 = -gcon^00 (1 + qsq)
+        const Real ut_sq = -G.gcon(loc, j, i, 0, 0) * (1. + qsq);
+        bsq = (BB + Bu*Bu) / ut_sq;
+    }
+
+    const Real uflr_max = m::max(uflr_geom, bsq / floors.bsq_over_u_max);
+    Real rhoflr_max = m::max(rhoflr_geom, bsq / floors.bsq_over_rho_max);
+    if (!floors.temp_adjust_u)
+        rhoflr_max = m::max(rhoflr_max, m::max(u, uflr_max) / floors.u_over_rho_max);
+
+    return rhoflr_max > rho || uflr_max > u;
+}
+template<typename Global>
+KOKKOS_INLINE_FUNCTION bool needs_floors(const GRCoordinates& G, const Global& P, const VarMap& m_p,
+                                         const Real& gam, const int& k, const int& j, const int& i,
+                                         const Floors::Prescription& floors, const Loci loc=Loci::center)
+{
+    Real rhoflr_geom, uflr_geom;
+    bool use_ff;
+    geo_floor_values(G, gam, k, j, i, floors, loc, rhoflr_geom, uflr_geom, use_ff);
+    return needs_floors(G, P, m_p, gam, k, j, i, floors, rhoflr_geom, uflr_geom, loc);
+}
+
+/**
+ * Apply floors of several types in determining how to add mass and internal energy to preserve stability.
+ * All floors which might apply are recorded separately, then mass/energy are added *in normal observer frame*
+ * 
+ * @return fflag + pflag: fflag is a flagset starting at the sixth bit from the right.  pflag is a number <32.
+ * This returns the sum, with the caller responsible for separating what's desired.
+ * 
+ * The frame must match floors.frame().  use_ff is only read for the mixed frame.
+ *
+ * LOCKSTEP: this function respects P and ignores U in order to return consistent P<->U
+ */
+template<Frame frame>
+KOKKOS_INLINE_FUNCTION int apply_floors(const GRCoordinates& G, const VariablePack<Real>& P, const VarMap& m_p,
+                                        const Real& gam, const EMHD::EMHD_parameters& emhd_params,
+                                        const int& k, const int& j, const int& i, const Floors::Prescription& floors,
+                                        const Real& rhoflr_geom, const Real& uflr_geom, const bool& use_ff,
+                                        const VariablePack<Real>& U, const VarMap& m_u, const Loci loc=Loci::center)
+{
+    int fflag = 0;
+    // Then apply floors:
+    // 1. Geometric hard floors, not based on fluid relationships, are passed in
+    bool in_ff;
+    if constexpr (frame == Frame::mixed) {
+        in_ff = use_ff;
+    } else {
+        in_ff = (frame == Frame::fluid);
+    }
+
     Real rho = P(m_p.RHO, k, j, i);
     Real u   = P(m_p.UU, k, j, i);
 
@@ -185,13 +275,13 @@ KOKKOS_INLINE_FUNCTION int apply_floors(const GRCoordinates& G, const VariablePa
         fflag |= (rhoflr_b > rho) * FFlag::B_RHO;
         fflag |= (uflr_b > u) * FFlag::B_U;
 
-        if (use_ff) {
+        if (in_ff) {
             P(m_p.RHO, k, j, i) += m::max(0., rhoflr_max - rho);
             P(m_p.UU, k, j, i)  += m::max(0., uflr_max - u);
             // Update conserved variables
             //Flux::p_to_u(G, P, m_p, emhd_params, gam, k, j, i, U, m_u, loc);
             GRMHD::p_to_u(G, P, m_p, gam, k, j, i, U, m_u, loc);
-        } else if (use_df) {
+        } else if constexpr (frame == Frame::drift) {
             // Drift frame floors. Refer to Appendix B3 in https://doi.org/10.1093/mnras/stx364 (hereafter R17)
             const Real lapse2    = 1. / (-G.gcon(Loci::center, j, i, 0, 0));
             double beta[GR_DIM] = {0};
@@ -284,7 +374,8 @@ KOKKOS_INLINE_FUNCTION int apply_floors(const GRCoordinates& G, const VariablePa
             
             // Recover primitive variables from conserved versions
             // TODO selector here when we get more options
-            Inverter::Status pflag = Inverter::u_to_p<Inverter::Type::onedw>(G, U, m_u, gam, k, j, i, P, m_p, loc);
+            int iters;
+            Inverter::Status pflag = Inverter::u_to_p<Inverter::Type::onedw>(G, U, m_u, gam, k, j, i, P, m_p, loc, iters);
             // 4. If the inversion fails, we've effectively already applied the floors in fluid-frame to the prims,
             // so we just formalize that
             if (Inverter::failed(pflag)) {
@@ -303,17 +394,38 @@ KOKKOS_INLINE_FUNCTION int apply_floors(const GRCoordinates& G, const VariablePa
         const Real reduce   = m::pow(rho / P(m_p.RHO, k, j, i), gam);
         const Real reduce_e = m::pow(rho / P(m_p.RHO, k, j, i), 4./3); // TODO pipe in real gam_e
         if (m_p.KTOT >= 0) P(m_p.KTOT, k, j, i) *= reduce;
-        if (m_p.K_CONSTANT >= 0) P(m_p.K_CONSTANT, k, j, i) *= reduce_e;
-        if (m_p.K_HOWES >= 0)    P(m_p.K_HOWES, k, j, i)    *= reduce_e;
-        if (m_p.K_KAWAZURA >= 0) P(m_p.K_KAWAZURA, k, j, i) *= reduce_e;
-        if (m_p.K_WERNER >= 0)   P(m_p.K_WERNER, k, j, i)   *= reduce_e;
-        if (m_p.K_ROWAN >= 0)    P(m_p.K_ROWAN, k, j, i)    *= reduce_e;
-        if (m_p.K_SHARMA >= 0)   P(m_p.K_SHARMA, k, j, i)   *= reduce_e;
+        if (var_allocated(P, m_p.K_CONSTANT)) P(m_p.K_CONSTANT, k, j, i) *= reduce_e;
+        if (var_allocated(P, m_p.K_HOWES))    P(m_p.K_HOWES, k, j, i)    *= reduce_e;
+        if (var_allocated(P, m_p.K_KAWAZURA)) P(m_p.K_KAWAZURA, k, j, i) *= reduce_e;
+        if (var_allocated(P, m_p.K_WERNER))   P(m_p.K_WERNER, k, j, i)   *= reduce_e;
+        if (var_allocated(P, m_p.K_ROWAN))    P(m_p.K_ROWAN, k, j, i)    *= reduce_e;
+        if (var_allocated(P, m_p.K_SHARMA))   P(m_p.K_SHARMA, k, j, i)   *= reduce_e;
     }
 
     // Return fflag (with pflag added if NOF floors were used!)
     return fflag;
 }
+// Version computing the geometric floors itself, and choosing the frame at runtime.
+// Only for kernels run once, e.g. initial floors: step kernels should be templated on the frame
+KOKKOS_INLINE_FUNCTION int apply_floors(const GRCoordinates& G, const VariablePack<Real>& P, const VarMap& m_p,
+                                        const Real& gam, const EMHD::EMHD_parameters& emhd_params,
+                                        const int& k, const int& j, const int& i, const Floors::Prescription& floors,
+                                        const VariablePack<Real>& U, const VarMap& m_u, const Loci loc=Loci::center)
+{
+    Real rhoflr_geom, uflr_geom;
+    bool use_ff;
+    geo_floor_values(G, gam, k, j, i, floors, loc, rhoflr_geom, uflr_geom, use_ff);
+    switch (floors.frame()) {
+    case Frame::fluid:
+        return apply_floors<Frame::fluid>(G, P, m_p, gam, emhd_params, k, j, i, floors, rhoflr_geom, uflr_geom, use_ff, U, m_u, loc);
+    case Frame::mixed:
+        return apply_floors<Frame::mixed>(G, P, m_p, gam, emhd_params, k, j, i, floors, rhoflr_geom, uflr_geom, use_ff, U, m_u, loc);
+    case Frame::drift:
+        return apply_floors<Frame::drift>(G, P, m_p, gam, emhd_params, k, j, i, floors, rhoflr_geom, uflr_geom, use_ff, U, m_u, loc);
+    default:
+        return apply_floors<Frame::normal>(G, P, m_p, gam, emhd_params, k, j, i, floors, rhoflr_geom, uflr_geom, use_ff, U, m_u, loc);
+    }
+}
 
 /**
  * Apply just the geometric floors to a set of local primitives.
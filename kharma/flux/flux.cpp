@@ -37,10 +37,22 @@
 
 #include "b_ct.hpp"
 #include "grmhd.hpp"
+#include "inverter.hpp"
 #include "kharma.hpp"
+#include "kharma_config.hpp"
+#include "wind.hpp"
+
+#include <algorithm>
 
 using namespace parthenon;
 
+// Blocks with a finer neighbor, see GetFinerNeighbors
+struct FinerNeighbors {
+    std::vector<int> flags_h;
+    ParArray1D<int> finer;
+    bool any = false, all = false;
+};
+
 // GetFlux is in the header file get_flux.hpp, as it is templated on reconstruction scheme and flux direction
 
 std::shared_ptr<KHARMAPackage> Flux::Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages)
@@ -58,12 +70,30 @@ std::shared_ptr<KHARMAPackage> Flux::Initialize(ParameterInput *pin, std::shared
     // TODO optionally move all these to faces? Not important yet, & faces have no output, more memory
     std::vector<MetadataFlag> flags_flux = {Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy};
     Metadata m = Metadata(flags_flux, s_flux);
-    pkg->AddField("Flux.Pr", m);
-    pkg->AddField("Flux.Pl", m);
-    pkg->AddField("Flux.Ur", m);
-    pkg->AddField("Flux.Ul", m);
-    pkg->AddField("Flux.Fr", m);
-    pkg->AddField("Flux.Fl", m);
+    // The fused flux kernel keeps face states in scratch, so these mesh-sized fields
+    // are only needed for the split kernels, or when asked for (e.g. to output them)
+    const bool fused_flux = packages->Get("Driver")->Param<bool>("fused_flux");
+    const bool keep_face_states = pin->GetOrAddBoolean("flux", "keep_face_states", !fused_flux);
+    if (!fused_flux && !keep_face_states)
+        throw std::invalid_argument("Face states can only be dropped when using driver/fused_flux!");
+    params.Add("keep_face_states", keep_face_states);
+    if (keep_face_states) {
+        pkg->AddField("Flux.Pr", m);
+        pkg->AddField("Flux.Pl", m);
+        pkg->AddField("Flux.Ur", m);
+        pkg->AddField("Flux.Ul", m);
+        pkg->AddField("Flux.Fr", m);
+        pkg->AddField("Flux.Fl", m);
+    }
+
+    // Optionally correct face-center fluxes to face averages, adding the transverse Laplacian
+    // <F> = F + (1/24) (d_j^2 F + d_k^2 F), see FourthOrderCorrection.  The point fluxes are kept in Flux.Fpoint
+    const bool fourth_order = pin->GetOrAddBoolean("flux", "fourth_order", false);
+    if (fourth_order && KReconstruction::stencil_width(pin->GetString("driver", "reconstruction")) < 5)
+        throw std::invalid_argument("Fourth-order flux correction requires a 5-point reconstruction, e.g. weno5!");
+    params.Add("fourth_order", fourth_order);
+    if (fourth_order)
+        pkg->AddField("Flux.Fpoint", m);
 
     std::vector<int> s_vector({NVEC});
     std::vector<MetadataFlag> flags_speed = {Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy};
@@ -79,22 +109,110 @@ std::shared_ptr<KHARMAPackage> Flux::Initialize(ParameterInput *pin, std::shared
         pkg->AddField("Flux.vl", m);
     }
 
-    // We register the geometric (\Gamma*T) source here
-    pkg->AddSource = Flux::AddGeoSource;
+    // Optionally compute the flux divergence and geometric source in one sweep,
+    // see FluxDivergenceGeoSource.  The driver swaps out Update::FluxDivergence if set.
+    const bool fused_geo_source = pin->GetOrAddBoolean("flux", "fused_geo_source", false);
+    params.Add("fused_geo_source", fused_geo_source);
+
+    // Optionally compute the flux divergence in two parts: every zone whose fluxes can't be corrected first,
+    // while flux corrections/EMFs are exchanged with neighbors, then zones on the faces of blocks with
+    // finer neighbors once they arrive.  Blocks without finer neighbors don't wait on the exchange at all.
+    // Only has an effect with AMR or face-centered B (otherwise there is no exchange to wait on)
+    const bool overlap_flux_comm = pin->GetOrAddBoolean("flux", "overlap_flux_comm", false);
+    params.Add("overlap_flux_comm", overlap_flux_comm);
+
+    // The wind source is applied in the same sweep as the geometric source (wherever that is),
+    // rather than in its own kernel.  Flux is loaded after all physics, so Wind is already here
+    const bool fuse_wind = packages->AllPackages().count("Wind");
+    params.Add("fuse_wind", fuse_wind);
+    if (fuse_wind)
+        packages->Get<KHARMAPackage>("Wind")->AddSource = nullptr;
+
+    // Optionally, recompute U at the end of each stage only in zones whose primitives were replaced after
+    // UtoP.  Floors & domain boundaries keep U up to date themselves, leaving only the zones fixed by
+    // FixUtoP or recovered from entropy (see Inverter::replaced).  The driver falls back to the full PtoU on stages with electron heating or primitive sources
+    const bool ptou_changed_only = pin->GetOrAddBoolean("flux", "ptou_changed_only", false);
+    params.Add("ptou_changed_only", ptou_changed_only);
+
+    // Packs for GetFlux, cached per MeshData object. See GetFluxPacks
+    params.Add("flux_packs", std::map<MeshData<Real>*, Flux::FluxPacks>(), true);
+    // Which blocks have finer neighbors, per MeshData object. See GetFinerNeighbors
+    params.Add("finer_neighbors", std::map<MeshData<Real>*, FinerNeighbors>(), true);
+
+    // We register the geometric (\Gamma*T) source here, unless it's added with the divergence
+    if (!fused_geo_source)
+        pkg->AddSource = Flux::AddGeoSource;
 
     EndFlag();
     return pkg;
 }
 
+const Flux::FluxPacks& Flux::GetFluxPacks(MeshData<Real> *md)
+{
+    auto pmesh = md->GetMeshPointer();
+    auto& params = pmesh->packages.Get("Flux")->AllParams();
+    auto& all_packs = *params.GetMutable<std::map<MeshData<Real>*, FluxPacks>>("flux_packs");
+    auto& packs = all_packs[md];
+
+    const int nb = md->NumBlocks();
+    std::vector<MeshBlockData<Real>*> blocks(nb);
+    for (int b = 0; b < nb; b++) blocks[b] = md->GetBlockData(b).get();
+    if (packs.blocks == blocks) return packs;
+
+    packs.blocks = blocks;
+    PackIndexMap prims_map, cons_map;
+    packs.cmax   = md->PackVariables(std::vector<std::string>{"Flux.cmax"});
+    packs.cmin   = md->PackVariables(std::vector<std::string>{"Flux.cmin"});
+    packs.P_all  = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive"), Metadata::Cell}, prims_map);
+    packs.U_all  = md->PackVariablesAndFluxes(std::vector<MetadataFlag>{Metadata::Conserved, Metadata::Cell}, cons_map);
+    packs.m_u    = VarMap(cons_map, true);
+    packs.m_p    = VarMap(prims_map, false);
+    packs.Bf     = md->PackVariables(std::vector<std::string>{"cons.fB"});
+    packs.vl_all = md->PackVariables(std::vector<std::string>{"Flux.vl"});
+    packs.vr_all = md->PackVariables(std::vector<std::string>{"Flux.vr"});
+    packs.flags  = md->PackVariables(std::vector<std::string>{"pflag", "fflag"});
+    packs.Pl_all = md->PackVariables(std::vector<std::string>{"Flux.Pl"});
+    packs.Pr_all = md->PackVariables(std::vector<std::string>{"Flux.Pr"});
+    packs.Ul_all = md->PackVariables(std::vector<std::string>{"Flux.Ul"});
+    packs.Ur_all = md->PackVariables(std::vector<std::string>{"Flux.Ur"});
+    packs.Fl_all = md->PackVariables(std::vector<std::string>{"Flux.Fl"});
+    packs.Fr_all = md->PackVariables(std::vector<std::string>{"Flux.Fr"});
+    return packs;
+}
+
+// Execution space instances for each flux direction, created on first use
+static std::vector<DevExecSpace> flux_exec_spaces;
+
+DevExecSpace Flux::FluxExecSpace(MeshData<Real> *md, int dir)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    if (!pmb0->packages.Get("Driver")->Param<bool>("flux_streams"))
+        return pmb0->exec_space;
+
+    if (flux_exec_spaces.empty()) {
+        auto instances = Kokkos::Experimental::partition_space(DevExecSpace(), 1, 1, 1);
+        flux_exec_spaces.assign(instances.begin(), instances.end());
+        // Instances must be destroyed before Kokkos is
+        Kokkos::push_finalize_hook([]() { flux_exec_spaces.clear(); });
+    }
+    return flux_exec_spaces[dir-1];
+}
+
+TaskStatus Flux::FenceFluxStreams(MeshData<Real> *md)
+{
+    for (auto &space : flux_exec_spaces) space.fence();
+    return TaskStatus::complete;
+}
+
 TaskStatus Flux::BlockPtoUMHD(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse)
 {
     // Pointers
     auto pmb = rc->GetBlockPointer();
     // Options
-    const auto& pars = pmb->packages.Get("GRMHD")->AllParams();
-    const Real gam = pars.Get<Real>("gamma");
+    const auto& config = KHARMA::GetConfig(pmb->packages);
+    const Real gam = config.gam;
 
-    const EMHD::EMHD_parameters& emhd_params = EMHD::GetEMHDParameters(pmb->packages);
+    const EMHD::EMHD_parameters& emhd_params = config.emhd_params;
 
     // Pack variables
     PackIndexMap prims_map, cons_map;
@@ -123,10 +241,10 @@ TaskStatus Flux::BlockPtoU(MeshBlockData<Real> *rc, IndexDomain domain, bool coa
     // Pointers
     auto pmb = rc->GetBlockPointer();
     // Options
-    const auto& pars = pmb->packages.Get("GRMHD")->AllParams();
-    const Real gam = pars.Get<Real>("gamma");
+    const auto& config = KHARMA::GetConfig(pmb->packages);
+    const Real gam = config.gam;
 
-    const EMHD::EMHD_parameters& emhd_params = EMHD::GetEMHDParameters(pmb->packages);
+    const EMHD::EMHD_parameters& emhd_params = config.emhd_params;
 
     // Pack variables
     PackIndexMap prims_map, cons_map;
@@ -139,7 +257,7 @@ TaskStatus Flux::BlockPtoU(MeshBlockData<Real> *rc, IndexDomain domain, bool coa
     if (P.GetDim(4) == 0) return TaskStatus::complete;
 
     // Make sure we always update center conserved B from the faces, not the prims
-    if (pmb->packages.AllPackages().count("B_CT"))
+    if (config.use_b_ct)
         B_CT::BlockUtoP(rc, domain, coarse);
 
     // Indices
@@ -159,10 +277,74 @@ TaskStatus Flux::BlockPtoU(MeshBlockData<Real> *rc, IndexDomain domain, bool coa
     return TaskStatus::complete;
 }
 
-TaskStatus Flux::MeshPtoU(MeshData<Real> *md, IndexDomain domain, bool coarse)
+/**
+ * The MeshPtoU kernel, for runtime VarMaps or a compile-time layout, see MatchLayout
+ */
+template<typename PMap, typename UMap>
+inline void MeshPtoUKernel(MeshData<Real> *md, const MeshBlockPack<VariablePack<Real>>& P, const PMap& m_p,
+                           const MeshBlockPack<VariablePack<Real>>& U, const UMap& m_u,
+                           const MeshBlockPack<VariablePack<Real>>& pflag, const bool changed_only,
+                           const EMHD::EMHD_parameters& emhd_params, const Real gam,
+                           const IndexRange& block, const IndexRange& kb, const IndexRange& jb, const IndexRange& ib)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    pmb0->par_for("p_to_u_mesh", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int &b, const int &k, const int &j, const int &i) {
+            if (changed_only && !Inverter::replaced(pflag(b, 0, k, j, i))) return;
+            const auto& G = P.GetCoords(b);
+            Flux::p_to_u(G, P(b), m_p, emhd_params, gam, k, j, i, U(b), m_u);
+        }
+    );
+}
+
+TaskStatus Flux::MeshPtoU(MeshData<Real> *md, IndexDomain domain, bool coarse, bool changed_only)
 {
-    for (int i=0; i < md->NumBlocks(); ++i)
-        Flux::BlockPtoU(md->GetBlockData(i).get(), domain, coarse);
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    // Options
+    const auto& config = KHARMA::GetConfig(pmb0->packages);
+    const Real gam = config.gam;
+
+    const EMHD::EMHD_parameters& emhd_params = config.emhd_params;
+
+    // Pack variables
+    PackIndexMap prims_map, cons_map;
+    const auto& P = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    const auto& U = md->PackVariables(std::vector<MetadataFlag>{Metadata::Conserved}, cons_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+
+    // Return if we're not syncing U & P at all (e.g. edges)
+    if (P.GetDim(4) == 0) return TaskStatus::complete;
+
+    // Make sure we always update center conserved B from the faces, not the prims
+    if (config.use_b_ct)
+        B_CT::MeshUtoP(md, domain, coarse);
+
+    // Only zones left with failed inversions (or recovered from entropy) had their primitives replaced
+    const auto& pflag = md->PackVariables(std::vector<std::string>{"pflag"});
+    changed_only = changed_only && pflag.GetDim(4) > 0;
+
+    // Indices
+    auto bounds = coarse ? pmb0->c_cellbounds : pmb0->cellbounds;
+    const IndexRange ib = bounds.GetBoundsI(domain);
+    const IndexRange jb = bounds.GetBoundsJ(domain);
+    const IndexRange kb = bounds.GetBoundsK(domain);
+    const IndexRange block = IndexRange{0, P.GetDim(5) - 1};
+
+    switch (MatchLayout(m_p, m_u)) {
+    case Layout::grmhd:
+        MeshPtoUKernel(md, P, Layouts::GRMHD(), U, Layouts::GRMHD(), pflag, changed_only, emhd_params, gam, block, kb, jb, ib);
+        break;
+    case Layout::grhd:
+        MeshPtoUKernel(md, P, Layouts::GRHD(), U, Layouts::GRHD(), pflag, changed_only, emhd_params, gam, block, kb, jb, ib);
+        break;
+    case Layout::egrmhd:
+        MeshPtoUKernel(md, P, Layouts::EGRMHD(), U, Layouts::EGRMHD(), pflag, changed_only, emhd_params, gam, block, kb, jb, ib);
+        break;
+    default:
+        MeshPtoUKernel(md, P, m_p, U, m_u, pflag, changed_only, emhd_params, gam, block, kb, jb, ib);
+        break;
+    }
+
     return TaskStatus::complete;
 }
 
@@ -172,15 +354,15 @@ TaskStatus Flux::BlockPtoU_Send(MeshBlockData<Real> *rc, IndexDomain domain, boo
     auto pmb = rc->GetBlockPointer();
     const int ndim = pmb->pmy_mesh->ndim;
     // Options
-    const auto& pars = pmb->packages.Get("GRMHD")->AllParams();
-    const Real gam = pars.Get<Real>("gamma");
+    const auto& config = KHARMA::GetConfig(pmb->packages);
+    const Real gam = config.gam;
 
-    const EMHD::EMHD_parameters& emhd_params = EMHD::GetEMHDParameters(pmb->packages);
+    const EMHD::EMHD_parameters& emhd_params = config.emhd_params;
 
     // Pack variables. We never want to run this on the B field
     using FC = Metadata::FlagCollection;
     auto cons_flags = FC(Metadata::Conserved, Metadata::Cell, Metadata::GetUserFlag("HD"));
-    if (pmb->packages.AllPackages().count("EMHD"))
+    if (config.use_emhd)
         cons_flags = cons_flags + FC(Metadata::Conserved, Metadata::Cell, Metadata::GetUserFlag("EMHDVar"));
     PackIndexMap prims_map, cons_map;
     const auto& P = rc->PackVariables({Metadata::GetUserFlag("Primitive"), Metadata::Cell}, prims_map);
@@ -191,7 +373,7 @@ TaskStatus Flux::BlockPtoU_Send(MeshBlockData<Real> *rc, IndexDomain domain, boo
     if (P.GetDim(4) == 0) return TaskStatus::complete;
 
     // Make sure we always update center conserved B from the faces, not the prims
-    if (pmb->packages.AllPackages().count("B_CT"))
+    if (config.use_b_ct)
         B_CT::BlockUtoP(rc, IndexDomain::interior, coarse);
 
     // Indices
@@ -201,7 +383,8 @@ TaskStatus Flux::BlockPtoU_Send(MeshBlockData<Real> *rc, IndexDomain domain, boo
     IndexRange kb = bounds.GetBoundsK(domain);
 
     // Modify the bounds to reflect zones we're sending, rather than actual ghosts
-    int ng = Globals::nghost;
+    // Coarse buffers have their own, smaller ghost depth
+    const int ng = bounds.GetBoundsI(IndexDomain::interior).s - bounds.GetBoundsI(IndexDomain::entire).s;
     if (domain == IndexDomain::inner_x1) {
         ib.s += ng;
         ib.e += ng;
@@ -242,23 +425,30 @@ void Flux::AddGeoSource(MeshData<Real> *md, MeshData<Real> *mdudt)
     // Pointers
     auto pmesh = md->GetMeshPointer();
     auto pmb0  = md->GetBlockData(0)->GetBlockPointer();
-    auto pkgs = pmb0->packages;
+    auto& pkgs = pmb0->packages;
     // Options
-    const auto& pars = pkgs.Get("GRMHD")->AllParams();
-    const Real gam   = pars.Get<Real>("gamma");
+    const auto& config = KHARMA::GetConfig(pkgs);
+    const Real gam     = config.gam;
 
     // All connection coefficients are zero in Cartesian Minkowski space
     // TODO do we know this fully in init?
-    if (pmb0->coords.coords.is_cart_minkowski()) return;
+    const bool add_geo = !pmb0->coords.coords.is_cart_minkowski();
+    // Any other sources composed into this sweep
+    const bool add_wind = pkgs.Get("Flux")->Param<bool>("fuse_wind");
+    if (!add_geo && !add_wind) return;
+    const Wind::Source wind = (add_wind) ? Wind::GetSource(pkgs) : Wind::Source();
 
     // Pack variables
     PackIndexMap prims_map, cons_map;
     auto P    = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
     auto dUdt = mdudt->PackVariables(std::vector<MetadataFlag>{Metadata::Conserved}, cons_map);
     const VarMap m_p(prims_map, false), m_u(cons_map, true);
+    // Empty unless GRMHD/cache_4vecs is set
+    auto D_cache = md->PackVariables(std::vector<std::string>{"fourvecs"});
+    const bool use_D_cache = D_cache.GetDim(4) > 0;
 
     // EMHD params
-    const EMHD::EMHD_parameters& emhd_params = EMHD::GetEMHDParameters(pmb0->packages);
+    const EMHD::EMHD_parameters& emhd_params = config.emhd_params;
     
     // Get sizes
     IndexDomain domain = IndexDomain::interior;
@@ -270,27 +460,246 @@ void Flux::AddGeoSource(MeshData<Real> *md, MeshData<Real> *mdudt)
     pmb0->par_for("tmunu_source", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) {
             const auto& G = dUdt.GetCoords(b);
-            FourVectors D;
-            GRMHD::calc_4vecs(G, P(b), m_p, k, j, i, Loci::center, D);
-            // Call Flux::calc_tensor which will in turn call the right calc_tensor based on the number of primitives
-            Real Tmu[GR_DIM]    = {0};
-            Real new_du[GR_DIM] = {0};
-            for (int mu = 0; mu < GR_DIM; ++mu) {
-                Flux::calc_tensor(P(b), m_p, D, emhd_params, gam, k, j, i, mu, Tmu);
-                for (int nu = 0; nu < GR_DIM; ++nu) {
-                    // Contract mhd stress tensor with connection, and multiply by metric determinant
-                    for (int lam = 0; lam < GR_DIM; ++lam) {
-                        new_du[lam] += Tmu[nu] * G.gdet_conn(j, i, nu, lam, mu);
+            // {rho u^t, T^t_t, T^t_i} sources
+            Real new_du[Wind::Source::nvar] = {0};
+            if (add_geo) {
+                FourVectors D;
+                if (use_D_cache) GRMHD::load_4vecs(D_cache(b), k, j, i, D);
+                else GRMHD::calc_4vecs(G, P(b), m_p, k, j, i, Loci::center, D);
+                // Call Flux::calc_tensor which will in turn call the right calc_tensor based on the number of primitives
+                Real Tmu[GR_DIM]    = {0};
+                for (int mu = 0; mu < GR_DIM; ++mu) {
+                    Flux::calc_tensor(P(b), m_p, D, emhd_params, gam, k, j, i, mu, Tmu);
+                    for (int nu = 0; nu < GR_DIM; ++nu) {
+                        // Contract mhd stress tensor with connection, and multiply by metric determinant
+                        for (int lam = 0; lam < GR_DIM; ++lam) {
+                            new_du[1 + lam] += Tmu[nu] * G.gdet_conn(j, i, nu, lam, mu);
+                        }
                     }
                 }
             }
+            if (add_wind) wind(G, k, j, i, new_du);
 
-            dUdt(b, m_u.UU, k, j, i)           += new_du[0];
-            VLOOP dUdt(b, m_u.U1 + v, k, j, i) += new_du[1 + v];
+            if (add_wind) dUdt(b, m_u.RHO, k, j, i) += new_du[0];
+            dUdt(b, m_u.UU, k, j, i)           += new_du[1];
+            VLOOP dUdt(b, m_u.U1 + v, k, j, i) += new_du[2 + v];
         }
     );
 }
 
+/**
+ * Mark the blocks of md with a finer neighbor, whose cell fluxes are changed by flux corrections.
+ * Checked on the host each call, as blocks can gain or lose finer neighbors on remeshing,
+ * and only copied to the device when something changed
+ */
+static const FinerNeighbors& GetFinerNeighbors(MeshData<Real> *md)
+{
+    auto pmesh = md->GetMeshPointer();
+    auto& params = pmesh->packages.Get("Flux")->AllParams();
+    auto& all_finer = *params.GetMutable<std::map<MeshData<Real>*, FinerNeighbors>>("finer_neighbors");
+    auto& fn = all_finer[md];
+
+    const int nb = md->NumBlocks();
+    std::vector<int> flags(nb, 0);
+    for (int b = 0; b < nb; b++) {
+        auto pmb = md->GetBlockData(b)->GetBlockPointer();
+        for (const auto& nb_block : pmb->neighbors)
+            if (nb_block.loc.level() > pmb->loc.level()) flags[b] = 1;
+    }
+    if (flags == fn.flags_h && fn.finer.extent_int(0) == nb) return fn;
+
+    fn.flags_h = flags;
+    fn.any = std::count(flags.begin(), flags.end(), 1) > 0;
+    fn.all = std::count(flags.begin(), flags.end(), 1) == nb;
+    fn.finer = ParArray1D<int>("finer_neighbors", nb);
+    auto finer_h = Kokkos::create_mirror_view(Kokkos::HostSpace(), fn.finer);
+    for (int b = 0; b < nb; b++) finer_h(b) = flags[b];
+    Kokkos::deep_copy(fn.finer, finer_h);
+    return fn;
+}
+
+/**
+ * Flux divergence, optionally with the geometric source, over part of the interior:
+ * 0: all zones
+ * 1: zones whose fluxes are untouched by flux corrections: all zones of blocks without finer
+ *    neighbors, and zones not bordering any block face in the others
+ * 2: the remaining zones, on the faces of blocks with finer neighbors
+ */
+TaskStatus Flux::FourthOrderCorrection(MeshData<Real> *md)
+{
+    auto pmesh = md->GetMeshPointer();
+    auto pmb0  = md->GetBlockData(0)->GetBlockPointer();
+    const int ndim = pmesh->ndim;
+    // No transverse directions to average over
+    if (ndim < 2) return TaskStatus::complete;
+    Flag("FourthOrderCorrection");
+
+    // The same variables as the divergence
+    const std::vector<MetadataFlag> flags({Metadata::WithFluxes, Metadata::Cell});
+    auto U = md->PackVariablesAndFluxes(flags);
+    auto Fp = md->PackVariables(std::vector<std::string>{"Flux.Fpoint"});
+    const int nvar = U.GetDim(4);
+
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    const IndexRange block = IndexRange{0, U.GetDim(5)-1};
+
+    for (int dir = X1DIR; dir <= ndim; dir++) {
+        // Faces read by the divergence, and a row of faces either side in each transverse direction.
+        // GetFlux computes fluxes a zone beyond these on each side
+        const bool t1 = (dir != X1DIR), t2 = (dir != X2DIR), t3 = (dir != X3DIR && ndim > 2);
+        const IndexRange3 bf = IndexRange3{(uint) ib.s, (uint) ib.e + !t1, (uint) jb.s, (uint) jb.e + !t2,
+                                           (uint) kb.s, (uint) kb.e + (ndim > 2 && !t3)};
+        // Keep the point fluxes, since each face's correction reads its neighbors'
+        pmb0->par_for("flux_fourth_order_copy", block.s, block.e, bf.ks - t3, bf.ke + t3,
+                      bf.js - t2, bf.je + t2, bf.is - t1, bf.ie + t1,
+            KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) {
+                for (int p=0; p < nvar; ++p) {
+                    if (!U.IsAllocated(b, p)) continue;
+                    Fp(b, p, k, j, i) = U(b).flux(dir, p, k, j, i);
+                }
+            }
+        );
+        pmb0->par_for("flux_fourth_order", block.s, block.e, bf.ks, bf.ke, bf.js, bf.je, bf.is, bf.ie,
+            KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) {
+                for (int p=0; p < nvar; ++p) {
+                    if (!U.IsAllocated(b, p)) continue;
+                    const Real F0 = Fp(b, p, k, j, i);
+                    Real lap = 0.;
+                    if (t1) lap += Fp(b, p, k, j, i+1) - 2.*F0 + Fp(b, p, k, j, i-1);
+                    if (t2) lap += Fp(b, p, k, j+1, i) - 2.*F0 + Fp(b, p, k, j-1, i);
+                    if (t3) lap += Fp(b, p, k+1, j, i) - 2.*F0 + Fp(b, p, k-1, j, i);
+                    U(b).flux(dir, p, k, j, i) = F0 + lap / 24.;
+                }
+            }
+        );
+    }
+
+    EndFlag();
+    return TaskStatus::complete;
+}
+
+static TaskStatus FluxDivergenceImpl(MeshData<Real> *md, MeshData<Real> *mdudt, bool geo_source, int part)
+{
+    // Pointers
+    auto pmesh = md->GetMeshPointer();
+    auto pmb0  = md->GetBlockData(0)->GetBlockPointer();
+    // Options
+    const auto& config = KHARMA::GetConfig(pmb0->packages);
+    const Real gam = config.gam;
+    const int ndim = pmesh->ndim;
+    // All connection coefficients are zero in Cartesian Minkowski space
+    const bool add_geo = geo_source && !pmb0->coords.coords.is_cart_minkowski();
+    // Sources composed with the geometric one, as in AddGeoSource
+    const bool add_wind = geo_source && pmb0->packages.Get("Flux")->Param<bool>("fuse_wind");
+    const Wind::Source wind = (add_wind) ? Wind::GetSource(pmb0->packages) : Wind::Source();
+
+    // Pack variables.  The same flags as Update::FluxDivergence, so that we cover
+    // exactly the same set of variables
+    const std::vector<MetadataFlag> flags({Metadata::WithFluxes, Metadata::Cell});
+    PackIndexMap prims_map, cons_map;
+    auto P    = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    auto U    = md->PackVariablesAndFluxes(flags, cons_map);
+    auto dUdt = mdudt->PackVariables(flags);
+    const VarMap m_p(prims_map, false), m_u(cons_map, true);
+    const int nvar = U.GetDim(4);
+    // Empty unless GRMHD/cache_4vecs is set
+    auto D_cache = md->PackVariables(std::vector<std::string>{"fourvecs"});
+    const bool use_D_cache = D_cache.GetDim(4) > 0;
+
+    const EMHD::EMHD_parameters& emhd_params = config.emhd_params;
+
+    // Get sizes
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    const IndexRange block = IndexRange{0, U.GetDim(5)-1};
+    // Zones bordering no block face
+    const IndexRange3 bd = IndexRange3{(uint) ib.s + 1, (uint) ib.e - 1,
+        (uint) jb.s + (ndim > 1), (uint) jb.e - (ndim > 1), (uint) kb.s + (ndim > 2), (uint) kb.e - (ndim > 2)};
+    // Blocks whose face fluxes are corrected.  Without any, the first part covers everything
+    const auto& fn = GetFinerNeighbors(md);
+    const auto finer = fn.finer;
+    if (part == 2 && !fn.any) return TaskStatus::complete;
+    // Otherwise the deep part can launch over just the zones away from faces, if all blocks are corrected
+    const bool all_finer = (part == 1) && fn.all;
+    const IndexRange il = (all_finer) ? IndexRange{(int) bd.is, (int) bd.ie} : ib;
+    const IndexRange jl = (all_finer) ? IndexRange{(int) bd.js, (int) bd.je} : jb;
+    const IndexRange kl = (all_finer) ? IndexRange{(int) bd.ks, (int) bd.ke} : kb;
+
+    pmb0->par_for("flux_divergence_geo_source", block.s, block.e, kl.s, kl.e, jl.s, jl.e, il.s, il.e,
+        KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) {
+            if (part == 1 && finer(b) && !KDomain::inside(k, j, i, bd)) return;
+            if (part == 2 && (!finer(b) || KDomain::inside(k, j, i, bd))) return;
+            const auto& G = U.GetCoords(b);
+            // Flux divergence, as in Update::FluxDivergence
+            for (int p=0; p < nvar; ++p) {
+                if (!U.IsAllocated(b, p)) continue;
+                Real du = (U(b).flux(X1DIR, p, k, j, i+1) - U(b).flux(X1DIR, p, k, j, i)) / G.Dxc<1>(i);
+                if (ndim > 1) du += (U(b).flux(X2DIR, p, k, j+1, i) - U(b).flux(X2DIR, p, k, j, i)) / G.Dxc<2>(j);
+                if (ndim > 2) du += (U(b).flux(X3DIR, p, k+1, j, i) - U(b).flux(X3DIR, p, k, j, i)) / G.Dxc<3>(k);
+                dUdt(b, p, k, j, i) = -du;
+            }
+
+            // Geometric source term, as in AddGeoSource
+            if (add_geo) {
+                FourVectors D;
+                if (use_D_cache) GRMHD::load_4vecs(D_cache(b), k, j, i, D);
+                else GRMHD::calc_4vecs(G, P(b), m_p, k, j, i, Loci::center, D);
+                Real Tmu[GR_DIM]    = {0};
+                Real new_du[GR_DIM] = {0};
+                for (int mu = 0; mu < GR_DIM; ++mu) {
+                    Flux::calc_tensor(P(b), m_p, D, emhd_params, gam, k, j, i, mu, Tmu);
+                    for (int nu = 0; nu < GR_DIM; ++nu) {
+                        for (int lam = 0; lam < GR_DIM; ++lam) {
+                            new_du[lam] += Tmu[nu] * G.gdet_conn(j, i, nu, lam, mu);
+                        }
+                    }
+                }
+
+                dUdt(b, m_u.UU, k, j, i)           += new_du[0];
+                VLOOP dUdt(b, m_u.U1 + v, k, j, i) += new_du[1 + v];
+            }
+            if (add_wind) {
+                Real wind_du[Wind::Source::nvar] = {0};
+                wind(G, k, j, i, wind_du);
+                dUdt(b, m_u.RHO, k, j, i)          += wind_du[0];
+                dUdt(b, m_u.UU, k, j, i)           += wind_du[1];
+                VLOOP dUdt(b, m_u.U1 + v, k, j, i) += wind_du[2 + v];
+            }
+        }
+    );
+
+    return TaskStatus::complete;
+}
+
+TaskStatus Flux::FluxDivergenceGeoSource(MeshData<Real> *md, MeshData<Real> *mdudt)
+{
+    Flag("FluxDivergenceGeoSource");
+    auto status = FluxDivergenceImpl(md, mdudt, true, 0);
+    EndFlag();
+    return status;
+}
+
+TaskStatus Flux::FluxDivergenceInterior(MeshData<Real> *md, MeshData<Real> *mdudt)
+{
+    Flag("FluxDivergenceInterior");
+    const bool geo_source = md->GetMeshPointer()->packages.Get("Flux")->Param<bool>("fused_geo_source");
+    auto status = FluxDivergenceImpl(md, mdudt, geo_source, 1);
+    EndFlag();
+    return status;
+}
+
+TaskStatus Flux::FluxDivergenceBoundary(MeshData<Real> *md, MeshData<Real> *mdudt)
+{
+    Flag("FluxDivergenceBoundary");
+    const bool geo_source = md->GetMeshPointer()->packages.Get("Flux")->Param<bool>("fused_geo_source");
+    auto status = FluxDivergenceImpl(md, mdudt, geo_source, 2);
+    EndFlag();
+    return status;
+}
+
 TaskStatus Flux::CheckCtop(MeshData<Real> *md)
 {
     Reductions::DomainReduction<Reductions::Var::nan_ctop, int>(md, UserHistoryOperation::sum, 0);
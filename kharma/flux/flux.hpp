@@ -49,16 +49,79 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
 
 TaskStatus CheckCtop(MeshData<Real> *md);
 
+/**
+ * Execution space instance used for the flux calculation in direction dir.
+ * With driver/flux_streams, each direction gets its own instance so that the kernels in each
+ * direction can overlap on the device.  Otherwise, this is just the default instance.
+ */
+DevExecSpace FluxExecSpace(MeshData<Real> *md, int dir);
+
+/**
+ * Wait for all the per-direction flux instances to finish.
+ * Must be run before anything (FixFlux, the update) uses the fluxes, if driver/flux_streams is set
+ */
+TaskStatus FenceFluxStreams(MeshData<Real> *md);
+
 TaskStatus PostStepDiagnostics(const SimTime& tm, MeshData<Real> *md);
 
+/**
+ * Packs & maps used by GetFlux, built the first time they're needed for each MeshData object,
+ * and again only when its blocks change (e.g. after remeshing), as in KBoundaries::GetBoundaryMasks.
+ * Saves building the name/flag lists, and Parthenon hashing them, for each pack on every call.
+ */
+struct FluxPacks {
+    // Identifies the blocks these packs were built for
+    std::vector<MeshBlockData<Real>*> blocks;
+    MeshBlockPack<VariablePack<Real>> cmax, cmin, P_all;
+    MeshBlockPack<VariableFluxPack<Real>> U_all;
+    VarMap m_u, m_p;
+    // Face fields & velocities, empty without B_CT
+    MeshBlockPack<VariablePack<Real>> Bf, vl_all, vr_all;
+    // Flags for troubled-zone fallback
+    MeshBlockPack<VariablePack<Real>> flags;
+    // Face states, empty unless allocated (see flux/keep_face_states)
+    MeshBlockPack<VariablePack<Real>> Pl_all, Pr_all, Ul_all, Ur_all, Fl_all, Fr_all;
+};
+const FluxPacks& GetFluxPacks(MeshData<Real> *md);
+
 /**
  * Add the geometric source term present in the covariant derivative of the stress-energy tensor,
  * S_nu = sqrt(-g) T^kap_lam Gamma^lam_nu_kap
  * This is defined in Flux:: rather than GRMHD:: because the stress-energy tensor may contain
  * (E)GR(R)(M)HD terms.
+ *
+ * Other local source terms on {rho u^t, T^t_nu} are composed into the same kernel as device
+ * functors, rather than each running their own: currently the wind, see Wind::Source.
  */
 void AddGeoSource(MeshData<Real> *md, MeshData<Real> *mdudt);
 
+/**
+ * Correct the fluxes computed at face centers to face averages to fourth order, by adding 1/24 of their
+ * Laplacian over the transverse directions, if flux/fourth_order is set.  Runs after GetFlux and before
+ * any package modifies the fluxes (FixFlux), so e.g. Flux-CT and polar fluxes see only the corrected values.
+ * The cell-centered states themselves are not deconvolved, nor are the sources, so the scheme
+ * is fourth-order only in the transverse averaging of the fluxes.
+ */
+TaskStatus FourthOrderCorrection(MeshData<Real> *md);
+
+/**
+ * Replacement for Update::FluxDivergence which also adds the geometric source above,
+ * so the fluxes, dUdt and connection are each read once per stage.
+ * Used in place of the two separate passes if flux/fused_geo_source is set
+ */
+TaskStatus FluxDivergenceGeoSource(MeshData<Real> *md, MeshData<Real> *mdudt);
+
+/**
+ * Flux divergence (and the geometric source, if flux/fused_geo_source) split in two, for
+ * flux/overlap_flux_comm: FluxDivergenceInterior covers every zone whose fluxes don't change with
+ * flux corrections, and can run while those are exchanged: all of a block without finer neighbors,
+ * and zones bordering no block face elsewhere.
+ * FluxDivergenceBoundary covers the rest, after the corrections are applied, and does nothing if
+ * no block in md has a finer neighbor (e.g. face CT on a uniform mesh).
+ */
+TaskStatus FluxDivergenceInterior(MeshData<Real> *md, MeshData<Real> *mdudt);
+TaskStatus FluxDivergenceBoundary(MeshData<Real> *md, MeshData<Real> *mdudt);
+
 /**
  * Likewise, the conversion P->U, even for just the GRMHD variables, requires (consists of)
  * the stress-energy tensor.
@@ -71,7 +134,13 @@ TaskStatus BlockPtoUMHD(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse
  * These calls just run that function over the grid.
  */
 TaskStatus BlockPtoU(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse=false);
-TaskStatus MeshPtoU(MeshData<Real> *md, IndexDomain domain, bool coarse=false);
+/**
+ * As BlockPtoU, over all blocks of md in one kernel.
+ * With changed_only, only zones left with failed inversions (and fixed in FixUtoP) are updated:
+ * elsewhere U is already consistent with P after UtoP, floors and domain boundaries.
+ * See flux/ptou_changed_only
+ */
+TaskStatus MeshPtoU(MeshData<Real> *md, IndexDomain domain, bool coarse=false, bool changed_only=false);
 
 /**
  * As above, except that IndexDomains of ghost cells are taken to cover
@@ -78,8 +78,9 @@ KOKKOS_FORCEINLINE_FUNCTION void calc_tensor(const Local& P, const VarMap& m_p,
     }
 }
 
-template<typename Global>
-KOKKOS_FORCEINLINE_FUNCTION void calc_tensor(const Global& P, const VarMap& m_p, const FourVectors D,
+// Global versions of calc_tensor, prim_to_flux & p_to_u also accept a StaticVarMap, see types.hpp
+template<typename Global, typename PMap>
+KOKKOS_FORCEINLINE_FUNCTION void calc_tensor(const Global& P, const PMap& m_p, const FourVectors D,
                                         const EMHD::EMHD_parameters& emhd_params, const Real& gam, 
                                         const int& k, const int& j, const int& i, const int& dir,
                                         Real T[GR_DIM])
@@ -177,11 +178,11 @@ KOKKOS_FORCEINLINE_FUNCTION void prim_to_flux(const GRCoordinates& G, const Loca
     }
 }
 
-template<typename Global>
-KOKKOS_FORCEINLINE_FUNCTION void prim_to_flux(const GRCoordinates& G, const Global& P, const VarMap& m_p, const FourVectors D,
+template<typename Global, typename PMap, typename UMap>
+KOKKOS_FORCEINLINE_FUNCTION void prim_to_flux(const GRCoordinates& G, const Global& P, const PMap& m_p, const FourVectors D,
                                          const EMHD::EMHD_parameters& emhd_params, const Real& gam, 
                                          const int& k, const int& j, const int& i, const int dir,
-                                         const Global& flux, const VarMap& m_u, const Loci loc=Loci::center)
+                                         const Global& flux, const UMap& m_u, const Loci loc=Loci::center)
 {
     const Real gdet = G.gdet(loc, j, i);
     // Particle number flux
@@ -226,17 +227,17 @@ KOKKOS_FORCEINLINE_FUNCTION void prim_to_flux(const GRCoordinates& G, const Glob
     // Electrons: normalized by density
     if (m_u.KTOT >= 0) {
         flux(m_u.KTOT, k, j, i)  = flux(m_u.RHO, k, j, i) * P(m_p.KTOT, k, j, i);
-        if (m_u.K_CONSTANT >= 0)
+        if (m_u.K_CONSTANT >= 0 && var_allocated(P, m_p.K_CONSTANT))
             flux(m_u.K_CONSTANT, k, j, i) = flux(m_u.RHO, k, j, i) * P(m_p.K_CONSTANT, k, j, i);
-        if (m_u.K_HOWES >= 0)
+        if (m_u.K_HOWES >= 0 && var_allocated(P, m_p.K_HOWES))
             flux(m_u.K_HOWES, k, j, i)    = flux(m_u.RHO, k, j, i) * P(m_p.K_HOWES, k, j, i);
-        if (m_u.K_KAWAZURA >= 0)
+        if (m_u.K_KAWAZURA >= 0 && var_allocated(P, m_p.K_KAWAZURA))
             flux(m_u.K_KAWAZURA, k, j, i) = flux(m_u.RHO, k, j, i) * P(m_p.K_KAWAZURA, k, j, i);
-        if (m_u.K_WERNER >= 0)
+        if (m_u.K_WERNER >= 0 && var_allocated(P, m_p.K_WERNER))
             flux(m_u.K_WERNER, k, j, i)   = flux(m_u.RHO, k, j, i) * P(m_p.K_WERNER, k, j, i);
-        if (m_u.K_ROWAN >= 0)
+        if (m_u.K_ROWAN >= 0 && var_allocated(P, m_p.K_ROWAN))
             flux(m_u.K_ROWAN, k, j, i)    = flux(m_u.RHO, k, j, i) * P(m_p.K_ROWAN, k, j, i);
-        if (m_u.K_SHARMA >= 0)
+        if (m_u.K_SHARMA >= 0 && var_allocated(P, m_p.K_SHARMA))
             flux(m_u.K_SHARMA, k, j, i)   = flux(m_u.RHO, k, j, i) * P(m_p.K_SHARMA, k, j, i);
     }
 }
@@ -275,11 +276,11 @@ KOKKOS_FORCEINLINE_FUNCTION void p_to_u(const GRCoordinates& G, const Local& P,
     prim_to_flux(G, P, m_p, Dtmp, emhd_params, gam, j, i, 0, U, m_u, loc);
 }
 
-template<typename Global>
-KOKKOS_FORCEINLINE_FUNCTION void p_to_u(const GRCoordinates& G, const Global& P, const VarMap& m_p,
+template<typename Global, typename PMap, typename UMap>
+KOKKOS_FORCEINLINE_FUNCTION void p_to_u(const GRCoordinates& G, const Global& P, const PMap& m_p,
                                    const EMHD::EMHD_parameters& emhd_params, const Real& gam, 
                                    const int& k, const int& j, const int& i,
-                                   const Global& U, const VarMap& m_u, const Loci& loc=Loci::center)
+                                   const Global& U, const UMap& m_u, const Loci& loc=Loci::center)
 {
     FourVectors Dtmp;
     GRMHD::calc_4vecs(G, P, m_p, k, j, i, Loci::center, Dtmp);
@@ -298,14 +299,13 @@ KOKKOS_FORCEINLINE_FUNCTION void p_to_u_mhd(const GRCoordinates& G, const Global
 }
 
 /**
- * Calculate components of magnetosonic velocity from primitive variables
- * This is only called in GetFlux, so we only provide a ScratchPad form
+ * Fast magnetosonic speed squared in the fluid frame, clipped to [SMALL, 1].
+ * Needs the full GRCoordinates object only for EMHD closures which depend on position.
  */
 template<typename Local>
-KOKKOS_FORCEINLINE_FUNCTION void vchar(const GRCoordinates& G, const Local& P, const VarMap& m, const FourVectors& D,
-                                  const Real& gam, const EMHD::EMHD_parameters& emhd_params, 
-                                  const int& k, const int& j, const int& i, const Loci& loc, const int& dir,
-                                  Real& cmax, Real& cmin)
+KOKKOS_FORCEINLINE_FUNCTION Real fast_speed_sq(const GRCoordinates& G, const Local& P, const VarMap& m, const FourVectors& D,
+                                          const Real& gam, const EMHD::EMHD_parameters& emhd_params,
+                                          const int& j, const int& i)
 {
     // Find sound speed
     const Real ef  = P(m.RHO) + gam * P(m.UU);
@@ -340,7 +340,18 @@ KOKKOS_FORCEINLINE_FUNCTION void vchar(const GRCoordinates& G, const Local& P, c
         cms2 = cs2;
     }
     clip(cms2, SMALL, 1.);
+    return cms2;
+}
 
+/**
+ * Coordinate-frame signal speeds in direction dir, given the fluid-frame speed cms2.
+ * Geom is either GRCoordinates or a FaceGeom already loaded at this point.
+ */
+template<typename Geom>
+KOKKOS_FORCEINLINE_FUNCTION void vchar_from_cms2(const Geom& G, const FourVectors& D, const Real& cms2,
+                                            const int& k, const int& j, const int& i, const Loci& loc, const int& dir,
+                                            Real& cmax, Real& cmin)
+{
     // Require that speed of wave measured by observer q.ucon is cms2
     Real A, B, C;
     {
@@ -371,4 +382,30 @@ KOKKOS_FORCEINLINE_FUNCTION void vchar(const GRCoordinates& G, const Local& P, c
     cmin = m::min(vp, vm);
 }
 
+/**
+ * Calculate components of magnetosonic velocity from primitive variables
+ * This is only called in GetFlux, so we only provide a ScratchPad form
+ */
+template<typename Local>
+KOKKOS_FORCEINLINE_FUNCTION void vchar(const GRCoordinates& G, const Local& P, const VarMap& m, const FourVectors& D,
+                                  const Real& gam, const EMHD::EMHD_parameters& emhd_params, 
+                                  const int& k, const int& j, const int& i, const Loci& loc, const int& dir,
+                                  Real& cmax, Real& cmin)
+{
+    const Real cms2 = fast_speed_sq(G, P, m, D, gam, emhd_params, j, i);
+    vchar_from_cms2(G, D, cms2, k, j, i, loc, dir, cmax, cmin);
+}
+/**
+ * As above, with the metric at this face already loaded into FG
+ */
+template<typename Local>
+KOKKOS_FORCEINLINE_FUNCTION void vchar(const GRCoordinates& G, const FaceGeom& FG, const Local& P, const VarMap& m,
+                                  const FourVectors& D, const Real& gam, const EMHD::EMHD_parameters& emhd_params, 
+                                  const int& k, const int& j, const int& i, const Loci& loc, const int& dir,
+                                  Real& cmax, Real& cmin)
+{
+    const Real cms2 = fast_speed_sq(G, P, m, D, gam, emhd_params, j, i);
+    vchar_from_cms2(FG, D, cms2, k, j, i, loc, dir, cmax, cmin);
+}
+
 } // namespace Flux
@@ -37,9 +37,256 @@
 
 #include "domain.hpp"
 #include "floors_functions.hpp"
+#include "kharma_config.hpp"
 
 namespace Flux {
 
+/**
+ * Replace the reconstructed states on either side of a face with linear/MC values,
+ * if any zone in the stencil around the face was flagged (inversion failure or floors)
+ * at the last UtoP.  This confines the lower-order reconstruction (and hopefully the
+ * subsequent trouble) to a few zones, rather than to whole regions picked at compile-time.
+ */
+template <int dir, typename S>
+KOKKOS_INLINE_FUNCTION void troubled_fallback(const VariablePack<Real>& P, const VariablePack<Real>& flags,
+                                              const int& k, const int& j, const int& i, S& Pl, S& Pr)
+{
+    constexpr int di = (dir == X1DIR), dj = (dir == X2DIR), dk = (dir == X3DIR);
+    // Face at i is between zones i-1 and i (along dir).  Check zones i-2 through i+1
+    bool troubled = false;
+    for (int f = 0; f < flags.GetDim(4); ++f)
+        for (int o = -2; o <= 1; ++o)
+            troubled |= (flags(f, k + o*dk, j + o*dj, i + o*di) > 0.);
+    if (!troubled) return;
+
+    for (int p = 0; p < P.GetDim(4); ++p) {
+        if (!P.IsAllocated(p)) continue;
+        // Left state from the zone to the left, right state from the zone to the right.  See PiecewiseLinearX1
+        const Real qlm = P(p, k - 2*dk, j - 2*dj, i - 2*di), ql0 = P(p, k - dk, j - dj, i - di);
+        const Real qr0 = P(p, k, j, i), qrp = P(p, k + dk, j + dj, i + di);
+        const Real dql = (qr0 - ql0) * KReconstruction::mc(ql0 - qlm, qr0 - ql0);
+        const Real dqr = (qrp - qr0) * KReconstruction::mc(qr0 - ql0, qrp - qr0);
+        Pl(p) = ql0 + 0.5*dql;
+        Pr(p) = qr0 - 0.5*dqr;
+    }
+}
+
+/**
+ * @brief Fused version of GetFlux below: reconstruct, replace face B, compute left/right
+ * conserved variables, fluxes, and signal speeds, and combine them with LLF/HLLE, all
+ * in a single team kernel.
+ *
+ * Intermediate states live only in team scratch: unless flux/keep_face_states is set,
+ * nothing is written to the Flux.Pl/Pr/Ul/Ur/Fl/Fr fields (which are then not allocated),
+ * only the final face fluxes, Flux.cmax/cmin, and (with B_CT) the face velocities Flux.vl/vr.
+ * Enabled with driver/fused_flux.
+ *
+ * With driver/pencil_recon, X2 and X3 fluxes are computed by teams each covering pencil_length
+ * consecutive rows, which reconstruct each row of zones only once.  Requires a five-point scheme.
+ */
+template <KReconstruction::Type Recon, int dir>
+inline TaskStatus GetFluxFused(MeshData<Real> *md)
+{
+    Flag("GetFluxFused_", dir);
+    // Pointers
+    auto pmb0  = md->GetBlockData(0)->GetBlockPointer();
+    auto& packages = pmb0->packages;
+
+    // Options
+    const auto& config     = KHARMA::GetConfig(packages);
+    const bool use_hlle    = config.use_hlle;
+
+    const bool reconstruction_floors = config.use_floors && KReconstruction::needs_recon_floors(Recon);
+    const Floors::Prescription& floors = config.GetFloors();
+
+    const Real gam = config.gam;
+    const EMHD::EMHD_parameters& emhd_params = config.emhd_params;
+    const Loci loc = loc_of(dir);
+
+    // Launch on this direction's execution space instance.  If that isn't the default instance,
+    // make sure anything queued before us on the default instance (e.g. B_CT::MeshUtoP) is done
+    const bool flux_streams = config.flux_streams;
+    auto exec_space = Flux::FluxExecSpace(md, dir);
+    if (flux_streams) pmb0->exec_space.fence();
+
+    // Pack variables, see Flux::GetFluxPacks
+    const auto& packs = Flux::GetFluxPacks(md);
+    const auto& cmax  = packs.cmax;
+    const auto& cmin  = packs.cmin;
+    const auto& P_all = packs.P_all;
+    const auto& U_all = packs.U_all;
+    const VarMap& m_u = packs.m_u;
+    const VarMap& m_p = packs.m_p;
+
+    // Face fields & velocities.  These packs are empty if B_CT isn't loaded
+    const bool use_b_ct = config.use_b_ct;
+    const auto& Bf     = packs.Bf;
+    const auto& vl_all = packs.vl_all;
+    const auto& vr_all = packs.vr_all;
+    const TopologicalElement face = FaceOf(dir);
+
+    // Optionally drop to linear reconstruction around flagged zones
+    const bool use_fallback = config.troubled_fallback;
+    const auto& flags = packs.flags;
+
+    // Optionally still record the reconstructed states, for output/debugging
+    const bool keep_face_states = config.keep_face_states;
+    const auto& Pl_all = packs.Pl_all;
+    const auto& Pr_all = packs.Pr_all;
+    const auto& Ul_all = packs.Ul_all;
+    const auto& Ur_all = packs.Ur_all;
+    const auto& Fl_all = packs.Fl_all;
+    const auto& Fr_all = packs.Fr_all;
+
+    // Get the domain size
+    const IndexRange3 b = KDomain::GetRange(md, IndexDomain::interior, -1, 2);
+    const int n1 = pmb0->cellbounds.ncellsi(IndexDomain::entire);
+    const IndexRange block = IndexRange{0, cmax.GetDim(5) - 1};
+    const int nvar = U_all.GetDim(4);
+
+    // Optionally stream through pencils of rows along dir, so that each row's five-point
+    // reconstruction is computed once, with its right-side result kept for the next face.
+    // Otherwise, the left & right reconstructions for each face are computed independently
+    const bool pencil = (dir > X1DIR) && KReconstruction::is_stencil5(Recon) && config.pencil_recon;
+    const int pencil_len = (pencil) ? config.pencil_length : 1;
+    // Outer loop is over (block, k, chunk of j) or (block, chunk of k, j)
+    const int nchunk = (dir == X2DIR) ? (b.je - b.js + pencil_len) / pencil_len
+                                      : (b.ke - b.ks + pencil_len) / pencil_len;
+    const IndexRange o2 = (dir == X3DIR) ? IndexRange{0, nchunk - 1} : IndexRange{(int) b.ks, (int) b.ke};
+    const IndexRange o1 = (dir == X2DIR) ? IndexRange{0, nchunk - 1} : IndexRange{(int) b.js, (int) b.je};
+
+    // Scratch: reconstructed prims, conserved, and fluxes for both sides,
+    // plus any temporaries the reconstruction allocates after them,
+    // plus the following row's left state when streaming through pencils
+    const int scratch_level = 1;
+    const size_t var_size_in_bytes = parthenon::ScratchPad2D<Real>::shmem_size(nvar, n1);
+    const size_t total_scratch_bytes = (6 + pencil + KReconstruction::scratch_vars(Recon)) * var_size_in_bytes;
+
+    // Static estimates for the timing report: read prims & both faces' geometry, write flux & speeds
+    const double nzones = static_cast<double>(block.e - block.s + 1) * (b.ke - b.ks + 1) * (b.je - b.js + 1) * (b.ie - b.is + 1);
+    Timers::CountKernel("calc_flux_fused", nzones, (2 * nvar + 2 + 66) * sizeof(Real),
+                        2 * nvar * KReconstruction::flops_per_var(Recon) + 900 + 6 * nvar);
+    parthenon::par_for_outer(DEFAULT_OUTER_LOOP_PATTERN, "calc_flux_fused", exec_space,
+        total_scratch_bytes, scratch_level, block.s, block.e, o2.s, o2.e, o1.s, o1.e,
+        KOKKOS_LAMBDA(parthenon::team_mbr_t member, const int& bl, const int& ko, const int& jo) {
+            const auto& G = U_all.GetCoords(bl);
+            ScratchPad2D<Real> Pl_s(member.team_scratch(scratch_level), nvar, n1);
+            ScratchPad2D<Real> Pr_s(member.team_scratch(scratch_level), nvar, n1);
+            ScratchPad2D<Real> Ul_s(member.team_scratch(scratch_level), nvar, n1);
+            ScratchPad2D<Real> Ur_s(member.team_scratch(scratch_level), nvar, n1);
+            ScratchPad2D<Real> Fl_s(member.team_scratch(scratch_level), nvar, n1);
+            ScratchPad2D<Real> Fr_s(member.team_scratch(scratch_level), nvar, n1);
+            ScratchPad2D<Real> Pn_s;
+            if (pencil) Pn_s = ScratchPad2D<Real>(member.team_scratch(scratch_level), nvar, n1);
+
+            // Rows handled by this team, along dir
+            const int r_start = (dir == X2DIR) ? b.js + jo*pencil_len : ((dir == X3DIR) ? b.ks + ko*pencil_len : 0);
+            const int r_end = (dir == X2DIR) ? m::min(r_start + pencil_len - 1, (int) b.je) :
+                             ((dir == X3DIR) ? m::min(r_start + pencil_len - 1, (int) b.ke) : 0);
+            const auto& P = P_all(bl);
+
+            for (int r = r_start; r <= r_end; ++r) {
+                const int k = (dir == X3DIR) ? r : ko;
+                const int j = (dir == X2DIR) ? r : jo;
+
+                if (pencil) {
+                    // Left state of the first face comes from the previous row.
+                    // After that, it was computed last iteration into Pn_s
+                    if (r == r_start) {
+                        KReconstruction::Stencil5Row<Recon, dir, true, false>(member, k - (dir == X3DIR), j - (dir == X2DIR),
+                                                                              b.is, b.ie, P, Pl_s, Pr_s);
+                    } else {
+                        auto tmp = Pl_s; Pl_s = Pn_s; Pn_s = tmp;
+                    }
+                    KReconstruction::Stencil5Row<Recon, dir, true, true>(member, k, j, b.is, b.ie, P, Pn_s, Pr_s);
+                } else {
+                    KReconstruction::reconstruct<Recon, dir>(member, P, k, j, b.is, b.ie, Pl_s, Pr_s);
+                }
+                member.team_barrier();
+
+                parthenon::par_for_inner(member, b.is, b.ie,
+                    [&](const int& i) {
+                        auto Pl = Kokkos::subview(Pl_s, Kokkos::ALL(), i);
+                        auto Pr = Kokkos::subview(Pr_s, Kokkos::ALL(), i);
+                        auto Ul = Kokkos::subview(Ul_s, Kokkos::ALL(), i);
+                        auto Ur = Kokkos::subview(Ur_s, Kokkos::ALL(), i);
+                        auto Fl = Kokkos::subview(Fl_s, Kokkos::ALL(), i);
+                        auto Fr = Kokkos::subview(Fr_s, Kokkos::ALL(), i);
+
+                        if (use_fallback) {
+                            Flux::troubled_fallback<dir>(P, flags(bl), k, j, i, Pl, Pr);
+                        }
+                        if (reconstruction_floors) {
+                            Floors::apply_geo_floors(G, Pl, m_p, gam, j, i, floors, loc);
+                            Floors::apply_geo_floors(G, Pr, m_p, gam, j, i, floors, loc);
+                        }
+                        // Metric at this face, loaded once for both sides
+                        FaceGeom fg;
+                        G.face_geom(loc, j, i, fg);
+
+                        if (use_b_ct) {
+                            const double bf = Bf(bl, face, 0, k, j, i) / fg.gdet_l;
+                            Pl(m_p.B1+dir-1) = bf;
+                            Pr(m_p.B1+dir-1) = bf;
+                        }
+
+                        FourVectors Dtmp;
+                        Real cmaxL, cminL, cmaxR, cminR;
+                        GRMHD::calc_4vecs(fg, Pl, m_p, j, i, loc, Dtmp);
+                        Flux::prim_to_flux(G, Pl, m_p, Dtmp, emhd_params, gam, j, i, 0, Ul, m_u, loc);
+                        Flux::prim_to_flux(G, Pl, m_p, Dtmp, emhd_params, gam, j, i, dir, Fl, m_u, loc);
+                        Flux::vchar(G, fg, Pl, m_p, Dtmp, gam, emhd_params, k, j, i, loc, dir, cmaxL, cminL);
+
+                        GRMHD::calc_4vecs(fg, Pr, m_p, j, i, loc, Dtmp);
+                        Flux::prim_to_flux(G, Pr, m_p, Dtmp, emhd_params, gam, j, i, 0, Ur, m_u, loc);
+                        Flux::prim_to_flux(G, Pr, m_p, Dtmp, emhd_params, gam, j, i, dir, Fr, m_u, loc);
+                        Flux::vchar(G, fg, Pr, m_p, Dtmp, gam, emhd_params, k, j, i, loc, dir, cmaxR, cminR);
+
+                        // Same result as the two-pass max in GetFlux
+                        cmax(bl, dir-1, k, j, i) = m::max(0., m::max(cmaxL, cmaxR));
+                        cmin(bl, dir-1, k, j, i) = m::max(0., m::max(-cminL, -cminR));
+
+                        if (use_b_ct) {
+                            for (int v=0; v < NVEC; ++v) {
+                                vl_all(bl, face, v, k, j, i) = Pl(m_p.U1+v);
+                                vr_all(bl, face, v, k, j, i) = Pr(m_p.U1+v);
+                            }
+                        }
+                    }
+                );
+                member.team_barrier();
+
+                // Riemann solve straight out of scratch
+                for (int p=0; p < nvar; ++p) {
+                    if (!U_all.IsAllocated(bl, p)) continue;
+                    parthenon::par_for_inner(member, b.is, b.ie,
+                        [&](const int& i) {
+                            const Real cmx = cmax(bl, dir-1, k, j, i);
+                            const Real cmn = cmin(bl, dir-1, k, j, i);
+                            U_all(bl).flux(dir, p, k, j, i) = (use_hlle) ?
+                                hlle(Fl_s(p, i), Fr_s(p, i), cmx, cmn, Ul_s(p, i), Ur_s(p, i)) :
+                                llf(Fl_s(p, i), Fr_s(p, i), cmx, cmn, Ul_s(p, i), Ur_s(p, i));
+                            if (keep_face_states) {
+                                Pl_all(bl, p, k, j, i) = Pl_s(p, i);
+                                Pr_all(bl, p, k, j, i) = Pr_s(p, i);
+                                Ul_all(bl, p, k, j, i) = Ul_s(p, i);
+                                Ur_all(bl, p, k, j, i) = Ur_s(p, i);
+                                Fl_all(bl, p, k, j, i) = Fl_s(p, i);
+                                Fr_all(bl, p, k, j, i) = Fr_s(p, i);
+                            }
+                        }
+                    );
+                }
+                // Scratch is reused next row
+                member.team_barrier();
+            }
+        }
+    );
+
+    EndFlag();
+    return TaskStatus::complete;
+}
+
 /**
  * @brief Reconstruct the values of primitive variables at left and right of each zone face,
  * find the corresponding conserved variables and their fluxes through the face
@@ -69,54 +316,61 @@ inline TaskStatus GetFlux(MeshData<Real> *md)
     if (ndim < 3 && dir == X3DIR) return TaskStatus::complete;
     if (ndim < 2 && dir == X2DIR) return TaskStatus::complete;
 
-    Flag("GetFlux_"+std::to_string(dir));
+    // Optionally do everything in one kernel, see above
+    const auto& config = KHARMA::GetConfig(packages);
+    if (config.fused_flux)
+        return GetFluxFused<Recon, dir>(md);
+
+    Flag("GetFlux_", dir);
 
     // Options
-    const auto& pars       = packages.Get("Driver")->AllParams();
-    const auto& mhd_pars   = packages.Get("GRMHD")->AllParams();
     const auto& globals    = packages.Get("Globals")->AllParams();
-    const bool use_hlle    = pars.Get<bool>("use_hlle");
+    const bool use_hlle    = config.use_hlle;
 
     // TODO make this an option in Flux package
-    const bool reconstruction_floors = packages.AllPackages().count("Floors") &&
-                                       (Recon == KReconstruction::Type::weno5);
-    Floors::Prescription floors_temp;
-    if (reconstruction_floors) {
-        // Apply post-reconstruction floors.
-        // Only enabled for WENO since it is not TVD, and only when other
-        // floors are enabled.
-        const auto& floor_pars = packages.Get("Floors")->AllParams();
-        // Pull out a struct of just the actual floor values for speed
-        floors_temp = Floors::Prescription(floor_pars);
-    }
-    const Floors::Prescription& floors = floors_temp;
+    // Apply post-reconstruction floors.
+    // Only enabled for WENO since it is not TVD, and only when other
+    // floors are enabled.
+    const bool reconstruction_floors = config.use_floors && KReconstruction::needs_recon_floors(Recon);
+    const Floors::Prescription& floors = config.GetFloors();
 
-    const Real gam = mhd_pars.Get<Real>("gamma");
+    const Real gam = config.gam;
 
     // Check whether we're using constraint-damping
     // (which requires that a variable be propagated at ctop_max)
-    const bool use_b_cd = packages.AllPackages().count("B_CD");
+    const bool use_b_cd = config.use_b_cd;
     const double ctop_max = (use_b_cd) ? packages.Get("B_CD")->Param<Real>("ctop_max_last") : 0.0;
 
-    const EMHD::EMHD_parameters& emhd_params = EMHD::GetEMHDParameters(packages);
+    const EMHD::EMHD_parameters& emhd_params = config.emhd_params;
 
     const Loci loc = loc_of(dir);
 
-    // Pack variables.  Keep ctop separate
-    PackIndexMap prims_map, cons_map;
-    const auto& cmax  = md->PackVariables(std::vector<std::string>{"Flux.cmax"});
-    const auto& cmin  = md->PackVariables(std::vector<std::string>{"Flux.cmin"});
-    // TODO maybe all WithFluxes vars, split into cell & face?
-    const auto& P_all = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive"), Metadata::Cell}, prims_map);
-    const auto& U_all = md->PackVariablesAndFluxes(std::vector<MetadataFlag>{Metadata::Conserved, Metadata::Cell}, cons_map);
-    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+    // Launch on this direction's execution space instance.  If that isn't the default instance,
+    // make sure anything queued before us on the default instance (e.g. B_CT::MeshUtoP) is done
+    const bool flux_streams = config.flux_streams;
+    auto exec_space = Flux::FluxExecSpace(md, dir);
+    if (flux_streams) pmb0->exec_space.fence();
 
-    const auto& Pl_all = md->PackVariables(std::vector<std::string>{"Flux.Pl"});
-    const auto& Pr_all = md->PackVariables(std::vector<std::string>{"Flux.Pr"});
-    const auto& Ul_all = md->PackVariables(std::vector<std::string>{"Flux.Ul"});
-    const auto& Ur_all = md->PackVariables(std::vector<std::string>{"Flux.Ur"});
-    const auto& Fl_all = md->PackVariables(std::vector<std::string>{"Flux.Fl"});
-    const auto& Fr_all = md->PackVariables(std::vector<std::string>{"Flux.Fr"});
+    // Pack variables.  Keep ctop separate.  See Flux::GetFluxPacks
+    // TODO maybe all WithFluxes vars, split into cell & face?
+    const auto& packs = Flux::GetFluxPacks(md);
+    const auto& cmax  = packs.cmax;
+    const auto& cmin  = packs.cmin;
+    const auto& P_all = packs.P_all;
+    const auto& U_all = packs.U_all;
+    const VarMap& m_u = packs.m_u;
+    const VarMap& m_p = packs.m_p;
+
+    // Optionally drop to linear reconstruction around flagged zones
+    const bool use_fallback = config.troubled_fallback;
+    const auto& flags = packs.flags;
+
+    const auto& Pl_all = packs.Pl_all;
+    const auto& Pr_all = packs.Pr_all;
+    const auto& Ul_all = packs.Ul_all;
+    const auto& Ur_all = packs.Ur_all;
+    const auto& Fl_all = packs.Fl_all;
+    const auto& Fr_all = packs.Fr_all;
 
     // Get the domain size
     const IndexRange3 b = KDomain::GetRange(md, IndexDomain::interior, -1, 2);
@@ -132,66 +386,99 @@ inline TaskStatus GetFlux(MeshData<Real> *md)
         emhd_params.print();
     }
 
+    // Optionally flatten the kernels over zones, for short rows, see driver/flux_policy.
+    // Only reconstructions with a single-face version can be flattened
+    bool flat = false;
+    if constexpr (KReconstruction::has_face_recon(Recon)) flat = config.flat_flux;
+
     // Allocate scratch space
     const int scratch_level = 1; // 0 is actual scratch (tiny); 1 is HBM
     const size_t var_size_in_bytes = parthenon::ScratchPad2D<Real>::shmem_size(nvar, n1);
     // Allocate enough to cache prims, conserved, and fluxes, for left and right faces,
     // plus temporaries inside reconstruction (most use 1, WENO5 uses none, linear_vl uses a bunch)
-    const size_t recon_scratch_bytes = (2 + 1*(Recon != KReconstruction::Type::weno5) +
-                                            4*(Recon == KReconstruction::Type::linear_vl)) * var_size_in_bytes;
+    const size_t recon_scratch_bytes = (2 + KReconstruction::scratch_vars(Recon)) * var_size_in_bytes;
     const size_t flux_scratch_bytes = 3 * var_size_in_bytes;
 
     // This isn't a pmb0->par_for_outer because Parthenon's current overloaded definitions
     // do not accept three pairs of bounds, which we need in order to iterate over blocks
-    Flag("GetFlux_"+std::to_string(dir)+"_recon");
-    parthenon::par_for_outer(DEFAULT_OUTER_LOOP_PATTERN, "calc_flux_recon", pmb0->exec_space,
-        recon_scratch_bytes, scratch_level, block.s, block.e, b.ks, b.ke, b.js, b.je,
-        KOKKOS_LAMBDA(parthenon::team_mbr_t member, const int& bl, const int& k, const int& j) {
-            const auto& G = U_all.GetCoords(bl);
-            ScratchPad2D<Real> Pl_s(member.team_scratch(scratch_level), nvar, n1);
-            ScratchPad2D<Real> Pr_s(member.team_scratch(scratch_level), nvar, n1);
-
-            // We template on reconstruction type to avoid a big switch statement here.
-            // Instead, a version of GetFlux() is generated separately for each reconstruction/direction pair.
-            // See reconstruction.hpp for all the implementations.
-            KReconstruction::reconstruct<Recon, dir>(member, P_all(bl), k, j, b.is, b.ie, Pl_s, Pr_s);
-
-            // Sync all threads in the team so that scratch memory is consistent
-            member.team_barrier();
-
-            parthenon::par_for_inner(member, b.is, b.ie,
-                [&](const int& i) {
-                    auto Pl = Kokkos::subview(Pl_s, Kokkos::ALL(), i);
-                    auto Pr = Kokkos::subview(Pr_s, Kokkos::ALL(), i);
-                    // Apply floors to the *reconstructed* primitives, because without TVD
-                    // we have no guarantee they remotely resemble the *centered* primitives
+    Flag("GetFlux_", dir, "_recon");
+    // Static estimates for the timing report: read P & write Pl, Pr.  The flux kernels each read
+    // a face's prims & geometry, write its U, F & speeds; the Riemann solve reads & writes ~5 vars
+    const double nzones = static_cast<double>(block.e - block.s + 1) * (b.ke - b.ks + 1) * (b.je - b.js + 1) * (b.ie - b.is + 1);
+    Timers::CountKernel("calc_flux_recon", nzones, 3 * nvar * sizeof(Real), nvar * KReconstruction::flops_per_var(Recon));
+    if constexpr (KReconstruction::has_face_recon(Recon)) {
+        if (flat) {
+            parthenon::par_for(DEFAULT_LOOP_PATTERN, "calc_flux_recon_flat", exec_space,
+                block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+                KOKKOS_LAMBDA(const int& bl, const int& k, const int& j, const int& i) {
+                    const auto& G = U_all.GetCoords(bl);
+                    KReconstruction::reconstruct_face<Recon, dir>(P_all(bl), k, j, i, Pl_all(bl), Pr_all(bl));
+                    PackZone Pl{Pl_all(bl), k, j, i}, Pr{Pr_all(bl), k, j, i};
+                    if (use_fallback) {
+                        Flux::troubled_fallback<dir>(P_all(bl), flags(bl), k, j, i, Pl, Pr);
+                    }
+                    // As in the team kernel below
                     if (reconstruction_floors) {
                         Floors::apply_geo_floors(G, Pl, m_p, gam, j, i, floors, loc);
                         Floors::apply_geo_floors(G, Pr, m_p, gam, j, i, floors, loc);
                     }
                 }
             );
-            member.team_barrier();
+        }
+    }
+    if (!flat) {
+        parthenon::par_for_outer(DEFAULT_OUTER_LOOP_PATTERN, "calc_flux_recon", exec_space,
+            recon_scratch_bytes, scratch_level, block.s, block.e, b.ks, b.ke, b.js, b.je,
+            KOKKOS_LAMBDA(parthenon::team_mbr_t member, const int& bl, const int& k, const int& j) {
+                const auto& G = U_all.GetCoords(bl);
+                ScratchPad2D<Real> Pl_s(member.team_scratch(scratch_level), nvar, n1);
+                ScratchPad2D<Real> Pr_s(member.team_scratch(scratch_level), nvar, n1);
+
+                // We template on reconstruction type to avoid a big switch statement here.
+                // Instead, a version of GetFlux() is generated separately for each reconstruction/direction pair.
+                // See reconstruction.hpp for all the implementations.
+                KReconstruction::reconstruct<Recon, dir>(member, P_all(bl), k, j, b.is, b.ie, Pl_s, Pr_s);
+
+                // Sync all threads in the team so that scratch memory is consistent
+                member.team_barrier();
 
-            // Copy out state (TODO(BSP) eliminate)
-            for (int p=0; p < nvar; ++p) {
                 parthenon::par_for_inner(member, b.is, b.ie,
                     [&](const int& i) {
-                        Pl_all(bl, p, k, j, i) = Pl_s(p, i);
-                        Pr_all(bl, p, k, j, i) = Pr_s(p, i);
+                        auto Pl = Kokkos::subview(Pl_s, Kokkos::ALL(), i);
+                        auto Pr = Kokkos::subview(Pr_s, Kokkos::ALL(), i);
+                        if (use_fallback) {
+                            Flux::troubled_fallback<dir>(P_all(bl), flags(bl), k, j, i, Pl, Pr);
+                        }
+                        // Apply floors to the *reconstructed* primitives, because without TVD
+                        // we have no guarantee they remotely resemble the *centered* primitives
+                        if (reconstruction_floors) {
+                            Floors::apply_geo_floors(G, Pl, m_p, gam, j, i, floors, loc);
+                            Floors::apply_geo_floors(G, Pr, m_p, gam, j, i, floors, loc);
+                        }
                     }
                 );
+                member.team_barrier();
+
+                // Copy out state (TODO(BSP) eliminate)
+                for (int p=0; p < nvar; ++p) {
+                    parthenon::par_for_inner(member, b.is, b.ie,
+                        [&](const int& i) {
+                            Pl_all(bl, p, k, j, i) = Pl_s(p, i);
+                            Pr_all(bl, p, k, j, i) = Pr_s(p, i);
+                        }
+                    );
+                }
+                member.team_barrier();
             }
-            member.team_barrier();
-        }
-    );
+        );
+    }
     EndFlag();
 
     // If we have B field on faces, we must replace reconstructed version with that
-    if (pmb0->packages.AllPackages().count("B_CT")) {  // TODO if variable "cons.fB"?
-        const auto& Bf  = md->PackVariables(std::vector<std::string>{"cons.fB"});
+    if (config.use_b_ct) {  // TODO if variable "cons.fB"?
+        const auto& Bf  = packs.Bf;
         const TopologicalElement face = (dir == 1) ? F1 : ((dir == 2) ? F2 : F3);
-        pmb0->par_for("replace_face", block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        parthenon::par_for(DEFAULT_LOOP_PATTERN, "replace_face", exec_space, block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
             KOKKOS_LAMBDA(const int& bl, const int& k, const int& j, const int& i) {
                 const auto& G = U_all.GetCoords(bl);
                 const double bf = Bf(bl, face, 0, k, j, i) / G.gdet(loc, j, i);
@@ -205,125 +492,169 @@ inline TaskStatus GetFlux(MeshData<Real> *md)
     // TODO per-package prim_to_flux?  Is that slower?
     // At least, we need to template on vchar/stress-energy T type
 
-    Flag("GetFlux_"+std::to_string(dir)+"_left");
-    parthenon::par_for_outer(DEFAULT_OUTER_LOOP_PATTERN, "calc_flux_left", pmb0->exec_space,
-        flux_scratch_bytes, scratch_level, block.s, block.e, b.ks, b.ke, b.js, b.je,
-        KOKKOS_LAMBDA(parthenon::team_mbr_t member, const int& bl, const int& k, const int& j) {
-            const auto& G = U_all.GetCoords(bl);
-            ScratchPad2D<Real> Pl_s(member.team_scratch(scratch_level), nvar, n1);
-            ScratchPad2D<Real> Ul_s(member.team_scratch(scratch_level), nvar, n1);
-            ScratchPad2D<Real> Fl_s(member.team_scratch(scratch_level), nvar, n1);
-
-            // Copy in state (TODO(BSP) eliminate)
-            for (int p=0; p < nvar; ++p) {
-                parthenon::par_for_inner(member, b.is, b.ie,
-                    [&](const int& i) {
-                        Pl_s(p, i) = Pl_all(bl, p, k, j, i);
-                    }
-                );
+    if (flat) {
+        // Both sides of each face in the same thread, straight from the face states
+        Flag("GetFlux_", dir, "_lr");
+        Timers::CountKernel("calc_flux", 2 * nzones, (3 * nvar + 2 + 33) * sizeof(Real), 450);
+        parthenon::par_for(DEFAULT_LOOP_PATTERN, "calc_flux_lr_flat", exec_space,
+            block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+            KOKKOS_LAMBDA(const int& bl, const int& k, const int& j, const int& i) {
+                const auto& G = U_all.GetCoords(bl);
+                const PackZone Pl{Pl_all(bl), k, j, i}, Ul{Ul_all(bl), k, j, i}, Fl{Fl_all(bl), k, j, i};
+                const PackZone Pr{Pr_all(bl), k, j, i}, Ur{Ur_all(bl), k, j, i}, Fr{Fr_all(bl), k, j, i};
+                FourVectors Dtmp;
+                FaceGeom fg;
+                G.face_geom(loc, j, i, fg);
+
+                // Left
+                GRMHD::calc_4vecs(fg, Pl, m_p, j, i, loc, Dtmp);
+                Flux::prim_to_flux(G, Pl, m_p, Dtmp, emhd_params, gam, j, i, 0, Ul, m_u, loc);
+                Flux::prim_to_flux(G, Pl, m_p, Dtmp, emhd_params, gam, j, i, dir, Fl, m_u, loc);
+                Real cmaxL, cminL;
+                Flux::vchar(G, fg, Pl, m_p, Dtmp, gam, emhd_params, k, j, i, loc, dir, cmaxL, cminL);
+
+                // Right
+                GRMHD::calc_4vecs(fg, Pr, m_p, j, i, loc, Dtmp);
+                Flux::prim_to_flux(G, Pr, m_p, Dtmp, emhd_params, gam, j, i, 0, Ur, m_u, loc);
+                Flux::prim_to_flux(G, Pr, m_p, Dtmp, emhd_params, gam, j, i, dir, Fr, m_u, loc);
+                Real cmaxR, cminR;
+                Flux::vchar(G, fg, Pr, m_p, Dtmp, gam, emhd_params, k, j, i, loc, dir, cmaxR, cminR);
+
+                // As the split kernels
+                cmax(bl, dir-1, k, j, i) = m::abs(m::max(m::max(0., cmaxL),  cmaxR));
+                cmin(bl, dir-1, k, j, i) = m::abs(m::max(m::max(0., -cminL), -cminR));
             }
-            member.team_barrier();
-
-            // LEFT FACES
-            parthenon::par_for_inner(member, b.is, b.ie,
-                [&](const int& i) {
-                    auto Pl = Kokkos::subview(Pl_s, Kokkos::ALL(), i);
-                    auto Ul = Kokkos::subview(Ul_s, Kokkos::ALL(), i);
-                    auto Fl = Kokkos::subview(Fl_s, Kokkos::ALL(), i);
-                    // Declare temporary vectors
-                    FourVectors Dtmp;
-
-                    // Left
-                    GRMHD::calc_4vecs(G, Pl, m_p, j, i, loc, Dtmp);
-                    Flux::prim_to_flux(G, Pl, m_p, Dtmp, emhd_params, gam, j, i, 0, Ul, m_u, loc);
-                    Flux::prim_to_flux(G, Pl, m_p, Dtmp, emhd_params, gam, j, i, dir, Fl, m_u, loc);
-
-                    // Magnetosonic speeds
-                    Real cmaxL, cminL;
-                    Flux::vchar(G, Pl, m_p, Dtmp, gam, emhd_params, k, j, i, loc, dir, cmaxL, cminL);
-
-                    // Record speeds
-                    cmax(bl, dir-1, k, j, i) = m::max(0., cmaxL);
-                    cmin(bl, dir-1, k, j, i) = m::max(0., -cminL);
+        );
+        EndFlag();
+    } else {
+        Flag("GetFlux_", dir, "_left");
+        Timers::CountKernel("calc_flux", nzones, (3 * nvar + 2 + 33) * sizeof(Real), 450);
+        parthenon::par_for_outer(DEFAULT_OUTER_LOOP_PATTERN, "calc_flux_left", exec_space,
+            flux_scratch_bytes, scratch_level, block.s, block.e, b.ks, b.ke, b.js, b.je,
+            KOKKOS_LAMBDA(parthenon::team_mbr_t member, const int& bl, const int& k, const int& j) {
+                const auto& G = U_all.GetCoords(bl);
+                ScratchPad2D<Real> Pl_s(member.team_scratch(scratch_level), nvar, n1);
+                ScratchPad2D<Real> Ul_s(member.team_scratch(scratch_level), nvar, n1);
+                ScratchPad2D<Real> Fl_s(member.team_scratch(scratch_level), nvar, n1);
+
+                // Copy in state (TODO(BSP) eliminate)
+                for (int p=0; p < nvar; ++p) {
+                    parthenon::par_for_inner(member, b.is, b.ie,
+                        [&](const int& i) {
+                            Pl_s(p, i) = Pl_all(bl, p, k, j, i);
+                        }
+                    );
                 }
-            );
-            member.team_barrier();
+                member.team_barrier();
 
-            // Copy out state
-            for (int p=0; p < nvar; ++p) {
+                // LEFT FACES
                 parthenon::par_for_inner(member, b.is, b.ie,
                     [&](const int& i) {
-                        Ul_all(bl, p, k, j, i) = Ul_s(p, i);
-                        Fl_all(bl, p, k, j, i) = Fl_s(p, i);
+                        auto Pl = Kokkos::subview(Pl_s, Kokkos::ALL(), i);
+                        auto Ul = Kokkos::subview(Ul_s, Kokkos::ALL(), i);
+                        auto Fl = Kokkos::subview(Fl_s, Kokkos::ALL(), i);
+                        // Declare temporary vectors
+                        FourVectors Dtmp;
+                        FaceGeom fg;
+                        G.face_geom(loc, j, i, fg);
+
+                        // Left
+                        GRMHD::calc_4vecs(fg, Pl, m_p, j, i, loc, Dtmp);
+                        Flux::prim_to_flux(G, Pl, m_p, Dtmp, emhd_params, gam, j, i, 0, Ul, m_u, loc);
+                        Flux::prim_to_flux(G, Pl, m_p, Dtmp, emhd_params, gam, j, i, dir, Fl, m_u, loc);
+
+                        // Magnetosonic speeds
+                        Real cmaxL, cminL;
+                        Flux::vchar(G, fg, Pl, m_p, Dtmp, gam, emhd_params, k, j, i, loc, dir, cmaxL, cminL);
+
+                        // Record speeds
+                        cmax(bl, dir-1, k, j, i) = m::max(0., cmaxL);
+                        cmin(bl, dir-1, k, j, i) = m::max(0., -cminL);
                     }
                 );
+                member.team_barrier();
+
+                // Copy out state
+                for (int p=0; p < nvar; ++p) {
+                    parthenon::par_for_inner(member, b.is, b.ie,
+                        [&](const int& i) {
+                            Ul_all(bl, p, k, j, i) = Ul_s(p, i);
+                            Fl_all(bl, p, k, j, i) = Fl_s(p, i);
+                        }
+                    );
+                }
             }
-        }
-    );
-    EndFlag();
+        );
+        EndFlag();
 
-    Flag("GetFlux_"+std::to_string(dir)+"_right");
-    parthenon::par_for_outer(DEFAULT_OUTER_LOOP_PATTERN, "calc_flux_right", pmb0->exec_space,
-        flux_scratch_bytes, scratch_level, block.s, block.e, b.ks, b.ke, b.js, b.je,
-        KOKKOS_LAMBDA(parthenon::team_mbr_t member, const int& bl, const int& k, const int& j) {
-            const auto& G = U_all.GetCoords(bl);
-            ScratchPad2D<Real> Pr_s(member.team_scratch(scratch_level), nvar, n1);
-            ScratchPad2D<Real> Ur_s(member.team_scratch(scratch_level), nvar, n1);
-            ScratchPad2D<Real> Fr_s(member.team_scratch(scratch_level), nvar, n1);
+        Flag("GetFlux_", dir, "_right");
+        Timers::CountKernel("calc_flux", nzones, (3 * nvar + 2 + 33) * sizeof(Real), 450);
+        parthenon::par_for_outer(DEFAULT_OUTER_LOOP_PATTERN, "calc_flux_right", exec_space,
+            flux_scratch_bytes, scratch_level, block.s, block.e, b.ks, b.ke, b.js, b.je,
+            KOKKOS_LAMBDA(parthenon::team_mbr_t member, const int& bl, const int& k, const int& j) {
+                const auto& G = U_all.GetCoords(bl);
+                ScratchPad2D<Real> Pr_s(member.team_scratch(scratch_level), nvar, n1);
+                ScratchPad2D<Real> Ur_s(member.team_scratch(scratch_level), nvar, n1);
+                ScratchPad2D<Real> Fr_s(member.team_scratch(scratch_level), nvar, n1);
+
+                // Copy in state (TODO(BSP) eliminate)
+                for (int p=0; p < nvar; ++p) {
+                    parthenon::par_for_inner(member, b.is, b.ie,
+                        [&](const int& i) {
+                            Pr_s(p, i) = Pr_all(bl, p, k, j, i);
+                        }
+                    );
+                }
+                member.team_barrier();
 
-            // Copy in state (TODO(BSP) eliminate)
-            for (int p=0; p < nvar; ++p) {
+                // RIGHT FACES, finalize signal speed
                 parthenon::par_for_inner(member, b.is, b.ie,
                     [&](const int& i) {
-                        Pr_s(p, i) = Pr_all(bl, p, k, j, i);
+                        auto Pr = Kokkos::subview(Pr_s, Kokkos::ALL(), i);
+                        auto Ur = Kokkos::subview(Ur_s, Kokkos::ALL(), i);
+                        auto Fr = Kokkos::subview(Fr_s, Kokkos::ALL(), i);
+                        // Declare temporary vectors
+                        FourVectors Dtmp;
+                        FaceGeom fg;
+                        G.face_geom(loc, j, i, fg);
+                        // Right
+                        GRMHD::calc_4vecs(fg, Pr, m_p, j, i, loc, Dtmp);
+                        Flux::prim_to_flux(G, Pr, m_p, Dtmp, emhd_params, gam, j, i, 0, Ur, m_u, loc);
+                        Flux::prim_to_flux(G, Pr, m_p, Dtmp, emhd_params, gam, j, i, dir, Fr, m_u, loc);
+
+                        // Magnetosonic speeds
+                        Real cmaxR, cminR;
+                        Flux::vchar(G, fg, Pr, m_p, Dtmp, gam, emhd_params, k, j, i, loc, dir, cmaxR, cminR);
+
+                        // Calculate cmax/min based on comparison with cached values
+                        cmax(bl, dir-1, k, j, i) = m::abs(m::max(cmax(bl, dir-1, k, j, i),  cmaxR));
+                        cmin(bl, dir-1, k, j, i) = m::abs(m::max(cmin(bl, dir-1, k, j, i), -cminR));
                     }
                 );
-            }
-            member.team_barrier();
-
-            // RIGHT FACES, finalize signal speed
-            parthenon::par_for_inner(member, b.is, b.ie,
-                [&](const int& i) {
-                    auto Pr = Kokkos::subview(Pr_s, Kokkos::ALL(), i);
-                    auto Ur = Kokkos::subview(Ur_s, Kokkos::ALL(), i);
-                    auto Fr = Kokkos::subview(Fr_s, Kokkos::ALL(), i);
-                    // Declare temporary vectors
-                    FourVectors Dtmp;
-                    // Right
-                    GRMHD::calc_4vecs(G, Pr, m_p, j, i, loc, Dtmp);
-                    Flux::prim_to_flux(G, Pr, m_p, Dtmp, emhd_params, gam, j, i, 0, Ur, m_u, loc);
-                    Flux::prim_to_flux(G, Pr, m_p, Dtmp, emhd_params, gam, j, i, dir, Fr, m_u, loc);
-
-                    // Magnetosonic speeds
-                    Real cmaxR, cminR;
-                    Flux::vchar(G, Pr, m_p, Dtmp, gam, emhd_params, k, j, i, loc, dir, cmaxR, cminR);
-
-                    // Calculate cmax/min based on comparison with cached values
-                    cmax(bl, dir-1, k, j, i) = m::abs(m::max(cmax(bl, dir-1, k, j, i),  cmaxR));
-                    cmin(bl, dir-1, k, j, i) = m::abs(m::max(cmin(bl, dir-1, k, j, i), -cminR));
+                member.team_barrier();
+
+                // Copy out state
+                for (int p=0; p < nvar; ++p) {
+                    parthenon::par_for_inner(member, b.is, b.ie,
+                        [&](const int& i) {
+                            Ur_all(bl, p, k, j, i) = Ur_s(p, i);
+                            Fr_all(bl, p, k, j, i) = Fr_s(p, i);
+                        }
+                    );
                 }
-            );
-            member.team_barrier();
 
-            // Copy out state
-            for (int p=0; p < nvar; ++p) {
-                parthenon::par_for_inner(member, b.is, b.ie,
-                    [&](const int& i) {
-                        Ur_all(bl, p, k, j, i) = Ur_s(p, i);
-                        Fr_all(bl, p, k, j, i) = Fr_s(p, i);
-                    }
-                );
             }
-
-        }
-    );
-    EndFlag();
+        );
+        EndFlag();
+    }
 
     // Apply what we've calculated
-    Flag("GetFlux_"+std::to_string(dir)+"_riemann");
+    Flag("GetFlux_", dir, "_riemann");
+    Timers::CountKernel("calc_flux", nzones, (5 * nvar + 2) * sizeof(Real), 6 * nvar);
     if (use_hlle) { // More fluxes would need a template
-        pmb0->par_for("flux_hlle", block.s, block.e, 0, nvar-1, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        parthenon::par_for(DEFAULT_LOOP_PATTERN, "flux_hlle", exec_space, block.s, block.e, 0, nvar-1, b.ks, b.ke, b.js, b.je, b.is, b.ie,
             KOKKOS_LAMBDA(const int& bl, const int& p, const int& k, const int& j, const int& i) {
+                if (!U_all.IsAllocated(bl, p)) return;
                 U_all(bl).flux(dir, p, k, j, i) = hlle(Fl_all(bl, p, k, j, i), Fr_all(bl, p, k, j, i),
                                                       cmax(bl, dir-1, k, j, i), cmin(bl, dir-1, k, j, i),
                                                       Ul_all(bl, p, k, j, i), Ur_all(bl, p, k, j, i));
@@ -332,8 +663,9 @@ inline TaskStatus GetFlux(MeshData<Real> *md)
             }
         );
     } else {
-        pmb0->par_for("flux_llf", block.s, block.e, 0, nvar-1, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        parthenon::par_for(DEFAULT_LOOP_PATTERN, "flux_llf", exec_space, block.s, block.e, 0, nvar-1, b.ks, b.ke, b.js, b.je, b.is, b.ie,
             KOKKOS_LAMBDA(const int& bl, const int& p, const int& k, const int& j, const int& i) {
+                if (!U_all.IsAllocated(bl, p)) return;
                 U_all(bl).flux(dir, p, k, j, i) = llf(Fl_all(bl, p, k, j, i), Fr_all(bl, p, k, j, i),
                                                      cmax(bl, dir-1, k, j, i), cmin(bl, dir-1, k, j, i),
                                                      Ul_all(bl, p, k, j, i), Ur_all(bl, p, k, j, i));
@@ -346,12 +678,12 @@ inline TaskStatus GetFlux(MeshData<Real> *md)
 
     // Save the face velocities for upwinding/CT later
     // TODO only for certain GS'05
-    if (packages.AllPackages().count("B_CT")) {
-        Flag("GetFlux_"+std::to_string(dir)+"_store_vel");
-        const auto& vl_all = md->PackVariables(std::vector<std::string>{"Flux.vl"});
-        const auto& vr_all = md->PackVariables(std::vector<std::string>{"Flux.vr"});
+    if (config.use_b_ct) {
+        Flag("GetFlux_", dir, "_store_vel");
+        const auto& vl_all = packs.vl_all;
+        const auto& vr_all = packs.vr_all;
         TopologicalElement face = (dir == 1) ? F1 : (dir == 2) ? F2 : F3;
-        pmb0->par_for("flux_llf", block.s, block.e, 0, NVEC-1, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        parthenon::par_for(DEFAULT_LOOP_PATTERN, "store_face_vel", exec_space, block.s, block.e, 0, NVEC-1, b.ks, b.ke, b.js, b.je, b.is, b.ie,
             KOKKOS_LAMBDA(const int& bl, const int& v, const int& k, const int& j, const int& i) {
                 vl_all(bl, face, v, k, j, i) = Pl_all(bl, m_p.U1+v, k, j, i);
                 vr_all(bl, face, v, k, j, i) = Pr_all(bl, m_p.U1+v, k, j, i);
@@ -49,7 +49,56 @@ namespace KReconstruction
 constexpr Real EPS = 1.e-26;
 
 // Enum for types.
-enum class Type{donor_cell=0, linear_mc, linear_vl, ppm, mp5, weno5, weno5_lower_edges, weno5_lower_poles};
+enum class Type{donor_cell=0, linear_mc, linear_vl, ppm, mp5, weno5, weno5_lower_edges, weno5_lower_poles, weno5_batched, weno5z};
+
+/**
+ * Width in zones of the stencil used by the reconstruction named by driver/reconstruction.
+ * A block needs stencil/2 + 1 ghost zones to reconstruct at all of its faces.
+ */
+inline int stencil_width(const std::string& recon)
+{
+    return (recon == "donor_cell") ? 1 : (recon == "linear_mc" || recon == "linear_vl") ? 3 : 5;
+}
+
+/**
+ * Number of extra scratch arrays (of size nvar x n1) a reconstruction allocates internally,
+ * on top of the ql/qr arrays passed to it.  Used to size scratch memory in GetFlux
+ */
+KOKKOS_INLINE_FUNCTION constexpr int scratch_vars(const Type recon)
+{
+    return (recon == Type::weno5 || recon == Type::weno5_batched || recon == Type::weno5z ||
+            recon == Type::ppm || recon == Type::mp5) ? 0 :
+           (recon == Type::linear_vl) ? 5 : 1;
+}
+
+/**
+ * Rough FLOPs per variable per zone of a reconstruction, for the kernel throughput report in timers.hpp
+ */
+KOKKOS_INLINE_FUNCTION constexpr int flops_per_var(const Type recon)
+{
+    return (recon == Type::donor_cell) ? 0 :
+           (recon == Type::linear_mc || recon == Type::linear_vl) ? 12 :
+           (recon == Type::ppm) ? 50 :
+           (recon == Type::mp5) ? 70 : 90;
+}
+
+/**
+ * Whether a reconstruction is implemented as a single five-point stencil per zone (see stencil5()),
+ * and so can be split up into a row at a time by Stencil5Row
+ */
+KOKKOS_INLINE_FUNCTION constexpr bool is_stencil5(const Type recon)
+{
+    return recon == Type::weno5 || recon == Type::weno5z || recon == Type::ppm || recon == Type::mp5;
+}
+
+/**
+ * Whether a reconstruction is free to produce face values outside the range of its neighbors,
+ * and so should be followed by floors on the reconstructed values.
+ */
+KOKKOS_INLINE_FUNCTION constexpr bool needs_recon_floors(const Type recon)
+{
+    return recon == Type::weno5 || recon == Type::weno5_batched || recon == Type::weno5z;
+}
 
 // BUILD UP (a) LINEAR MC RECONSTRUCTION
 
@@ -71,6 +120,7 @@ KOKKOS_INLINE_FUNCTION void PiecewiseLinearX1(parthenon::team_mbr_t const &membe
 {
     const int nu = q.GetDim(4) - 1;
     for (int p = 0; p <= nu; ++p) {
+        if (!var_allocated(q, p)) continue;
         parthenon::par_for_inner(member, il, iu,
             KOKKOS_LAMBDA (const int& i) {
                 Real dql = q(p, k, j, i) - q(p, k, j, i - 1);
@@ -89,6 +139,7 @@ KOKKOS_INLINE_FUNCTION void PiecewiseLinearX2(parthenon::team_mbr_t const &membe
 {
     const int nu = q.GetDim(4) - 1;
     for (int p = 0; p <= nu; ++p) {
+        if (!var_allocated(q, p)) continue;
         parthenon::par_for_inner(member, il, iu,
             KOKKOS_LAMBDA (const int& i) {
                 Real dql = q(p, k, j, i) - q(p, k, j - 1, i);
@@ -107,6 +158,7 @@ KOKKOS_INLINE_FUNCTION void PiecewiseLinearX3(parthenon::team_mbr_t const &membe
 {
     const int nu = q.GetDim(4) - 1;
     for (int p = 0; p <= nu; ++p) {
+        if (!var_allocated(q, p)) continue;
         parthenon::par_for_inner(member, il, iu,
             KOKKOS_LAMBDA (const int& i) {
                 Real dql = q(p, k, j, i) - q(p, k - 1, j, i);
@@ -294,6 +346,7 @@ KOKKOS_INLINE_FUNCTION void WENO5X1(parthenon::team_mbr_t const &member, const i
 {
     const int nu = q.GetDim(4) - 1;
     for (int p = 0; p <= nu; ++p) {
+        if (!var_allocated(q, p)) continue;
         parthenon::par_for_inner(member, il, iu,
             KOKKOS_LAMBDA (const int& i) {
                 Real lout, rout;
@@ -315,6 +368,7 @@ KOKKOS_INLINE_FUNCTION void WENO5X2(parthenon::team_mbr_t const &member, const i
 {
     const int nu = q.GetDim(4) - 1;
     for (int p = 0; p <= nu; ++p) {
+        if (!var_allocated(q, p)) continue;
         parthenon::par_for_inner(member, il, iu,
             KOKKOS_LAMBDA (const int& i) {
                 Real lout, rout;
@@ -335,6 +389,7 @@ KOKKOS_INLINE_FUNCTION void WENO5X2l(parthenon::team_mbr_t const &member, const
 {
     const int nu = q.GetDim(4) - 1;
     for (int p = 0; p <= nu; ++p) {
+        if (!var_allocated(q, p)) continue;
         parthenon::par_for_inner(member, il, iu,
             KOKKOS_LAMBDA (const int& i) {
                 Real rout;
@@ -354,6 +409,7 @@ KOKKOS_INLINE_FUNCTION void WENO5X2r(parthenon::team_mbr_t const &member, const
 {
     const int nu = q.GetDim(4) - 1;
     for (int p = 0; p <= nu; ++p) {
+        if (!var_allocated(q, p)) continue;
         parthenon::par_for_inner(member, il, iu,
             KOKKOS_LAMBDA (const int& i) {
                 Real lout;
@@ -374,6 +430,7 @@ KOKKOS_INLINE_FUNCTION void WENO5X3(parthenon::team_mbr_t const &member, const i
 {
     const int nu = q.GetDim(4) - 1;
     for (int p = 0; p <= nu; ++p) {
+        if (!var_allocated(q, p)) continue;
         parthenon::par_for_inner(member, il, iu,
             KOKKOS_LAMBDA (const int& i) {
                 Real lout, rout;
@@ -394,6 +451,7 @@ KOKKOS_INLINE_FUNCTION void WENO5X3l(parthenon::team_mbr_t const &member, const
 {
     const int nu = q.GetDim(4) - 1;
     for (int p = 0; p <= nu; ++p) {
+        if (!var_allocated(q, p)) continue;
         parthenon::par_for_inner(member, il, iu,
             KOKKOS_LAMBDA (const int& i) {
                 Real rout;
@@ -413,6 +471,7 @@ KOKKOS_INLINE_FUNCTION void WENO5X3r(parthenon::team_mbr_t const &member, const
 {
     const int nu = q.GetDim(4) - 1;
     for (int p = 0; p <= nu; ++p) {
+        if (!var_allocated(q, p)) continue;
         parthenon::par_for_inner(member, il, iu,
             KOKKOS_LAMBDA (const int& i) {
                 Real lout;
@@ -427,6 +486,89 @@ KOKKOS_INLINE_FUNCTION void WENO5X3r(parthenon::team_mbr_t const &member, const
     }
 }
 
+// BATCHED WENO5
+// The same scheme as weno5() above, but evaluated on fixed-width batches of zones laid out
+// struct-of-arrays, so that the stencil arithmetic vectorizes across zones on CPUs.
+// On GPUs this just amounts to each thread handling WENO_BATCH zones.
+constexpr int WENO_BATCH = 8;
+
+template <bool do_l, bool do_r>
+KOKKOS_INLINE_FUNCTION void weno5_batch(const Real (&x)[5][WENO_BATCH], Real (&lout)[WENO_BATCH], Real (&rout)[WENO_BATCH])
+{
+    Real beta0[WENO_BATCH], beta1[WENO_BATCH], beta2[WENO_BATCH];
+    for (int w = 0; w < WENO_BATCH; ++w) {
+        // Smoothness indicators, T07 A18 or S11 8
+        const Real c1a = x[0][w] - 2.*x[1][w] + x[2][w], c2a = x[0][w] - 4.*x[1][w] + 3.*x[2][w];
+        const Real c1b = x[1][w] - 2.*x[2][w] + x[3][w], c2b = x[3][w] - x[1][w];
+        const Real c1c = x[2][w] - 2.*x[3][w] + x[4][w], c2c = x[4][w] - 4.*x[3][w] + 3.*x[2][w];
+        beta0[w] = EPS + (13./12.)*c1a*c1a + (1./4.)*c2a*c2a;
+        beta1[w] = EPS + (13./12.)*c1b*c1b + (1./4.)*c2b*c2b;
+        beta2[w] = EPS + (13./12.)*c1c*c1c + (1./4.)*c2c*c2c;
+        beta0[w] *= beta0[w]; beta1[w] *= beta1[w]; beta2[w] *= beta2[w];
+    }
+    if (do_l) {
+        for (int w = 0; w < WENO_BATCH; ++w) {
+            // Nonlinear weights S11 9
+            const Real wt0 = (1./16.)/beta2[w], wt1 = (5./8.)/beta1[w], wt2 = (5./16.)/beta0[w];
+            const Real Winv = 1./(wt0 + wt1 + wt2);
+            lout[w] = (((3./8.)*x[4][w] - (5./4.)*x[3][w] + (15./8.)*x[2][w])*wt0 +
+                       ((-1./8.)*x[3][w] + (3./4.)*x[2][w] + (3./8.)*x[1][w])*wt1 +
+                       ((3./8.)*x[2][w] + (3./4.)*x[1][w] - (1./8.)*x[0][w])*wt2) * Winv;
+        }
+    }
+    if (do_r) {
+        for (int w = 0; w < WENO_BATCH; ++w) {
+            const Real wt0 = (1./16.)/beta0[w], wt1 = (5./8.)/beta1[w], wt2 = (5./16.)/beta2[w];
+            const Real Winv = 1./(wt0 + wt1 + wt2);
+            rout[w] = (((3./8.)*x[0][w] - (5./4.)*x[1][w] + (15./8.)*x[2][w])*wt0 +
+                       ((-1./8.)*x[1][w] + (3./4.)*x[2][w] + (3./8.)*x[3][w])*wt1 +
+                       ((3./8.)*x[2][w] + (3./4.)*x[3][w] - (1./8.)*x[4][w])*wt2) * Winv;
+        }
+    }
+}
+
+/**
+ * Row-wise batched WENO5 along direction dir, for rows at k, j.
+ * Writes left values with the same face offsets as WENO5X{1,2,3}l and
+ * right values as WENO5X{1,2,3}r (i.e., in X1 ql(i+1) and qr(i) from zone i).
+ * The final partial batch is padded by clamping the zone index, and its
+ * extra results discarded.
+ */
+template <int dir, bool do_l, bool do_r, typename T>
+KOKKOS_INLINE_FUNCTION void WENO5Batched(parthenon::team_mbr_t const &member, const int& k, const int& j,
+                       const int& il, const int& iu, const T &q, ScratchPad2D<Real> &ql,
+                       ScratchPad2D<Real> &qr)
+{
+    const int nu = q.GetDim(4) - 1;
+    const int nbatch = (iu - il + WENO_BATCH) / WENO_BATCH;
+    // X1 faces are offset by one from zone centers, like in WENO5X1
+    constexpr int lshift = (dir == X1DIR) ? 1 : 0;
+    for (int p = 0; p <= nu; ++p) {
+        if (!var_allocated(q, p)) continue;
+        parthenon::par_for_inner(member, 0, nbatch - 1,
+            KOKKOS_LAMBDA (const int& ib) {
+                const int i0 = il + ib * WENO_BATCH;
+                Real x[5][WENO_BATCH], lout[WENO_BATCH], rout[WENO_BATCH];
+                for (int s = 0; s < 5; ++s) {
+                    for (int w = 0; w < WENO_BATCH; ++w) {
+                        const int i = m::min(i0 + w, iu);
+                        x[s][w] = (dir == X1DIR) ? q(p, k, j, i + s - 2) :
+                                  (dir == X2DIR) ? q(p, k, j + s - 2, i) :
+                                                   q(p, k + s - 2, j, i);
+                    }
+                }
+                weno5_batch<do_r, do_l>(x, lout, rout);
+                const int nw = m::min(WENO_BATCH, iu - i0 + 1);
+                for (int w = 0; w < nw; ++w) {
+                    // Face-relative "left" is the zone-relative "right" and vice versa, see above
+                    if (do_l) ql(p, i0 + w + lshift) = rout[w];
+                    if (do_r) qr(p, i0 + w) = lout[w];
+                }
+            }
+        );
+    }
+}
+
 /**
  * Parablic reconstruction, see Collela & Woodward '84
  *  
@@ -475,6 +617,182 @@ KOKKOS_INLINE_FUNCTION void para(const Real& x1, const Real& x2, const Real& x3,
 }
 
 
+// WENO-Z: WENO5 with the improved nonlinear weights of Borges et al. 2008 (B08),
+// which are less dissipative near smooth extrema.  Same conventions as weno5()
+KOKKOS_INLINE_FUNCTION void weno5z(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                Real &lout, Real &rout)
+{
+    // Smoothness indicators, T07 A18 or S11 8
+    Real beta[3], c1, c2;
+    c1 = x1 - 2.*x2 + x3; c2 = x1 - 4.*x2 + 3.*x3;
+    beta[0] = (13./12.)*c1*c1 + (1./4.)*c2*c2;
+    c1 = x2 - 2.*x3 + x4; c2 = x4 - x2;
+    beta[1] = (13./12.)*c1*c1 + (1./4.)*c2*c2;
+    c1 = x3 - 2.*x4 + x5; c2 = x5 - 4.*x4 + 3.*x3;
+    beta[2] = (13./12.)*c1*c1 + (1./4.)*c2*c2;
+
+    // Global smoothness indicator & weights B08 eqs. 25, 28 (with q = 2)
+    const Real tau5 = m::abs(beta[0] - beta[2]);
+    Real ind[3];
+    for (int n = 0; n < 3; ++n) ind[n] = 1. + SQR(tau5 / (beta[n] + EPS));
+
+    const Real wtr[3] = {(1./16.)*ind[0], (5./8.)*ind[1], (5./16.)*ind[2]};
+    const Real Wr = wtr[0] + wtr[1] + wtr[2];
+    const Real wtl[3] = {(1./16.)*ind[2], (5./8.)*ind[1], (5./16.)*ind[0]};
+    const Real Wl = wtl[0] + wtl[1] + wtl[2];
+
+    lout = ((3./8.)*x5 - (5./4.)*x4 + (15./8.)*x3)*(wtl[0] / Wl) +
+            ((-1./8.)*x4 + (3./4.)*x3 + (3./8.)*x2)*(wtl[1] / Wl) +
+            ((3./8.)*x3 + (3./4.)*x2 - (1./8.)*x1)*(wtl[2] / Wl);
+    rout = ((3./8.)*x1 - (5./4.)*x2 + (15./8.)*x3)*(wtr[0] / Wr) +
+            ((-1./8.)*x2 + (3./4.)*x3 + (3./8.)*x4)*(wtr[1] / Wr) +
+            ((3./8.)*x3 + (3./4.)*x4 - (1./8.)*x5)*(wtr[2] / Wr);
+}
+
+// MP5: monotonicity-preserving 5th-order reconstruction, Suresh & Huynh 1997 (SH97)
+KOKKOS_INLINE_FUNCTION Real minmod2(const Real& a, const Real& b)
+{
+    return 0.5 * (m::copysign(1., a) + m::copysign(1., b)) * m::min(m::abs(a), m::abs(b));
+}
+KOKKOS_INLINE_FUNCTION Real minmod4(const Real& a, const Real& b, const Real& c, const Real& d)
+{
+    const Real sa = m::copysign(1., a);
+    return 0.125 * (sa + m::copysign(1., b)) * m::abs((sa + m::copysign(1., c)) * (sa + m::copysign(1., d)))
+            * m::min(m::min(m::abs(a), m::abs(b)), m::min(m::abs(c), m::abs(d)));
+}
+// Value at the right face of the zone x3, i.e. "rout"
+KOKKOS_INLINE_FUNCTION Real mp5_face(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5)
+{
+    constexpr Real alpha = 4.;
+    // Unlimited 5th-order interpolant, SH97 2.1
+    const Real f = (2.*x1 - 13.*x2 + 47.*x3 + 27.*x4 - 3.*x5) / 60.;
+    // Monotonicity-preserving bound, SH97 2.12
+    const Real fmp = x3 + minmod2(x4 - x3, alpha*(x3 - x2));
+    if ((f - x3)*(f - fmp) <= 1.e-12) return f;
+
+    // Curvature measures & limits, SH97 2.19-2.27
+    const Real dm = x1 + x3 - 2.*x2;
+    const Real d0 = x2 + x4 - 2.*x3;
+    const Real dp = x3 + x5 - 2.*x4;
+    const Real dm4p = minmod4(4.*d0 - dp, 4.*dp - d0, d0, dp);
+    const Real dm4m = minmod4(4.*d0 - dm, 4.*dm - d0, d0, dm);
+    const Real ful = x3 + alpha*(x3 - x2);
+    const Real fmd = 0.5*(x3 + x4) - 0.5*dm4p;
+    const Real flc = x3 + 0.5*(x3 - x2) + (4./3.)*dm4m;
+    const Real fmin = m::max(m::min(m::min(x3, x4), fmd), m::min(m::min(x3, ful), flc));
+    const Real fmax = m::min(m::max(m::max(x3, x4), fmd), m::max(m::max(x3, ful), flc));
+    // Median, i.e. clip f into [fmin, fmax]
+    return f + minmod2(fmin - f, fmax - f);
+}
+KOKKOS_INLINE_FUNCTION void mp5(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                Real &lout, Real &rout)
+{
+    lout = mp5_face(x5, x4, x3, x2, x1);
+    rout = mp5_face(x1, x2, x3, x4, x5);
+}
+
+/**
+ * Single-zone five-point stencil, dispatched on reconstruction type.
+ * Same conventions as weno5(); lout/rout are relative to the zone center
+ */
+template <Type Recon>
+KOKKOS_INLINE_FUNCTION void stencil5(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                     Real &lout, Real &rout);
+template <>
+KOKKOS_INLINE_FUNCTION void stencil5<Type::weno5>(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                     Real &lout, Real &rout) { weno5(x1, x2, x3, x4, x5, lout, rout); }
+template <>
+KOKKOS_INLINE_FUNCTION void stencil5<Type::ppm>(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                     Real &lout, Real &rout) { para(x1, x2, x3, x4, x5, lout, rout); }
+template <>
+KOKKOS_INLINE_FUNCTION void stencil5<Type::mp5>(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                     Real &lout, Real &rout) { mp5(x1, x2, x3, x4, x5, lout, rout); }
+template <>
+KOKKOS_INLINE_FUNCTION void stencil5<Type::weno5z>(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                     Real &lout, Real &rout) { weno5z(x1, x2, x3, x4, x5, lout, rout); }
+
+/**
+ * Row-wise application of any five-point stencil along direction dir.
+ * Offsets of ql/qr follow WENO5X1 (X1) and WENO5X{2,3}{l,r} (X2, X3), see WENO5Batched
+ */
+template <Type Recon, int dir, bool do_l, bool do_r, typename T>
+KOKKOS_INLINE_FUNCTION void Stencil5Row(parthenon::team_mbr_t const &member, const int& k, const int& j,
+                       const int& il, const int& iu, const T &q, ScratchPad2D<Real> &ql,
+                       ScratchPad2D<Real> &qr)
+{
+    const int nu = q.GetDim(4) - 1;
+    constexpr int lshift = (dir == X1DIR) ? 1 : 0;
+    constexpr int di = (dir == X1DIR), dj = (dir == X2DIR), dk = (dir == X3DIR);
+    for (int p = 0; p <= nu; ++p) {
+        if (!var_allocated(q, p)) continue;
+        parthenon::par_for_inner(member, il, iu,
+            KOKKOS_LAMBDA (const int& i) {
+                Real lout, rout;
+                stencil5<Recon>(q(p, k - 2*dk, j - 2*dj, i - 2*di),
+                                q(p, k - dk, j - dj, i - di),
+                                q(p, k, j, i),
+                                q(p, k + dk, j + dj, i + di),
+                                q(p, k + 2*dk, j + 2*dj, i + 2*di), lout, rout);
+                if (do_l) ql(p, i + lshift) = rout;
+                if (do_r) qr(p, i) = lout;
+            }
+        );
+    }
+}
+
+/**
+ * Whether a reconstruction has a single-face version, see reconstruct_face.
+ * The lowered-order WENO variants pick their order by position in the domain, and are left out
+ */
+KOKKOS_INLINE_FUNCTION constexpr bool has_face_recon(const Type recon)
+{
+    return recon == Type::donor_cell || recon == Type::linear_mc || recon == Type::weno5_batched || is_stencil5(recon);
+}
+
+/**
+ * Reconstruct both sides of the single face at (k, j, i), between zones i-1 and i along dir,
+ * reading P and writing ql/qr straight from/to global memory.  Used by the flattened kernels in GetFlux.
+ * ql, qr are indexed like the Flux.Pl/Pr fields.  Faces whose stencil would reach past the block edge
+ * (all outside those any flux is computed from) are given donor-cell values instead.
+ */
+template <Type Recon, int dir>
+KOKKOS_INLINE_FUNCTION void reconstruct_face(const VariablePack<Real>& P, const int& k, const int& j, const int& i,
+                                             const VariablePack<Real>& ql, const VariablePack<Real>& qr)
+{
+    constexpr int di = (dir == X1DIR), dj = (dir == X2DIR), dk = (dir == X3DIR);
+    // Zones used on each side of the face
+    constexpr int reach = (Recon == Type::donor_cell) ? 0 : (Recon == Type::linear_mc) ? 1 : 2;
+    const int x = (dir == X1DIR) ? i : ((dir == X2DIR) ? j : k);
+    const bool fits = x - 1 - reach >= 0 && x + reach <= P.GetDim(dir) - 1;
+    const int nu = P.GetDim(4) - 1;
+    for (int p = 0; p <= nu; ++p) {
+        if (!var_allocated(P, p)) continue;
+        const Real qm = P(p, k - dk, j - dj, i - di), q0 = P(p, k, j, i);
+        if (!fits) {
+            ql(p, k, j, i) = qm;
+            qr(p, k, j, i) = q0;
+        } else if constexpr (Recon == Type::donor_cell) {
+            ql(p, k, j, i) = qm;
+            qr(p, k, j, i) = q0;
+        } else if constexpr (Recon == Type::linear_mc) {
+            const Real qmm = P(p, k - 2*dk, j - 2*dj, i - 2*di), qp = P(p, k + dk, j + dj, i + di);
+            ql(p, k, j, i) = qm + 0.5*mc(qm - qmm, q0 - qm)*(q0 - qm);
+            qr(p, k, j, i) = q0 - 0.5*mc(q0 - qm, qp - q0)*(qp - q0);
+        } else {
+            // The batched WENO5 computes the same stencil as weno5
+            constexpr Type S = (Recon == Type::weno5_batched) ? Type::weno5 : Recon;
+            const Real qmmm = P(p, k - 3*dk, j - 3*dj, i - 3*di), qmm = P(p, k - 2*dk, j - 2*dj, i - 2*di);
+            const Real qp = P(p, k + dk, j + dj, i + di), qpp = P(p, k + 2*dk, j + 2*dj, i + 2*di);
+            Real lout, rout;
+            // Left state from the upper side of zone i-1, right state from the lower side of zone i
+            stencil5<S>(qmmm, qmm, qm, q0, qp, lout, rout);
+            ql(p, k, j, i) = rout;
+            stencil5<S>(qmm, qm, q0, qp, qpp, lout, rout);
+            qr(p, k, j, i) = lout;
+        }
+    }
+}
+
 /**
  * Templated calls to different reconstruction algorithms
  * This is basically a compile-time 'if' or 'switch' statement, where all the options get generated
@@ -616,6 +934,114 @@ KOKKOS_INLINE_FUNCTION void reconstruct<Type::weno5, X3DIR>(parthenon::team_mbr_
     KReconstruction::WENO5X3l(member, k - 1, j, is_l, ie_l, P, ql);
     KReconstruction::WENO5X3r(member, k, j, is_l, ie_l, P, qr);
 }
+// WENO5, batched over zones for vectorization
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<Type::weno5_batched, X1DIR>(parthenon::team_mbr_t& member,
+                                        const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+{
+    KReconstruction::WENO5Batched<X1DIR, true, true>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<Type::weno5_batched, X2DIR>(parthenon::team_mbr_t& member,
+                                        const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+{
+    KReconstruction::WENO5Batched<X2DIR, true, false>(member, k, j - 1, is_l, ie_l, P, ql, qr);
+    KReconstruction::WENO5Batched<X2DIR, false, true>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<Type::weno5_batched, X3DIR>(parthenon::team_mbr_t& member,
+                                        const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+{
+    KReconstruction::WENO5Batched<X3DIR, true, false>(member, k - 1, j, is_l, ie_l, P, ql, qr);
+    KReconstruction::WENO5Batched<X3DIR, false, true>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+// PPM
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<Type::ppm, X1DIR>(parthenon::team_mbr_t& member,
+                                        const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+{
+    KReconstruction::Stencil5Row<Type::ppm, X1DIR, true, true>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<Type::ppm, X2DIR>(parthenon::team_mbr_t& member,
+                                        const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+{
+    KReconstruction::Stencil5Row<Type::ppm, X2DIR, true, false>(member, k, j - 1, is_l, ie_l, P, ql, qr);
+    KReconstruction::Stencil5Row<Type::ppm, X2DIR, false, true>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<Type::ppm, X3DIR>(parthenon::team_mbr_t& member,
+                                        const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+{
+    KReconstruction::Stencil5Row<Type::ppm, X3DIR, true, false>(member, k - 1, j, is_l, ie_l, P, ql, qr);
+    KReconstruction::Stencil5Row<Type::ppm, X3DIR, false, true>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+// MP5
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<Type::mp5, X1DIR>(parthenon::team_mbr_t& member,
+                                        const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+{
+    KReconstruction::Stencil5Row<Type::mp5, X1DIR, true, true>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<Type::mp5, X2DIR>(parthenon::team_mbr_t& member,
+                                        const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+{
+    KReconstruction::Stencil5Row<Type::mp5, X2DIR, true, false>(member, k, j - 1, is_l, ie_l, P, ql, qr);
+    KReconstruction::Stencil5Row<Type::mp5, X2DIR, false, true>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<Type::mp5, X3DIR>(parthenon::team_mbr_t& member,
+                                        const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+{
+    KReconstruction::Stencil5Row<Type::mp5, X3DIR, true, false>(member, k - 1, j, is_l, ie_l, P, ql, qr);
+    KReconstruction::Stencil5Row<Type::mp5, X3DIR, false, true>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+// WENO-Z
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<Type::weno5z, X1DIR>(parthenon::team_mbr_t& member,
+                                        const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+{
+    KReconstruction::Stencil5Row<Type::weno5z, X1DIR, true, true>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<Type::weno5z, X2DIR>(parthenon::team_mbr_t& member,
+                                        const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+{
+    KReconstruction::Stencil5Row<Type::weno5z, X2DIR, true, false>(member, k, j - 1, is_l, ie_l, P, ql, qr);
+    KReconstruction::Stencil5Row<Type::weno5z, X2DIR, false, true>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<Type::weno5z, X3DIR>(parthenon::team_mbr_t& member,
+                                        const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+{
+    KReconstruction::Stencil5Row<Type::weno5z, X3DIR, true, false>(member, k - 1, j, is_l, ie_l, P, ql, qr);
+    KReconstruction::Stencil5Row<Type::weno5z, X3DIR, false, true>(member, k, j, is_l, ie_l, P, ql, qr);
+}
 // WENO5 lowered edges:
 // Linear X1 reconstruction near X1 boundaries
 template <>
@@ -41,11 +41,13 @@
 
 #include "boundaries.hpp"
 #include "current.hpp"
+#include "domain.hpp"
 #include "floors.hpp"
 #include "flux.hpp"
 #include "gr_coordinates.hpp"
 #include "grmhd_functions.hpp"
 #include "kharma.hpp"
+#include "kharma_config.hpp"
 #include "kharma_driver.hpp"
 
 #include <memory>
@@ -102,18 +104,82 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
     bool use_dt_light_phase_speed = pin->GetOrAddBoolean("parthenon/time", "use_dt_light_phase_speed", false);
     params.Add("use_dt_light_phase_speed", use_dt_light_phase_speed);
 
+    // Polar timestep relief: average the conserved variables over groups of zones in X3,
+    // in the pole_average_zones rows nearest each pole.  Groups are 2^(pole_average_zones - d)
+    // zones wide in row d (counting from 0 at the pole), so the effective zone width, and
+    // therefore the timestep, no longer shrinks toward the axis.  See AveragePoles
+    int pole_average_zones = pin->GetOrAddInteger("GRMHD", "pole_average_zones", 0);
+    if (pole_average_zones < 0)
+        throw std::invalid_argument("GRMHD/pole_average_zones must be non-negative!");
+    if (pole_average_zones > 0) {
+        if (!pin->GetBoolean("coordinates", "spherical"))
+            throw std::invalid_argument("Polar averaging requires spherical coordinates!");
+        if (packages->Get("Driver")->Param<DriverType>("type") != DriverType::kharma)
+            throw std::invalid_argument("Polar averaging is only implemented for the kharma driver!");
+    }
+    params.Add("pole_average_zones", pole_average_zones);
+
+    // Every this many steps, report the CFL timestep of each refinement level & the speedup
+    // which ideal subcycling by level could give.  Off (0) by default, as it costs an extra reduction
+    int report_level_dt = pin->GetOrAddInteger("GRMHD", "report_level_dt", 0);
+    params.Add("report_level_dt", report_level_dt);
+    params.Add("block_ndt", Allocations::PersistentArray<Real>("block_ndt"), true);
+
+    // Every parthenon/time/ncycle_out steps, report where the zone which limited the step is.
+    // Only those steps use the (slightly slower) reduction with location
+    bool report_dt_zone = pin->GetOrAddBoolean("GRMHD", "report_dt_zone", false);
+    params.Add("report_dt_zone", report_dt_zone);
+    const int dt_zone_ncycle = m::max(pin->GetOrAddInteger("parthenon/time", "ncycle_out", 1), 1);
+    params.Add("dt_zone_ncycle", dt_zone_ncycle);
+    // Whether this step locates its zone, and the best so far over partitions: ndt, gid, r, th, phi
+    params.Add("locate_dt_zone", report_dt_zone && dt_zone_ncycle == 1, true);
+    params.Add("dt_zone", std::vector<Real>{std::numeric_limits<Real>::max(), -1., 0., 0., 0.}, true);
+    params.Add("dt_zone_X", Allocations::PersistentArray<Real>("dt_zone_X"), true);
+
+    // Keep the center four-vectors u^mu, b^mu of every zone, computed once per stage after the
+    // primitives are final (see FillFourVectors), for the geometric source and reductions.  Costs 16 cell fields
+    bool cache_4vecs = pin->GetOrAddBoolean("GRMHD", "cache_4vecs", false);
+    if (cache_4vecs) {
+        if (packages->Get("Driver")->Param<DriverType>("type") != DriverType::kharma)
+            throw std::invalid_argument("Caching four-vectors is only implemented for the kharma driver!");
+        if (pin->GetOrAddString("parthenon/mesh", "refinement", "none") != "none")
+            throw std::invalid_argument("Caching four-vectors is not supported with mesh refinement!");
+    }
+    params.Add("cache_4vecs", cache_4vecs);
+    params.Add("level_dt_steps", 0, true);
+
     // IMPLICIT PARAMETERS
     // The ImEx driver is necessary to evolve implicitly, but doesn't require it.  Using explicit
     // updates for GRMHD vars is useful for testing, or if adding just a couple of implicit variables
-    // Doing EGRMHD requires implicit evolution of GRMHD variables, of course
+    // EGRMHD defaults to implicit evolution of the GRMHD variables too.  If only the EMHD scalars
+    // are stiff, GRMHD/implicit=false evolves the fluid explicitly and solves just for q/dP
     auto& driver = packages->Get("Driver")->AllParams();
     auto implicit_grmhd = (driver.Get<DriverType>("type") == DriverType::imex) &&
-                          (pin->GetBoolean("emhd", "on") || pin->GetOrAddBoolean("GRMHD", "implicit", false));
+                          pin->GetOrAddBoolean("GRMHD", "implicit", pin->GetBoolean("emhd", "on") &&
+                                               !pin->GetOrAddBoolean("emhd", "subcycle", false));
     params.Add("implicit", implicit_grmhd);
 
     // AMR PARAMETERS
     // Adaptive mesh refinement options
     // Only active if "refinement" and "numlevel" parameters allow
+    // Per-block indicator compared against the tolerances, see GRMHD::CheckRefinement:
+    // rho_range: max - min of rho over the block
+    // rho_gradient, bsq_gradient: max normalized difference |q_i+1 - q_i| / (|q_i+1| + |q_i|) of rho or b^2
+    // current_sheet: max normalized difference of the primitive B vector between neighbors, ~2 in a reversal
+    std::vector<std::string> allowed_criteria = {"rho_range", "rho_gradient", "bsq_gradient", "current_sheet"};
+    std::string refine_criterion = pin->GetOrAddString("GRMHD", "refine_criterion", "rho_range", allowed_criteria);
+    if (refine_criterion == "rho_range") {
+        params.Add("refine_criterion", RefineCriterion::rho_range);
+    } else if (refine_criterion == "rho_gradient") {
+        params.Add("refine_criterion", RefineCriterion::rho_gradient);
+    } else if (refine_criterion == "bsq_gradient") {
+        params.Add("refine_criterion", RefineCriterion::bsq_gradient);
+    } else {
+        params.Add("refine_criterion", RefineCriterion::current_sheet);
+    }
+    if ((refine_criterion == "bsq_gradient" || refine_criterion == "current_sheet") &&
+        pin->GetString("b_field", "solver") == "none")
+        throw std::invalid_argument("GRMHD/refine_criterion "+refine_criterion+" requires a magnetic field!");
     Real refine_tol = pin->GetOrAddReal("GRMHD", "refine_tol", 0.5);
     params.Add("refine_tol", refine_tol);
     Real derefine_tol = pin->GetOrAddReal("GRMHD", "derefine_tol", 0.05);
@@ -175,6 +241,11 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
     // No magnetic fields here. KHARMA should operate fine in GRHD without them,
     // so they are allocated only by B field packages.
 
+    if (cache_4vecs) {
+        std::vector<int> s_4vecs({4*GR_DIM});
+        pkg->AddField("fourvecs", Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy}, s_4vecs));
+    }
+
     // A KHARMAPackage also contains quite a few "callbacks," or functions called at
     // specific points in a step if the package is loaded.
     // Generally, see the headers for function descriptions.
@@ -185,7 +256,7 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
     pkg->DomainBoundaryPtoU = Flux::BlockPtoUMHD;
 
     // AMR-related
-    pkg->CheckRefinementBlock    = GRMHD::CheckRefinement;
+    pkg->CheckRefinementMesh     = GRMHD::CheckRefinement;
     pkg->EstimateTimestepBlock   = GRMHD::EstimateTimestep;
     pkg->EstimateTimestepMesh    = GRMHD::MeshEstimateTimestep;
     pkg->PostStepDiagnosticsMesh = GRMHD::PostStepDiagnostics;
@@ -195,6 +266,26 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
     return pkg;
 }
 
+// Radial range which limits the timestep: everything, unless a multizone run has frozen some zones
+inline void ActiveRadii(Packages_t &packages, Real &r_min, Real &r_max)
+{
+    r_min = 0.;
+    r_max = std::numeric_limits<Real>::max();
+    if (packages.AllPackages().count("Multizone")) {
+        const auto& mz_pars = packages.Get("Multizone")->AllParams();
+        r_min = mz_pars.Get<Real>("r_active_min");
+        r_max = mz_pars.Get<Real>("r_active_max");
+    }
+}
+KOKKOS_INLINE_FUNCTION bool InActiveRadii(const GRCoordinates& G, const int& k, const int& j, const int& i,
+                                          const Real& r_min, const Real& r_max)
+{
+    if (r_min <= 0. && r_max == std::numeric_limits<Real>::max()) return true;
+    GReal Xembed[GR_DIM];
+    G.coord_embed(k, j, i, Loci::center, Xembed);
+    return Xembed[1] >= r_min && Xembed[1] <= r_max;
+}
+
 Real EstimateTimestep(MeshBlockData<Real> *rc)
 {
     // Normally the caller would place this flag before calling us, but this is from Parthenon
@@ -210,8 +301,7 @@ Real EstimateTimestep(MeshBlockData<Real> *rc)
     auto& cmin = rc->Get("Flux.cmin").data;
 
     // TODO: move timestep limiters into KHARMADriver::SetGlobalTimestep
-    // TODO: option to keep location (in embedding coords) of zone which sets step.
-    //       (this will likely be very slow, but we should do it anyway)
+    // The location of the zone which sets the step is only found in MeshEstimateTimestep, see GRMHD/report_dt_zone
 
     auto& globals = pmb->packages.Get("Globals")->AllParams();
     const auto& grmhd_pars = pmb->packages.Get("GRMHD")->AllParams();
@@ -246,17 +336,28 @@ Real EstimateTimestep(MeshBlockData<Real> *rc)
         return globals.Get<double>("dt_light");
     }
 
-    ParArray1D<Real> min_loc("min_loc", 3);
+    // Zones near the poles are effectively wider in X3 if they're averaged, see AveragePoles
+    const int pole_zones = grmhd_pars.Get<int>("pole_average_zones");
+    const int nx3 = kb.e - kb.s + 1;
+    const bool inner_pole = pole_zones > 0 && pmb->boundary_flag[BoundaryFace::inner_x2] == BoundaryFlag::user;
+    const bool outer_pole = pole_zones > 0 && pmb->boundary_flag[BoundaryFace::outer_x2] == BoundaryFlag::user;
+
+    // In multizone runs, zones outside the active annulus are frozen and don't limit the step
+    Real r_active_min, r_active_max;
+    ActiveRadii(pmb->packages, r_active_min, r_active_max);
 
-    // TODO version preserving location, with switch to keep this fast one
-    // std::tuple doesn't work device-side, Kokkos::pair is 2D.  pair of pairs?
     Real min_ndt = 0.;
+    // Static estimates for the timing report: read 6 signal speeds & 3 widths, ~20 FLOPs
+    Timers::CountKernel("ndt_min", static_cast<double>(kb.e - kb.s + 1) * (jb.e - jb.s + 1) * (ib.e - ib.s + 1), 9 * sizeof(Real), 20);
     pmb->par_reduce("ndt_min", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA (const int k, const int j, const int i,
                       Real &local_result) {
+            if (!InActiveRadii(G, k, j, i, r_active_min, r_active_max)) return;
+            const int width = m::max((inner_pole) ? pole_average_width(j - jb.s, pole_zones, nx3) : 1,
+                                     (outer_pole) ? pole_average_width(jb.e - j, pole_zones, nx3) : 1);
             double ndt_zone = 1 / (1 / (G.Dxc<1>(i) /  m::max(cmax(0, k, j, i), cmin(0, k, j, i))) +
                                    1 / (G.Dxc<2>(j) /  m::max(cmax(1, k, j, i), cmin(1, k, j, i))) +
-                                   1 / (G.Dxc<3>(k) /  m::max(cmax(2, k, j, i), cmin(2, k, j, i))));
+                                   1 / (width * G.Dxc<3>(k) /  m::max(cmax(2, k, j, i), cmin(2, k, j, i))));
 
             if (!m::isnan(ndt_zone) && (ndt_zone < local_result)) {
                 local_result = ndt_zone;
@@ -266,9 +367,6 @@ Real EstimateTimestep(MeshBlockData<Real> *rc)
     // TODO(BSP) this would need work for non-rectangular grids.
     const double nctop = m::min(G.Dxc<1>(0), m::min(G.Dxc<2>(0), G.Dxc<3>(0))) / min_ndt;
 
-    // TODO print location
-    //std::cout << "New min timestep: " << min_ndt << std::endl;
-
     // Apply limits
     const double cfl = grmhd_pars.Get<double>("cfl");
     const double dt_min = grmhd_pars.Get<double>("dt_min");
@@ -288,6 +386,298 @@ Real EstimateTimestep(MeshBlockData<Real> *rc)
     return ndt;
 }
 
+void ReportLevelTimesteps(MeshData<Real> *md, const Real dt_global)
+{
+    Flag("ReportLevelTimesteps");
+    auto pmesh = md->GetMeshPointer();
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    auto& grmhd_pars = pmb0->packages.Get("GRMHD")->AllParams();
+    const Real cfl = grmhd_pars.Get<double>("cfl");
+    const int nblocks = md->NumBlocks();
+
+    // Minimum CFL timestep of each block, in one kernel
+    const auto& cmax = md->PackVariables(std::vector<std::string>{"Flux.cmax"});
+    const auto& cmin = md->PackVariables(std::vector<std::string>{"Flux.cmin"});
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    const auto block_ndt = grmhd_pars.GetMutable<Allocations::PersistentArray<Real>>("block_ndt")->Get(nblocks);
+    Kokkos::deep_copy(block_ndt, std::numeric_limits<Real>::max());
+    pmb0->par_for("block_ndt", 0, nblocks - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int b, const int k, const int j, const int i) {
+            const auto& G = cmax.GetCoords(b);
+            const double ndt_zone = 1 / (1 / (G.Dxc<1>(i) /  m::max(cmax(b, 0, k, j, i), cmin(b, 0, k, j, i))) +
+                                         1 / (G.Dxc<2>(j) /  m::max(cmax(b, 1, k, j, i), cmin(b, 1, k, j, i))) +
+                                         1 / (G.Dxc<3>(k) /  m::max(cmax(b, 2, k, j, i), cmin(b, 2, k, j, i))));
+            if (!m::isnan(ndt_zone)) Kokkos::atomic_min(&block_ndt(b), ndt_zone);
+        }
+    );
+    auto block_ndt_h = block_ndt.GetHostMirrorAndCopy();
+
+    // Level of each block, from its zone size relative to the base mesh
+    constexpr int max_levels = 16;
+    const int nx1 = pmesh->mesh_size.nx(X1DIR);
+    const GReal dx1_base = (pmesh->mesh_size.xmax(X1DIR) - pmesh->mesh_size.xmin(X1DIR)) / nx1;
+    const int zones_per_block = (ib.e - ib.s + 1) * (jb.e - jb.s + 1) * (kb.e - kb.s + 1);
+    std::vector<Real> level_dt(max_levels, std::numeric_limits<Real>::max()), level_zones(max_levels, 0.);
+    for (int b = 0; b < nblocks; ++b) {
+        const auto& G = md->GetBlockData(b)->GetBlockPointer()->coords;
+        const int level = m::min(m::max((int) std::lround(std::log2(dx1_base / G.Dxc<1>(0))), 0), max_levels - 1);
+        level_dt[level] = m::min(level_dt[level], block_ndt_h(b) * cfl);
+        level_zones[level] += zones_per_block;
+    }
+
+    // Channels 2 & 3 of the vector<Real> pool are otherwise unused
+    Reductions::Start<std::vector<Real>>(md, 2, level_dt, MPI_MIN);
+    Reductions::Start<std::vector<Real>>(md, 3, level_zones, MPI_SUM);
+    level_dt = Reductions::Check<std::vector<Real>>(md, 2);
+    level_zones = Reductions::Check<std::vector<Real>>(md, 3);
+
+    if (MPIRank0()) {
+        // Zone updates per unit time: stepping everything at the global dt, vs. each level at its own
+        Real cost_global = 0., cost_levels = 0.;
+        for (int l = 0; l < max_levels; ++l) {
+            if (level_zones[l] == 0.) continue;
+            std::cout << "Level " << l << ": " << (long) level_zones[l] << " zones, CFL dt " << level_dt[l] << std::endl;
+            cost_global += level_zones[l] / dt_global;
+            cost_levels += level_zones[l] / level_dt[l];
+        }
+        std::cout << "Ideal speedup from subcycling levels: " << cost_global / cost_levels << std::endl;
+    }
+
+    EndFlag();
+}
+
+void ReportTimestepZone(MeshData<Real> *md)
+{
+    auto pmesh = md->GetMeshPointer();
+    auto& grmhd_pars = pmesh->packages.Get("GRMHD")->AllParams();
+    auto& dt_zone = *grmhd_pars.GetMutable<std::vector<Real>>("dt_zone");
+    std::vector<double> zone(dt_zone.begin(), dt_zone.end());
+#ifdef MPI_PARALLEL
+    // Rank with the smallest step, which then broadcasts its zone
+    struct { double val; int rank; } local = {zone[0], MPIRank()}, global;
+    PARTHENON_MPI_CHECK(MPI_Allreduce(&local, &global, 1, MPI_DOUBLE_INT, MPI_MINLOC, MPI_COMM_WORLD));
+    PARTHENON_MPI_CHECK(MPI_Bcast(zone.data(), zone.size(), MPI_DOUBLE, global.rank, MPI_COMM_WORLD));
+#endif
+    if (MPIRank0() && zone[1] >= 0) {
+        const Real cfl = grmhd_pars.Get<double>("cfl");
+        std::cout << "Step " << zone[0] * cfl << " limited by zone at r = " << zone[2] << ", th = " << zone[3]
+                  << ", phi = " << zone[4] << " in block " << (int) zone[1] << std::endl;
+    }
+    dt_zone = {std::numeric_limits<Real>::max(), -1., 0., 0., 0.};
+}
+
+Real MeshEstimateTimestep(MeshData<Real> *md)
+{
+    Flag("MeshEstimateTimestep");
+    auto pmesh = md->GetMeshPointer();
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    auto& globals = pmb0->packages.Get("Globals")->AllParams();
+    const auto& config = KHARMA::GetConfig(pmb0->packages);
+
+    if (!globals.Get<bool>("in_loop") || config.use_dt_light) {
+        Real ndt = std::numeric_limits<Real>::max();
+        for (int i=0; i < md->NumBlocks(); ++i) {
+            double dtb = EstimateTimestep(md->GetBlockData(i).get());
+            if (dtb < ndt) ndt = dtb;
+        }
+        EndFlag();
+        return ndt;
+    }
+
+    const auto& cmax = md->PackVariables(std::vector<std::string>{"Flux.cmax"});
+    const auto& cmin = md->PackVariables(std::vector<std::string>{"Flux.cmin"});
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    const IndexRange block = IndexRange{0, cmax.GetDim(5) - 1};
+
+    // Zones near the poles are effectively wider in X3 if they're averaged, see AveragePoles.
+    // Blocks at a (non-periodic) X2 edge of the mesh hold the poles, which we can find from
+    // their coordinates without a per-block list on device
+    const int pole_zones = config.pole_average_zones;
+    const int nx3 = kb.e - kb.s + 1;
+    const bool any_pole = pole_zones > 0 && !config.x2_periodic;
+    const GReal x2min = pmesh->mesh_size.xmin(X2DIR);
+    const GReal x2max = pmesh->mesh_size.xmax(X2DIR);
+
+    Real r_active_min, r_active_max;
+    ActiveRadii(pmesh->packages, r_active_min, r_active_max);
+
+    // Step allowed by one zone, or NaN if it shouldn't count
+    auto zone_ndt = KOKKOS_LAMBDA (const int b, const int k, const int j, const int i) -> double {
+        const auto& G = cmax.GetCoords(b);
+        if (!InActiveRadii(G, k, j, i, r_active_min, r_active_max)) return NAN;
+        const bool inner_pole = any_pole && G.Xf<2>(jb.s) < x2min + 0.5 * G.Dxc<2>(jb.s);
+        const bool outer_pole = any_pole && G.Xf<2>(jb.e + 1) > x2max - 0.5 * G.Dxc<2>(jb.e);
+        const int width = m::max((inner_pole) ? pole_average_width(j - jb.s, pole_zones, nx3) : 1,
+                                 (outer_pole) ? pole_average_width(jb.e - j, pole_zones, nx3) : 1);
+        return 1 / (1 / (G.Dxc<1>(i) /  m::max(cmax(b, 0, k, j, i), cmin(b, 0, k, j, i))) +
+                    1 / (G.Dxc<2>(j) /  m::max(cmax(b, 1, k, j, i), cmin(b, 1, k, j, i))) +
+                    1 / (width * G.Dxc<3>(k) /  m::max(cmax(b, 2, k, j, i), cmin(b, 2, k, j, i))));
+    };
+
+    Real min_ndt = 0.;
+    Timers::CountKernel("ndt_min", static_cast<double>(block.e - block.s + 1) * (kb.e - kb.s + 1) * (jb.e - jb.s + 1) * (ib.e - ib.s + 1),
+                        9 * sizeof(Real), 20);
+    auto& mutable_pars = pmb0->packages.Get("GRMHD")->AllParams();
+    if (!mutable_pars.Get<bool>("locate_dt_zone")) {
+        pmb0->par_reduce("ndt_min", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA (const int b, const int k, const int j, const int i,
+                          Real &local_result) {
+                const double ndt_zone = zone_ndt(b, k, j, i);
+                if (!m::isnan(ndt_zone) && (ndt_zone < local_result)) {
+                    local_result = ndt_zone;
+                }
+            }
+        , Kokkos::Min<Real>(min_ndt));
+    } else {
+        // Same reduction, keeping the zone as one packed index
+        const int n1 = ib.e - ib.s + 1, n2 = jb.e - jb.s + 1, n3 = kb.e - kb.s + 1;
+        using MinLocNdt = Kokkos::MinLoc<Real, int64_t>;
+        MinLocNdt::value_type min_loc;
+        pmb0->par_reduce("ndt_min_loc", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA (const int b, const int k, const int j, const int i,
+                          MinLocNdt::value_type &local_result) {
+                const double ndt_zone = zone_ndt(b, k, j, i);
+                if (!m::isnan(ndt_zone) && (ndt_zone < local_result.val)) {
+                    local_result.val = ndt_zone;
+                    local_result.loc = (((int64_t) b * n3 + (k - kb.s)) * n2 + (j - jb.s)) * n1 + (i - ib.s);
+                }
+            }
+        , MinLocNdt(min_loc));
+        min_ndt = min_loc.val;
+        auto& dt_zone = *mutable_pars.GetMutable<std::vector<Real>>("dt_zone");
+        if (min_loc.loc >= 0 && min_ndt < dt_zone[0]) {
+            const int64_t loc = min_loc.loc;
+            const int i = ib.s + loc % n1, j = jb.s + (loc / n1) % n2, k = kb.s + (loc / n1 / n2) % n3;
+            const int b = loc / n1 / n2 / n3;
+            // Embedding coordinates from device, as they may be cached there
+            const auto X = mutable_pars.GetMutable<Allocations::PersistentArray<Real>>("dt_zone_X")->Get(GR_DIM);
+            pmb0->par_for("dt_zone_X", 0, 0,
+                KOKKOS_LAMBDA (const int &n) {
+                    GReal Xembed[GR_DIM];
+                    cmax.GetCoords(b).coord_embed(k, j, i, Loci::center, Xembed);
+                    DLOOP1 X(mu) = Xembed[mu];
+                }
+            );
+            auto X_h = X.GetHostMirrorAndCopy();
+            dt_zone = {min_ndt, (Real) md->GetBlockData(b)->GetBlockPointer()->gid, X_h(1), X_h(2), X_h(3)};
+        }
+    }
+
+    // Apply limits
+    const double cfl = config.cfl;
+    const double dt_last = globals.Get<double>("dt_last");
+    const double ndt = clip(min_ndt * cfl, config.dt_min, config.max_dt_increase * dt_last);
+
+    const int report_level_dt = config.report_level_dt;
+    if (report_level_dt > 0) {
+        const int steps = mutable_pars.Get<int>("level_dt_steps");
+        mutable_pars.Update<int>("level_dt_steps", steps + 1);
+        if (steps % report_level_dt == 0) ReportLevelTimesteps(md, min_ndt * cfl);
+    }
+
+    // Record max ctop, for constraint damping.  Smallest zone dimension of any block, as in EstimateTimestep
+    if (config.use_b_cd) {
+        double min_dx = std::numeric_limits<double>::max();
+        for (int b=0; b < md->NumBlocks(); ++b) {
+            const auto& G = md->GetBlockData(b)->GetBlockPointer()->coords;
+            min_dx = m::min(min_dx, m::min(G.Dxc<1>(0), m::min(G.Dxc<2>(0), G.Dxc<3>(0))));
+        }
+        const double nctop = min_dx / min_ndt;
+        auto& b_cd_params = pmb0->packages.Get("B_CD")->AllParams();
+        if (nctop > b_cd_params.Get<Real>("ctop_max"))
+            b_cd_params.Update<Real>("ctop_max", nctop);
+    }
+
+    EndFlag();
+    return ndt;
+}
+
+TaskStatus AveragePoles(MeshData<Real> *md)
+{
+    Flag("AveragePoles");
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const int pole_zones = pmb0->packages.Get("GRMHD")->Param<int>("pole_average_zones");
+    if (pole_zones == 0 || md->GetMeshPointer()->ndim < 3) {
+        EndFlag();
+        return TaskStatus::complete;
+    }
+
+    // Everything but the magnetic field: averaging B in X3 would break divB
+    PackIndexMap cons_map;
+    auto U = md->PackVariables(std::vector<MetadataFlag>{Metadata::Conserved, Metadata::Cell}, cons_map);
+    const VarMap m_u(cons_map, true);
+    const int nvar = U.GetDim(4);
+
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    const IndexRange block = IndexRange{0, U.GetDim(5)-1};
+    const int nx3 = kb.e - kb.s + 1;
+    // Rows averaged from each pole, never overlapping if a block touches both
+    const int nrows = m::min(pole_zones, (jb.e - jb.s + 1) / 2);
+
+    // Which blocks touch either pole
+    const int nblocks = md->NumBlocks();
+    ParArray2D<int> poles("poles", nblocks, 2);
+    auto poles_h = Kokkos::create_mirror_view(Kokkos::HostSpace(), poles);
+    for (int b=0; b < nblocks; ++b) {
+        auto pmb = md->GetBlockData(b)->GetBlockPointer();
+        poles_h(b, 0) = (pmb->boundary_flag[BoundaryFace::inner_x2] == BoundaryFlag::user);
+        poles_h(b, 1) = (pmb->boundary_flag[BoundaryFace::outer_x2] == BoundaryFlag::user);
+    }
+    Kokkos::deep_copy(poles, poles_h);
+
+    // One thread per group: conserved variables are densitized by gdet, which doesn't
+    // depend on X3, so a plain average conserves their totals exactly
+    pmb0->par_for("average_poles", block.s, block.e, 0, 1, 0, nrows - 1, kb.s, kb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int& b, const int& side, const int& d, const int& k, const int& i) {
+            const int width = pole_average_width(d, pole_zones, nx3);
+            if (!poles(b, side) || width == 1 || (k - kb.s) % width != 0) return;
+            const int j = (side == 0) ? jb.s + d : jb.e - d;
+            for (int v=0; v < nvar; ++v) {
+                if (m_u.B1 >= 0 && v >= m_u.B1 && v < m_u.B1 + NVEC) continue;
+                if (!U.IsAllocated(b, v)) continue;
+                Real sum = 0.;
+                for (int kk = k; kk < k + width; ++kk) sum += U(b, v, kk, j, i);
+                for (int kk = k; kk < k + width; ++kk) U(b, v, kk, j, i) = sum / width;
+            }
+        }
+    );
+
+    EndFlag();
+    return TaskStatus::complete;
+}
+
+TaskStatus FillFourVectors(MeshData<Real> *md)
+{
+    auto D_cache = md->PackVariables(std::vector<std::string>{"fourvecs"});
+    if (D_cache.GetDim(4) == 0) return TaskStatus::complete;
+
+    Flag("FillFourVectors");
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    PackIndexMap prims_map;
+    auto P = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    const VarMap m_p(prims_map, false);
+
+    const IndexRange3 b = KDomain::GetRange(md, IndexDomain::entire);
+    const IndexRange block = IndexRange{0, P.GetDim(5)-1};
+    pmb0->par_for("fill_fourvecs", block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        KOKKOS_LAMBDA (const int& bl, const int &k, const int &j, const int &i) {
+            const auto& G = P.GetCoords(bl);
+            FourVectors D;
+            calc_4vecs(G, P(bl), m_p, k, j, i, Loci::center, D);
+            store_4vecs(D_cache(bl), k, j, i, D);
+        }
+    );
+
+    EndFlag();
+    return TaskStatus::complete;
+}
+
 Real EstimateRadiativeTimestep(MeshBlockData<Real> *rc)
 {
     Flag("EstimateRadiativeTimestep");
@@ -354,34 +744,119 @@ Real EstimateRadiativeTimestep(MeshBlockData<Real> *rc)
     return ndt;
 }
 
-AmrTag CheckRefinement(MeshBlockData<Real> *rc)
+template<RefineCriterion criterion>
+void CheckRefinementImpl(MeshData<Real> *md, parthenon::ParArray1D<AmrTag> &amr_tags)
 {
-    auto pmb = rc->GetBlockPointer();
-    auto v = rc->Get("prims.rho").data;
-
-    IndexDomain domain = IndexDomain::interior;
-    IndexRange ib = pmb->cellbounds.GetBoundsI(domain);
-    IndexRange jb = pmb->cellbounds.GetBoundsJ(domain);
-    IndexRange kb = pmb->cellbounds.GetBoundsK(domain);
-
-    typename Kokkos::MinMax<Real>::value_type minmax;
-    pmb->par_reduce("check_refinement", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-        KOKKOS_LAMBDA(const int k, const int j, const int i,
-                      typename Kokkos::MinMax<Real>::value_type &lminmax) {
-        lminmax.min_val =
-            v(k, j, i) < lminmax.min_val ? v(k, j, i) : lminmax.min_val;
-        lminmax.max_val =
-            v(k, j, i) > lminmax.max_val ? v(k, j, i) : lminmax.max_val;
+    auto pmesh = md->GetMeshPointer();
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const int ndim = pmesh->ndim;
+
+    PackIndexMap prims_map;
+    auto P = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    const VarMap m_p(prims_map, false);
+
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    const int ni = ib.e - ib.s + 1, nj = jb.e - jb.s + 1, nk = kb.e - kb.s + 1;
+    const IndexRange block = IndexRange{0, P.GetDim(5) - 1};
+
+    const auto& pars = pmesh->packages.Get("GRMHD")->AllParams();
+    const Real refine_tol   = pars.Get<Real>("refine_tol");
+    const Real derefine_tol = pars.Get<Real>("derefine_tol");
+
+    // One team per block, reducing its indicator over all interior zones
+    parthenon::par_for_outer(DEFAULT_OUTER_LOOP_PATTERN, "check_refinement", pmb0->exec_space, 0, 0,
+        block.s, block.e,
+        KOKKOS_LAMBDA(parthenon::team_mbr_t member, const int& b) {
+            const auto& G = P.GetCoords(b);
+            // Normalized difference of a zone-centered quantity q(k, j, i) with its upper neighbors
+            auto norm_diff = [&](auto q, const int& k, const int& j, const int& i) {
+                const Real q0 = q(k, j, i);
+                Real dmax = m::abs(q(k, j, i+1) - q0) / (m::abs(q(k, j, i+1)) + m::abs(q0) + SMALL);
+                if (ndim > 1) dmax = m::max(dmax, m::abs(q(k, j+1, i) - q0) / (m::abs(q(k, j+1, i)) + m::abs(q0) + SMALL));
+                if (ndim > 2) dmax = m::max(dmax, m::abs(q(k+1, j, i) - q0) / (m::abs(q(k+1, j, i)) + m::abs(q0) + SMALL));
+                return dmax;
+            };
+            Real indicator = 0.;
+            if constexpr (criterion == RefineCriterion::rho_range) {
+                Real rho_max = 0., rho_min = 0.;
+                Kokkos::parallel_reduce(Kokkos::TeamThreadRange(member, nk*nj*ni),
+                    [&](const int& idx, Real& lmax) {
+                        const int k = kb.s + idx / (nj*ni), j = jb.s + (idx / ni) % nj, i = ib.s + idx % ni;
+                        lmax = m::max(lmax, P(b, m_p.RHO, k, j, i));
+                    }
+                , Kokkos::Max<Real>(rho_max));
+                Kokkos::parallel_reduce(Kokkos::TeamThreadRange(member, nk*nj*ni),
+                    [&](const int& idx, Real& lmin) {
+                        const int k = kb.s + idx / (nj*ni), j = jb.s + (idx / ni) % nj, i = ib.s + idx % ni;
+                        lmin = m::min(lmin, P(b, m_p.RHO, k, j, i));
+                    }
+                , Kokkos::Min<Real>(rho_min));
+                indicator = rho_max - rho_min;
+            } else {
+                Kokkos::parallel_reduce(Kokkos::TeamThreadRange(member, nk*nj*ni),
+                    [&](const int& idx, Real& lmax) {
+                        const int k = kb.s + idx / (nj*ni), j = jb.s + (idx / ni) % nj, i = ib.s + idx % ni;
+                        Real dmax = 0.;
+                        if constexpr (criterion == RefineCriterion::rho_gradient) {
+                            dmax = norm_diff([&](const int& kk, const int& jj, const int& ii) {
+                                return P(b, m_p.RHO, kk, jj, ii);
+                            }, k, j, i);
+                        } else if constexpr (criterion == RefineCriterion::bsq_gradient) {
+                            dmax = norm_diff([&](const int& kk, const int& jj, const int& ii) {
+                                FourVectors Dtmp;
+                                GRMHD::calc_4vecs(G, P(b), m_p, kk, jj, ii, Loci::center, Dtmp);
+                                return dot(Dtmp.bcon, Dtmp.bcov);
+                            }, k, j, i);
+                        } else {
+                            // Sum over components, so that a reversal of the dominant component scores ~2
+                            // regardless of the field's magnitude
+                            auto bdiff = [&](const int& kk, const int& jj, const int& ii) {
+                                Real diff = 0., norm = SMALL;
+                                VLOOP {
+                                    diff += m::abs(P(b, m_p.B1 + v, kk, jj, ii) - P(b, m_p.B1 + v, k, j, i));
+                                    norm += m::abs(P(b, m_p.B1 + v, kk, jj, ii)) + m::abs(P(b, m_p.B1 + v, k, j, i));
+                                }
+                                return 2. * diff / norm;
+                            };
+                            dmax = bdiff(k, j, i+1);
+                            if (ndim > 1) dmax = m::max(dmax, bdiff(k, j+1, i));
+                            if (ndim > 2) dmax = m::max(dmax, bdiff(k+1, j, i));
+                        }
+                        lmax = m::max(lmax, dmax);
+                    }
+                , Kokkos::Max<Real>(indicator));
+            }
+            Kokkos::single(Kokkos::PerTeam(member), [&]() {
+                const AmrTag tag = (indicator > refine_tol) ? AmrTag::refine :
+                                   (indicator < derefine_tol) ? AmrTag::derefine : AmrTag::same;
+                // Combine with other packages' & Parthenon's own criteria, which may have asked for more
+                if (tag > amr_tags(b)) amr_tags(b) = tag;
+            });
         }
-    , Kokkos::MinMax<Real>(minmax));
-
-    auto pkg = pmb->packages.Get("GRMHD");
-    const auto &refine_tol   = pkg->Param<Real>("refine_tol");
-    const auto &derefine_tol = pkg->Param<Real>("derefine_tol");
+    );
+}
 
-    if (minmax.max_val - minmax.min_val > refine_tol) return AmrTag::refine;
-    if (minmax.max_val - minmax.min_val < derefine_tol) return AmrTag::derefine;
-    return AmrTag::same;
+void CheckRefinement(MeshData<Real> *md, parthenon::ParArray1D<AmrTag> &amr_tags)
+{
+    Flag("CheckRefinement");
+    const auto& pars = md->GetMeshPointer()->packages.Get("GRMHD")->AllParams();
+    switch (pars.Get<RefineCriterion>("refine_criterion")) {
+    case RefineCriterion::rho_range:
+        CheckRefinementImpl<RefineCriterion::rho_range>(md, amr_tags);
+        break;
+    case RefineCriterion::rho_gradient:
+        CheckRefinementImpl<RefineCriterion::rho_gradient>(md, amr_tags);
+        break;
+    case RefineCriterion::bsq_gradient:
+        CheckRefinementImpl<RefineCriterion::bsq_gradient>(md, amr_tags);
+        break;
+    case RefineCriterion::current_sheet:
+        CheckRefinementImpl<RefineCriterion::current_sheet>(md, amr_tags);
+        break;
+    }
+    EndFlag();
 }
 
 TaskStatus PostStepDiagnostics(const SimTime& tm, MeshData<Real> *md)
@@ -415,6 +890,35 @@ TaskStatus PostStepDiagnostics(const SimTime& tm, MeshData<Real> *md)
         }
     }
 
+    // Location of the zone which limited this step, if we looked for it
+    auto& grmhd_pars = pmesh->packages.Get("GRMHD")->AllParams();
+    if (grmhd_pars.Get<bool>("locate_dt_zone")) {
+        ReportTimestepZone(md);
+    }
+    if (grmhd_pars.Get<bool>("report_dt_zone")) {
+        // tm.ncycle is incremented after this call, so the next step is tm.ncycle + 1
+        grmhd_pars.Update<bool>("locate_dt_zone", (tm.ncycle + 2) % grmhd_pars.Get<int>("dt_zone_ncycle") == 0);
+    }
+
+    // Sampled checks: results are from the previous step, so that MPI needn't hold up this one.
+    // Throws on all ranks together, as the counts are reduced to all
+    const int sampled_checks = pars.Get<int>("sampled_checks");
+    if (sampled_checks > 0) {
+        const auto counts = Reductions::SampledChecks(md, sampled_checks, tm.ncycle);
+        std::vector<int> last;
+        if (Reductions::LaggedSumToAll(md, 0, counts, last)) {
+            const int nnan = last[0], nneg_rho = last[1], nneg_u = last[2], nbad_ctop = last[3];
+            if (MPIRank0() && (nneg_rho > 0 || nneg_u > 0)) {
+                std::cout << "Number of negative primitive rho, u (sampled): " << nneg_rho << "," << nneg_u << std::endl;
+            }
+            if (nnan > 0 || nbad_ctop > 0) {
+                if (MPIRank0())
+                    fprintf(stderr, "Sampled checks found %d zones with NaN primitives, %d with ctop of 0 or NaN\n", nnan, nbad_ctop);
+                throw std::runtime_error("Bad state found by sampled checks!");
+            }
+        }
+    }
+
     return TaskStatus::complete;
 }
 
@@ -44,6 +44,10 @@
  * Many device-side functions related to GRMHD are implemented in grmhd_functions.hpp
  */
 namespace GRMHD {
+
+// Indicators for tagging blocks to refine, see GRMHD/refine_criterion
+enum class RefineCriterion{rho_range, rho_gradient, bsq_gradient, current_sheet};
+
 // For declaring variables, as well as the full intermediates we need (right & left fluxes etc)
 std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages);
 
@@ -55,27 +59,62 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
  * Parthenon will take the minimum and put it in pmy_mesh->dt
  */
 Real EstimateTimestep(MeshBlockData<Real> *rc);
-inline Real MeshEstimateTimestep(MeshData<Real> *md)
+/**
+ * As EstimateTimestep, over all blocks of the MeshData in a single reduction.
+ * Startup and light-crossing estimates still go block by block, as they're rare.
+ */
+Real MeshEstimateTimestep(MeshData<Real> *md);
+
+/**
+ * Print the CFL timestep of each refinement level, and the speedup that ideal subcycling
+ * would give over stepping the whole mesh at dt_global.  See GRMHD/report_level_dt
+ */
+void ReportLevelTimesteps(MeshData<Real> *md, const Real dt_global);
+
+/**
+ * Print the embedding coordinates & block of the zone which limited the last step, as found by
+ * MeshEstimateTimestep on steps with locate_dt_zone.  See GRMHD/report_dt_zone
+ */
+void ReportTimestepZone(MeshData<Real> *md);
+
+/**
+ * Width in zones of the groups averaged over X3 in row d from a pole (d=0 adjacent),
+ * when averaging the first pole_zones rows.  Halves each row away from the pole,
+ * and always divides the number of zones nx3 in a block so groups stay within blocks.
+ */
+KOKKOS_INLINE_FUNCTION int pole_average_width(const int d, const int pole_zones, const int nx3)
 {
-    Flag("MeshEstimateTimestep");
-    Real ndt = std::numeric_limits<Real>::max();
-    for (int i=0; i < md->NumBlocks(); ++i) {
-        double dtb = EstimateTimestep(md->GetBlockData(i).get());
-        if (dtb < ndt) ndt = dtb;
-    }
-    EndFlag();
-    return ndt;
+    if (d < 0 || d >= pole_zones) return 1;
+    int width = 1 << (pole_zones - d);
+    while (nx3 % width != 0) width /= 2;
+    return width;
 }
 
+/**
+ * Average the conserved variables (except B) over groups of zones in X3
+ * in the GRMHD/pole_average_zones rows nearest each polar boundary.
+ * Together with the wider effective zones in EstimateTimestep, this keeps
+ * the polar zones from limiting the global timestep.
+ */
+TaskStatus AveragePoles(MeshData<Real> *md);
+
+/**
+ * Fill the "fourvecs" cache with the center four-vectors from the current primitives,
+ * if GRMHD/cache_4vecs is set.  Called at the end of each stage, after the last change to P,
+ * so that the next stage's sources and any reductions read the four-vectors of the same P.
+ */
+TaskStatus FillFourVectors(MeshData<Real> *md);
+
 // Internal version for the light phase speed crossing time of smallest zone
 Real EstimateRadiativeTimestep(MeshBlockData<Real> *rc);
 
 /**
- * Return a tag per-block indicating whether to refine it
- * 
- * Criteria are very WIP
+ * Tag every block in md for refinement at once, in a single launch with one team per block.
+ * The per-block indicator is chosen by GRMHD/refine_criterion, and compared against
+ * GRMHD/refine_tol and GRMHD/derefine_tol.  Tags are only ever raised, as other criteria
+ * may already have asked for refinement.
  */
-AmrTag CheckRefinement(MeshBlockData<Real> *rc);
+void CheckRefinement(MeshData<Real> *md, parthenon::ParArray1D<AmrTag> &amr_tags);
 
 /**
  * Fill fields which are calculated only for output to file
@@ -105,8 +105,9 @@ KOKKOS_INLINE_FUNCTION Real lorentz_calc(const GRCoordinates& G, const Real uv[N
 
     return m::sqrt(1. + qsq);
 }
-// Versions for full primitives array
-KOKKOS_INLINE_FUNCTION Real lorentz_calc(const GRCoordinates& G, const VariablePack<Real>& P, const VarMap& m,
+// Versions for full primitives array.  Map is a VarMap or StaticVarMap
+template<typename Map>
+KOKKOS_INLINE_FUNCTION Real lorentz_calc(const GRCoordinates& G, const VariablePack<Real>& P, const Map& m,
                                          const int& k, const int& j, const int& i, const Loci& loc=Loci::center)
 {
     const Real qsq = G.gcov(loc, j, i, 1, 1) * P(m.U1, k, j, i) * P(m.U1, k, j, i) +
@@ -118,8 +119,8 @@ KOKKOS_INLINE_FUNCTION Real lorentz_calc(const GRCoordinates& G, const VariableP
 
     return m::sqrt(1. + qsq);
 }
-template <typename Local>
-KOKKOS_INLINE_FUNCTION Real lorentz_calc(const GRCoordinates& G, const Local& P, const VarMap& m,
+template <typename Geom, typename Local>
+KOKKOS_INLINE_FUNCTION Real lorentz_calc(const Geom& G, const Local& P, const VarMap& m,
                                          const int& j, const int& i, const Loci& loc=Loci::center)
 {
     const Real qsq = G.gcov(loc, j, i, 1, 1) * P(m.U1) * P(m.U1) +
@@ -201,7 +202,8 @@ KOKKOS_INLINE_FUNCTION void calc_4vecs(const GRCoordinates& G, const GridVector
     G.lower(D.bcon, D.bcov, k, j, i, loc);
 }
 // Primitive/VarMap versions of calc_4vecs for kernels that use "packed" primitives
-KOKKOS_INLINE_FUNCTION void calc_4vecs(const GRCoordinates& G, const VariablePack<Real>& P, const VarMap& m,
+template<typename Map>
+KOKKOS_INLINE_FUNCTION void calc_4vecs(const GRCoordinates& G, const VariablePack<Real>& P, const Map& m,
                                       const int& k, const int& j, const int& i, const Loci loc, FourVectors& D)
 {
     const Real gamma = lorentz_calc(G, P, m, k, j, i, loc);
@@ -222,8 +224,9 @@ KOKKOS_INLINE_FUNCTION void calc_4vecs(const GRCoordinates& G, const VariablePac
         DLOOP1 D.bcon[mu] = D.bcov[mu] = 0.;
     }
 }
-template <typename Local>
-KOKKOS_INLINE_FUNCTION void calc_4vecs(const GRCoordinates& G, const Local& P, const VarMap& m,
+// Also accepts a FaceGeom in place of G, see gr_coordinates.hpp
+template <typename Geom, typename Local>
+KOKKOS_INLINE_FUNCTION void calc_4vecs(const Geom& G, const Local& P, const VarMap& m,
                                       const int& j, const int& i, const Loci loc, FourVectors& D)
 {
     const Real gamma = lorentz_calc(G, P, m, j, i, loc);
@@ -244,6 +247,30 @@ KOKKOS_INLINE_FUNCTION void calc_4vecs(const GRCoordinates& G, const Local& P, c
         DLOOP1 D.bcon[mu] = D.bcov[mu] = 0.;
     }
 }
+/**
+ * Store & load the center four-vectors of a zone in the "fourvecs" cache, see GRMHD::FillFourVectors.
+ * The cache holds ucon, ucov, bcon, bcov in that order.
+ */
+template<typename Global>
+KOKKOS_INLINE_FUNCTION void store_4vecs(const Global& cache, const int& k, const int& j, const int& i, const FourVectors& D)
+{
+    DLOOP1 {
+        cache(mu, k, j, i)              = D.ucon[mu];
+        cache(GR_DIM + mu, k, j, i)     = D.ucov[mu];
+        cache(2 * GR_DIM + mu, k, j, i) = D.bcon[mu];
+        cache(3 * GR_DIM + mu, k, j, i) = D.bcov[mu];
+    }
+}
+template<typename Global>
+KOKKOS_INLINE_FUNCTION void load_4vecs(const Global& cache, const int& k, const int& j, const int& i, FourVectors& D)
+{
+    DLOOP1 {
+        D.ucon[mu] = cache(mu, k, j, i);
+        D.ucov[mu] = cache(GR_DIM + mu, k, j, i);
+        D.bcon[mu] = cache(2 * GR_DIM + mu, k, j, i);
+        D.bcov[mu] = cache(3 * GR_DIM + mu, k, j, i);
+    }
+}
 /**
  * Just the velocity 4-vector, in the first two styles of calc_4vecs.  For various corners.
  */
@@ -149,3 +149,83 @@ TaskStatus Implicit::FixSolve(MeshBlockData<Real> *mbd) {
     return TaskStatus::complete;
 
 }
+
+TaskStatus Implicit::MeshFixSolve(MeshData<Real> *md) {
+
+    Flag("MeshFixSolve");
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+
+    PackIndexMap implicit_prims_map;
+    auto implicit_vars = Implicit::GetOrderedNames(md->GetBlockData(0).get(), Metadata::GetUserFlag("Primitive"), true);
+    auto P          = md->PackVariables(implicit_vars, implicit_prims_map);
+    auto solve_fail = md->PackVariables(std::vector<std::string>{"solve_fail"});
+    const int nfvar = P.GetDim(4);
+    if (nfvar == 0 || solve_fail.GetDim(4) == 0) {
+        EndFlag();
+        return TaskStatus::complete;
+    }
+
+    const Real gam    = pmb0->packages.Get("GRMHD")->Param<Real>("gamma");
+    const int flag_verbose = pmb0->packages.Get("Globals")->Param<int>("flag_verbose");
+
+    // See FixSolve: ghost zones hold unsuccessful values too, so fix over the entire domain
+    const IndexRange3 b   = KDomain::GetRange(md, IndexDomain::entire);
+    const IndexRange3 b_b = KDomain::GetRange(md, IndexDomain::interior);
+    const IndexRange block = IndexRange{0, P.GetDim(5) - 1};
+
+    // Rather than keeping sums for every zone, loop over the stencil once per variable.
+    // This only happens in failed zones, which are rare
+    pmb0->par_for("fix_solver_failures_mesh", block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        KOKKOS_LAMBDA (const int& bl, const int& k, const int& j, const int& i) {
+            if (failed(solve_fail(bl, 0, k, j, i))) {
+                double wsum = 0.;
+                for (int n = -1; n <= 1; n++)
+                    for (int m = -1; m <= 1; m++)
+                        for (int l = -1; l <= 1; l++) {
+                            int ii = i + l, jj = j + m, kk = k + n;
+                            if (KDomain::inside(kk, jj, ii, b) && !failed(solve_fail(bl, 0, kk, jj, ii)))
+                                wsum += 1./(m::abs(l) + m::abs(m) + m::abs(n) + 1);
+                        }
+
+                if(wsum < 1.e-10) {
+#ifndef KOKKOS_ENABLE_SYCL
+                    if (flag_verbose >= 3 && KDomain::inside(k, j, i, b_b))
+                        printf("No neighbors were available at %d %d %d in block %d!\n", i, j, k, bl);
+#endif
+                } else {
+                    FLOOP {
+                        double sum = 0.;
+                        for (int n = -1; n <= 1; n++)
+                            for (int m = -1; m <= 1; m++)
+                                for (int l = -1; l <= 1; l++) {
+                                    int ii = i + l, jj = j + m, kk = k + n;
+                                    if (KDomain::inside(kk, jj, ii, b) && !failed(solve_fail(bl, 0, kk, jj, ii)))
+                                        sum += P(bl, ip, kk, jj, ii) / (m::abs(l) + m::abs(m) + m::abs(n) + 1);
+                                }
+                        P(bl, ip, k, j, i) = sum/wsum;
+                    }
+                }
+            }
+        }
+    );
+
+    PackIndexMap prims_map, cons_map;
+    auto P_all = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    auto U_all = md->PackVariables(std::vector<MetadataFlag>{Metadata::Conserved}, cons_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+
+    EMHD_parameters emhd_params = EMHD::GetEMHDParameters(pmb0->packages);
+
+    pmb0->par_for("fix_solver_failures_PtoU_mesh", block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        KOKKOS_LAMBDA (const int& bl, const int& k, const int& j, const int& i) {
+            if (failed(solve_fail(bl, 0, k, j, i))) {
+                const auto& G = U_all.GetCoords(bl);
+                Flux::p_to_u(G, P_all(bl), m_p, emhd_params, gam, k, j, i, U_all(bl), m_u);
+            }
+        }
+    );
+
+    EndFlag();
+    return TaskStatus::complete;
+
+}
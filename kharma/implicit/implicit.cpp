@@ -39,6 +39,92 @@
 #include "kharma.hpp"
 #include "pack.hpp"
 #include "reductions.hpp"
+#include "zone_tiles.hpp"
+
+std::vector<std::array<IndexRange, 3>> Implicit::RegionBoxes(MeshData<Real> *md, SolveRegion region)
+{
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    if (region == SolveRegion::all) return {{ib, jb, kb}};
+
+    // Core ranges, excluding nghost zones next to each face in each active direction
+    const int ng = Globals::nghost;
+    const int ndim = md->GetMeshPointer()->ndim;
+    const IndexRange ic = IndexRange{ib.s + ng, ib.e - ng};
+    const IndexRange jc = (ndim > 1) ? IndexRange{jb.s + ng, jb.e - ng} : jb;
+    const IndexRange kc = (ndim > 2) ? IndexRange{kb.s + ng, kb.e - ng} : kb;
+    // Blocks too small to have a core are all shell
+    if (ic.e < ic.s || jc.e < jc.s || kc.e < kc.s) {
+        if (region == SolveRegion::shell) return {{ib, jb, kb}};
+        else return {};
+    }
+    if (region == SolveRegion::core) return {{ic, jc, kc}};
+
+    // Shell: slabs in X3, then X2 inside the X3 core, then X1 inside both
+    std::vector<std::array<IndexRange, 3>> boxes;
+    if (ndim > 2) {
+        boxes.push_back({ib, jb, IndexRange{kb.s, kc.s - 1}});
+        boxes.push_back({ib, jb, IndexRange{kc.e + 1, kb.e}});
+    }
+    if (ndim > 1) {
+        boxes.push_back({ib, IndexRange{jb.s, jc.s - 1}, kc});
+        boxes.push_back({ib, IndexRange{jc.e + 1, jb.e}, kc});
+    }
+    boxes.push_back({IndexRange{ib.s, ic.s - 1}, jc, kc});
+    boxes.push_back({IndexRange{ic.e + 1, ib.e}, jc, kc});
+    return boxes;
+}
+
+size_t Implicit::ScratchBytes(int n1, int nvar, int nfvar, bool register_solve, bool batched_solve)
+{
+    const size_t var_size_in_bytes    = parthenon::ScratchPad2D<Real>::shmem_size(n1, nvar);
+    const size_t fvar_size_in_bytes   = parthenon::ScratchPad2D<Real>::shmem_size(n1, nfvar);
+    // With register_solve, the Jacobian lives in each thread, so only reserve a placeholder
+    // Likewise the QR workspace
+    const int jac_n = (register_solve) ? 1 : nfvar;
+    const size_t tensor_size_in_bytes = parthenon::ScratchPad3D<Real>::shmem_size(jac_n, n1, jac_n);
+    const size_t lin_size_in_bytes    = parthenon::ScratchPad2D<Real>::shmem_size(n1, jac_n);
+    const size_t work_size_in_bytes   = parthenon::ScratchPad2D<Real>::shmem_size(n1, 2*jac_n);
+    const size_t pivot_size_in_bytes  = parthenon::ScratchPad2D<int>::shmem_size(n1, jac_n);
+    const size_t scalar_size_in_bytes = parthenon::ScratchPad1D<Real>::shmem_size(n1);
+    // With batched_solve, another copy of the Jacobians & steps, lane-major, plus two flags per zone
+    const int batch_n = (batched_solve) ? nfvar : 1;
+    const int batch_n1 = (batched_solve) ? n1 : 1;
+    const size_t batch_size_in_bytes  = parthenon::ScratchPad3D<Real>::shmem_size(batch_n, batch_n, batch_n1) +
+                                        parthenon::ScratchPad2D<Real>::shmem_size(batch_n, batch_n1) +
+                                        2 * parthenon::ScratchPad1D<int>::shmem_size(n1);
+    // Allocate enough to cache:
+    // jacobian (2D), trans, work, pivot (linear solve only)
+    // residual, deltaP, dU_implicit, residual_delta temp (implicit only)
+    // P_full_step_init/U_full_step_init, P_sub_step_init, flux_src, 
+    // P_solver, two temps (all vars)
+    // solve_norm, solve_fail
+    // P_linesearch shares the P_delta temp: the Jacobian leaves it equal to P_solver, and it is only
+    // needed once the Jacobian is done.  U_sub_step_init & P_linesearch required no separate copies.
+    return tensor_size_in_bytes + lin_size_in_bytes + work_size_in_bytes + pivot_size_in_bytes +
+           (4) * fvar_size_in_bytes + (7) * var_size_in_bytes + (2) * scalar_size_in_bytes + batch_size_in_bytes;
+}
+
+TaskStatus Implicit::CopyRegion(MeshData<Real> *md_from, MeshData<Real> *md_to, SolveRegion region)
+{
+    auto pmb0 = md_from->GetBlockData(0)->GetBlockPointer();
+    const auto& from = md_from->PackVariables(std::vector<MetadataFlag>{Metadata::Cell});
+    const auto& to = md_to->PackVariables(std::vector<MetadataFlag>{Metadata::Cell});
+    const IndexRange block = IndexRange{0, from.GetDim(5) - 1};
+    const IndexRange vars = IndexRange{0, from.GetDim(4) - 1};
+
+    for (const auto &box : RegionBoxes(md_from, region)) {
+        const IndexRange ib = box[0], jb = box[1], kb = box[2];
+        pmb0->par_for("copy_region", block.s, block.e, vars.s, vars.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA (const int& b, const int& v, const int& k, const int& j, const int& i) {
+                if (from.IsAllocated(b, v) && to.IsAllocated(b, v))
+                    to(b, v, k, j, i) = from(b, v, k, j, i);
+            }
+        );
+    }
+    return TaskStatus::complete;
+}
 
 #if DISABLE_IMPLICIT
 
@@ -48,7 +134,8 @@ std::shared_ptr<KHARMAPackage> Implicit::Initialize(ParameterInput *pin, std::sh
 { throw std::runtime_error("KHARMA was compiled without implicit stepping support!"); }
 // We still need a stub for Step() in order to compile, but it will never be called
 TaskStatus Implicit::Step(MeshData<Real> *md_full_step_init, MeshData<Real> *md_sub_step_init, MeshData<Real> *md_flux_src,
-                MeshData<Real> *md_linesearch, MeshData<Real> *md_solver, const Real& dt) {}
+                MeshData<Real> *md_linesearch, MeshData<Real> *md_solver, const Real& dt,
+                SolveRegion region) {}
 
 #else
 
@@ -102,6 +189,38 @@ std::shared_ptr<KHARMAPackage> Implicit::Initialize(ParameterInput *pin, std::sh
     // The alternative LU decomposition does not, and should mostly be used for debugging.
     bool use_qr = pin->GetOrAddBoolean("implicit", "use_qr", true);
     params.Add("use_qr", use_qr);
+    // Keep each zone's Jacobian in thread-local storage and solve it with a small unrolled LU,
+    // instead of in team scratch with KokkosBatched.  Requires nfvar <= IMPLICIT_MAX_NFVAR (see implicit.hpp)
+    bool register_solve = pin->GetOrAddBoolean("implicit", "register_solve", false);
+    params.Add("register_solve", register_solve);
+    // Chord method: factor the Jacobian only on the first nonlinear iteration of each sub-step,
+    // and reuse the factors for later iterations.  Converges more slowly, but each iteration
+    // costs only a residual evaluation & triangular solve
+    bool chord = pin->GetOrAddBoolean("implicit", "chord", false);
+    if (chord && register_solve)
+        throw std::invalid_argument("Chord iterations are not supported with implicit/register_solve!");
+    params.Add("chord", chord);
+    // Factor & solve the linear system in single precision, keeping the residual and update in double.
+    // Each Newton iteration then acts as a step of iterative refinement, and convergence is still judged
+    // by the double-precision residual norm.  Only for implicit/register_solve
+    bool mixed_precision = pin->GetOrAddBoolean("implicit", "mixed_precision", false);
+    if (mixed_precision && !register_solve)
+        throw std::invalid_argument("Mixed-precision implicit solves require implicit/register_solve=true!");
+    params.Add("mixed_precision", mixed_precision);
+    // Solve the Jacobian systems of each row of zones together, batch_width at a time, with the zone index
+    // fastest in memory so that each step of the LU decomposition vectorizes across zones on CPUs.
+    // The Jacobians are still built per zone as with register_solve, which this requires
+    bool batched_solve = pin->GetOrAddBoolean("implicit", "batched_solve", false);
+    if (batched_solve && (!register_solve || mixed_precision))
+        throw std::invalid_argument("implicit/batched_solve requires register_solve=true and mixed_precision=false!");
+    params.Add("batched_solve", batched_solve);
+    // Zones per batch: a multiple of the SIMD width in doubles, e.g. 8 for AVX-512 or 512-bit SVE
+    int batch_width = pin->GetOrAddInteger("implicit", "batch_width", 8);
+    if (batch_width < 1)
+        throw std::invalid_argument("implicit/batch_width must be positive!");
+    params.Add("batch_width", batch_width);
+    // Print the scratch size of the solver kernel, just once
+    params.Add("reported_scratch", false, true);
 
     bool linesearch = pin->GetOrAddBoolean("implicit", "linesearch", true);
     params.Add("linesearch", linesearch);
@@ -111,6 +230,30 @@ std::shared_ptr<KHARMAPackage> Implicit::Initialize(ParameterInput *pin, std::sh
     params.Add("linesearch_eps", linesearch_eps);
     Real linesearch_lambda = pin->GetOrAddReal("implicit", "linesearch_lambda", 1.0);
     params.Add("linesearch_lambda", linesearch_lambda);
+    // Stop iterating on zones which have already converged (after min_nonlinear_iter), and skip
+    // any teams (i.e. rows of zones) in which every zone has converged or failed
+    bool skip_converged = pin->GetOrAddBoolean("implicit", "skip_converged", false);
+    params.Add("skip_converged", skip_converged);
+
+    // Solve zones within nghost of block faces first, then start the boundary sync and solve the
+    // rest of each block while it's in flight (ImEx driver).
+    bool overlap_sync = pin->GetOrAddBoolean("implicit", "overlap_sync", false);
+    params.Add("overlap_sync", overlap_sync);
+
+    // Solve only the zones where EMHD relaxation is stiff, i.e. tau/dt < stiff_threshold. The rest take an explicit
+    // update, with the EMHD sources evaluated at the explicitly-updated fluid state, and the Newton kernel iterates
+    // over only the rows of zones containing a stiff zone.  Requires GRMHD/implicit=false, so the fluid is updated
+    // before the solve & only the EMHD scalars are implicit
+    bool adaptive = pin->GetOrAddBoolean("implicit", "adaptive", false);
+    if (adaptive && (!packages->AllPackages().count("EMHD") || packages->Get("GRMHD")->Param<bool>("implicit")))
+        throw std::invalid_argument("Adaptive implicit solves require EMHD with GRMHD/implicit=false!");
+    params.Add("adaptive", adaptive);
+    // Forward Euler relaxation is stable for dt < 2 tau, so this leaves a factor of 2 margin
+    Real stiff_threshold = pin->GetOrAddReal("implicit", "stiff_threshold", 1.0);
+    params.Add("stiff_threshold", stiff_threshold);
+    // Compacted lists of rows with any stiff zone, and their count in each box, kept between steps
+    params.Add("stiff_rows", Allocations::PersistentArray<int>("stiff_rows"), true);
+    params.Add("stiff_count", Allocations::PersistentArray<int>("stiff_count"), true);
 
     // Allocate additional fields that reflect the success of the solver
     // L2 norm of the residual
@@ -119,27 +262,53 @@ std::shared_ptr<KHARMAPackage> Implicit::Initialize(ParameterInput *pin, std::sh
     // Integer field that saves where the solver fails (rho + drho < 0 || u + du < 0)
     m_real = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy, Metadata::FillGhost});
     pkg->AddField("solve_fail", m_real); // TODO: Replace with m_int once Integer is supported for CellVariable
+    // Number of nonlinear iterations actually performed in each zone, for diagnostics
+    m_real = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy});
+    pkg->AddField("solve_iters", m_real);
+    // Number of linesearch steps in each zone over all iterations, for diagnostics
+    if (linesearch) pkg->AddField("solve_linesearch_iters", m_real);
 
     // Should the solve save the residual vector field? Useful for debugging purposes. Default is NO.
     bool save_residual = pin->GetOrAddBoolean("implicit", "save_residual", false);
     params.Add("save_residual", save_residual);
+    const int nvars_implicit = KHARMA::PackDimension(packages.get(), Metadata::GetUserFlag("Implicit"));
     if (save_residual) {
-        int nvars_implicit  = KHARMA::PackDimension(packages.get(), Metadata::GetUserFlag("Implicit"));
 
         std::vector<int> s_vars_implicit({nvars_implicit});
         Metadata m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy}, s_vars_implicit);
         pkg->AddField("residual", m);
     }
+    // Jacobian factors (QR or LU), plus the QR transformation & pivots, saved between chord iterations
+    if (chord) {
+        std::vector<int> s_factors({nvars_implicit * (nvars_implicit + 2)});
+        Metadata m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy}, s_factors);
+        pkg->AddField("solve_factors", m);
+    }
 
     // The major call, to Step(), is done manually from the ImEx driver
     // But, we just register the diagnostics function to print out solver failures
     pkg->PostStepDiagnosticsMesh = Implicit::PostStepDiagnostics;
 
+    // History counters: total nonlinear iterations and linesearch steps
+    if (pin->GetOrAddBoolean("debug", "history_counters", false)) {
+        parthenon::HstVar_list hst_vars = {};
+        hst_vars.emplace_back(parthenon::HistoryOutputVar(UserHistoryOperation::sum,
+            [](MeshData<Real> *md) -> Real { return Reductions::SumField(md, "solve_iters", IndexDomain::interior); },
+            "ImplicitIters"));
+        if (linesearch) {
+            hst_vars.emplace_back(parthenon::HistoryOutputVar(UserHistoryOperation::sum,
+                [](MeshData<Real> *md) -> Real { return Reductions::SumField(md, "solve_linesearch_iters", IndexDomain::interior); },
+                "LinesearchIters"));
+        }
+        pkg->AddParam<>(parthenon::hist_param_key, hst_vars);
+    }
+
     return pkg;
 }
 
 TaskStatus Implicit::Step(MeshData<Real> *md_full_step_init, MeshData<Real> *md_sub_step_init, MeshData<Real> *md_flux_src,
-                MeshData<Real> *md_linesearch, MeshData<Real> *md_solver, const Real& dt)
+                MeshData<Real> *md_linesearch, MeshData<Real> *md_solver, const Real& dt,
+                SolveRegion region)
 {
     Flag("Implicit::Step");
     // Pull out the block pointers for each sub-step, as we need the *mutable parameters*
@@ -156,6 +325,14 @@ TaskStatus Implicit::Step(MeshData<Real> *md_full_step_init, MeshData<Real> *md_
     const Real delta         = implicit_par.Get<Real>("jacobian_delta");
     const Real rootfind_tol  = implicit_par.Get<Real>("rootfind_tol");
     const bool use_qr        = implicit_par.Get<bool>("use_qr");
+    const bool register_solve = implicit_par.Get<bool>("register_solve");
+    const bool skip_converged = implicit_par.Get<bool>("skip_converged");
+    const bool chord          = implicit_par.Get<bool>("chord");
+    const bool mixed_precision = implicit_par.Get<bool>("mixed_precision");
+    const bool batched_solve  = implicit_par.Get<bool>("batched_solve");
+    const int batch_width     = implicit_par.Get<int>("batch_width");
+    const bool adaptive       = implicit_par.Get<bool>("adaptive");
+    const Real stiff_threshold = implicit_par.Get<Real>("stiff_threshold");
     const auto& globals      = pmb_full_step_init->packages.Get("Globals")->AllParams();
     const int verbose        = globals.Get<int>("verbose");
     const int flag_verbose   = globals.Get<int>("flag_verbose");
@@ -202,12 +379,10 @@ TaskStatus Implicit::Step(MeshData<Real> *md_full_step_init, MeshData<Real> *md_
     const VarMap m_u(cons_map, true), m_p(prims_map, false);
     // Current sub-step starting state.
     auto& P_sub_step_init_all = md_sub_step_init->PackVariables(ordered_prims);
-    auto& U_sub_step_init_all = md_sub_step_init->PackVariables(ordered_cons);
     // Flux divergence plus explicit source terms. This is what we'd be adding.
     auto& flux_src_all = md_flux_src->PackVariables(ordered_cons);
     // Guess at initial state. We update only the implicit primitive vars
     auto& P_solver_all     = md_solver->PackVariables(ordered_prims);
-    auto& P_linesearch_all = md_linesearch->PackVariables(ordered_prims);
 
     // Sizes and scratchpads
     const int nblock = U_full_step_init_all.GetDim(5);
@@ -219,10 +394,17 @@ TaskStatus Implicit::Step(MeshData<Real> *md_full_step_init, MeshData<Real> *md_
     PackIndexMap implicit_prims_map;
     auto& P_full_step_init_implicit = md_full_step_init->PackVariables(implicit_vars, implicit_prims_map);
     const int nfvar = P_full_step_init_implicit.GetDim(4);
+    // Are the fluid primitives part of the solve, or just the EMHD scalars? Only the former can go negative here
+    const bool fluid_implicit = m_p.RHO < nfvar && m_p.UU < nfvar;
 
     // Pull fields associated with the solver's performance
     auto& solve_norm_all = md_solver->PackVariables(std::vector<std::string>{"solve_norm"});
     auto& solve_fail_all = md_solver->PackVariables(std::vector<std::string>{"solve_fail"});
+    auto& solve_iters_all = md_solver->PackVariables(std::vector<std::string>{"solve_iters"});
+    auto& solve_linesearch_all = md_solver->PackVariables(std::vector<std::string>{"solve_linesearch_iters"});
+    const bool record_linesearch = solve_linesearch_all.GetDim(4) > 0;
+    // Factored Jacobians for chord iterations, if enabled
+    auto& solve_factors_all = md_solver->PackVariables(std::vector<std::string>{"solve_factors"});
 
     auto bounds  = pmb_sub_step_init->cellbounds;
     const int n1 = bounds.ncellsi(IndexDomain::entire);
@@ -238,12 +420,14 @@ TaskStatus Implicit::Step(MeshData<Real> *md_full_step_init, MeshData<Real> *md_
     // TODO keep this around as a field?
     // ParArray4D<Real> norm_all("norm_all", nblock, n3, n2, n1); // EDIT
 
-    // Get meshblock array bounds from Parthenon
-    const IndexDomain domain = IndexDomain::interior;
-    const IndexRange ib      = bounds.GetBoundsI(domain);
-    const IndexRange jb      = bounds.GetBoundsJ(domain);
-    const IndexRange kb      = bounds.GetBoundsK(domain);
+    // Get the ranges of each box of zones we're solving, usually just the block interior.
+    // Each box is solved by a separate launch of the same kernel
+    const auto boxes         = RegionBoxes(md_solver, region);
     const IndexRange block   = IndexRange{0, nblock - 1};
+    if (boxes.size() == 0) {
+        EndFlag();
+        return TaskStatus::complete;
+    }
 
     // Allocate scratch space
     // It is impossible to declare runtime-sized arrays in CUDA
@@ -253,74 +437,202 @@ TaskStatus Implicit::Step(MeshData<Real> *md_full_step_init, MeshData<Real> *md_
     // to avoid a bunch of indices in all the device-side operations
     // See grmhd_functions.hpp for the other approach with overloads
     const int scratch_level = 1; // 0 is actual scratch (tiny); 1 is HBM
-    const size_t var_size_in_bytes    = parthenon::ScratchPad2D<Real>::shmem_size(n1, nvar);
-    const size_t fvar_size_in_bytes   = parthenon::ScratchPad2D<Real>::shmem_size(n1, nfvar);
-    const size_t tensor_size_in_bytes = parthenon::ScratchPad3D<Real>::shmem_size(nfvar, n1, nfvar);
-    const size_t scalar_size_in_bytes = parthenon::ScratchPad1D<Real>::shmem_size(n1);
-    const size_t int_size_in_bytes    = parthenon::ScratchPad1D<int>::shmem_size(n1);
-    // Allocate enough to cache:
-    // jacobian (2D)
-    // residual, deltaP, trans, work (implicit only)
-    // P_full_step_init/U_full_step_init, P_sub_step_init/U_sub_step_init, flux_src, 
-    // P_solver, P_linesearch, dU_implicit, three temps (all vars)
-    // solve_norm, solve_fail
+    // With register_solve, the Jacobian lives in each thread, see ScratchBytes
+    if (register_solve && nfvar > IMPLICIT_MAX_NFVAR)
+        throw std::runtime_error("Too many implicit variables for implicit/register_solve! Recompile with larger IMPLICIT_MAX_NFVAR.");
+    const int jac_n = (register_solve) ? 1 : nfvar;
+    // With batched_solve, the Jacobians & Newton steps are also kept with the zone index fastest
+    const int batch_n = (batched_solve) ? nfvar : 1;
+    const int batch_n1 = (batched_solve) ? n1 : 1;
+    const size_t total_scratch_bytes = ScratchBytes(n1, nvar, nfvar, register_solve, batched_solve);
+
+    if (verbose > 0 && am_rank0 && !implicit_par.Get<bool>("reported_scratch")) {
+        printf("Implicit solver scratch per team: %lu bytes (%d zones, %d implicit of %d variables)\n",
+               (unsigned long) total_scratch_bytes, n1, nfvar, nvar);
+        pmb_full_step_init->packages.Get("Implicit")->UpdateParam<bool>("reported_scratch", true);
+    }
 
-    const size_t total_scratch_bytes = tensor_size_in_bytes + (6) * fvar_size_in_bytes + (11) * var_size_in_bytes + \
-                                    (2) * scalar_size_in_bytes;
-                                    //  + int_size_in_bytes;
+    // With implicit/adaptive, update the non-stiff zones explicitly and list the rows of each box containing
+    // any stiff zones.  The Newton kernel below then launches one team per listed row, rather than per row
+    std::vector<int> n_rows(boxes.size()), row_offsets(boxes.size());
+    ParArray1D<int> stiff_rows;
+    {
+        int total_rows = 0;
+        for (int ibox = 0; ibox < boxes.size(); ++ibox) {
+            const IndexRange jb = boxes[ibox][1], kb = boxes[ibox][2];
+            n_rows[ibox] = nblock * (kb.e - kb.s + 1) * (jb.e - jb.s + 1);
+            row_offsets[ibox] = total_rows;
+            total_rows += n_rows[ibox];
+        }
+        if (adaptive) {
+            auto& implicit_par_mutable = pmb_full_step_init->packages.Get("Implicit")->AllParams();
+            stiff_rows = implicit_par_mutable.GetMutable<Allocations::PersistentArray<int>>("stiff_rows")->Get(total_rows);
+            const auto stiff_count = implicit_par_mutable.GetMutable<Allocations::PersistentArray<int>>("stiff_count")->Get(boxes.size());
+            Kokkos::deep_copy(stiff_count, 0);
+            for (int ibox = 0; ibox < boxes.size(); ++ibox) {
+                const IndexRange ib = boxes[ibox][0], jb = boxes[ibox][1], kb = boxes[ibox][2];
+                const int nj = jb.e - jb.s + 1, nk = kb.e - kb.s + 1;
+                const int offset = row_offsets[ibox];
+                parthenon::par_for_outer(DEFAULT_OUTER_LOOP_PATTERN, "implicit_classify", pmb_sub_step_init->exec_space,
+                    0, 0, block.s, block.e, kb.s, kb.e, jb.s, jb.e,
+                    KOKKOS_LAMBDA(parthenon::team_mbr_t member, const int& b, const int& k, const int& j) {
+                        const auto& G = U_full_step_init_all.GetCoords(b);
+                        int n_stiff = 0;
+                        Kokkos::parallel_reduce(Kokkos::TeamThreadRange(member, ib.s, ib.e + 1),
+                            [&](const int& i, int& local_stiff) {
+                                auto P_full_step_init = Kokkos::subview(P_full_step_init_all(b), Kokkos::ALL(), k, j, i);
+                                auto P_sub_step_init  = Kokkos::subview(P_sub_step_init_all(b), Kokkos::ALL(), k, j, i);
+                                auto P_solver         = Kokkos::subview(P_solver_all(b), Kokkos::ALL(), k, j, i);
+                                EMHD::SourceTerms emhd_terms;
+                                EMHD::source_terms(G, P_full_step_init, P_sub_step_init, m_p, emhd_params_sub_step_init,
+                                                gam, j, i, emhd_terms);
+                                if (emhd_terms.tau < stiff_threshold * dt) {
+                                    solve_fail_all(b, 0, k, j, i) = (Real) SolverStatus::converged;
+                                    ++local_stiff;
+                                    return;
+                                }
+                                // Explicit update: the implicit sources at the initial & current states, and the time
+                                // derivative sources, all evaluated with the EMHD scalars from the sub-step start.
+                                // The fluid primitives in P_solver are already updated for this sub-step
+                                Real dUq_i = 0., dUdP_i = 0., dUq = 0., dUdP = 0., dUq_t = 0., dUdP_t = 0.;
+                                EMHD::implicit_sources(G, P_full_step_init, m_p, j, i, emhd_params_sub_step_init,
+                                                       emhd_terms, dUq_i, dUdP_i);
+                                if (m_p.Q >= 0) P_solver(m_p.Q) = P_sub_step_init(m_p.Q);
+                                if (m_p.DP >= 0) P_solver(m_p.DP) = P_sub_step_init(m_p.DP);
+                                EMHD::implicit_sources(G, P_solver, m_p, j, i, emhd_params_sub_step_init,
+                                                       emhd_terms, dUq, dUdP);
+                                EMHD::time_derivative_sources(G, P_solver, m_p, emhd_params_sub_step_init,
+                                                              emhd_terms, gam, dt, j, i, dUq_t, dUdP_t);
+                                const Real ucon0 = GRMHD::lorentz_calc(G, P_solver, m_p, j, i, Loci::center)
+                                                    * m::sqrt(-G.gcon(Loci::center, j, i, 0, 0));
+                                const Real inv_norm = 1. / (ucon0 * G.gdet(Loci::center, j, i));
+                                if (emhd_params_sub_step_init.conduction)
+                                    P_solver(m_p.Q) = (U_full_step_init_all(b, m_u.Q, k, j, i)
+                                                    + dt * (flux_src_all(b, m_u.Q, k, j, i) + 0.5*(dUq + dUq_i) + dUq_t)) * inv_norm;
+                                if (emhd_params_sub_step_init.viscosity)
+                                    P_solver(m_p.DP) = (U_full_step_init_all(b, m_u.DP, k, j, i)
+                                                    + dt * (flux_src_all(b, m_u.DP, k, j, i) + 0.5*(dUdP + dUdP_i) + dUdP_t)) * inv_norm;
+                                solve_fail_all(b, 0, k, j, i) = (Real) SolverStatus::nonstiff;
+                                solve_norm_all(b, 0, k, j, i) = 0.;
+                                solve_iters_all(b, 0, k, j, i) = 0.;
+                                if (record_linesearch) solve_linesearch_all(b, 0, k, j, i) = 0.;
+                            }
+                        , n_stiff);
+                        if (n_stiff > 0) {
+                            Kokkos::single(Kokkos::PerTeam(member), [&]() {
+                                const int n = Kokkos::atomic_fetch_add(&stiff_count(ibox), 1);
+                                stiff_rows(offset + n) = (b * nk + (k - kb.s)) * nj + (j - jb.s);
+                            });
+                        }
+                    }
+                );
+            }
+            auto stiff_count_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), stiff_count);
+            for (int ibox = 0; ibox < boxes.size(); ++ibox) n_rows[ibox] = stiff_count_h(ibox);
+        }
+    }
 
     // Iterate.  This loop is outside the kokkos kernel in order to print max_norm
     // There are generally a low and similar number of iterations between
     // different zones, so probably acceptable speed loss.
     for (int iter=1; iter <= iter_max; ++iter) {
         // Flags per iter, since debugging here will be rampant
-        Flag("ImplicitIteration_"+std::to_string(iter));
-
-        parthenon::par_for_outer(DEFAULT_OUTER_LOOP_PATTERN, "implicit_solve", pmb_sub_step_init->exec_space,
-            total_scratch_bytes, scratch_level, block.s, block.e, kb.s, kb.e, jb.s, jb.e,
-            KOKKOS_LAMBDA(parthenon::team_mbr_t member, const int& b, const int& k, const int& j) {
-                const auto& G = U_full_step_init_all.GetCoords(b);
-                // Scratchpads for implicit vars
-                ScratchPad3D<Real> jacobian_s(member.team_scratch(scratch_level), n1, nfvar, nfvar);
-                ScratchPad2D<Real> residual_s(member.team_scratch(scratch_level), n1, nfvar);
-                ScratchPad2D<Real> delta_prim_s(member.team_scratch(scratch_level), n1, nfvar);
-                ScratchPad2D<int> pivot_s(member.team_scratch(scratch_level), n1, nfvar);
-                ScratchPad2D<Real> trans_s(member.team_scratch(scratch_level), n1, nfvar);
-                ScratchPad2D<Real> work_s(member.team_scratch(scratch_level), n1, 2*nfvar);
-                // Scratchpads for all vars
-                ScratchPad2D<Real> dU_implicit_s(member.team_scratch(scratch_level), n1, nvar);
-                ScratchPad2D<Real> tmp1_s(member.team_scratch(scratch_level), n1, nvar);
-                ScratchPad2D<Real> tmp2_s(member.team_scratch(scratch_level), n1, nfvar);
-                ScratchPad2D<Real> tmp3_s(member.team_scratch(scratch_level), n1, nvar);
-                ScratchPad2D<Real> P_full_step_init_s(member.team_scratch(scratch_level), n1, nvar);
-                ScratchPad2D<Real> U_full_step_init_s(member.team_scratch(scratch_level), n1, nvar);
-                ScratchPad2D<Real> P_sub_step_init_s(member.team_scratch(scratch_level), n1, nvar);
-                ScratchPad2D<Real> U_sub_step_init_s(member.team_scratch(scratch_level), n1, nvar);
-                ScratchPad2D<Real> flux_src_s(member.team_scratch(scratch_level), n1, nvar);
-                ScratchPad2D<Real> P_solver_s(member.team_scratch(scratch_level), n1, nvar);
-                ScratchPad2D<Real> P_linesearch_s(member.team_scratch(scratch_level), n1, nvar);
-                // Scratchpads for solver performance diagnostics
-                ScratchPad1D<Real> solve_norm_s(member.team_scratch(scratch_level), n1);
-                ScratchPad1D<SolverStatus> solve_fail_s(member.team_scratch(scratch_level), n1);
-
-                // Copy some file contents to scratchpads, so we can slice them
-                for(int ip=0; ip < nvar; ++ip) {
+        Flag("ImplicitIteration_", iter);
+
+        for (int ibox = 0; ibox < boxes.size(); ++ibox) {
+            const IndexRange ib = boxes[ibox][0], jb = boxes[ibox][1], kb = boxes[ibox][2];
+            const int nj = jb.e - jb.s + 1, nk = kb.e - kb.s + 1;
+            const int offset = row_offsets[ibox];
+            if (n_rows[ibox] == 0) continue;
+            // Static estimates for the timing report: read both initial states, fluxes & the solver
+            // state, write it back.  Residuals for each Jacobian column then a dense LU solve
+            Timers::CountKernel("implicit_solve", static_cast<double>(n_rows[ibox]) * (ib.e - ib.s + 1),
+                                (7 * nvar + 43) * sizeof(Real), (nfvar + 1) * 400. + 2. * nfvar * nfvar * nfvar / 3.);
+            // One team per row of zones (b, k, j), or per listed row with implicit/adaptive
+            parthenon::par_for_outer(DEFAULT_OUTER_LOOP_PATTERN, "implicit_solve", pmb_sub_step_init->exec_space,
+                total_scratch_bytes, scratch_level, 0, n_rows[ibox] - 1,
+                KOKKOS_LAMBDA(parthenon::team_mbr_t member, const int& r) {
+                    const int row = (adaptive) ? stiff_rows(offset + r) : r;
+                    const int j = jb.s + row % nj;
+                    const int k = kb.s + (row / nj) % nk;
+                    const int b = row / (nj * nk);
+                    const auto& G = U_full_step_init_all.GetCoords(b);
+                    // Skip the whole row if no zone in it will iterate
+                    if (skip_converged && iter > iter_min) {
+                        int n_active = 0;
+                        Kokkos::parallel_reduce(Kokkos::TeamThreadRange(member, ib.s, ib.e + 1),
+                            [&](const int& i, int& local_active) {
+                                const SolverStatus status = (SolverStatus) solve_fail_all(b, 0, k, j, i);
+                                if (status != SolverStatus::converged && status != SolverStatus::fail &&
+                                    status != SolverStatus::nonstiff) ++local_active;
+                            }
+                        , n_active);
+                        if (n_active == 0) return;
+                    }
+                    // Scratchpads for implicit vars
+                    ScratchPad3D<Real> jacobian_s(member.team_scratch(scratch_level), n1, jac_n, jac_n);
+                    ScratchPad2D<Real> residual_s(member.team_scratch(scratch_level), n1, nfvar);
+                    ScratchPad2D<Real> delta_prim_s(member.team_scratch(scratch_level), n1, nfvar);
+                    ScratchPad2D<int> pivot_s(member.team_scratch(scratch_level), n1, jac_n);
+                    ScratchPad2D<Real> trans_s(member.team_scratch(scratch_level), n1, jac_n);
+                    ScratchPad2D<Real> work_s(member.team_scratch(scratch_level), n1, 2*jac_n);
+                    // Only ever indexed by implicit (i.e., leading) conserved vars Q, DP
+                    ScratchPad2D<Real> dU_implicit_s(member.team_scratch(scratch_level), n1, nfvar);
+                    ScratchPad2D<Real> tmp2_s(member.team_scratch(scratch_level), n1, nfvar);
+                    // Scratchpads for all vars
+                    ScratchPad2D<Real> tmp1_s(member.team_scratch(scratch_level), n1, nvar);
+                    ScratchPad2D<Real> tmp3_s(member.team_scratch(scratch_level), n1, nvar);
+                    ScratchPad2D<Real> P_full_step_init_s(member.team_scratch(scratch_level), n1, nvar);
+                    ScratchPad2D<Real> U_full_step_init_s(member.team_scratch(scratch_level), n1, nvar);
+                    ScratchPad2D<Real> P_sub_step_init_s(member.team_scratch(scratch_level), n1, nvar);
+                    ScratchPad2D<Real> flux_src_s(member.team_scratch(scratch_level), n1, nvar);
+                    ScratchPad2D<Real> P_solver_s(member.team_scratch(scratch_level), n1, nvar);
+                    // Scratchpads for solver performance diagnostics
+                    ScratchPad1D<Real> solve_norm_s(member.team_scratch(scratch_level), n1);
+                    ScratchPad1D<SolverStatus> solve_fail_s(member.team_scratch(scratch_level), n1);
+                    // Lane-major systems for implicit/batched_solve, and which zones are waiting on them
+                    ScratchPad3D<Real> jacobian_b_s(member.team_scratch(scratch_level), batch_n, batch_n, batch_n1);
+                    ScratchPad2D<Real> delta_prim_b_s(member.team_scratch(scratch_level), batch_n, batch_n1);
+                    ScratchPad1D<int> batch_pending_s(member.team_scratch(scratch_level), n1);
+                    ScratchPad1D<int> batch_singular_s(member.team_scratch(scratch_level), n1);
+
+                    // Copy some file contents to scratchpads in zone-major order, so we can slice them
+                    ZoneTiles::load(member, P_full_step_init_all(b), nvar, k, j, 0, n1-1, P_full_step_init_s);
+                    ZoneTiles::load(member, U_full_step_init_all(b), nvar, k, j, 0, n1-1, U_full_step_init_s);
+                    ZoneTiles::load(member, P_sub_step_init_all(b), nvar, k, j, 0, n1-1, P_sub_step_init_s);
+                    ZoneTiles::load(member, flux_src_all(b), nvar, k, j, 0, n1-1, flux_src_s);
+                    // The initial guess for implicit variables is their state at the beginning of the sub-step
+                    ZoneTiles::load(member, (iter == 1) ? P_sub_step_init_all(b) : P_solver_all(b),
+                                    nfvar, k, j, 0, n1-1, P_solver_s);
+                    for(int ip=nfvar; ip < nvar; ++ip) {
+                        parthenon::par_for_inner(member, 0, n1-1,
+                            [&](const int& i) {
+                                P_solver_s(i, ip) = P_solver_all(b)(ip, k, j, i);
+                            }
+                        );
+                    }
+                    for(int ip=0; ip < nvar; ++ip) {
+                        parthenon::par_for_inner(member, 0, n1-1,
+                            [&](const int& i) {
+                                tmp1_s(i, ip) = 0.;
+                                tmp3_s(i, ip) = 0.;
+                            }
+                        );
+                    }
                     parthenon::par_for_inner(member, 0, n1-1,
                         [&](const int& i) {
-                            P_full_step_init_s(i, ip) = P_full_step_init_all(b)(ip, k, j, i);
-                            U_full_step_init_s(i, ip) = U_full_step_init_all(b)(ip, k, j, i);
-                            P_sub_step_init_s(i, ip)  = P_sub_step_init_all(b)(ip, k, j, i);
-                            U_sub_step_init_s(i, ip)  = U_sub_step_init_all(b)(ip, k, j, i);
-                            flux_src_s(i, ip)         = flux_src_all(b)(ip, k, j, i);
-                            P_solver_s(i, ip)         = P_solver_all(b)(ip, k, j, i);
-                            P_linesearch_s(i, ip)     = P_linesearch_all(b)(ip, k, j, i);
-                            dU_implicit_s(i, ip)      = 0.;
-                            tmp1_s(i, ip) = 0.;
-                            tmp3_s(i, ip) = 0.;
-
-                            // TODO these are run repeatedly a bunch of times
-                            solve_norm_s(i) = 0.;
-                            if (iter == 1) {
+                            // Keep the last norm around for any zones we don't iterate
+                            solve_norm_s(i) = (iter == 1) ? 0. : solve_norm_all(b, 0, k, j, i);
+                            batch_pending_s(i) = 0;
+                            // Zones which don't take a step solve the identity, so every lane of a batch is valid
+                            if (batched_solve) {
+                                FLOOP {
+                                    for (int jp=0; jp < nfvar; ++jp)
+                                        jacobian_b_s(ip, jp, i) = (ip == jp) ? 1. : 0.;
+                                    delta_prim_b_s(ip, i) = 0.;
+                                }
+                            }
+                            if (iter == 1 && !adaptive) {
                                 // New beginnings
                                 solve_fail_s(i) = SolverStatus::converged;
                             } else {
@@ -328,253 +640,378 @@ TaskStatus Implicit::Step(MeshData<Real> *md_full_step_init, MeshData<Real> *md_
                                 // If so, we don't attempt to update it again in the implicit solver.
                                 solve_fail_s(i) = (SolverStatus) solve_fail_all(b, 0, k, j, i);
                             }
+                            // Keep the explicit update of any non-stiff zones, rather than the guess
+                            if (solve_fail_s(i) == SolverStatus::nonstiff)
+                                FLOOP P_solver_s(i, ip) = P_solver_all(b)(ip, k, j, i);
                         }
                     );
-                }
-                // For implicit only
-                for(int ip=0; ip < nfvar; ++ip) {
-                    parthenon::par_for_inner(member, 0, n1-1,
-                        [&](const int& i) {
-                            for(int jp=0; jp < nfvar; ++jp)
-                                jacobian_s(i, ip, jp) = 0.;
-                            residual_s(i, ip) = 0.;
-                            delta_prim_s(i, ip) = 0.;
-                            pivot_s(i, ip) = 0;
-                            trans_s(i, ip) = 0.;
-                            work_s(i, ip) = 0.;
-                            work_s(i, ip+nfvar) = 0.;
-                            tmp2_s(i, ip) = 0.;
-                        }
-                    );
-                }
-                member.team_barrier();
+                    // For implicit only
+                    for(int ip=0; ip < nfvar; ++ip) {
+                        parthenon::par_for_inner(member, 0, n1-1,
+                            [&](const int& i) {
+                                if (ip < jac_n)
+                                    for(int jp=0; jp < jac_n; ++jp)
+                                        jacobian_s(i, ip, jp) = 0.;
+                                residual_s(i, ip) = 0.;
+                                delta_prim_s(i, ip) = 0.;
+                                if (ip < jac_n) {
+                                    pivot_s(i, ip) = 0;
+                                    trans_s(i, ip) = 0.;
+                                    work_s(i, ip) = 0.;
+                                    work_s(i, ip+jac_n) = 0.;
+                                }
+                                dU_implicit_s(i, ip) = 0.;
+                                tmp2_s(i, ip) = 0.;
+                            }
+                        );
+                    }
+                    member.team_barrier();
 
-                parthenon::par_for_inner(member, ib.s, ib.e,
-                    [&](const int& i) {
-                        // Lots of slicing.  This still ends up faster & cleaner than alternatives I tried
-                        auto P_full_step_init = Kokkos::subview(P_full_step_init_s, i, Kokkos::ALL());
-                        auto U_full_step_init = Kokkos::subview(U_full_step_init_s, i, Kokkos::ALL());
+                    // Backtracking, linesearch & update of the guess in zone i, once delta_prim holds the Newton step.
+                    // Called just after each zone's solve, or after the batched solve of the row (implicit/batched_solve)
+                    const auto update_zone = [&](const int& i, const EMHD::SourceTerms& emhd_terms) {
                         auto P_sub_step_init  = Kokkos::subview(P_sub_step_init_s, i, Kokkos::ALL());
-                        auto U_sub_step_init  = Kokkos::subview(U_sub_step_init_s, i, Kokkos::ALL());
+                        auto U_full_step_init = Kokkos::subview(U_full_step_init_s, i, Kokkos::ALL());
                         auto flux_src         = Kokkos::subview(flux_src_s, i, Kokkos::ALL());
                         auto P_solver         = Kokkos::subview(P_solver_s, i, Kokkos::ALL());
-                        auto P_linesearch     = Kokkos::subview(P_linesearch_s, i, Kokkos::ALL());
-                        // Solver variables
-                        auto residual   = Kokkos::subview(residual_s, i, Kokkos::ALL());
-                        auto jacobian   = Kokkos::subview(jacobian_s, i, Kokkos::ALL(), Kokkos::ALL());
-                        auto delta_prim = Kokkos::subview(delta_prim_s, i, Kokkos::ALL());
-                        auto pivot      = Kokkos::subview(pivot_s, i, Kokkos::ALL());
-                        auto trans      = Kokkos::subview(trans_s, i, Kokkos::ALL());
-                        auto work       = Kokkos::subview(work_s, i, Kokkos::ALL());
-                        // Temporaries
-                        auto tmp1  = Kokkos::subview(tmp1_s, i, Kokkos::ALL());
-                        auto tmp2  = Kokkos::subview(tmp2_s, i, Kokkos::ALL());
-                        auto tmp3  = Kokkos::subview(tmp3_s, i, Kokkos::ALL());
-                        // Implicit sources at starting state
-                        auto dU_implicit = Kokkos::subview(dU_implicit_s, i, Kokkos::ALL());
-                        // Solver performance diagnostics
-                        auto solve_norm = Kokkos::subview(solve_norm_s, i);
-                        auto solve_fail = Kokkos::subview(solve_fail_s, i);
-
-                        // Perform the solve only if it hadn't failed in any of the previous iterations.
-                        if (solve_fail() != SolverStatus::fail) {
-                            // Now that we know that it isn't a bad zone, reset solve_fail for this iteration
-                            solve_fail() = SolverStatus::converged;
-
-                            if (m_p.Q >= 0 || m_p.DP >= 0) {
-                                Real dUq, dUdP;
-                                EMHD::implicit_sources(G, P_full_step_init, P_sub_step_init, m_p, gam, k, j, i,
-                                                emhd_params_sub_step_init, dUq, dUdP);
-                                if (emhd_params_sub_step_init.conduction)
-                                    dU_implicit(m_u.Q) = dUq;
-                                if (emhd_params_sub_step_init.viscosity)
-                                    dU_implicit(m_u.DP) = dUdP;
-                            }
-
-                            // Copy `solver` prims to `linesearch`. This doesn't matter for the first step of the solver
-                            // since we do a copy in imex_driver just before, but it is required for the subsequent
-                            // iterations of the solver.
-                            PLOOP P_linesearch(ip) = P_solver(ip);
-
-                            // Jacobian calculation
-                            // Requires calculating the residual anyway, so we grab it here
-                            calc_jacobian(G, P_solver, P_full_step_init, U_full_step_init, P_sub_step_init, 
-                                        flux_src, dU_implicit, tmp1, tmp2, tmp3, m_p, m_u, emhd_params_solver,
-                                        emhd_params_sub_step_init, nvar, nfvar, k, j, i, delta, gam, dt, jacobian, residual);
-                            // Solve against the negative residual
-                            FLOOP delta_prim(ip) = -residual(ip);
-#if 0
+                        auto residual         = Kokkos::subview(residual_s, i, Kokkos::ALL());
+                        auto delta_prim       = Kokkos::subview(delta_prim_s, i, Kokkos::ALL());
+                        auto P_linesearch     = Kokkos::subview(tmp1_s, i, Kokkos::ALL());
+                        auto tmp3             = Kokkos::subview(tmp3_s, i, Kokkos::ALL());
+                        auto dU_implicit      = Kokkos::subview(dU_implicit_s, i, Kokkos::ALL());
+                        auto solve_norm       = Kokkos::subview(solve_norm_s, i);
+                        auto solve_fail       = Kokkos::subview(solve_fail_s, i);
+
+                        // Check for positive definite values of density and internal energy.
+                        // Ignore zone if manual backtracking is not sufficient.
+                        // The primitives will be averaged over good neighbors.
+                        Real lambda = linesearch_lambda;
+                        if (fluid_implicit && ((P_solver(m_p.RHO) + lambda*delta_prim(m_p.RHO) < 0.) || (P_solver(m_p.UU) + lambda*delta_prim(m_p.UU) < 0.))) {
+                            solve_fail() = SolverStatus::backtrack;
+                            lambda       = 0.1;
+                        }
+                        if (fluid_implicit && ((P_solver(m_p.RHO) + lambda*delta_prim(m_p.RHO) < 0.) || (P_solver(m_p.UU) + lambda*delta_prim(m_p.UU) < 0.))) {
+                            solve_fail() = SolverStatus::fail;
+                            // break; // Doesn't break from the inner par_for. 
+                            // Instead we set all fluid primitives to value at beginning of substep.
+                            // We average over neighboring good zones later.
+                            FLOOP P_solver(ip) = P_sub_step_init(ip);
                         }
-                    }
-                );
-                member.team_barrier();
-                parthenon::par_for_inner(member, ib.s, ib.e,
-                    [&](const int& i) {
-                        // Solver variables
-                        auto residual   = Kokkos::subview(residual_s, i, Kokkos::ALL());
-                        auto jacobian   = Kokkos::subview(jacobian_s, i, Kokkos::ALL(), Kokkos::ALL());
-                        auto delta_prim = Kokkos::subview(delta_prim_s, i, Kokkos::ALL());
-                        auto pivot      = Kokkos::subview(pivot_s, i, Kokkos::ALL());
-                        auto trans      = Kokkos::subview(trans_s, i, Kokkos::ALL());
-                        auto work       = Kokkos::subview(work_s, i, Kokkos::ALL());
-                        auto solve_fail = Kokkos::subview(solve_fail_s, i);
 
+                        // If the solver failed, we don't want to update the implicit primitives for those zones
                         if (solve_fail() != SolverStatus::fail) {
-#endif
-                            if (use_qr) {
-                                // Linear solve by QR decomposition
-                                KokkosBatched::SerialQR<KokkosBatched::Algo::QR::Unblocked>::invoke(jacobian, trans, pivot, work);
-                                KokkosBatched::SerialApplyQ<KokkosBatched::Side::Left, KokkosBatched::Trans::Transpose,
-                                                            KokkosBatched::Algo::ApplyQ::Unblocked>
-                                ::invoke(jacobian, trans, delta_prim, work);
-                            } else {
-                                KokkosBatched::SerialLU<KokkosBatched::Algo::LU::Unblocked>::invoke(jacobian, tiny);
-                            }
-                            KokkosBatched::SerialTrsv<KokkosBatched::Uplo::Upper, KokkosBatched::Trans::NoTranspose, 
-                                                    KokkosBatched::Diag::NonUnit, KokkosBatched::Algo::Trsv::Unblocked>
-                            ::invoke(alpha, jacobian, delta_prim);
-                            if (use_qr) {
-                                // Linear solve by QR decomposition
-                                KokkosBatched::SerialApplyPivot<KokkosBatched::Side::Left,KokkosBatched::Direct::Backward>
-                                    ::invoke(pivot, delta_prim);
-                            }
-#if 0
-                        }
-                    }
-                );
-                member.team_barrier();
+                            // Linesearch
+                            if (linesearch) {
+                                solve_norm()        = 0;
+                                FLOOP solve_norm() += residual(ip) * residual(ip);
+                                solve_norm()        = m::sqrt(solve_norm());
 
-                parthenon::par_for_inner(member, ib.s, ib.e,
-                    [&](const int& i) {
-                        // Lots of slicing.  This still ends up faster & cleaner than alternatives I tried
-                        auto P_full_step_init = Kokkos::subview(P_full_step_init_s, i, Kokkos::ALL());
-                        auto U_full_step_init = Kokkos::subview(U_full_step_init_s, i, Kokkos::ALL());
-                        auto P_sub_step_init  = Kokkos::subview(P_sub_step_init_s, i, Kokkos::ALL());
-                        auto U_sub_step_init  = Kokkos::subview(U_sub_step_init_s, i, Kokkos::ALL());
-                        auto flux_src         = Kokkos::subview(flux_src_s, i, Kokkos::ALL());
-                        auto P_solver         = Kokkos::subview(P_solver_s, i, Kokkos::ALL());
-                        auto P_linesearch     = Kokkos::subview(P_linesearch_s, i, Kokkos::ALL());
-                        // Solver variables
-                        auto residual   = Kokkos::subview(residual_s, i, Kokkos::ALL());
-                        auto jacobian   = Kokkos::subview(jacobian_s, i, Kokkos::ALL(), Kokkos::ALL());
-                        auto delta_prim = Kokkos::subview(delta_prim_s, i, Kokkos::ALL());
-                        auto pivot      = Kokkos::subview(pivot_s, i, Kokkos::ALL());
-                        auto trans      = Kokkos::subview(trans_s, i, Kokkos::ALL());
-                        auto work       = Kokkos::subview(work_s, i, Kokkos::ALL());
-                        // Temporaries
-                        auto tmp1  = Kokkos::subview(tmp1_s, i, Kokkos::ALL());
-                        auto tmp2  = Kokkos::subview(tmp2_s, i, Kokkos::ALL());
-                        auto tmp3  = Kokkos::subview(tmp3_s, i, Kokkos::ALL());
-                        // Implicit sources at starting state
-                        auto dU_implicit = Kokkos::subview(dU_implicit_s, i, Kokkos::ALL());
-                        // Solver performance diagnostics
-                        auto solve_norm = Kokkos::subview(solve_norm_s, i);
-                        auto solve_fail = Kokkos::subview(solve_fail_s, i);
+                                Real f0      = 0.5 * solve_norm();
+                                Real fprime0 = -2. * f0;
 
-                        if (solve_fail() != SolverStatus::fail) {
-#endif
-                            // Check for positive definite values of density and internal energy.
-                            // Ignore zone if manual backtracking is not sufficient.
-                            // The primitives will be averaged over good neighbors.
-                            Real lambda = linesearch_lambda;
-                            if ((P_solver(m_p.RHO) + lambda*delta_prim(m_p.RHO) < 0.) || (P_solver(m_p.UU) + lambda*delta_prim(m_p.UU) < 0.)) {
-                                solve_fail() = SolverStatus::backtrack;
-                                lambda       = 0.1;
-                            }
-                            if ((P_solver(m_p.RHO) + lambda*delta_prim(m_p.RHO) < 0.) || (P_solver(m_p.UU) + lambda*delta_prim(m_p.UU) < 0.)) {
-                                solve_fail() = SolverStatus::fail;
-                                // break; // Doesn't break from the inner par_for. 
-                                // Instead we set all fluid primitives to value at beginning of substep.
-                                // We average over neighboring good zones later.
-                                FLOOP P_solver(ip) = P_sub_step_init(ip);
-                            }
+                                for (int linesearch_iter = 0; linesearch_iter < max_linesearch_iter; linesearch_iter++) {
+                                    if (record_linesearch) solve_linesearch_all(b, 0, k, j, i) += 1.;
+                                    // Take step
+                                    FLOOP P_linesearch(ip) = P_solver(ip) + (lambda * delta_prim(ip));
+
+                                    // Compute solve_norm of the residual (loss function)
+                                    calc_residual(G, P_linesearch, U_full_step_init, flux_src,
+                                                dU_implicit, tmp3, m_p, m_u, emhd_params_linesearch, emhd_params_solver, emhd_terms,
+                                                nfvar, j, i, gam, dt, residual);
 
-                            // If the solver failed, we don't want to update the implicit primitives for those zones
-                            if (solve_fail() != SolverStatus::fail) {
-                                // Linesearch
-                                if (linesearch) {
                                     solve_norm()        = 0;
                                     FLOOP solve_norm() += residual(ip) * residual(ip);
                                     solve_norm()        = m::sqrt(solve_norm());
+                                    Real f1             = 0.5 * solve_norm();
 
-                                    Real f0      = 0.5 * solve_norm();
-                                    Real fprime0 = -2. * f0;
+                                    // Compute new step length
+                                    int condition   = f1 > (f0 * (1. - linesearch_eps * lambda) + SMALL);
+                                    Real denom      = (f1 - f0 - (fprime0 * lambda)) * condition + (1 - condition);
+                                    Real lambda_new = -fprime0 * lambda * lambda / denom / 2.;
+                                    lambda          = lambda * (1 - condition) + (condition * lambda_new);
 
-                                    for (int linesearch_iter = 0; linesearch_iter < max_linesearch_iter; linesearch_iter++) {
-                                        // Take step
-                                        FLOOP P_linesearch(ip) = P_solver(ip) + (lambda * delta_prim(ip));
+                                    // Check if new solution has converged within required tolerance
+                                    if (condition == 0) break;                           
+                                }
+                            }
 
-                                        // Compute solve_norm of the residual (loss function)
-                                        calc_residual(G, P_linesearch, P_full_step_init, U_full_step_init, P_sub_step_init, flux_src,
-                                                    dU_implicit, tmp3, m_p, m_u, emhd_params_linesearch, emhd_params_solver, nfvar,
-                                                    k, j, i, gam, dt, residual);
+                            // Update the guess
+                            FLOOP P_solver(ip) += lambda * delta_prim(ip);
 
-                                        solve_norm()        = 0;
-                                        FLOOP solve_norm() += residual(ip) * residual(ip);
-                                        solve_norm()        = m::sqrt(solve_norm());
-                                        Real f1             = 0.5 * solve_norm();
+                            calc_residual(G, P_solver, U_full_step_init, flux_src, dU_implicit, tmp3,
+                                        m_p, m_u, emhd_params_solver, emhd_params_sub_step_init, emhd_terms, nfvar, j, i, gam, dt, residual);
 
-                                        // Compute new step length
-                                        int condition   = f1 > (f0 * (1. - linesearch_eps * lambda) + SMALL);
-                                        Real denom      = (f1 - f0 - (fprime0 * lambda)) * condition + (1 - condition);
-                                        Real lambda_new = -fprime0 * lambda * lambda / denom / 2.;
-                                        lambda          = lambda * (1 - condition) + (condition * lambda_new);
+                            // Store for maximum/output
+                            // I would be tempted to store the whole residual, but it's of variable size
+                            solve_norm()        = 0;
+                            FLOOP solve_norm() += residual(ip) * residual(ip);
+                            solve_norm()        = m::sqrt(solve_norm()); // TODO faster to scratch cache & copy?
 
-                                        // Check if new solution has converged within required tolerance
-                                        if (condition == 0) break;                           
-                                    }
+                            // Did we converge to required tolerance? If not, update solve_fail accordingly
+                            if (solve_norm() > rootfind_tol) {
+                                solve_fail() = SolverStatus::beyond_tol; // TODO was changed from +=. Valid?
+                            }
+                        }
+                    };
+
+                    parthenon::par_for_inner(member, ib.s, ib.e,
+                        [&](const int& i) {
+                            // Lots of slicing.  This still ends up faster & cleaner than alternatives I tried
+                            auto P_full_step_init = Kokkos::subview(P_full_step_init_s, i, Kokkos::ALL());
+                            auto U_full_step_init = Kokkos::subview(U_full_step_init_s, i, Kokkos::ALL());
+                            auto P_sub_step_init  = Kokkos::subview(P_sub_step_init_s, i, Kokkos::ALL());
+                            auto flux_src         = Kokkos::subview(flux_src_s, i, Kokkos::ALL());
+                            auto P_solver         = Kokkos::subview(P_solver_s, i, Kokkos::ALL());
+                            // Solver variables
+                            auto residual   = Kokkos::subview(residual_s, i, Kokkos::ALL());
+                            auto jacobian   = Kokkos::subview(jacobian_s, i, Kokkos::ALL(), Kokkos::ALL());
+                            auto delta_prim = Kokkos::subview(delta_prim_s, i, Kokkos::ALL());
+                            auto pivot      = Kokkos::subview(pivot_s, i, Kokkos::ALL());
+                            auto trans      = Kokkos::subview(trans_s, i, Kokkos::ALL());
+                            auto work       = Kokkos::subview(work_s, i, Kokkos::ALL());
+                            // Temporaries
+                            auto tmp1  = Kokkos::subview(tmp1_s, i, Kokkos::ALL());
+                            auto& P_linesearch = tmp1;
+                            auto tmp2  = Kokkos::subview(tmp2_s, i, Kokkos::ALL());
+                            auto tmp3  = Kokkos::subview(tmp3_s, i, Kokkos::ALL());
+                            // Implicit sources at starting state
+                            auto dU_implicit = Kokkos::subview(dU_implicit_s, i, Kokkos::ALL());
+                            // Solver performance diagnostics
+                            auto solve_norm = Kokkos::subview(solve_norm_s, i);
+                            auto solve_fail = Kokkos::subview(solve_fail_s, i);
+
+                            // Perform the solve only if it hadn't failed in any of the previous iterations,
+                            // and optionally only if it hasn't yet converged.
+                            const bool skip = (skip_converged && iter > iter_min && solve_fail() == SolverStatus::converged) ||
+                                              solve_fail() == SolverStatus::nonstiff;
+                            const bool reuse_factors = chord && iter > 1;
+                            if (solve_fail() != SolverStatus::fail && !skip) {
+                                solve_iters_all(b, 0, k, j, i) = (iter == 1) ? 1. : solve_iters_all(b, 0, k, j, i) + 1.;
+                                if (record_linesearch && iter == 1) solve_linesearch_all(b, 0, k, j, i) = 0.;
+                                // Now that we know that it isn't a bad zone, reset solve_fail for this iteration
+                                solve_fail() = SolverStatus::converged;
+
+                                // EMHD closure parameters & 4-vectors of the initial states, shared by every
+                                // residual evaluated in this zone: Jacobian columns, linesearch, and final check
+                                EMHD::SourceTerms emhd_terms;
+                                if (m_p.Q >= 0 || m_p.DP >= 0) {
+                                    EMHD::source_terms(G, P_full_step_init, P_sub_step_init, m_p, emhd_params_sub_step_init,
+                                                    gam, j, i, emhd_terms);
+                                    Real dUq, dUdP;
+                                    EMHD::implicit_sources(G, P_full_step_init, m_p, j, i,
+                                                    emhd_params_sub_step_init, emhd_terms, dUq, dUdP);
+                                    if (emhd_params_sub_step_init.conduction)
+                                        dU_implicit(m_u.Q) = dUq;
+                                    if (emhd_params_sub_step_init.viscosity)
+                                        dU_implicit(m_u.DP) = dUdP;
                                 }
 
-                                // Update the guess
-                                FLOOP P_solver(ip) += lambda * delta_prim(ip);
+                                if (register_solve) {
+                                    // Jacobian calculation & linear solve entirely in this thread's registers/stack
+                                    SmallMatrix<IMPLICIT_MAX_NFVAR> jacobian_l;
+                                    calc_jacobian(G, P_solver, P_full_step_init, U_full_step_init, P_sub_step_init,
+                                                flux_src, dU_implicit, tmp1, tmp2, tmp3, m_p, m_u, emhd_params_solver,
+                                                emhd_params_sub_step_init, emhd_terms, nvar, nfvar, k, j, i, delta, gam, dt, jacobian_l, residual);
+                                    FLOOP delta_prim(ip) = -residual(ip);
+                                    // Don't step at all from a singular Jacobian, leave the zone to the usual tolerance check
+                                    bool solved = true;
+                                    if (batched_solve) {
+                                        // Leave the system for the batched solve of the row, below
+                                        FLOOP {
+                                            for (int jp=0; jp < nfvar; ++jp)
+                                                jacobian_b_s(ip, jp, i) = jacobian_l(ip, jp);
+                                            delta_prim_b_s(ip, i) = delta_prim(ip);
+                                        }
+                                    } else if (mixed_precision) {
+                                        SmallMatrix<IMPLICIT_MAX_NFVAR, float> jacobian_f;
+                                        SmallVector<IMPLICIT_MAX_NFVAR, float> delta_prim_f;
+                                        FLOOP {
+                                            for (int jp=0; jp < nfvar; ++jp)
+                                                jacobian_f(ip, jp) = (float) jacobian_l(ip, jp);
+                                            delta_prim_f(ip) = (float) delta_prim(ip);
+                                        }
+                                        solved = small_lu_solve(jacobian_f, nfvar, delta_prim_f, (float) tiny);
+                                        FLOOP delta_prim(ip) = delta_prim_f(ip);
+                                    } else {
+                                        solved = small_lu_solve(jacobian_l, nfvar, delta_prim, tiny);
+                                    }
+                                    if (!solved) {
+                                        FLOOP delta_prim(ip) = 0.;
+                                    }
+                                } else {
+                                    if (reuse_factors) {
+                                        // Chord iteration: recover the factored Jacobian from the first iteration,
+                                        // and just evaluate the residual at the new guess
+                                        FLOOP {
+                                            for (int jp=0; jp < nfvar; ++jp)
+                                                jacobian(ip, jp) = solve_factors_all(b, ip*nfvar + jp, k, j, i);
+                                            trans(ip) = solve_factors_all(b, nfvar*nfvar + ip, k, j, i);
+                                            pivot(ip) = (int) solve_factors_all(b, nfvar*nfvar + nfvar + ip, k, j, i);
+                                        }
+                                        calc_residual(G, P_solver, U_full_step_init, flux_src, dU_implicit, tmp3,
+                                                    m_p, m_u, emhd_params_solver, emhd_params_sub_step_init, emhd_terms, nfvar, j, i, gam, dt, residual);
+                                    } else {
+                                        // Jacobian calculation
+                                        // Requires calculating the residual anyway, so we grab it here
+                                        calc_jacobian(G, P_solver, P_full_step_init, U_full_step_init, P_sub_step_init, 
+                                                    flux_src, dU_implicit, tmp1, tmp2, tmp3, m_p, m_u, emhd_params_solver,
+                                                    emhd_params_sub_step_init, emhd_terms, nvar, nfvar, k, j, i, delta, gam, dt, jacobian, residual);
+                                    }
+                                    // Solve against the negative residual
+                                    FLOOP delta_prim(ip) = -residual(ip);
+                                }
+                                // `linesearch` prims start from `solver` prims.  They share scratch with the
+                                // Jacobian temporaries, so this can only be set now
+                                PLOOP P_linesearch(ip) = P_solver(ip);
+                                if (!register_solve) {
+    #if 0
+                            }
+                        }
+                    );
+                    member.team_barrier();
+                    parthenon::par_for_inner(member, ib.s, ib.e,
+                        [&](const int& i) {
+                            // Solver variables
+                            auto residual   = Kokkos::subview(residual_s, i, Kokkos::ALL());
+                            auto jacobian   = Kokkos::subview(jacobian_s, i, Kokkos::ALL(), Kokkos::ALL());
+                            auto delta_prim = Kokkos::subview(delta_prim_s, i, Kokkos::ALL());
+                            auto pivot      = Kokkos::subview(pivot_s, i, Kokkos::ALL());
+                            auto trans      = Kokkos::subview(trans_s, i, Kokkos::ALL());
+                            auto work       = Kokkos::subview(work_s, i, Kokkos::ALL());
+                            auto solve_fail = Kokkos::subview(solve_fail_s, i);
 
-                                calc_residual(G, P_solver, P_full_step_init, U_full_step_init, P_sub_step_init, flux_src, dU_implicit, tmp3,
-                                            m_p, m_u, emhd_params_solver, emhd_params_sub_step_init, nfvar, k, j, i, gam, dt, residual);
+                            if (solve_fail() != SolverStatus::fail) {
+    #endif
+                                    if (use_qr) {
+                                        // Linear solve by QR decomposition
+                                        if (!reuse_factors)
+                                            KokkosBatched::SerialQR<KokkosBatched::Algo::QR::Unblocked>::invoke(jacobian, trans, pivot, work);
+                                        KokkosBatched::SerialApplyQ<KokkosBatched::Side::Left, KokkosBatched::Trans::Transpose,
+                                                                    KokkosBatched::Algo::ApplyQ::Unblocked>
+                                        ::invoke(jacobian, trans, delta_prim, work);
+                                    } else if (!reuse_factors) {
+                                        KokkosBatched::SerialLU<KokkosBatched::Algo::LU::Unblocked>::invoke(jacobian, tiny);
+                                    }
+                                    // Keep the factors from the first iteration for the rest
+                                    if (chord && iter == 1) {
+                                        FLOOP {
+                                            for (int jp=0; jp < nfvar; ++jp)
+                                                solve_factors_all(b, ip*nfvar + jp, k, j, i) = jacobian(ip, jp);
+                                            solve_factors_all(b, nfvar*nfvar + ip, k, j, i) = trans(ip);
+                                            solve_factors_all(b, nfvar*nfvar + nfvar + ip, k, j, i) = (Real) pivot(ip);
+                                        }
+                                    }
+                                    KokkosBatched::SerialTrsv<KokkosBatched::Uplo::Upper, KokkosBatched::Trans::NoTranspose, 
+                                                            KokkosBatched::Diag::NonUnit, KokkosBatched::Algo::Trsv::Unblocked>
+                                    ::invoke(alpha, jacobian, delta_prim);
+                                    if (use_qr) {
+                                        // Linear solve by QR decomposition
+                                        KokkosBatched::SerialApplyPivot<KokkosBatched::Side::Left,KokkosBatched::Direct::Backward>
+                                            ::invoke(pivot, delta_prim);
+                                    }
+                                }
+    #if 0
+                            }
+                        }
+                    );
+                    member.team_barrier();
 
-                                // Store for maximum/output
-                                // I would be tempted to store the whole residual, but it's of variable size
-                                solve_norm()        = 0;
-                                FLOOP solve_norm() += residual(ip) * residual(ip);
-                                solve_norm()        = m::sqrt(solve_norm()); // TODO faster to scratch cache & copy?
+                    parthenon::par_for_inner(member, ib.s, ib.e,
+                        [&](const int& i) {
+                            // Lots of slicing.  This still ends up faster & cleaner than alternatives I tried
+                            auto P_full_step_init = Kokkos::subview(P_full_step_init_s, i, Kokkos::ALL());
+                            auto U_full_step_init = Kokkos::subview(U_full_step_init_s, i, Kokkos::ALL());
+                            auto P_sub_step_init  = Kokkos::subview(P_sub_step_init_s, i, Kokkos::ALL());
+                            auto flux_src         = Kokkos::subview(flux_src_s, i, Kokkos::ALL());
+                            auto P_solver         = Kokkos::subview(P_solver_s, i, Kokkos::ALL());
+                            // Solver variables
+                            auto residual   = Kokkos::subview(residual_s, i, Kokkos::ALL());
+                            auto jacobian   = Kokkos::subview(jacobian_s, i, Kokkos::ALL(), Kokkos::ALL());
+                            auto delta_prim = Kokkos::subview(delta_prim_s, i, Kokkos::ALL());
+                            auto pivot      = Kokkos::subview(pivot_s, i, Kokkos::ALL());
+                            auto trans      = Kokkos::subview(trans_s, i, Kokkos::ALL());
+                            auto work       = Kokkos::subview(work_s, i, Kokkos::ALL());
+                            // Temporaries
+                            auto tmp1  = Kokkos::subview(tmp1_s, i, Kokkos::ALL());
+                            auto& P_linesearch = tmp1;
+                            auto tmp2  = Kokkos::subview(tmp2_s, i, Kokkos::ALL());
+                            auto tmp3  = Kokkos::subview(tmp3_s, i, Kokkos::ALL());
+                            // Implicit sources at starting state
+                            auto dU_implicit = Kokkos::subview(dU_implicit_s, i, Kokkos::ALL());
+                            // Solver performance diagnostics
+                            auto solve_norm = Kokkos::subview(solve_norm_s, i);
+                            auto solve_fail = Kokkos::subview(solve_fail_s, i);
 
-                                // Did we converge to required tolerance? If not, update solve_fail accordingly
-                                if (solve_norm() > rootfind_tol) {
-                                    solve_fail() = SolverStatus::beyond_tol; // TODO was changed from +=. Valid?
+                            if (solve_fail() != SolverStatus::fail) {
+    #endif
+                                if (batched_solve) {
+                                    // Finished below, once the whole row is solved
+                                    batch_pending_s(i) = 1;
+                                } else {
+                                    update_zone(i, emhd_terms);
                                 }
                             }
                         }
+                    );
+                    member.team_barrier();
+
+                    if (batched_solve) {
+                        // Solve the row's systems in lockstep, batch_width zones at a time
+                        const int nbatch = (ib.e - ib.s + batch_width) / batch_width;
+                        Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nbatch),
+                            [&](const int& w) {
+                                const int l0 = ib.s + w * batch_width;
+                                batched_lu_solve(jacobian_b_s, nfvar, l0, m::min(batch_width, ib.e + 1 - l0),
+                                                 delta_prim_b_s, batch_singular_s, tiny);
+                            }
+                        );
+                        member.team_barrier();
+                        // Then finish each zone which took a step.  Its closure terms weren't kept, so recompute them
+                        parthenon::par_for_inner(member, ib.s, ib.e,
+                            [&](const int& i) {
+                                if (batch_pending_s(i)) {
+                                    auto P_full_step_init = Kokkos::subview(P_full_step_init_s, i, Kokkos::ALL());
+                                    auto P_sub_step_init  = Kokkos::subview(P_sub_step_init_s, i, Kokkos::ALL());
+                                    FLOOP delta_prim_s(i, ip) = delta_prim_b_s(ip, i);
+                                    EMHD::SourceTerms emhd_terms;
+                                    if (m_p.Q >= 0 || m_p.DP >= 0)
+                                        EMHD::source_terms(G, P_full_step_init, P_sub_step_init, m_p, emhd_params_sub_step_init,
+                                                        gam, j, i, emhd_terms);
+                                    update_zone(i, emhd_terms);
+                                }
+                            }
+                        );
+                        member.team_barrier();
                     }
-                );
-                member.team_barrier();
 
-                // Copy out P_solver to the existing array.
-                // We'll copy even the values for the failed zones because it doesn't really matter, it'll be averaged over later.
-                // And copy any other diagnostics that are relevant to analyze the solver's performance
-                FLOOP {
+                    // Copy out P_solver to the existing array.
+                    // We'll copy even the values for the failed zones because it doesn't really matter, it'll be averaged over later.
+                    // And copy any other diagnostics that are relevant to analyze the solver's performance
+                    ZoneTiles::store(member, P_solver_s, nfvar, k, j, ib.s, ib.e, P_solver_all(b));
                     parthenon::par_for_inner(member, ib.s, ib.e,
                         [&](const int& i) {
-                            P_solver_all(b)(ip, k, j, i) = P_solver_s(i, ip);
+                            solve_norm_all(b, 0, k, j, i) = solve_norm_s(i);
+                            solve_fail_all(b, 0, k, j, i) = (Real) solve_fail_s(i);
                         }
                     );
                 }
-                parthenon::par_for_inner(member, ib.s, ib.e,
-                    [&](const int& i) {
-                        solve_norm_all(b, 0, k, j, i) = solve_norm_s(i);
-                        solve_fail_all(b, 0, k, j, i) = (Real) solve_fail_s(i);
-                    }
-                );
-            }
-        );
+            );
+        }
 
         // If we need to print or exit on the max norm...
         if (iter >= iter_min || verbose >= 1) {
             // Take the maximum L2 norm on this rank
             Real lmax_norm = 0.0;
-            pmb_sub_step_init->par_reduce("max_norm", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-                KOKKOS_LAMBDA (const int& b, const int& k, const int& j, const int& i, Real& local_result) {
-                    if (solve_norm_all(b, 0, k, j, i) > local_result) local_result = solve_norm_all(b, 0, k, j, i);
-                }
-            , Kokkos::Max<Real>(lmax_norm));
+            for (const auto &box : boxes) {
+                const IndexRange ib = box[0], jb = box[1], kb = box[2];
+                Real lmax_box = 0.0;
+                pmb_sub_step_init->par_reduce("max_norm", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+                    KOKKOS_LAMBDA (const int& b, const int& k, const int& j, const int& i, Real& local_result) {
+                        if (solve_norm_all(b, 0, k, j, i) > local_result) local_result = solve_norm_all(b, 0, k, j, i);
+                    }
+                , Kokkos::Max<Real>(lmax_box));
+                lmax_norm = m::max(lmax_norm, lmax_box);
+            }
             // Then MPI AllReduce to copy the global max to every rank
             Reductions::StartToAll<Real>(md_solver, 4, lmax_norm, MPI_MAX);
             Real max_norm = Reductions::CheckOnAll<Real>(md_solver, 4);
@@ -582,11 +1019,16 @@ TaskStatus Implicit::Step(MeshData<Real> *md_full_step_init, MeshData<Real> *md_
             if (verbose >= 1) {
                 // Count total number of solver fails
                 int lnfails = 0;
-                pmb_sub_step_init->par_reduce("count_solver_fails", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-                    KOKKOS_LAMBDA (const int& b, const int& k, const int& j, const int& i, int& local_result) {
-                        if ((SolverStatus) solve_fail_all(b, 0, k, j, i) == SolverStatus::fail) ++local_result;
-                    }
-                , Kokkos::Sum<int>(lnfails));
+                for (const auto &box : boxes) {
+                    const IndexRange ib = box[0], jb = box[1], kb = box[2];
+                    int lnfails_box = 0;
+                    pmb_sub_step_init->par_reduce("count_solver_fails", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+                        KOKKOS_LAMBDA (const int& b, const int& k, const int& j, const int& i, int& local_result) {
+                            if ((SolverStatus) solve_fail_all(b, 0, k, j, i) == SolverStatus::fail) ++local_result;
+                        }
+                    , Kokkos::Sum<int>(lnfails_box));
+                    lnfails += lnfails_box;
+                }
                 // Then reduce to rank 0 to print the iteration by iteration
                 Reductions::Start<int>(md_solver, 5, lnfails, MPI_SUM);
                 int nfails = Reductions::Check<int>(md_solver, 5);
@@ -626,8 +1068,32 @@ TaskStatus Implicit::PostStepDiagnostics(const SimTime& tm, MeshData<Real> *md)
 
     // Debugging/diagnostic info about implicit solver
     if (flag_verbose > 0) {
-        Reductions::StartFlagReduce(md, "solve_fail", Implicit::status_names, IndexDomain::interior, false, 2);
-        Reductions::CheckFlagReduceAndPrintHits(md, "solve_fail", Implicit::status_names, IndexDomain::interior, false, 2);
+        // With floors, solver failures are counted & reported alongside fflags, see Floors::PostStepDiagnostics
+        const bool count_fails = !pmesh->packages.AllPackages().count("Floors");
+        if (count_fails)
+            Reductions::StartFlagReduce(md, "solve_fail", Implicit::status_names, IndexDomain::interior, false, 2);
+
+        // Average number of nonlinear iterations per zone
+        auto& solve_iters = md->PackVariables(std::vector<std::string>{"solve_iters"});
+        const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+        const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+        const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+        const IndexRange block = IndexRange{0, solve_iters.GetDim(5) - 1};
+        Real liters = 0.;
+        pmb0->par_reduce("sum_solve_iters", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA (const int& b, const int& k, const int& j, const int& i, Real& local_result) {
+                local_result += solve_iters(b, 0, k, j, i);
+            }
+        , Kokkos::Sum<Real>(liters));
+        const Real lzones = (Real) (block.e - block.s + 1) * (kb.e - kb.s + 1) * (jb.e - jb.s + 1) * (ib.e - ib.s + 1);
+        Reductions::Start<std::vector<Real>>(md, 3, std::vector<Real>{liters, lzones}, MPI_SUM);
+
+        if (count_fails)
+            Reductions::CheckFlagReduceAndPrintHits(md, "solve_fail", Implicit::status_names, IndexDomain::interior, false, 2);
+        const std::vector<Real> iters = Reductions::Check<std::vector<Real>>(md, 3);
+        if (MPIRank0() && iters[1] > 0.) {
+            printf("Average implicit iterations per zone: %g\n", iters[0] / iters[1]);
+        }
     }
 
     return TaskStatus::complete;
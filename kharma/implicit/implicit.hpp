@@ -55,6 +55,12 @@ using namespace EMHD;
 // Version of PLOOP for just implicit ("fluid") variables
 #define FLOOP for(int ip=0; ip < nfvar; ++ip)
 
+// Largest implicit system solved in thread-local storage with implicit/register_solve,
+// rather than in team scratch.  Every thread holds a matrix of this size, so keep it small
+#ifndef IMPLICIT_MAX_NFVAR
+#define IMPLICIT_MAX_NFVAR 10
+#endif
+
 namespace Implicit
 {
 
@@ -65,14 +71,20 @@ namespace Implicit
 // `fail`: manual backtracking wasn't good enough. FixSolve will be called
 // `beyond_tol`: solver didn't converge to prescribed tolerance but didn't fail
 // `backtrack`: step length of 1 gave negative rho/uu, but manual backtracking (0.1) sufficed
-enum class SolverStatus{converged=0, fail, beyond_tol, backtrack};
+// `nonstiff`: tau/dt was above implicit/stiff_threshold, so the zone was updated explicitly (implicit/adaptive)
+enum class SolverStatus{converged=0, fail, beyond_tol, backtrack, nonstiff};
 
 static const std::map<int, std::string> status_names = {
     {(int) SolverStatus::fail, "failed"},
     {(int) SolverStatus::beyond_tol, "beyond tolerance"},
-    {(int) SolverStatus::backtrack, "backtrack"}
+    {(int) SolverStatus::backtrack, "backtrack"},
+    {(int) SolverStatus::nonstiff, "explicit update"}
 };
 
+// Which zones of each block to solve in a call to Step.  The "shell" is the zones within nghost of any
+// block face, i.e. those sent to neighbors in a boundary sync.  The "core" is everything else.
+enum class SolveRegion{all=0, shell, core};
+
 template <typename T>
 KOKKOS_INLINE_FUNCTION bool failed(T status_flag)
 {
@@ -91,12 +103,30 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
  * @param md_full_step_init the fluid state at the beginning of the step
  * @param md_sub_step_init the initial fluid state for this substep
  * @param md_flux_src the negative flux divergence plus explicit source terms
- * @param md_solver should contain initial guess on call, contains result on return
- * @param md_linesearch should contain solver prims at start, updated in the linesearch
+ * @param md_solver should contain any explicit updates on call, contains result on return.
+ *                  The guess for implicit variables is taken from md_sub_step_init
+ * @param md_linesearch source of package parameters for the linesearch state, which is kept in scratch
  * @param dt the timestep (current substep)
+ * @param region which zones to solve, see SolveRegion
  */
 TaskStatus Step(MeshData<Real> *md_full_step_init, MeshData<Real> *md_sub_step_init, MeshData<Real> *md_flux_src,
-                MeshData<Real> *md_linesearch, MeshData<Real> *md_solver, const Real& dt);
+                MeshData<Real> *md_linesearch, MeshData<Real> *md_solver, const Real& dt,
+                SolveRegion region);
+
+/**
+ * Get the index ranges {ib, jb, kb} of a set of boxes covering a region of the block interior
+ */
+std::vector<std::array<IndexRange, 3>> RegionBoxes(MeshData<Real> *md, SolveRegion region);
+
+/**
+ * Bytes of team scratch used by each team (row of n1 zones) of the solver kernel
+ */
+size_t ScratchBytes(int n1, int nvar, int nfvar, bool register_solve, bool batched_solve=false);
+
+/**
+ * Copy the cell-centered variables from md_from to md_to, only over a region of the block interior
+ */
+TaskStatus CopyRegion(MeshData<Real> *md_from, MeshData<Real> *md_to, SolveRegion region);
 
 /**
  * Get the names of all variables matching 'flag' in a deterministic order, placing implicitly-evolved variables first.
@@ -111,19 +141,130 @@ std::vector<std::string> GetOrderedNames(MeshBlockData<Real> *rc, const Metadata
  * @return TaskStatus 
  */
 TaskStatus FixSolve(MeshBlockData<Real> *mbd);
-inline TaskStatus MeshFixSolve(MeshData<Real> *md) {
-    Flag("MeshFixSolve");
-    for (int i=0; i < md->NumBlocks(); ++i)
-        FixSolve(md->GetBlockData(i).get());
-    EndFlag();
-    return TaskStatus::complete;
-}
+/**
+ * As FixSolve, over all blocks in md at once.
+ */
+TaskStatus MeshFixSolve(MeshData<Real> *md);
 
 /**
  * Print diagnostics about number of failed solves
  */
 TaskStatus PostStepDiagnostics(const SimTime& tm, MeshData<Real> *md);
 
+/**
+ * Square matrix of at most N x N elements, held by a single thread.
+ * Addressable like the Kokkos subviews used elsewhere, so it can be filled by calc_jacobian
+ */
+template<int N, typename T=Real>
+struct SmallMatrix {
+    T a[N][N];
+    KOKKOS_FORCEINLINE_FUNCTION T& operator()(const int& row, const int& col) { return a[row][col]; }
+    KOKKOS_FORCEINLINE_FUNCTION const T& operator()(const int& row, const int& col) const { return a[row][col]; }
+};
+/**
+ * Vector of at most N elements to go with SmallMatrix, e.g. for solving in a different precision
+ */
+template<int N, typename T=Real>
+struct SmallVector {
+    T a[N];
+    KOKKOS_FORCEINLINE_FUNCTION T& operator()(const int& row) { return a[row]; }
+    KOKKOS_FORCEINLINE_FUNCTION const T& operator()(const int& row) const { return a[row]; }
+};
+
+/**
+ * Solve A x = b in place for the first n x n elements of a SmallMatrix, by LU decomposition with partial pivoting.
+ * Overwrites A with its factors and b with the solution x.
+ * Returns false if the matrix is singular to within tiny
+ */
+template<int N, typename T, typename Local>
+KOKKOS_INLINE_FUNCTION bool small_lu_solve(SmallMatrix<N, T>& A, const int& n, Local& b, const T& tiny)
+{
+    for (int c = 0; c < n; ++c) {
+        // Choose the largest remaining pivot in this column
+        int piv = c;
+        for (int r = c+1; r < n; ++r)
+            if (m::abs(A(r, c)) > m::abs(A(piv, c))) piv = r;
+        if (m::abs(A(piv, c)) < tiny) return false;
+        if (piv != c) {
+            for (int cc = 0; cc < n; ++cc) {
+                const T t = A(c, cc); A(c, cc) = A(piv, cc); A(piv, cc) = t;
+            }
+            const auto t = b(c); b(c) = b(piv); b(piv) = t;
+        }
+        // Eliminate below, applying the same to b as we go
+        for (int r = c+1; r < n; ++r) {
+            const T f = A(r, c) / A(c, c);
+            for (int cc = c+1; cc < n; ++cc) A(r, cc) -= f * A(c, cc);
+            b(r) -= f * b(c);
+        }
+    }
+    // Back-substitute
+    for (int r = n-1; r >= 0; --r) {
+        for (int cc = r+1; cc < n; ++cc) b(r) -= A(r, cc) * b(cc);
+        b(r) /= A(r, r);
+    }
+    return true;
+}
+
+/**
+ * small_lu_solve for the systems in lanes l0 through l0+nl-1 at once, with the lane (zone) index fastest,
+ * i.e. A(row, col, lane) and b(row, lane).  Every lane takes the same sequence of operations, with the row
+ * exchanges of partial pivoting done by selects, so each loop over lanes can vectorize on CPUs.
+ * Overwrites A with its factors and b with the solution.  Lanes singular to within tiny are marked in
+ * singular(lane), and their b zeroed
+ */
+template<typename Matrix, typename Vector, typename Mask>
+KOKKOS_INLINE_FUNCTION void batched_lu_solve(const Matrix& A, const int& n, const int& l0, const int& nl,
+                                             const Vector& b, const Mask& singular, const Real& tiny)
+{
+    const int l1 = l0 + nl;
+    for (int l = l0; l < l1; ++l) singular(l) = 0;
+    for (int c = 0; c < n; ++c) {
+        // Bring the largest remaining pivot of each lane into row c, comparing against each row below in turn.
+        // Column c decides each exchange, so it is exchanged last
+        for (int r = c+1; r < n; ++r) {
+            for (int l = l0; l < l1; ++l) {
+                const bool swap = m::abs(A(r, c, l)) > m::abs(A(c, c, l));
+                const Real t = b(c, l);
+                b(c, l) = swap ? b(r, l) : t;
+                b(r, l) = swap ? t : b(r, l);
+            }
+            for (int cc = n-1; cc >= c; --cc) {
+                for (int l = l0; l < l1; ++l) {
+                    const bool swap = m::abs(A(r, c, l)) > m::abs(A(c, c, l));
+                    const Real t = A(c, cc, l);
+                    A(c, cc, l) = swap ? A(r, cc, l) : t;
+                    A(r, cc, l) = swap ? t : A(r, cc, l);
+                }
+            }
+        }
+        // Mark singular lanes, and give them a unit pivot so the rest of the batch proceeds
+        for (int l = l0; l < l1; ++l) {
+            const bool small = m::abs(A(c, c, l)) < tiny;
+            singular(l) = singular(l) || small;
+            A(c, c, l) = small ? 1. : A(c, c, l);
+        }
+        // Eliminate below, applying the same to b as we go
+        for (int r = c+1; r < n; ++r) {
+            for (int l = l0; l < l1; ++l) {
+                A(r, c, l) /= A(c, c, l);
+                b(r, l) -= A(r, c, l) * b(c, l);
+            }
+            for (int cc = c+1; cc < n; ++cc)
+                for (int l = l0; l < l1; ++l)
+                    A(r, cc, l) -= A(r, c, l) * A(c, cc, l);
+        }
+    }
+    // Back-substitute
+    for (int r = n-1; r >= 0; --r) {
+        for (int cc = r+1; cc < n; ++cc)
+            for (int l = l0; l < l1; ++l)
+                b(r, l) -= A(r, cc, l) * b(cc, l);
+        for (int l = l0; l < l1; ++l)
+            b(r, l) = singular(l) ? 0. : b(r, l) / A(r, r, l);
+    }
+}
+
 /**
  * Calculate the residual generated by the trial primitives P_test
  * 
@@ -184,25 +325,70 @@ KOKKOS_INLINE_FUNCTION void calc_residual(const GRCoordinates& G, const Local& P
 
 }
 
+/**
+ * As calc_residual, using EMHD terms precomputed from Pi & Ps, see EMHD::SourceTerms.
+ * Must be called with emhd_params_s, the parameters corresponding to Ps.
+ */
+template<typename Local>
+KOKKOS_INLINE_FUNCTION void calc_residual(const GRCoordinates& G, const Local& P_test, const Local& Ui,
+                                          const Local& dudt_explicit, const Local& dUi, const Local& tmp,
+                                          const VarMap& m_p, const VarMap& m_u, const EMHD_parameters& emhd_params,
+                                          const EMHD_parameters& emhd_params_s, const EMHD::SourceTerms& s, const int& nfvar,
+                                          const int& j, const int& i, const Real& gam, const double& dt, Local& residual)
+{
+    Flux::p_to_u(G, P_test, m_p, emhd_params, gam, j, i, tmp, m_u); // U_test
+    FLOOP residual(ip) = (tmp(ip) - Ui(ip)) / dt - dudt_explicit(ip);
+
+    if (m_p.Q >= 0 || m_p.DP >= 0) {
+        Real dUq, dUdP;
+        EMHD::implicit_sources(G, P_test, m_p, j, i, emhd_params_s, s, dUq, dUdP); // dU_new
+        if (emhd_params.conduction)
+            residual(m_u.Q) -= 0.5*(dUq + dUi(m_u.Q));
+        if (emhd_params.viscosity)
+            residual(m_u.DP) -= 0.5*(dUdP + dUi(m_u.DP));
+
+        EMHD::time_derivative_sources(G, P_test, m_p, emhd_params_s, s, gam, dt, j, i, dUq, dUdP); // dU_time
+        if (emhd_params.conduction)
+            residual(m_u.Q) -= dUq;
+        if (emhd_params.viscosity)
+            residual(m_u.DP) -= dUdP;
+
+        // Normalize
+        if (emhd_params.conduction)
+            residual(m_u.Q) *= s.tau;
+        if (emhd_params.viscosity)
+            residual(m_u.DP) *= s.tau;
+        if (emhd_params.higher_order_terms) {
+            if (emhd_params.conduction)
+                residual(m_u.Q) *= (s.chi_e != 0) ? m::sqrt(s.rho * s.chi_e * s.tau * s.Theta * s.Theta) / s.tau : 1.;
+            if (emhd_params.viscosity)
+                residual(m_u.DP) *= (s.nu_e != 0) ? m::sqrt(s.rho * s.nu_e * s.tau * s.Theta) / s.tau : 1.;
+        }
+    }
+}
+
 /**
  * Evaluate the jacobian for the implicit iteration, in one zone
  * 
  * Local is anything addressable by (0:nvar-1), Local2 is the same for 2D (0:nvar-1, 0:nvar-1)
  * Usually these are Kokkos subviews
+ * 
+ * All residuals reuse the EMHD terms s computed once per zone from the initial states,
+ * see EMHD::source_terms, leaving Flux::p_to_u as the main cost of each column.
  */
 template<typename Local, typename Local2>
 KOKKOS_INLINE_FUNCTION void calc_jacobian(const GRCoordinates& G, const Local& P_solver,
                                           const Local& P_full_step_init, const Local& U_full_step_init, const Local& P_sub_step_init,
                                           const Local& flux_src, const Local& dU_implicit, Local& tmp1, Local& tmp2, Local& tmp3,
                                           const VarMap& m_p, const VarMap& m_u, const EMHD_parameters& emhd_params_solver,
-                                          const EMHD_parameters& emhd_params_sub_step_init, const int& nvar, const int& nfvar,
-                                          const int& k, const int& j, const int& i,
+                                          const EMHD_parameters& emhd_params_sub_step_init, const EMHD::SourceTerms& s,
+                                          const int& nvar, const int& nfvar, const int& k, const int& j, const int& i,
                                           const Real& jac_delta, const Real& gam, const double& dt,
                                           Local2& jacobian, Local& residual)
 {
     // Calculate residual of P
-    calc_residual(G, P_solver, P_full_step_init, U_full_step_init, P_sub_step_init, flux_src, dU_implicit, tmp3,
-                    m_p, m_u, emhd_params_solver, emhd_params_sub_step_init, nfvar, k, j, i, gam, dt, residual);
+    calc_residual(G, P_solver, U_full_step_init, flux_src, dU_implicit, tmp3,
+                    m_p, m_u, emhd_params_solver, emhd_params_sub_step_init, s, nfvar, j, i, gam, dt, residual);
 
     // Use one scratchpad as the incremented prims P_delta,
     // one as the new residual residual_delta
@@ -221,8 +407,8 @@ KOKKOS_INLINE_FUNCTION void calc_jacobian(const GRCoordinates& G, const Local& P
         }
 
         // Compute the residual for P_delta, residual_delta
-        calc_residual(G, P_delta, P_full_step_init, U_full_step_init, P_sub_step_init, flux_src, dU_implicit, tmp3, 
-                    m_p, m_u, emhd_params_solver, emhd_params_sub_step_init, nfvar, k, j, i, gam, dt, residual_delta);
+        calc_residual(G, P_delta, U_full_step_init, flux_src, dU_implicit, tmp3,
+                    m_p, m_u, emhd_params_solver, emhd_params_sub_step_init, s, nfvar, j, i, gam, dt, residual_delta);
 
         // Compute forward derivatives of each residual vs the primitive col
         for (int row = 0; row < nfvar; row++) {
@@ -0,0 +1,242 @@
+/* 
+ *  File: in_situ.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "in_situ.hpp"
+
+#include "kharma_package.hpp"
+
+#include <sstream>
+
+#if USE_ASCENT
+#include <ascent.hpp>
+#include <conduit_blueprint.hpp>
+#endif
+
+static std::map<std::string, InSitu::Consumer> consumers;
+
+#if USE_ASCENT
+static struct {
+    bool open = false;
+    ascent::Ascent ascent;
+    // Host copies, only used with host_copy, kept between snapshots by gid & field
+    std::map<std::pair<int, std::string>, decltype(std::declval<ParArrayND<Real>>().GetHostMirror())> mirrors;
+    // Ghost zone markers per block, by gid
+    std::map<int, std::vector<int>> ghosts;
+} ascent_state;
+
+static void PublishAscent(const InSitu::Snapshot& snap, ParameterInput *pin, const Params& params)
+{
+    if (!ascent_state.open) {
+        conduit::Node opts;
+#ifdef MPI_PARALLEL
+        opts["mpi_comm"] = MPI_Comm_c2f(MPI_COMM_WORLD);
+#endif
+        opts["actions_file"] = params.Get<std::string>("actions_file");
+        ascent_state.ascent.open(opts);
+        ascent_state.open = true;
+    }
+    const bool host_copy = params.Get<bool>("host_copy");
+
+    conduit::Node mesh;
+    for (auto& blk : snap.blocks) {
+        conduit::Node &dom = mesh["domain_" + std::to_string(blk.gid)];
+        dom["state/cycle"] = snap.ncycle;
+        dom["state/time"] = snap.time;
+        dom["state/domain_id"] = blk.gid;
+
+        // Uniform mesh in native coordinates, over the entire block.  Zones are elements
+        const int n1 = blk.ib_e.e - blk.ib_e.s + 1, n2 = blk.jb_e.e - blk.jb_e.s + 1, n3 = blk.kb_e.e - blk.kb_e.s + 1;
+        const int ncells = n1 * n2 * n3;
+        dom["coordsets/coords/type"] = "uniform";
+        dom["coordsets/coords/dims/i"] = n1 + 1;
+        dom["coordsets/coords/dims/j"] = n2 + 1;
+        dom["coordsets/coords/origin/x"] = blk.xf0[0];
+        dom["coordsets/coords/origin/y"] = blk.xf0[1];
+        dom["coordsets/coords/spacing/dx"] = blk.dx[0];
+        dom["coordsets/coords/spacing/dy"] = blk.dx[1];
+        if (n3 > 1) {
+            dom["coordsets/coords/dims/k"] = n3 + 1;
+            dom["coordsets/coords/origin/z"] = blk.xf0[2];
+            dom["coordsets/coords/spacing/dz"] = blk.dx[2];
+        }
+        dom["topologies/mesh/type"] = "uniform";
+        dom["topologies/mesh/coordset"] = "coords";
+
+        // Ghost zones, so they are left out of renders & reductions
+        auto& ghosts = ascent_state.ghosts[blk.gid];
+        if (ghosts.size() != ncells) {
+            ghosts.resize(ncells);
+            for (int k = 0; k < n3; k++)
+                for (int j = 0; j < n2; j++)
+                    for (int i = 0; i < n1; i++) {
+                        const bool interior = (i + blk.ib_e.s >= blk.ib.s && i + blk.ib_e.s <= blk.ib.e) &&
+                                              (j + blk.jb_e.s >= blk.jb.s && j + blk.jb_e.s <= blk.jb.e) &&
+                                              (k + blk.kb_e.s >= blk.kb.s && k + blk.kb_e.s <= blk.kb.e);
+                        ghosts[(k * n2 + j) * n1 + i] = !interior;
+                    }
+        }
+        dom["fields/ascent_ghosts/association"] = "element";
+        dom["fields/ascent_ghosts/topology"] = "mesh";
+        dom["fields/ascent_ghosts/values"].set_external(ghosts.data(), ncells);
+
+        // Fields, one per component, pointing at the block's own memory (or its host copy)
+        for (auto& field : blk.fields) {
+            const Real *data = field.second.data();
+            if (host_copy) {
+                const auto key = std::make_pair(blk.gid, field.first);
+                if (!ascent_state.mirrors.count(key) || ascent_state.mirrors.at(key).GetSize() != field.second.GetSize())
+                    ascent_state.mirrors[key] = field.second.GetHostMirror();
+                ascent_state.mirrors.at(key).DeepCopy(field.second);
+                data = ascent_state.mirrors.at(key).data();
+            }
+            const int ncomp = field.second.GetSize() / ncells;
+            for (int c = 0; c < ncomp; c++) {
+                const std::string label = (ncomp > 1) ? field.first + "_" + std::to_string(c) : field.first;
+                conduit::Node &f = dom["fields/" + label];
+                f["association"] = "element";
+                f["topology"] = "mesh";
+                f["values"].set_external(const_cast<Real*>(data) + c * ncells, ncells);
+            }
+        }
+    }
+    if (host_copy) Kokkos::fence();
+
+    ascent_state.ascent.publish(mesh);
+    conduit::Node actions;
+    ascent_state.ascent.execute(actions);
+}
+#endif
+
+std::shared_ptr<KHARMAPackage> InSitu::Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages)
+{
+    auto pkg = std::make_shared<KHARMAPackage>("InSitu");
+    Params &params = pkg->AllParams();
+
+    // Options
+    int ncycle = pin->GetOrAddInteger("in_situ", "ncycle", 10);
+    if (ncycle < 1) throw std::invalid_argument("in_situ/ncycle must be at least 1!");
+    params.Add("ncycle", ncycle);
+    // Fields to hand over, comma-separated.  Vectors & tensors are split into components for Ascent
+    std::string variables = pin->GetOrAddString("in_situ", "variables", "prims.rho,prims.u,prims.uvec");
+    std::vector<std::string> names;
+    std::stringstream ss(variables);
+    std::string var;
+    while (std::getline(ss, var, ',')) {
+        if (!var.empty()) names.push_back(var);
+    }
+    if (names.empty()) throw std::invalid_argument("in_situ/variables lists no fields!");
+    params.Add("variables", names);
+    // Ascent
+    std::string actions_file = pin->GetOrAddString("in_situ", "actions_file", "ascent_actions.yaml");
+    params.Add("actions_file", actions_file);
+    bool host_copy = pin->GetOrAddBoolean("in_situ", "host_copy",
+                                          !Kokkos::SpaceAccessibility<Kokkos::HostSpace, DevMemSpace>::accessible);
+    params.Add("host_copy", host_copy);
+
+#if !USE_ASCENT
+    if (MPIRank0())
+        std::cout << "KHARMA was compiled without Ascent: in-situ snapshots go to registered consumers only" << std::endl;
+#endif
+
+    pkg->PostStepWork = InSitu::PostStepWork;
+    pkg->PostExecute = InSitu::PostExecute;
+
+    return pkg;
+}
+
+void InSitu::AddConsumer(const std::string& name, Consumer consumer)
+{
+    consumers[name] = consumer;
+}
+
+void InSitu::PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+    auto &params = pmesh->packages.Get("InSitu")->AllParams();
+    // tm.ncycle & tm.time are incremented after this call
+    const int ncycle = tm.ncycle + 1;
+    if (ncycle % params.Get<int>("ncycle") != 0) return;
+
+    Flag("InSitu");
+    const auto& names = params.Get<std::vector<std::string>>("variables");
+    Snapshot snap;
+    snap.time = tm.time + tm.dt;
+    snap.ncycle = ncycle;
+    for (auto &pmb : pmesh->block_list) {
+        // Fill any output-only fields, exactly as before a dump
+        Packages::UserWorkBeforeOutput(pmb.get(), pin);
+
+        auto rc = pmb->meshblock_data.Get();
+        BlockFields blk;
+        blk.gid = pmb->gid;
+        blk.ib = pmb->cellbounds.GetBoundsI(IndexDomain::interior);
+        blk.jb = pmb->cellbounds.GetBoundsJ(IndexDomain::interior);
+        blk.kb = pmb->cellbounds.GetBoundsK(IndexDomain::interior);
+        blk.ib_e = pmb->cellbounds.GetBoundsI(IndexDomain::entire);
+        blk.jb_e = pmb->cellbounds.GetBoundsJ(IndexDomain::entire);
+        blk.kb_e = pmb->cellbounds.GetBoundsK(IndexDomain::entire);
+        const auto& G = pmb->coords;
+        blk.xf0[0] = G.Xf<1>(blk.ib_e.s); blk.dx[0] = G.Dxc<1>(blk.ib.s);
+        blk.xf0[1] = G.Xf<2>(blk.jb_e.s); blk.dx[1] = G.Dxc<2>(blk.jb.s);
+        blk.xf0[2] = G.Xf<3>(blk.kb_e.s); blk.dx[2] = G.Dxc<3>(blk.kb.s);
+        for (auto& name : names) {
+            if (!rc->HasVariable(name))
+                throw std::runtime_error("In-situ variable "+name+" does not exist!");
+            blk.fields[name] = rc->Get(name).data;
+        }
+        snap.blocks.push_back(blk);
+    }
+    // Output-only fields must be filled before anyone reads them
+    Kokkos::fence();
+
+    for (auto& consumer : consumers) {
+        Flag("InSitu_", consumer.first);
+        consumer.second(snap);
+        EndFlag();
+    }
+#if USE_ASCENT
+    Flag("InSitu_Ascent");
+    PublishAscent(snap, pin, params);
+    EndFlag();
+#endif
+    EndFlag();
+}
+
+void InSitu::PostExecute(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+#if USE_ASCENT
+    if (ascent_state.open) {
+        ascent_state.ascent.close();
+        ascent_state.open = false;
+    }
+#endif
+}
@@ -0,0 +1,99 @@
+/* 
+ *  File: in_situ.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+#include "types.hpp"
+
+#include <parthenon/parthenon.hpp>
+
+/**
+ * In-situ analysis & visualization: every in_situ/ncycle steps, hand the fields listed in in_situ/variables
+ * (any primitives, conserved or output-only fields, e.g. jcon or coords.*) to in-situ consumers
+ * without writing anything to disk.
+ *
+ * Fields are passed as the blocks' own device arrays, uncopied.  Output-only fields are filled first
+ * as for any output, see Packages::UserWorkBeforeOutput, so listing e.g. coords.r or jcon here
+ * loads their packages just as listing them in an output block would.
+ *
+ * Consumers are:
+ * 1. Any C++ function registered with InSitu::AddConsumer, for analysis compiled in with KHARMA
+ * 2. Ascent, if KHARMA was built with it (USE_ASCENT).  Each block is published as one domain of a
+ *    uniform mesh in native coordinates, including ghost zones marked by "ascent_ghosts",
+ *    and actions are read from in_situ/actions_file.  Ascent builds without device support are
+ *    given host copies instead (in_situ/host_copy, default when device memory isn't host-accessible)
+ */
+namespace InSitu {
+
+/**
+ * One block's fields, as handed to consumers.  Arrays are the block's own storage, laid out (v,k,j,i)
+ * over the entire block including ghost zones
+ */
+struct BlockFields {
+    int gid;
+    // Index ranges of the interior & entire block
+    IndexRange ib, jb, kb, ib_e, jb_e, kb_e;
+    // Native coordinates of the first face in each direction (entire block), and zone widths
+    GReal xf0[3], dx[3];
+    std::map<std::string, ParArrayND<Real>> fields;
+};
+struct Snapshot {
+    Real time;
+    int ncycle;
+    std::vector<BlockFields> blocks;
+};
+using Consumer = std::function<void(const Snapshot&)>;
+
+/**
+ * Initialize the in-situ package, loaded if in_situ/on is set
+ */
+std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages);
+
+/**
+ * Register an analysis function to be called with each snapshot.  Call any time before the step loop,
+ * e.g. from a problem's setup code
+ */
+void AddConsumer(const std::string& name, Consumer consumer);
+
+/**
+ * Hand a snapshot to every consumer, if one is due
+ */
+void PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+
+/**
+ * Close any in-situ library
+ */
+void PostExecute(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+
+}
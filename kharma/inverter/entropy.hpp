@@ -0,0 +1,138 @@
+/* 
+ *  File: entropy.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2026, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+// General template, Status etc.
+#include "invert_template.hpp"
+// For the shared conversion of U to four-vectors, and setting primitives from W'
+#include "onedw.hpp"
+
+#include "grmhd_functions.hpp"
+#include "kharma_utils.hpp"
+
+namespace Inverter {
+
+// The backup inversion is only run in zones where the main one failed, so it can afford more iterations
+static constexpr int ENTROPY_ITER_MAX = 2 * UTOP_ITER_MAX;
+
+/**
+ * Error in W = w gamma^2 for the entropy inversion, where the enthalpy w is determined by
+ * rho = D/gamma and the pressure p = K rho^gam, rather than by the energy equation as in err_eqn
+ */
+KOKKOS_INLINE_FUNCTION GReal entropy_err_eqn(const GReal& gam, const GReal& K, const OneDWState& s,
+                                           const GReal& Wp, Status& eflag)
+{
+    const GReal gamma = lorentz_calc_w(s.Bsq, s.D, s.QdB, s.Qtsq, Wp);
+    if (gamma < 1) eflag = Status::bad_ut;
+    const GReal rho = s.D / gamma;
+    const GReal w = rho + gam / (gam - 1) * K * m::pow(rho, gam);
+    return Wp + s.D - w * gamma * gamma;
+}
+
+/**
+ * Backup inversion using the entropy K = p/rho^gam in place of the energy equation,
+ * as in Noble et al. (2009).  Used to recover zones where the main inversion fails, see
+ * inverter/entropy_fallback.  The result doesn't conserve energy, so callers must recompute
+ * U from the new primitives, as for any fixed zone.
+ *
+ * K is the advected entropy, U(Ktot)/U(rho).  As u_to_p, only writes primitives on success
+ */
+KOKKOS_INLINE_FUNCTION Status u_to_p_entropy(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                             const Real& gam, const Real& K, const int& k, const int& j, const int& i,
+                                             const VariablePack<Real>& P, const VarMap& m_p,
+                                             const Loci loc, int& iters)
+{
+    // Also catches NaN, and zones never given an entropy
+    if (!(K > 0.)) return Status::neg_input;
+
+    OneDWState s;
+    const Status setup = onedw_setup(G, U, m_u, k, j, i, loc, s);
+    if (failed(setup)) return setup;
+
+    // Start from the current primitives if they make sense, otherwise from rest
+    GReal Wp;
+    if (failed(onedw_guess(G, P, m_p, gam, k, j, i, loc, Wp)) || !(Wp > 0.))
+        Wp = gam / (gam - 1) * K * m::pow(s.D, (GReal) gam);
+
+    // Newton-Raphson with a one-sided finite-difference derivative
+    int iter = 0;
+    for (iter = 0; iter < ENTROPY_ITER_MAX; iter++) {
+        Status eflag = Status::success;
+        const GReal err = entropy_err_eqn(gam, K, s, Wp, eflag);
+        const GReal h = DELTA * Wp;
+        const GReal errp = entropy_err_eqn(gam, K, s, Wp + h, eflag);
+        if (eflag != Status::success) return eflag;
+
+        const GReal dW = clip(-err * h / (errp - err), (GReal) -0.5*Wp, (GReal) 2.0*Wp);
+        Wp += dW;
+        if (m::abs(dW / Wp) < UTOP_ERRTOL) break;
+    }
+    iters = iter + 1;
+    if (iter == ENTROPY_ITER_MAX) return Status::max_iter;
+
+    // At convergence w - rho = gam/(gam-1) K rho^gam, so this sets u = K rho^gam / (gam-1)
+    return onedw_set_prims(s, gam, Wp, k, j, i, P, m_p);
+}
+
+/**
+ * Entropy step applied after the main inversion of each zone, when inverter/entropy_fallback is set.
+ * Zones which failed are retried with u_to_p_entropy, returning Status::entropy if recovered,
+ * or the original failure if not.  Successful zones are left alone, except that if the inverter
+ * owns the entropy (i.e., electrons are disabled), it is reset to that of the new primitives,
+ * so it only drifts from the true entropy over a single step.
+ * K_U and K_P are the conserved & primitive Ktot of this block.
+ */
+KOKKOS_INLINE_FUNCTION Status entropy_fallback(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                               const Real& gam, const VariablePack<Real>& K_U, const VariablePack<Real>& K_P,
+                                               const bool& reset_entropy, const int& k, const int& j, const int& i,
+                                               const VariablePack<Real>& P, const VarMap& m_p, const Status& status)
+{
+    if (!failed(status)) {
+        if (reset_entropy) {
+            const Real K = (gam - 1.) * P(m_p.UU, k, j, i) * m::pow(P(m_p.RHO, k, j, i), -gam);
+            K_P(0, k, j, i) = K;
+            K_U(0, k, j, i) = U(m_u.RHO, k, j, i) * K;
+        }
+        return status;
+    }
+
+    const Real K = K_U(0, k, j, i) / U(m_u.RHO, k, j, i);
+    int iters;
+    const Status entropy_status = u_to_p_entropy(G, U, m_u, gam, K, k, j, i, P, m_p, Loci::center, iters);
+    if (failed(entropy_status)) return status;
+    K_P(0, k, j, i) = K;
+    return Status::entropy;
+}
+
+} // namespace Inverter
@@ -38,6 +38,7 @@
 #include "floors.hpp"
 #include "floors_functions.hpp"
 #include "flux_functions.hpp"
+#include "kharma_config.hpp"
 #include "pack.hpp"
 
 // Version of "PLOOP" guaranteeing specifically the 5 GRMHD fixup-amenable primitive vars
@@ -51,8 +52,9 @@ TaskStatus Inverter::FixUtoP(MeshBlockData<Real> *rc)
     // This may actually mean we require the 4 ghost zones Parthenon "wants" us to have,
     // if we need to use only fixed zones.
     auto pmb = rc->GetBlockPointer();
+    const auto& config = KHARMA::GetConfig(pmb->packages);
     // Bail if we're not enabled
-    if (!pmb->packages.Get("Inverter")->Param<bool>("fix_average_neighbors")) {
+    if (!config.fix_average_neighbors) {
         return TaskStatus::complete;
     }
 
@@ -62,8 +64,7 @@ TaskStatus Inverter::FixUtoP(MeshBlockData<Real> *rc)
 
     GridScalar pflag = rc->Get("pflag").data;
 
-    const auto& pars = pmb->packages.Get("GRMHD")->AllParams();
-    const Real gam = pars.Get<Real>("gamma");
+    const Real gam = config.gam;
     // Only yell about neighbors on extreme verbosity.
     // 
     const int flag_verbose = pmb->packages.Get("Globals")->Param<int>("flag_verbose");
@@ -76,55 +77,89 @@ TaskStatus Inverter::FixUtoP(MeshBlockData<Real> *rc)
 
     const auto& G = pmb->coords;
 
-    pmb->par_for("fix_U_to_P", b.ks, b.ke, b.js, b.je, b.is, b.ie,
+    // Failures are rare, so rather than branching over the whole block twice,
+    // count them with a cheap read-only pass and then gather their indices into a list
+    int nfail = 0;
+    Kokkos::Sum<int> sum_reducer(nfail);
+    pmb->par_reduce("count_failed", b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        KOKKOS_LAMBDA (const int &k, const int &j, const int &i, int &local_result) {
+            if (failed(pflag(k, j, i))) ++local_result;
+        }
+    , sum_reducer);
+    if (nfail == 0) {
+        EndFlag();
+        return TaskStatus::complete;
+    }
+
+    const int n1 = b.ie - b.is + 1, n2 = b.je - b.js + 1;
+    auto& inverter_pars = pmb->packages.Get("Inverter")->AllParams();
+    const auto fail_list = inverter_pars.GetMutable<Allocations::PersistentArray<int>>("fail_list")->Get(nfail);
+    const auto fail_count = inverter_pars.GetMutable<Allocations::PersistentArray<int>>("fail_count")->Get(1);
+    Kokkos::deep_copy(fail_count, 0);
+    pmb->par_for("list_failed", b.ks, b.ke, b.js, b.je, b.is, b.ie,
         KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
             if (failed(pflag(k, j, i))) {
-                // Luckily fixups are rare, so we don't have to worry about optimizing this *too* much
-                double wsum = 0., wsum_x = 0.;
-                double sum[NPRIM] = {0.}, sum_x[NPRIM] = {0.};
-                // For all neighboring cells...
-                for (int n = -1; n <= 1; n++) {
-                    for (int m = -1; m <= 1; m++) {
-                        for (int l = -1; l <= 1; l++) {
-                            int ii = i + l, jj = j + m, kk = k + n;
-                            // If we haven't overstepped array bounds...
-                            if (KDomain::inside(kk, jj, ii, b)) {
-                                // Weight by distance
-                                double w = 1./(m::abs(l) + m::abs(m) + m::abs(n) + 1);
-
-                                // Count only the good cells (not failed AND not corner), if we can
-                                if (!failed(pflag(kk, jj, ii))) {
-                                    // Weight by distance.  Note interpolated "fixed" cells stay flagged
-                                    wsum += w;
-                                    PRIMLOOP sum[p] += w * P(p, kk, jj, ii);
-                                }
-                                // Just in case, keep a sum of even the bad ones
-                                wsum_x += w;
-                                PRIMLOOP sum_x[p] += w * P(p, kk, jj, ii);
+                const int n = Kokkos::atomic_fetch_add(&fail_count(0), 1);
+                fail_list(n) = ((k - b.ks) * n2 + (j - b.js)) * n1 + (i - b.is);
+            }
+        }
+    );
+
+    Flag("fix_U_to_P");
+    // Static estimates for the timing report: average prims & flags over 27 neighbors, recompute U
+    Timers::CountKernel("fix_U_to_P", nfail, (27 * 9 + 16) * sizeof(Real), 1100);
+    pmb->par_for("fix_U_to_P", 0, nfail - 1,
+        KOKKOS_LAMBDA (const int &f) {
+            const int idx = fail_list(f);
+            const int i = b.is + idx % n1;
+            const int j = b.js + (idx / n1) % n2;
+            const int k = b.ks + idx / (n1 * n2);
+            // Luckily fixups are rare, so we don't have to worry about optimizing this *too* much
+            double wsum = 0., wsum_x = 0.;
+            double sum[NPRIM] = {0.}, sum_x[NPRIM] = {0.};
+            // For all neighboring cells...
+            for (int n = -1; n <= 1; n++) {
+                for (int m = -1; m <= 1; m++) {
+                    for (int l = -1; l <= 1; l++) {
+                        int ii = i + l, jj = j + m, kk = k + n;
+                        // If we haven't overstepped array bounds...
+                        if (KDomain::inside(kk, jj, ii, b)) {
+                            // Weight by distance
+                            double w = 1./(m::abs(l) + m::abs(m) + m::abs(n) + 1);
+
+                            // Count only the good cells (not failed AND not corner), if we can
+                            if (!failed(pflag(kk, jj, ii))) {
+                                // Weight by distance.  Note interpolated "fixed" cells stay flagged
+                                wsum += w;
+                                PRIMLOOP sum[p] += w * P(p, kk, jj, ii);
                             }
+                            // Just in case, keep a sum of even the bad ones
+                            wsum_x += w;
+                            PRIMLOOP sum_x[p] += w * P(p, kk, jj, ii);
                         }
                     }
                 }
+            }
 
-                if(wsum < 1.e-10) {
-                    // TODO probably should crash here.
+            if(wsum < 1.e-10) {
+                // TODO probably should crash here.
 #ifndef KOKKOS_ENABLE_SYCL
-                    if (flag_verbose >= 3)
-                        printf("No neighbors were available at %d %d %d!\n", i, j, k);
+                if (flag_verbose >= 3)
+                    printf("No neighbors were available at %d %d %d!\n", i, j, k);
 #endif
-                    // TODO is there a situation in which this shadow is useful, or do we ditch it?
-                    PRIMLOOP P(p, k, j, i) = sum_x[p]/wsum_x;
-                } else {
-                    PRIMLOOP P(p, k, j, i) = sum[p]/wsum;
-                }
+                // TODO is there a situation in which this shadow is useful, or do we ditch it?
+                PRIMLOOP P(p, k, j, i) = sum_x[p]/wsum_x;
+            } else {
+                PRIMLOOP P(p, k, j, i) = sum[p]/wsum;
             }
         }
     );
+    EndFlag();
 
     // Re-apply floors to fixed zones
-    if (pmb->packages.AllPackages().count("Floors")) {
+    if (config.use_floors) {
         // Floor prescription from the package
-        const Floors::Prescription floors(pmb->packages.Get("Floors")->AllParams());
+        const Floors::Prescription& floors = config.GetFloors();
 
         // We need the full packs of prims/cons for p_to_u
         // Pack new variables
@@ -138,18 +173,144 @@ TaskStatus Inverter::FixUtoP(MeshBlockData<Real> *rc)
         // Get floor flag
         GridScalar fflag = rc->Get("fflag").data;
 
-        pmb->par_for("fix_U_to_P_floors", b.ks, b.ke, b.js, b.je, b.is, b.ie,
-            KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-                if (failed(pflag(k, j, i))) {
-                    // Make sure all fixed values still abide by floors (floors keep lockstep)
-                    // TODO Full floors instead of just geo?
-                    Floors::apply_geo_floors(G, P, m_p, gam, k, j, i, floors);
+        pmb->par_for("fix_U_to_P_floors", 0, nfail - 1,
+            KOKKOS_LAMBDA (const int &f) {
+                const int idx = fail_list(f);
+                const int i = b.is + idx % n1;
+                const int j = b.js + (idx / n1) % n2;
+                const int k = b.ks + idx / (n1 * n2);
+                // Make sure all fixed values still abide by floors (floors keep lockstep)
+                // TODO Full floors instead of just geo?
+                Floors::apply_geo_floors(G, P, m_p, gam, k, j, i, floors);
+
+                // Make sure to keep lockstep
+                // This will only be run for GRMHD, so we can call its p_to_u
+                GRMHD::p_to_u(G, P, m_p, gam, k, j, i, U, m_u);
+            }
+        );
+    }
+
+    EndFlag();
+    return TaskStatus::complete;
+}
+
+TaskStatus Inverter::MeshFixUtoP(MeshData<Real> *md)
+{
+    // As FixUtoP, over every block in md at once.  Each block can only be fixed
+    // from its own zones, so neighbors are checked against per-block physical ranges.
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const auto& config = KHARMA::GetConfig(pmb0->packages);
+    if (!config.fix_average_neighbors) {
+        return TaskStatus::complete;
+    }
+
+    Flag("Inverter::MeshFixUtoP");
+    PackIndexMap hd_map;
+    auto P = GRMHD::PackHDPrims(md, hd_map);
+    auto pflag = md->PackVariables(std::vector<std::string>{"pflag"});
+    if (P.GetDim(4) == 0 || pflag.GetDim(4) == 0) {
+        EndFlag();
+        return TaskStatus::complete;
+    }
+
+    const Real gam = config.gam;
+    const int flag_verbose = pmb0->packages.Get("Globals")->Param<int>("flag_verbose");
+
+    const int nblocks = P.GetDim(5);
+    const auto phys = KDomain::GetPhysicalRanges(md);
+    const IndexRange3 b = KDomain::GetRange(md, IndexDomain::entire);
+    const IndexRange block = IndexRange{0, nblocks - 1};
+
+    // Count & list failures over the whole partition, as in FixUtoP
+    int nfail = 0;
+    Kokkos::Sum<int> sum_reducer(nfail);
+    pmb0->par_reduce("count_failed_mesh", block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        KOKKOS_LAMBDA (const int &bl, const int &k, const int &j, const int &i, int &local_result) {
+            if (KDomain::inside(k, j, i, phys, bl) && failed(pflag(bl, 0, k, j, i))) ++local_result;
+        }
+    , sum_reducer);
+    if (nfail == 0) {
+        EndFlag();
+        return TaskStatus::complete;
+    }
+
+    const int n1 = b.ie - b.is + 1, n2 = b.je - b.js + 1, n3 = b.ke - b.ks + 1;
+    auto& inverter_pars = pmb0->packages.Get("Inverter")->AllParams();
+    const auto fail_list = inverter_pars.GetMutable<Allocations::PersistentArray<int>>("fail_list")->Get(nfail);
+    const auto fail_count = inverter_pars.GetMutable<Allocations::PersistentArray<int>>("fail_count")->Get(1);
+    Kokkos::deep_copy(fail_count, 0);
+    pmb0->par_for("list_failed_mesh", block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        KOKKOS_LAMBDA (const int &bl, const int &k, const int &j, const int &i) {
+            if (KDomain::inside(k, j, i, phys, bl) && failed(pflag(bl, 0, k, j, i))) {
+                const int n = Kokkos::atomic_fetch_add(&fail_count(0), 1);
+                fail_list(n) = ((bl * n3 + (k - b.ks)) * n2 + (j - b.js)) * n1 + (i - b.is);
+            }
+        }
+    );
 
-                    // Make sure to keep lockstep
-                    // This will only be run for GRMHD, so we can call its p_to_u
-                    GRMHD::p_to_u(G, P, m_p, gam, k, j, i, U, m_u);
+    Flag("fix_U_to_P_mesh");
+    Timers::CountKernel("fix_U_to_P", nfail, (27 * 9 + 16) * sizeof(Real), 1100);
+    pmb0->par_for("fix_U_to_P_mesh", 0, nfail - 1,
+        KOKKOS_LAMBDA (const int &f) {
+            const int idx = fail_list(f);
+            const int i = b.is + idx % n1;
+            const int j = b.js + (idx / n1) % n2;
+            const int k = b.ks + (idx / (n1 * n2)) % n3;
+            const int bl = idx / (n1 * n2 * n3);
+            double wsum = 0., wsum_x = 0.;
+            double sum[NPRIM] = {0.}, sum_x[NPRIM] = {0.};
+            for (int n = -1; n <= 1; n++) {
+                for (int m = -1; m <= 1; m++) {
+                    for (int l = -1; l <= 1; l++) {
+                        int ii = i + l, jj = j + m, kk = k + n;
+                        if (KDomain::inside(kk, jj, ii, phys, bl)) {
+                            double w = 1./(m::abs(l) + m::abs(m) + m::abs(n) + 1);
+                            if (!failed(pflag(bl, 0, kk, jj, ii))) {
+                                wsum += w;
+                                PRIMLOOP sum[p] += w * P(bl, p, kk, jj, ii);
+                            }
+                            wsum_x += w;
+                            PRIMLOOP sum_x[p] += w * P(bl, p, kk, jj, ii);
+                        }
+                    }
                 }
             }
+
+            if(wsum < 1.e-10) {
+#ifndef KOKKOS_ENABLE_SYCL
+                if (flag_verbose >= 3)
+                    printf("No neighbors were available at %d %d %d in block %d!\n", i, j, k, bl);
+#endif
+                PRIMLOOP P(bl, p, k, j, i) = sum_x[p]/wsum_x;
+            } else {
+                PRIMLOOP P(bl, p, k, j, i) = sum[p]/wsum;
+            }
+        }
+    );
+    EndFlag();
+
+    // Re-apply floors to fixed zones
+    if (config.use_floors) {
+        const Floors::Prescription& floors = config.GetFloors();
+
+        PackIndexMap prims_map, cons_map;
+        auto U_all = GRMHD::PackMHDCons(md, cons_map);
+        auto P_all = GRMHD::PackMHDPrims(md, prims_map);
+        const VarMap m_u(cons_map, true), m_p(prims_map, false);
+
+        pmb0->par_for("fix_U_to_P_floors_mesh", 0, nfail - 1,
+            KOKKOS_LAMBDA (const int &f) {
+                const int idx = fail_list(f);
+                const int i = b.is + idx % n1;
+                const int j = b.js + (idx / n1) % n2;
+                const int k = b.ks + (idx / (n1 * n2)) % n3;
+                const int bl = idx / (n1 * n2 * n3);
+                const auto& G = U_all.GetCoords(bl);
+                auto P_b = P_all(bl);
+                auto U_b = U_all(bl);
+                Floors::apply_geo_floors(G, P_b, m_p, gam, k, j, i, floors);
+                GRMHD::p_to_u(G, P_b, m_p, gam, k, j, i, U_b, m_u);
+            }
         );
     }
 
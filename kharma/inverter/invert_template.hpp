@@ -43,13 +43,15 @@
 
 namespace Inverter {
 
-// Denote inverter types. Currently just one
-enum class Type{none=0, onedw};
+// Denote inverter types
+enum class Type{none=0, onedw, onedw_analytic, kastaun};
 
 // Denote inversion failures (pflags)
 // This enum should grow to cover any inversion algorithm
 // TODO is this better off in its own space like FFlag?
-enum class Status{success=0, neg_input, max_iter, bad_ut, bad_gamma, neg_rho, neg_u, neg_rhou};
+// 'entropy' marks zones where the main inversion failed, but the backup inversion from the
+// advected entropy (see entropy.hpp) succeeded.  These are not failures and aren't fixed.
+enum class Status{success=0, neg_input, max_iter, bad_ut, bad_gamma, neg_rho, neg_u, neg_rhou, entropy};
 
 static const std::map<int, std::string> status_names = {
     {(int) Status::neg_input, "Negative input"},
@@ -58,13 +60,25 @@ static const std::map<int, std::string> status_names = {
     {(int) Status::bad_gamma, "Gamma invalid"},
     {(int) Status::neg_rho, "Negative rho"},
     {(int) Status::neg_u, "Negative U"},
-    {(int) Status::neg_rhou, "Negative rho & U"}
+    {(int) Status::neg_rhou, "Negative rho & U"},
+    {(int) Status::entropy, "Recovered from entropy"}
 };
 
 template <typename T>
 KOKKOS_INLINE_FUNCTION bool failed(T status_flag)
 {
     // Return only values >0, among the failure flags
+    return static_cast<int>(status_flag) > static_cast<int>(Status::success) &&
+           static_cast<int>(status_flag) != static_cast<int>(Status::entropy);
+}
+
+/**
+ * Whether the primitives in a zone were set by anything but the main inversion (i.e. fixed up after
+ * failing, or recovered from entropy), so that its conserved variables must be recomputed from them
+ */
+template <typename T>
+KOKKOS_INLINE_FUNCTION bool replaced(T status_flag)
+{
     return static_cast<int>(status_flag) > static_cast<int>(Status::success);
 }
 
@@ -77,6 +91,8 @@ KOKKOS_INLINE_FUNCTION bool failed(T status_flag)
  * 
  * On error, will not write replacement values, leaving the previous step's values in place
  * These are fixed later, in FixUtoP
+ *
+ * The number of iterations taken is returned in iters, for diagnostics
  * 
  * This is the function template: implementations are filled in in their own headers.
  * Be VERY CAREFUL to define any specializations by including those headers,
@@ -86,5 +102,19 @@ template<Type inverter>
 KOKKOS_INLINE_FUNCTION Status u_to_p(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
                                               const Real& gam, const int& k, const int& j, const int& i,
                                               const VariablePack<Real>& P, const VarMap& m_p,
-                                              const Loci loc);
+                                              const Loci loc, int& iters);
+
+/**
+ * As u_to_p, optionally starting from a guess W'/D cached from a previous call, see inverter/warm_start.
+ * Inverters which don't use an initial guess just ignore the cache, as here.
+ * Specializations for the 1D_W inverters are in onedw.hpp
+ */
+template<Type inverter>
+KOKKOS_INLINE_FUNCTION Status u_to_p_warm(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                          const Real& gam, const int& k, const int& j, const int& i,
+                                          const VariablePack<Real>& P, const VarMap& m_p,
+                                          const Loci loc, int& iters, Real& Wp_cache)
+{
+    return u_to_p<inverter>(G, U, m_u, gam, k, j, i, P, m_p, loc, iters);
+}
 } // namespace Inverter
@@ -36,7 +36,11 @@
 // This will include headers in the correct order
 #include "invert_template.hpp"
 
+#include "b_ct.hpp"
 #include "domain.hpp"
+#include "electrons.hpp"
+#include "floors.hpp"
+#include "floors_functions.hpp"
 #include "reductions.hpp"
 
 std::shared_ptr<KHARMAPackage> Inverter::Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages)
@@ -55,13 +59,35 @@ std::shared_ptr<KHARMAPackage> Inverter::Initialize(ParameterInput *pin, std::sh
     std::string inverter_name = pin->GetOrAddString("inverter", "type", "onedw");
     if (inverter_name == "onedw") {
         params.Add("inverter_type", Type::onedw);
+    } else if (inverter_name == "onedw_analytic") {
+        params.Add("inverter_type", Type::onedw_analytic);
+    } else if (inverter_name == "kastaun") {
+        params.Add("inverter_type", Type::kastaun);
     } else if (inverter_name == "none") {
         params.Add("inverter_type", Type::none);
+    } else {
+        throw std::invalid_argument("Unknown inverter type "+inverter_name+"! Use onedw, onedw_analytic, kastaun, or none");
     }
 
     bool fix_average_neighbors = pin->GetOrAddBoolean("inverter", "fix_average_neighbors", true);
     params.Add("fix_average_neighbors", fix_average_neighbors);
-    // TODO add version attempting to recover from entropy, stuff like that
+
+    // Before leaving failed zones to FixUtoP, try recovering them from an advected entropy, see entropy.hpp.
+    // This uses the total entropy Ktot of the Electrons package if it's enabled, otherwise we add & keep it
+    bool entropy_fallback = pin->GetOrAddBoolean("inverter", "entropy_fallback", false);
+    params.Add("entropy_fallback", entropy_fallback);
+    const bool own_entropy = entropy_fallback && !pin->GetOrAddBoolean("electrons", "on", false);
+    params.Add("own_entropy", own_entropy);
+    if (own_entropy) {
+        // As the Electrons package's Ktot, but always explicit
+        std::vector<MetadataFlag> flags_entropy = {Metadata::Cell, Metadata::GetUserFlag("Explicit")};
+        auto flags_prim = packages->Get("Driver")->Param<std::vector<MetadataFlag>>("prim_flags");
+        flags_prim.insert(flags_prim.end(), flags_entropy.begin(), flags_entropy.end());
+        auto flags_cons = packages->Get("Driver")->Param<std::vector<MetadataFlag>>("cons_flags");
+        flags_cons.insert(flags_cons.end(), flags_entropy.begin(), flags_entropy.end());
+        pkg->AddField("cons.Ktot", flags_cons);
+        pkg->AddField("prims.Ktot", flags_prim);
+    }
 
     // Flag denoting UtoP inversion failures
     // Needs boundary sync if treating primitive variables as fundamental, since we need to
@@ -75,12 +101,64 @@ std::shared_ptr<KHARMAPackage> Inverter::Initialize(ParameterInput *pin, std::sh
     }
     pkg->AddField("pflag", m);
 
+    // Optionally start each inversion from the W'/D found in the zone on the last successful call,
+    // rather than the current primitives.  Costs one cell field.
+    bool warm_start = pin->GetOrAddBoolean("inverter", "warm_start", false);
+    params.Add("warm_start", warm_start);
+    if (warm_start) {
+        pkg->AddField("inverter_Wp", Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy}));
+    }
+
+    // Optionally record the number of iterations taken by the inverter in each zone
+    // On by default when reporting debug/history_counters or a debug/cost_map
+    const bool history_counters = pin->GetOrAddBoolean("debug", "history_counters", false);
+    const bool cost_map = pin->GetOrAddBoolean("debug", "cost_map", false);
+    bool record_iterations = pin->GetOrAddBoolean("inverter", "record_iterations", history_counters || cost_map);
+    params.Add("record_iterations", record_iterations);
+    if (record_iterations) {
+        pkg->AddField("inverter_iters", Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy}));
+    }
+
+    // Optionally apply the GRMHD floors in the same kernel as the inversion, see MeshUtoPFloors.
+    // Zones which fail inversion are left for FixUtoP, which re-applies floors itself
+    bool fuse_floors = pin->GetOrAddBoolean("inverter", "fuse_floors", false);
+    params.Add("fuse_floors", fuse_floors);
+
+    // Average the face-centered B field to zone centers inside the inversion kernels,
+    // rather than in a separate B_CT::MeshUtoP launch.  See FusesBCT
+    bool fuse_b_ct = pin->GetOrAddBoolean("inverter", "fuse_b_ct", true);
+    params.Add("fuse_b_ct", fuse_b_ct);
+    // Likewise recover the electron entropies in the inversion kernel.  See FusesElectrons
+    bool fuse_electrons = pin->GetOrAddBoolean("inverter", "fuse_electrons", false);
+    params.Add("fuse_electrons", fuse_electrons);
+
+    // Lists of failed zones for FixUtoP, kept between steps so steps with failures don't allocate
+    params.Add("fail_list", Allocations::PersistentArray<int>("fail_list"), true);
+    params.Add("fail_count", Allocations::PersistentArray<int>("fail_count"), true);
+
     // We exist basically to do this
     pkg->BlockUtoP = Inverter::BlockUtoP;
+    pkg->MeshUtoP = Inverter::MeshUtoP;
+    pkg->MeshUtoPFloors = Inverter::MeshUtoPFloors;
     pkg->BoundaryUtoP = Inverter::BlockUtoP;
 
     pkg->PostStepDiagnosticsMesh = Inverter::PostStepDiagnostics;
 
+    // History counters: total inversion iterations, and zones left for FixUtoP
+    if (history_counters) {
+        parthenon::HstVar_list hst_vars = {};
+        hst_vars.emplace_back(parthenon::HistoryOutputVar(UserHistoryOperation::sum,
+            [](MeshData<Real> *md) -> Real { return Reductions::SumField(md, "inverter_iters", IndexDomain::interior); },
+            "InverterIters"));
+        hst_vars.emplace_back(parthenon::HistoryOutputVar(UserHistoryOperation::sum,
+            [](MeshData<Real> *md) -> Real {
+                // Zones recovered from entropy are flagged, but not fixed.  They're counted last
+                const auto counts = Reductions::CountFlags(md, "pflag", Inverter::status_names, IndexDomain::interior, false);
+                return counts[0] - counts.back();
+            }, "FixUtoPZones"));
+        pkg->AddParam<>(parthenon::hist_param_key, hst_vars);
+    }
+
     return pkg;
 }
 
@@ -100,6 +178,17 @@ inline void BlockPerformInversion(MeshBlockData<Real> *rc, IndexDomain domain, b
     const VarMap m_u(cons_map, true), m_p(prims_map, false);
 
     auto pflag = rc->PackVariables(std::vector<std::string>{"pflag"});
+    // Empty unless inverter/record_iterations is set
+    auto iters_out = rc->PackVariables(std::vector<std::string>{"inverter_iters"});
+    const bool record_iterations = iters_out.GetDim(4) > 0;
+    // Empty unless inverter/warm_start is set
+    auto Wp_cache = rc->PackVariables(std::vector<std::string>{"inverter_Wp"});
+    const bool warm_start = Wp_cache.GetDim(4) > 0;
+    // Empty unless inverter/entropy_fallback is set
+    auto K_U = rc->PackVariables(std::vector<std::string>{"cons.Ktot"});
+    auto K_P = rc->PackVariables(std::vector<std::string>{"prims.Ktot"});
+    const bool entropy_fallback = pmb->packages.Get("Inverter")->Param<bool>("entropy_fallback") && K_U.GetDim(4) > 0;
+    const bool own_entropy = pmb->packages.Get("Inverter")->Param<bool>("own_entropy");
 
     if (U.GetDim(4) == 0 || pflag.GetDim(4) == 0)
         return;
@@ -116,14 +205,278 @@ inline void BlockPerformInversion(MeshBlockData<Real> *rc, IndexDomain domain, b
     auto bounds = coarse ? pmb->c_cellbounds : pmb->cellbounds;
     const IndexRange3 b = KDomain::GetPhysicalRange(rc);
 
+    Flag("U_to_P");
+    // Static estimates for the timing report: read U & geometry, write P & pflag, ~5 iterations
+    Timers::CountKernel("U_to_P", static_cast<double>(b.ke - b.ks + 1) * (b.je - b.js + 1) * (b.ie - b.is + 1), 32 * sizeof(Real), 600);
     pmb->par_for("U_to_P", b.ks, b.ke, b.js, b.je, b.is, b.ie,
         KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
             if (KDomain::inside(k, j, i, b)) {
                 // Run over all interior zones and any initialized ghosts
-                pflag(0, k, j, i) = static_cast<double>(Inverter::u_to_p<inverter>(G, U, m_u, gam, k, j, i, P, m_p, Loci::center));
+                int iters;
+                Inverter::Status status = (warm_start)
+                    ? Inverter::u_to_p_warm<inverter>(G, U, m_u, gam, k, j, i, P, m_p, Loci::center, iters, Wp_cache(0, k, j, i))
+                    : Inverter::u_to_p<inverter>(G, U, m_u, gam, k, j, i, P, m_p, Loci::center, iters);
+                if (entropy_fallback)
+                    status = Inverter::entropy_fallback(G, U, m_u, gam, K_U, K_P, own_entropy, k, j, i, P, m_p, status);
+                pflag(0, k, j, i) = static_cast<double>(status);
+                if (record_iterations) iters_out(0, k, j, i) = iters;
             }
         }
     );
+    EndFlag();
+}
+
+/**
+ * As BlockPerformInversion, over all blocks in md at once.
+ * Each block's physical range is different, so we copy them to the device
+ * and check against them inside the kernel.
+ */
+template<Inverter::Type inverter>
+inline void MeshPerformInversion(MeshData<Real> *md, IndexDomain domain, bool coarse)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+
+    PackIndexMap prims_map, cons_map;
+    auto U = GRMHD::PackMHDCons(md, cons_map);
+    auto P = GRMHD::PackHDPrims(md, prims_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+
+    auto pflag = md->PackVariables(std::vector<std::string>{"pflag"});
+    auto iters_out = md->PackVariables(std::vector<std::string>{"inverter_iters"});
+    const bool record_iterations = iters_out.GetDim(4) > 0;
+    auto Wp_cache = md->PackVariables(std::vector<std::string>{"inverter_Wp"});
+    const bool warm_start = Wp_cache.GetDim(4) > 0;
+    auto K_U = md->PackVariables(std::vector<std::string>{"cons.Ktot"});
+    auto K_P = md->PackVariables(std::vector<std::string>{"prims.Ktot"});
+    const bool entropy_fallback = pmb0->packages.Get("Inverter")->Param<bool>("entropy_fallback") && K_U.GetDim(4) > 0;
+    const bool own_entropy = pmb0->packages.Get("Inverter")->Param<bool>("own_entropy");
+
+    // Face-centered B, averaged here if B_CT::MeshUtoP isn't being run separately
+    const bool fuse_b = Inverter::FusesBCT(md, coarse);
+    auto B_Uf = md->PackVariables(std::vector<std::string>{"cons.fB"});
+    auto B_P = md->PackVariables(std::vector<std::string>{"prims.B"});
+    auto B_U = md->PackVariables(std::vector<std::string>{"cons.B"});
+
+    // Electron entropies, recovered here if Electrons::MeshUtoP isn't being run separately
+    const bool fuse_e = Inverter::FusesElectrons(md, coarse);
+    PackIndexMap e_prims_map, e_cons_map;
+    auto P_all = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, e_prims_map);
+    auto U_all = md->PackVariables(std::vector<MetadataFlag>{Metadata::Conserved}, e_cons_map);
+    const VarMap m_pa(e_prims_map, false), m_ua(e_cons_map, true);
+
+    if (U.GetDim(4) == 0 || pflag.GetDim(4) == 0) {
+        // Nothing to invert, but we promised to fill B & the electrons
+        if (fuse_b) B_CT::MeshUtoP(md, domain, coarse);
+        if (fuse_e) Electrons::MeshUtoP(md, domain, coarse);
+        return;
+    }
+
+    const Real gam = pmb0->packages.Get("GRMHD")->Param<Real>("gamma");
+
+    // Physical range of each block, see BlockPerformInversion
+    const int nblocks = U.GetDim(5);
+    const auto phys = KDomain::GetPhysicalRanges(md);
+
+    const IndexRange3 b = KDomain::GetRange(md, IndexDomain::entire);
+    // B is averaged over the requested domain, as in B_CT::MeshUtoP
+    const IndexRange3 bc = KDomain::GetRange(md, domain, coarse);
+    const int ndim = pmb0->pmy_mesh->ndim;
+    const IndexRange block = IndexRange{0, nblocks - 1};
+
+    Flag("U_to_P_mesh");
+    Timers::CountKernel("U_to_P", static_cast<double>(nblocks) * (b.ke - b.ks + 1) * (b.je - b.js + 1) * (b.ie - b.is + 1), 32 * sizeof(Real), 600);
+    pmb0->par_for("U_to_P_mesh", block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        KOKKOS_LAMBDA (const int& bl, const int &k, const int &j, const int &i) {
+            const auto& G = U.GetCoords(bl);
+            if (fuse_b && KDomain::inside(k, j, i, bc))
+                B_CT::face_to_center(G, B_Uf(bl), B_P(bl), B_U(bl), ndim, k, j, i);
+            if (KDomain::inside(k, j, i, phys, bl)) {
+                int iters;
+                Inverter::Status status = (warm_start)
+                    ? Inverter::u_to_p_warm<inverter>(G, U(bl), m_u, gam, k, j, i, P(bl), m_p, Loci::center, iters, Wp_cache(bl, 0, k, j, i))
+                    : Inverter::u_to_p<inverter>(G, U(bl), m_u, gam, k, j, i, P(bl), m_p, Loci::center, iters);
+                if (entropy_fallback)
+                    status = Inverter::entropy_fallback(G, U(bl), m_u, gam, K_U(bl), K_P(bl), own_entropy, k, j, i, P(bl), m_p, status);
+                pflag(bl, 0, k, j, i) = static_cast<double>(status);
+                if (record_iterations) iters_out(bl, 0, k, j, i) = iters;
+            }
+            // Over the requested domain, as in Electrons::MeshUtoP
+            if (fuse_e && KDomain::inside(k, j, i, bc))
+                Electrons::u_to_p(U_all(bl), m_ua, k, j, i, P_all(bl), m_pa);
+        }
+    );
+    EndFlag();
+}
+
+/**
+ * As MeshPerformInversion, additionally applying floors & ceilings to each zone
+ * immediately after it is inverted successfully.  This replaces the separate read & write
+ * of all primitives in Floors::ApplyGRMHDFloors.
+ * Packs all primitive & conserved variables, as floors need them, so this must
+ * only be used when the GRMHD primitives are the only ones full UtoP needs to set.
+ */
+template<Inverter::Type inverter, Floors::Frame frame>
+inline void MeshPerformInversionFloors(MeshData<Real> *md, IndexDomain domain, bool coarse)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+
+    PackIndexMap prims_map, cons_map;
+    auto P = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    auto U = md->PackVariables(std::vector<MetadataFlag>{Metadata::Conserved}, cons_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+
+    auto pflag = md->PackVariables(std::vector<std::string>{"pflag"});
+    auto fflag = md->PackVariables(std::vector<std::string>{"fflag"});
+    auto geom_cache = md->PackVariables(std::vector<std::string>{"floors_geom"});
+    const bool use_cache = geom_cache.GetDim(4) > 0;
+    auto iters_out = md->PackVariables(std::vector<std::string>{"inverter_iters"});
+    const bool record_iterations = iters_out.GetDim(4) > 0;
+    auto Wp_cache = md->PackVariables(std::vector<std::string>{"inverter_Wp"});
+    const bool warm_start = Wp_cache.GetDim(4) > 0;
+    auto K_U = md->PackVariables(std::vector<std::string>{"cons.Ktot"});
+    auto K_P = md->PackVariables(std::vector<std::string>{"prims.Ktot"});
+    const bool entropy_fallback = pmb0->packages.Get("Inverter")->Param<bool>("entropy_fallback") && K_U.GetDim(4) > 0;
+    const bool own_entropy = pmb0->packages.Get("Inverter")->Param<bool>("own_entropy");
+
+    // Face-centered B, averaged here if B_CT::MeshUtoP isn't being run separately
+    const bool fuse_b = Inverter::FusesBCT(md, coarse);
+    auto B_Uf = md->PackVariables(std::vector<std::string>{"cons.fB"});
+    auto B_P = md->PackVariables(std::vector<std::string>{"prims.B"});
+    auto B_U = md->PackVariables(std::vector<std::string>{"cons.B"});
+
+    if (U.GetDim(4) == 0 || pflag.GetDim(4) == 0 || fflag.GetDim(4) == 0) {
+        // Nothing to invert, but we promised to fill B
+        if (fuse_b) B_CT::MeshUtoP(md, domain, coarse);
+        return;
+    }
+
+    const Real gam = pmb0->packages.Get("GRMHD")->Param<Real>("gamma");
+    const Floors::Prescription floors(pmb0->packages.Get("Floors")->AllParams());
+    const EMHD::EMHD_parameters& emhd_params = EMHD::GetEMHDParameters(pmb0->packages);
+
+    const int nblocks = U.GetDim(5);
+    const auto phys = KDomain::GetPhysicalRanges(md);
+
+    const IndexRange3 b = KDomain::GetRange(md, IndexDomain::entire);
+    // B is averaged over the requested domain, as in B_CT::MeshUtoP
+    const IndexRange3 bc = KDomain::GetRange(md, domain, coarse);
+    const int ndim = pmb0->pmy_mesh->ndim;
+    const IndexRange block = IndexRange{0, nblocks - 1};
+
+    Flag("U_to_P_floors_mesh");
+    // As U_to_P, plus reading & writing back all variables & fflag for floors
+    Timers::CountKernel("U_to_P_floors", static_cast<double>(nblocks) * (b.ke - b.ks + 1) * (b.je - b.js + 1) * (b.ie - b.is + 1), (32 + 14) * sizeof(Real), 900);
+    pmb0->par_for("U_to_P_floors_mesh", block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        KOKKOS_LAMBDA (const int& bl, const int &k, const int &j, const int &i) {
+            const auto& G = U.GetCoords(bl);
+            if (fuse_b && KDomain::inside(k, j, i, bc))
+                B_CT::face_to_center(G, B_Uf(bl), B_P(bl), B_U(bl), ndim, k, j, i);
+            if (KDomain::inside(k, j, i, phys, bl)) {
+                int iters;
+                Inverter::Status status = (warm_start)
+                    ? Inverter::u_to_p_warm<inverter>(G, U(bl), m_u, gam, k, j, i, P(bl), m_p, Loci::center, iters, Wp_cache(bl, 0, k, j, i))
+                    : Inverter::u_to_p<inverter>(G, U(bl), m_u, gam, k, j, i, P(bl), m_p, Loci::center, iters);
+                if (entropy_fallback)
+                    status = Inverter::entropy_fallback(G, U(bl), m_u, gam, K_U(bl), K_P(bl), own_entropy, k, j, i, P(bl), m_p, status);
+                int pf = static_cast<int>(status);
+                int ff = 0;
+                // Failed zones are overwritten by FixUtoP, which floors them then
+                if (!Inverter::failed(status)) {
+                    // As in ApplyGRMHDFloors: pflag from any inversion inside the floors goes in the bottom bits
+                    Real rhoflr_geom, uflr_geom;
+                    bool use_ff;
+                    if (use_cache) Floors::geo_floor_values(G, gam, k, j, i, floors, geom_cache(bl), rhoflr_geom, uflr_geom, use_ff);
+                    else Floors::geo_floor_values(G, gam, k, j, i, floors, Loci::center, rhoflr_geom, uflr_geom, use_ff);
+                    const int comboflag = Floors::apply_floors<frame>(G, P(bl), m_p, gam, emhd_params, k, j, i, floors,
+                                                                      rhoflr_geom, uflr_geom, use_ff, U(bl), m_u);
+                    ff = (comboflag / FFlag::MINIMUM) * FFlag::MINIMUM;
+                    if (comboflag % FFlag::MINIMUM) pf = comboflag % FFlag::MINIMUM;
+                    ff |= Floors::apply_ceilings(G, P(bl), m_p, gam, k, j, i, floors, U(bl), m_u);
+                }
+                pflag(bl, 0, k, j, i) = pf;
+                fflag(bl, 0, k, j, i) = ff;
+                if (record_iterations) iters_out(bl, 0, k, j, i) = iters;
+            }
+        }
+    );
+    EndFlag();
+}
+
+/**
+ * Select the floor frame for MeshPerformInversionFloors, see Floors::Frame
+ */
+template<Inverter::Type inverter>
+inline void MeshPerformInversionFloors(MeshData<Real> *md, IndexDomain domain, bool coarse)
+{
+    const Floors::Prescription floors(md->GetMeshPointer()->packages.Get("Floors")->AllParams());
+    switch (floors.frame()) {
+    case Floors::Frame::fluid:
+        MeshPerformInversionFloors<inverter, Floors::Frame::fluid>(md, domain, coarse);
+        break;
+    case Floors::Frame::mixed:
+        MeshPerformInversionFloors<inverter, Floors::Frame::mixed>(md, domain, coarse);
+        break;
+    case Floors::Frame::drift:
+        MeshPerformInversionFloors<inverter, Floors::Frame::drift>(md, domain, coarse);
+        break;
+    default:
+        MeshPerformInversionFloors<inverter, Floors::Frame::normal>(md, domain, coarse);
+        break;
+    }
+}
+
+bool Inverter::FusesBCT(MeshData<Real> *md, bool coarse)
+{
+    auto& packages = md->GetMeshPointer()->packages;
+    return !coarse && packages.AllPackages().count("B_CT")
+           && packages.Get("Inverter")->Param<bool>("fuse_b_ct")
+           && packages.Get("Inverter")->Param<Type>("inverter_type") != Type::none;
+}
+
+bool Inverter::FusesElectrons(MeshData<Real> *md, bool coarse)
+{
+    auto& packages = md->GetMeshPointer()->packages;
+    return !coarse && packages.AllPackages().count("Electrons")
+           && packages.Get("Inverter")->Param<bool>("fuse_electrons")
+           && packages.Get("Inverter")->Param<Type>("inverter_type") != Type::none;
+}
+
+void Inverter::MeshUtoPFloors(MeshData<Real> *md, IndexDomain domain, bool coarse)
+{
+    // As MeshUtoP
+    auto& type = md->GetMeshPointer()->packages.Get("Inverter")->Param<Type>("inverter_type");
+    switch(type) {
+    case Type::onedw:
+        MeshPerformInversionFloors<Type::onedw>(md, domain, coarse);
+        break;
+    case Type::onedw_analytic:
+        MeshPerformInversionFloors<Type::onedw_analytic>(md, domain, coarse);
+        break;
+    case Type::kastaun:
+        MeshPerformInversionFloors<Type::kastaun>(md, domain, coarse);
+        break;
+    case Type::none:
+        break;
+    }
+}
+
+void Inverter::MeshUtoP(MeshData<Real> *md, IndexDomain domain, bool coarse)
+{
+    // As BlockUtoP, only chooses an implementation
+    auto& type = md->GetMeshPointer()->packages.Get("Inverter")->Param<Type>("inverter_type");
+    switch(type) {
+    case Type::onedw:
+        MeshPerformInversion<Type::onedw>(md, domain, coarse);
+        break;
+    case Type::onedw_analytic:
+        MeshPerformInversion<Type::onedw_analytic>(md, domain, coarse);
+        break;
+    case Type::kastaun:
+        MeshPerformInversion<Type::kastaun>(md, domain, coarse);
+        break;
+    case Type::none:
+        break;
+    }
 }
 
 void Inverter::BlockUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse)
@@ -134,12 +487,40 @@ void Inverter::BlockUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coars
     case Type::onedw:
         BlockPerformInversion<Type::onedw>(rc, domain, coarse);
         break;
+    case Type::onedw_analytic:
+        BlockPerformInversion<Type::onedw_analytic>(rc, domain, coarse);
+        break;
+    case Type::kastaun:
+        BlockPerformInversion<Type::kastaun>(rc, domain, coarse);
+        break;
     case Type::none:
         break;
     }
     //Reductions::StartFlagReduce(md, "pflag", Inverter::status_names, IndexDomain::interior, false, 1);
 }
 
+void Inverter::InitEntropy(MeshBlockData<Real> *rc)
+{
+    auto pmb = rc->GetBlockPointer();
+    if (!pmb->packages.Get("Inverter")->Param<bool>("own_entropy"))
+        return;
+
+    Flag("InitEntropy");
+    GridScalar K = rc->Get("prims.Ktot").data;
+    GridScalar rho = rc->Get("prims.rho").data;
+    GridScalar u = rc->Get("prims.u").data;
+    const Real gam = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
+
+    // Conserved Ktot is set from this along with everything else, in PostInitialize
+    const IndexRange3 b = KDomain::GetRange(rc, IndexDomain::entire);
+    pmb->par_for("init_entropy", b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
+            K(k, j, i) = (gam - 1.) * u(k, j, i) * m::pow(rho(k, j, i), -gam);
+        }
+    );
+    EndFlag();
+}
+
 TaskStatus Inverter::PostStepDiagnostics(const SimTime& tm, MeshData<Real> *md)
 {
     auto pmesh = md->GetMeshPointer();
@@ -152,8 +533,12 @@ TaskStatus Inverter::PostStepDiagnostics(const SimTime& tm, MeshData<Real> *md)
     // TODO grab the total and die on too many
     if (flag_verbose >= 1) {
         // TODO this should move into UtoP when everything goes MeshData
-        Reductions::StartFlagReduce(md, "pflag", Inverter::status_names, IndexDomain::interior, false, 1);
-        Reductions::CheckFlagReduceAndPrintHits(md, "pflag", Inverter::status_names, IndexDomain::interior, false, 1);
+        // With floors, pflags were counted & reported alongside fflags in Floors::PostStepDiagnostics,
+        // which runs first (packages are visited in name order)
+        if (!pmesh->packages.AllPackages().count("Floors")) {
+            Reductions::StartFlagReduce(md, "pflag", Inverter::status_names, IndexDomain::interior, false, 1);
+            Reductions::CheckFlagReduceAndPrintHits(md, "pflag", Inverter::status_names, IndexDomain::interior, false, 1);
+        }
     }
 
     return TaskStatus::complete;
@@ -40,6 +40,8 @@
 // Additionally, invert_template contains the Type and Status enums
 #include "invert_template.hpp"
 #include "onedw.hpp"
+#include "kastaun.hpp"
+#include "entropy.hpp"
 
 #include "pack.hpp"
 
@@ -47,8 +49,9 @@ using namespace parthenon;
 
 /**
  * Recover primitive variables from conserved forms.
- * Currently can only use the 1D_W scheme of Noble et al. (2006),
- * but this is the spot for alternate implementations
+ * Either the 1D_W scheme of Noble et al. (2006), or the bracketed
+ * scheme of Kastaun et al. (2021), selected with inverter/type.
+ * Optionally falls back to an inversion using the advected entropy, see entropy.hpp
  */
 namespace Inverter {
 
@@ -64,6 +67,31 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
  * output: U and P match down to inversion errors
  */
 void BlockUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse);
+/**
+ * As BlockUtoP, but over every block in md with a single kernel launch.
+ * Used by Packages::MeshUtoP in place of one BlockUtoP call per block.
+ */
+void MeshUtoP(MeshData<Real> *md, IndexDomain domain, bool coarse);
+
+/**
+ * Whether the inverter's mesh kernels also average B_CT's face-centered field to zone centers,
+ * so that the B used by each zone's inversion is computed in the same thread.
+ * True when B_CT is loaded, inverter/fuse_b_ct is set, and the inverter is not disabled.
+ * Only fine (non-coarse) buffers are handled: when this is false, B_CT runs its own MeshUtoP first.
+ */
+bool FusesBCT(MeshData<Real> *md, bool coarse);
+
+/**
+ * Whether the inverter's mesh kernel also recovers the electron entropies, in the same zone loop as the fluid.
+ * As FusesBCT, for inverter/fuse_electrons.  When this is false, Electrons runs its own MeshUtoP afterward.
+ */
+bool FusesElectrons(MeshData<Real> *md, bool coarse);
+
+/**
+ * As MeshUtoP, also applying GRMHD floors & ceilings to zones which invert successfully.
+ * Used when inverter/fuse_floors is set, see KHARMADriver::MakeDefaultTaskCollection
+ */
+void MeshUtoPFloors(MeshData<Real> *md, IndexDomain domain, bool coarse);
 
 /**
  * Smooth over inversion failures, usually by averaging values of the primitive variables from each neighboring zone
@@ -72,13 +100,17 @@ void BlockUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse);
  * LOCKSTEP: this function expects and should preserve P<->U
  */
 TaskStatus FixUtoP(MeshBlockData<Real> *rc);
-inline TaskStatus MeshFixUtoP(MeshData<Real> *md) {
-    Flag("MeshFixUtoP");
-    for (int i=0; i < md->NumBlocks(); ++i)
-        FixUtoP(md->GetBlockData(i).get());
-    EndFlag();
-    return TaskStatus::complete;
-}
+/**
+ * As FixUtoP, over all blocks in md in one launch per step.
+ * Zones are only averaged with neighbors in the same block, as in FixUtoP.
+ */
+TaskStatus MeshFixUtoP(MeshData<Real> *md);
+
+/**
+ * Initialize the advected entropy Ktot from the primitives, when it is kept by the inverter
+ * for inverter/entropy_fallback (i.e. when electrons are disabled)
+ */
+void InitEntropy(MeshBlockData<Real> *rc);
 
 /**
  * Print details of any inversion failures or fixed zones
@@ -0,0 +1,194 @@
+/* 
+ *  File: kastaun.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+// General template
+// We define a specialization based on the Inverter::Type parameter
+#include "invert_template.hpp"
+// For the shared conversion of U to four-vectors
+#include "onedw.hpp"
+
+#include "grmhd_functions.hpp"
+#include "kharma_utils.hpp"
+
+namespace Inverter {
+
+// Relative tolerance on mu, and maximum bracketing iterations.
+// The method always converges, so this is just a guard
+static constexpr Real KASTAUN_ERRTOL = 1.e-10;
+static constexpr int  KASTAUN_ITER_MAX = 64;
+
+/**
+ * State of the Kastaun et al. (2021) scheme: all quantities normalized by D,
+ * see their Section 3.  r and b are 3-vectors in the normal observer frame.
+ */
+struct KastaunState {
+    Real q;     // tau/D
+    Real rsq;   // r_i r^i
+    Real bsq;   // b_i b^i
+    Real rbsq;  // (r_i b^i)^2
+    Real v0sq;  // Limit on v^2 for physical states
+};
+
+/**
+ * Quantities of the Kastaun scheme depending on the iteration variable mu = 1/(hW)
+ */
+KOKKOS_INLINE_FUNCTION void kastaun_rbar_qbar(const KastaunState& s, const Real& mu, Real& x, Real& rbarsq, Real& qbar)
+{
+    x = 1. / (1. + mu * s.bsq);
+    rbarsq = s.rsq * x * x + mu * x * (1. + x) * s.rbsq;
+    qbar = s.q - 0.5 * s.bsq - 0.5 * mu * mu * x * x * m::max(s.bsq * s.rsq - s.rbsq, 0.);
+}
+
+/**
+ * Auxiliary function, whose root bounds that of the master function from above (eq. 49)
+ */
+KOKKOS_INLINE_FUNCTION Real kastaun_aux(const KastaunState& s, const Real& mu)
+{
+    Real x, rbarsq, qbar;
+    kastaun_rbar_qbar(s, mu, x, rbarsq, qbar);
+    // Minimum enthalpy of the ideal gas is h0 = 1
+    return mu * m::sqrt(1. + rbarsq) - 1.;
+}
+
+/**
+ * Master function (eq. 44), also returning the corresponding Lorentz factor
+ * and specific internal energy.  eps is returned un-clipped, so the caller can flag negative values.
+ */
+KOKKOS_INLINE_FUNCTION Real kastaun_master(const KastaunState& s, const Real& gam, const Real& mu,
+                                           Real& W, Real& eps)
+{
+    Real x, rbarsq, qbar;
+    kastaun_rbar_qbar(s, mu, x, rbarsq, qbar);
+
+    const Real vsq = m::min(mu * mu * rbarsq, s.v0sq);
+    W = 1. / m::sqrt(1. - vsq);
+    eps = W * (qbar - mu * rbarsq) + vsq * W * W / (1. + W);
+
+    // Limit to the range of the ideal gas EOS
+    const Real eps_c = m::max(eps, 0.);
+    const Real a = (gam - 1.) * eps_c / (1. + eps_c);
+    const Real nu_a = (1. + a) * (1. + eps_c) / W;
+    const Real nu_b = (1. + a) * (1. + qbar - mu * rbarsq);
+    const Real nu = m::max(nu_a, nu_b);
+
+    return mu - 1. / (nu + mu * rbarsq);
+}
+
+/**
+ * Root of f on [a, b] with the Illinois variant of regula falsi,
+ * which keeps the root bracketed and converges superlinearly.
+ * Requires f(a) <= 0 <= f(b), true for both functions above.
+ */
+template<typename F>
+KOKKOS_INLINE_FUNCTION Real kastaun_illinois(const F& f, Real a, Real b, int& iters)
+{
+    Real fa = f(a), fb = f(b);
+    for (iters = 0; iters < KASTAUN_ITER_MAX; iters++) {
+        if (fb == 0.) break;
+        const Real c = (fb != fa) ? b - fb * (b - a) / (fb - fa) : 0.5 * (a + b);
+        const Real fc = f(c);
+        if (fc * fb < 0.) {
+            a = b; fa = fb;
+        } else {
+            fa *= 0.5;
+        }
+        const Real step = c - b;
+        b = c; fb = fc;
+        if (m::abs(step) < KASTAUN_ERRTOL * m::abs(b)) break;
+    }
+    return b;
+}
+
+/**
+ * Bracketed inverter of Kastaun, Kalinani & Ciolfi (2021), PRD 103, 023018.
+ * Solves a single well-behaved equation in mu = 1/(hW), on an interval
+ * guaranteed to contain exactly one root, so it does not depend on the initial guess
+ * and fails only for unphysical input.
+ */
+template <>
+KOKKOS_INLINE_FUNCTION Status u_to_p<Type::kastaun>(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                              const Real& gam, const int& k, const int& j, const int& i,
+                                              const VariablePack<Real>& P, const VarMap& m_p,
+                                              const Loci loc, int& iters)
+{
+    iters = 0;
+    // Same projections of the conserved variables as 1D_W
+    OneDWState st;
+    const Status setup = onedw_setup(G, U, m_u, k, j, i, loc, st);
+    if (setup != Status::success) return setup;
+    const Real &D = st.D, &QdB = st.QdB;
+
+    // Normalized state
+    KastaunState s;
+    s.q    = st.Ep / D;
+    s.rsq  = st.Qtsq / (D * D);
+    s.bsq  = st.Bsq / D;
+    s.rbsq = QdB * QdB / (D * D * D);
+    s.v0sq = s.rsq / (1. + s.rsq);
+
+    // Bracket the root from above with that of the auxiliary function
+    int iters_aux = 0;
+    const Real mu_h = kastaun_illinois([&](const Real& mu_) { return kastaun_aux(s, mu_); },
+                                       0., 1., iters_aux);
+
+    // Solve the master function on [0, mu_h]
+    Real W, eps;
+    const Real mu = kastaun_illinois([&](const Real& mu_) { return kastaun_master(s, gam, mu_, W, eps); },
+                                     0., mu_h, iters);
+    // Recover W, eps at the final mu
+    kastaun_master(s, gam, mu, W, eps);
+    if (iters_aux >= KASTAUN_ITER_MAX || iters >= KASTAUN_ITER_MAX) return Status::max_iter;
+    iters += iters_aux;
+
+    const Real rho = D / W;
+    const Real u = rho * eps;
+    // Return without updating non-B primitives.  rho > 0 since D > 0
+    if (u < 0) return Status::neg_u;
+
+    // Set primitives
+    P(m_p.RHO, k, j, i) = rho;
+    P(m_p.UU, k, j, i) = u;
+
+    // Velocity v^i = mu x (r^i + mu (r.b) b^i) (eq. 68), returned as W v^i
+    const Real x = 1. / (1. + mu * s.bsq);
+    const Real pre = W * mu * x / D;
+    P(m_p.U1, k, j, i) = pre * (st.Qtcon[1] + mu * QdB * st.Bcon[1] / D);
+    P(m_p.U2, k, j, i) = pre * (st.Qtcon[2] + mu * QdB * st.Bcon[2] / D);
+    P(m_p.U3, k, j, i) = pre * (st.Qtcon[3] + mu * QdB * st.Bcon[3] / D);
+
+    return Status::success;
+}
+
+} // namespace Inverter
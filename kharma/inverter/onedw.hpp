@@ -44,26 +44,26 @@ namespace Inverter {
 
 // TODO TODO MOVE AWAY
 // Accuracy required for U to P
-static constexpr Real UTOP_ERRTOL = 1.e-8;
+static constexpr GReal UTOP_ERRTOL = 1.e-8;
 // Maximum iterations when doing U to P inversion
 static constexpr int  UTOP_ITER_MAX = 8;
 // Heuristic step size
-static constexpr Real DELTA = 1e-5;
+static constexpr GReal DELTA = 1e-5;
 
 // Could put support fns in their own namespace, but I'm lazy
 /**
  * Fluid relativistic factor gamma in terms of inversion state variables of the Noble 1D_W inverter
  */
-KOKKOS_INLINE_FUNCTION Real lorentz_calc_w(const Real& Bsq, const Real& D, const Real& QdB,
-                                           const Real& Qtsq, const Real& Wp)
+KOKKOS_INLINE_FUNCTION GReal lorentz_calc_w(const GReal& Bsq, const GReal& D, const GReal& QdB,
+                                           const GReal& Qtsq, const GReal& Wp)
 {
-    const Real QdBsq = QdB * QdB;
-    const Real W = Wp + D;
-    const Real W2 = W * W;
-    const Real WB = W + Bsq;
+    const GReal QdBsq = QdB * QdB;
+    const GReal W = Wp + D;
+    const GReal W2 = W * W;
+    const GReal WB = W + Bsq;
 
     // This is basically inversion of eq. A7 of Mignone & McKinney
-    const Real utsq = -((W + WB) * QdBsq + W2 * Qtsq) / (QdBsq * (W + WB) + W2 * (Qtsq - WB * WB));
+    const GReal utsq = -((W + WB) * QdBsq + W2 * Qtsq) / (QdBsq * (W + WB) + W2 * (Qtsq - WB * WB));
 
     // Catch utsq < 0 and YELL
     // TODO latter number should be ~1e3*GAMMAMAX^2
@@ -77,28 +77,74 @@ KOKKOS_INLINE_FUNCTION Real lorentz_calc_w(const Real& Bsq, const Real& D, const
 /**
  * Error metric for Newton-Raphson step in Noble 1D_W inverter
  */
-KOKKOS_INLINE_FUNCTION Real err_eqn(const Real& gam, const Real& Bsq, const Real& D, const Real& Ep, const Real& QdB,
-                                    const Real& Qtsq, const Real& Wp, Status& eflag)
+KOKKOS_INLINE_FUNCTION GReal err_eqn(const GReal& gam, const GReal& Bsq, const GReal& D, const GReal& Ep, const GReal& QdB,
+                                    const GReal& Qtsq, const GReal& Wp, Status& eflag)
 {
-    const Real W = Wp + D;
-    const Real gamma = lorentz_calc_w(Bsq, D, QdB, Qtsq, Wp);
+    const GReal W = Wp + D;
+    const GReal gamma = lorentz_calc_w(Bsq, D, QdB, Qtsq, Wp);
     if (gamma < 1) eflag = Status::bad_ut;
-    const Real w = W / (gamma*gamma);
-    const Real rho = D / gamma;
-    const Real p = (w - rho) * (gam - 1) / gam;
+    const GReal w = W / (gamma*gamma);
+    const GReal rho = D / gamma;
+    const GReal p = (w - rho) * (gam - 1) / gam;
 
     return -Ep + Wp - p + 0.5 * Bsq + 0.5 * (Bsq * Qtsq - QdB * QdB) / SQR(Bsq + W);
 
 }
 
 /**
- * 1D_W inverter from Ressler et al. 2006.
+ * Derivative d(err_eqn)/dW', computed analytically from the same expressions.
+ * Returns the error as err_eqn would, with the derivative in dedW
  */
-template <>
-KOKKOS_INLINE_FUNCTION Status u_to_p<Type::onedw>(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
-                                              const Real& gam, const int& k, const int& j, const int& i,
-                                              const VariablePack<Real>& P, const VarMap& m_p,
-                                              const Loci loc)
+KOKKOS_INLINE_FUNCTION GReal err_eqn_deriv(const GReal& gam, const GReal& Bsq, const GReal& D, const GReal& Ep, const GReal& QdB,
+                                          const GReal& Qtsq, const GReal& Wp, Status& eflag, GReal& dedW)
+{
+    const GReal QdBsq = QdB * QdB;
+    const GReal W = Wp + D;
+    const GReal W2 = W * W;
+    const GReal WB = W + Bsq;
+
+    // utsq = N / Dn as in lorentz_calc_w, and its derivative wrt W (== wrt W')
+    const GReal N  = -((W + WB) * QdBsq + W2 * Qtsq);
+    const GReal Dn = QdBsq * (W + WB) + W2 * (Qtsq - WB * WB);
+    const GReal dN  = -2. * (QdBsq + W * Qtsq);
+    const GReal dDn = 2. * QdBsq + 2. * W * (Qtsq - WB * WB) - 2. * W2 * WB;
+    const GReal utsq = N / Dn;
+    const GReal dutsq = (dN * Dn - N * dDn) / (Dn * Dn);
+
+    if (utsq < -1.e-15 || utsq > 1.e7) {
+        eflag = Status::bad_ut;
+        // Fall back to the derivative without velocity dependence
+        dedW = 1. - (gam - 1) / gam - (Bsq * Qtsq - QdBsq) / (WB * WB * WB);
+        return err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wp, eflag);
+    }
+
+    const GReal gamma = m::sqrt(1. + m::abs(utsq));
+    const GReal dgamma = 0.5 * dutsq / gamma;
+    const GReal w = W / (gamma*gamma);
+    const GReal rho = D / gamma;
+    const GReal p = (w - rho) * (gam - 1) / gam;
+    const GReal dw = 1. / (gamma*gamma) - 2. * W * dgamma / (gamma*gamma*gamma);
+    const GReal drho = -D * dgamma / (gamma*gamma);
+    const GReal dp = (dw - drho) * (gam - 1) / gam;
+
+    dedW = 1. - dp - (Bsq * Qtsq - QdBsq) / (WB * WB * WB);
+    return -Ep + Wp - p + 0.5 * Bsq + 0.5 * (Bsq * Qtsq - QdBsq) / SQR(WB);
+}
+
+/**
+ * Projections of the conserved variables used by the 1D_W inverters (and Kastaun)
+ */
+struct OneDWState {
+    GReal D, Bsq, QdB, Qtsq, Ep;
+    GReal Bcon[GR_DIM], Qtcon[GR_DIM];
+};
+
+/**
+ * Convert from conserved variables to the four-vectors & scalars of Noble et al. 2006
+ */
+KOKKOS_INLINE_FUNCTION Status onedw_setup(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                          const int& k, const int& j, const int& i, const Loci loc,
+                                          OneDWState& s)
 {
     // if (i == 10 && j == 11)
     //     printf("CONS: %g %g %g %g %g %g %g %g", U(m_u.RHO, k, j, i), U(m_u.UU, k, j, i), U(m_u.U1, k, j, i), U(m_u.U2, k, j, i),
@@ -109,87 +155,138 @@ KOKKOS_INLINE_FUNCTION Status u_to_p<Type::onedw>(const GRCoordinates &G, const
     }
 
     // Convert from conserved variables to four-vectors
-    const Real alpha = 1./m::sqrt(-G.gcon(loc, j, i, 0, 0));
-    const Real gdet = G.gdet(loc, j, i);
-    const Real a_over_g = alpha / gdet;
-    const Real D = U(m_u.RHO, k, j, i) * a_over_g;
+    const GReal alpha = 1./m::sqrt(-G.gcon(loc, j, i, 0, 0));
+    const GReal gdet = G.gdet(loc, j, i);
+    const GReal a_over_g = alpha / gdet;
+    s.D = U(m_u.RHO, k, j, i) * a_over_g;
 
-    Real Bcon[GR_DIM] = {0};
+    DLOOP1 s.Bcon[mu] = 0.;
     if (m_u.B1 >= 0) {
-        Bcon[1] = U(m_u.B1, k, j, i) * a_over_g;
-        Bcon[2] = U(m_u.B2, k, j, i) * a_over_g;
-        Bcon[3] = U(m_u.B3, k, j, i) * a_over_g;
+        s.Bcon[1] = U(m_u.B1, k, j, i) * a_over_g;
+        s.Bcon[2] = U(m_u.B2, k, j, i) * a_over_g;
+        s.Bcon[3] = U(m_u.B3, k, j, i) * a_over_g;
     }
 
-    const Real Qcov[GR_DIM] =
+    const GReal Qcov[GR_DIM] =
         {(U(m_u.UU, k, j, i) - U(m_u.RHO, k, j, i)) * a_over_g,
           U(m_u.U1, k, j, i) * a_over_g,
           U(m_u.U2, k, j, i) * a_over_g,
           U(m_u.U3, k, j, i) * a_over_g};
 
-    const Real ncov[GR_DIM] = {(Real) -alpha, 0., 0., 0.};
+    const GReal ncov[GR_DIM] = {(GReal) -alpha, 0., 0., 0.};
 
-    // TODO faster with on-the-fly gcon/cov?
-    Real Bcov[GR_DIM], Qcon[GR_DIM], ncon[GR_DIM];
-    G.lower(Bcon, Bcov, k, j, i, loc);
-    G.raise(Qcov, Qcon, k, j, i, loc);
-    G.raise(ncov, ncon, k, j, i, loc);
+    // Raise & lower in geometry precision, rather than through G.lower/G.raise in Real
+    GReal Bcov[GR_DIM] = {0}, Qcon[GR_DIM] = {0}, ncon[GR_DIM] = {0};
+    DLOOP2 {
+        Bcov[mu] += G.gcov(loc, j, i, mu, nu) * s.Bcon[nu];
+        Qcon[mu] += G.gcon(loc, j, i, mu, nu) * Qcov[nu];
+        ncon[mu] += G.gcon(loc, j, i, mu, nu) * ncov[nu];
+    }
 
-    const Real Bsq = dot(Bcon, Bcov);
-    const Real QdB = dot(Bcon, Qcov);
-    const Real Qdotn = dot(Qcon, ncov);
+    s.Bsq = dot(s.Bcon, Bcov);
+    s.QdB = dot(s.Bcon, Qcov);
+    const GReal Qdotn = dot(Qcon, ncov);
 
-    Real Qtcon[GR_DIM];
-    DLOOP1 Qtcon[mu] = Qcon[mu] + ncon[mu] * Qdotn;
-    const Real Qtsq = dot(Qcon, Qcov) + Qdotn*Qdotn;
+    DLOOP1 s.Qtcon[mu] = Qcon[mu] + ncon[mu] * Qdotn;
+    s.Qtsq = dot(Qcon, Qcov) + Qdotn*Qdotn;
 
     // Set up eqtn for W'; this is the energy density
-    const Real Ep = -Qdotn - D;
+    s.Ep = -Qdotn - s.D;
+
+    return Status::success;
+}
+
+/**
+ * Initial guess for W' from the current primitives
+ */
+KOKKOS_INLINE_FUNCTION Status onedw_guess(const GRCoordinates &G, const VariablePack<Real>& P, const VarMap& m_p,
+                                          const GReal& gam, const int& k, const int& j, const int& i, const Loci loc,
+                                          GReal& Wp)
+{
+    const GReal gamma = GRMHD::lorentz_calc(G, P, m_p, k, j, i, loc);
+    if (gamma < 1) return Status::bad_ut;
+    const GReal rho = P(m_p.RHO, k, j, i), u = P(m_p.UU, k, j, i);
+
+    Wp = (rho + u + (gam - 1) * u) * gamma * gamma - rho * gamma;
+    return Status::success;
+}
+
+/**
+ * Set the fluid primitives from a converged W', or return why not
+ */
+KOKKOS_INLINE_FUNCTION Status onedw_set_prims(const OneDWState& s, const GReal& gam, const GReal& Wp,
+                                              const int& k, const int& j, const int& i,
+                                              const VariablePack<Real>& P, const VarMap& m_p)
+{
+    // Find utsq, gamma, rho from Wp
+    const GReal gamma = lorentz_calc_w(s.Bsq, s.D, s.QdB, s.Qtsq, Wp);
+    if (gamma < 1) return Status::bad_ut;
+
+    const GReal rho = s.D / gamma;
+    const GReal W = Wp + s.D;
+    const GReal w = W / (gamma*gamma);
+    const GReal p = (w - rho) * (gam - 1) / gam;
+    const GReal u = w - (rho + p);
+
+    // Return without updating non-B primitives
+    if (rho < 0 && u < 0) return Status::neg_rhou;
+    else if (rho < 0) return Status::neg_rho;
+    else if (u < 0) return Status::neg_u;
+
+    // Set primitives
+    P(m_p.RHO, k, j, i) = rho;
+    P(m_p.UU, k, j, i) = u;
 
-    // Numerical rootfinding
+    // Find u(tilde); Eqn. 31 of Noble et al.
+    const GReal pre = (gamma / (W + s.Bsq));
+    P(m_p.U1, k, j, i) = pre * (s.Qtcon[1] + s.QdB * s.Bcon[1] / W);
+    P(m_p.U2, k, j, i) = pre * (s.Qtcon[2] + s.QdB * s.Bcon[2] / W);
+    P(m_p.U3, k, j, i) = pre * (s.Qtcon[3] + s.QdB * s.Bcon[3] / W);
+
+    return Status::success;
+}
+
+/**
+ * Iteration of the original 1D_W: one Halley step using finite differences, then secant steps.
+ * Modifies Wp in place from its initial guess
+ */
+KOKKOS_INLINE_FUNCTION Status onedw_iterate(const OneDWState& s, const GReal& gam, GReal& Wp, int& iters)
+{
+    const GReal &D = s.D, &Bsq = s.Bsq, &QdB = s.QdB, &Qtsq = s.Qtsq, &Ep = s.Ep;
 
     // Accumulator for errors in err_eqn
     Status eflag = Status::success;
 
-    // Initial guess from primitives:
-    Real Wp, err;
-    {
-        const Real gamma = GRMHD::lorentz_calc(G, P, m_p, k, j, i, loc);
-        if (gamma < 1) return Status::bad_ut;
-        const Real rho = P(m_p.RHO, k, j, i), u = P(m_p.UU, k, j, i);
-
-        Wp = (rho + u + (gam - 1) * u) * gamma * gamma - rho * gamma;
-        err = err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wp, eflag);
-    }
+    GReal err = err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wp, eflag);
 
-    Real dW;
+    GReal dW;
     {
         // Step around the guess & evaluate errors
-        const Real Wpm = (1. - DELTA) * Wp; //heuristic
-        const Real h = Wp - Wpm;
-        const Real Wpp = Wp + h;
-        const Real errm = err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wpm, eflag);
-        const Real errp = err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wpp, eflag);
+        const GReal Wpm = (1. - DELTA) * Wp; //heuristic
+        const GReal h = Wp - Wpm;
+        const GReal Wpp = Wp + h;
+        const GReal errm = err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wpm, eflag);
+        const GReal errp = err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wpp, eflag);
 
         // Attempt a Halley/Muller/Bailey/Press step
-        const Real dedW = (errp - errm) / (Wpp - Wpm);
-        const Real dedW2 = (errp - 2. * err + errm) / (h*h);
+        const GReal dedW = (errp - errm) / (Wpp - Wpm);
+        const GReal dedW2 = (errp - 2. * err + errm) / (h*h);
         // TODO look into changing these clipped values?
-        const Real f = clip(0.5 * err * dedW2 / (dedW*dedW), -0.3, 0.3);
+        const GReal f = clip(0.5 * err * dedW2 / (dedW*dedW), -0.3, 0.3);
 
         dW = clip(-err / dedW / (1. - f), -0.5*Wp, 2.0*Wp);
     }
 
     // Take the first step
-    Real Wp1 = Wp;
-    Real err1 = err;
+    GReal Wp1 = Wp;
+    GReal err1 = err;
     Wp += dW;
     err = err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wp, eflag);
 
     // Not good enough?  apply secant method
     int iter = 0;
     for (iter = 0; iter < UTOP_ITER_MAX; iter++) {
-        dW = clip((Wp1 - Wp) * err / (err - err1), (Real) -0.5*Wp, (Real) 2.0*Wp);
+        dW = clip((Wp1 - Wp) * err / (err - err1), (GReal) -0.5*Wp, (GReal) 2.0*Wp);
 
         Wp1 = Wp;
         err1 = err;
@@ -202,38 +299,137 @@ KOKKOS_INLINE_FUNCTION Status u_to_p<Type::onedw>(const GRCoordinates &G, const
 
         if (m::abs(err / Wp) < UTOP_ERRTOL) break;
     }
+    iters = iter + 1;
     // If there was a bad gamma calculation, do not set primitives other than B
     // Uncomment to error on any bad velocity.  iharm2d/3d do not do this.
     //if (eflag) return eflag;
     // Return failure to converge
     if (iter == UTOP_ITER_MAX) return Status::max_iter;
+    return Status::success;
+}
 
-    // Find utsq, gamma, rho from Wp
-    const Real gamma = lorentz_calc_w(Bsq, D, QdB, Qtsq, Wp);
-    if (gamma < 1) return Status::bad_ut;
+/**
+ * Plain Newton-Raphson steps using the analytic derivative of err_eqn:
+ * one residual evaluation per iteration, quadratic convergence
+ */
+KOKKOS_INLINE_FUNCTION Status onedw_iterate_analytic(const OneDWState& s, const GReal& gam, GReal& Wp, int& iters)
+{
+    Status eflag = Status::success;
+    int iter = 0;
+    for (iter = 0; iter < UTOP_ITER_MAX; iter++) {
+        GReal dedW;
+        const GReal err = err_eqn_deriv(gam, s.Bsq, s.D, s.Ep, s.QdB, s.Qtsq, Wp, eflag, dedW);
+        if (m::abs(err / Wp) < UTOP_ERRTOL) break;
 
-    const Real rho = D / gamma;
-    const Real W = Wp + D;
-    const Real w = W / (gamma*gamma);
-    const Real p = (w - rho) * (gam - 1) / gam;
-    const Real u = w - (rho + p);
+        const GReal dW = clip(-err / dedW, (GReal) -0.5*Wp, (GReal) 2.0*Wp);
+        Wp += dW;
 
-    // Return without updating non-B primitives
-    if (rho < 0 && u < 0) return Status::neg_rhou;
-    else if (rho < 0) return Status::neg_rho;
-    else if (u < 0) return Status::neg_u;
+        if (m::abs(dW / Wp) < UTOP_ERRTOL) break;
+    }
+    iters = iter + 1;
+    if (iter == UTOP_ITER_MAX) return Status::max_iter;
+    return Status::success;
+}
 
-    // Set primitives
-    P(m_p.RHO, k, j, i) = rho;
-    P(m_p.UU, k, j, i) = u;
+/**
+ * 1D_W inverter from Ressler et al. 2006.
+ */
+template <>
+KOKKOS_INLINE_FUNCTION Status u_to_p<Type::onedw>(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                              const Real& gam, const int& k, const int& j, const int& i,
+                                              const VariablePack<Real>& P, const VarMap& m_p,
+                                              const Loci loc, int& iters)
+{
+    iters = 0;
+    OneDWState s;
+    const Status setup = onedw_setup(G, U, m_u, k, j, i, loc, s);
+    if (setup != Status::success) return setup;
 
-    // Find u(tilde); Eqn. 31 of Noble et al.
-    const Real pre = (gamma / (W + Bsq));
-    P(m_p.U1, k, j, i) = pre * (Qtcon[1] + QdB * Bcon[1] / W);
-    P(m_p.U2, k, j, i) = pre * (Qtcon[2] + QdB * Bcon[2] / W);
-    P(m_p.U3, k, j, i) = pre * (Qtcon[3] + QdB * Bcon[3] / W);
+    // Initial guess from primitives
+    GReal Wp;
+    const Status guess = onedw_guess(G, P, m_p, gam, k, j, i, loc, Wp);
+    if (guess != Status::success) return guess;
 
-    return Status::success;
+    const Status conv = onedw_iterate(s, gam, Wp, iters);
+    if (conv != Status::success) return conv;
+
+    return onedw_set_prims(s, gam, Wp, k, j, i, P, m_p);
+}
+
+/**
+ * 1D_W inverter as above, but with the analytic derivative, see onedw_iterate_analytic
+ */
+template <>
+KOKKOS_INLINE_FUNCTION Status u_to_p<Type::onedw_analytic>(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                              const Real& gam, const int& k, const int& j, const int& i,
+                                              const VariablePack<Real>& P, const VarMap& m_p,
+                                              const Loci loc, int& iters)
+{
+    iters = 0;
+    OneDWState s;
+    const Status setup = onedw_setup(G, U, m_u, k, j, i, loc, s);
+    if (setup != Status::success) return setup;
+
+    GReal Wp;
+    const Status guess = onedw_guess(G, P, m_p, gam, k, j, i, loc, Wp);
+    if (guess != Status::success) return guess;
+
+    const Status conv = onedw_iterate_analytic(s, gam, Wp, iters);
+    if (conv != Status::success) return conv;
+
+    return onedw_set_prims(s, gam, Wp, k, j, i, P, m_p);
+}
+
+/**
+ * Warm-started versions of the above: start from W'/D of the last successful inversion
+ * in this zone, if there was one, rather than from the current primitives.
+ * Records W'/D on success, or zero on failure.
+ */
+template <>
+KOKKOS_INLINE_FUNCTION Status u_to_p_warm<Type::onedw>(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                              const Real& gam, const int& k, const int& j, const int& i,
+                                              const VariablePack<Real>& P, const VarMap& m_p,
+                                              const Loci loc, int& iters, Real& Wp_cache)
+{
+    iters = 0;
+    OneDWState s;
+    const Status setup = onedw_setup(G, U, m_u, k, j, i, loc, s);
+    if (setup != Status::success) { Wp_cache = 0.; return setup; }
+
+    GReal Wp = Wp_cache * s.D;
+    if (!(Wp > 0.)) {
+        const Status guess = onedw_guess(G, P, m_p, gam, k, j, i, loc, Wp);
+        if (guess != Status::success) { Wp_cache = 0.; return guess; }
+    }
+
+    Status status = onedw_iterate(s, gam, Wp, iters);
+    if (status == Status::success)
+        status = onedw_set_prims(s, gam, Wp, k, j, i, P, m_p);
+    Wp_cache = (status == Status::success) ? Wp / s.D : 0.;
+    return status;
+}
+template <>
+KOKKOS_INLINE_FUNCTION Status u_to_p_warm<Type::onedw_analytic>(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                              const Real& gam, const int& k, const int& j, const int& i,
+                                              const VariablePack<Real>& P, const VarMap& m_p,
+                                              const Loci loc, int& iters, Real& Wp_cache)
+{
+    iters = 0;
+    OneDWState s;
+    const Status setup = onedw_setup(G, U, m_u, k, j, i, loc, s);
+    if (setup != Status::success) { Wp_cache = 0.; return setup; }
+
+    GReal Wp = Wp_cache * s.D;
+    if (!(Wp > 0.)) {
+        const Status guess = onedw_guess(G, P, m_p, gam, k, j, i, loc, Wp);
+        if (guess != Status::success) { Wp_cache = 0.; return guess; }
+    }
+
+    Status status = onedw_iterate_analytic(s, gam, Wp, iters);
+    if (status == Status::success)
+        status = onedw_set_prims(s, gam, Wp, k, j, i, P, m_p);
+    Wp_cache = (status == Status::success) ? Wp / s.D : 0.;
+    return status;
 }
 
 } // namespace Inverter
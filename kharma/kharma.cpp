@@ -32,19 +32,27 @@
  *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include "kharma.hpp"
+#include "kharma_config.hpp"
 
+#include <iomanip>
 #include <iostream>
+#include <map>
 
 #include <parthenon/parthenon.hpp>
 
 #include "decs.hpp"
+#include "coordinate_inverse.hpp"
+#include "reconstruction.hpp"
 #include "version.hpp"
 
 // Packages
+#include "analysis_grid.hpp"
+#include "averages.hpp"
 #include "b_flux_ct.hpp"
 #include "b_cd.hpp"
 #include "b_cleanup.hpp"
 #include "b_ct.hpp"
+#include "checkpoint.hpp"
 #include "coord_output.hpp"
 #include "current.hpp"
 #include "kharma_driver.hpp"
@@ -52,9 +60,14 @@
 #include "implicit.hpp"
 #include "floors.hpp"
 #include "grmhd.hpp"
+#include "reduced_output.hpp"
+#include "float_halo.hpp"
 #include "reductions.hpp"
 #include "emhd.hpp"
 #include "wind.hpp"
+#include "multizone.hpp"
+#include "tracers.hpp"
+#include "in_situ.hpp"
 
 #include "bondi.hpp"
 #include "boundaries.hpp"
@@ -83,6 +96,30 @@ std::shared_ptr<KHARMAPackage> KHARMA::InitializeGlobals(ParameterInput *pin, st
     params.Add("flag_verbose", flag_verbose, true);
     int extra_checks = pin->GetOrAddInteger("debug", "extra_checks", 0);
     params.Add("extra_checks", extra_checks, true);
+    // Cheaper checks for production: NaN/negative primitives and bad ctop, in one kernel over
+    // 1/sampled_checks of the blocks each step, rotating.  Reported a step late to avoid blocking on MPI
+    int sampled_checks = pin->GetOrAddInteger("debug", "sampled_checks", 0);
+    params.Add("sampled_checks", sampled_checks);
+
+    // Per-region wall-clock timers keyed on Flag() labels, see timers.hpp
+    // Reported at the end of the run and optionally every timers_ncycle steps
+    bool timers = pin->GetOrAddBoolean("debug", "timers", false);
+    bool timers_fence = pin->GetOrAddBoolean("debug", "timers_fence", false);
+    int timers_ncycle = pin->GetOrAddInteger("debug", "timers_ncycle", 0);
+    params.Add("timers", timers);
+    params.Add("timers_ncycle", timers_ncycle);
+    if (timers) Timers::Start(timers_fence);
+
+    // Count device allocations made during the step loop, see allocations.hpp.
+    // The first few steps allocate Parthenon's pack caches & our persistent buffers, so aren't counted
+    bool track_allocations = pin->GetOrAddBoolean("debug", "track_allocations", false);
+    int track_allocations_warmup = pin->GetOrAddInteger("debug", "track_allocations_warmup", 2);
+    params.Add("track_allocations", track_allocations);
+    if (track_allocations) Allocations::Start(track_allocations_warmup);
+    // Per-package device memory breakdown & predicted high-water mark at startup, see ReportMemory
+    params.Add("memory_report", pin->GetOrAddBoolean("debug", "memory_report", false));
+    // Count of block neighbors on other ranks at startup, see ReportCommunication
+    params.Add("comm_report", pin->GetOrAddBoolean("debug", "comm_report", false));
 
     // Record the problem name, just in case we need to special-case for different problems.
     // Please favor packages & options before using this, and modify problem-specific code
@@ -95,9 +132,59 @@ std::shared_ptr<KHARMAPackage> KHARMA::InitializeGlobals(ParameterInput *pin, st
     params.Add("SHA1", KHARMA::Version::GIT_SHA1);
     params.Add("branch", KHARMA::Version::GIT_REFSPEC);
 
+    // Tabulated inverse of the native->embedding map, for MKS/FMKS whose coord_to_native
+    // otherwise requires a root find.  See coordinate_inverse.hpp
+    int inverse_nth = pin->GetOrAddInteger("coordinates", "inverse_table_nth", 1024);
+    int inverse_nx1 = pin->GetOrAddInteger("coordinates", "inverse_table_nx1", 128);
+    if (pin->GetOrAddBoolean("coordinates", "inverse_table", true) &&
+        pin->DoesParameterExist("parthenon/mesh", "x1min")) {
+        CoordinateEmbedding coords(pin);
+        // Cover the ghost zones too
+        const GReal x1min = pin->GetReal("parthenon/mesh", "x1min");
+        const GReal x1max = pin->GetReal("parthenon/mesh", "x1max");
+        const GReal x1ghost = (x1max - x1min) / pin->GetInteger("parthenon/mesh", "nx1") * Globals::nghost;
+        params.Add("coord_inverse", CoordinateInverse(coords, x1min - x1ghost, x1max + x1ghost,
+                                                      inverse_nth, inverse_nx1));
+    } else {
+        params.Add("coord_inverse", CoordinateInverse());
+    }
+
+    // Scratch arrays shared between packages, see GetScratch
+    std::map<std::string, ParArray5D<Real>> scratch_arena;
+    params.Add("scratch_arena", scratch_arena, true);
+
+    // Map of the work done in each zone, accumulated over each output interval:
+    // one unit per zone per step, plus weighted inverter iterations, implicit iterations, and fixups.
+    // The weights are rough guesses, calibrate them for a machine with kharma_bench
+    bool cost_map = pin->GetOrAddBoolean("debug", "cost_map", false);
+    params.Add("cost_map", cost_map);
+    if (cost_map) {
+        params.Add("cost_inverter_weight", pin->GetOrAddReal("debug", "cost_inverter_weight", 0.05));
+        params.Add("cost_implicit_weight", pin->GetOrAddReal("debug", "cost_implicit_weight", 1.0));
+        params.Add("cost_fixup_weight", pin->GetOrAddReal("debug", "cost_fixup_weight", 1.0));
+        params.Add("cost_reset", false, true);
+        Metadata m_cost = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy});
+        pkg->AddField("cost", m_cost);
+        // Optionally also the total over each block, written to every zone of the block
+        bool cost_block = pin->GetOrAddBoolean("debug", "cost_block", false);
+        params.Add("cost_block", cost_block);
+        if (cost_block) pkg->AddField("cost_block", m_cost);
+        pkg->BlockUserWorkBeforeOutput = KHARMA::CostBeforeOutput;
+        // Steps accumulated in the current interval
+        params.Add("cost_nsteps", 0, true);
+    }
+    // Feed the measured cost of each block to Parthenon's load balancer (as balancer=manual, set in
+    // FixParameters), every parthenon/loadbalancing/interval steps
+    bool cost_balance = pin->GetOrAddBoolean("debug", "cost_balance", false);
+    params.Add("cost_balance", cost_balance);
+    if (cost_balance) {
+        params.Add("cost_balance_interval", m::max(pin->GetOrAddInteger("parthenon/loadbalancing", "interval", 10), 1));
+    }
+
     // Update the times with callbacks
     pkg->PreStepWork = KHARMA::PreStepWork;
     pkg->PostStepWork = KHARMA::PostStepWork;
+    pkg->PostExecute = KHARMA::PostExecute;
 
     return pkg;
 }
@@ -116,6 +203,20 @@ void KHARMA::ResetGlobals(ParameterInput *pin, Mesh *pmesh)
     // to be restored by Parthenon
 }
 
+ParArray5D<Real> KHARMA::GetScratch(Mesh *pmesh, const std::string& slot, int nb, int nv, int n3, int n2, int n1)
+{
+    auto& params = pmesh->packages.Get("Globals")->AllParams();
+    auto *arena = params.GetMutable<std::map<std::string, ParArray5D<Real>>>("scratch_arena");
+    auto found = arena->find(slot);
+    if (found == arena->end() ||
+        found->second.extent_int(0) < nb || found->second.extent_int(1) < nv ||
+        found->second.extent_int(2) < n3 || found->second.extent_int(3) < n2 ||
+        found->second.extent_int(4) < n1) {
+        (*arena)[slot] = ParArray5D<Real>("scratch_" + slot, nb, nv, n3, n2, n1);
+    }
+    return (*arena)[slot];
+}
+
 void KHARMA::PreStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
 {
     auto& globals = pmesh->packages.Get("Globals")->AllParams();
@@ -137,6 +238,247 @@ void KHARMA::PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
     auto& globals = pmesh->packages.Get("Globals")->AllParams();
     globals.Update<double>("dt_last", tm.dt);
     globals.Update<double>("time", tm.time);
+
+    if (globals.Get<bool>("cost_map"))
+        AccumulateCost(pmesh);
+    // tm.ncycle is incremented, then the mesh is load balanced, after this call
+    if (globals.Get<bool>("cost_balance") && (tm.ncycle + 1) % globals.Get<int>("cost_balance_interval") == 0)
+        SetBlockCosts(pmesh);
+
+    if (globals.Get<bool>("track_allocations"))
+        Allocations::SetCycle(tm.ncycle + 1);
+
+    const int timers_ncycle = globals.Get<int>("timers_ncycle");
+    if (globals.Get<bool>("timers") && timers_ncycle > 0 && tm.ncycle % timers_ncycle == 0)
+        Timers::Report(tm.ncycle);
+}
+
+void KHARMA::AccumulateCost(Mesh *pmesh)
+{
+    Flag("AccumulateCost");
+    auto& globals = pmesh->packages.Get("Globals")->AllParams();
+    const Real w_inverter = globals.Get<Real>("cost_inverter_weight");
+    const Real w_implicit = globals.Get<Real>("cost_implicit_weight");
+    const Real w_fixup = globals.Get<Real>("cost_fixup_weight");
+    const bool reset = globals.Get<bool>("cost_reset");
+    globals.Update<bool>("cost_reset", false);
+    globals.Update<int>("cost_nsteps", (reset) ? 1 : globals.Get<int>("cost_nsteps") + 1);
+
+    for (int p = 0; p < pmesh->DefaultNumPartitions(); p++) {
+        auto &md = pmesh->mesh_data.GetOrAdd("base", p);
+        auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+        auto& cost = md->PackVariables(std::vector<std::string>{"cost"});
+        // Any of these may be absent, depending on the packages and options in use
+        auto& inverter_iters = md->PackVariables(std::vector<std::string>{"inverter_iters"});
+        auto& solve_iters = md->PackVariables(std::vector<std::string>{"solve_iters"});
+        auto& pflag = md->PackVariables(std::vector<std::string>{"pflag"});
+        const bool use_inverter = inverter_iters.GetDim(4) > 0;
+        const bool use_implicit = solve_iters.GetDim(4) > 0;
+        const bool use_pflag = pflag.GetDim(4) > 0;
+
+        const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+        const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+        const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+        const IndexRange block = IndexRange{0, cost.GetDim(5) - 1};
+        pmb0->par_for("accumulate_cost", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA (const int& b, const int& k, const int& j, const int& i) {
+                Real c = 1.;
+                if (use_inverter) c += w_inverter * inverter_iters(b, 0, k, j, i);
+                if (use_implicit) c += w_implicit * solve_iters(b, 0, k, j, i);
+                if (use_pflag && pflag(b, 0, k, j, i) > 0) c += w_fixup;
+                cost(b, 0, k, j, i) = (reset) ? c : cost(b, 0, k, j, i) + c;
+            }
+        );
+    }
+    EndFlag();
+}
+
+Real KHARMA::BlockCost(MeshBlock *pmb)
+{
+    auto &rc = pmb->meshblock_data.Get();
+    GridScalar cost = rc->Get("cost").data;
+    const IndexRange ib = pmb->cellbounds.GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = pmb->cellbounds.GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = pmb->cellbounds.GetBoundsK(IndexDomain::interior);
+    Real total;
+    pmb->par_reduce("block_cost", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int& k, const int& j, const int& i, Real& local_result) {
+            local_result += cost(k, j, i);
+        }
+    , Kokkos::Sum<Real>(total));
+    return total;
+}
+
+void KHARMA::SetBlockCosts(Mesh *pmesh)
+{
+    Flag("SetBlockCosts");
+    // Average cost per step over the current interval, relative to a block with no extra work,
+    // so that blocks cost ~1 unless they do more inversions/fixups/implicit iterations than usual
+    const int nsteps = m::max(pmesh->packages.Get("Globals")->Param<int>("cost_nsteps"), 1);
+    for (auto &pmb : pmesh->block_list) {
+        const auto &cb = pmb->cellbounds;
+        const Real zones = cb.ncellsi(IndexDomain::interior) * cb.ncellsj(IndexDomain::interior) * cb.ncellsk(IndexDomain::interior);
+        pmb->SetCostForLoadBalancing(BlockCost(pmb.get()) / (nsteps * zones));
+    }
+    EndFlag();
+}
+
+void KHARMA::CostBeforeOutput(MeshBlock *pmb, ParameterInput *pin)
+{
+    auto& globals = pmb->packages.Get("Globals")->AllParams();
+    if (globals.Get<bool>("cost_block")) {
+        const Real total = BlockCost(pmb);
+        GridScalar cost_block = pmb->meshblock_data.Get()->Get("cost_block").data;
+        const IndexRange ib = pmb->cellbounds.GetBoundsI(IndexDomain::entire);
+        const IndexRange jb = pmb->cellbounds.GetBoundsJ(IndexDomain::entire);
+        const IndexRange kb = pmb->cellbounds.GetBoundsK(IndexDomain::entire);
+        pmb->par_for("fill_block_cost", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA (const int& k, const int& j, const int& i) {
+                cost_block(k, j, i) = total;
+            }
+        );
+    }
+    // Whatever is being written, start accumulating a new interval on the next step
+    globals.Update<bool>("cost_reset", true);
+}
+
+void KHARMA::PostExecute(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+    if (pmesh->packages.Get("Globals")->Param<bool>("timers"))
+        Timers::Report(tm.ncycle);
+    if (pmesh->packages.Get("Globals")->Param<bool>("track_allocations"))
+        Allocations::Report();
+}
+
+void KHARMA::ReportMemory(ParameterInput *pin, Mesh *pmesh)
+{
+    Flag("ReportMemory");
+    using FC = Metadata::FlagCollection;
+    auto &packages = pmesh->packages;
+    const double MB = 1024. * 1024.;
+
+    // Which package owns each field
+    std::map<std::string, std::string> owner;
+    for (auto &pkg : packages.AllPackages())
+        for (const auto &name : pkg.second->GetVariableNames(FC({Metadata::Cell, Metadata::Face, Metadata::Edge}, true)))
+            owner[name] = pkg.first;
+
+    // Bytes of each field over this rank's blocks, including fluxes & coarse buffers.
+    // Fields without OneCopy are duplicated in each stage container the driver adds
+    std::map<std::string, std::map<std::string, double>> field_bytes;
+    double total_bytes = 0., copied_bytes = 0., geom_bytes = 0.;
+    for (auto &pmb : pmesh->block_list) {
+        for (auto &var : pmb->meshblock_data.Get()->GetVariableVector()) {
+            if (!var->IsAllocated()) continue;
+            double bytes = var->data.size() + var->coarse_s.size();
+            for (int d = X1DIR; d <= X3DIR; d++) bytes += var->flux[d].size();
+            bytes *= sizeof(Real);
+            const std::string pkg_name = owner.count(var->label()) ? owner[var->label()] : "other";
+            field_bytes[pkg_name][var->label()] += bytes;
+            total_bytes += bytes;
+            if (!var->IsSet(Metadata::OneCopy)) copied_bytes += bytes;
+        }
+#if !FAST_CARTESIAN && !NO_CACHE
+        // Geometry caches are pooled between blocks, count each pool at its first block
+        const auto &G = pmb->coords;
+        if (G.geom_slot == 0) {
+            geom_bytes += (G.gcon_direct.size() + G.gcov_direct.size() + G.gdet_direct.size() + G.conn_direct.size() +
+                           G.gdet_conn_direct.size() + G.embed_direct.size()) * sizeof(Real) +
+                          (G.gcon_single.size() + G.gcov_single.size()) * sizeof(float);
+        }
+#endif
+    }
+
+    // Stage containers: dUdt, the intermediate stage(s), plus the implicit solver's and jcon's copies
+    const auto &driver_pars = packages.Get("Driver")->AllParams();
+    const std::string integrator = pin->GetOrAddString("parthenon/time", "integrator", "rk2");
+    const int nstages = (integrator == "rk1") ? 1 : (integrator == "rk3") ? 3 : 2;
+    const bool low_storage = driver_pars.Get<bool>("low_storage") && !packages.AllPackages().count("Electrons");
+    const int ncopies = 1 + ((low_storage) ? m::min(nstages - 1, 1) : nstages - 1) +
+                        packages.AllPackages().count("Implicit") + packages.AllPackages().count("Current");
+
+    // Team scratch (level 1, in device memory) per row of zones, and for every team of one launch
+    // over a pack of blocks.  Kokkos only allocates it for the teams resident at once, so this is an upper bound
+    const int n1 = pmesh->block_list[0]->cellbounds.ncellsi(IndexDomain::entire);
+    const int n2 = pmesh->block_list[0]->cellbounds.ncellsj(IndexDomain::entire);
+    const int n3 = pmesh->block_list[0]->cellbounds.ncellsk(IndexDomain::entire);
+    const int nvar = PackDimension(&packages, FC({Metadata::Conserved, Metadata::Cell}));
+    const KReconstruction::Type recon = driver_pars.Get<KReconstruction::Type>("recon");
+    const size_t var_size_in_bytes = parthenon::ScratchPad2D<Real>::shmem_size(nvar, n1);
+    // As computed in GetFlux & GetFluxFused
+    const int recon_vars = KReconstruction::scratch_vars(recon);
+    const bool pencil = KReconstruction::is_stencil5(recon) && driver_pars.Get<bool>("pencil_recon");
+    const size_t flux_scratch = ((driver_pars.Get<bool>("fused_flux")) ? 6 + pencil + recon_vars
+                                                                      : m::max(2 + recon_vars, 3)) * var_size_in_bytes;
+    size_t implicit_scratch = 0;
+    if (packages.AllPackages().count("Implicit")) {
+        implicit_scratch = Implicit::ScratchBytes(n1, PackDimension(&packages, FC({Metadata::GetUserFlag("Primitive")})),
+                                                  PackDimension(&packages, FC({Metadata::GetUserFlag("Implicit")})),
+                                                  packages.Get("Implicit")->Param<bool>("register_solve"),
+                                                  packages.Get("Implicit")->Param<bool>("batched_solve"));
+    }
+    const int pack_size = pin->GetOrAddInteger("parthenon/mesh", "pack_size", -1);
+    const int nblocks = pmesh->block_list.size();
+    const int pack_blocks = (pack_size < 1) ? nblocks : m::min(pack_size, nblocks);
+    const double scratch_bytes = static_cast<double>(m::max(flux_scratch, implicit_scratch)) * pack_blocks * n2 * n3;
+
+    const double high_water = total_bytes + (ncopies * copied_bytes) + geom_bytes + scratch_bytes;
+    double max_high_water = high_water;
+#ifdef MPI_PARALLEL
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &max_high_water, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD));
+#endif
+
+    if (MPIRank0()) {
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "Device memory on rank 0 (" << nblocks << " blocks):" << std::endl;
+        for (auto &pkg : field_bytes) {
+            double pkg_total = 0.;
+            for (auto &field : pkg.second) pkg_total += field.second;
+            std::cout << "  " << std::left << std::setw(32) << pkg.first << std::right << std::setw(12) << pkg_total / MB << " MB" << std::endl;
+            for (auto &field : pkg.second)
+                std::cout << "    " << std::left << std::setw(30) << field.first << std::right << std::setw(12) << field.second / MB << " MB" << std::endl;
+        }
+        std::cout << "  Fields: " << total_bytes / MB << " MB, geometry caches: " << geom_bytes / MB << " MB" << std::endl;
+        std::cout << "  Stage containers: " << ncopies << " copies of " << copied_bytes / MB << " MB" << std::endl;
+        std::cout << "  Team scratch: flux " << flux_scratch / 1024. << " kB";
+        if (implicit_scratch > 0) std::cout << ", implicit " << implicit_scratch / 1024. << " kB";
+        std::cout << " per team, at most " << scratch_bytes / MB << " MB per launch over " << pack_blocks << " blocks" << std::endl;
+        std::cout << "  Predicted high-water mark: " << high_water / MB << " MB on rank 0, "
+                  << max_high_water / MB << " MB on the largest rank" << std::endl;
+        std::cout << std::endl << std::defaultfloat << std::setprecision(6);
+    }
+    EndFlag();
+}
+
+void KHARMA::ReportCommunication(Mesh *pmesh)
+{
+    Flag("ReportCommunication");
+    // Neighbor pairs in total, on other ranks, across the X3-periodic boundary, and across it on
+    // other ranks.  Only same-level pairs are recognized as crossing the boundary
+    std::vector<long long> counts(4, 0);
+    for (auto &pmb : pmesh->block_list) {
+        for (const auto &nb : pmb->neighbors) {
+            const bool offrank = nb.rank != MPIRank();
+            // Neighbors more than one block apart in X3 must be across the periodic boundary
+            const bool seam = nb.loc.level() == pmb->loc.level() && m::abs(nb.loc.lx3() - pmb->loc.lx3()) > 1;
+            counts[0]++;
+            if (offrank) counts[1]++;
+            if (seam) counts[2]++;
+            if (seam && offrank) counts[3]++;
+        }
+    }
+#ifdef MPI_PARALLEL
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, counts.data(), counts.size(), MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD));
+#endif
+    if (MPIRank0()) {
+        std::cout << "Block neighbors: " << counts[0] << ", of which on other ranks: " << counts[1]
+                  << " (" << std::fixed << std::setprecision(1) << 100. * counts[1] / m::max(counts[0], 1ll) << "%)" << std::endl;
+        std::cout << "  Across the X3-periodic seam: " << counts[2] << ", on other ranks: " << counts[3] << std::endl;
+        if (counts[3] > 0)
+            std::cout << "  (driver/whole_phi_blocks=true keeps these within each block)" << std::endl;
+        std::cout << std::defaultfloat << std::setprecision(6);
+    }
+    EndFlag();
 }
 
 void KHARMA::FixParameters(ParameterInput *pin)
@@ -146,7 +488,17 @@ void KHARMA::FixParameters(ParameterInput *pin)
     // We set a better default with our own parameter, and inform Parthenon.
     // This means that ONLY driver/nghost will be respected
     // Driver::Initialize will check we set enough for our reconstruction
-    Globals::nghost = pin->GetOrAddInteger("driver", "nghost", 4);
+    // The default is the fewest the reconstruction needs, plus one for the KHARMA driver so that it
+    // can skip the second boundary sync (see driver/two_sync).  Every other stencil (B field EMFs,
+    // EMHD gradients, fixups) reaches at most 2 zones into the ghosts, as does Parthenon's prolongation.
+    // Mesh refinement additionally requires an even number of ghost zones.
+    const std::string recon = pin->GetOrAddString("driver", "reconstruction", "weno5");
+    const bool do_emhd = pin->GetOrAddBoolean("emhd", "on", false) && !pin->GetOrAddBoolean("emhd", "subcycle", false);
+    const bool kharma_driver = pin->GetOrAddString("driver", "type", (do_emhd) ? "imex" : "kharma") == "kharma";
+    int nghost_default = m::max(KReconstruction::stencil_width(recon)/2 + 1 + kharma_driver, 2);
+    if (pin->GetOrAddString("parthenon/mesh", "refinement", "none") != "none")
+        nghost_default += nghost_default % 2;
+    Globals::nghost = pin->GetOrAddInteger("driver", "nghost", nghost_default);
     pin->SetInteger("parthenon/mesh", "nghost", Globals::nghost);
 
     // If we're restarting (not via Parthenon), read the restart file to get most parameters
@@ -157,6 +509,9 @@ void KHARMA::FixParameters(ParameterInput *pin)
     if (prob == "resize_restart_kharma") {
         ReadKharmaRestartHeader(pin->GetString("resize_restart", "fname"), pin);
     }
+    if (prob == "checkpoint") {
+        Checkpoint::ReadCheckpointHeader(pin->GetOrAddString("checkpoint", "restart_file", ""), pin);
+    }
 
     // Construct a CoordinateEmbedding object.  See coordinate_embedding.hpp for supported systems/tags
     CoordinateEmbedding tmp_coords(pin);
@@ -215,6 +570,37 @@ void KHARMA::FixParameters(ParameterInput *pin)
             pin->GetOrAddReal("coordinates", "r_out", tmp_coords.X1_to_embed(pin->GetReal("parthenon/mesh", "x1max")));
         }
 
+        // Optionally excise the inside of the EH: drop whole meshblocks of radial zones from the inner
+        // edge, keeping excise_buffer zones inside the horizon, which need only outflow conditions
+        // as nothing there can reach the exterior.  This keeps the remaining grid identical.
+        // Recorded as "excised" so restarts from our own parameter file don't apply it twice.
+        if (pin->GetOrAddBoolean("coordinates", "excise", false) &&
+            !pin->GetOrAddBoolean("coordinates", "excised", false) &&
+            !mpark::holds_alternative<SphMinkowskiCoords>(tmp_coords.base)) {
+            const int buffer = pin->GetOrAddInteger("coordinates", "excise_buffer", 5);
+            const int nx1 = pin->GetInteger("parthenon/mesh", "nx1");
+            const int nb1 = pin->GetOrAddInteger("parthenon/meshblock", "nx1", nx1);
+            const GReal x1min = pin->GetReal("parthenon/mesh", "x1min");
+            const GReal x1max = pin->GetReal("parthenon/mesh", "x1max");
+            const GReal dx = (x1max - x1min) / nx1;
+            const GReal x1hor = tmp_coords.r_to_native(tmp_coords.get_horizon());
+            // Zones lying entirely inside the EH, less the buffer, in whole blocks
+            const int ninside = m::max((int) m::floor((x1hor - x1min) / dx) - buffer, 0);
+            const int nexcise = m::min(ninside / nb1, nx1 / nb1 - 1) * nb1;
+            if (nexcise > 0) {
+                const GReal x1min_new = x1min + nexcise * dx;
+                pin->SetReal("parthenon/mesh", "x1min", x1min_new);
+                pin->SetInteger("parthenon/mesh", "nx1", nx1 - nexcise);
+                pin->SetReal("coordinates", "r_in", tmp_coords.X1_to_embed(x1min_new));
+                if (MPIRank0())
+                    std::cout << "Excising " << nexcise << " radial zones inside the EH, new r_in: "
+                              << pin->GetReal("coordinates", "r_in") << std::endl;
+            } else if (MPIRank0()) {
+                std::cout << "KHARMA WARNING: no whole meshblocks lie inside the EH buffer, nothing excised" << std::endl;
+            }
+            pin->SetBoolean("coordinates", "excised", true);
+        }
+
         // If the simulation domain extends inside the EH, we change some boundary options
         pin->SetBoolean("coordinates", "domain_intersects_eh", pin->GetReal("coordinates", "r_in") < tmp_coords.get_horizon());
 
@@ -226,6 +612,38 @@ void KHARMA::FixParameters(ParameterInput *pin)
         pin->GetOrAddString("boundaries", "outer_x2", "reflecting");
         pin->GetOrAddString("boundaries", "inner_x3", "periodic");
         pin->GetOrAddString("boundaries", "outer_x3", "periodic");
+
+        // Parthenon hands each rank a contiguous range of blocks in Z-order, which keeps neighbors in
+        // X1 & X2 together, but puts the first & last blocks in X3 far apart, so the phi-periodic
+        // exchange usually crosses ranks (and nodes).  (The poles are reflecting, so they exchange nothing.)
+        // Optionally make each block a whole ring in phi, splitting X2 or X1 more finely to keep the
+        // block count, so the periodic exchange stays within the block.  See also debug/comm_report
+        const int nx3 = pin->GetOrAddInteger("parthenon/mesh", "nx3", 1);
+        const int nb3 = pin->GetOrAddInteger("parthenon/meshblock", "nx3", nx3);
+        if (pin->GetOrAddBoolean("driver", "whole_phi_blocks", false) && nx3 > 1 && nb3 < nx3 &&
+            pin->GetString("boundaries", "inner_x3") == "periodic") {
+            const int factor = nx3 / nb3;
+            pin->SetInteger("parthenon/meshblock", "nx3", nx3);
+            // Keep blocks at least 2*nghost zones wide in the direction we split
+            bool split = false;
+            for (int d : {2, 1}) {
+                const std::string nx = "nx" + std::to_string(d);
+                const int nb = pin->GetOrAddInteger("parthenon/meshblock", nx, pin->GetInteger("parthenon/mesh", nx));
+                if (nb % factor == 0 && nb / factor >= 2 * Globals::nghost) {
+                    pin->SetInteger("parthenon/meshblock", nx, nb / factor);
+                    split = true;
+                    break;
+                }
+            }
+            if (MPIRank0()) {
+                std::cout << "Using meshblocks covering all of X3: "
+                          << pin->GetInteger("parthenon/meshblock", "nx1") << "x"
+                          << pin->GetInteger("parthenon/meshblock", "nx2") << "x" << nx3 << std::endl;
+                if (!split)
+                    std::cout << "KHARMA WARNING: could not split X1 or X2 to keep the block count, "
+                              << "there are " << factor << "x fewer blocks" << std::endl;
+            }
+        }
     } else {
         // We can set reasonable default boundary conditions for Cartesian sims,
         // but not default domain bounds
@@ -260,6 +678,50 @@ void KHARMA::FixParameters(ParameterInput *pin)
     if (tmp_coords.stopx(3) >= 0)
         pin->GetOrAddReal("parthenon/mesh", "x3max", tmp_coords.stopx(3));
 
+    // Apply any pack size recorded by an earlier autotuning run on this machine, since Parthenon
+    // fixes its partitions when building the Mesh.  Done after any change to the meshblock size above.
+    // Only the base-level block count is known here, so AMR runs may still re-tune on the first step,
+    // see KHARMADriver::TunePackSize
+    if (pin->GetOrAddBoolean("driver", "autotune_pack_size", false)) {
+        const std::string cache_file = pin->GetOrAddString("driver", "autotune_file", "");
+        if (!cache_file.empty()) {
+            int nblocks = 1;
+            for (int d = 1; d <= 3; d++) {
+                const std::string nx = "nx" + std::to_string(d);
+                const int nmesh = pin->GetInteger("parthenon/mesh", nx);
+                const int nmb = pin->DoesParameterExist("parthenon/meshblock", nx) ? pin->GetInteger("parthenon/meshblock", nx) : nmesh;
+                nblocks *= nmesh / nmb;
+            }
+            nblocks = (nblocks + MPINumRanks() - 1) / MPINumRanks();
+            const int cached = KHARMADriver::CachedPackSize(cache_file, KHARMADriver::PackSizeKey(pin, nblocks));
+            if (cached > 0) pin->SetInteger("parthenon/mesh", "pack_size", cached);
+        }
+    }
+
+    // Cost-weighted load balancing needs the cost map, and Parthenon's "manual" balancer to use our costs
+    if (pin->GetOrAddBoolean("debug", "cost_balance", false)) {
+        pin->SetBoolean("debug", "cost_map", true);
+        pin->SetString("parthenon/loadbalancing", "balancer", "manual");
+    }
+
+    // Benchmark mode: disable outputs and optional checks so that timings measure only stepping.
+    // The driver reports steady-state throughput after driver/benchmark_warmup steps
+    if (pin->GetOrAddBoolean("driver", "benchmark", false)) {
+        InputBlock *pib = pin->pfirst_block;
+        while (pib != nullptr) {
+            if (pib->block_name.find("parthenon/output") != std::string::npos) {
+                pin->SetReal(pib->block_name, "dt", 1.e30);
+                if (pin->DoesParameterExist(pib->block_name, "dn"))
+                    pin->SetInteger(pib->block_name, "dn", -1);
+            }
+            pib = pib->pnext;
+        }
+        pin->SetInteger("debug", "extra_checks", 0);
+        pin->SetInteger("debug", "sampled_checks", 0);
+        pin->SetInteger("debug", "flag_verbose", 0);
+        pin->SetInteger("debug", "verbose", 0);
+    }
+
     EndFlag();
 }
 
@@ -270,7 +732,7 @@ TaskStatus KHARMA::AddPackage(std::shared_ptr<Packages_t>& packages,
     // TODO package names before initialization
     const auto& pkg = package_init(pin, packages);
     packages->Add(pkg);
-    Flag("AddPackage_"+pkg->label());
+    Flag("AddPackage_", pkg->label());
     EndFlag();
     return TaskStatus::complete;
 }
@@ -300,7 +762,10 @@ Packages_t KHARMA::ProcessPackages(std::unique_ptr<ParameterInput> &pin)
     auto t_grmhd = tl.AddTask(t_globals | t_driver, KHARMA::AddPackage, packages, GRMHD::Initialize, pin.get());
     // Only load the inverter if GRMHD/EMHD isn't being evolved implicitly
     auto t_inverter = t_grmhd;
-    if (!pin->GetOrAddBoolean("GRMHD", "implicit", pin->GetOrAddBoolean("emhd", "on", false))) {
+    // (the same default as GRMHD::Initialize, which also requires the ImEx driver)
+    const bool implicit_default = pin->GetOrAddBoolean("emhd", "on", false) && !pin->GetOrAddBoolean("emhd", "subcycle", false);
+    if (!pin->GetOrAddBoolean("GRMHD", "implicit", implicit_default) ||
+        pin->GetOrAddString("driver", "type", implicit_default ? "imex" : "kharma") != "imex") {
         t_inverter = tl.AddTask(t_grmhd, KHARMA::AddPackage, packages, Inverter::Initialize, pin.get());
     }
     // Floors package depends on having pflag
@@ -358,6 +823,14 @@ Packages_t KHARMA::ProcessPackages(std::unique_ptr<ParameterInput> &pin)
     if (pin->GetOrAddBoolean("wind", "on", false)) {
         auto t_wind = tl.AddTask(t_grmhd, KHARMA::AddPackage, packages, Wind::Initialize, pin.get());
     }
+    // Passive tracer particles, see tracers.hpp
+    if (pin->GetOrAddBoolean("tracers", "on", false)) {
+        auto t_tracers = tl.AddTask(t_grmhd, KHARMA::AddPackage, packages, Tracers::Initialize, pin.get());
+    }
+    // Evolving one annulus at a time, see multizone.hpp. Needs to know the B field transport
+    if (pin->GetOrAddBoolean("multizone", "on", false)) {
+        auto t_multizone = tl.AddTask(t_b_field, KHARMA::AddPackage, packages, Multizone::Initialize, pin.get());
+    }
     // Enable calculating jcon iff it is in any list of outputs (and there's even B to calculate it).
     // Since it is never required to restart, this is the only time we'd write (hence, need) it
     if (FieldIsOutput(pin.get(), "jcon") && t_b_field != t_none) {
@@ -377,6 +850,37 @@ Packages_t KHARMA::ProcessPackages(std::unique_ptr<ParameterInput> &pin)
     // TODO avoid init if Parthenon will be handling all boundaries?
     KHARMA::AddPackage(packages, KBoundaries::Initialize, pin.get());
 
+    // Exchanging some variables' ghost zones in float32, see float_halo.hpp
+    if (!pin->GetOrAddString("float_halo", "variables", "").empty()) {
+        KHARMA::AddPackage(packages, FloatHalo::Initialize, pin.get());
+    }
+
+    // KHARMA's own (asynchronous) checkpoints
+    if (pin->GetOrAddReal("checkpoint", "dt", -1.) > 0. ||
+        pin->GetOrAddInteger("checkpoint", "memory_interval", 0) > 0) {
+        KHARMA::AddPackage(packages, Checkpoint::Initialize, pin.get());
+    }
+
+    // In-situ analysis & visualization, see in_situ.hpp
+    if (pin->GetOrAddBoolean("in_situ", "on", false)) {
+        KHARMA::AddPackage(packages, InSitu::Initialize, pin.get());
+    }
+
+    // Reduced-precision copies of variables, iff any are in a list of outputs
+    if (FieldIsOutput(pin.get(), "reduced.")) {
+        KHARMA::AddPackage(packages, ReducedOutput::Initialize, pin.get());
+    }
+
+    // Running time averages of selected fields, see averages.hpp
+    if (pin->GetOrAddBoolean("averages", "on", false)) {
+        KHARMA::AddPackage(packages, Averages::Initialize, pin.get());
+    }
+
+    // Snapshots interpolated onto a uniform grid for post-processing, see analysis_grid.hpp
+    if (pin->GetOrAddBoolean("analysis_grid", "on", false)) {
+        KHARMA::AddPackage(packages, AnalysisGrid::Initialize, pin.get());
+    }
+
     // Load the implicit package last, if there are *any* variables that need implicit evolution
     // This lets us just count by flag, rather than checking all the possible parameters that would
     // trigger this
@@ -385,6 +889,11 @@ Packages_t KHARMA::ProcessPackages(std::unique_ptr<ParameterInput> &pin)
         KHARMA::AddPackage(packages, Implicit::Initialize, pin.get());
     }
 
+    // With everything loaded, fix the order of UtoP callbacks for the rest of the run
+    Packages::ResolveUtoP(packages.get());
+    // and gather the options read by hot task functions, see KHARMAConfig
+    KHARMA::InitializeConfig(packages.get());
+
 #if DEBUG
     // Carry the ParameterInput with us, for generating outputs whenever we want
     packages->Get("Globals")->AllParams().Add("pin", pin.get());
@@ -53,6 +53,16 @@ std::shared_ptr<KHARMAPackage> InitializeGlobals(ParameterInput *pin, std::share
  */
 void ResetGlobals(ParameterInput *pin, Mesh *pmesh);
 
+/**
+ * Get a scratch array of (at least) the given size, from an arena shared by all packages.
+ * Each named slot is allocated on first use and kept for the rest of the run,
+ * reallocated only if a caller needs it larger.  Use for temporaries which live only
+ * within one task and need no boundary communication, in place of permanent Parthenon fields.
+ * Contents are undefined on return.  Slots are shared between mesh partitions,
+ * so these must not be used by tasks which might run concurrently.
+ */
+ParArray5D<Real> GetScratch(Mesh *pmesh, const std::string& slot, int nb, int nv, int n3, int n2, int n1);
+
 /**
  * Update variables in Globals package based on Parthenon state incl. SimTime struct
  */
@@ -61,6 +71,40 @@ void PreStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
  * Update variables in Globals package based on Parthenon state incl. SimTime struct
  */
 void PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+/**
+ * Add this step's work estimate in each zone to the "cost" field, see debug/cost_map
+ */
+void AccumulateCost(Mesh *pmesh);
+/**
+ * Total of the "cost" field over a block's interior zones
+ */
+Real BlockCost(MeshBlock *pmb);
+/**
+ * Pass each block's average cost per step to Parthenon's load balancer, see debug/cost_balance
+ */
+void SetBlockCosts(Mesh *pmesh);
+/**
+ * Fill the per-block cost field before an output, and start a new accumulation interval
+ */
+void CostBeforeOutput(MeshBlock *pmb, ParameterInput *pin);
+/**
+ * Print the final timing breakdown, if timers are enabled
+ */
+void PostExecute(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+
+/**
+ * Print the device memory used by each package's fields and the geometry caches on this rank,
+ * and predict the high-water mark once the driver adds its stage containers and team scratch.
+ * Enabled with debug/memory_report.  Takes the MPI maximum over ranks, so must be called on all ranks.
+ */
+void ReportMemory(ParameterInput *pin, Mesh *pmesh);
+
+/**
+ * Print how many block neighbors are on other ranks, and how many of those are across the X3-periodic
+ * boundary, which Parthenon's Z-ordered rank assignment always splits.  Enabled with debug/comm_report.
+ * Takes the MPI sum over ranks, so must be called on all ranks.
+ */
+void ReportCommunication(Mesh *pmesh);
 
 /**
  * Task to add a package.  Lets us queue up all the packages we want in a task list, *then* load them
@@ -86,7 +130,7 @@ Packages_t ProcessPackages(std::unique_ptr<ParameterInput>& pin);
 // TODO(BSP) not sure where to put these
 
 /**
- * Check whether a given field is anywhere in outputs.
+ * Check whether a given field is anywhere in outputs, or handed to in-situ analysis.
  * Used to avoid calculating expensive fields (jcon, divB) if they
  * will not even be written.
  * Note this compares the field name as a substring rather than
@@ -107,6 +151,11 @@ inline bool FieldIsOutput(ParameterInput *pin, std::string name)
         }
         pib = pib->pnext;
     }
+    // Fields handed to in-situ analysis count too, see in_situ.hpp
+    if (pin->DoesParameterExist("in_situ", "variables") && pin->GetOrAddBoolean("in_situ", "on", false) &&
+        pin->GetString("in_situ", "variables").find(name) != std::string::npos) {
+        return true;
+    }
     return false;
 }
 
@@ -0,0 +1,92 @@
+/* 
+ *  File: kharma_config.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "kharma_config.hpp"
+
+void KHARMA::InitializeConfig(Packages_t *packages)
+{
+    auto& all = packages->AllPackages();
+    KHARMAConfig config;
+
+    config.use_b_ct      = all.count("B_CT");
+    config.use_b_cd      = all.count("B_CD");
+    config.use_b_flux_ct = all.count("B_FluxCT");
+    config.use_floors    = all.count("Floors");
+    config.use_emhd      = all.count("EMHD");
+    config.use_electrons = all.count("Electrons");
+    config.use_inverter  = all.count("Inverter");
+
+    const auto& grmhd_pars = packages->Get("GRMHD")->AllParams();
+    config.gam                = grmhd_pars.Get<Real>("gamma");
+    config.cfl                = grmhd_pars.Get<double>("cfl");
+    config.dt_min             = grmhd_pars.Get<double>("dt_min");
+    config.max_dt_increase    = grmhd_pars.Get<double>("max_dt_increase");
+    config.use_dt_light       = grmhd_pars.Get<bool>("use_dt_light");
+    config.pole_average_zones = grmhd_pars.Get<int>("pole_average_zones");
+    config.report_level_dt    = grmhd_pars.Get<int>("report_level_dt");
+    config.x2_periodic = all.count("Boundaries") &&
+                         packages->Get("Boundaries")->Param<std::string>("inner_x2") == "periodic";
+
+    const auto& driver_pars = packages->Get("Driver")->AllParams();
+    config.recon             = driver_pars.Get<KReconstruction::Type>("recon");
+    config.use_hlle          = driver_pars.Get<bool>("use_hlle");
+    config.fused_flux        = driver_pars.Get<bool>("fused_flux");
+    config.flux_streams      = driver_pars.Get<bool>("flux_streams");
+    config.troubled_fallback = driver_pars.Get<bool>("troubled_fallback");
+    config.keep_face_states  = packages->Get("Flux")->Param<bool>("keep_face_states");
+    config.pencil_recon      = driver_pars.Get<bool>("pencil_recon");
+    config.pencil_length     = driver_pars.Get<int>("pencil_length");
+    config.flat_flux         = driver_pars.Get<bool>("flat_flux");
+
+    config.fix_average_neighbors = config.use_inverter &&
+                                   packages->Get("Inverter")->Param<bool>("fix_average_neighbors");
+
+    config.emhd_params = EMHD::GetEMHDParameters(*packages);
+
+    // Floors start out unrelaxed, see KHARMADriver::MakeTaskCollection
+    config.relaxed = false;
+    if (config.use_floors) {
+        config.floors = Floors::Prescription(packages->Get("Floors")->AllParams());
+        // Relaxation steps use normal observer frame floors, as in Floors::Prescription
+        config.floors_relaxed = config.floors;
+        config.floors_relaxed.fluid_frame = config.floors_relaxed.mixed_frame = config.floors_relaxed.drift_frame = false;
+    }
+
+    packages->Get("Globals")->AllParams().Add("config", config, true);
+}
+
+void KHARMA::SetFloorsRelaxed(Packages_t& packages, bool relaxed)
+{
+    packages.Get("Floors")->UpdateParam<bool>("relaxed", relaxed);
+    packages.Get("Globals")->AllParams().GetMutable<KHARMAConfig>("config")->relaxed = relaxed;
+}
@@ -0,0 +1,107 @@
+/* 
+ *  File: kharma_config.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+#include "types.hpp"
+
+#include "emhd.hpp"
+#include "floors.hpp"
+#include "reconstruction.hpp"
+
+/**
+ * Options read by the hottest task functions (fluxes, PtoU, fixups, timestep estimation),
+ * gathered into one struct once all packages are loaded.
+ * Each of those functions then makes one Params lookup, rather than one per option,
+ * per block or per partition, per stage.  See KHARMA::GetConfig.
+ *
+ * Only options which are fixed for the whole run belong here.  The single exception is
+ * 'relaxed', which mirrors the Floors parameter of the same name, see GetFloors.
+ */
+struct KHARMAConfig {
+    // Which packages are loaded
+    bool use_b_ct, use_b_cd, use_b_flux_ct, use_floors, use_emhd, use_electrons, use_inverter;
+
+    // GRMHD
+    Real gam;
+    Real cfl, dt_min, max_dt_increase;
+    bool use_dt_light;
+    int pole_average_zones, report_level_dt;
+    // Whether X2 boundaries are periodic, i.e. there are no poles to average
+    bool x2_periodic;
+
+    // Driver & fluxes
+    KReconstruction::Type recon;
+    bool use_hlle, fused_flux, flux_streams, troubled_fallback, keep_face_states;
+    bool pencil_recon, flat_flux;
+    int pencil_length;
+
+    // Inverter
+    bool fix_average_neighbors;
+
+    // EMHD, zeroed if not loaded as in EMHD::GetEMHDParameters
+    EMHD::EMHD_parameters emhd_params;
+
+    // Floors, both as normally applied and during initial relaxation steps
+    Floors::Prescription floors, floors_relaxed;
+    bool relaxed;
+
+    const Floors::Prescription& GetFloors() const
+    {
+        return relaxed ? floors_relaxed : floors;
+    }
+};
+
+namespace KHARMA {
+
+/**
+ * Build the KHARMAConfig from the package parameters, and store it in Globals as "config".
+ * Called at the end of ProcessPackages.
+ */
+void InitializeConfig(Packages_t *packages);
+
+/**
+ * Get the run's KHARMAConfig
+ */
+inline const KHARMAConfig& GetConfig(Packages_t& packages)
+{
+    return packages.Get("Globals")->Param<KHARMAConfig>("config");
+}
+
+/**
+ * Set whether floors are in their relaxed form, in the Floors package parameters and the config
+ */
+void SetFloorsRelaxed(Packages_t& packages, bool relaxed);
+
+} // namespace KHARMA
@@ -33,6 +33,8 @@
  */
 #include "kharma_package.hpp"
 
+#include "inverter.hpp"
+
 #include "types.hpp"
 
 // TODO clearly this needs a better concept of ordering.
@@ -46,7 +48,7 @@ TaskStatus Packages::FixFlux(MeshData<Real> *md)
     auto kpackages = md->GetMeshPointer()->packages.AllPackagesOfType<KHARMAPackage>();
     for (auto kpackage : kpackages) {
         if (kpackage.second->FixFlux != nullptr) {
-            Flag("FixFlux_"+kpackage.first);
+            Flag("FixFlux_", kpackage.first);
             kpackage.second->FixFlux(md);
             EndFlag();
         }
@@ -80,7 +82,7 @@ TaskStatus Packages::BlockUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool
     }
     for (auto kpackage : kpackages) {
         if (kpackage.second->BlockUtoP != nullptr && kpackage.first != "B_CT" && kpackage.first != "Inverter") {
-            Flag("BlockUtoP_"+kpackage.first);
+            Flag("BlockUtoP_", kpackage.first);
             kpackage.second->BlockUtoP(rc, domain, coarse);
             EndFlag();
         }
@@ -88,12 +90,83 @@ TaskStatus Packages::BlockUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool
     EndFlag();
     return TaskStatus::complete;
 }
+
+void Packages::ResolveUtoP(Packages_t *packages)
+{
+    // Prefer MeshUtoP implementations, and fall back to running BlockUtoP on each block.
+    // Same ordering as BlockUtoP
+    auto kpackages = packages->AllPackagesOfType<KHARMAPackage>();
+    // Whether the inverter's mesh kernels fill B at zone centers themselves, as Inverter::FusesBCT
+    // minus the check for coarse buffers, which is made per-call
+    const bool b_fused = kpackages.count("B_CT") && kpackages.count("Inverter")
+                         && packages->Get("Inverter")->Param<bool>("fuse_b_ct")
+                         && packages->Get("Inverter")->Param<Inverter::Type>("inverter_type") != Inverter::Type::none;
+    // Likewise Inverter::FusesElectrons.  Only the plain inversion kernel does this, not the one with floors
+    const bool e_fused = kpackages.count("Electrons") && kpackages.count("Inverter")
+                         && packages->Get("Inverter")->Param<bool>("fuse_electrons")
+                         && packages->Get("Inverter")->Param<Inverter::Type>("inverter_type") != Inverter::Type::none;
+    std::vector<UtoPStep> utop_order, utop_floors_order;
+    auto resolve = [&](const std::string& name, KHARMAPackage *pkpackage) {
+        const bool fused_b_ct = b_fused && (name == "B_CT");
+        const bool fused = fused_b_ct || (e_fused && name == "Electrons");
+        UtoPStep step, step_floors;
+        if (pkpackage->MeshUtoP != nullptr) {
+            step = {"MeshUtoP_"+name, pkpackage->MeshUtoP, fused};
+        } else if (pkpackage->BlockUtoP != nullptr) {
+            auto block_utop = pkpackage->BlockUtoP;
+            step = {"BlockUtoP_"+name, [block_utop](MeshData<Real> *md, IndexDomain domain, bool coarse) {
+                for (int i=0; i < md->NumBlocks(); ++i)
+                    block_utop(md->GetBlockData(i).get(), domain, coarse);
+            }, fused};
+        } else {
+            return;
+        }
+        utop_order.push_back(step);
+        if (pkpackage->MeshUtoPFloors != nullptr) {
+            utop_floors_order.push_back({"MeshUtoPFloors_"+name, pkpackage->MeshUtoPFloors, fused_b_ct});
+        } else {
+            utop_floors_order.push_back({step.label, step.call, fused_b_ct});
+        }
+    };
+    if (kpackages.count("B_CT"))
+        resolve("B_CT", kpackages.at("B_CT"));
+    if (kpackages.count("Inverter"))
+        resolve("Inverter", kpackages.at("Inverter"));
+    for (auto kpackage : kpackages) {
+        if (kpackage.first != "B_CT" && kpackage.first != "Inverter")
+            resolve(kpackage.first, kpackage.second);
+    }
+
+    auto& params = packages->Get("Globals")->AllParams();
+    params.Add("utop_order", utop_order);
+    params.Add("utop_floors_order", utop_floors_order);
+}
+
+// Implementation of MeshUtoP & MeshUtoPFloors, which differ only in the list of callbacks
+inline void MeshUtoPImpl(MeshData<Real> *md, IndexDomain domain, bool coarse, bool floors)
+{
+    auto pmesh = md->GetMeshPointer();
+    const auto& steps = pmesh->packages.Get("Globals")->Param<std::vector<Packages::UtoPStep>>(
+                            floors ? "utop_floors_order" : "utop_order");
+    for (const auto& step : steps) {
+        if (step.fused && !coarse) continue;
+        Flag(step.label);
+        step.call(md, domain, coarse);
+        EndFlag();
+    }
+}
+
 TaskStatus Packages::MeshUtoP(MeshData<Real> *md, IndexDomain domain, bool coarse)
 {
-    // TODO TODO prefer MeshUtoP implementations and fall back
     Flag("MeshUtoP");
-    for (int i=0; i < md->NumBlocks(); ++i)
-        BlockUtoP(md->GetBlockData(i).get(), domain, coarse);
+    MeshUtoPImpl(md, domain, coarse, false);
+    EndFlag();
+    return TaskStatus::complete;
+}
+TaskStatus Packages::MeshUtoPFloors(MeshData<Real> *md, IndexDomain domain, bool coarse)
+{
+    Flag("MeshUtoPFloors");
+    MeshUtoPImpl(md, domain, coarse, true);
     EndFlag();
     return TaskStatus::complete;
 }
@@ -113,7 +186,7 @@ TaskStatus Packages::BoundaryUtoP(MeshBlockData<Real> *rc, IndexDomain domain, b
     }
     for (auto kpackage : kpackages) {
         if (kpackage.second->BoundaryUtoP != nullptr && kpackage.first != "Inverter") {
-            Flag("BoundaryUtoP_"+kpackage.first);
+            Flag("BoundaryUtoP_", kpackage.first);
             kpackage.second->BoundaryUtoP(rc, domain, coarse);
             EndFlag();
         }
@@ -122,13 +195,13 @@ TaskStatus Packages::BoundaryUtoP(MeshBlockData<Real> *rc, IndexDomain domain, b
     return TaskStatus::complete;
 }
 
-TaskStatus Packages::BoundaryPtoUElseUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse)
+TaskStatus Packages::BoundaryPtoUElseUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse, bool skip_grmhd)
 {
     Flag("DomainBoundaryLockstep");
     auto pmb = rc->GetBlockPointer();
     auto kpackages = rc->GetBlockPointer()->packages.AllPackagesOfType<KHARMAPackage>();
     // Some downstream UtoP rely on GRMHD prims, some cons
-    if (kpackages.count("GRMHD")) {
+    if (kpackages.count("GRMHD") && !skip_grmhd) {
         KHARMAPackage *pkpackage = pmb->packages.Get<KHARMAPackage>("GRMHD");
         if (pkpackage->DomainBoundaryPtoU != nullptr) {
             Flag("DomainBoundaryPtoU_GRMHD");
@@ -142,11 +215,11 @@ TaskStatus Packages::BoundaryPtoUElseUtoP(MeshBlockData<Real> *rc, IndexDomain d
     }
     for (auto kpackage : kpackages) {
         if (kpackage.second->DomainBoundaryPtoU != nullptr && kpackage.first != "GRMHD") {
-            Flag("DomainBoundaryPtoU_"+kpackage.first);
+            Flag("DomainBoundaryPtoU_", kpackage.first);
             kpackage.second->DomainBoundaryPtoU(rc, domain, coarse);
             EndFlag();
         } else if (kpackage.second->BoundaryUtoP != nullptr && kpackage.first != "GRMHD") {
-            Flag("DomainBoundaryUtoP_"+kpackage.first);
+            Flag("DomainBoundaryUtoP_", kpackage.first);
             kpackage.second->BoundaryUtoP(rc, domain, coarse);
             EndFlag();
         }
@@ -161,7 +234,7 @@ TaskStatus Packages::AddSource(MeshData<Real> *md, MeshData<Real> *mdudt)
     auto kpackages = md->GetMeshPointer()->packages.AllPackagesOfType<KHARMAPackage>();
     for (auto kpackage : kpackages) {
         if (kpackage.second->AddSource != nullptr) {
-            Flag("AddSource_"+kpackage.first);
+            Flag("AddSource_", kpackage.first);
             kpackage.second->AddSource(md, mdudt);
             EndFlag();
         }
@@ -186,8 +259,15 @@ TaskStatus Packages::BlockApplyPrimSource(MeshBlockData<Real> *rc)
 TaskStatus Packages::MeshApplyPrimSource(MeshData<Real> *md)
 {
     Flag("MeshApplyPrimSource");
-    for (int i=0; i < md->NumBlocks(); ++i)
-        BlockApplyPrimSource(md->GetBlockData(i).get());
+    auto kpackages = md->GetMeshPointer()->packages.AllPackagesOfType<KHARMAPackage>();
+    for (auto kpackage : kpackages) {
+        if (kpackage.second->MeshApplyPrimSource != nullptr) {
+            kpackage.second->MeshApplyPrimSource(md);
+        } else if (kpackage.second->BlockApplyPrimSource != nullptr) {
+            for (int i=0; i < md->NumBlocks(); ++i)
+                kpackage.second->BlockApplyPrimSource(md->GetBlockData(i).get());
+        }
+    }
     EndFlag();
     return TaskStatus::complete;
 }
@@ -212,7 +292,7 @@ TaskStatus Packages::BlockApplyFloors(MeshBlockData<Real> *mbd, IndexDomain doma
     for (auto kpackage : kpackages) {
         if (kpackage.first != "Floors") {
             if (kpackage.second->BlockApplyFloors != nullptr) {
-                Flag("BlockApplyFloors_"+kpackage.first);
+                Flag("BlockApplyFloors_", kpackage.first);
                 kpackage.second->BlockApplyFloors(mbd, domain);
                 EndFlag();
             }
@@ -239,7 +319,7 @@ void Packages::UserWorkBeforeOutput(MeshBlock *pmb, ParameterInput *pin)
     auto kpackages = pmb->packages.AllPackagesOfType<KHARMAPackage>();
     for (auto kpackage : kpackages) {
         if (kpackage.second->BlockUserWorkBeforeOutput != nullptr) {
-            Flag("UserWorkBeforeOutput_"+kpackage.first);
+            Flag("UserWorkBeforeOutput_", kpackage.first);
             kpackage.second->BlockUserWorkBeforeOutput(pmb, pin);
             EndFlag();
         }
@@ -253,7 +333,7 @@ void Packages::PreStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
     auto kpackages = pmesh->packages.AllPackagesOfType<KHARMAPackage>();
     for (auto kpackage : kpackages) {
         if (kpackage.second->PreStepWork != nullptr) {
-            Flag("PreStepWork_"+kpackage.first);
+            Flag("PreStepWork_", kpackage.first);
             kpackage.second->PreStepWork(pmesh, pin, tm);
             EndFlag();
         }
@@ -267,7 +347,7 @@ void Packages::PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
     auto kpackages = pmesh->packages.AllPackagesOfType<KHARMAPackage>();
     for (auto kpackage : kpackages) {
         if (kpackage.second->PostStepWork != nullptr) {
-            Flag("PostStepWork_"+kpackage.first);
+            Flag("PostStepWork_", kpackage.first);
             kpackage.second->PostStepWork(pmesh, pin, tm);
             EndFlag();
         }
@@ -284,7 +364,7 @@ void Packages::PostStepDiagnostics(Mesh *pmesh, ParameterInput *pin, const SimTi
     if (md->NumBlocks() > 0) {
         for (auto &package : pmesh->packages.AllPackages()) {
             if (package.second->PostStepDiagnosticsMesh != nullptr) {
-                Flag("PostStepDiagnostics_"+package.first);
+                Flag("PostStepDiagnostics_", package.first);
                 package.second->PostStepDiagnosticsMesh(tm, md);
                 EndFlag();
             }
@@ -299,7 +379,7 @@ void Packages::PostExecute(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
     auto kpackages = pmesh->packages.AllPackagesOfType<KHARMAPackage>();
     for (auto kpackage : kpackages) {
         if (kpackage.second->PostExecute != nullptr) {
-            Flag("PostExecute_"+kpackage.first);
+            Flag("PostExecute_", kpackage.first);
             kpackage.second->PostExecute(pmesh, pin, tm);
             EndFlag();
         }
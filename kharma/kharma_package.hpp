@@ -62,6 +62,8 @@ class KHARMAPackage : public StateDescriptor {
         // rather, they are called on zone center values once per step only.
         std::function<void(MeshBlockData<Real>*, IndexDomain, bool)> BlockUtoP = nullptr;
         std::function<void(MeshData<Real>*, IndexDomain, bool)> MeshUtoP = nullptr;
+        // UtoP which also applies floors to successfully inverted zones, see Packages::MeshUtoPFloors
+        std::function<void(MeshData<Real>*, IndexDomain, bool)> MeshUtoPFloors = nullptr;
         // Allow applying UtoP only/separately for boundary domains after sync/prolong/restrict ops
         // All packages with independent variables should register this for AMR
         std::function<void(MeshBlockData<Real>*, IndexDomain, bool)> BoundaryUtoP = nullptr;
@@ -81,6 +83,8 @@ class KHARMAPackage : public StateDescriptor {
         // to control dissipation (Hubble, turbulence).
         // Must be applied over entire domain!
         std::function<void(MeshBlockData<Real>*)> BlockApplyPrimSource = nullptr;
+        // Mesh-level version, called once per partition instead of BlockApplyPrimSource if set
+        std::function<void(MeshData<Real>*)> MeshApplyPrimSource = nullptr;
 
         // Apply any fixes after the initial fluxes are calculated
         std::function<void(MeshData<Real>*)> FixFlux = nullptr;
@@ -127,6 +131,27 @@ TaskStatus FixFlux(MeshData<Real> *md);
  */
 TaskStatus BlockUtoP(MeshBlockData<Real> *mbd, IndexDomain domain, bool coarse=false);
 TaskStatus MeshUtoP(MeshData<Real> *md, IndexDomain domain, bool coarse=false);
+/**
+ * As MeshUtoP, but packages registering MeshUtoPFloors apply floors in the same kernel.
+ * Used in place of MeshUtoP followed by MeshApplyFloors, when only GRMHD floors are needed.
+ */
+TaskStatus MeshUtoPFloors(MeshData<Real> *md, IndexDomain domain, bool coarse=false);
+
+/**
+ * One step of MeshUtoP: a package's preferred UtoP callback, already wrapped to take MeshData.
+ * fused marks steps the inverter's kernel performs itself: B_CT's, see Inverter::FusesBCT,
+ * and Electrons', see Inverter::FusesElectrons.  Those steps are only run for coarse buffers.
+ */
+struct UtoPStep {
+    std::string label;
+    std::function<void(MeshData<Real>*, IndexDomain, bool)> call;
+    bool fused;
+};
+/**
+ * Resolve the ordered list of UtoP callbacks for MeshUtoP and MeshUtoPFloors, once all packages are loaded.
+ * This is stored in Globals, so that each call just walks the list.
+ */
+void ResolveUtoP(Packages_t *packages);
 
 /**
  * U to P specifically for boundaries (domain and MPI).
@@ -139,8 +164,9 @@ TaskStatus BoundaryUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse
  * This is for domain boundaries: if we're syncing the conserved variables, we still
  * want to apply domain boundaries to the GRHD primitive variables
  * See KBoundaries::ApplyBoundary for details
+ * skip_grmhd omits the GRMHD package, for callers which have already run its PtoU.
  */
-TaskStatus BoundaryPtoUElseUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse=false);
+TaskStatus BoundaryPtoUElseUtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse=false, bool skip_grmhd=false);
 
 /**
  * Fill all conserved variables (U) from primitive variables (P), over a domain on a single block
@@ -35,6 +35,7 @@
 
 #include "decs.hpp"
 
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <string>
@@ -96,9 +97,10 @@ KOKKOS_INLINE_FUNCTION void print_vector(const std::string name, const double v[
  *
  * Lightly edited from https://stackoverflow.com/questions/9323903/most-efficient-elegant-way-to-clip-a-number
  * Note that in C++17+ this can likely be a straight std::clamp call
+ * Bounds are converted to the type of n, so that literal bounds work with Real = float
  */
-template <typename T>
-KOKKOS_INLINE_FUNCTION T clip(const T& n, const T& lower, const T& upper)
+template <typename T, typename L, typename U>
+KOKKOS_INLINE_FUNCTION T clip(const T& n, const L& lower, const U& upper)
 {
 #if TRACE
   // This isn't so useful without context
@@ -106,7 +108,7 @@ KOKKOS_INLINE_FUNCTION T clip(const T& n, const T& lower, const T& upper)
   //if (n > upper) printf("Clip %g to %g\n", n, upper);
   //if (n < lower) printf("Clip %g to %g\n", n, lower);
 #endif
-    return m::min(m::max(lower, n), upper);
+    return m::min(m::max((T) lower, n), (T) upper);
 }
 // Version which "bounces" any excess over the bounds, useful for the polar coordinate
 template <typename T>
@@ -158,3 +160,36 @@ KOKKOS_INLINE_FUNCTION void gzero2(T a[GR_DIM][GR_DIM])
     memset(&(a[0][0]), 0, GR_DIM*GR_DIM*sizeof(T));
     //for(int i = 0; i < GR_DIM*GR_DIM; i++) (&(a[0][0]))[i] = 0.;
 }
+
+/**
+ * Counter-based random numbers: Philox-4x32-10 (Salmon et al. 2011).
+ * Each draw is a pure function of a key (the seed) and a 128-bit counter (e.g. a global zone index),
+ * so values can be generated in any order or decomposition, fully in parallel, with no state.
+ */
+KOKKOS_INLINE_FUNCTION void philox4x32(uint32_t ctr[4], const uint64_t& seed)
+{
+    uint32_t k0 = (uint32_t) seed, k1 = (uint32_t) (seed >> 32);
+    for (int round = 0; round < 10; round++) {
+        const uint64_t p0 = (uint64_t) 0xD2511F53u * ctr[0];
+        const uint64_t p1 = (uint64_t) 0xCD9E8D57u * ctr[2];
+        const uint32_t c1 = ctr[1], c3 = ctr[3];
+        ctr[0] = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+        ctr[1] = (uint32_t) p1;
+        ctr[2] = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+        ctr[3] = (uint32_t) p0;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+}
+/**
+ * Uniform double in [0, 1) for counter (c0, c1, c2, c3) under 'seed'
+ */
+KOKKOS_INLINE_FUNCTION double philox_uniform(const uint64_t& seed, const uint32_t& c0, const uint32_t& c1,
+                                             const uint32_t& c2, const uint32_t& c3=0)
+{
+    uint32_t ctr[4] = {c0, c1, c2, c3};
+    philox4x32(ctr, seed);
+    // Top 53 bits of the first two words
+    const uint64_t bits = (((uint64_t) ctr[0] << 32) | ctr[1]) >> 11;
+    return bits * (1.0 / 9007199254740992.0);
+}
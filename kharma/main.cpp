@@ -40,6 +40,7 @@
 #include "kharma.hpp"
 #include "post_initialize.hpp"
 #include "problem.hpp"
+#include "tracers.hpp"
 #include "emhd/conducting_atmosphere.hpp"
 #include "version.hpp"
 
@@ -85,6 +86,44 @@ int kharma_debug_trace_mutex = 0;
 
 using namespace parthenon;
 
+#ifdef KOKKOS_ENABLE_OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * Report how OpenMP threads are bound on this rank, for host (OpenMP) builds.
+ * Device arrays are placed in the memory of whichever socket's thread first touches them, i.e. zero-fills
+ * them at allocation.  That only matches the threads which later step them if threads can't migrate.
+ */
+static void print_thread_binding()
+{
+#ifdef KOKKOS_ENABLE_OPENMP
+    if (!std::is_same<DevExecSpace, Kokkos::OpenMP>::value) return;
+    const int nthreads = omp_get_max_threads();
+    const omp_proc_bind_t bind = omp_get_proc_bind();
+    const char *bind_names[] = {"false", "true", "primary", "close", "spread"};
+    std::vector<int> places(nthreads, -1);
+#pragma omp parallel num_threads(nthreads)
+    places[omp_get_thread_num()] = omp_get_place_num();
+
+    std::cout << "OpenMP: " << nthreads << " threads per rank, proc_bind " << bind_names[(int) bind]
+              << ", " << omp_get_num_places() << " places";
+    std::ifstream numa("/sys/devices/system/node/online");
+    std::string nodes;
+    if (numa >> nodes) std::cout << ", NUMA nodes " << nodes;
+    std::cout << std::endl;
+    if (bind == omp_proc_bind_false) {
+        std::cout << "  Threads are not bound!  Set OMP_PROC_BIND & OMP_PLACES (run.sh does by default) so that"
+                  << std::endl << "  arrays stay in the memory of the socket stepping them" << std::endl;
+    } else {
+        std::cout << "  Thread places:";
+        for (const int place : places) std::cout << " " << place;
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+#endif
+}
+
 /**
  * Main function for KHARMA.  Basically a wrapper calling a particular driver class to
  * handle fluid evolution.
@@ -102,11 +141,18 @@ using namespace parthenon;
  */
 int main(int argc, char *argv[])
 {
+    // Wall-clock marks for the startup breakdown printed before the first step
+    using clock = std::chrono::steady_clock;
+    std::vector<std::pair<std::string, clock::time_point>> startup_marks{{"start", clock::now()}};
+    auto mark = [&startup_marks](const std::string& label) { startup_marks.emplace_back(label, clock::now()); };
+
     ParthenonManager pman;
 
     // A couple of callbacks are KHARMA-wide single functions
     pman.app_input->ProcessPackages = KHARMA::ProcessPackages;
-    pman.app_input->ProblemGenerator = KHARMA::ProblemGenerator;
+    // Called once per mesh partition. Problems without a mesh-level initializer fall back to
+    // KHARMA::ProblemGenerator on each block
+    pman.app_input->MeshProblemGenerator = KHARMA::MeshProblemGenerator;
     // A few are passed on to be implemented by packages as they see fit
     pman.app_input->MeshBlockUserWorkBeforeOutput = Packages::UserWorkBeforeOutput;
     pman.app_input->PreStepMeshUserWorkInLoop = Packages::PreStepWork;
@@ -122,11 +168,16 @@ int main(int argc, char *argv[])
     pman.app_input->boundary_conditions[parthenon::BoundaryFace::outer_x2] = KBoundaries::ApplyBoundaryTemplate<IndexDomain::outer_x2>;
     pman.app_input->boundary_conditions[parthenon::BoundaryFace::inner_x3] = KBoundaries::ApplyBoundaryTemplate<IndexDomain::inner_x3>;
     pman.app_input->boundary_conditions[parthenon::BoundaryFace::outer_x3] = KBoundaries::ApplyBoundaryTemplate<IndexDomain::outer_x3>;
+    // Tracer particles handle the domain edges themselves, see tracers.hpp.  Parthenon needs something
+    // to call on "user" faces regardless
+    for (int f = 0; f < BOUNDARY_NFACES; f++)
+        pman.app_input->swarm_boundary_conditions[f] = Tracers::SwarmDomainBoundary;
 
     // Initialize Parthenon for MPI (also Kokkos, parses command line, etc.)
     Flag("ParthenonInit");
     auto manager_status = pman.ParthenonInitEnv(argc, argv);
     EndFlag();
+    mark("Parthenon & Kokkos init");
 
     if(MPIRank0()) {
         // Always print the version header, because it's fun
@@ -141,6 +192,7 @@ int main(int argc, char *argv[])
         std::cout << "KHARMA is released under the BSD 3-clause license." << std::endl;
         std::cout << "Source code is available at https://github.com/AFD-Illinois/kharma/" << std::endl;
         std::cout << std::endl;
+        print_thread_binding();
     }
 
     // Check the Parthenon init return code, initialize packages/mesh
@@ -156,8 +208,10 @@ int main(int argc, char *argv[])
     auto pin = pman.pinput.get(); // All parameters in the input file or command line
     // Modify input parameters as we need
     KHARMA::FixParameters(pin);
+    mark("Parameters & restart headers");
     // InitPackagesEtc calls ProcessPackages, then constructs the Mesh
     pman.ParthenonInitPackagesAndMesh();
+    mark("Packages, mesh, geometry & problem");
     // Now pull out the mesh and app_input as well for below
     auto pmesh = pman.pmesh.get(); // The mesh, with list of blocks & locations, size, etc
     auto papp = pman.app_input.get(); // The list of callback functions specified above
@@ -209,7 +263,7 @@ int main(int argc, char *argv[])
     // MeshBlocks to be initialized already.
     // TODO(BSP) split to package hooks
     auto prob = pin->GetString("parthenon/job", "problem_id");
-    bool is_restart = (prob == "resize_restart") || (prob == "resize_restart_kharma") || pman.IsRestart();
+    bool is_restart = (prob == "resize_restart") || (prob == "resize_restart_kharma") || (prob == "checkpoint") || pman.IsRestart();
     if(MPIRank0() && verbose > 0) {
         if (is_restart) {
             std::cout << "Running post-restart tasks..." << std::endl;
@@ -220,6 +274,33 @@ int main(int argc, char *argv[])
     Flag("PostInitialize");
     KHARMA::PostInitialize(pin, pmesh, is_restart);
     EndFlag();
+    mark("Post-initialization");
+
+    // Report where startup time went, as the slowest rank saw it
+    {
+        std::vector<double> secs;
+        for (int i = 1; i < startup_marks.size(); i++)
+            secs.push_back(std::chrono::duration<double>(startup_marks[i].second - startup_marks[i-1].second).count());
+        secs.push_back(std::chrono::duration<double>(startup_marks.back().second - startup_marks[0].second).count());
+#ifdef MPI_PARALLEL
+        PARTHENON_MPI_CHECK(MPI_Reduce(MPIRank0() ? MPI_IN_PLACE : secs.data(), secs.data(), secs.size(),
+                                       MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD));
+#endif
+        if (MPIRank0()) {
+            std::cout << "Startup time (max over ranks):" << std::endl << std::fixed << std::setprecision(2);
+            for (int i = 1; i < startup_marks.size(); i++)
+                std::cout << "  " << std::left << std::setw(36) << startup_marks[i].first << std::right
+                          << std::setw(10) << secs[i-1] << " s" << std::endl;
+            std::cout << "  " << std::left << std::setw(36) << "Total" << std::right
+                      << std::setw(10) << secs.back() << " s" << std::endl << std::endl << std::defaultfloat;
+        }
+    }
+
+    // Report memory use now that all fields are allocated
+    if (pmesh->packages.Get("Globals")->Param<bool>("memory_report"))
+        KHARMA::ReportMemory(pin, pmesh);
+    if (pmesh->packages.Get("Globals")->Param<bool>("comm_report"))
+        KHARMA::ReportCommunication(pmesh);
 
     // TODO output parsed parameters *here*, now we have everything including any problem configs for B field
 
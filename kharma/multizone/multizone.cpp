@@ -0,0 +1,301 @@
+/* 
+ *  File: multizone.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "multizone.hpp"
+
+#include "allocations.hpp"
+#include "kharma.hpp"
+#include "kharma_driver.hpp"
+
+// State which is frozen outside the active annulus: same as for Dirichlet boundaries
+inline Metadata::FlagCollection FrozenVars()
+{
+    using FC = Metadata::FlagCollection;
+    return FC({Metadata::Cell, Metadata::Conserved})
+         + FC({Metadata::Cell, Metadata::GetUserFlag("Primitive")})
+         - FC({Metadata::GetUserFlag("StartupOnly")});
+}
+
+using HostArray = decltype(std::declval<GridScalar>().GetHostMirror());
+
+// With multizone/frozen_on_host, the frozen state of each local block, by variable in 'names'.
+// Blocks entirely inside the active annulus keep no state until they are frozen
+enum class BlockState {active, straddling, frozen};
+static struct {
+    std::vector<std::string> names;
+    std::vector<int> gids;
+    std::vector<BlockState> state;
+    std::vector<std::vector<HostArray>> data;
+} host_frozen;
+
+std::shared_ptr<KHARMAPackage> Multizone::Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages)
+{
+    auto pkg = std::make_shared<KHARMAPackage>("Multizone");
+    Params &params = pkg->AllParams();
+
+    // Frozen zones are restored cell-by-cell, which would break divB in face-centered fields
+    if (packages->AllPackages().count("B_CT"))
+        throw std::invalid_argument("Multizone runs do not support face-centered fields! Use b_field/solver=flux_ct");
+    if (pin->GetOrAddString("parthenon/mesh", "refinement", "none") != "none")
+        throw std::invalid_argument("Multizone runs do not support mesh refinement!");
+    if (!pin->GetBoolean("coordinates", "spherical"))
+        throw std::invalid_argument("Multizone runs require spherical coordinates!");
+
+    // Annulus k covers [base^k, base^(k+2)], for k in [0, nzones)
+    int nzones = pin->GetOrAddInteger("multizone", "nzones", 2);
+    if (nzones < 2)
+        throw std::invalid_argument("Multizone runs need at least 2 annuli!");
+    params.Add("nzones", nzones);
+    Real base = pin->GetOrAddReal("multizone", "base", 8.);
+    params.Add("base", base);
+    // Time spent in each annulus.  Default is the free-fall time at its outer radius
+    Real runtime = pin->GetOrAddReal("multizone", "runtime", -1.);
+    params.Add("runtime", runtime);
+    // Keep the frozen state in host memory rather than a second copy of the mesh on the device.
+    // Blocks entirely outside the annulus are then copied back whole each step, and the few
+    // straddling its edges through a one-variable device buffer
+    bool frozen_on_host = pin->GetOrAddBoolean("multizone", "frozen_on_host", false);
+    params.Add("frozen_on_host", frozen_on_host);
+    if (frozen_on_host)
+        params.Add("restore_buffer", Allocations::PersistentArray<Real>("multizone_restore"), true);
+    // Verbose reporting of annulus switches
+    int verbose = pin->GetOrAddInteger("debug", "verbose", 0);
+    params.Add("verbose", verbose);
+
+    // State of the cycle.  Start in the outermost annulus and move inward
+    params.Add("initialized", false, true);
+    params.Add("annulus", nzones - 1, true);
+    params.Add("direction", -1, true);
+    params.Add("t_switch", 0., true);
+    // Active radial range.  Read by GRMHD::EstimateTimestep to ignore frozen zones
+    params.Add("r_active_min", 0., true);
+    params.Add("r_active_max", std::numeric_limits<Real>::max(), true);
+
+    pkg->PreStepWork = Multizone::PreStepWork;
+    pkg->PostStepWork = Multizone::PostStepWork;
+
+    return pkg;
+}
+
+void Multizone::ActivateAnnulus(Mesh *pmesh, int annulus, const Real time)
+{
+    auto &params = pmesh->packages.Get("Multizone")->AllParams();
+    const int nzones = params.Get<int>("nzones");
+    const Real base = params.Get<Real>("base");
+    const Real runtime = params.Get<Real>("runtime");
+
+    // Innermost & outermost annuli extend to the mesh edges, where the usual boundaries apply
+    const Real r_lo = m::pow(base, annulus);
+    const Real r_hi = m::pow(base, annulus + 2);
+    params.Update<int>("annulus", annulus);
+    params.Update<Real>("r_active_min", (annulus == 0) ? 0. : r_lo);
+    params.Update<Real>("r_active_max", (annulus == nzones - 1) ? std::numeric_limits<Real>::max() : r_hi);
+    params.Update<Real>("t_switch", time + ((runtime > 0.) ? runtime : m::pow(r_hi, 1.5)));
+
+    // Snapshot the whole mesh: only the part outside the annulus is used
+    if (params.Get<bool>("frozen_on_host")) {
+        SaveFrozenToHost(pmesh, params.Get<Real>("r_active_min"), params.Get<Real>("r_active_max"));
+    } else {
+        auto &base_md = pmesh->mesh_data.Get();
+        auto &frozen = pmesh->mesh_data.Add("multizone_frozen");
+        KHARMADriver::Copy<MeshData<Real>>({Metadata::Cell}, base_md.get(), frozen.get());
+    }
+
+    if (params.Get<int>("verbose") > 0 && MPIRank0()) {
+        std::cout << "Multizone: activating annulus " << annulus << ", r in [" << r_lo << ", " << r_hi
+                  << "] until t = " << params.Get<Real>("t_switch") << std::endl;
+    }
+}
+
+void Multizone::PreStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+    auto &params = pmesh->packages.Get("Multizone")->AllParams();
+    if (!params.Get<bool>("initialized")) {
+        ActivateAnnulus(pmesh, params.Get<int>("annulus"), tm.time);
+        params.Update<bool>("initialized", true);
+    }
+}
+
+void Multizone::PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+    auto &params = pmesh->packages.Get("Multizone")->AllParams();
+    auto &base_md = pmesh->mesh_data.Get();
+
+    if (params.Get<bool>("frozen_on_host")) {
+        RestoreFrozenFromHost(pmesh);
+    } else {
+        auto &frozen = pmesh->mesh_data.Get("multizone_frozen");
+        RestoreFrozen(base_md.get(), frozen.get());
+    }
+
+    // tm.time is incremented after this call
+    const Real time = tm.time + tm.dt;
+    if (time >= params.Get<Real>("t_switch")) {
+        // Bounce at either end
+        const int nzones = params.Get<int>("nzones");
+        int annulus = params.Get<int>("annulus");
+        int direction = params.Get<int>("direction");
+        if (annulus + direction < 0 || annulus + direction > nzones - 1) {
+            direction *= -1;
+            params.Update<int>("direction", direction);
+        }
+        annulus += direction;
+        ActivateAnnulus(pmesh, annulus, time);
+
+        // The step estimated during Step() covered the old annulus.  Moving inward, the
+        // new one needs a smaller step, so re-estimate before Parthenon sets the next one.
+        // Signal speeds are still valid everywhere, as fluxes are computed over the whole mesh
+        Update::EstimateTimestep<MeshData<Real>>(base_md.get());
+    }
+}
+
+TaskStatus Multizone::RestoreFrozen(MeshData<Real> *md, MeshData<Real> *md_frozen)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const auto &params = pmb0->packages.Get("Multizone")->AllParams();
+    const Real r_min = params.Get<Real>("r_active_min");
+    const Real r_max = params.Get<Real>("r_active_max");
+
+    auto q = md->PackVariables(FrozenVars());
+    auto q_frozen = md_frozen->PackVariables(FrozenVars());
+    if (q.GetDim(4) == 0) return TaskStatus::complete;
+
+    // Ghost zones are refilled by the next boundary sync
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    const IndexRange vars = IndexRange{0, q.GetDim(4) - 1};
+    const IndexRange block = IndexRange{0, q.GetDim(5) - 1};
+
+    pmb0->par_for("multizone_restore", block.s, block.e, vars.s, vars.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int &b, const int &v, const int &k, const int &j, const int &i) {
+            const auto& G = q.GetCoords(b);
+            GReal Xembed[GR_DIM];
+            G.coord_embed(k, j, i, Loci::center, Xembed);
+            if ((Xembed[1] < r_min || Xembed[1] > r_max) && q.IsAllocated(b, v) && q_frozen.IsAllocated(b, v))
+                q(b, v, k, j, i) = q_frozen(b, v, k, j, i);
+        }
+    );
+
+    return TaskStatus::complete;
+}
+
+void Multizone::SaveFrozenToHost(Mesh *pmesh, const Real r_min, const Real r_max)
+{
+    Flag("SaveFrozenToHost");
+    if (host_frozen.names.empty())
+        host_frozen.names = KHARMA::GetVariableNames(&(pmesh->packages), FrozenVars());
+
+    // Start over if the local blocks changed, e.g. after load balancing
+    const int nblocks = pmesh->block_list.size();
+    bool same_blocks = (host_frozen.gids.size() == nblocks);
+    for (int b = 0; same_blocks && b < nblocks; b++)
+        same_blocks = (host_frozen.gids[b] == pmesh->block_list[b]->gid);
+    if (!same_blocks) {
+        host_frozen.gids.assign(nblocks, 0);
+        host_frozen.data.assign(nblocks, std::vector<HostArray>());
+    }
+    host_frozen.state.assign(nblocks, BlockState::active);
+
+    for (int b = 0; b < nblocks; b++) {
+        auto &pmb = pmesh->block_list[b];
+        auto rc = pmb->meshblock_data.Get();
+        host_frozen.gids[b] = pmb->gid;
+
+        // Radius depends only on X1 in the spherical systems multizone supports
+        const auto& G = pmb->coords;
+        const IndexRange ib = pmb->cellbounds.GetBoundsI(IndexDomain::interior);
+        const GReal r_lo = G.coords.X1_to_embed(G.Xc<1>(ib.s));
+        const GReal r_hi = G.coords.X1_to_embed(G.Xc<1>(ib.e));
+        if (r_hi < r_min || r_lo > r_max) {
+            host_frozen.state[b] = BlockState::frozen;
+        } else if (r_lo < r_min || r_hi > r_max) {
+            host_frozen.state[b] = BlockState::straddling;
+        } else {
+            continue;
+        }
+
+        if (host_frozen.data[b].empty())
+            for (auto& name : host_frozen.names)
+                host_frozen.data[b].push_back(rc->Get(name).data.GetHostMirror());
+        for (int v = 0; v < host_frozen.names.size(); v++)
+            host_frozen.data[b][v].DeepCopy(rc->Get(host_frozen.names[v]).data);
+    }
+    Kokkos::fence();
+    EndFlag();
+}
+
+void Multizone::RestoreFrozenFromHost(Mesh *pmesh)
+{
+    Flag("RestoreFrozenFromHost");
+    auto &params = pmesh->packages.Get("Multizone")->AllParams();
+    const Real r_min = params.Get<Real>("r_active_min");
+    const Real r_max = params.Get<Real>("r_active_max");
+    auto &restore_buffer = *params.GetMutable<Allocations::PersistentArray<Real>>("restore_buffer");
+
+    for (int b = 0; b < pmesh->block_list.size(); b++) {
+        if (host_frozen.state[b] == BlockState::active) continue;
+        auto &pmb = pmesh->block_list[b];
+        auto rc = pmb->meshblock_data.Get();
+        for (int v = 0; v < host_frozen.names.size(); v++) {
+            auto q = rc->Get(host_frozen.names[v]).data;
+            const auto &q_host = host_frozen.data[b][v];
+            // Ghost zones are refilled by the next boundary sync, so whole blocks can just be copied
+            if (host_frozen.state[b] == BlockState::frozen) {
+                q.DeepCopy(q_host);
+                continue;
+            }
+
+            // Otherwise stage the block's frozen copy of this variable, and restore only the zones outside
+            const int n = q_host.GetSize();
+            auto buf = restore_buffer.Get(n);
+            Kokkos::View<const Real*, Kokkos::HostSpace, Kokkos::MemoryUnmanaged> q_h(q_host.data(), n);
+            Kokkos::deep_copy(Kokkos::subview(buf, std::make_pair(0, n)), q_h);
+
+            const int n1 = q.GetDim(1), n2 = q.GetDim(2), n3 = q.GetDim(3);
+            const IndexRange ib = pmb->cellbounds.GetBoundsI(IndexDomain::interior);
+            const IndexRange jb = pmb->cellbounds.GetBoundsJ(IndexDomain::interior);
+            const IndexRange kb = pmb->cellbounds.GetBoundsK(IndexDomain::interior);
+            const auto& G = pmb->coords;
+            pmb->par_for("multizone_restore_host", 0, q.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+                KOKKOS_LAMBDA (const int &p, const int &k, const int &j, const int &i) {
+                    GReal Xembed[GR_DIM];
+                    G.coord_embed(k, j, i, Loci::center, Xembed);
+                    if (Xembed[1] < r_min || Xembed[1] > r_max)
+                        q(p, k, j, i) = buf(((p*n3 + k)*n2 + j)*n1 + i);
+                }
+            );
+        }
+    }
+    EndFlag();
+}
@@ -0,0 +1,89 @@
+/* 
+ *  File: multizone.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+#include "types.hpp"
+
+#include <parthenon/parthenon.hpp>
+
+/**
+ * In-process multizone runs: the mesh always covers the full radial range, but only one
+ * annulus [base^k, base^(k+2)] is evolved at a time.  Zones outside the active annulus are
+ * held fixed at their values from the moment the annulus became active, i.e. they act as a
+ * Dirichlet boundary on both sides of it.  After multizone/runtime (by default the free-fall
+ * time at the annulus outer radius) the next annulus is activated, moving inward from the
+ * outermost and bouncing at either end, as in the restart-chained tests/multizone/run.sh.
+ *
+ * By default the frozen state is a second copy of the mesh in device memory.  With
+ * multizone/frozen_on_host, it is kept in host memory instead, so the device holds the
+ * live mesh alone.  Frozen blocks are still stepped, so this trades a host->device copy
+ * of the frozen region each step for that memory.
+ */
+namespace Multizone {
+
+/**
+ * Initialize the multizone package: annulus count & base, and the state of the cycle
+ */
+std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages);
+
+/**
+ * Activate the first annulus on the first step, saving the frozen state
+ */
+void PreStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+
+/**
+ * Reset zones outside the active annulus to their frozen state, then switch annuli if it is time,
+ * re-estimating the timestep over the new annulus
+ */
+void PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+
+/**
+ * Activate annulus 'annulus', saving the current state of the whole mesh as the frozen state
+ */
+void ActivateAnnulus(Mesh *pmesh, int annulus, const Real time);
+
+/**
+ * Copy the frozen state back into zones outside the active annulus
+ */
+TaskStatus RestoreFrozen(MeshData<Real> *md, MeshData<Real> *md_frozen);
+
+/**
+ * As ActivateAnnulus & RestoreFrozen, keeping the frozen state in host memory, see multizone/frozen_on_host.
+ * Only blocks with zones outside [r_min, r_max] are saved & restored
+ */
+void SaveFrozenToHost(Mesh *pmesh, const Real r_min, const Real r_max);
+void RestoreFrozenFromHost(Mesh *pmesh);
+
+}
@@ -76,6 +76,9 @@ TaskStatus InitializeBondi(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterIn
         pmb->packages.Get("GRMHD")->AddParam<Real>("fill_interior_bondi", fill_interior);
     if(! pmb->packages.Get("GRMHD")->AllParams().hasKey("zero_velocity_bondi"))
         pmb->packages.Get("GRMHD")->AddParam<Real>("zero_velocity_bondi", zero_velocity);
+    // Bondi boundary values of each block, see SetBondiImpl
+    if(! pmb->packages.Get("GRMHD")->AllParams().hasKey("bondi_cache"))
+        pmb->packages.Get("GRMHD")->AllParams().Add("bondi_cache", std::map<std::array<GReal, 8>, ParArray4D<Real>>(), true);
 
     // Set this problem to control the outer X1 boundary by default
     // remember to disable inflow_check in parameter file!
@@ -145,47 +148,54 @@ TaskStatus SetBondiImpl(std::shared_ptr<MeshBlockData<Real>>& rc, IndexDomain do
     const IndexRange jb = bounds.GetBoundsJ(domain);
     const IndexRange kb = bounds.GetBoundsK(domain);
 
-    pmb->par_for("bondi_boundary", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-        KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-            GReal Xnative[GR_DIM], Xembed[GR_DIM];
-            G.coord(k, j, i, Loci::center, Xnative);
-            G.coord_embed(k, j, i, Loci::center, Xembed);
-            GReal r = Xembed[1];
-
-            // Either fill the interior region with the innermost analytically computed value,
-            // or let it be filled with floor values later
-            if (r < rin_bondi) {
-                if (fill_interior) {
-                    // just match at the rin_bondi value
-                    r = rin_bondi;
-                    // TODO(BSP) could also do values at inf, restore that?
-                } else {
-                    return;
-                }
-            }
+    const int iRHO = m_p.RHO, iUU = m_p.UU, iU1 = m_p.U1, iU2 = m_p.U2, iU3 = m_p.U3;
 
-            Real rho, u, ur;
-            get_bondi_soln(r, rs, mdot, gam, rho, u, ur);
-
-            // Get the native-coordinate 4-vector corresponding to ur
-            const Real ucon_bl[GR_DIM] = {0, ur, 0, 0};
-            Real ucon_native[GR_DIM];
-            G.coords.bl_fourvel_to_native(Xnative, ucon_bl, ucon_native);
-
-            // Convert native 4-vector to primitive u-twiddle, see Gammie '04
-            Real gcon[GR_DIM][GR_DIM], u_prim[NVEC];
-            G.gcon(Loci::center, j, i, gcon);
-            fourvel_to_prim(gcon, ucon_native, u_prim);
-
-            // Note that NaN guards, including these, are ignored (!) under -ffast-math flag.
-            // Thus we stay away from initializing at EH where this could happen
-            if(!isnan(rho)) P(m_p.RHO, k, j, i) = rho;
-            if(!isnan(u)) P(m_p.UU, k, j, i) = u;
-            if(!isnan(u_prim[0])) P(m_p.U1, k, j, i) = u_prim[0];
-            if(!isnan(u_prim[1])) P(m_p.U2, k, j, i) = u_prim[1];
-            if(!isnan(u_prim[2])) P(m_p.U3, k, j, i) = u_prim[2];
+    if (domain == IndexDomain::interior || domain == IndexDomain::entire) {
+        // Initialization: just solve in each zone
+        pmb->par_for("bondi_set", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
+                Real prims[5];
+                const int set = get_bondi_prims(G, rs, mdot, gam, rin_bondi, fill_interior, k, j, i, prims);
+                if (set & 1) P(iRHO, k, j, i) = prims[0];
+                if (set & 2) P(iUU, k, j, i) = prims[1];
+                if (set & 4) P(iU1, k, j, i) = prims[2];
+                if (set & 8) P(iU2, k, j, i) = prims[3];
+                if (set & 16) P(iU3, k, j, i) = prims[4];
+            }
+        );
+    } else {
+        // Boundaries: the solution is time-independent, so solve once per block & boundary domain
+        // and keep the result, making later applications a copy.
+        // Keyed on the block's extent rather than gid, which can be reassigned on remeshing
+        auto *cache = pmb->packages.Get("GRMHD")->AllParams().GetMutable<std::map<std::array<GReal, 8>, ParArray4D<Real>>>("bondi_cache");
+        const auto& bs = pmb->block_size;
+        const std::array<GReal, 8> key = {bs.xmin(X1DIR), bs.xmax(X1DIR), bs.xmin(X2DIR), bs.xmax(X2DIR),
+                                          bs.xmin(X3DIR), bs.xmax(X3DIR), (GReal) domain, (GReal) coarse};
+        if (!cache->count(key)) {
+            // Five primitives & which of them to set
+            ParArray4D<Real> bcache("bondi_cache", 6, kb.e - kb.s + 1, jb.e - jb.s + 1, ib.e - ib.s + 1);
+            pmb->par_for("bondi_boundary_solve", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+                KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
+                    Real prims[5];
+                    const int set = get_bondi_prims(G, rs, mdot, gam, rin_bondi, fill_interior, k, j, i, prims);
+                    for (int p = 0; p < 5; p++) bcache(p, k - kb.s, j - jb.s, i - ib.s) = prims[p];
+                    bcache(5, k - kb.s, j - jb.s, i - ib.s) = set;
+                }
+            );
+            (*cache)[key] = bcache;
         }
-    );
+        const auto bcache = cache->at(key);
+        pmb->par_for("bondi_boundary", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
+                const int set = (int) bcache(5, k - kb.s, j - jb.s, i - ib.s);
+                if (set & 1) P(iRHO, k, j, i) = bcache(0, k - kb.s, j - jb.s, i - ib.s);
+                if (set & 2) P(iUU, k, j, i) = bcache(1, k - kb.s, j - jb.s, i - ib.s);
+                if (set & 4) P(iU1, k, j, i) = bcache(2, k - kb.s, j - jb.s, i - ib.s);
+                if (set & 8) P(iU2, k, j, i) = bcache(3, k - kb.s, j - jb.s, i - ib.s);
+                if (set & 16) P(iU3, k, j, i) = bcache(4, k - kb.s, j - jb.s, i - ib.s);
+            }
+        );
+    }
 
     // Generally I avoid this, but the viscous Bondi test problem has very unique
     // boundary requirements to converge.  The GRMHD vars must be held constant,
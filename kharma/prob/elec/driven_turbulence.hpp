@@ -34,10 +34,10 @@
 #pragma once
 
 #include "decs.hpp"
-#include "gaussian.hpp"
 #include "types.hpp"
 
 #include <parthenon/parthenon.hpp>
+#include "Kokkos_Random.hpp"
 
 using namespace parthenon;
 
@@ -73,6 +73,13 @@ TaskStatus InitializeDrivenTurbulence(std::shared_ptr<MeshBlockData<Real>>& rc,
     //adding for later use in create_grf
     if(! (pmb->packages.Get("GRMHD")->AllParams().hasKey("dt_kick")))
         pmb->packages.Get("GRMHD")->AddParam<Real>("dt_kick", dt_kick);
+    // Highest mode number kept when synthesizing each kick, and the seed for its amplitudes
+    const int kick_nmax = pin->GetOrAddInteger("driven_turbulence", "kick_nmax", 8);
+    if(! (pmb->packages.Get("GRMHD")->AllParams().hasKey("kick_nmax")))
+        pmb->packages.Get("GRMHD")->AddParam<int>("kick_nmax", kick_nmax);
+    const int kick_seed = pin->GetOrAddInteger("driven_turbulence", "seed", 31337);
+    if(! (pmb->packages.Get("GRMHD")->AllParams().hasKey("kick_seed")))
+        pmb->packages.Get("GRMHD")->AddParam<int>("kick_seed", kick_seed);
 
     const Real u0 = cs0 * cs0 * rho0 / (gam - 1) / gam; //from flux_functions.hpp
     IndexRange myib = pmb->cellbounds.GetBoundsI(IndexDomain::interior);
@@ -88,10 +95,79 @@ TaskStatus InitializeDrivenTurbulence(std::shared_ptr<MeshBlockData<Real>>& rc,
     return TaskStatus::complete;
 }
 
+/**
+ * Random amplitudes of the Fourier modes of a kick, for |n1|, |n2| <= nmax.
+ * Each mode draws from its own generator seeded by (seed, kick, mode), so every block & rank
+ * builds the same field without communication, independent of the device thread layout.
+ * The spectrum & solenoidal projection are those of create_grf in gaussian.cpp.
+ * Stored as (mode, {Re dv0, Im dv0, Re dv1, Im dv1})
+ */
+inline ParArray2D<Real> DrivingModes(MeshBlock *pmb, const int nmax, const Real lx1, const Real lx2,
+                                     const uint64_t seed, const uint64_t kick)
+{
+    const int nside = 2*nmax + 1;
+    const int nmodes = nside * nside;
+    const Real dkx1 = 2*M_PI/lx1;
+    const Real dkx2 = 2*M_PI/lx2;
+    const Real k_peak = 4*M_PI/lx1;
+    ParArray2D<Real> modes("grf_modes", nmodes, 4);
+    pmb->par_for("driven_turb_modes", 0, nmodes - 1,
+        KOKKOS_LAMBDA (const int &m) {
+            // splitmix64 of the seed, kick & mode, so nearby seeds don't give correlated streams
+            uint64_t z = seed + 0x9E3779B97F4A7C15ull * (kick * nmodes + m + 1);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            z = z ^ (z >> 31);
+            Kokkos::Random_XorShift64<DevExecSpace> rgen(z);
+
+            Real retx1 = (m / nside - nmax) * dkx1;
+            Real retx2 = (m % nside - nmax) * dkx2;
+            const Real curr_k_magn = m::sqrt(retx1*retx1 + retx2*retx2);
+            const Real pwr_spct = m::pow(curr_k_magn, 6)*m::exp(-8*curr_k_magn/k_peak);
+            if (curr_k_magn != 0) {
+                retx1 /= curr_k_magn;
+                retx2 /= curr_k_magn;
+            }
+
+            const Real noisy_dvkx1_real = pwr_spct*rgen.normal(); const Real noisy_dvkx1_imag = pwr_spct*rgen.normal();
+            const Real noisy_dvkx2_real = pwr_spct*rgen.normal(); const Real noisy_dvkx2_imag = pwr_spct*rgen.normal();
+            // Remove the component along k
+            const Real kdot_real = retx1*noisy_dvkx1_real + retx2*noisy_dvkx2_real;
+            const Real kdot_imag = retx1*noisy_dvkx1_imag + retx2*noisy_dvkx2_imag;
+            modes(m, 0) = noisy_dvkx1_real - kdot_real*retx1;
+            modes(m, 1) = noisy_dvkx1_imag - kdot_imag*retx1;
+            modes(m, 2) = noisy_dvkx2_real - kdot_real*retx2;
+            modes(m, 3) = noisy_dvkx2_imag - kdot_imag*retx2;
+        }
+    );
+    return modes;
+}
+
+/**
+ * Real part of the inverse transform of 'modes' at (X1, X2)
+ */
+KOKKOS_INLINE_FUNCTION void DrivingField(const ParArray2D<Real> &modes, const int &nmax,
+                                         const Real &dkx1, const Real &dkx2, const GReal X[GR_DIM],
+                                         Real &dv0, Real &dv1)
+{
+    const int nside = 2*nmax + 1;
+    dv0 = 0.; dv1 = 0.;
+    for (int m = 0; m < nside*nside; m++) {
+        const Real phase = (m / nside - nmax) * dkx1 * X[1] + (m % nside - nmax) * dkx2 * X[2];
+        const Real c = m::cos(phase), s = m::sin(phase);
+        dv0 += modes(m, 0) * c - modes(m, 1) * s;
+        dv1 += modes(m, 2) * c - modes(m, 3) * s;
+    }
+}
+
 /**
  * This applies a turbulent Gaussian random "kick" every dt_kick units of simulation time
  * It is only called after the last sub-step, so this splits nicely with the fluid
  * evolution operator.
+ *
+ * The field is synthesized on device from the modes |n| <= driven_turbulence/kick_nmax (the
+ * spectrum peaks at n ~ 1.5 and falls as n^6 e^{-4n}), and all the sums needed to center and
+ * normalize it are taken in one reduction.
  */
 void ApplyDrivingTurbulence(MeshBlockData<Real> *rc)
 {
@@ -110,6 +186,7 @@ void ApplyDrivingTurbulence(MeshBlockData<Real> *rc)
     Real counter = pmb->packages.Get("GRMHD")->Param<Real>("counter");
     const Real dt_kick=  pmb->packages.Get("GRMHD")->Param<Real>("dt_kick");
     if (counter < t) {
+        const uint64_t kick = static_cast<uint64_t>(m::round(counter / dt_kick));
         counter += dt_kick;
         pmb->packages.Get("GRMHD")->UpdateParam<Real>("counter", counter);
         printf("Kick applied at time %.32f\n", t);
@@ -117,70 +194,52 @@ void ApplyDrivingTurbulence(MeshBlockData<Real> *rc)
         const Real lx1=  pmb->packages.Get("GRMHD")->Param<Real>("lx1");
         const Real lx2=  pmb->packages.Get("GRMHD")->Param<Real>("lx2");
         const Real edot= pmb->packages.Get("GRMHD")->Param<Real>("drive_edot");
+        const int nmax = pmb->packages.Get("GRMHD")->Param<int>("kick_nmax");
+        const uint64_t seed = pmb->packages.Get("GRMHD")->Param<int>("kick_seed");
         GridScalar alfven_speed = rc->Get("alfven_speed").data;
-        
-        int Nx1 = pmb->cellbounds.ncellsi(IndexDomain::interior);
-        int Nx2 = pmb->cellbounds.ncellsj(IndexDomain::interior);
-        Real *dv0 =  (Real*) malloc(sizeof(Real)*Nx1*Nx2);
-        Real *dv1 =  (Real*) malloc(sizeof(Real)*Nx1*Nx2);
-        create_grf(Nx1, Nx2, lx1, lx2, dv0, dv1);
-
-        Real mean_velocity_num0 = 0;    Kokkos::Sum<Real> mean_velocity_num0_reducer(mean_velocity_num0);
-        Real mean_velocity_num1 = 0;    Kokkos::Sum<Real> mean_velocity_num1_reducer(mean_velocity_num1);
-        Real tot_mass = 0;              Kokkos::Sum<Real> tot_mass_reducer(tot_mass);
-        pmb->par_reduce("forced_mhd_normal_kick_centering_mean_vel0", mykb.s, mykb.e, myjb.s, myjb.e, myib.s, myib.e,
-            KOKKOS_LAMBDA (const int &k, const int &j, const int &i, double &local_result) {
-                Real cell_mass = (rho(k, j, i) * G.Dxc<3>(k) * G.Dxc<2>(j) * G.Dxc<1>(i));
-                local_result += cell_mass * dv0[(i-4)*Nx1+(j-4)];
-            }
-        , mean_velocity_num0_reducer);
-        pmb->par_reduce("forced_mhd_normal_kick_centering_mean_vel1", mykb.s, mykb.e, myjb.s, myjb.e, myib.s, myib.e,
-            KOKKOS_LAMBDA (const int &k, const int &j, const int &i, double &local_result) {
-                Real cell_mass = (rho(k, j, i) * G.Dxc<3>(k) * G.Dxc<2>(j) * G.Dxc<1>(i));
-                local_result += cell_mass * dv1[(i-4)*Nx1+(j-4)];
-            }
-        , mean_velocity_num1_reducer);
-        pmb->par_reduce("forced_mhd_normal_kick_centering_tot_mass", mykb.s, mykb.e, myjb.s, myjb.e, myib.s, myib.e,
-            KOKKOS_LAMBDA (const int &k, const int &j, const int &i, double &local_result) {
-                local_result += (rho(k, j, i) * G.Dxc<3>(k) * G.Dxc<2>(j) * G.Dxc<1>(i));
-            }
-        , tot_mass_reducer);
-        Real mean_velocity0 = mean_velocity_num0/tot_mass;
-        Real mean_velocity1 = mean_velocity_num1/tot_mass;
-        #pragma omp parallel for simd collapse(2)
-        for (size_t i = 0; i < Nx1 ; i ++) {
-            for (size_t j = 0; j < Nx2 ; j ++) {
-                dv0[i*Nx1+j] -= mean_velocity0;
-                dv1[i*Nx1+j] -= mean_velocity1;
-            }
-        } 
-
-        Real Bhalf = 0; Real A = 0; Real init_e = 0; 
-        Kokkos::Sum<Real> Bhalf_reducer(Bhalf); Kokkos::Sum<Real> A_reducer(A); Kokkos::Sum<Real> init_e_reducer(init_e);
-        pmb->par_reduce("forced_mhd_normal_kick_normalization_Bhalf", mykb.s, mykb.e, myjb.s, myjb.e, myib.s, myib.e,
-            KOKKOS_LAMBDA (const int &k, const int &j, const int &i, double &local_result) {
-                Real cell_mass = (rho(k, j, i) * G.Dxc<3>(k) * G.Dxc<2>(j) * G.Dxc<1>(i));
-                local_result += cell_mass * (dv0[(i-4)*Nx1+(j-4)]*uvec(0, k, j, i) + dv1[(i-4)*Nx1+(j-4)]*uvec(1, k, j, i));
-            }
-        , Bhalf_reducer);
-        pmb->par_reduce("forced_mhd_normal_kick_normalization_A", mykb.s, mykb.e, myjb.s, myjb.e, myib.s, myib.e,
-            KOKKOS_LAMBDA (const int &k, const int &j, const int &i, double &local_result) {
-                Real cell_mass = (rho(k, j, i) * G.Dxc<3>(k) * G.Dxc<2>(j) * G.Dxc<1>(i));
-                local_result += cell_mass * (pow(dv0[(i-4)*Nx1+(j-4)], 2) + pow(dv1[(i-4)*Nx1+(j-4)], 2));
-            }
-        , A_reducer);
-        pmb->par_reduce("forced_mhd_normal_kick_init_e", mykb.s, mykb.e, myjb.s, myjb.e, myib.s, myib.e,
-            KOKKOS_LAMBDA (const int &k, const int &j, const int &i, double &local_result) {
-                Real cell_mass = (rho(k, j, i) * G.Dxc<3>(k) * G.Dxc<2>(j) * G.Dxc<1>(i));
-                local_result += 0.5 * cell_mass * (pow(uvec(0, k, j, i), 2) + pow(uvec(1, k, j, i), 2));
+
+        const auto modes = DrivingModes(pmb.get(), nmax, lx1, lx2, seed, kick);
+        const Real dkx1 = 2*M_PI/lx1;
+        const Real dkx2 = 2*M_PI/lx2;
+
+        // Mass, mass-weighted sums of dv, u, dv.u, dv^2, u^2.  Centering dv on its mass-weighted
+        // mean afterward only needs these, so one pass replaces the separate reductions
+        enum {MASS=0, DV0, DV1, U0, U1, DVU, DV2, U2, NSUMS};
+        Reductions::array_type<Real, NSUMS> sums;
+        pmb->par_reduce("forced_mhd_normal_kick_sums", mykb.s, mykb.e, myjb.s, myjb.e, myib.s, myib.e,
+            KOKKOS_LAMBDA (const int &k, const int &j, const int &i, Reductions::array_type<Real, NSUMS> &local_result) {
+                GReal X[GR_DIM];
+                G.coord(k, j, i, Loci::center, X);
+                Real dv0, dv1;
+                DrivingField(modes, nmax, dkx1, dkx2, X, dv0, dv1);
+                grf_normalized(0, k, j, i) = dv0;
+                grf_normalized(1, k, j, i) = dv1;
+
+                const Real cell_mass = (rho(k, j, i) * G.Dxc<3>(k) * G.Dxc<2>(j) * G.Dxc<1>(i));
+                local_result.my_array[MASS] += cell_mass;
+                local_result.my_array[DV0] += cell_mass * dv0;
+                local_result.my_array[DV1] += cell_mass * dv1;
+                local_result.my_array[U0] += cell_mass * uvec(0, k, j, i);
+                local_result.my_array[U1] += cell_mass * uvec(1, k, j, i);
+                local_result.my_array[DVU] += cell_mass * (dv0 * uvec(0, k, j, i) + dv1 * uvec(1, k, j, i));
+                local_result.my_array[DV2] += cell_mass * (dv0 * dv0 + dv1 * dv1);
+                local_result.my_array[U2] += cell_mass * (SQR(uvec(0, k, j, i)) + SQR(uvec(1, k, j, i)));
             }
-        , init_e_reducer);
+        , Reductions::ArraySum<Real, HostExecSpace, NSUMS>(sums));
+        const Real *S = sums.my_array;
+        const Real mean_velocity0 = S[DV0]/S[MASS];
+        const Real mean_velocity1 = S[DV1]/S[MASS];
+
+        // Normalization terms of the centered field dv - mean
+        const Real Bhalf = S[DVU] - mean_velocity0 * S[U0] - mean_velocity1 * S[U1];
+        const Real A = S[DV2] - 2 * (mean_velocity0 * S[DV0] + mean_velocity1 * S[DV1])
+                       + (SQR(mean_velocity0) + SQR(mean_velocity1)) * S[MASS];
 
-        Real norm_const = (-Bhalf + pow(pow(Bhalf,2) + A*2*dt_kick*edot, 0.5))/A;  // going from k:(0, 0), j:(4, 515), i:(4, 515) inclusive
+        const Real norm_const = (-Bhalf + pow(pow(Bhalf,2) + A*2*dt_kick*edot, 0.5))/A;
         pmb->par_for("forced_mhd_normal_kick_setting", mykb.s, mykb.e, myjb.s, myjb.e, myib.s, myib.e,
             KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-                grf_normalized(0, k, j, i) = (dv0[(i-4)*Nx1+(j-4)]*norm_const);
-                grf_normalized(1, k, j, i) = (dv1[(i-4)*Nx1+(j-4)]*norm_const);
+                grf_normalized(0, k, j, i) = (grf_normalized(0, k, j, i) - mean_velocity0) * norm_const;
+                grf_normalized(1, k, j, i) = (grf_normalized(1, k, j, i) - mean_velocity1) * norm_const;
                 uvec(0, k, j, i) += grf_normalized(0, k, j, i);
                 uvec(1, k, j, i) += grf_normalized(1, k, j, i);
                 FourVectors Dtmp;
@@ -190,15 +249,10 @@ void ApplyDrivingTurbulence(MeshBlockData<Real> *rc)
             }
         );
 
-        Real finl_e = 0;    Kokkos::Sum<Real> finl_e_reducer(finl_e);
-        pmb->par_reduce("forced_mhd_normal_kick_finl_e", mykb.s, mykb.e, myjb.s, myjb.e, myib.s, myib.e,
-            KOKKOS_LAMBDA (const int &k, const int &j, const int &i, double &local_result) {
-                Real cell_mass = (rho(k, j, i) * G.Dxc<3>(k) * G.Dxc<2>(j) * G.Dxc<1>(i));
-                local_result += 0.5 * cell_mass * (pow(uvec(0, k, j, i), 2) + pow(uvec(1, k, j, i), 2));
-            }
-        , finl_e_reducer);
+        // The change in kinetic energy is exactly norm_const*Bhalf + norm_const^2*A/2 = edot*dt_kick,
+        // so it needs no further pass
+        const Real delta_e = norm_const * Bhalf + 0.5 * norm_const * norm_const * A;
         printf("%.32f\n", A); printf("%.32f\n", Bhalf); printf("%.32f\n", norm_const);
-        printf("%.32f\n", (finl_e-init_e)/dt_kick);
-        free(dv0); free(dv1);
+        printf("%.32f\n", delta_e/dt_kick);
     }
 }
@@ -36,26 +36,28 @@
 
 #include "floors.hpp"
 #include "coordinate_utils.hpp"
+#include "domain.hpp"
+#include "kharma.hpp"
 #include "types.hpp"
 
-TaskStatus InitializeFMTorus(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterInput *pin)
-{
-    auto pmb        = rc->GetBlockPointer();
-    GridScalar rho  = rc->Get("prims.rho").data;
-    GridScalar u    = rc->Get("prims.u").data;
-    GridVector uvec = rc->Get("prims.uvec").data;
+/**
+ * Torus parameters, and the analytic normalization rho_max.  Shared between the block & mesh versions
+ */
+struct FMTorusSetup {
+    GReal rin, rmax, tilt, a, l;
+    Real kappa, gam, rho_max;
+};
 
-    const GReal rin      = pin->GetOrAddReal("torus", "rin", 6.0);
-    const GReal rmax     = pin->GetOrAddReal("torus", "rmax", 12.0);
-    const Real kappa     = pin->GetOrAddReal("torus", "kappa", 1.e-3);
+// Read parameters, set up B-G injection, and find rho_max.  Any block's coordinates work here
+static FMTorusSetup SetupFMTorus(MeshBlock *pmb, ParameterInput *pin)
+{
+    FMTorusSetup t;
+    t.rin      = pin->GetOrAddReal("torus", "rin", 6.0);
+    t.rmax     = pin->GetOrAddReal("torus", "rmax", 12.0);
+    t.kappa    = pin->GetOrAddReal("torus", "kappa", 1.e-3);
     const GReal tilt_deg = pin->GetOrAddReal("torus", "tilt", 0.0);
-    const GReal tilt     = tilt_deg / 180. * M_PI;
-    const Real gam       = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
-
-    IndexDomain domain = IndexDomain::interior;
-    const int is = pmb->cellbounds.is(domain), ie = pmb->cellbounds.ie(domain);
-    const int js = pmb->cellbounds.js(domain), je = pmb->cellbounds.je(domain);
-    const int ks = pmb->cellbounds.ks(domain), ke = pmb->cellbounds.ke(domain);
+    t.tilt     = tilt_deg / 180. * M_PI;
+    t.gam      = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
 
     // Get coordinate systems
     // G clearly holds a reference to an existing system G.coords.base,
@@ -63,139 +65,169 @@ TaskStatus InitializeFMTorus(std::shared_ptr<MeshBlockData<Real>>& rc, Parameter
     // Since we can't create a system and assign later, we just
     // rebuild copies of both based on the BH spin "a"
     const auto& G = pmb->coords;
-    const GReal a = G.coords.get_a();
+    t.a = G.coords.get_a();
 
     // Blandford-Globus injection
     // B-G Model 
     const bool do_BG = pmb->packages.Get("B_FluxCT")->Param<bool>("do_BG");
-    if (do_BG) {
+    if (do_BG && !pmb->packages.Get("B_FluxCT")->AllParams().hasKey("bg_rate")) {
         GReal bg_rate = pin->GetOrAddReal("b_field", "bg_rate", 5.0);
 	    GReal bg_start_t = pin->GetOrAddReal("b_field", "bg_start_t", 2500.0 );
         pmb->packages.Get("B_FluxCT")->AllParams().Add("bg_rate", bg_rate);
 	    pmb->packages.Get("B_FluxCT")->AllParams().Add("bg_start_t", bg_start_t);
         auto bpkg = pmb->packages.Get<KHARMAPackage>("B_FluxCT");
-        bpkg->BlockApplyPrimSource = BG_Injection;
+        bpkg->MeshApplyPrimSource = BG_Injection;
     }
 
     // Fishbone-Moncrief parameters
-    Real l = lfish_calc(a, rmax);
+    t.l = lfish_calc(t.a, t.rmax);
 
-    pmb->par_for("fm_torus_init", ks, ke, js, je, is, ie,
-        KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-            GReal Xnative[GR_DIM], Xembed[GR_DIM], Xmidplane[GR_DIM];
-            G.coord(k, j, i, Loci::center, Xnative);
-            G.coord_embed(k, j, i, Loci::center, Xembed);
-            // What are our corresponding "midplane" values for evaluating the function?
-            rotate_polar(Xembed, tilt, Xmidplane);
-
-            GReal r   = Xmidplane[1], th = Xmidplane[2];
-            GReal sth = sin(th);
-            GReal cth = cos(th);
-
-            Real lnh = lnh_calc(a, l, rin, r, th);
-
-            // Region inside magnetized torus; u^i is calculated in
-            // Boyer-Lindquist coordinates, as per Fishbone & Moncrief,
-            // so it needs to be transformed at the end
-            // everything outside is left 0 to be added by the floors
-            if (lnh >= 0. && r >= rin) {
-                Real r2 = r*r;
-                Real a2 = a*a;
-                Real DD = r2 - 2. * r + a2;
-                Real AA = m::pow(r2 + a2, 2) - DD * a2 * sth * sth;
-                Real SS = r2 + a2 * cth * cth;
-
-                // Calculate rho and u
-                Real hm1   = m::exp(lnh) - 1.;
-                Real rho_l = m::pow(hm1 * (gam - 1.) / (kappa * gam), 1. / (gam - 1.));
-                Real u_l   = kappa * m::pow(rho_l, gam) / (gam - 1.);
-
-                // Calculate u^phi
-                Real expm2chi = SS * SS * DD / (AA * AA * sth * sth);
-                Real up1      = m::sqrt((-1. + m::sqrt(1. + 4. * l * l * expm2chi)) / 2.);
-                Real up       = 2. * a * r * m::sqrt(1. + up1 * up1) / m::sqrt(AA * SS * DD) +
-                                m::sqrt(SS / AA) * up1 / sth;
-
-                const Real ucon_tilt[GR_DIM] = {0., 0., 0., up};
-                Real ucon_bl[GR_DIM];
-                rotate_polar_vec(Xmidplane, ucon_tilt, -tilt, Xembed, ucon_bl);
-
-                // Then set u^t and transform the 4-vector to KS if necessary,
-                // and then to native coordinates
-                Real ucon_native[GR_DIM];
-                G.coords.bl_fourvel_to_native(Xnative, ucon_bl, ucon_native);
-
-                // Convert native 4-vector to primitive u-twiddle, see Gammie '04
-                Real gcon[GR_DIM][GR_DIM], u_prim[NVEC];
-                G.gcon(Loci::center, j, i, gcon);
-                fourvel_to_prim(gcon, ucon_native, u_prim);
-
-                rho(k, j, i) = rho_l;
-                u(k, j, i) = u_l;
-                uvec(0, k, j, i) = u_prim[0];
-                uvec(1, k, j, i) = u_prim[1];
-                uvec(2, k, j, i) = u_prim[2];
-            }
+    // Find rho_max "analytically" by looking over the whole mesh domain for the maximum in the midplane.
+    // This doesn't depend on the block, so it is computed by the first block on each rank and reused
+    auto& grmhd_params = pmb->packages.Get("GRMHD")->AllParams();
+    if (!grmhd_params.hasKey("rho_norm")) {
+        const GReal a = t.a, rin = t.rin, rmax = t.rmax;
+        const Real gam = t.gam, kappa = t.kappa;
+        // Done device-side for speed (for large 2D meshes this may get bad) but may work fine in HostSpace
+        // Note this covers the full domain on each rank: it doesn't need a grid so it's not a memory problem,
+        // and an MPI synch as is done for beta_min would be a headache
+        GReal x1min = pmb->pmy_mesh->mesh_size.xmin(X1DIR); // TODO probably could get domain from GRCoords
+        GReal x1max = pmb->pmy_mesh->mesh_size.xmax(X1DIR);
+        // Add back 2D if torus solution may not be largest in midplane (before tilt ofc)
+        //GReal x2min = pmb->pmy_mesh->mesh_size.x2min;
+        //GReal x2max = pmb->pmy_mesh->mesh_size.x2max;
+        GReal dx = 0.001;
+        int nx1 = (x1max - x1min) / dx;
+        //int nx2 = (x2max - x2min) / dx;
+
+        // If we print diagnostics, do so only from block 0, which is first on rank 0
+        if (pmb->gid == 0 && pmb->packages.Get("Globals")->Param<int>("verbose") > 0) {
+            std::cout << "Calculating maximum density:" << std::endl;
+            std::cout << "a = " << a << std::endl;
+            std::cout << "dx = " << dx << std::endl;
+            std::cout << "x1min->x1max: " << x1min << " " << x1max << std::endl;
+            std::cout << "nx1 = " << nx1 << std::endl;
+            //cout << "x2min->x2max: " << x2min << " " << x2max << std::endl;
+            //cout << "nx2 = " << nx2 << std::endl;
         }
-    );
 
-    // Find rho_max "analytically" by looking over the whole mesh domain for the maximum in the midplane
-    // Done device-side for speed (for large 2D meshes this may get bad) but may work fine in HostSpace
-    // Note this covers the full domain on each rank: it doesn't need a grid so it's not a memory problem,
-    // and an MPI synch as is done for beta_min would be a headache
-    GReal x1min = pmb->pmy_mesh->mesh_size.xmin(X1DIR); // TODO probably could get domain from GRCoords
-    GReal x1max = pmb->pmy_mesh->mesh_size.xmax(X1DIR);
-    // Add back 2D if torus solution may not be largest in midplane (before tilt ofc)
-    //GReal x2min = pmb->pmy_mesh->mesh_size.x2min;
-    //GReal x2max = pmb->pmy_mesh->mesh_size.x2max;
-    GReal dx = 0.001;
-    int nx1 = (x1max - x1min) / dx;
-    //int nx2 = (x2max - x2min) / dx;
-
-    // If we print diagnostics, do so only from block 0 as the others do exactly the same thing
-    // Since this is initialization, we are guaranteed to have a block 0
-    if (pmb->gid == 0 && pmb->packages.Get("Globals")->Param<int>("verbose") > 0) {
-        std::cout << "Calculating maximum density:" << std::endl;
-        std::cout << "a = " << a << std::endl;
-        std::cout << "dx = " << dx << std::endl;
-        std::cout << "x1min->x1max: " << x1min << " " << x1max << std::endl;
-        std::cout << "nx1 = " << nx1 << std::endl;
-        //cout << "x2min->x2max: " << x2min << " " << x2max << std::endl;
-        //cout << "nx2 = " << nx2 << std::endl;
-    }
+        Real rho_max = 0;
+        Kokkos::Max<Real> max_reducer(rho_max);
+        pmb->par_reduce("fm_torus_maxrho", 0, nx1,
+            KOKKOS_LAMBDA (const int &i, parthenon::Real &local_result) {
+                GReal x1 = x1min + i*dx;
+                //GReal x2 = x2min + j*dx;
+                GReal Xnative[GR_DIM] = {0,x1,0,0};
+                GReal Xembed[GR_DIM];
+                G.coords.coord_to_embed(Xnative, Xembed);
+                const GReal r = Xembed[1];
+                // Regardless of native coordinate shenanigans,
+                // set th=pi/2 since the midplane is densest in the solution
+                const GReal rho = fm_torus_rho(a, rin, rmax, gam, kappa, r, M_PI/2.);
+                // TODO umax for printing/recording?
 
-    // TODO split this out
-    Real rho_max = 0;
-    Kokkos::Max<Real> max_reducer(rho_max);
-    pmb->par_reduce("fm_torus_maxrho", 0, nx1,
-        KOKKOS_LAMBDA (const int &i, parthenon::Real &local_result) {
-            GReal x1 = x1min + i*dx;
-            //GReal x2 = x2min + j*dx;
-            GReal Xnative[GR_DIM] = {0,x1,0,0};
-            GReal Xembed[GR_DIM];
-            G.coords.coord_to_embed(Xnative, Xembed);
-            const GReal r = Xembed[1];
-            // Regardless of native coordinate shenanigans,
-            // set th=pi/2 since the midplane is densest in the solution
-            const GReal rho = fm_torus_rho(a, rin, rmax, gam, kappa, r, M_PI/2.);
-            // TODO umax for printing/recording?
-
-            // Record max
-            if (rho > local_result) local_result = rho;
+                // Record max
+                if (rho > local_result) local_result = rho;
+            }
+        , max_reducer);
+
+        // Record and print normalization factor
+        grmhd_params.Add("rho_norm", rho_max);
+        if (pmb->packages.Get("Globals")->Param<int>("verbose") > 0 && MPIRank0()) {
+            std::cout << "Initial maximum density is " << rho_max << std::endl;
         }
-    , max_reducer);
+    }
+    t.rho_max = grmhd_params.Get<Real>("rho_norm");
+
+    return t;
+}
+
+
+/**
+ * Fill the torus in one zone, already normalized.  Zones outside the torus are left to the floors
+ */
+KOKKOS_INLINE_FUNCTION void fm_torus_zone(const GRCoordinates& G, const FMTorusSetup& t, const int& k, const int& j, const int& i,
+                                          Real& rho, Real& u, Real& u1, Real& u2, Real& u3)
+{
+    const GReal a = t.a, l = t.l, rin = t.rin, tilt = t.tilt;
+    const Real gam = t.gam, kappa = t.kappa;
+
+    GReal Xnative[GR_DIM], Xembed[GR_DIM], Xmidplane[GR_DIM];
+    G.coord(k, j, i, Loci::center, Xnative);
+    G.coord_embed(k, j, i, Loci::center, Xembed);
+    // What are our corresponding "midplane" values for evaluating the function?
+    rotate_polar(Xembed, tilt, Xmidplane);
+
+    GReal r   = Xmidplane[1], th = Xmidplane[2];
+    GReal sth = sin(th);
+    GReal cth = cos(th);
+
+    Real lnh = lnh_calc(a, l, rin, r, th);
+
+    // Region inside magnetized torus; u^i is calculated in
+    // Boyer-Lindquist coordinates, as per Fishbone & Moncrief,
+    // so it needs to be transformed at the end
+    // everything outside is left 0 to be added by the floors
+    if (lnh >= 0. && r >= rin) {
+        Real r2 = r*r;
+        Real a2 = a*a;
+        Real DD = r2 - 2. * r + a2;
+        Real AA = m::pow(r2 + a2, 2) - DD * a2 * sth * sth;
+        Real SS = r2 + a2 * cth * cth;
+
+        // Calculate rho and u
+        Real hm1   = m::exp(lnh) - 1.;
+        Real rho_l = m::pow(hm1 * (gam - 1.) / (kappa * gam), 1. / (gam - 1.));
+        Real u_l   = kappa * m::pow(rho_l, gam) / (gam - 1.);
+
+        // Calculate u^phi
+        Real expm2chi = SS * SS * DD / (AA * AA * sth * sth);
+        Real up1      = m::sqrt((-1. + m::sqrt(1. + 4. * l * l * expm2chi)) / 2.);
+        Real up       = 2. * a * r * m::sqrt(1. + up1 * up1) / m::sqrt(AA * SS * DD) +
+                        m::sqrt(SS / AA) * up1 / sth;
+
+        const Real ucon_tilt[GR_DIM] = {0., 0., 0., up};
+        Real ucon_bl[GR_DIM];
+        rotate_polar_vec(Xmidplane, ucon_tilt, -tilt, Xembed, ucon_bl);
+
+        // Then set u^t and transform the 4-vector to KS if necessary,
+        // and then to native coordinates
+        Real ucon_native[GR_DIM];
+        G.coords.bl_fourvel_to_native(Xnative, ucon_bl, ucon_native);
 
-    // Record and print normalization factor
-    if(! (pmb->packages.Get("GRMHD")->AllParams().hasKey("rho_norm")))
-        pmb->packages.Get("GRMHD")->AllParams().Add("rho_norm", rho_max);
-    if (pmb->gid == 0 && pmb->packages.Get("Globals")->Param<int>("verbose") > 0) {
-        std::cout << "Initial maximum density is " << rho_max << std::endl;
+        // Convert native 4-vector to primitive u-twiddle, see Gammie '04
+        Real gcon[GR_DIM][GR_DIM], u_prim[NVEC];
+        G.gcon(Loci::center, j, i, gcon);
+        fourvel_to_prim(gcon, ucon_native, u_prim);
+
+        // Normalized as we go, so the torus is set in one pass
+        rho = rho_l / t.rho_max;
+        u = u_l / t.rho_max;
+        u1 = u_prim[0];
+        u2 = u_prim[1];
+        u3 = u_prim[2];
     }
+}
+
+TaskStatus InitializeFMTorus(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterInput *pin)
+{
+    auto pmb        = rc->GetBlockPointer();
+    GridScalar rho  = rc->Get("prims.rho").data;
+    GridScalar u    = rc->Get("prims.u").data;
+    GridVector uvec = rc->Get("prims.uvec").data;
+
+    const FMTorusSetup t = SetupFMTorus(pmb.get(), pin);
 
-    pmb->par_for("fm_torus_normalize", ks, ke, js, je, is, ie,
+    IndexDomain domain = IndexDomain::interior;
+    const int is = pmb->cellbounds.is(domain), ie = pmb->cellbounds.ie(domain);
+    const int js = pmb->cellbounds.js(domain), je = pmb->cellbounds.je(domain);
+    const int ks = pmb->cellbounds.ks(domain), ke = pmb->cellbounds.ke(domain);
+    const auto& G = pmb->coords;
+
+    pmb->par_for("fm_torus_init", ks, ke, js, je, is, ie,
         KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-            rho(k, j, i) /= rho_max;
-            u(k, j, i) /= rho_max;
+            fm_torus_zone(G, t, k, j, i, rho(k, j, i), u(k, j, i),
+                          uvec(0, k, j, i), uvec(1, k, j, i), uvec(2, k, j, i));
         }
     );
 
@@ -207,41 +239,100 @@ TaskStatus InitializeFMTorus(std::shared_ptr<MeshBlockData<Real>>& rc, Parameter
 
     return TaskStatus::complete;
 }
-void BG_Injection(MeshBlockData<Real> *rc) 
+
+TaskStatus InitializeFMTorus(MeshData<Real> *md, ParameterInput *pin)
 {
-    auto pmb = rc->GetBlockPointer();
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const FMTorusSetup t = SetupFMTorus(pmb0.get(), pin);
 
     PackIndexMap prims_map;
-    auto P = GRMHD::PackMHDPrims(rc, prims_map);
+    auto P = GRMHD::PackMHDPrims(md, prims_map);
     const VarMap m_p(prims_map, false);
 
-    GRCoordinates G = pmb->coords;
+    const IndexRange3 b = KDomain::GetRange(md, IndexDomain::interior);
+    const IndexRange block = IndexRange{0, P.GetDim(5) - 1};
+    pmb0->par_for("fm_torus_init_mesh", block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        KOKKOS_LAMBDA (const int &bl, const int &k, const int &j, const int &i) {
+            const auto& G = P.GetCoords(bl);
+            fm_torus_zone(G, t, k, j, i, P(bl, m_p.RHO, k, j, i), P(bl, m_p.UU, k, j, i),
+                          P(bl, m_p.U1, k, j, i), P(bl, m_p.U2, k, j, i), P(bl, m_p.U3, k, j, i));
+        }
+    );
+
+    // As above
+    Floors::ApplyInitialFloors(pin, md, IndexDomain::interior);
+
+    return TaskStatus::complete;
+}
+
+void BG_Injection(MeshData<Real> *md)
+{
+    auto pmesh = md->GetMeshPointer();
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
 
-    IndexDomain domain = IndexDomain::entire;
-    auto ib = rc->GetBoundsI(domain);
-    auto jb = rc->GetBoundsJ(domain);
-    auto kb = rc->GetBoundsK(domain);
+    const GReal rate = pmb0->packages.Get("B_FluxCT")->Param<Real>("bg_rate");
+    const GReal start_time = pmb0->packages.Get("B_FluxCT")->Param<Real>("bg_start_t");
+    const GReal dt = pmb0->packages.Get("Globals")->Param<Real>("dt_last");
+    const GReal t = pmb0->packages.Get("Globals")->Param<Real>("time");
+    if (t <= start_time) return;
 
-    const GReal rate = pmb->packages.Get("B_FluxCT")->Param<Real>("bg_rate");
-    const GReal start_time = pmb->packages.Get("B_FluxCT")->Param<Real>("bg_start_t");
-    const GReal dt = pmb->packages.Get("Globals")->Param<Real>("dt_last");
     const GReal cthwid = .1; /* how wide a cone is the field addition region */
     const GReal bchar = 1.; /* characteristic field strength */
     const GReal fac = -2.76/(cthwid*cthwid); /*conversion from FWHM to 1/(2 stdev^2)*/
-    const GReal t = pmb->packages.Get("Globals")->Param<Real>("time");
-    
-
-    if (t > start_time) {
-        pmb->par_for("magnetic_injection", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e, 
-            KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-                GReal Xnative[GR_DIM], Xembed[GR_DIM];
-                G.coord(k, j, i, Loci::center, Xnative);
-                G.coord_embed(k, j, i, Loci::center, Xembed);
-                GReal r = Xembed[1];
-                GReal th = Xembed[2];
-                P(m_p.B1, k, j, i) += (exp(th*th*fac)-exp((M_PI-th)*(M_PI-th)*fac))*rate*dt*bchar/G.gdet(Loci::center, j, i);
-            }  
-        ); 
-        B_FluxCT::BlockPtoU(rc, IndexDomain::entire); 
-    }
+    // Zones where the cone profile is below this add nothing representable, and are skipped.
+    // For the default width that is everything more than ~0.3rad from either pole
+    const GReal min_weight = 1.e-16;
+
+    PackIndexMap prims_map, cons_map;
+    auto P = GRMHD::PackMHDPrims(md, prims_map);
+    auto U = GRMHD::PackMHDCons(md, cons_map);
+    const VarMap m_p(prims_map, false), m_u(cons_map, true);
+
+    const IndexRange ib = md->GetBoundsI(IndexDomain::entire);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::entire);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::entire);
+    const int nb = P.GetDim(5);
+    const int nj = jb.e - jb.s + 1, ni = ib.e - ib.s + 1;
+    const int n2d = nb * nj * ni;
+
+    // Compact the (block, j, i) columns inside the polar cones into a list.  The profile depends
+    // only on theta, which in spherical KS coordinates doesn't vary with X3
+    auto list = KHARMA::GetScratch(pmesh, "bg_injection", 1, 1, 1, 1, n2d);
+    int n_inject = 0;
+    Kokkos::parallel_scan("bg_injection_select", Kokkos::RangePolicy<>(DevExecSpace(), 0, n2d),
+        KOKKOS_LAMBDA (const int &n, int &update, const bool final) {
+            const int b = n / (nj * ni);
+            const int j = jb.s + (n / ni) % nj;
+            const int i = ib.s + n % ni;
+            const auto& G = P.GetCoords(b);
+            GReal Xembed[GR_DIM];
+            G.coord_embed(kb.s, j, i, Loci::center, Xembed);
+            const GReal th = Xembed[2];
+            const GReal weight = exp(th*th*fac) - exp((M_PI-th)*(M_PI-th)*fac);
+            if (m::abs(weight) > min_weight) {
+                if (final) list(0, 0, 0, 0, update) = n;
+                ++update;
+            }
+        }
+    , n_inject);
+    if (n_inject == 0) return;
+
+    // Add the field in just those columns.  The conserved field is sqrt(-g) B, so it is updated
+    // directly rather than with a PtoU over the whole domain
+    const GReal dB = rate*dt*bchar;
+    pmb0->par_for("magnetic_injection", 0, n_inject - 1, kb.s, kb.e,
+        KOKKOS_LAMBDA (const int &l, const int &k) {
+            const int n = static_cast<int>(list(0, 0, 0, 0, l));
+            const int b = n / (nj * ni);
+            const int j = jb.s + (n / ni) % nj;
+            const int i = ib.s + n % ni;
+            const auto& G = P.GetCoords(b);
+            GReal Xembed[GR_DIM];
+            G.coord_embed(k, j, i, Loci::center, Xembed);
+            const GReal th = Xembed[2];
+            const GReal added = (exp(th*th*fac)-exp((M_PI-th)*(M_PI-th)*fac))*dB;
+            P(b, m_p.B1, k, j, i) += added/G.gdet(Loci::center, j, i);
+            U(b, m_u.B1, k, j, i) += added;
+        }
+    );
 }
@@ -11,6 +11,10 @@
  * @param rmax is the radius of maximum density of the F-M torus in r_g
  */
 TaskStatus InitializeFMTorus(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterInput *pin);
+/**
+ * As above, over all blocks of a MeshData in one kernel.  Used by KHARMA::MeshProblemGenerator
+ */
+TaskStatus InitializeFMTorus(MeshData<Real> *md, ParameterInput *pin);
 
 /**
  * Torus solution for ln h, See Fishbone and Moncrief eqn. 3.6. 
@@ -106,6 +110,7 @@ KOKKOS_INLINE_FUNCTION Real fm_torus_rho(const GReal a, const GReal rin, const G
 }
 
 /**
-* Magnetic flux injection for Blandford-Globus model
+* Magnetic flux injection for Blandford-Globus model.
+* Only touches the zones near the poles where the injection profile is nonzero.
 */
-void BG_Injection(MeshBlockData<Real> *rc);
+void BG_Injection(MeshData<Real> *md);
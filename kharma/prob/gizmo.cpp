@@ -41,6 +41,33 @@
  * Initialization of domain from output of cosmological simulation code GIZMO
  * Note this requires 
  */
+/**
+ * Read the radial profile in datfn, and keep it on device in the GRMHD package's params,
+ * resampled to a table uniform in log(r) with n points (by default 4x the file's resolution).
+ * SetGIZMO is also a boundary condition, so this saves reading the file on every application.
+ */
+static void LoadGIZMO(StateDescriptor *pkg, const std::string& datfn, int n)
+{
+    std::vector<Real> rarr;
+    std::vector<std::vector<Real>> vars(3);
+    FILE *fptr = fopen(datfn.c_str(), "r");
+    if (fptr == nullptr)
+        throw std::runtime_error("Could not open GIZMO data file "+datfn);
+    double r, rho, T, vr, Menc;
+    while (fscanf(fptr, "%lf %lf %lf %lf %lf\n", &r, &rho, &T, &vr, &Menc) == 5) {
+        rarr.push_back(r);
+        vars[GIZMO_RHO].push_back(rho);
+        vars[GIZMO_T].push_back(T);
+        vars[GIZMO_VR].push_back(vr);
+    }
+    fclose(fptr);
+    if (rarr.size() < 2)
+        throw std::runtime_error("GIZMO data file "+datfn+" has fewer than 2 radii!");
+
+    if (n <= 0) n = 4 * rarr.size();
+    pkg->AddParam<Interpolation::LogRTable>("gizmo_profile", Interpolation::ResampleLogR("gizmo_profile", rarr, vars, n));
+}
+
 TaskStatus InitializeGIZMO(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterInput *pin)
 {
     auto pmb = rc->GetBlockPointer();
@@ -59,6 +86,8 @@ TaskStatus InitializeGIZMO(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterIn
         pmb->packages.Get("GRMHD")->AddParam<std::string>("gizmo_dat", datfn);
     if(! (pmb->packages.Get("GRMHD")->AllParams().hasKey("rin_init")))
         pmb->packages.Get("GRMHD")->AddParam<Real>("rin_init", rin_init);
+    if(! (pmb->packages.Get("GRMHD")->AllParams().hasKey("gizmo_profile")))
+        LoadGIZMO(pmb->packages.Get("GRMHD").get(), datfn, pin->GetOrAddInteger("gizmo", "table_size", -1));
 
     // Set the interior domain to the analytic solution to begin
     // This tests that PostInitialize will correctly fill ghost zones with the boundary we set
@@ -88,7 +117,6 @@ TaskStatus SetGIZMO(std::shared_ptr<MeshBlockData<Real>>& rc, IndexDomain domain
 
     const EMHD::EMHD_parameters& emhd_params = EMHD::GetEMHDParameters(pmb->packages);
 
-    auto datfn = pmb->packages.Get("GRMHD")->Param<std::string>("gizmo_dat");
     auto rin_init = pmb->packages.Get("GRMHD")->Param<Real>("rin_init");
 
     // Just the X1 right boundary
@@ -102,56 +130,17 @@ TaskStatus SetGIZMO(std::shared_ptr<MeshBlockData<Real>>& rc, IndexDomain domain
     const IndexRange jb = bounds.GetBoundsJ(domain);
     const IndexRange kb = bounds.GetBoundsK(domain);
     
-    // GIZMO shell
-    // Read the gizmo data file
-    FILE *fptr = fopen(datfn.c_str(),"r");
-    const int datlen = 100000;
-    Real *rarr = new double[datlen];
-    Real *rhoarr = new double[datlen]; 
-    Real *Tarr = new double[datlen]; 
-    Real *vrarr = new double[datlen]; 
-    Real *Mencarr = new double[datlen]; 
-    int length=0, itemp=0;
-    while (fscanf(fptr,"%lf %lf %lf %lf %lf\n", &(rarr[itemp]), &(rhoarr[itemp]), &(Tarr[itemp]), &(vrarr[itemp]), &(Mencarr[itemp])) == 5) { // assign the read value to variable, and enter it in array
-            itemp++;
-    }
-    fclose(fptr);
-    length = itemp;
-
-    GridVector r_device("r_device", length); 
-    GridVector rho_device("rho_device", length); 
-    GridVector T_device("T_device", length); 
-    GridVector vr_device("vr_device", length); 
-    auto r_host = r_device.GetHostMirror();
-    auto rho_host = rho_device.GetHostMirror();
-    auto T_host = T_device.GetHostMirror();
-    auto vr_host = vr_device.GetHostMirror();
-    for (itemp = 0; itemp < length; itemp++) {
-        r_host(itemp) = rarr[itemp];
-        rho_host(itemp) = rhoarr[itemp];
-        T_host(itemp) = Tarr[itemp];
-        vr_host(itemp) = vrarr[itemp];
-    }
-    r_device.DeepCopy(r_host);
-    rho_device.DeepCopy(rho_host);
-    T_device.DeepCopy(T_host);
-    vr_device.DeepCopy(vr_host);
-        
-    Kokkos::fence();
+    // GIZMO shell, read once in InitializeGIZMO
+    const auto profile = pmb->packages.Get("GRMHD")->Param<Interpolation::LogRTable>("gizmo_profile");
 
     pmb->par_for("gizmo_shell", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
             // same vacuum conditions at rin_init
-            GReal Xshell[GR_DIM] = {0, rin_init, 0, 0};
-            int i_sh;
-            GReal del_sh;
-            XtoindexGIZMO(Xshell, r_device, length, i_sh, del_sh);
-            Real vacuum_rho, vacuum_u_over_rho, vacuum_logrho, vacuum_log_u_over_rho;
-            vacuum_rho = rho_device(i_sh)*(1.-del_sh)+rho_device(i_sh+1)*del_sh;
-            vacuum_u_over_rho = (T_device(i_sh)*(1.-del_sh)+T_device(i_sh+1)*del_sh)/(gam-1.);
-
-            get_prim_gizmo_shell(G, cs, P, m_p, gam, rin_init, rs, vacuum_rho, vacuum_u_over_rho, 
-                r_device, rho_device, T_device, vr_device, length, k, j, i);
+            const Real vacuum_rho = profile(GIZMO_RHO, rin_init);
+            const Real vacuum_u_over_rho = profile(GIZMO_T, rin_init) / (gam - 1.);
+
+            get_prim_gizmo_shell(G, cs, P, m_p, gam, rin_init, rs, vacuum_rho, vacuum_u_over_rho,
+                                 profile, k, j, i);
         }
     );
 
@@ -41,6 +41,7 @@
 #include "grmhd_functions.hpp"
 #include "pack.hpp"
 #include "coordinate_utils.hpp"
+#include "interpolation.hpp"
 #include "types.hpp"
 
 #include <parthenon/parthenon.hpp>
@@ -57,31 +58,11 @@ TaskStatus InitializeGIZMO(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterIn
  */
 TaskStatus SetGIZMO(std::shared_ptr<MeshBlockData<Real>>& rc, IndexDomain domain, bool coarse=false);
 
-KOKKOS_INLINE_FUNCTION void XtoindexGIZMO(const GReal XG[GR_DIM],
-                                    const GridScalar& rarr, const int length, int& i, GReal& del)
-{
-    Real dx2, dx2_min;
-    dx2_min = m::pow(XG[1]-rarr(0),2); //100000.; //arbitrarily large number
-
-    i = 0; // initialize
-
-    for (int itemp = 0; itemp < length; itemp++) {
-        if (rarr(itemp) < XG[1]) { // only look for smaller side
-            dx2 = m::pow(XG[1] - rarr(itemp), 2);
+// Variables in the GIZMO profile table
+#define GIZMO_RHO 0
+#define GIZMO_T 1
+#define GIZMO_VR 2
 
-            // simplest interpolation (Hyerin 07/26/22)
-            if (dx2 < dx2_min){
-                dx2_min = dx2;
-                i = itemp;
-            }
-        }
-    }
-    
-    // interpolation (11/14/2022) TODO: write a case where indices hit the boundaries of the data file
-    del = (XG[1]-rarr(i))/(rarr(i+1)-rarr(i));
-
-    if (m::abs(dx2_min/m::pow(XG[1],2))>1.e-8) printf("XtoindexGizmo: dx2 pretty large = %g at r= %g \n",dx2_min, XG[1]);
-}
 /**
  * Get the GIZMO output values at a particular zone
  * Note this assumes that there are ghost zones!
@@ -89,7 +70,7 @@ KOKKOS_INLINE_FUNCTION void XtoindexGIZMO(const GReal XG[GR_DIM],
 KOKKOS_INLINE_FUNCTION void get_prim_gizmo_shell(const GRCoordinates& G, const CoordinateEmbedding& coords, const VariablePack<Real>& P, const VarMap& m_p,
                                            const Real& gam,
                                            const Real rin_init, const Real rs, Real vacuum_rho, Real vacuum_u_over_rho,
-                                           const GridScalar& rarr, const GridScalar& rhoarr, const GridScalar& Tarr, const GridScalar& vrarr, const int length,
+                                           const Interpolation::LogRTable& profile,
                                            const int& k, const int& j, const int& i)
 {
     // Solution constants for velocity prescriptions
@@ -112,14 +93,9 @@ KOKKOS_INLINE_FUNCTION void get_prim_gizmo_shell(const GRCoordinates& G, const C
         Real rho_tmp, u_tmp;
         get_bondi_soln(r, rs, mdot, gam, rho_tmp, u_tmp, ur);
     } else {
-        // linear interpolation
-        int itemp; GReal del;
-        XtoindexGIZMO(Xembed, rarr, length, itemp, del);
-        if (del < 0 ) { // when r is smaller than GIZMO's range
-            del = 0; // just copy over the smallest r values
-        }
-        rho = rhoarr(itemp) * (1.-del) + rhoarr(itemp+1) * del;
-        u = rho * (Tarr(itemp) * (1.-del) + Tarr(itemp+1) * del) / (gam - 1.);
+        // Interpolate the profile.  Radii below GIZMO's range just copy the smallest r values
+        rho = profile(GIZMO_RHO, r);
+        u = rho * profile(GIZMO_T, r) / (gam - 1.);
         ur = 0.;
     }
     Real ucon_bl[GR_DIM] = {0., ur, 0., 0.};
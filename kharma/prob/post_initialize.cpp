@@ -40,6 +40,7 @@
 #include "b_flux_ct.hpp"
 #include "blob.hpp"
 #include "boundaries.hpp"
+#include "electrons.hpp"
 #include "emhd.hpp"
 #include "floors.hpp"
 #include "flux.hpp"
@@ -51,6 +52,26 @@
 #include "seed_B.hpp"
 #include "types.hpp"
 
+// Cheap check of a restarted state, in place of re-deriving it: count NaN & negative primitives over the mesh.
+// Throws on every rank together if anything came back NaN
+static void CheckRestartState(std::shared_ptr<MeshData<Real>>& md)
+{
+    Flag("CheckRestartState");
+    // Every block, i.e. one sample in every 1. The ctop count is ignored, as signal speeds aren't restored
+    const auto counts = Reductions::SampledChecks(md.get(), 1, 0);
+    Reductions::StartToAll<std::vector<int>>(md.get(), 0, counts, MPI_SUM);
+    const auto totals = Reductions::CheckOnAll<std::vector<int>>(md.get(), 0);
+    const int nnan = totals[0], nneg_rho = totals[1], nneg_u = totals[2];
+    if (MPIRank0() && (nneg_rho > 0 || nneg_u > 0)) {
+        std::cout << "Number of negative primitive rho, u on restart: " << nneg_rho << "," << nneg_u << std::endl;
+    }
+    if (nnan > 0) {
+        if (MPIRank0()) fprintf(stderr, "Restarted state has %d zones with NaN primitives!\n", nnan);
+        throw std::runtime_error("Bad state read on restart!");
+    }
+    EndFlag();
+}
+
 void KHARMA::PostInitialize(ParameterInput *pin, Mesh *pmesh, bool is_restart)
 {
     // This call:
@@ -59,6 +80,7 @@ void KHARMA::PostInitialize(ParameterInput *pin, Mesh *pmesh, bool is_restart)
     // 3. Adds any extra material which might be superimposed when restarting, e.g. "hotspot" regions a.k.a. "blobs"
     // 4. Resets a couple of incidental flags, if Parthenon read them from a restart file
     // 5. If necessary, cleans up any magnetic field divergence present on the grid
+    // Exact restarts (Parthenon restart files & KHARMA checkpoints) skip step 5 by default, see fast_restart below
 
     // Coming into this function, at least the *interior* regions should be initialized with a problem:
     // that is, rho, u, uvec, and any nonzero auxiliary variables, on each physical zone.
@@ -108,8 +130,8 @@ void KHARMA::PostInitialize(ParameterInput *pin, Mesh *pmesh, bool is_restart)
         // but KHARMA needs a few (currently one) reset instead
         KHARMA::ResetGlobals(pin, pmesh);
 
-        // We only record the conserved magnetic field in KHARMA restarts,
-        // but we record primitive field in iharm3d restarts
+        // KHARMA restarts & checkpoints record only conserved magnetic field & extra variables
+        // (along with the GRMHD primitives), but iharm3d restarts record primitive field
         bool iharm3d_restart = prob_name == "resize_restart";
         if (!iharm3d_restart) {
             if (pkgs.count("B_FluxCT")) {
@@ -120,6 +142,9 @@ void KHARMA::PostInitialize(ParameterInput *pin, Mesh *pmesh, bool is_restart)
             if (pkgs.count("EMHD")) {
                 EMHD::MeshUtoP(md.get(), IndexDomain::entire);
             }
+            if (pkgs.count("Electrons")) {
+                Electrons::MeshUtoP(md.get(), IndexDomain::entire);
+            }
         } else {
             if (pkgs.count("B_FluxCT")) {
                 B_FluxCT::MeshPtoU(md.get(), IndexDomain::entire);
@@ -130,13 +155,18 @@ void KHARMA::PostInitialize(ParameterInput *pin, Mesh *pmesh, bool is_restart)
         }
     }
 
-    if (pin->GetString("b_field", "solver") != "none") {
-        // Regardless of how we initialized, if evolving a field we should print max(divB)
-        // divB is not stencil-1, and we may or may not have initialized or read it
-        // Either way, we still need another sync, so it works out
-        KBoundaries::FreezeDirichlet(md);
-        KHARMADriver::SyncAllBounds(md);
-
+    // Exact restarts (not resizes) pick up a state which was already consistent & cleaned when written.
+    // With restart/fast (default), these skip the initial B field cleanup, along with its extra
+    // FreezeDirichlet/sync & divB print, even if b_cleanup is on for the run (periodic cleaning is unaffected).
+    // They go straight to the final PtoU & single sync below, then just check the state for NaN/negative values.
+    const bool exact_restart = is_restart && prob_name != "resize_restart" && prob_name != "resize_restart_kharma";
+    const bool fast_restart = exact_restart && pin->GetOrAddBoolean("restart", "fast", true);
+
+    // Regardless of how we initialized, if evolving a field we should print max(divB)
+    // divB is not stencil-1, and we may or may not have initialized or read it, so it needs a sync.
+    // If we're cleaning, print before & after.  Otherwise, wait for the final sync below
+    const bool has_b_field = pin->GetString("b_field", "solver") != "none";
+    auto print_divb = [&]() {
         if (pkgs.count("B_FluxCT")) {
             B_FluxCT::PrintGlobalMaxDivB(md.get());
         } else if (pkgs.count("B_CT")) {
@@ -144,12 +174,17 @@ void KHARMA::PostInitialize(ParameterInput *pin, Mesh *pmesh, bool is_restart)
         } else if (pkgs.count("B_CD")) {
             //B_CD::PrintGlobalMaxDivB(md.get());
         }
+    };
+    if (has_b_field && pkgs.count("B_Cleanup") && !fast_restart) {
+        KBoundaries::FreezeDirichlet(md);
+        KHARMADriver::SyncAllBounds(md);
+        print_divb();
     }
 
     // Clean the B field, generally for resizing/restarting
     // We call this function any time the package is loaded:
     // if we decided to load it in kharma.cpp, we need to clean.
-    if (pkgs.count("B_Cleanup")) {
+    if (pkgs.count("B_Cleanup") && !fast_restart) {
         if (pin->GetOrAddBoolean("b_cleanup", "output_before_cleanup", false)) {
             auto tm = SimTime(0., 0., 0, 0, 0, 0, 0.);
             auto pouts = std::make_unique<Outputs>(pmesh, pin, &tm);
@@ -177,4 +212,9 @@ void KHARMA::PostInitialize(ParameterInput *pin, Mesh *pmesh, bool is_restart)
     KBoundaries::FreezeDirichlet(md);
     // This is the first sync if there is no B field
     KHARMADriver::SyncAllBounds(md);
+    // Fill any cached four-vectors for the first step's sources, see GRMHD::FillFourVectors
+    GRMHD::FillFourVectors(md.get());
+
+    if (fast_restart) CheckRestartState(md);
+    if (has_b_field) print_divb();
 }
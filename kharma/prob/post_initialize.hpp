@@ -56,6 +56,7 @@ void SeedAndNormalizeB(ParameterInput *pin, std::shared_ptr<MeshData<Real>> md);
  * 3. Any ad-hoc additions to fluid state, e.g. add hotspots etc.
  * 4. On restarts, reset any per-run parameters
  * 5. Clean up B field divergence if resizing the grid
+ * Exact restarts instead skip any cleanup, and only check the restored state after the final sync (restart/fast)
  */
 void PostInitialize(ParameterInput *pin, Mesh *pmesh, bool is_restart);
 
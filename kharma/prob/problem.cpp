@@ -41,6 +41,7 @@
 #include "gr_coordinates.hpp"
 #include "grmhd.hpp"
 #include "grmhd_functions.hpp"
+#include "inverter.hpp"
 #include "perturbation.hpp"
 #include "types.hpp"
 
@@ -50,6 +51,7 @@
 #include "fm_torus.hpp"
 #include "resize_restart.hpp"
 #include "resize_restart_kharma.hpp"
+#include "checkpoint.hpp"
 #include "kelvin_helmholtz.hpp"
 #include "bz_monopole.hpp"
 #include "mhdmodes.hpp"
@@ -69,18 +71,50 @@
 
 using namespace parthenon;
 
-void KHARMA::ProblemGenerator(MeshBlock *pmb, ParameterInput *pin)
+// If we're not restarting, do any grooming of the initial conditions
+static void GroomInitialConditions(std::shared_ptr<MeshBlockData<Real>> &rc, ParameterInput *pin, const std::string &prob)
+{
+    auto pmb = rc->GetBlockPointer();
+    if ((prob != "resize_restart") && (prob != "resize_restart_kharma") && (prob != "checkpoint")) { //Hyerin
+        // Perturb the internal energy a bit to encourage accretion
+        // Note this defaults to zero & is basically turned on only for torii
+        if (pin->GetOrAddReal("perturbation", "u_jitter", 0.0) > 0.0) {
+            PerturbU(rc, pin);
+        }
+
+        // Initialize electron entropies to defaults if enabled
+        if (pmb->packages.AllPackages().count("Electrons")) {
+            Electrons::InitElectrons(rc, pin);
+        }
+
+        if (pmb->packages.AllPackages().count("EMHD")) {
+            EMHD::InitEMHDVariables(rc, pin);
+        }
+
+        // Initialize the entropy kept for the inverter's backup inversion, if enabled
+        if (pmb->packages.AllPackages().count("Inverter")) {
+            Inverter::InitEntropy(rc.get());
+        }
+    }
+}
+
+// Also just print this, it's important
+static void PrintProblemMessage(const std::string &prob)
 {
-    auto rc = pmb->meshblock_data.Get();
-    auto prob = pin->GetString("parthenon/job", "problem_id"); // Required parameter
-    Flag("ProblemGenerator_"+prob);
-    // Also just print this, it's important
     if (MPIRank0()) {
         // We have no way of tracking whether this is the first block we're initializing
         static bool printed_msg = false;
         if (!printed_msg) std::cout << "Initializing problem: " << prob << std::endl;
         printed_msg = true;
     }
+}
+
+void KHARMA::ProblemGenerator(MeshBlock *pmb, ParameterInput *pin)
+{
+    auto rc = pmb->meshblock_data.Get();
+    auto prob = pin->GetString("parthenon/job", "problem_id"); // Required parameter
+    Flag("ProblemGenerator_", prob);
+    PrintProblemMessage(prob);
 
     // Breakout to call the appropriate initialization function,
     // defined in accompanying headers.
@@ -123,6 +157,8 @@ void KHARMA::ProblemGenerator(MeshBlock *pmb, ParameterInput *pin)
         status = ReadIharmRestart(rc, pin);
     } else if (prob == "resize_restart_kharma") {
         status = ReadKharmaRestart(rc, pin);
+    } else if (prob == "checkpoint") {
+        status = Checkpoint::ReadCheckpoint(rc, pin);
     } else if (prob == "gizmo") {
         status = InitializeGIZMO(rc, pin);
     } else if (prob == "vacuum" || prob == "bz_monopole") {
@@ -135,23 +171,7 @@ void KHARMA::ProblemGenerator(MeshBlock *pmb, ParameterInput *pin)
         throw std::invalid_argument("Invalid or incomplete problem: "+prob);
     }
 
-    // If we're not restarting, do any grooming of the initial conditions
-    if ((prob != "resize_restart") && (prob != "resize_restart_kharma")) { //Hyerin
-        // Perturb the internal energy a bit to encourage accretion
-        // Note this defaults to zero & is basically turned on only for torii
-        if (pin->GetOrAddReal("perturbation", "u_jitter", 0.0) > 0.0) {
-            PerturbU(rc, pin);
-        }
-
-        // Initialize electron entropies to defaults if enabled
-        if (pmb->packages.AllPackages().count("Electrons")) {
-            Electrons::InitElectrons(rc, pin);
-        }
-
-        if (pmb->packages.AllPackages().count("EMHD")) {
-            EMHD::InitEMHDVariables(rc, pin);
-        }
-    }
+    GroomInitialConditions(rc, pin, prob);
 
     // Floors are NOT automatically applied at this point anymore.
     // If needed, they are applied within the problem-specific call.
@@ -166,3 +186,36 @@ void KHARMA::ProblemGenerator(MeshBlock *pmb, ParameterInput *pin)
 
     EndFlag();
 }
+
+void KHARMA::MeshProblemGenerator(Mesh *pmesh, ParameterInput *pin, MeshData<Real> *md)
+{
+    auto prob = pin->GetString("parthenon/job", "problem_id");
+
+    // Problems with a mesh-level initializer set every block of the partition in one kernel
+    TaskStatus status = TaskStatus::incomplete;
+    if (prob == "torus") {
+        Flag("MeshProblemGenerator_", prob);
+        PrintProblemMessage(prob);
+        status = InitializeFMTorus(md, pin);
+    } else if (prob == "vacuum" || prob == "bz_monopole") {
+        Flag("MeshProblemGenerator_", prob);
+        PrintProblemMessage(prob);
+        status = Floors::ApplyInitialFloors(pin, md, IndexDomain::interior);
+    }
+
+    if (status == TaskStatus::incomplete) {
+        // Everything else is initialized block by block
+        for (int b = 0; b < md->NumBlocks(); b++) {
+            ProblemGenerator(md->GetBlockData(b)->GetBlockPointer().get(), pin);
+        }
+    } else {
+        if (status != TaskStatus::complete) {
+            throw std::invalid_argument("Invalid or incomplete problem: "+prob);
+        }
+        for (int b = 0; b < md->NumBlocks(); b++) {
+            auto rc = md->GetBlockData(b)->GetBlockPointer()->meshblock_data.Get();
+            GroomInitialConditions(rc, pin, prob);
+        }
+        EndFlag();
+    }
+}
@@ -61,4 +61,12 @@ namespace KHARMA {
  */
 void ProblemGenerator(MeshBlock *pmb, ParameterInput *pin);
 
+/**
+ * Generate the initial conditions for all MeshBlocks of a partition.  Called by Parthenon
+ * once per partition, rather than once per block.
+ * Problems with a MeshData initializer (currently the torus and vacuum/bz_monopole) set the
+ * whole partition in one kernel; others call ProblemGenerator on each block.
+ */
+void MeshProblemGenerator(Mesh *pmesh, ParameterInput *pin, MeshData<Real> *md);
+
 }
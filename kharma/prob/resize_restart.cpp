@@ -43,6 +43,8 @@
 #include <sys/stat.h>
 #include <ctype.h>
 
+#include <climits>
+
 // TODO: The iharm3d restart format fails to record several things we must guess:
 // 1. Sometimes, even precise domain boundaries in native coordinates
 // 2. Which coordinate system was used
@@ -58,76 +60,90 @@
 hsize_t static_max(int i, int n) { return static_cast<hsize_t>(m::max(i, n)); }
 hsize_t static_min(int i, int n) { return static_cast<hsize_t>(m::min(i, n)); }
 
+// Everything read from an iharm3d restart's header, plain data so it can be broadcast in one go
+struct IharmRestartHeader {
+    char version[20] = {0};
+    int n1file = 0, n2file = 0, n3file = 0;
+    double x1min = 0., x2min = 0., x3min = 0.;
+    double x1max = 0., x2max = 0., x3max = 0.;
+    double Rin = 0., Rout = 0., a = 0., hslope = 0.;
+    double gam = 0., t = 0., dt = 0., tf = 0.;
+    bool use_native_bounds = false, file_in_spherical = false, has_game = false, known_type = true;
+};
+
 void ReadIharmRestartHeader(std::string fname, ParameterInput *pin)
 {
-    // Read the restart file and set parameters that need to be specified at early loading
-    hdf5_open(fname.c_str());
-
-    // Read everything from root
-    hdf5_set_directory("/");
-    // Print version
-    hid_t string_type = hdf5_make_str_type(20);
-    char version[20];
-    hdf5_read_single_val(version, "version", string_type);
+    // Read the restart file and set parameters that need to be specified at early loading.
+    // Only rank 0 touches the file, then broadcasts the header: collective opens of one small
+    // file from every rank are a large part of startup at scale
+    IharmRestartHeader h;
     if (MPIRank0()) {
-        std::cout << "Initialized from " << fname << ", file version " << version << std::endl << std::endl;
-    }
+        hdf5_open(fname.c_str());
+
+        // Read everything from root
+        hdf5_set_directory("/");
+        // Print version
+        hid_t string_type = hdf5_make_str_type(20);
+        hdf5_read_single_val(h.version, "version", string_type);
+
+        // Read what we need from the file, regardless of where we're putting it
+        hdf5_read_single_val(&h.n1file, "n1", H5T_STD_I32LE);
+        hdf5_read_single_val(&h.n2file, "n2", H5T_STD_I32LE);
+        hdf5_read_single_val(&h.n3file, "n3", H5T_STD_I32LE);
+
+        if (hdf5_exists("x1Min")) {
+            // If available, read domain boundaries exactly.  This is mostly
+            // for re-gridded KHARMA dumps.
+            hdf5_read_single_val(&h.x1min, "x1Min", H5T_IEEE_F64LE);
+            hdf5_read_single_val(&h.x1max, "x1Max", H5T_IEEE_F64LE);
+            hdf5_read_single_val(&h.x2min, "x2Min", H5T_IEEE_F64LE);
+            hdf5_read_single_val(&h.x2max, "x2Max", H5T_IEEE_F64LE);
+            hdf5_read_single_val(&h.x3min, "x3Min", H5T_IEEE_F64LE);
+            hdf5_read_single_val(&h.x3max, "x3Max", H5T_IEEE_F64LE);
+            h.use_native_bounds = true;
+        } else if (hdf5_exists("a")) {
+            // Only read these if the better versions aren't available
+            hdf5_read_single_val(&h.Rin, "Rin", H5T_IEEE_F64LE);
+            hdf5_read_single_val(&h.Rout, "Rout", H5T_IEEE_F64LE);
+        } else {
+            h.known_type = false;
+        }
 
-    // Read what we need from the file, regardless of where we're putting it
-    int n1file, n2file, n3file;
-    hdf5_read_single_val(&n1file, "n1", H5T_STD_I32LE);
-    hdf5_read_single_val(&n2file, "n2", H5T_STD_I32LE);
-    hdf5_read_single_val(&n3file, "n3", H5T_STD_I32LE);
-
-    double x1min, x2min, x3min;
-    double x1max, x2max, x3max;
-    bool use_native_bounds = false;
-    // Spherical for guessing
-    double Rin, Rout;
-    if (hdf5_exists("x1Min")) {
-        // If available, read domain boundaries exactly.  This is mostly
-        // for re-gridded KHARMA dumps.
-        hdf5_read_single_val(&x1min, "x1Min", H5T_IEEE_F64LE);
-        hdf5_read_single_val(&x1max, "x1Max", H5T_IEEE_F64LE);
-        hdf5_read_single_val(&x2min, "x2Min", H5T_IEEE_F64LE);
-        hdf5_read_single_val(&x2max, "x2Max", H5T_IEEE_F64LE);
-        hdf5_read_single_val(&x3min, "x3Min", H5T_IEEE_F64LE);
-        hdf5_read_single_val(&x3max, "x3Max", H5T_IEEE_F64LE);
-        use_native_bounds = true;
-    } else if (hdf5_exists("a")) {
-        // Only read these if the better versions aren't available
-        hdf5_read_single_val(&Rin, "Rin", H5T_IEEE_F64LE);
-        hdf5_read_single_val(&Rout, "Rout", H5T_IEEE_F64LE);
-    } else {
-        throw std::runtime_error("Unknown restart file type!");
-    }
+        // Anything always necessary for spherical coordinates
+        if (hdf5_exists("a")) {
+            hdf5_read_single_val(&h.a, "a", H5T_IEEE_F64LE);
+            hdf5_read_single_val(&h.hslope, "hslope", H5T_IEEE_F64LE);
+            h.file_in_spherical = true;
+        }
 
-    // Anything always necessary for spherical coordinates
-    double a, hslope;
-    bool file_in_spherical = false;
-    if (hdf5_exists("a")) {
-        hdf5_read_single_val(&a, "a", H5T_IEEE_F64LE);
-        hdf5_read_single_val(&hslope, "hslope", H5T_IEEE_F64LE);
-        file_in_spherical = true;
-    }
+        // Anything else
+        hdf5_read_single_val(&h.gam, "gam", H5T_IEEE_F64LE);
+        hdf5_read_single_val(&h.t, "t", H5T_IEEE_F64LE);
+        hdf5_read_single_val(&h.dt, "dt", H5T_IEEE_F64LE);
+        hdf5_read_single_val(&h.tf, "tf", H5T_IEEE_F64LE);
 
-    // Anything else
-    double gam, t, dt, tf;
-    hdf5_read_single_val(&gam, "gam", H5T_IEEE_F64LE);
-    hdf5_read_single_val(&t, "t", H5T_IEEE_F64LE);
-    hdf5_read_single_val(&dt, "dt", H5T_IEEE_F64LE);
-    hdf5_read_single_val(&tf, "tf", H5T_IEEE_F64LE);
-
-    // Set the number of primitive vars
-    // TODO do this better by recording/counting flags in MODEL
-    if(hdf5_exists("game")) {
-        pin->SetInteger("resize_restart", "nfprim", 10);
-    } else {
-        pin->SetInteger("resize_restart", "nfprim", 8);
+        // Set the number of primitive vars
+        // TODO do this better by recording/counting flags in MODEL
+        h.has_game = hdf5_exists("game");
+
+        // End HDF5 reads
+        hdf5_close();
     }
+#ifdef MPI_PARALLEL
+    PARTHENON_MPI_CHECK(MPI_Bcast(&h, sizeof(IharmRestartHeader), MPI_BYTE, 0, MPI_COMM_WORLD));
+#endif
+    if (!h.known_type) throw std::runtime_error("Unknown restart file type!");
+    if (MPIRank0()) {
+        std::cout << "Initialized from " << fname << ", file version " << h.version << std::endl << std::endl;
+    }
+    pin->SetInteger("resize_restart", "nfprim", (h.has_game) ? 10 : 8);
 
-    // End HDF5 reads
-    hdf5_close();
+    const int n1file = h.n1file, n2file = h.n2file, n3file = h.n3file;
+    const double x1min = h.x1min, x2min = h.x2min, x3min = h.x3min;
+    const double x1max = h.x1max, x2max = h.x2max, x3max = h.x3max;
+    const bool use_native_bounds = h.use_native_bounds, file_in_spherical = h.file_in_spherical;
+    const double Rin = h.Rin, Rout = h.Rout, a = h.a, hslope = h.hslope;
+    const double gam = h.gam, t = h.t, dt = h.dt, tf = h.tf;
 
     // Record the parameters of the file grid
     // Note the iharm3d-style naming as mnemonic
@@ -182,7 +198,8 @@ void ReadIharmRestartHeader(std::string fname, ParameterInput *pin)
                 pin->SetReal("coordinates", "r_out", m::exp(x1max));
             }
         } else {
-            std::cout << "Guessing geometry when restarting! This is potentially very bad to do!" << std::endl;
+            if (MPIRank0())
+                std::cout << "Guessing geometry when restarting! This is potentially very bad to do!" << std::endl;
             // NOTE: the reason guessing is bad here has to do with old KHARMA versions:
             // input parameters (even geometry) were only stored to 6-digit precision in old KHARMA.
             // This means that r_in and x3max especially were cut off, and only correct to 6 digits.
@@ -208,7 +225,8 @@ void ReadIharmRestartHeader(std::string fname, ParameterInput *pin)
             pin->SetString("coordinates", "transform", "funky");
         }
     } else {
-        std::cout << "Guessing the restart file is in Cartesian coordinates!" << std::endl;
+        if (MPIRank0())
+            std::cout << "Guessing the restart file is in Cartesian coordinates!" << std::endl;
         // Anything without a BH spin was pretty likely Cartesian
         pin->SetString("coordinates", "base", "cartesian_minkowski");
         pin->SetString("coordinates", "transform", "null");
@@ -230,6 +248,157 @@ void ReadIharmRestartHeader(std::string fname, ParameterInput *pin)
     }
 }
 
+// Blocks on this rank initialized so far.  All are filled when the first is.
+static int iharm_nblocks_done = 0;
+
+/**
+ * Read file zones gs..ge (global indices, inclusive, per X1..X3) into buf, dimensioned
+ * nm = {nprim, n1, n2, n3} with X1 fastest.  Zones past the file's edges are read from the
+ * opposite edge where the mesh is periodic, and left blank otherwise.
+ * Every read is made on every rank, empty where not needed (or if empty is set),
+ * so that collective reads stay matched.
+ */
+static void ReadIharmZones(double *buf, const hsize_t ntot[GR_DIM], const int nm[GR_DIM],
+                           const int gs[GR_DIM], const int ge[GR_DIM], const bool periodic[BOUNDARY_NFACES], const bool empty)
+{
+    // File arrays are ordered {prim, X3, X2, X1}
+    hsize_t fdims[4] = {ntot[0], ntot[3], ntot[2], ntot[1]};
+    hsize_t mdims[4] = {(hsize_t) nm[0], (hsize_t) nm[3], (hsize_t) nm[2], (hsize_t) nm[1]};
+    const int fgs[4] = {0, gs[3], gs[2], gs[1]};
+    const int fge[4] = {nm[0] - 1, ge[3], ge[2], ge[1]};
+    const BoundaryFace inner[4] = {BoundaryFace::undef, BoundaryFace::inner_x3, BoundaryFace::inner_x2, BoundaryFace::inner_x1};
+    const BoundaryFace outer[4] = {BoundaryFace::undef, BoundaryFace::outer_x3, BoundaryFace::outer_x2, BoundaryFace::outer_x1};
+
+    // Truncate the file read sizes so we don't overrun the file data
+    hsize_t fstart[4], fcount[4], mstart[4];
+    for (int d = 0; d < 4; d++) {
+        fstart[d] = static_max(fgs[d], 0);
+        // Test gXe against last valid index, i.e. nXtot-1
+        const int fstop = m::min(fge[d], (int) fdims[d] - 1);
+        // We add one here to get sizes from indices
+        fcount[d] = static_max(fstop - (int) fstart[d] + 1, 0);
+        // If we overran an index on the left, we need to leave blank rows (i.e., start at 1 for index -1) to reflect this
+        mstart[d] = fstart[d] - fgs[d];
+    }
+    if (empty) fcount[0] = 0;
+
+    // Read the main array
+    hdf5_read_array(buf, "p", 4, fdims, fstart, fcount, mdims, mstart, H5T_IEEE_F64LE);
+
+    // Do some special reads from elsewhere in the file to fill periodic bounds
+    // Note we do NOT fill outflow/reflecting bounds here -- instead, we treat them specially below
+    hsize_t fstart_tmp[4], fcount_tmp[4], mstart_tmp[4];
+    for (int d = 1; d < 4; d++) {
+        for (int side = 0; side < 2; side++) {
+            DLOOP1 {fstart_tmp[mu] = fstart[mu]; fcount_tmp[mu] = fcount[mu]; mstart_tmp[mu] = mstart[mu];}
+            if (side == 0) {
+                // same other indices, but take only the globally LAST rank in this direction...
+                fstart_tmp[d] = fdims[d] - 1;
+                fcount_tmp[d] = (fgs[d] < 0 && periodic[inner[d]]);
+                // ...and read it to the rank of our array at global index -1
+                mstart_tmp[d] = static_max(-1 - fgs[d], 0);
+            } else {
+                // Likewise the globally FIRST rank, to our rank at global index n
+                fstart_tmp[d] = 0;
+                fcount_tmp[d] = (fge[d] > (int) fdims[d] - 1 && periodic[outer[d]]);
+                mstart_tmp[d] = static_min((int) fdims[d] - fgs[d], (int) mdims[d] - 1);
+            }
+            hdf5_read_array(buf, "p", 4, fdims, fstart_tmp, fcount_tmp, mdims, mstart_tmp, H5T_IEEE_F64LE);
+        }
+    }
+}
+
+/**
+ * Interpolate into the zones of a block whose first file zone in X3 lies in [own_ks, own_ke],
+ * from cache(p, mk, mj, mi) holding file zones gs..ge.
+ */
+static void InterpolateIharmBlock(MeshBlock *pmb, const ParArray4D<Real>& cache,
+                                  const int gs_in[GR_DIM], const int ge_in[GR_DIM], const hsize_t ntot[GR_DIM],
+                                  const GReal startx_in[GR_DIM], const GReal dx_in[GR_DIM],
+                                  const int interp_type, const bool is_spherical, const int own_ks, const int own_ke)
+{
+    auto rc = pmb->meshblock_data.Get();
+    const IndexRange ib = pmb->cellbounds.GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = pmb->cellbounds.GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = pmb->cellbounds.GetBoundsK(IndexDomain::interior);
+    const auto& G = pmb->coords;
+    const CoordinateEmbedding coords = G.coords;
+
+    // Get the arrays we'll be writing to
+    // TODO this is probably easier AND more flexible if we pack them
+    GridScalar rho = rc->Get("prims.rho").data;
+    GridScalar u = rc->Get("prims.u").data;
+    GridVector uvec = rc->Get("prims.uvec").data;
+    GridVector B_P = rc->Get("prims.B").data;
+
+    // TODO real boundary flags. Repeat on any outflow/reflecting bounds
+    const bool repeat_x1i = is_spherical;
+    const bool repeat_x1o = is_spherical;
+    const bool repeat_x2i = is_spherical;
+    const bool repeat_x2o = is_spherical;
+    // Copies for the kernel
+    const GReal startx[GR_DIM] = {startx_in[0], startx_in[1], startx_in[2], startx_in[3]};
+    const GReal dx[GR_DIM] = {dx_in[0], dx_in[1], dx_in[2], dx_in[3]};
+    const int gs[GR_DIM] = {0, gs_in[1], gs_in[2], gs_in[3]};
+    // The valid file zones within the cache
+    const int glo[GR_DIM] = {0, m::max(gs[1], 0), m::max(gs[2], 0), m::max(gs[3], 0)};
+    const int ghi[GR_DIM] = {0, m::min(ge_in[1], (int) ntot[1] - 1),
+                                m::min(ge_in[2], (int) ntot[2] - 1),
+                                m::min(ge_in[3], (int) ntot[3] - 1)};
+    const int n1 = ntot[1], n2 = ntot[2];
+    const int mn1 = ge_in[1] - gs[1] + 1, mn2 = ge_in[2] - gs[2] + 1, mn3 = ge_in[3] - gs[3] + 1;
+
+    // Interpolate on the device from the cache
+    // Nearest-neighbor interpolation is currently only used when grids exactly correspond -- otherwise, linear or
+    // conservative interpolation is used to minimize the resulting B field divergence.
+    pmb->par_for("resize_restart_interp", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
+            // rho, u, uvec, B
+            Real vals[8];
+            if (interp_type == 0) {
+                GReal X[GR_DIM]; int gk, gj, gi;
+                G.coord(k, j, i, Loci::center, X);
+                Interpolation::Xtoijk_nearest(X, startx, dx, gi, gj, gk);
+                if (gk < own_ks || gk > own_ke) return;
+                // TODO verify this never reads zones outside the cache
+                // Calculate indices inside our cached block
+                const int mk = gk - gs[3], mj = gj - gs[2], mi = gi - gs[1];
+                // Fill cells of the new block with equivalents in the cached block
+                for (int p = 0; p < 8; p++) vals[p] = cache(p, mk, mj, mi);
+            } else if (interp_type == 1) {
+                GReal X[GR_DIM], del[GR_DIM]; int gk, gj, gi;
+                // Get the zone center location
+                G.coord(k, j, i, Loci::center, X);
+                // Get global indices
+                Interpolation::Xtoijk(X, startx, dx, gi, gj, gk, del);
+                if (gk < own_ks || gk > own_ke) return;
+                // Make any corrections due to global boundaries
+                // Currently just repeats the last zone, equivalent to falling back to nearest-neighbor
+                if (repeat_x1i && gi < 0) { gi = 0; del[1] = 0; }
+                if (repeat_x1o && gi > n1-2) { gi = n1 - 2; del[1] = 1; }
+                if (repeat_x2i && gj < 0) { gj = 0; del[2] = 0; }
+                if (repeat_x2o && gj > n2-2) { gj = n2 - 2; del[2] = 1; }
+                // Calculate indices inside our cached block
+                const int mk = gk - gs[3], mj = gj - gs[2], mi = gi - gs[1];
+                // Interpolate the value at this location from the cached grid
+                for (int p = 0; p < 8; p++)
+                    vals[p] = Interpolation::linear(mi, mj, mk, mn1, mn2, mn3, del, cache, p);
+            } else {
+                GReal Xl[GR_DIM], Xr[GR_DIM];
+                G.coord(k, j, i, Loci::corner, Xl);
+                G.coord(k + 1, j + 1, i + 1, Loci::corner, Xr);
+                const int gk = (int) m::floor((Xl[3] - startx[3]) / dx[3]);
+                if (gk < own_ks || gk > own_ke) return;
+                Interpolation::conservative(coords, Xl, Xr, startx, dx, gs, glo, ghi, cache, 8, vals);
+            }
+            rho(k, j, i) = vals[0];
+            u(k, j, i)   = vals[1];
+            VLOOP uvec(v, k, j, i) = vals[2+v];
+            VLOOP B_P(v, k, j, i) = vals[5+v];
+        }
+    );
+}
+
 TaskStatus ReadIharmRestart(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterInput *pin)
 {
     auto pmb = rc->GetBlockPointer();
@@ -237,6 +406,21 @@ TaskStatus ReadIharmRestart(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterI
     const auto fname = pin->GetString("resize_restart", "fname"); // Require this, don't guess
     const bool regrid_only = pin->GetOrAddBoolean("resize_restart", "regrid_only", false);
     const bool is_spherical = pin->GetBoolean("coordinates", "spherical");
+    // I/O tuning for large files: collective MPI-IO reads, with hints for the MPI-IO layer.
+    // Hints of 0 are left to the MPI implementation's defaults
+    const bool use_mpiio = pin->GetOrAddBoolean("resize_restart", "mpiio", true);
+    const int cb_nodes = pin->GetOrAddInteger("resize_restart", "cb_nodes", 0);
+    const int striping_factor = pin->GetOrAddInteger("resize_restart", "striping_factor", 0);
+    const int striping_unit = pin->GetOrAddInteger("resize_restart", "striping_unit", 0);
+    const bool align_reads = pin->GetOrAddBoolean("resize_restart", "align_reads", false);
+    // Interpolation from the file grid: nearest-neighbor (only sensible when grids correspond exactly),
+    // linear, or conservative (gdet-volume-weighted averages over each new zone)
+    const std::string interp = pin->GetOrAddString("resize_restart", "interp", (regrid_only) ? "nearest" : "linear");
+    // Read the file in slabs of this many X3 zones, to bound memory use.  0 reads everything at once
+    const int slab_nk = pin->GetOrAddInteger("resize_restart", "slab_nk", 0);
+    if (interp != "nearest" && interp != "linear" && interp != "conservative")
+        throw std::invalid_argument("Unknown resize_restart interpolation: "+interp);
+    const int interp_type = (interp == "nearest") ? 0 : ((interp == "linear") ? 1 : 2);
 
     // Size/domain of the file we're reading *from*.
     const hsize_t nfprim = pin->GetInteger("resize_restart", "nfprim");
@@ -286,209 +470,142 @@ TaskStatus ReadIharmRestart(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterI
         }
     }
 
-    if(MPIRank0()) std::cout << "Reading mesh from file to cache..." << std::endl;
+    // Total file size
+    // TODO separate nmprim to stop at 8 prims if we don't need e-
+    const hsize_t ntot[GR_DIM] = {nfprim, n1tot, n2tot, n3tot};
 
     // In this section we're dealing with two different meshes: the one we're interpolating *from* (the "file" grid)
     // and the one we're interpolating *to* -- the "meshblock."
     // Additionally, in the "file" mesh we must deail with global file locations (no ghost zones, global index, prefixed "g")
     // as well as local file locations (locations in a cache we read to host memory, prefixed "m")
 
-    // Size/domain of the MeshBlock we're reading *to*.
+    // Size/domain of the MeshBlocks we're reading *to*.
     // Note that we only fill the block's physical zones --
     // PostInitialize will take care of ghosts with MPI syncs and calls to the domain boundary conditions
     IndexDomain domain = IndexDomain::interior;
     const IndexRange ib = pmb->cellbounds.GetBoundsI(domain);
     const IndexRange jb = pmb->cellbounds.GetBoundsJ(domain);
     const IndexRange kb = pmb->cellbounds.GetBoundsK(domain);
-    const auto& G = pmb->coords;
 
-    // Total file size
-    // TODO separate nmprim to stop at 8 prims if we don't need e-
-    hsize_t fdims[] = {nfprim, n3tot, n2tot, n1tot};
-
-    // Figure out the subset in global space corresponding to our memory cache
-    int gis, gjs, gks, gie, gje, gke;
-    if (regrid_only) {
-        // For nearest neighbor "interpolation," we don't need any ghost zones
-        // Global location of first zone of our new grid
-        double X[GR_DIM];
-        G.coord(kb.s, jb.s, ib.s, Loci::center, X);
-        // Global file coordinate corresponding to that location
-        Interpolation::Xtoijk_nearest(X, startx, dx, gis, gjs, gks);
-        // Same for the end
-        G.coord(kb.e, jb.e, ib.e, Loci::center, X);
-        Interpolation::Xtoijk_nearest(X, startx, dx, gie, gje, gke);
-    } else {
-        // Linear interpolation case: we need ghost zones
-        // Global location of first zone of our new grid
-        double tmp[GR_DIM], X[GR_DIM];
-        G.coord(kb.s, jb.s, ib.s, Loci::center, X);
-        // Global file coordinate corresponding to that location
-        // Note this will be the *left* side already, so we'll never read below this.
-        // The values gis,gjs,gks can/will be -1 sometimes
-        Interpolation::Xtoijk(X, startx, dx, gis, gjs, gks, tmp);
-        // Same for the end
-        G.coord(kb.e, jb.e, ib.e, Loci::center, X);
-        Interpolation::Xtoijk(X, startx, dx, gie, gje, gke, tmp);
-        // Include one extra zone in each direction, for right side of linear interp
-        gke += 1; gje += 1; gie += 1;
-    }
-
-    // Truncate the file read sizes so we don't overrun the file data
-    hsize_t fstart[4] = {0, static_max(gks, 0), static_max(gjs, 0), static_max(gis, 0)};
-    // Test gXe against last valid index, i.e. nXtot-1
-    hsize_t fstop[4] = {nfprim-1, static_min(gke, n3tot-1), static_min(gje, n2tot-1), static_min(gie, n1tot-1)};
-    // We add one here to get sizes from indices
-    hsize_t fcount[4] = {fstop[0] - fstart[0] + 1,
-                         fstop[1] - fstart[1] + 1,
-                         fstop[2] - fstart[2] + 1,
-                         fstop[3] - fstart[3] + 1};
-    // If we overran an index on the left, we need to leave a blank row (i.e., start at 1 == true) to reflect this
-    hsize_t mstart[4] = {0, (gks < 0), (gjs < 0), (gis < 0)};
-    // Total memory size is never truncated
-    // This calculation produces XxYx2 arrays for 2D sims w/linear interp but that's fine
-    hsize_t nmk = gke-gks+1, nmj = gje-gjs+1, nmi = gie-gis+1;
-    hsize_t mdims[4] = {nfprim, nmk, nmj, nmi};
-    // TODO these should be const but hdf5_read_array yells about it, fix that
-    // TODO should yell if any of these fired for nearest-neighbor
-
-    // Allocate the array we'll need
-    hsize_t nmblock = nmk * nmj * nmi;
-    // TODO this may be float[] if we ever want to read dump files as restarts
-    double *ptmp = new double[nfprim*nmblock];
-
-    // Open the file
-    hdf5_open(fname.c_str());
-    hdf5_set_directory("/");
-
-    // Read the main array
-    hdf5_read_array(ptmp, "p", 4, fdims, fstart, fcount, mdims, mstart, H5T_IEEE_F64LE);
-
-    // Do some special reads from elsewhere in the file to fill periodic bounds
-    // Note we do NOT fill outflow/reflecting bounds here -- instead, we treat them specially below
-    // TODO this could probably be a lot cleaner
-    hsize_t fstart_tmp[4], fcount_tmp[4], mstart_tmp[4];
-#define RESET_COUNTS DLOOP1 {fstart_tmp[mu] = fstart[mu]; fcount_tmp[mu] = fcount[mu]; mstart_tmp[mu] = mstart[mu];}
-    if (gks < 0 && pmb->boundary_flag[BoundaryFace::inner_x3] == BoundaryFlag::periodic) {
-        RESET_COUNTS
-        // same X1/X2, but take only the globally LAST rank in X3
-        fstart_tmp[1] = n3tot-1;
-        fcount_tmp[1] = 1;
-        // Read it to the FIRST rank of our array
-        mstart_tmp[1] = 0;
-        hdf5_read_array(ptmp, "p", 4, fdims, fstart_tmp, fcount_tmp, mdims, mstart_tmp, H5T_IEEE_F64LE);
-    }
-    if (gke > n3tot-1 && pmb->boundary_flag[BoundaryFace::outer_x3] == BoundaryFlag::periodic) {
-        RESET_COUNTS
-        // same X1/X2, but take only the globally FIRST rank in X3
-        fstart_tmp[1] = 0;
-        fcount_tmp[1] = 1;
-        // Read it to the LAST rank of our array
-        mstart_tmp[1] = mdims[1]-1;
-        hdf5_read_array(ptmp, "p", 4, fdims, fstart_tmp, fcount_tmp, mdims, mstart_tmp, H5T_IEEE_F64LE);
-    }
-    if (gjs < 0 && pmb->boundary_flag[BoundaryFace::inner_x2] == BoundaryFlag::periodic) {
-        RESET_COUNTS
-        fstart_tmp[2] = n2tot-1;
-        fcount_tmp[2] = 1;
-        mstart_tmp[2] = 0;
-        hdf5_read_array(ptmp, "p", 4, fdims, fstart_tmp, fcount_tmp, mdims, mstart_tmp, H5T_IEEE_F64LE);
-    }
-    if (gje > n2tot-1 && pmb->boundary_flag[BoundaryFace::outer_x2] == BoundaryFlag::periodic) {
-        RESET_COUNTS
-        fstart_tmp[2] = 0;
-        fcount_tmp[2] = 1;
-        mstart_tmp[2] = mdims[2]-1;
-        hdf5_read_array(ptmp, "p", 4, fdims, fstart_tmp, fcount_tmp, mdims, mstart_tmp, H5T_IEEE_F64LE);
-    }
-    if (gis < 0 && pmb->boundary_flag[BoundaryFace::inner_x1] == BoundaryFlag::periodic) {
-        RESET_COUNTS
-        fstart_tmp[3] = n1tot-1;
-        fcount_tmp[3] = 1;
-        mstart_tmp[3] = 0;
-        hdf5_read_array(ptmp, "p", 4, fdims, fstart_tmp, fcount_tmp, mdims, mstart_tmp, H5T_IEEE_F64LE);
-    }
-    if (gie > n1tot-1 && pmb->boundary_flag[BoundaryFace::outer_x1] == BoundaryFlag::periodic) {
-        RESET_COUNTS
-        fstart_tmp[3] = 0;
-        fcount_tmp[3] = 1;
-        mstart_tmp[3] = mdims[3]-1;
-        hdf5_read_array(ptmp, "p", 4, fdims, fstart_tmp, fcount_tmp, mdims, mstart_tmp, H5T_IEEE_F64LE);
-    }
+    // The file is read and interpolated into all of this rank's blocks when the first is initialized
+    auto& block_list = pmb->pmy_mesh->block_list;
+    if (iharm_nblocks_done++ == 0) {
+        if(MPIRank0()) std::cout << "Reading mesh from file to cache..." << std::endl;
+
+        // Figure out the subset in global space corresponding to our memory cache:
+        // the union of the file zones needed by each of our blocks
+        int gs[GR_DIM] = {0, INT_MAX, INT_MAX, INT_MAX}, ge[GR_DIM] = {0, INT_MIN, INT_MIN, INT_MIN};
+        bool periodic[BOUNDARY_NFACES] = {false};
+        GReal max_dx3 = 0.;
+        for (auto &pmb_local : block_list) {
+            const auto& G_local = pmb_local->coords;
+            int bis, bjs, bks, bie, bje, bke;
+            if (interp_type == 0) {
+                // For nearest neighbor "interpolation," we don't need any ghost zones
+                // Global location of first zone of our new grid
+                double X[GR_DIM];
+                G_local.coord(kb.s, jb.s, ib.s, Loci::center, X);
+                // Global file coordinate corresponding to that location
+                Interpolation::Xtoijk_nearest(X, startx, dx, bis, bjs, bks);
+                // Same for the end
+                G_local.coord(kb.e, jb.e, ib.e, Loci::center, X);
+                Interpolation::Xtoijk_nearest(X, startx, dx, bie, bje, bke);
+            } else {
+                // Linear interpolation case: we need ghost zones
+                // Global location of first zone of our new grid
+                double tmp[GR_DIM], X[GR_DIM];
+                G_local.coord(kb.s, jb.s, ib.s, Loci::center, X);
+                // Global file coordinate corresponding to that location
+                // Note this will be the *left* side already, so we'll never read below this.
+                // The values gis,gjs,gks can/will be -1 sometimes
+                Interpolation::Xtoijk(X, startx, dx, bis, bjs, bks, tmp);
+                // Same for the end
+                G_local.coord(kb.e, jb.e, ib.e, Loci::center, X);
+                Interpolation::Xtoijk(X, startx, dx, bie, bje, bke, tmp);
+                // Include one extra zone in each direction, for right side of linear interp
+                bke += 1; bje += 1; bie += 1;
+                // Conservative remapping needs every zone overlapping our zones, corner to corner
+                if (interp_type == 2) {
+                    double X2[GR_DIM];
+                    G_local.coord(kb.s, jb.s, ib.s, Loci::corner, X);
+                    Interpolation::Xtoijk_nearest(X, startx, dx, bis, bjs, bks);
+                    G_local.coord(kb.e + 1, jb.e + 1, ib.e + 1, Loci::corner, X2);
+                    Interpolation::Xtoijk_nearest(X2, startx, dx, bie, bje, bke);
+                    bis -= 1; bjs -= 1; bks -= 1;
+                }
+            }
+            gs[1] = m::min(gs[1], bis); gs[2] = m::min(gs[2], bjs); gs[3] = m::min(gs[3], bks);
+            ge[1] = m::max(ge[1], bie); ge[2] = m::max(ge[2], bje); ge[3] = m::max(ge[3], bke);
+            for (int f = 0; f < BOUNDARY_NFACES; f++)
+                periodic[f] = periodic[f] || pmb_local->boundary_flag[f] == BoundaryFlag::periodic;
+            max_dx3 = m::max(max_dx3, G_local.Dxc<3>(kb.s));
+        }
+        // Optionally read whole X1 rows, so each rank's reads are long contiguous runs of the file
+        if (align_reads) {
+            gs[1] = m::min(gs[1], 0);
+            ge[1] = m::max(ge[1], (int) n1tot - 1);
+        }
 
-    hdf5_close();
+        // Split the X3 range into slabs of (at most) slab_nk file zones, each read with the extra
+        // zones needed to interpolate into any zone whose first file zone is in the slab.
+        // Destination zones are filled from the slab containing their first file zone.
+        const int nk_all = ge[3] - gs[3] + 1;
+        const int nk_slab = (slab_nk > 0) ? m::min(slab_nk, nk_all) : nk_all;
+        const int halo = (interp_type == 0) ? 0 : ((interp_type == 1) ? 1 : (int) m::ceil(max_dx3 / dx[3]) + 1);
+        int nslabs = (nk_all + nk_slab - 1) / nk_slab;
+        // Collective reads must be matched, so every rank reads as many slabs as the busiest
+#ifdef MPI_PARALLEL
+        if (use_mpiio) MPI_Allreduce(MPI_IN_PLACE, &nslabs, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+        if (MPIRank0() && slab_nk > 0)
+            std::cout << "Streaming file in " << nslabs << " X3 slabs of " << nk_slab << " zones" << std::endl;
+
+        // Open the file, collectively if requested, with any MPI-IO hints
+        hdf5_use_mpio(use_mpiio);
+        if (cb_nodes > 0) hdf5_set_mpio_hint("cb_nodes", std::to_string(cb_nodes).c_str());
+        if (striping_factor > 0) hdf5_set_mpio_hint("striping_factor", std::to_string(striping_factor).c_str());
+        if (striping_unit > 0) hdf5_set_mpio_hint("striping_unit", std::to_string(striping_unit).c_str());
+        hdf5_open(fname.c_str());
+        hdf5_set_directory("/");
+
+        // One buffer on host and device, re-used for each slab
+        const int nm[GR_DIM] = {(int) nfprim, ge[1] - gs[1] + 1, ge[2] - gs[2] + 1, m::min(nk_slab + halo, nk_all)};
+        std::vector<double> buf(nm[0]*nm[1]*nm[2]*nm[3]);
+        ParArray4D<Real> cache("resize_restart_cache", nm[0], nm[3], nm[2], nm[1]);
+        auto cache_host = cache.GetHostMirror();
+
+        for (int s = 0; s < nslabs; s++) {
+            // X3 zones owned by this slab, and read for it
+            const int own_ks = gs[3] + s * nk_slab;
+            const int own_ke = (s == nslabs - 1) ? INT_MAX : own_ks + nk_slab - 1;
+            const bool empty = own_ks > ge[3];
+            int sgs[GR_DIM] = {0, gs[1], gs[2], (empty) ? ge[3] : own_ks};
+            int sge[GR_DIM] = {0, ge[1], ge[2], m::min(sgs[3] + nm[3] - 1, ge[3])};
+
+            ReadIharmZones(buf.data(), ntot, nm, sgs, sge, periodic, empty);
+            if (empty) continue;
+
+            for (int p = 0; p < nm[0]; p++) for (int mk = 0; mk < sge[3] - sgs[3] + 1; mk++)
+                for (int mj = 0; mj < nm[2]; mj++) for (int mi = 0; mi < nm[1]; mi++)
+                    cache_host(p, mk, mj, mi) = buf[((p*nm[3] + mk)*nm[2] + mj)*nm[1] + mi];
+            cache.DeepCopy(cache_host);
+
+            for (auto &pmb_local : block_list) {
+                InterpolateIharmBlock(pmb_local.get(), cache, sgs, sge, ntot, startx, dx,
+                                      interp_type, is_spherical, own_ks, own_ke);
+            }
+        }
 
-    if (MPIRank0()) std::cout << "Read!" << std::endl;
+        hdf5_close();
+        hdf5_use_mpio(0);
+        hdf5_clear_mpio_hints();
+        Kokkos::fence();
 
-    // Get the arrays we'll be writing to
-    // TODO this is probably easier AND more flexible if we pack them
-    GridScalar rho = rc->Get("prims.rho").data;
-    GridScalar u = rc->Get("prims.u").data;
-    GridVector uvec = rc->Get("prims.uvec").data;
-    GridVector B_P = rc->Get("prims.B").data;
-    auto rho_host = rho.GetHostMirror();
-    auto u_host = u.GetHostMirror();
-    auto uvec_host = uvec.GetHostMirror();
-    auto B_host = B_P.GetHostMirror();
-
-    // Interpolate on the host side & copy into the mirror Views
-    // Nearest-neighbor interpolation is currently only used when grids exactly correspond -- otherwise, linear interpolation is used
-    // to minimize the resulting B field divergence.
-    // NOTE: KOKKOS USES < not <=!! Therefore the RangePolicy below will seem like it is too big
-    if (regrid_only) {
-        // TODO Kokkos calls here had problems with CUDA, reintroduce/fix
-        // OpenMP here conflicts with Kokkos parallel in some cases, so we're stuck
-        for (int k=kb.s; k <= kb.e; ++k) for (int j=jb.s; j <= jb.e; ++j) for (int i=ib.s; i <= ib.e; ++i) {
-            GReal X[GR_DIM]; int gk, gj, gi;
-            G.coord(k, j, i, Loci::center, X);
-            Interpolation::Xtoijk_nearest(X, startx, dx, gi, gj, gk);
-            // TODO verify this never reads zones outside the cache
-            // Calculate indices inside our cached block
-            int mk = gk - gks, mj = gj - gjs, mi = gi - gis;
-            // Fill cells of the new block with equivalents in the cached block
-            rho_host(k, j, i) = ptmp[0*nmblock + mk*nmj*nmi + mj*nmi + mi];
-            u_host(k, j, i)   = ptmp[1*nmblock + mk*nmj*nmi + mj*nmi + mi];
-            VLOOP uvec_host(v, k, j, i) = ptmp[(2+v)*nmblock + mk*nmj*nmi + mj*nmi + mi];
-            VLOOP B_host(v, k, j, i) = ptmp[(5+v)*nmblock + mk*nmj*nmi + mj*nmi + mi];
-        }
-    } else {
-        // TODO real boundary flags. Repeat on any outflow/reflecting bounds
-        const bool repeat_x1i = is_spherical;
-        const bool repeat_x1o = is_spherical;
-        const bool repeat_x2i = is_spherical;
-        const bool repeat_x2o = is_spherical;
-
-        for (int k=kb.s; k <= kb.e; ++k) for (int j=jb.s; j <= jb.e; ++j) for (int i=ib.s; i <= ib.e; ++i) {
-            GReal X[GR_DIM], del[GR_DIM]; int gk, gj, gi;
-            // Get the zone center location
-            G.coord(k, j, i, Loci::center, X);
-            // Get global indices
-            Interpolation::Xtoijk(X, startx, dx, gi, gj, gk, del);
-            // Make any corrections due to global boundaries
-            // Currently just repeats the last zone, equivalent to falling back to nearest-neighbor
-            if (repeat_x1i && gi < 0) { gi = 0; del[1] = 0; }
-            if (repeat_x1o && gi > n1tot-2) { gi = n1tot - 2; del[1] = 1; }
-            if (repeat_x2i && gj < 0) { gj = 0; del[2] = 0; }
-            if (repeat_x2o && gj > n2tot-2) { gj = n2tot - 2; del[2] = 1; }
-            // Calculate indices inside our cached block
-            int mk = gk - gks, mj = gj - gjs, mi = gi - gis;
-            // Interpolate the value at this location from the cached grid
-            rho_host(k, j, i) = Interpolation::linear(mi, mj, mk, nmi, nmj, nmk, del, &(ptmp[0*nmblock]));
-            u_host(k, j, i) = Interpolation::linear(mi, mj, mk, nmi, nmj, nmk, del, &(ptmp[1*nmblock]));
-            VLOOP uvec_host(v, k, j, i) = Interpolation::linear(mi, mj, mk, nmi, nmj, nmk, del, &(ptmp[(2+v)*nmblock]));
-            VLOOP B_host(v, k, j, i) = Interpolation::linear(mi, mj, mk, nmi, nmj, nmk, del, &(ptmp[(5+v)*nmblock]));
-        }
+        if (MPIRank0()) std::cout << "Read!" << std::endl;
     }
 
-    // Deep copy to device
-    rho.DeepCopy(rho_host);
-    u.DeepCopy(u_host);
-    uvec.DeepCopy(uvec_host);
-    B_P.DeepCopy(B_host);
-    Kokkos::fence();
-
-    // Delete our cache.  Only we ever used it, so we're safe here.
-    delete[] ptmp;
+    // Reset after the last block on this rank, in case of any later re-initialization
+    if (iharm_nblocks_done == (int) block_list.size()) iharm_nblocks_done = 0;
 
     return TaskStatus::complete;
 }
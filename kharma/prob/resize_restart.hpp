@@ -11,7 +11,10 @@
 void ReadIharmRestartHeader(std::string fname, ParameterInput *pin);
 
 /**
- * Read data from an iharm3d restart file. Does not support >1 meshblock in Parthenon
+ * Read data from an iharm3d restart file.  The zones needed by all of this rank's blocks
+ * are read and interpolated into every block when the first is initialized, with collective
+ * MPI-IO by default (see resize_restart/mpiio, cb_nodes, striping_factor, striping_unit, align_reads).
+ * With resize_restart/slab_nk > 0, the file is streamed through a fixed buffer in X3 slabs.
  * 
  * Returns stop time tf of the original simulation, for e.g. replicating regression tests
  */
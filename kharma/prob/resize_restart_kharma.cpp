@@ -41,6 +41,9 @@
 #include <sys/stat.h>
 #include <ctype.h>
 
+#include <algorithm>
+#include <limits>
+
 // Reads in KHARMA restart file but at a different simulation size
 
 void ReadKharmaRestartHeader(std::string fname, ParameterInput *pin)
@@ -50,12 +53,31 @@ void ReadKharmaRestartHeader(std::string fname, ParameterInput *pin)
 
     // Read input from restart file 
     // (from external/parthenon/src/parthenon_manager.cpp)
-    auto restartReader = std::make_unique<RestartReader>(fname.c_str());
+    // Only rank 0 opens the file, then broadcasts the input deck & times to the others
+    std::string inputString;
+    Real tNow, dt;
+    int ncycle;
+    if (MPIRank0()) {
+        auto restartReader = std::make_unique<RestartReader>(fname.c_str());
+        inputString = restartReader->GetAttr<std::string>("Input", "File");
+        tNow = restartReader->GetAttr<Real>("Info", "Time");
+        dt = restartReader->GetAttr<Real>("Info", "dt");
+        ncycle = restartReader->GetAttr<int>("Info", "NCycle");
+        // File closed here when restartReader falls out of scope
+    }
+#ifdef MPI_PARALLEL
+    long input_len = inputString.size();
+    PARTHENON_MPI_CHECK(MPI_Bcast(&input_len, 1, MPI_LONG, 0, MPI_COMM_WORLD));
+    inputString.resize(input_len);
+    PARTHENON_MPI_CHECK(MPI_Bcast(&inputString[0], input_len, MPI_CHAR, 0, MPI_COMM_WORLD));
+    PARTHENON_MPI_CHECK(MPI_Bcast(&tNow, 1, MPI_PARTHENON_REAL, 0, MPI_COMM_WORLD));
+    PARTHENON_MPI_CHECK(MPI_Bcast(&dt, 1, MPI_PARTHENON_REAL, 0, MPI_COMM_WORLD));
+    PARTHENON_MPI_CHECK(MPI_Bcast(&ncycle, 1, MPI_INT, 0, MPI_COMM_WORLD));
+#endif
 
     // Load input stream
     std::unique_ptr<ParameterInput> fpinput;
     fpinput = std::make_unique<ParameterInput>();
-    auto inputString = restartReader->GetAttr<std::string>("Input", "File");
     std::istringstream is(inputString);
     fpinput->LoadFromStream(is);
 
@@ -94,12 +116,9 @@ void ReadKharmaRestartHeader(std::string fname, ParameterInput *pin)
     pin->SetBoolean("parthenon/mesh", "restart_ghostzones", fghostzones);
     pin->SetString("b_field", "type", fBfield); // (12/07/22) Hyerin need to test
 
-    Real gam, tNow, dt, tf;
+    Real gam, tf;
     gam = fpinput->GetReal("GRMHD", "gamma");
-    tNow = restartReader->GetAttr<Real>("Info", "Time");
-    dt = restartReader->GetAttr<Real>("Info", "dt");
     tf = fpinput->GetReal("parthenon/time", "tlim");
-    int ncycle = restartReader->GetAttr<int>("Info", "NCycle");
 
     pin->SetReal("GRMHD", "gamma", gam);
     pin->SetReal("parthenon/time", "start_time", tNow);
@@ -118,10 +137,152 @@ void ReadKharmaRestartHeader(std::string fname, ParameterInput *pin)
         GReal hslope = fpinput->GetReal("coordinates", "hslope");
         pin->SetReal("coordinates", "hslope", hslope);
     }
+}
+
+/**
+ * Source blocks of a KHARMA restart file, read to device.  Only the blocks near
+ * this rank's part of the mesh are kept, so length[0] is the number of blocks read.
+ */
+struct RestartSource {
+    hsize_t length[GR_DIM];
+    GridScalar x1, x2, x3, rho, u;
+    GridVector uvec, B;
+};
+
+/**
+ * Read the source blocks of a restart file which could contain the nearest zone to any point
+ * in [lo, hi] (native coordinates), i.e. those which overlap the box after it is clamped to the
+ * file's domain.  Block 0 is always read, as it's used to fill radii inside the file's domain.
+ * Each field is read in one (collective) hyperslab selection.
+ */
+static RestartSource ReadRestartSource(const std::string& fname, const hsize_t length_all[GR_DIM], const bool include_B,
+                                       const GReal lo[GR_DIM], const GReal hi[GR_DIM], const int verbose)
+{
+    const hsize_t nBlocks = length_all[0];
+
+    hdf5_open(fname.c_str());
+    hdf5_set_directory("/");
+
+    // Coordinates of every block are small, read them all to pick blocks
+    std::vector<std::vector<Real>> x_all(GR_DIM);
+    const char* x_names[GR_DIM] = {"", "VolumeLocations/x", "VolumeLocations/y", "VolumeLocations/z"};
+    for (int d = 1; d < GR_DIM; d++) {
+        x_all[d].resize(nBlocks*length_all[d]);
+        hsize_t fdims_x[] = {nBlocks, length_all[d]};
+        hsize_t fstart_x[] = {0, 0};
+        hdf5_read_array(x_all[d].data(), x_names[d], 2, fdims_x, fstart_x, fdims_x, fdims_x, fstart_x, H5T_IEEE_F64LE);
+    }
+
+    // Clamp the box into the file's domain: points outside take values from its edges
+    GReal clo[GR_DIM], chi[GR_DIM];
+    for (int d = 1; d < GR_DIM; d++) {
+        const auto minmax = std::minmax_element(x_all[d].begin(), x_all[d].end());
+        clo[d] = m::min(m::max(lo[d], *minmax.first), *minmax.second);
+        chi[d] = m::min(m::max(hi[d], *minmax.first), *minmax.second);
+    }
+    std::vector<hsize_t> blocks;
+    for (hsize_t b = 0; b < nBlocks; b++) {
+        bool overlaps = true;
+        for (int d = 1; d < GR_DIM; d++) {
+            const hsize_t n = length_all[d];
+            if (n < 2) continue;
+            const Real xs = x_all[d][b*n], xe = x_all[d][b*n + n - 1];
+            // Nearest zone centers are within a zone of the block
+            const Real dx = (xe - xs) / (n - 1);
+            overlaps = overlaps && (xs - dx <= chi[d]) && (xe + dx >= clo[d]);
+        }
+        if (b == 0 || overlaps) blocks.push_back(b);
+    }
+    const hsize_t nsel = blocks.size();
+
+    RestartSource src;
+    src.length[0] = nsel;
+    for (int d = 1; d < GR_DIM; d++) src.length[d] = length_all[d];
+    const hsize_t* length = src.length;
+    const hsize_t block_sz = length[1]*length[2]*length[3];
+
+    if (verbose > 1) {
+        std::cout << "Rank " << MPIRank() << " reading " << nsel << " of " << nBlocks << " blocks from " << fname << std::endl;
+    }
+
+    src.x1 = GridScalar("x1_f_device", length[0], length[1]);
+    src.x2 = GridScalar("x2_f_device", length[0], length[2]);
+    src.x3 = GridScalar("x3_f_device", length[0], length[3]);
+    src.rho = GridScalar("rho_f_device", length[0], length[3], length[2], length[1]);
+    src.u = GridScalar("u_f_device", length[0], length[3], length[2], length[1]);
+    src.uvec = GridVector("uvec_f_device", NVEC, length[0], length[3], length[2], length[1]);
+    src.B = GridVector("B_f_device", NVEC, length[0], length[3], length[2], length[1]);
+    auto x1_host = src.x1.GetHostMirror();
+    auto x2_host = src.x2.GetHostMirror();
+    auto x3_host = src.x3.GetHostMirror();
+    auto rho_host = src.rho.GetHostMirror();
+    auto u_host = src.u.GetHostMirror();
+    auto uvec_host = src.uvec.GetHostMirror();
+    auto B_host = src.B.GetHostMirror();
+
+    std::vector<Real> rho_file(nsel*block_sz), u_file(nsel*block_sz), uvec_file(NVEC*nsel*block_sz), B_file;
+    hsize_t fdims[] = {nBlocks, length[3], length[2], length[1]};
+    hsize_t fdims_vec[] = {nBlocks, NVEC, length[3], length[2], length[1]};
+    hdf5_read_blocks(rho_file.data(), "prims.rho", 4, fdims, nsel, blocks.data(), H5T_IEEE_F64LE);
+    hdf5_read_blocks(u_file.data(), "prims.u", 4, fdims, nsel, blocks.data(), H5T_IEEE_F64LE);
+    hdf5_read_blocks(uvec_file.data(), "prims.uvec", 5, fdims_vec, nsel, blocks.data(), H5T_IEEE_F64LE);
+    if (include_B) {
+        B_file.resize(NVEC*nsel*block_sz);
+        hdf5_read_blocks(B_file.data(), "cons.B", 5, fdims_vec, nsel, blocks.data(), H5T_IEEE_F64LE);
+    }
+    hdf5_close();
+
+    // save the grid coordinate values to host array
+    for (int iblocktemp = 0; iblocktemp < length[0]; iblocktemp++) {
+        const hsize_t b = blocks[iblocktemp];
+        for (int itemp = 0; itemp < length[1]; itemp++)
+            x1_host(iblocktemp,itemp) = x_all[1][length[1]*b+itemp];
+        for (int jtemp = 0; jtemp < length[2]; jtemp++)
+            x2_host(iblocktemp,jtemp) = x_all[2][length[2]*b+jtemp];
+        for (int ktemp = 0; ktemp < length[3]; ktemp++)
+            x3_host(iblocktemp,ktemp) = x_all[3][length[3]*b+ktemp];
+    }
+    // re-arrange uvec such that it can be read in the VLOOP
+    int vector_file_index, scalar_file_index;
+    for (int iblocktemp = 0; iblocktemp < length[0]; iblocktemp++) {
+        for (int itemp = 0; itemp < length[1]; itemp++) {
+            for (int jtemp = 0; jtemp < length[2]; jtemp++) {
+                for (int ktemp = 0; ktemp < length[3]; ktemp++) {
+                    scalar_file_index = length[1]*(length[2]*(length[3]*iblocktemp+ktemp)+jtemp)+itemp;
+
+                    rho_host(iblocktemp,ktemp,jtemp,itemp) = rho_file[scalar_file_index];
+                    u_host(iblocktemp,ktemp,jtemp,itemp) = u_file[scalar_file_index];
+                    for (int ltemp = 0; ltemp < 3; ltemp++) {
+                        vector_file_index = length[1]*(length[2]*(length[3]*(NVEC*iblocktemp+ltemp)+ktemp)+jtemp)+itemp;
+
+                        uvec_host(ltemp,iblocktemp,ktemp,jtemp,itemp) = uvec_file[vector_file_index];
+                        if (include_B) B_host(ltemp,iblocktemp,ktemp,jtemp,itemp) = B_file[vector_file_index];
+                    }
+                }
+            }
+        }
+    }
+
+    // Deep copy to device
+    src.x1.DeepCopy(x1_host);
+    src.x2.DeepCopy(x2_host);
+    src.x3.DeepCopy(x3_host);
+    src.rho.DeepCopy(rho_host);
+    src.u.DeepCopy(u_host);
+    src.uvec.DeepCopy(uvec_host);
+    if (include_B) src.B.DeepCopy(B_host);
+    Kokkos::fence();
 
-    // File closed here when restartReader falls out of scope
+    return src;
 }
 
+// The restart data read for this rank's blocks, shared between them.
+// Read when the first block is initialized, and freed after the last
+static struct {
+    int nblocks_done = 0;
+    RestartSource file, fill;
+} restart_cache;
+
 TaskStatus ReadKharmaRestart(std::shared_ptr<MeshBlockData<Real>> rc, ParameterInput *pin)
 {
     auto pmb = rc->GetBlockPointer();
@@ -160,144 +321,47 @@ TaskStatus ReadKharmaRestart(std::shared_ptr<MeshBlockData<Real>> rc, ParameterI
     if (!fghostzones) fnghost=0; // reset to 0
     int x3factor=1;
     if (n3tot <= 1) x3factor=0; // if less than 3D, do not add ghosts in x3
-    hsize_t length[GR_DIM] = {nBlocks,
+    hsize_t length_all[GR_DIM] = {nBlocks,
                                 n1mb+2*fnghost,
                                 n2mb+2*fnghost,
-                                n3mb+2*fnghost*x3factor}; 
-    const int block_sz = length[0]*length[1]*length[2]*length[3];
+                                n3mb+2*fnghost*x3factor};
 
-    if (MPIRank0() && verbose > 0) {
+    if (MPIRank0() && verbose > 0 && restart_cache.nblocks_done == 0) {
         std::cout << "Reading mesh size " << n1tot << "x" << n2tot << "x" << n3tot <<
                         " block size " << n1mb << "x" << n2mb << "x" << n3mb << std::endl;
-        std::cout << "Reading " << length[0] << " meshblocks of total size " <<
-                     length[1] << "x" <<  length[2]<< "x" << length[3] << std::endl;
-    }
-    
-    
-    // read from file and stored in device Hyerin (10/18/2022)
-    GridScalar x1_f_device("x1_f_device", length[0], length[1]); 
-    GridScalar x2_f_device("x2_f_device", length[0], length[2]); 
-    GridScalar x3_f_device("x3_f_device", length[0], length[3]); 
-    GridScalar rho_f_device("rho_f_device", length[0], length[3], length[2], length[1]); 
-    GridScalar u_f_device("u_f_device", length[0], length[3], length[2], length[1]); 
-    GridVector uvec_f_device("uvec_f_device", NVEC, length[0], length[3], length[2], length[1]); 
-    GridVector B_f_device("B_f_device", NVEC, length[0], length[3], length[2], length[1]);
-    auto x1_f_host = x1_f_device.GetHostMirror();
-    auto x2_f_host = x2_f_device.GetHostMirror();
-    auto x3_f_host = x3_f_device.GetHostMirror();
-    auto rho_f_host = rho_f_device.GetHostMirror();
-    auto u_f_host = u_f_device.GetHostMirror();
-    auto uvec_f_host = uvec_f_device.GetHostMirror();
-    auto B_f_host = B_f_device.GetHostMirror();
-    // Hyerin (09/19/2022) : new attempt to read the file 
-    hdf5_open(fname.c_str());
-    hdf5_set_directory("/");
-    Real *rho_file = new double[block_sz];
-    Real *u_file = new double[block_sz];
-    Real *uvec_file = new double[NVEC*block_sz];
-    Real *B_file = new double[NVEC*block_sz];
-    Real *x1_file = new double[length[0]*length[1]];
-    Real *x2_file = new double[length[0]*length[2]];
-    Real *x3_file = new double[length[0]*length[3]];
-    //static hsize_t fdims[] = {length[0], 1, length[3], length[2], length[1],1}; //outdated
-    static hsize_t fdims[] = {length[0], length[3], length[2], length[1]};
-    //static hsize_t fdims_vec[] = {length[0], length[3], length[2], length[1],3}; //outdated
-    static hsize_t fdims_vec[] = {length[0], NVEC, length[3], length[2], length[1]};
-    static hsize_t fdims_x1[] = {length[0], length[1]};
-    static hsize_t fdims_x2[] = {length[0], length[2]};
-    static hsize_t fdims_x3[] = {length[0], length[3]};
-    hsize_t fstart[] = {0, 0, 0, 0};
-    hsize_t fstart_vec[] = {0, 0, 0, 0, 0};
-    hsize_t fstart_x[] = {0, 0};
-    hdf5_read_array(rho_file, "prims.rho", 4, fdims, fstart, fdims, fdims, fstart, H5T_IEEE_F64LE);
-    hdf5_read_array(u_file, "prims.u", 4, fdims, fstart, fdims, fdims, fstart, H5T_IEEE_F64LE);
-    hdf5_read_array(uvec_file, "prims.uvec", 5, fdims_vec, fstart_vec, fdims_vec, fdims_vec, fstart_vec, H5T_IEEE_F64LE);
-    //if (include_B) hdf5_read_array(B_file, "prims.B", 5, fdims_vec, fstart_vec, fdims_vec, fdims_vec, fstart_vec, H5T_IEEE_F64LE);
-    if (include_B) hdf5_read_array(B_file, "cons.B", 5, fdims_vec, fstart_vec, fdims_vec, fdims_vec, fstart_vec, H5T_IEEE_F64LE);
-    hdf5_read_array(x1_file, "VolumeLocations/x", 2, fdims_x1, fstart_x, fdims_x1, fdims_x1, fstart_x, H5T_IEEE_F64LE);
-    hdf5_read_array(x2_file, "VolumeLocations/y", 2, fdims_x2, fstart_x, fdims_x2, fdims_x2, fstart_x, H5T_IEEE_F64LE);
-    hdf5_read_array(x3_file, "VolumeLocations/z", 2, fdims_x3, fstart_x, fdims_x3, fdims_x3, fstart_x, H5T_IEEE_F64LE);
-    hdf5_close();
-    
-    GridScalar x1_fill_device("x1_fill_device", length[0], length[1]); 
-    GridScalar x2_fill_device("x2_fill_device", length[0], length[2]); 
-    GridScalar x3_fill_device("x3_fill_device", length[0], length[3]); 
-    GridScalar rho_fill_device("rho_fill_device", length[0], length[3], length[2], length[1]); 
-    GridScalar u_fill_device("u_fill_device", length[0], length[3], length[2], length[1]); 
-    GridVector uvec_fill_device("uvec_fill_device", NVEC, length[0], length[3], length[2], length[1]); 
-    GridVector B_fill_device("B_fill_device", NVEC, length[0], length[3], length[2], length[1]); 
-    auto x1_fill_host = x1_fill_device.GetHostMirror();
-    auto x2_fill_host = x2_fill_device.GetHostMirror();
-    auto x3_fill_host = x3_fill_device.GetHostMirror();
-    auto rho_fill_host = rho_fill_device.GetHostMirror();
-    auto u_fill_host = u_fill_device.GetHostMirror();
-    auto uvec_fill_host = uvec_fill_device.GetHostMirror();
-    auto B_fill_host = B_fill_device.GetHostMirror();
-    Real *rho_filefill = new double[block_sz];
-    Real *u_filefill = new double[block_sz];
-    Real *uvec_filefill = new double[block_sz*NVEC];
-    Real *B_filefill = new double[block_sz*NVEC];
-    Real *x1_filefill = new double[length[0]*length[1]];
-    Real *x2_filefill = new double[length[0]*length[2]];
-    Real *x3_filefill = new double[length[0]*length[3]];
-    if (fname_fill != "none") { // TODO: here I'm assuming fname and fname_fill has same dimensions, which is not always the case.
-        hdf5_open(fname_fill.c_str());
-        hdf5_set_directory("/");
-        hdf5_read_array(rho_filefill, "prims.rho", 4, fdims, fstart, fdims, fdims, fstart, H5T_IEEE_F64LE);
-        hdf5_read_array(u_filefill, "prims.u", 4, fdims, fstart, fdims, fdims, fstart, H5T_IEEE_F64LE);
-        hdf5_read_array(uvec_filefill, "prims.uvec", 5, fdims_vec, fstart_vec, fdims_vec, fdims_vec, fstart_vec, H5T_IEEE_F64LE);
-        //if (include_B) hdf5_read_array(B_filefill, "prims.B", 5, fdims_vec, fstart_vec, fdims_vec, fdims_vec, fstart_vec, H5T_IEEE_F64LE);
-        if (include_B) hdf5_read_array(B_filefill, "cons.B", 5, fdims_vec, fstart_vec, fdims_vec, fdims_vec, fstart_vec,H5T_IEEE_F64LE);
-        hdf5_read_array(x1_filefill, "VolumeLocations/x", 2, fdims_x1, fstart_x, fdims_x1, fdims_x1, fstart_x, H5T_IEEE_F64LE);
-        hdf5_read_array(x2_filefill, "VolumeLocations/y", 2, fdims_x2, fstart_x, fdims_x2, fdims_x2, fstart_x, H5T_IEEE_F64LE);
-        hdf5_read_array(x3_filefill, "VolumeLocations/z", 2, fdims_x3, fstart_x, fdims_x3, fdims_x3, fstart_x, H5T_IEEE_F64LE);
-        hdf5_close();
+        std::cout << "Reading from " << length_all[0] << " meshblocks of total size " <<
+                     length_all[1] << "x" <<  length_all[2]<< "x" << length_all[3] << std::endl;
     }
 
-    // save the grid coordinate values to host array
-    for (int iblocktemp = 0; iblocktemp < length[0]; iblocktemp++) {
-        for (int itemp = 0; itemp < length[1]; itemp++) {
-            x1_f_host(iblocktemp,itemp) = x1_file[length[1]*iblocktemp+itemp];
-            if (fname_fill != "none") x1_fill_host(iblocktemp,itemp) = x1_filefill[length[1]*iblocktemp+itemp];
+    // Read once per rank, only the source blocks near any of this rank's blocks (ghost zones included)
+    auto& block_list = pmb->pmy_mesh->block_list;
+    if (restart_cache.nblocks_done == 0) {
+        GReal lo[GR_DIM], hi[GR_DIM];
+        for (int d = 1; d < GR_DIM; d++) {
+            lo[d] = std::numeric_limits<GReal>::max();
+            hi[d] = std::numeric_limits<GReal>::lowest();
         }
-        for (int jtemp = 0; jtemp < length[2]; jtemp++) {
-            x2_f_host(iblocktemp,jtemp) = x2_file[length[2]*iblocktemp+jtemp];
-            if (fname_fill != "none") x2_fill_host(iblocktemp,jtemp) = x2_filefill[length[2]*iblocktemp+jtemp];
-        }
-        for (int ktemp = 0; ktemp < length[3]; ktemp++) {
-            x3_f_host(iblocktemp,ktemp) = x3_file[length[3]*iblocktemp+ktemp];
-            if (fname_fill != "none") x3_fill_host(iblocktemp,ktemp) = x3_filefill[length[3]*iblocktemp+ktemp];
-        }
-    }
-    // re-arrange uvec such that it can be read in the VLOOP
-    int vector_file_index, scalar_file_index;
-    for (int iblocktemp = 0; iblocktemp < length[0]; iblocktemp++) {
-        for (int itemp = 0; itemp < length[1]; itemp++) {
-            for (int jtemp = 0; jtemp < length[2]; jtemp++) {
-                for (int ktemp = 0; ktemp < length[3]; ktemp++) {
-                    scalar_file_index = length[1]*(length[2]*(length[3]*iblocktemp+ktemp)+jtemp)+itemp;
-
-                    rho_f_host(iblocktemp,ktemp,jtemp,itemp) = rho_file[scalar_file_index];
-                    u_f_host(iblocktemp,ktemp,jtemp,itemp) = u_file[scalar_file_index];
-                    if (fname_fill != "none") {
-                        rho_fill_host(iblocktemp,ktemp,jtemp,itemp) = rho_filefill[scalar_file_index];
-                        u_fill_host(iblocktemp,ktemp,jtemp,itemp) = u_filefill[scalar_file_index];
-                    }
-                    for (int ltemp = 0; ltemp < 3; ltemp++) {
-                        //vector_file_index = 3*(scalar_file_index)+ltemp; // outdated parthenon phdf5 saving order
-                        vector_file_index = length[1]*(length[2]*(length[3]*(NVEC*iblocktemp+ltemp)+ktemp)+jtemp)+itemp;
-                        
-                        uvec_f_host(ltemp,iblocktemp,ktemp,jtemp,itemp) = uvec_file[vector_file_index];
-                        if (include_B) B_f_host(ltemp,iblocktemp,ktemp,jtemp,itemp) = B_file[vector_file_index];
-                        if (fname_fill != "none") {
-                            uvec_fill_host(ltemp,iblocktemp,ktemp,jtemp,itemp) = uvec_filefill[vector_file_index];
-                            if (include_B) B_fill_host(ltemp,iblocktemp,ktemp,jtemp,itemp) = B_filefill[vector_file_index];
-                        }
-                    }
-                }
+        for (auto &pmb_local : block_list) {
+            const auto& bs = pmb_local->block_size;
+            for (int d = 1; d < GR_DIM; d++) {
+                const GReal dx = (bs.xmax((CoordinateDirection) d) - bs.xmin((CoordinateDirection) d)) / bs.nx((CoordinateDirection) d);
+                const int ng = (bs.nx((CoordinateDirection) d) > 1) ? Globals::nghost : 0;
+                lo[d] = m::min(lo[d], bs.xmin((CoordinateDirection) d) - ng*dx);
+                hi[d] = m::max(hi[d], bs.xmax((CoordinateDirection) d) + ng*dx);
             }
         }
+        restart_cache.file = ReadRestartSource(fname, length_all, include_B, lo, hi, verbose);
+        // TODO: here I'm assuming fname and fname_fill has same dimensions, which is not always the case.
+        if (should_fill) restart_cache.fill = ReadRestartSource(fname_fill, length_all, include_B, lo, hi, verbose);
     }
+    const RestartSource& file = restart_cache.file;
+    const RestartSource& fill = restart_cache.fill;
+    const hsize_t length[GR_DIM] = {file.length[0], file.length[1], file.length[2], file.length[3]};
+    const hsize_t length_fill[GR_DIM] = {(should_fill) ? fill.length[0] : 0, length[1], length[2], length[3]};
+    auto x1_f_device = file.x1, x2_f_device = file.x2, x3_f_device = file.x3, rho_f_device = file.rho, u_f_device = file.u;
+    auto uvec_f_device = file.uvec, B_f_device = file.B;
+    auto x1_fill_device = fill.x1, x2_fill_device = fill.x2, x3_fill_device = fill.x3, rho_fill_device = fill.rho, u_fill_device = fill.u;
+    auto uvec_fill_device = fill.uvec, B_fill_device = fill.B;
 
     const Real gam = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
 
@@ -342,13 +406,13 @@ TaskStatus ReadKharmaRestart(std::shared_ptr<MeshBlockData<Real>> rc, ParameterI
     pmb->par_for("copy_restart_state_kharma", ks, ke, js, je, is, ie,
         KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
             get_prim_restart_kharma(G, coords, P, m_p,
-                fx1min, fx1max, fnghost, should_fill, is_spherical, include_B, gam, rs, mdot, length,
+                fx1min, fx1max, fnghost, should_fill, is_spherical, include_B, gam, rs, mdot, length, length_fill,
                 x1_f_device, x2_f_device, x3_f_device, rho_f_device, u_f_device, uvec_f_device, B_f_device,
                 x1_fill_device, x2_fill_device, x3_fill_device, rho_fill_device, u_fill_device, uvec_fill_device, B_fill_device,
                 k, j, i);
             if (include_B) {
                 get_B_restart_kharma(G, U, m_u,
-                    fx1min, fx1max, should_fill, length,
+                    fx1min, fx1max, should_fill, length, length_fill,
                     x1_f_device, x2_f_device, x3_f_device, B_f_device,
                     x1_fill_device, x2_fill_device, x3_fill_device, B_fill_device,
                     k, j, i);
@@ -359,5 +423,13 @@ TaskStatus ReadKharmaRestart(std::shared_ptr<MeshBlockData<Real>> rc, ParameterI
     Flux::BlockPtoUMHD(rc.get(), IndexDomain::entire, false);
     B_FluxCT::BlockUtoP(rc.get(), IndexDomain::entire, false);
 
+    // Free the source data after the last block, rather than at exit after Kokkos has finalized
+    if (++restart_cache.nblocks_done == (int) block_list.size()) {
+        Kokkos::fence();
+        restart_cache.file = RestartSource();
+        restart_cache.fill = RestartSource();
+        restart_cache.nblocks_done = 0;
+    }
+
     return TaskStatus::complete;
 }
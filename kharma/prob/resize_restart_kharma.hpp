@@ -16,7 +16,8 @@
 void ReadKharmaRestartHeader(std::string fname, ParameterInput *pin);
 
 /**
- * Read data from an KHARMA restart file. Does not support >1 meshblock in Parthenon
+ * Read data from an KHARMA restart file.  The file is read once per rank, when the first
+ * block is initialized, and only source blocks near this rank's blocks are kept.
  * 
  * Returns stop time tf of the original simulation, for e.g. replicating regression tests
  */
@@ -76,7 +77,7 @@ KOKKOS_INLINE_FUNCTION void Xtoindex(const GReal XG[GR_DIM],
 
 KOKKOS_INLINE_FUNCTION void get_prim_restart_kharma(const GRCoordinates& G, const CoordinateEmbedding& coords, const VariablePack<Real>& P, const VarMap& m_p,
                     const Real fx1min, const Real fx1max, const Real fnghost, const bool should_fill, const bool is_spherical, const bool include_B,
-                    const Real gam, const Real rs,  const Real mdot, const hsize_t length[GR_DIM],
+                    const Real gam, const Real rs,  const Real mdot, const hsize_t length[GR_DIM], const hsize_t length_fill[GR_DIM],
                     const GridScalar& x1, const GridScalar& x2, const GridScalar& x3, const GridScalar& rho_file, const GridScalar& u_file, const GridVector& uvec_file, const GridVector& B_file,
                     const GridScalar& x1_fill, const GridScalar& x2_fill, const GridScalar& x3_fill, const GridScalar& rho_fill, const GridScalar& u_fill, const GridVector& uvec_fill, const GridVector& B_fill,
                     const int& k, const int& j, const int& i) 
@@ -130,7 +131,7 @@ KOKKOS_INLINE_FUNCTION void get_prim_restart_kharma(const GRCoordinates& G, cons
     // HyerinTODO: if fname_fill exists and smaller.
     else if ((should_fill) && ((X[1]>fx1max)||(X[1]<fx1min))) { // fill with the fname_fill
         //Xtoindex(X, &(x1_fill[0]), &(x2_fill[0]), &(x3_fill[0]), length, iblocktemp, itemp, jtemp, ktemp, del);
-        Xtoindex(X, x1_fill, x2_fill, x3_fill, length, iblocktemp, itemp, jtemp, ktemp, del);
+        Xtoindex(X, x1_fill, x2_fill, x3_fill, length_fill, iblocktemp, itemp, jtemp, ktemp, del);
         rho = rho_fill(iblocktemp, ktemp, jtemp, itemp);
         u = u_fill(iblocktemp, ktemp, jtemp, itemp);
         VLOOP u_prim[v] = uvec_fill(v, iblocktemp, ktemp, jtemp, itemp);
@@ -158,7 +159,7 @@ KOKKOS_INLINE_FUNCTION void get_prim_restart_kharma(const GRCoordinates& G, cons
 
 KOKKOS_INLINE_FUNCTION void get_B_restart_kharma(const GRCoordinates& G, const VariablePack<Real>& U, const VarMap& m_u,
                     const Real fx1min, const Real fx1max, const bool should_fill,
-                    const hsize_t length[GR_DIM],
+                    const hsize_t length[GR_DIM], const hsize_t length_fill[GR_DIM],
                     const GridScalar& x1, const GridScalar& x2, const GridScalar& x3, const GridVector& B,
                     const GridScalar& x1_fill, const GridScalar& x2_fill, const GridScalar& x3_fill, const GridVector& B_fill,
                     const int& k, const int& j, const int& i) 
@@ -174,7 +175,7 @@ KOKKOS_INLINE_FUNCTION void get_B_restart_kharma(const GRCoordinates& G, const V
         // do nothing. just use the initialization from SeedBField
    }
     else if ((should_fill) && ((X[1]>fx1max)||(X[1]<fx1min))) { // fill with the fname_fill
-        Xtoindex(X, x1_fill, x2_fill, x3_fill, length, iblocktemp, itemp, jtemp, ktemp, del);
+        Xtoindex(X, x1_fill, x2_fill, x3_fill, length_fill, iblocktemp, itemp, jtemp, ktemp, del);
         VLOOP B_cons[v] = B_fill(v,iblocktemp,ktemp,jtemp,itemp);
     }
     else { 
@@ -37,6 +37,7 @@
 #include "b_flux_ct.hpp"
 
 #include "boundaries.hpp"
+#include "coordinate_inverse.hpp"
 #include "coordinate_utils.hpp"
 #include "domain.hpp"
 #include "fm_torus.hpp"
@@ -62,20 +63,45 @@ inline T MPIReduce_once(T f, MPI_Op O)
     return reduction.val;
 }
 
-// Shorter names for the reductions we use here
-Real MaxBsq(MeshData<Real> *md)
-{
-    return Reductions::DomainReduction<Reductions::Var::bsq, Real>(md, UserHistoryOperation::max);
-}
-Real MaxPressure(MeshData<Real> *md)
-{
-    return Reductions::DomainReduction<Reductions::Var::gas_pressure, Real>(md, UserHistoryOperation::max);
-}
-Real MinBeta(MeshData<Real> *md)
+/**
+ * Maximum b^2, maximum gas pressure, and minimum plasma beta over the domain interior,
+ * as computed by the bsq, gas_pressure, beta reductions, but from one pass over this rank's
+ * blocks and a single global reduction.
+ */
+void BNormStats(MeshData<Real> *md, Real &bsq_max, Real &p_max, Real &beta_min)
 {
-    return Reductions::DomainReduction<Reductions::Var::beta, Real>(md, UserHistoryOperation::min);
-}
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const Real gam = pmb0->packages.Get("GRMHD")->Param<Real>("gamma");
+
+    PackIndexMap prims_map;
+    const auto& P = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    const VarMap m_p(prims_map, false);
+
+    const IndexRange3 b = KDomain::GetRange(md, IndexDomain::interior);
+    const IndexRange block = IndexRange{0, P.GetDim(5) - 1};
+
+    // Beta is reduced as its negative, to take the minimum
+    Reductions::array_type<Real, 3> stats;
+    pmb0->par_reduce("B_norm_stats", block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+        KOKKOS_LAMBDA (const int &bl, const int &k, const int &j, const int &i,
+                       Reductions::array_type<Real, 3> &local_result) {
+            const auto& G = P.GetCoords(bl);
+            FourVectors Dtmp;
+            GRMHD::calc_4vecs(G, P(bl), m_p, k, j, i, Loci::center, Dtmp);
+            const Real bsq = dot(Dtmp.bcon, Dtmp.bcov);
+            const Real pgas = (gam - 1) * P(bl, m_p.UU, k, j, i);
+            const Real beta = pgas / (0.5 * (bsq + SMALL));
+            if (bsq > local_result.my_array[0]) local_result.my_array[0] = bsq;
+            if (pgas > local_result.my_array[1]) local_result.my_array[1] = pgas;
+            if (-beta > local_result.my_array[2]) local_result.my_array[2] = -beta;
+        }
+    , Reductions::ArrayMax<Real, HostExecSpace, 3>(stats));
 
+    const std::vector<Real> global = MPIReduce_once(std::vector<Real>{stats.my_array[0], stats.my_array[1], stats.my_array[2]}, MPI_MAX);
+    bsq_max = global[0];
+    p_max = global[1];
+    beta_min = -global[2];
+}
 
 template <BSeedType Seed>
 TaskStatus SeedBFieldType(MeshBlockData<Real> *rc, ParameterInput *pin, IndexDomain domain = IndexDomain::entire)
@@ -222,6 +248,7 @@ TaskStatus SeedBFieldType(MeshBlockData<Real> *rc, ParameterInput *pin, IndexDom
         // But for tilted conditions we must keep track of all components
         IndexSize3 sz = KDomain::GetBlockSize(rc);
         ParArrayND<double> A("A", NVEC, sz.n3, sz.n2, sz.n1);
+        const auto coord_inverse = pmb->packages.Get("Globals")->Param<CoordinateInverse>("coord_inverse");
         pmb->par_for(
             "B_field_A", b.ks, b.ke, b.js, b.je, b.is, b.ie,
             KOKKOS_LAMBDA(const int &k, const int &j, const int &i) {
@@ -272,9 +299,10 @@ TaskStatus SeedBFieldType(MeshBlockData<Real> *rc, ParameterInput *pin, IndexDom
                     const double A_untilt_lower[GR_DIM] = {0., 0., 0., Aphi};
                     // Raise to contravariant vector, since rotate_polar_vec will need that.
                     // Note we have to do this in the midplane!
-                    // The coord_to_native calculation involves an iterative solve for MKS/FMKS
+                    // The coord_to_native calculation involves an iterative solve for MKS/FMKS,
+                    // so use the table built at startup
                     GReal Xnative_midplane[GR_DIM] = {0}, gcon_midplane[GR_DIM][GR_DIM] = {0};
-                    G.coords.coord_to_native(Xmidplane, Xnative_midplane);
+                    coord_inverse.coord_to_native(G.coords, Xmidplane, Xnative_midplane);
                     G.coords.gcon_native(Xnative_midplane, gcon_midplane);
                     double A_untilt[GR_DIM] = {0};
                     DLOOP2 A_untilt[mu] += gcon_midplane[mu][nu] * A_untilt_lower[nu];
@@ -423,12 +451,9 @@ TaskStatus NormalizeBField(MeshData<Real> *md, ParameterInput *pin)
 
     // Calculate current beta_min value
     Real bsq_max, p_max, beta_min;
+    BNormStats(md, bsq_max, p_max, beta_min);
     if (beta_calc_legacy) {
-        bsq_max = MPIReduce_once(MaxBsq(md), MPI_MAX);
-        p_max = MPIReduce_once(MaxPressure(md), MPI_MAX);
         beta_min = p_max / (0.5 * bsq_max);
-    } else {
-        beta_min = MPIReduce_once(MinBeta(md), MPI_MIN);
     }
 
     if (MPIRank0() && verbose > 0) {
@@ -441,23 +466,38 @@ TaskStatus NormalizeBField(MeshData<Real> *md, ParameterInput *pin)
 
     // Then normalize B by sqrt(beta/beta_min)
     if (beta_min > 0) {
-        Real norm = m::sqrt(beta_min/desired_beta_min);
-        for (auto &pmb : pmesh->block_list) {
-            auto& rc = pmb->meshblock_data.Get();
-            KHARMADriver::Scale(std::vector<std::string>{"prims.B"}, rc.get(), norm);
+        const Real norm = m::sqrt(beta_min/desired_beta_min);
+        auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+        // Scale the primitive B, and the face-centered field too if it's the "real" one.
+        // Otherwise the next B_CT UtoP would undo the normalization
+        const auto& B_P = md->PackVariables(std::vector<std::string>{"prims.B"});
+        const auto& B_Uf = md->PackVariables(std::vector<std::string>{"cons.fB"});
+        const bool scale_faces = B_Uf.GetDim(4) > 0;
+        const IndexRange3 b = KDomain::GetRange(md, IndexDomain::entire);
+        const IndexRange block = IndexRange{0, B_P.GetDim(5) - 1};
+        pmb0->par_for("B_norm_scale", block.s, block.e, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+            KOKKOS_LAMBDA (const int &bl, const int &k, const int &j, const int &i) {
+                VLOOP B_P(bl, v, k, j, i) *= norm;
+            }
+        );
+        if (scale_faces) {
+            // Face arrays extend one past the last zone, so loop over their full size
+            pmb0->par_for("B_norm_scale_faces", block.s, block.e, 0, B_Uf.GetDim(3) - 1,
+                          0, B_Uf.GetDim(2) - 1, 0, B_Uf.GetDim(1) - 1,
+                KOKKOS_LAMBDA (const int &bl, const int &k, const int &j, const int &i) {
+                    B_Uf(bl, F1, 0, k, j, i) *= norm;
+                    B_Uf(bl, F2, 0, k, j, i) *= norm;
+                    B_Uf(bl, F3, 0, k, j, i) *= norm;
+                }
+            );
         }
     } // else yell?
 
-    // Measure again to check
-    if (verbose > 0) {
-        Real bsq_max, p_max, beta_min;
-        if (beta_calc_legacy) {
-            bsq_max = MPIReduce_once(MaxBsq(md), MPI_MAX);
-            p_max = MPIReduce_once(MaxPressure(md), MPI_MAX);
-            beta_min = p_max / (0.5 * bsq_max);
-        } else {
-            beta_min = MPIReduce_once(MinBeta(md), MPI_MIN);
-        }
+    // Report the result.  Scaling B scales b^2 by norm^2 everywhere, so this needs no second pass
+    if (verbose > 0 && beta_min > 0) {
+        const Real norm2 = beta_min / desired_beta_min;
+        bsq_max *= norm2;
+        beta_min /= norm2;
         if (MPIRank0()) {
             if (beta_calc_legacy) {
                 std::cout << "B^2 max post-norm: " << bsq_max << std::endl;
@@ -41,13 +41,21 @@
 #include <string.h>
 #include <hdf5.h>
 
+// For MPI_PARALLEL
+#include <parthenon_mpi.hpp>
+
 // This lib uses a global debug flag if one exists
 #ifndef DEBUG
 #define DEBUG 0
 #endif
 
-// We'll never call this for fast/MPI I/O
+// MPI-IO is available in MPI builds, but only used after hdf5_use_mpio(1).
+// Every rank must then make the same sequence of open/read/close calls
+#ifdef MPI_PARALLEL
+#define USE_MPI 1
+#else
 #define USE_MPI 0
+#endif
 
 // Crash on read/write failures.  Saves checking return values like a pleb
 #ifndef FAIL_HARD
@@ -68,6 +76,33 @@ static char hdf5_cur_dir[STRLEN] = "/";
 // Keep the file pointer globally.  This means ONE FILE AT A TIME!
 hid_t file_id;
 
+// Whether to open files and read with MPI-IO, and any hints for opening them
+static int hdf5_mpio = 0;
+#if USE_MPI
+static MPI_Info hdf5_mpio_info = MPI_INFO_NULL;
+#endif
+
+void hdf5_use_mpio(int enable)
+{
+  hdf5_mpio = USE_MPI && enable;
+}
+
+void hdf5_set_mpio_hint(const char *key, const char *value)
+{
+#if USE_MPI
+  if (hdf5_mpio_info == MPI_INFO_NULL) MPI_Info_create(&hdf5_mpio_info);
+  MPI_Info_set(hdf5_mpio_info, key, value);
+#endif
+}
+
+void hdf5_clear_mpio_hints()
+{
+#if USE_MPI
+  if (hdf5_mpio_info != MPI_INFO_NULL) MPI_Info_free(&hdf5_mpio_info);
+  hdf5_mpio_info = MPI_INFO_NULL;
+#endif
+}
+
 // Create a new HDF5 file in memory and group specified by name to
 // the root of the new HDF5 file and return pointer to blob.
 // Returns NULL on failure.
@@ -129,7 +164,7 @@ int hdf5_create(const char *fname)
 {
   hid_t plist_id = H5Pcreate(H5P_FILE_ACCESS);
 #if USE_MPI
-  H5Pset_fapl_mpio(plist_id, MPI_COMM_WORLD, MPI_INFO_NULL); // TODO tune HDF with an MPI info object
+  if (hdf5_mpio) H5Pset_fapl_mpio(plist_id, MPI_COMM_WORLD, hdf5_mpio_info);
 #endif
   file_id = H5Fcreate(fname, H5F_ACC_TRUNC, H5P_DEFAULT, plist_id);
   H5Pclose(plist_id);
@@ -149,7 +184,7 @@ int hdf5_open(const char *fname)
 {
   hid_t plist_id = H5Pcreate(H5P_FILE_ACCESS);
 #if USE_MPI
-  H5Pset_fapl_mpio(plist_id, MPI_COMM_WORLD, MPI_INFO_NULL);
+  if (hdf5_mpio) H5Pset_fapl_mpio(plist_id, MPI_COMM_WORLD, hdf5_mpio_info);
 #endif
   file_id = H5Fopen(fname, H5F_ACC_RDONLY, plist_id);
   H5Pclose(plist_id);
@@ -308,7 +343,7 @@ int hdf5_write_array(const void *data, const char *name, size_t rank,
   // Conduct the transfer
   plist_id = H5Pcreate(H5P_DATASET_XFER);
 #if USE_MPI
-  H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
+  if (hdf5_mpio) H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
 #endif
   herr_t err = H5Dwrite(dset_id, hdf5_type, memspace, filespace, plist_id, data);
   if (err < 0) FAIL(err, "hdf5_write_array", path);
@@ -341,7 +376,7 @@ int hdf5_write_single_val(const void *val, const char *name, hsize_t hdf5_type)
   // Conduct transfer
   plist_id = H5Pcreate(H5P_DATASET_XFER);
 #if USE_MPI
-  H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
+  if (hdf5_mpio) H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
 #endif
   herr_t err = H5Dwrite(dset_id, hdf5_type, scalarspace, scalarspace, plist_id, val);
   if (err < 0) FAIL(err, "hdf5_write_single_val", path);
@@ -368,7 +403,7 @@ int hdf5_read_single_val(void *val, const char *name, hsize_t hdf5_type)
 
   hid_t plist_id = H5Pcreate(H5P_DATASET_XFER);
 #if USE_MPI
-  H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
+  if (hdf5_mpio) H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
 #endif
   herr_t err = H5Dread(dset_id, hdf5_type, scalarspace, scalarspace, plist_id, val);
   if (err < 0) FAIL(err, "hdf5_read_single_val", path);
@@ -390,6 +425,14 @@ int hdf5_read_array(void *data, const char *name, size_t rank,
   hid_t memspace = H5Screate_simple(rank, mdims, NULL);
   H5Sselect_hyperslab(memspace, H5S_SELECT_SET, mstart, NULL, fcount,
     NULL);
+  // Empty reads still take part in collective I/O, selecting nothing
+  for (size_t d = 0; d < rank; d++) {
+    if (fcount[d] == 0) {
+      H5Sselect_none(filespace);
+      H5Sselect_none(memspace);
+      break;
+    }
+  }
 
   char path[STRLEN];
   strncpy(path, hdf5_cur_dir, STRLEN);
@@ -408,7 +451,7 @@ int hdf5_read_array(void *data, const char *name, size_t rank,
 
   hid_t plist_id = H5Pcreate(H5P_DATASET_XFER);
 #if USE_MPI
-  H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
+  if (hdf5_mpio) H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
 #endif
   herr_t err = H5Dread(dset_id, hdf5_type, memspace, filespace, plist_id, data);
   if (err < 0) FAIL(err, "hdf5_read_array", path);
@@ -420,3 +463,52 @@ int hdf5_read_array(void *data, const char *name, size_t rank,
 
   return 0;
 }
+
+int hdf5_read_blocks(void *data, const char *name, size_t rank,
+                      hsize_t *fdims, hsize_t nblocks, const hsize_t *blocks, hsize_t hdf5_type)
+{
+  // Union of one hyperslab per block.  HDF5 reads selections in file order,
+  // so blocks must be ascending to land in memory in the listed order
+  hsize_t fstart[H5S_MAX_RANK], fcount[H5S_MAX_RANK], mdims[H5S_MAX_RANK];
+  for (size_t d = 0; d < rank; d++) {
+    fstart[d] = 0;
+    fcount[d] = fdims[d];
+    mdims[d] = fdims[d];
+  }
+  fcount[0] = 1;
+  mdims[0] = (nblocks > 0) ? nblocks : 1;
+
+  hid_t filespace = H5Screate_simple(rank, fdims, NULL);
+  H5Sselect_none(filespace);
+  for (hsize_t n = 0; n < nblocks; n++) {
+    fstart[0] = blocks[n];
+    H5Sselect_hyperslab(filespace, H5S_SELECT_OR, fstart, NULL, fcount, NULL);
+  }
+  hid_t memspace = H5Screate_simple(rank, mdims, NULL);
+  if (nblocks == 0) H5Sselect_none(memspace);
+
+  char path[STRLEN];
+  strncpy(path, hdf5_cur_dir, STRLEN);
+  strncat(path, name, STRLEN - strlen(path));
+
+  if(DEBUG) {
+    fprintf(stderr,"Reading %llu blocks of arr %s\n", nblocks, path);
+  }
+
+  hid_t dset_id = H5Dopen(file_id, path, H5P_DEFAULT);
+
+  // Still collective: every rank calls this once per dataset, even with no blocks
+  hid_t plist_id = H5Pcreate(H5P_DATASET_XFER);
+#if USE_MPI
+  if (hdf5_mpio) H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
+#endif
+  herr_t err = H5Dread(dset_id, hdf5_type, memspace, filespace, plist_id, data);
+  if (err < 0) FAIL(err, "hdf5_read_blocks", path);
+
+  H5Dclose(dset_id);
+  H5Pclose(plist_id);
+  H5Sclose(filespace);
+  H5Sclose(memspace);
+
+  return 0;
+}
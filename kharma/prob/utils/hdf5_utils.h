@@ -42,6 +42,12 @@
 // Force MPI on or off
 //#define USE_MPI 0
 
+// MPI-IO.  Off by default: while enabled, files are opened and read collectively,
+// using any hints set (e.g. "cb_nodes", "striping_factor") when opening
+void hdf5_use_mpio(int enable);
+void hdf5_set_mpio_hint(const char *key, const char *value);
+void hdf5_clear_mpio_hints();
+
 // Blob "copy" utility
 typedef hid_t hdf5_blob;
 hdf5_blob hdf5_get_blob(const char *name);
@@ -67,6 +73,9 @@ int hdf5_exists(const char *name);
 int hdf5_read_single_val(void *val, const char *name, hsize_t hdf5_type);
 int hdf5_read_array(void *data, const char *name, size_t rank,
                       hsize_t *fdims, hsize_t *fstart, hsize_t *fcount, hsize_t *mdims, hsize_t *mstart, hsize_t hdf5_type);
+// Read only the listed (ascending) indices of the first dimension, packed contiguously in memory
+int hdf5_read_blocks(void *data, const char *name, size_t rank,
+                      hsize_t *fdims, hsize_t nblocks, const hsize_t *blocks, hsize_t hdf5_type);
 
 // Convenience and annotations
 hid_t hdf5_make_str_type(size_t len);
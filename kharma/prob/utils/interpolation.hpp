@@ -34,11 +34,14 @@
 #pragma once
 
 #include "decs.hpp"
+#include "coordinate_embedding.hpp"
+
+#include <algorithm>
 
 /**
  * Routines for interpolating on a grid, using values given in a flattened array.
  * Mostly used in resize_restart.cpp, which must interpolate from old simulation
- * data.
+ * data, and for tabulated radial profiles (LogRTable) in problem setups.
  * 
  * Note that resizing or resampling of magnetic fields usually requires
  * fixing a resulting divergence -- see b_cleanup/ for details.
@@ -96,7 +99,7 @@ KOKKOS_INLINE_FUNCTION void Xtoijk_nearest(const GReal X[GR_DIM],
  * Takes indices i,j,k and a block size n1, n2, n3,
  * as well as a flat array var.
  * 
- * TODO version(s) with View(s) for real device-side operation
+ * See below for a version reading from a View, for device-side operation
  */
 KOKKOS_INLINE_FUNCTION Real linear(const int& i, const int& j, const int& k,
                                    const int& n1, const int& n2, const int& n3,
@@ -120,4 +123,137 @@ KOKKOS_INLINE_FUNCTION Real linear(const int& i, const int& j, const int& k,
     return interp;
 }
 
+/**
+ * Linear interpolation as above, from variable p of a View var(p, k, j, i), for use on device
+ */
+template<typename V>
+KOKKOS_INLINE_FUNCTION Real linear(const int& i, const int& j, const int& k,
+                                   const int& n1, const int& n2, const int& n3,
+                                   const double del[4], const V& var, const int& p)
+{
+    Real interp = var(p, k, j, i    )*(1. - del[1]) +
+                  var(p, k, j, i + 1)*del[1];
+    if (n2 > 1) {
+        interp = (1. - del[2])*interp +
+                 del[2]*(var(p, k, j + 1, i    )*(1. - del[1]) +
+                         var(p, k, j + 1, i + 1)*del[1]);
+    }
+    if (n3 > 1) {
+        interp = (1. - del[3])*interp +
+                 del[3]*(var(p, k + 1, j    , i    )*(1. - del[1])*(1. - del[2]) +
+                         var(p, k + 1, j    , i + 1)*del[1]*(1. - del[2]) +
+                         var(p, k + 1, j + 1, i    )*(1. - del[1])*del[2] +
+                         var(p, k + 1, j + 1, i + 1)*del[1]*del[2]);
+    }
+    return interp;
+}
+
+/**
+ * Conservative (volume-weighted) remapping of the first nvar variables of a View var(p, k, j, i)
+ * onto the zone [Xl, Xr) of another grid.  Each overlapping zone of the cached grid is weighted by
+ * its overlap volume and by gdet at its center, so that integrals of gdet*var are preserved.
+ * gs is the global index of the cache's first zone, and [glo, ghi] the valid global indices in it:
+ * overlapping zones outside this range repeat the nearest valid zone.
+ */
+template<typename V>
+KOKKOS_INLINE_FUNCTION void conservative(const CoordinateEmbedding& coords,
+                                         const GReal Xl[GR_DIM], const GReal Xr[GR_DIM],
+                                         const GReal startx[GR_DIM], const GReal dx[GR_DIM],
+                                         const int gs[GR_DIM], const int glo[GR_DIM], const int ghi[GR_DIM],
+                                         const V& var, const int& nvar, Real *out)
+{
+    // Range of cached grid zones overlapping the target zone
+    int lo[GR_DIM], hi[GR_DIM];
+    for (int d = 1; d < GR_DIM; d++) {
+        lo[d] = (int) m::floor((Xl[d] - startx[d]) / dx[d]);
+        hi[d] = (int) m::ceil((Xr[d] - startx[d]) / dx[d]) - 1;
+        if (hi[d] < lo[d]) hi[d] = lo[d];
+    }
+    for (int p = 0; p < nvar; p++) out[p] = 0.;
+    Real wtot = 0.;
+    for (int gk = lo[3]; gk <= hi[3]; gk++) {
+        const Real w3 = m::min(Xr[3], startx[3] + (gk + 1)*dx[3]) - m::max(Xl[3], startx[3] + gk*dx[3]);
+        const int mk = m::min(m::max(gk, glo[3]), ghi[3]) - gs[3];
+        for (int gj = lo[2]; gj <= hi[2]; gj++) {
+            const Real w2 = m::min(Xr[2], startx[2] + (gj + 1)*dx[2]) - m::max(Xl[2], startx[2] + gj*dx[2]);
+            const int mj = m::min(m::max(gj, glo[2]), ghi[2]) - gs[2];
+            for (int gi = lo[1]; gi <= hi[1]; gi++) {
+                const Real w1 = m::min(Xr[1], startx[1] + (gi + 1)*dx[1]) - m::max(Xl[1], startx[1] + gi*dx[1]);
+                const int mi = m::min(m::max(gi, glo[1]), ghi[1]) - gs[1];
+                // Metric at the center of the (possibly repeated) cached zone
+                const GReal X[GR_DIM] = {0., startx[1] + (mi + gs[1] + 0.5)*dx[1],
+                                             startx[2] + (mj + gs[2] + 0.5)*dx[2],
+                                             startx[3] + (mk + gs[3] + 0.5)*dx[3]};
+                const Real w = m::max(w1, 0.) * m::max(w2, 0.) * m::max(w3, 0.) * coords.gdet_native(X);
+                for (int p = 0; p < nvar; p++) out[p] += w * var(p, mk, mj, mi);
+                wtot += w;
+            }
+        }
+    }
+    if (wtot > 0.)
+        for (int p = 0; p < nvar; p++) out[p] /= wtot;
+}
+
+/**
+ * Radial profiles of nvar variables tabulated uniformly in log(r), for O(1) lookup on device
+ * by problem initializers & boundaries.  Lookup is linear in log(r), and clamps to the
+ * first/last entry outside [rmin, rmax].
+ * Build with TabulateLogR or ResampleLogR below, host-side.
+ */
+struct LogRTable {
+    ParArray2D<Real> data; // (var, index)
+    GReal lrmin = 0., dlr = 1.;
+    int n = 0;
+
+    KOKKOS_INLINE_FUNCTION Real operator()(const int& v, const GReal& r) const
+    {
+        const GReal x = (m::log(r) - lrmin) / dlr;
+        const int i = m::min(m::max((int) m::floor(x), 0), n - 2);
+        const GReal del = m::min(m::max(x - i, 0.), 1.);
+        return data(v, i) * (1. - del) + data(v, i + 1) * del;
+    }
+};
+
+/**
+ * Tabulate nvar profiles at n points uniform in log(r) over [rmin, rmax], evaluating
+ * f(r, out) host-side at each point, e.g. with a root solve.
+ */
+template<typename Function>
+inline LogRTable TabulateLogR(const std::string& label, const int nvar, const int n,
+                              const GReal rmin, const GReal rmax, Function f)
+{
+    if (n < 2 || rmin <= 0. || rmax <= rmin)
+        throw std::invalid_argument("Log-r table "+label+" needs at least 2 points over 0 < rmin < rmax!");
+    LogRTable table;
+    table.n = n;
+    table.lrmin = m::log(rmin);
+    table.dlr = (m::log(rmax) - table.lrmin) / (n - 1);
+    table.data = ParArray2D<Real>(label, nvar, n);
+    auto data_h = table.data.GetHostMirror();
+    std::vector<Real> out(nvar);
+    for (int i = 0; i < n; i++) {
+        f(m::exp(table.lrmin + i * table.dlr), out.data());
+        for (int v = 0; v < nvar; v++) data_h(v, i) = out[v];
+    }
+    table.data.DeepCopy(data_h);
+    return table;
+}
+
+/**
+ * Resample profiles given at increasing radii r (e.g. read from a file), with linear
+ * interpolation in r, onto a table of n points uniform in log(r) over the same range
+ */
+inline LogRTable ResampleLogR(const std::string& label, const std::vector<Real>& r,
+                              const std::vector<std::vector<Real>>& vars, const int n)
+{
+    const int nvar = vars.size();
+    return TabulateLogR(label, nvar, n, r.front(), r.back(),
+        [&](const GReal& rt, Real *out) {
+            const int i = m::min(m::max((int) (std::upper_bound(r.begin(), r.end(), rt) - r.begin()) - 1, 0),
+                                 (int) r.size() - 2);
+            const GReal del = m::min(m::max((rt - r[i]) / (r[i + 1] - r[i]), 0.), 1.);
+            for (int v = 0; v < nvar; v++) out[v] = vars[v][i] * (1. - del) + vars[v][i + 1] * del;
+        });
+}
+
 } // Interpolation
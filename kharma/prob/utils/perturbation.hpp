@@ -34,17 +34,18 @@
 #pragma once
 
 #include "decs.hpp"
-
-#include <random>
-#include "Kokkos_Random.hpp"
+#include "kharma_utils.hpp"
 
 /**
  * Perturb the internal energy by a uniform random proportion per cell.
  * Resulting internal energies will be between u \pm u*u_jitter/2
  * i.e. u_jitter=0.1 -> \pm 5% randomization, 0.95u to 1.05u
  *
+ * Random values come from a counter-based generator keyed on each zone's global index,
+ * so the perturbation is the same for any MeshBlock layout or number of ranks.
+ *
  * @param u_jitter see description
- * @param rng_seed is added to the MPI rank to seed the GSL RNG
+ * @param rng_seed is the key for the generator
  */
 TaskStatus PerturbU(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterInput *pin)
 {
@@ -55,14 +56,7 @@ TaskStatus PerturbU(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterInput *pi
     const Real u_jitter = pin->GetReal("perturbation", "u_jitter");
     // Don't jitter values set by floors
     const Real jitter_above_rho = pin->GetReal("floors", "rho_min_geom") + 1e-10;
-    // Note we add the MeshBlock gid to this value when seeding RNG,
-    // to get a new sequence for every block
     const int rng_seed = pin->GetOrAddInteger("perturbation", "rng_seed", 31337);
-    // Print real seed used for all blocks, to ensure they're different
-    if (pmb->packages.Get("Globals")->Param<int>("verbose") > 1) {
-        std::cout << "Seeding RNG in block " << pmb->gid << " with value " << rng_seed + pmb->gid << std::endl;
-    }
-    const bool serial = pin->GetOrAddInteger("perturbation", "serial", false);
 
     // Should we jitter ghosts? If first boundary sync doesn't work it's marginally less disruptive
     IndexDomain domain = IndexDomain::interior;
@@ -70,33 +64,27 @@ TaskStatus PerturbU(std::shared_ptr<MeshBlockData<Real>>& rc, ParameterInput *pi
     const int js = pmb->cellbounds.js(domain), je = pmb->cellbounds.je(domain);
     const int ks = pmb->cellbounds.ks(domain), ke = pmb->cellbounds.ke(domain);
 
-    if (serial) {
-        // Serial version
-        // Probably guarantees better determinism, but CPU single-thread only
-        std::mt19937 gen(rng_seed + pmb->gid);
-        std::uniform_real_distribution<Real> dis(-u_jitter/2, u_jitter/2);
-
-        auto u_host = u.GetHostMirrorAndCopy();
-        for(int k=ks; k <= ke; k++)
-            for(int j=js; j <= je; j++)
-                for(int i=is; i <= ie; i++)
-                    u_host(k, j, i) *= 1. + dis(gen);
-        u.DeepCopy(u_host);
-    } else {
-        // Kokkos version
-        typedef typename Kokkos::Random_XorShift64_Pool<> RandPoolType;
-        RandPoolType rand_pool(rng_seed + pmb->gid);
-        typedef typename RandPoolType::generator_type gen_type;
-        pmb->par_for("perturb_u", ks, ke, js, je, is, ie,
-            KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
-                if (rho(k, j, i) > jitter_above_rho) {
-                    gen_type rgen = rand_pool.get_state();
-                    u(k, j, i) *= 1. + Kokkos::rand<gen_type, Real>::draw(rgen, -u_jitter/2, u_jitter/2);
-                    rand_pool.free_state(rgen);
-                }
+    // Global zone index from native coordinates, which are uniform at each refinement level.
+    // The zone width distinguishes levels, so refined zones get their own values
+    const auto& G = pmb->coords;
+    const GReal x1min = pmb->pmy_mesh->mesh_size.xmin(X1DIR);
+    const GReal x2min = pmb->pmy_mesh->mesh_size.xmin(X2DIR);
+    const GReal x3min = pmb->pmy_mesh->mesh_size.xmin(X3DIR);
+    const GReal dx1_base = (pmb->pmy_mesh->mesh_size.xmax(X1DIR) - x1min) / pmb->pmy_mesh->mesh_size.nx(X1DIR);
+    const uint32_t level = (uint32_t) m::max((int) std::lround(std::log2(dx1_base / G.Dxc<1>(is))), 0);
+    pmb->par_for("perturb_u", ks, ke, js, je, is, ie,
+        KOKKOS_LAMBDA (const int &k, const int &j, const int &i) {
+            if (rho(k, j, i) > jitter_above_rho) {
+                GReal X[GR_DIM];
+                G.coord(k, j, i, Loci::center, X);
+                const uint32_t gi = (uint32_t) m::floor((X[1] - x1min) / G.Dxc<1>(i));
+                const uint32_t gj = (uint32_t) m::floor((X[2] - x2min) / G.Dxc<2>(j));
+                const uint32_t gk = (uint32_t) m::floor((X[3] - x3min) / G.Dxc<3>(k));
+                const Real r = philox_uniform(rng_seed, gi, gj, gk, level);
+                u(k, j, i) *= 1. + u_jitter * (r - 0.5);
             }
-        );
-    }
+        }
+    );
 
     return TaskStatus::complete;
 }
@@ -0,0 +1,114 @@
+/* 
+ *  File: reduced_output.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "reduced_output.hpp"
+
+#include "domain.hpp"
+
+#include <sstream>
+
+std::shared_ptr<KHARMAPackage> ReducedOutput::Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages)
+{
+    auto pkg = std::make_shared<KHARMAPackage>("ReducedOutput");
+    Params &params = pkg->AllParams();
+
+    // Options
+    // Comma-separated list of cell-centered variables to copy.  prims.uvec & prims.B are vectors, others scalars
+    const std::string var_list = pin->GetOrAddString("reduced_output", "variables", "prims.rho,prims.u,prims.uvec,prims.B");
+    // Mantissa bits to keep of float32's 23: 10 is about 3 significant digits
+    const int bits = pin->GetOrAddInteger("reduced_output", "bits", 10);
+    if (bits < 0 || bits > 23)
+        throw std::invalid_argument("reduced_output/bits must be between 0 and 23!");
+
+    std::vector<std::string> sources, names;
+    std::vector<int> var_bits;
+    std::stringstream ss(var_list);
+    std::string var;
+    while (std::getline(ss, var, ',')) {
+        // Trim any whitespace
+        var.erase(0, var.find_first_not_of(" \t"));
+        var.erase(var.find_last_not_of(" \t") + 1);
+        if (var.empty()) continue;
+        // Name after the last dot: prims.rho -> reduced.rho
+        const std::string name = var.substr(var.rfind('.') + 1);
+        sources.push_back(var);
+        names.push_back("reduced." + name);
+        var_bits.push_back(pin->GetOrAddInteger("reduced_output", "bits_" + name, bits));
+        if (var_bits.back() < 0 || var_bits.back() > 23)
+            throw std::invalid_argument("reduced_output/bits_" + name + " must be between 0 and 23!");
+    }
+    params.Add("sources", sources);
+    params.Add("names", names);
+    params.Add("bits", var_bits);
+
+    // Fields: output-only copies, never synchronized or restarted
+    Metadata::AddUserFlag("ReducedOutput");
+    std::vector<MetadataFlag> flags_reduced = {Metadata::Real, Metadata::Cell, Metadata::Derived,
+                                               Metadata::OneCopy, Metadata::GetUserFlag("ReducedOutput")};
+    std::vector<int> s_vector({NVEC});
+    for (int v = 0; v < names.size(); v++) {
+        const bool is_vector = (sources[v] == "prims.uvec" || sources[v] == "prims.B");
+        pkg->AddField(names[v], (is_vector) ? Metadata(flags_reduced, s_vector) : Metadata(flags_reduced));
+    }
+
+    pkg->BlockUserWorkBeforeOutput = ReducedOutput::BlockUserWorkBeforeOutput;
+
+    return pkg;
+}
+
+TaskStatus ReducedOutput::BlockUserWorkBeforeOutput(MeshBlock *pmb, ParameterInput *pin)
+{
+    auto rc = pmb->meshblock_data.Get();
+    auto& params = pmb->packages.Get("ReducedOutput")->AllParams();
+    const auto& sources = params.Get<std::vector<std::string>>("sources");
+    const auto& names = params.Get<std::vector<std::string>>("names");
+    const auto& var_bits = params.Get<std::vector<int>>("bits");
+
+    IndexRange3 b = KDomain::GetRange(rc, IndexDomain::entire);
+    for (int v = 0; v < names.size(); v++) {
+        auto src = rc->PackVariables(std::vector<std::string>{sources[v]});
+        auto dst = rc->PackVariables(std::vector<std::string>{names[v]});
+        // A source which doesn't exist in this run packs empty, and is skipped here
+        const int nvar = m::min(src.GetDim(4), dst.GetDim(4));
+        if (nvar < 1) continue;
+        const int nbits = var_bits[v];
+        pmb->par_for("reduce_output_" + names[v], 0, nvar - 1, b.ks, b.ke, b.js, b.je, b.is, b.ie,
+            KOKKOS_LAMBDA (const int &p, const int &k, const int &j, const int &i) {
+                dst(p, k, j, i) = round_mantissa(src(p, k, j, i), nbits);
+            }
+        );
+    }
+
+    return TaskStatus::complete;
+}
@@ -0,0 +1,80 @@
+/* 
+ *  File: reduced_output.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+#include "types.hpp"
+
+#include <parthenon/parthenon.hpp>
+
+/**
+ * Reduced-precision copies of selected variables, for cheaper production dumps.
+ *
+ * Each variable listed in reduced_output/variables gets a copy "reduced.<name>" (e.g.
+ * reduced.rho for prims.rho), filled before each output with the value rounded to a
+ * float32 keeping only reduced_output/bits mantissa bits (or bits_<name> for one variable).
+ * List these in an output block with single_precision_output=true and a nonzero
+ * hdf5_compression_level: the zeroed low bits make gzip compression very effective.
+ */
+namespace ReducedOutput {
+
+/**
+ * Initialize the reduced output fields and options
+ */
+std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages);
+
+/**
+ * Fill the reduced fields from their sources over a block
+ */
+TaskStatus BlockUserWorkBeforeOutput(MeshBlock *pmb, ParameterInput *pin);
+
+/**
+ * Round x to a float with only the top "bits" bits of mantissa (of 23), rounding to nearest.
+ * Values needing no rounding, infinities and NaNs pass through as floats.
+ */
+KOKKOS_INLINE_FUNCTION Real round_mantissa(const Real x, const int bits)
+{
+    union { float f; uint32_t u; } val;
+    val.f = (float) x;
+    const int drop = 23 - bits;
+    // Leave exponent-only values (inf/NaN) alone
+    if (drop > 0 && (val.u & 0x7f800000u) != 0x7f800000u) {
+        const uint32_t half = 1u << (drop - 1);
+        const uint32_t mask = ~((1u << drop) - 1u);
+        val.u = (val.u + half) & mask;
+    }
+    return (Real) val.f;
+}
+
+}
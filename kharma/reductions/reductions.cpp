@@ -34,8 +34,12 @@
 
 #include "reductions.hpp"
 
+#include "hdf5_utils.h"
+
 #include <parthenon/parthenon.hpp>
 
+#include <sstream>
+
 // TODO none of this machinery preserves zone locations,
 // which we pretty often would like...
 
@@ -65,9 +69,374 @@ std::shared_ptr<KHARMAPackage> Reductions::Initialize(ParameterInput *pin, std::
     std::vector<AllReduce<Real>> allreduce_pool;
     params.Add("allreduce_pool", allreduce_pool, true);
 
+    // Which channels of allreduce_pool have a lagged reduction in flight, see LaggedMaxToAll
+    std::vector<int> lagged_active;
+    params.Add("lagged_active", lagged_active, true);
+    // Likewise for vector_int_allreduce_pool, see LaggedSumToAll
+    std::vector<int> lagged_vector_int_active;
+    params.Add("lagged_vector_int_active", lagged_vector_int_active, true);
+
+    // Device lists of blocks for InnerX1Blocks & SampledChecks, kept to avoid allocating each step
+    params.Add("inner_x1_blocks", Allocations::PersistentArray<int>("inner_x1_blocks"), true);
+    params.Add("sampled_blocks", Allocations::PersistentArray<int>("sampled_blocks"), true);
+    // Likewise the bins for RadialProfiles & Slice
+    params.Add("profile_bins", Allocations::PersistentArray<Real>("profile_bins"), true);
+    params.Add("slice_bins", Allocations::PersistentArray<Real>("slice_bins"), true);
+
+    // Optionally complete flag counts lazily: each is reported when the next count on its channel
+    // is started (usually the next step), rather than blocking right after it is started.
+    // Keeps MPI latency off the end of each step, at the cost of reports lagging by a step
+    bool lazy_flag_reports = pin->GetOrAddBoolean("debug", "lazy_flag_reports", false);
+    params.Add("lazy_flag_reports", lazy_flag_reports);
+    // Flag counts in flight on each channel of vector_int_reduce_pool, when reporting lazily
+    std::vector<LazyFlagReport> lazy_reports;
+    params.Add("lazy_reports", lazy_reports, true);
+
+    pkg->PostExecute = Reductions::PostExecute;
+
+    // Radial profiles of some basic quantities, reduced on device and written as text.
+    // Cheaper than writing dumps just to post-process them into profiles
+    Real profile_dt = pin->GetOrAddReal("profiles", "dt", -1.);
+    params.Add("profile_dt", profile_dt);
+    if (profile_dt > 0.) {
+        // Default to one bin per zone of the base mesh
+        int profile_nbins1 = pin->GetOrAddInteger("profiles", "nbins1", pin->GetInteger("parthenon/mesh", "nx1"));
+        // Binning in X2 too gives (r, th) profiles, averaged only over X3
+        int profile_nbins2 = pin->GetOrAddInteger("profiles", "nbins2", 1);
+        if (profile_nbins1 < 1 || profile_nbins2 < 1)
+            throw std::invalid_argument("Radial profiles need at least one bin in each direction!");
+        params.Add("profile_nbins1", profile_nbins1);
+        params.Add("profile_nbins2", profile_nbins2);
+        // Profiles are appended to this file, each block marked with its time, so restarts simply continue it
+        std::string profile_file = pin->GetOrAddString("profiles", "file", "profiles.txt");
+        params.Add("profile_file", profile_file);
+        // Simulation time of the next profile
+        params.Add("profile_next_time", (Real) 0., true);
+        pkg->PostStepDiagnosticsMesh = Reductions::PostStepDiagnostics;
+    }
+
+    // Planes (e.g. equatorial & poloidal slices for movies) and downsampled volumes of some
+    // primitive & derived quantities, binned on device and written by rank 0 to small HDF5 files
+    Real slice_dt = pin->GetOrAddReal("slices", "dt", -1.);
+    params.Add("slice_dt", slice_dt);
+    if (slice_dt > 0.) {
+        // Comma-separated planes X<d>=<native coordinate>, where the coordinate can also be "min" or "mid"
+        std::string plane_list = pin->GetOrAddString("slices", "planes", "X2=mid,X3=min");
+        std::vector<int> slice_dirs;
+        std::vector<std::string> slice_pos;
+        std::stringstream ss(plane_list);
+        std::string plane;
+        while (std::getline(ss, plane, ',')) {
+            plane.erase(0, plane.find_first_not_of(" \t"));
+            plane.erase(plane.find_last_not_of(" \t") + 1);
+            if (plane.empty()) continue;
+            const auto eq = plane.find('=');
+            if (eq != 2 || plane[0] != 'X' || plane[1] < '1' || plane[1] > '3')
+                throw std::invalid_argument("Slice planes must be given as X1=, X2= or X3=, not "+plane);
+            slice_dirs.push_back(plane[1] - '0');
+            slice_pos.push_back(plane.substr(eq + 1));
+        }
+        // Optionally also a volume, averaged over stride^3 zones of the base mesh
+        int slice_stride = pin->GetOrAddInteger("slices", "stride", 0);
+        if (slice_stride > 0) {
+            slice_dirs.push_back(0);
+            slice_pos.push_back("");
+        }
+        if (slice_dirs.empty())
+            throw std::invalid_argument("Slices need at least one plane, or a volume stride!");
+        params.Add("slice_dirs", slice_dirs);
+        params.Add("slice_pos", slice_pos);
+        params.Add("slice_stride", slice_stride);
+        // Default to one bin per zone of the base mesh in planes
+        std::vector<int> slice_nx, slice_nbins;
+        for (int d=1; d <= 3; d++) {
+            slice_nx.push_back(pin->GetInteger("parthenon/mesh", "nx"+std::to_string(d)));
+            slice_nbins.push_back(pin->GetOrAddInteger("slices", "nbins"+std::to_string(d), slice_nx.back()));
+        }
+        for (int d=0; d < 3; d++)
+            if (slice_nbins[d] < 1) throw std::invalid_argument("Slices need at least one bin in each direction!");
+        params.Add("slice_nx", slice_nx);
+        params.Add("slice_nbins", slice_nbins);
+        // Each slice file is named <file>.<number>.h5, numbered by time so restarts continue the sequence
+        std::string slice_file = pin->GetOrAddString("slices", "file", "slices");
+        params.Add("slice_file", slice_file);
+        params.Add("slice_next_time", (Real) 0., true);
+        pkg->PostStepDiagnosticsMesh = Reductions::PostStepDiagnostics;
+    }
+
     return pkg;
 }
 
+static void WriteProfiles(const SimTime& tm, MeshData<Real> *md)
+{
+    using namespace Reductions;
+    auto pmesh = md->GetMeshPointer();
+    auto& pars = pmesh->packages.Get("Reductions")->AllParams();
+
+    Flag("WriteProfiles");
+    const int nbins1 = pars.Get<int>("profile_nbins1");
+    const int nbins2 = pars.Get<int>("profile_nbins2");
+    // Channel 0 of the vector<Real> pool is otherwise unused
+    const auto profiles = RadialProfiles<Var::rho, Var::gas_pressure, Var::mag_pressure, Var::beta,
+                                         Var::mdot, Var::edot, Var::ldot>(md, nbins1, nbins2, 0);
+    constexpr int N = 7;
+
+    if (MPIRank0()) {
+        const auto& coords = md->GetBlockData(0)->GetBlockPointer()->coords.coords;
+        const GReal x1min = pmesh->mesh_size.xmin(X1DIR);
+        const GReal x2min = pmesh->mesh_size.xmin(X2DIR);
+        const GReal dbin1 = (pmesh->mesh_size.xmax(X1DIR) - x1min) / nbins1;
+        const GReal dbin2 = (pmesh->mesh_size.xmax(X2DIR) - x2min) / nbins2;
+
+        FILE *fp = fopen(pars.Get<std::string>("profile_file").c_str(), "a");
+        if (fp == nullptr) throw std::runtime_error("Could not open radial profiles file!");
+        fprintf(fp, "# t = %.10g\n", tm.time);
+        fprintf(fp, "# X1 X2 r th rho Pg Pb beta Mdot Edot Ldot\n");
+        for (int bin2=0; bin2 < nbins2; bin2++) {
+            for (int bin1=0; bin1 < nbins1; bin1++) {
+                // Bin center.  X2 is the midplane if we only bin in X1
+                const GReal Xnative[GR_DIM] = {0., x1min + (bin1 + 0.5) * dbin1,
+                                               (nbins2 > 1) ? x2min + (bin2 + 0.5) * dbin2 : 0.5 * (x2min + pmesh->mesh_size.xmax(X2DIR)), 0.};
+                GReal Xembed[GR_DIM];
+                coords.coord_to_embed(Xnative, Xembed);
+                fprintf(fp, "%.10g %.10g %.10g %.10g", Xnative[1], Xnative[2], Xembed[1], Xembed[2]);
+                const int bin = bin2 * nbins1 + bin1;
+                for (int v=0; v < N; v++) fprintf(fp, " %.10g", profiles[N * bin + v]);
+                fprintf(fp, "\n");
+            }
+        }
+        fprintf(fp, "\n");
+        fclose(fp);
+    }
+
+    EndFlag();
+}
+
+static void WriteSlices(const SimTime& tm, MeshData<Real> *md)
+{
+    using namespace Reductions;
+    auto pmesh = md->GetMeshPointer();
+    auto& pars = pmesh->packages.Get("Reductions")->AllParams();
+
+    Flag("WriteSlices");
+    const auto& dirs = pars.Get<std::vector<int>>("slice_dirs");
+    const auto& pos = pars.Get<std::vector<std::string>>("slice_pos");
+    const auto& nbins_mesh = pars.Get<std::vector<int>>("slice_nbins");
+    const auto& nx_mesh = pars.Get<std::vector<int>>("slice_nx");
+    const int stride = pars.Get<int>("slice_stride");
+    const char *var_names[] = {"rho", "Pg", "bsq", "beta", "sigma"};
+    constexpr int N = 5;
+
+    // Only rank 0 writes, so the whole file is serial
+    if (MPIRank0()) {
+        const int num = static_cast<int>(m::floor(tm.time / pars.Get<Real>("slice_dt") + 1.e-6));
+        char numstr[16];
+        snprintf(numstr, 16, "%05d", num);
+        const std::string fname = pars.Get<std::string>("slice_file") + "." + numstr + ".h5";
+        hdf5_use_mpio(0);
+        hdf5_create(fname.c_str());
+        hdf5_write_single_val(&tm.time, "t", H5T_IEEE_F64LE);
+    }
+
+    for (int s=0; s < dirs.size(); s++) {
+        const int dir = dirs[s];
+        GReal x0 = 0.;
+        int nbins[3];
+        for (int d=0; d < 3; d++) {
+            if (dir == 0) {
+                nbins[d] = m::max(nx_mesh[d] / stride, 1);
+            } else {
+                nbins[d] = (d+1 == dir) ? 1 : nbins_mesh[d];
+            }
+        }
+        std::string name = "volume";
+        if (dir > 0) {
+            const auto cdir = static_cast<CoordinateDirection>(dir);
+            const GReal xmin = pmesh->mesh_size.xmin(cdir), xmax = pmesh->mesh_size.xmax(cdir);
+            if (pos[s] == "min") x0 = xmin;
+            else if (pos[s] == "mid") x0 = 0.5 * (xmin + xmax);
+            else x0 = std::stod(pos[s]);
+            name = "X" + std::to_string(dir) + "_" + std::to_string(s);
+        }
+
+        // Channel 1 of the vector<Real> pool is otherwise unused
+        const auto slice = Slice<Var::rho, Var::gas_pressure, Var::bsq, Var::beta, Var::sigma>(md, dir, x0, nbins, 1);
+
+        if (MPIRank0()) {
+            hdf5_make_directory(name.c_str());
+            hdf5_set_directory(("/" + name + "/").c_str());
+            hdf5_write_single_val(&dir, "dir", H5T_STD_I32LE);
+            hdf5_write_single_val(&x0, "x0", H5T_IEEE_F64LE);
+            // Arrays in X3,X2,X1 order like Parthenon's own dumps
+            hsize_t fdims[3] = {(hsize_t) nbins[2], (hsize_t) nbins[1], (hsize_t) nbins[0]};
+            hsize_t fstart[3] = {0, 0, 0};
+            const int nbins_tot = nbins[0] * nbins[1] * nbins[2];
+            std::vector<Real> var(nbins_tot);
+            for (int v=0; v < N; v++) {
+                for (int bin=0; bin < nbins_tot; bin++) var[bin] = slice[N * bin + v];
+                hdf5_write_array(var.data(), var_names[v], 3, fdims, fstart, fdims, fdims, fstart, H5T_IEEE_F64LE);
+            }
+            hdf5_set_directory("/");
+        }
+    }
+
+    if (MPIRank0()) hdf5_close();
+
+    EndFlag();
+}
+
+TaskStatus Reductions::PostStepDiagnostics(const SimTime& tm, MeshData<Real> *md)
+{
+    auto pmesh = md->GetMeshPointer();
+    auto& pars = pmesh->packages.Get("Reductions")->AllParams();
+    if (!pmesh->packages.AllPackages().count("GRMHD")) return TaskStatus::complete;
+
+    // Schedule each from the current time, so restarts don't write a burst of outputs
+    const Real profile_dt = pars.Get<Real>("profile_dt");
+    if (profile_dt > 0. && tm.time >= pars.Get<Real>("profile_next_time")) {
+        pars.Update<Real>("profile_next_time", (m::floor(tm.time / profile_dt) + 1) * profile_dt);
+        WriteProfiles(tm, md);
+    }
+    const Real slice_dt = pars.Get<Real>("slice_dt");
+    if (slice_dt > 0. && tm.time >= pars.Get<Real>("slice_next_time")) {
+        pars.Update<Real>("slice_next_time", (m::floor(tm.time / slice_dt) + 1) * slice_dt);
+        WriteSlices(tm, md);
+    }
+
+    return TaskStatus::complete;
+}
+
+bool Reductions::LaggedMaxToAll(MeshData<Real> *md, int channel, Real val, Real &last)
+{
+    auto& pars = md->GetMeshPointer()->packages.Get("Reductions")->AllParams();
+    auto *lagged_active = pars.GetMutable<std::vector<int>>("lagged_active");
+    while (lagged_active->size() <= channel) lagged_active->push_back(0);
+
+    const bool had_last = (*lagged_active)[channel];
+    if (had_last) last = CheckOnAll<Real>(md, channel);
+    StartToAll<Real>(md, channel, val, MPI_MAX);
+    (*lagged_active)[channel] = 1;
+    return had_last;
+}
+
+bool Reductions::LaggedSumToAll(MeshData<Real> *md, int channel, const std::vector<int> &val, std::vector<int> &last)
+{
+    auto& pars = md->GetMeshPointer()->packages.Get("Reductions")->AllParams();
+    auto *lagged_active = pars.GetMutable<std::vector<int>>("lagged_vector_int_active");
+    while (lagged_active->size() <= channel) lagged_active->push_back(0);
+
+    const bool had_last = (*lagged_active)[channel];
+    if (had_last) last = CheckOnAll<std::vector<int>>(md, channel);
+    StartToAll<std::vector<int>>(md, channel, val, MPI_SUM);
+    (*lagged_active)[channel] = 1;
+    return had_last;
+}
+
+std::vector<int> Reductions::SampledChecks(MeshData<Real> *md, int stride, int offset)
+{
+    Flag("SampledChecks");
+    constexpr int N = 4;
+
+    // Blocks to check this time around.  Uses gid so coverage rotates over the whole mesh
+    std::vector<int> sampled;
+    for (int b=0; b < md->NumBlocks(); ++b) {
+        if ((md->GetBlockData(b)->GetBlockPointer()->gid + offset) % stride == 0)
+            sampled.push_back(b);
+    }
+    const int n_sampled = sampled.size();
+    std::vector<int> result(N, 0);
+    if (n_sampled == 0) {
+        EndFlag();
+        return result;
+    }
+    auto& pars = md->GetMeshPointer()->packages.Get("Reductions")->AllParams();
+    const auto sampled_blocks = pars.GetMutable<Allocations::PersistentArray<int>>("sampled_blocks")->Set(sampled);
+
+    PackIndexMap prims_map;
+    const auto& P = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    const VarMap m_p(prims_map, false);
+    const auto& cmax = md->PackVariables(std::vector<std::string>{"Flux.cmax"});
+    const auto& cmin = md->PackVariables(std::vector<std::string>{"Flux.cmin"});
+    const int nvar = P.GetDim(4);
+
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    IndexRange ib = pmb0->cellbounds.GetBoundsI(IndexDomain::interior);
+    IndexRange jb = pmb0->cellbounds.GetBoundsJ(IndexDomain::interior);
+    IndexRange kb = pmb0->cellbounds.GetBoundsK(IndexDomain::interior);
+
+    array_type<int, N> counts;
+    pmb0->par_reduce("sampled_checks", 0, n_sampled - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int &bb, const int &k, const int &j, const int &i, array_type<int, N> &local_result) {
+            const int b = sampled_blocks(bb);
+            bool any_nan = false;
+            for (int p=0; p < nvar; ++p) if (P.IsAllocated(b, p)) any_nan |= m::isnan(P(b, p, k, j, i));
+            bool bad_ctop = false;
+            VLOOP {
+                const Real ctop = m::max(cmax(b, v, k, j, i), cmin(b, v, k, j, i));
+                bad_ctop |= (m::isnan(ctop) || ctop <= 0.);
+            }
+            local_result.my_array[0] += any_nan;
+            local_result.my_array[1] += (P(b, m_p.RHO, k, j, i) < 0.);
+            local_result.my_array[2] += (P(b, m_p.UU, k, j, i) < 0.);
+            local_result.my_array[3] += bad_ctop;
+        }
+    , ArraySum<int, HostExecSpace, N>(counts));
+
+    for (int n=0; n < N; ++n) result[n] = counts.my_array[n];
+    EndFlag();
+    return result;
+}
+
+static void PrintCensusHits(Mesh *pmesh, const std::vector<Reductions::FlagField> &fields, IndexDomain domain,
+                            const std::vector<int> &total_flag_counts);
+
+void Reductions::PostExecute(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+    auto& pars = pmesh->packages.Get("Reductions")->AllParams();
+    // Report any flag counts still in flight
+    auto *lazy_reports = pars.GetMutable<std::vector<LazyFlagReport>>("lazy_reports");
+    auto *vector_int_reduce_pool = pars.GetMutable<std::vector<Reduce<std::vector<int>>>>("vector_int_reduce_pool");
+    for (int channel=0; channel < lazy_reports->size(); ++channel) {
+        auto& report = (*lazy_reports)[channel];
+        if (report.pending) {
+            auto& reducer = (*vector_int_reduce_pool)[channel];
+            while (reducer.CheckReduce() == TaskStatus::incomplete);
+            PrintCensusHits(pmesh, report.fields, report.domain, reducer.val);
+            report.pending = false;
+        }
+    }
+
+    auto *lagged_active = pars.GetMutable<std::vector<int>>("lagged_active");
+    auto *allreduce_pool = pars.GetMutable<std::vector<AllReduce<Real>>>("allreduce_pool");
+    for (int channel=0; channel < lagged_active->size(); ++channel) {
+        if ((*lagged_active)[channel]) {
+            while ((*allreduce_pool)[channel].CheckReduce() == TaskStatus::incomplete);
+            (*lagged_active)[channel] = 0;
+        }
+    }
+
+    auto *lagged_vector_int_active = pars.GetMutable<std::vector<int>>("lagged_vector_int_active");
+    auto *vector_int_allreduce_pool = pars.GetMutable<std::vector<AllReduce<std::vector<int>>>>("vector_int_allreduce_pool");
+    for (int channel=0; channel < lagged_vector_int_active->size(); ++channel) {
+        if ((*lagged_vector_int_active)[channel]) {
+            while ((*vector_int_allreduce_pool)[channel].CheckReduce() == TaskStatus::incomplete);
+            (*lagged_vector_int_active)[channel] = 0;
+        }
+    }
+}
+
+ParArray1D<int> Reductions::InnerX1Blocks(MeshData<Real> *md, int &n_inner)
+{
+    std::vector<int> inner;
+    for (int b=0; b < md->NumBlocks(); ++b) {
+        if (md->GetBlockData(b)->GetBlockPointer()->boundary_flag[BoundaryFace::inner_x1] == BoundaryFlag::user)
+            inner.push_back(b);
+    }
+    n_inner = inner.size();
+    auto& pars = md->GetMeshPointer()->packages.Get("Reductions")->AllParams();
+    return pars.GetMutable<Allocations::PersistentArray<int>>("inner_x1_blocks")->Set(inner);
+}
+
 // Flag reductions: local
 int Reductions::CountFlag(MeshData<Real> *md, std::string field_name, const int& flag_val, IndexDomain domain, bool is_bitflag)
 {
@@ -94,11 +463,31 @@ int Reductions::CountFlag(MeshData<Real> *md, std::string field_name, const int&
     return n_flag;
 }
 
+Real Reductions::SumField(MeshData<Real> *md, std::string field_name, IndexDomain domain)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    auto& field = md->PackVariables(std::vector<std::string>{field_name});
+    if (field.GetDim(4) < 1) return 0.;
+
+    IndexRange ib = md->GetBoundsI(domain);
+    IndexRange jb = md->GetBoundsJ(domain);
+    IndexRange kb = md->GetBoundsK(domain);
+    IndexRange block = IndexRange{0, field.GetDim(5) - 1};
+
+    Real total;
+    pmb0->par_reduce("sum_field", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int &b, const int &k, const int &j, const int &i, Real &local_result) {
+            local_result += field(b, 0, k, j, i);
+        }
+    , Kokkos::Sum<Real>(total));
+    return total;
+}
+
 #define MAX_NFLAGS 20
 
 std::vector<int> Reductions::CountFlags(MeshData<Real> *md, std::string field_name, const std::map<int, std::string> &flag_values, IndexDomain domain, bool is_bitflag)
 {
-    Flag("CountFlags_"+field_name);
+    Flag("CountFlags_", field_name);
     auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
 
     // Pack variables
@@ -111,17 +500,16 @@ std::vector<int> Reductions::CountFlags(MeshData<Real> *md, std::string field_na
     IndexRange kb = md->GetBoundsK(domain);
     IndexRange block = IndexRange{0, flag.GetDim(5) - 1};
 
-    // Man, moving arrays is clunky.  Oh well.
+    // The list of flag values is short, so it's captured by value rather than copied to the device
     const int n_of_flags = flag_values.size();
-    ParArray1D<int> flag_val_list("flag_values", MAX_NFLAGS);
-    auto flag_val_list_h = flag_val_list.GetHostMirror();
+    if (n_of_flags + 1 > MAX_NFLAGS)
+        throw std::runtime_error("Too many flags to count together!");
+    Reductions::array_type<int, MAX_NFLAGS> flag_val_list;
     int f=1;
     for (auto &flag : flag_values) {
-        flag_val_list_h[f] = flag.first;
+        flag_val_list.my_array[f] = flag.first;
         f++;
     }
-    flag_val_list.DeepCopy(flag_val_list_h);
-    Kokkos::fence();
 
     // Count all nonzero (technically, >0) values,
     // and all values which match each flag.
@@ -135,9 +523,9 @@ std::vector<int> Reductions::CountFlags(MeshData<Real> *md, std::string field_na
             // First element is total count
             if (flag_int > 0) ++local_result.my_array[0];
             // The rest of the list is individual flags
-            for (int f=1; f < n_of_flags; f++)
-                if ((is_bitflag && flag_int & flag_val_list(f)) ||
-                    (!is_bitflag && flag_int == flag_val_list(f)))
+            for (int f=1; f <= n_of_flags; f++)
+                if ((is_bitflag && flag_int & flag_val_list.my_array[f]) ||
+                    (!is_bitflag && flag_int == flag_val_list.my_array[f]))
                     ++local_result.my_array[f];
         }
     , Reductions::ArraySum<int, HostExecSpace, MAX_NFLAGS>(flag_reducer));
@@ -150,34 +538,201 @@ std::vector<int> Reductions::CountFlags(MeshData<Real> *md, std::string field_na
     return n_each_flag;
 }
 
+#define MAX_FLAG_FIELDS 4
+#define MAX_CENSUS_FLAGS 32
+
+std::vector<std::vector<int>> Reductions::CountFlagFields(MeshData<Real> *md, const std::vector<FlagField> &fields, IndexDomain domain)
+{
+    Flag("CountFlagFields");
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const int n_fields = fields.size();
+    if (n_fields > MAX_FLAG_FIELDS)
+        throw std::runtime_error("Too many flag fields to count together!");
+
+    // Pack all the fields together, and find each in the pack
+    std::vector<std::string> names;
+    for (auto &field : fields) names.push_back(field.name);
+    PackIndexMap flag_map;
+    auto& flags = md->PackVariables(names, flag_map);
+
+    IndexRange ib = md->GetBoundsI(domain);
+    IndexRange jb = md->GetBoundsJ(domain);
+    IndexRange kb = md->GetBoundsK(domain);
+    IndexRange block = IndexRange{0, flags.GetDim(5) - 1};
+
+    // All lists share one reducer: each field's total, followed by its flags, in order.
+    // Per-field info: index in the pack, offset of its total in the reducer, # of flags, bitflag
+    // Both are small, so they're captured by value rather than copied to the device
+    Reductions::array_type<int, 4*MAX_FLAG_FIELDS> field_info;
+    Reductions::array_type<int, MAX_CENSUS_FLAGS> flag_val_list;
+    int offset = 0;
+    for (int n=0; n < n_fields; n++) {
+        field_info.my_array[4*n] = flag_map[fields[n].name].first;
+        field_info.my_array[4*n + 1] = offset;
+        field_info.my_array[4*n + 2] = fields[n].flag_values.size();
+        field_info.my_array[4*n + 3] = fields[n].is_bitflag;
+        if (offset + fields[n].flag_values.size() + 1 > MAX_CENSUS_FLAGS)
+            throw std::runtime_error("Too many flags to count together!");
+        int f = offset + 1;
+        for (auto &flag : fields[n].flag_values) {
+            flag_val_list.my_array[f] = flag.first;
+            f++;
+        }
+        offset = f;
+    }
+
+    // As CountFlags, reading each zone's flags once
+    Reductions::array_type<int, MAX_CENSUS_FLAGS> flag_reducer;
+    pmb0->par_reduce("count_flag_fields", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int &b, const int &k, const int &j, const int &i, 
+                       Reductions::array_type<int, MAX_CENSUS_FLAGS> &local_result) {
+            for (int n=0; n < n_fields; n++) {
+                const int flag_int = static_cast<int>(flags(b, field_info.my_array[4*n], k, j, i));
+                if (flag_int > 0) {
+                    const int off = field_info.my_array[4*n + 1];
+                    const bool is_bitflag = field_info.my_array[4*n + 3];
+                    ++local_result.my_array[off];
+                    for (int f=off + 1; f <= off + field_info.my_array[4*n + 2]; f++)
+                        if ((is_bitflag && flag_int & flag_val_list.my_array[f]) ||
+                            (!is_bitflag && flag_int == flag_val_list.my_array[f]))
+                            ++local_result.my_array[f];
+                }
+            }
+        }
+    , Reductions::ArraySum<int, HostExecSpace, MAX_CENSUS_FLAGS>(flag_reducer));
+
+    std::vector<std::vector<int>> n_each;
+    for (int n=0; n < n_fields; n++) {
+        const int off = field_info.my_array[4*n + 1];
+        n_each.push_back(std::vector<int>(flag_reducer.my_array + off,
+                                          flag_reducer.my_array + off + field_info.my_array[4*n + 2] + 1));
+    }
+
+    EndFlag();
+    return n_each;
+}
+
+std::pair<std::vector<int>, std::vector<int>> Reductions::CountFlagPair(MeshData<Real> *md,
+                        std::string field_a, const std::map<int, std::string> &flag_values_a, bool is_bitflag_a,
+                        std::string field_b, const std::map<int, std::string> &flag_values_b, bool is_bitflag_b,
+                        IndexDomain domain)
+{
+    auto counts = CountFlagFields(md, {FlagField{field_a, flag_values_a, is_bitflag_a},
+                                       FlagField{field_b, flag_values_b, is_bitflag_b}}, domain);
+    return std::make_pair(counts[0], counts[1]);
+}
+
 // Flag reductions: global
+/**
+ * Print the concatenated counts of several fields, as from CountFlagFields
+ */
+static void PrintCensusHits(Mesh *pmesh, const std::vector<Reductions::FlagField> &fields, IndexDomain domain,
+                            const std::vector<int> &total_flag_counts)
+{
+    int offset = 0;
+    for (auto &field : fields) {
+        const int n = field.flag_values.size() + 1;
+        if (offset + n > total_flag_counts.size()) break;
+        Reductions::PrintFlagHits(pmesh, field.name, field.flag_values, domain,
+                                  std::vector<int>(total_flag_counts.begin() + offset, total_flag_counts.begin() + offset + n));
+        offset += n;
+    }
+}
+
+/**
+ * When reporting lazily, finish & report the count last started on 'channel', and record the one about to start
+ */
+static void CycleLazyReport(MeshData<Real> *md, const std::vector<Reductions::FlagField> &fields,
+                            IndexDomain domain, int channel)
+{
+    auto& pars = md->GetMeshPointer()->packages.Get("Reductions")->AllParams();
+    if (!pars.Get<bool>("lazy_flag_reports")) return;
+    auto *lazy_reports = pars.GetMutable<std::vector<Reductions::LazyFlagReport>>("lazy_reports");
+    while (lazy_reports->size() <= channel) lazy_reports->push_back(Reductions::LazyFlagReport());
+    auto& report = (*lazy_reports)[channel];
+    if (report.pending) {
+        auto *vector_int_reduce_pool = pars.GetMutable<std::vector<Reduce<std::vector<int>>>>("vector_int_reduce_pool");
+        auto& reducer = (*vector_int_reduce_pool)[channel];
+        while (reducer.CheckReduce() == TaskStatus::incomplete);
+        PrintCensusHits(md->GetMeshPointer(), report.fields, report.domain, reducer.val);
+    }
+    report = Reductions::LazyFlagReport{fields, domain, true};
+}
+
 void Reductions::StartFlagReduce(MeshData<Real> *md, std::string field_name, const std::map<int, std::string> &flag_values, IndexDomain domain, bool is_bitflag, int channel)
 {
-    Start<std::vector<int>>(md, channel, CountFlags(md, field_name, flag_values, domain, is_bitflag), MPI_SUM);
+    // Count before waiting on anything, so any previous reduction has all the longer to finish
+    auto counts = CountFlags(md, field_name, flag_values, domain, is_bitflag);
+    CycleLazyReport(md, {FlagField{field_name, flag_values, is_bitflag}}, domain, channel);
+    Start<std::vector<int>>(md, channel, counts, MPI_SUM);
 }
 
-std::vector<int> Reductions::CheckFlagReduceAndPrintHits(MeshData<Real> *md, std::string field_name, const std::map<int, std::string> &flag_values,
-                                                     IndexDomain domain, bool is_bitflag, int channel)
+void Reductions::StartFlagPairReduce(MeshData<Real> *md,
+                                     std::string field_a, const std::map<int, std::string> &flag_values_a, bool is_bitflag_a, int channel_a,
+                                     std::string field_b, const std::map<int, std::string> &flag_values_b, bool is_bitflag_b, int channel_b,
+                                     IndexDomain domain)
 {
-    Flag("CheckFlagReduce");
-    const auto& pmesh = md->GetMeshPointer();
-    const auto& verbose = pmesh->packages.Get("Globals")->Param<int>("flag_verbose");
+    auto counts = CountFlagPair(md, field_a, flag_values_a, is_bitflag_a, field_b, flag_values_b, is_bitflag_b, domain);
+    CycleLazyReport(md, {FlagField{field_a, flag_values_a, is_bitflag_a}}, domain, channel_a);
+    CycleLazyReport(md, {FlagField{field_b, flag_values_b, is_bitflag_b}}, domain, channel_b);
+    Start<std::vector<int>>(md, channel_a, counts.first, MPI_SUM);
+    Start<std::vector<int>>(md, channel_b, counts.second, MPI_SUM);
+}
 
-    // Get the relevant reducer and result
+void Reductions::StartFlagCensus(MeshData<Real> *md, const std::vector<FlagField> &fields, IndexDomain domain, int channel)
+{
+    auto counts = CountFlagFields(md, fields, domain);
+    std::vector<int> all_counts;
+    for (auto &field_counts : counts) all_counts.insert(all_counts.end(), field_counts.begin(), field_counts.end());
+    CycleLazyReport(md, fields, domain, channel);
+    Start<std::vector<int>>(md, channel, all_counts, MPI_SUM);
+}
+
+std::vector<std::vector<int>> Reductions::CheckFlagCensusAndPrintHits(MeshData<Real> *md, const std::vector<FlagField> &fields,
+                                                                     IndexDomain domain, int channel)
+{
+    Flag("CheckFlagCensus");
     auto& pars = md->GetMeshPointer()->packages.Get("Reductions")->AllParams();
     auto *vector_int_reduce_pool = pars.GetMutable<std::vector<Reduce<std::vector<int>>>>("vector_int_reduce_pool");
-    auto& vector_int_reduce = (*vector_int_reduce_pool)[channel];
+    auto& reducer = (*vector_int_reduce_pool)[channel];
 
-    while (vector_int_reduce.CheckReduce() == TaskStatus::incomplete);
-    const std::vector<int> &total_flag_counts = vector_int_reduce.val;
+    // See CheckFlagReduceAndPrintHits
+    const bool lazy = pars.Get<bool>("lazy_flag_reports");
+    if (!lazy) {
+        while (reducer.CheckReduce() == TaskStatus::incomplete);
+        PrintCensusHits(md->GetMeshPointer(), fields, domain, reducer.val);
+    }
+
+    // Split the result back up by field
+    std::vector<std::vector<int>> n_each;
+    int offset = 0;
+    for (auto &field : fields) {
+        const int n = field.flag_values.size() + 1;
+        if (offset + n <= reducer.val.size()) {
+            n_each.push_back(std::vector<int>(reducer.val.begin() + offset, reducer.val.begin() + offset + n));
+        } else {
+            n_each.push_back(std::vector<int>(n, 0));
+        }
+        offset += n;
+    }
+
+    EndFlag();
+    return n_each;
+}
+
+void Reductions::PrintFlagHits(Mesh *pmesh, std::string field_name, const std::map<int, std::string> &flag_values,
+                               IndexDomain domain, const std::vector<int> &total_flag_counts)
+{
+    const auto& verbose = pmesh->packages.Get("Globals")->Param<int>("flag_verbose");
 
     // Print flags 
     if (total_flag_counts[0] > 0 && verbose > 0) {
         if (MPIRank0()) {
             // Always our domain size times total number of blocks
-            IndexRange ib = md->GetBoundsI(domain);
-            IndexRange jb = md->GetBoundsJ(domain);
-            IndexRange kb = md->GetBoundsK(domain);
+            auto pmb0 = pmesh->block_list[0];
+            IndexRange ib = pmb0->cellbounds.GetBoundsI(domain);
+            IndexRange jb = pmb0->cellbounds.GetBoundsJ(domain);
+            IndexRange kb = pmb0->cellbounds.GetBoundsK(domain);
             int n_cells = pmesh->nbtotal * (kb.e - kb.s + 1) * (jb.e - jb.s + 1) * (ib.e - ib.s + 1);
 
             int nflags = total_flag_counts[0];
@@ -193,6 +748,31 @@ std::vector<int> Reductions::CheckFlagReduceAndPrintHits(MeshData<Real> *md, std
             }
         }
     }
+}
+
+std::vector<int> Reductions::CheckFlagReduceAndPrintHits(MeshData<Real> *md, std::string field_name, const std::map<int, std::string> &flag_values,
+                                                     IndexDomain domain, bool is_bitflag, int channel)
+{
+    Flag("CheckFlagReduce");
+    const auto& pmesh = md->GetMeshPointer();
+
+    // Get the relevant reducer and result
+    auto& pars = md->GetMeshPointer()->packages.Get("Reductions")->AllParams();
+    auto *vector_int_reduce_pool = pars.GetMutable<std::vector<Reduce<std::vector<int>>>>("vector_int_reduce_pool");
+    auto& vector_int_reduce = (*vector_int_reduce_pool)[channel];
+
+    // Lazily-reported counts are checked & printed when the next one starts.
+    // Return the last completed count instead (zeros if there isn't one yet)
+    if (pars.Get<bool>("lazy_flag_reports")) {
+        EndFlag();
+        if (vector_int_reduce.val.size() == 0) return std::vector<int>(flag_values.size() + 1, 0);
+        return vector_int_reduce.val;
+    }
+
+    while (vector_int_reduce.CheckReduce() == TaskStatus::incomplete);
+    const std::vector<int> &total_flag_counts = vector_int_reduce.val;
+
+    PrintFlagHits(pmesh, field_name, flag_values, domain, total_flag_counts);
 
     EndFlag();
     return total_flag_counts;
@@ -50,6 +50,12 @@ namespace Reductions {
  */
 std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages);
 
+/**
+ * Device list of the indices in md of blocks on the inner X1 domain boundary,
+ * with its length in n_inner.  Used to run EH reductions as a single launch over those blocks.
+ */
+ParArray1D<int> InnerX1Blocks(MeshData<Real> *md, int &n_inner);
+
 /**
  * Perform a reduction using operation 'op' over a spherical shell at the given zone, measured from left side of
  * innermost block in radius.
@@ -59,6 +65,51 @@ std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<P
 template<Var var, typename T>
 T EHReduction(MeshData<Real> *md, UserHistoryOperation op, int zone);
 
+/**
+ * Sum several variables over the same spherical shell as EHReduction, in a single kernel.
+ * Zone quantities shared between variables (e.g. T^1_mu for edot & ldot) are computed once.
+ * Returns the local sums in the order of vars, and optionally starts their MPI sum on
+ * the given channel of the vector<Real> pool.
+ */
+template<Var... vars>
+std::vector<Real> EHReductions(MeshData<Real> *md, int zone, int channel=-1);
+
+/**
+ * Sum several variables over the whole domain in a single kernel, as DomainReduction.
+ */
+template<Var... vars>
+std::vector<Real> DomainReductions(MeshData<Real> *md, int channel=-1);
+
+/**
+ * Profiles of several variables in X1 (or X1 & X2, if nbins2 > 1), binned uniformly in native
+ * coordinates over the mesh, computed in a single kernel and summed over ranks in one MPI reduction
+ * on the given channel of the vector<Real> pool.
+ * Variables including gdet (see includes_gdet) give shell integrals, like EHReduction at each radius.
+ * Anything else gives the shell average, weighted by proper volume.
+ * Returns nvars values per bin, ordered with X1 fastest (bin1 + nbins1*bin2), on rank 0 only.
+ */
+template<Var... vars>
+std::vector<Real> RadialProfiles(MeshData<Real> *md, int nbins1, int nbins2, int channel);
+
+/**
+ * Values of several variables over a plane or a downsampled volume, averaged (by proper volume)
+ * into nbins[0] x nbins[1] x nbins[2] bins uniform in native coordinates over the mesh.
+ * If dir is 1-3, only zones containing the plane X^dir == x0 are included, and that direction
+ * should have a single bin.  If dir is 0, every zone is included.
+ * As RadialProfiles, computed in a single kernel and summed in one MPI reduction on the given
+ * channel of the vector<Real> pool.
+ * Returns nvars values per bin, ordered with X1 fastest, on rank 0 only.
+ */
+template<Var... vars>
+std::vector<Real> Slice(MeshData<Real> *md, int dir, GReal x0, const int nbins[3], int channel);
+
+/**
+ * Write radial profiles of some basic quantities (see Initialize) to the profiles file,
+ * every profiles/dt in simulation time, and planes/downsampled volumes to a slice file
+ * every slices/dt.
+ */
+TaskStatus PostStepDiagnostics(const SimTime& tm, MeshData<Real> *md);
+
 /**
  * Perform a reduction using operation 'op' over a given domain
  * This should be used for all 2D shell sums not around the EH:
@@ -99,6 +150,33 @@ T CheckOnAll(MeshData<Real> *md, int channel);
 template<typename T>
 T Check(MeshData<Real> *md, int channel);
 
+/**
+ * Global maximum lagged by one call, for per-step diagnostics which needn't block the step.
+ * Waits on the maximum started by the previous call on this channel (usually long finished)
+ * of the Real AllReduce pool, and places it in 'last'.  Then starts a maximum of 'val' and returns.
+ * Returns false, leaving 'last' alone, on the first call.
+ */
+bool LaggedMaxToAll(MeshData<Real> *md, int channel, Real val, Real &last);
+/**
+ * As LaggedMaxToAll, for a sum of counts on a channel of the vector<int> AllReduce pool
+ */
+bool LaggedSumToAll(MeshData<Real> *md, int channel, const std::vector<int> &val, std::vector<int> &last);
+
+/**
+ * Cheap version of the extra_checks diagnostics, for production runs:
+ * count zones with any NaN primitive, negative primitive rho, negative primitive u,
+ * and zero or NaN ctop, in that order, in a single kernel.
+ * Only blocks with (gid + offset) % stride == 0 are checked, so that calling with
+ * offset = cycle covers every block once each 'stride' steps.
+ * Returns local counts.
+ */
+std::vector<int> SampledChecks(MeshData<Real> *md, int stride, int offset);
+
+/**
+ * Wait on any reductions left in flight by LaggedMaxToAll or LaggedSumToAll, so MPI can finalize cleanly
+ */
+void PostExecute(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+
 /**
  * Count instances of a particular flag value in the named field.
  * is_bitflag specifies whether multiple flags may be present and will be orthogonal (e.g. FFlag),
@@ -106,6 +184,11 @@ T Check(MeshData<Real> *md, int channel);
  */
 int CountFlag(MeshData<Real> *md, std::string field_name, const int& flag_val, IndexDomain domain, bool is_bitflag);
 
+/**
+ * Sum of a scalar field over the domain, e.g. per-zone iteration counts
+ */
+Real SumField(MeshData<Real> *md, std::string field_name, IndexDomain domain);
+
 /**
  * Count instances of all flags in the named field.
  * is_bitflag specifies whether multiple flags may be present and will be orthogonal (e.g. FFlag),
@@ -113,17 +196,82 @@ int CountFlag(MeshData<Real> *md, std::string field_name, const int& flag_val, I
  */
 std::vector<int> CountFlags(MeshData<Real> *md, std::string field_name, const std::map<int, std::string> &flag_values, IndexDomain domain, bool is_bitflag);
 
+/**
+ * A flag field to be counted alongside others, see CountFlagFields
+ */
+struct FlagField {
+    std::string name;
+    std::map<int, std::string> flag_values;
+    bool is_bitflag;
+};
+
+/**
+ * As CountFlags, for several fields at once, e.g. pflag, fflag & solve_fail.
+ * All fields are read in a single kernel and counted in one reducer.
+ */
+std::vector<std::vector<int>> CountFlagFields(MeshData<Real> *md, const std::vector<FlagField> &fields, IndexDomain domain);
+
+/**
+ * As CountFlags, for two fields at once, e.g. pflag & fflag.  Reads both in a single kernel,
+ * rather than launching a separate reduction over the mesh for each.
+ */
+std::pair<std::vector<int>, std::vector<int>> CountFlagPair(MeshData<Real> *md,
+                        std::string field_a, const std::map<int, std::string> &flag_values_a, bool is_bitflag_a,
+                        std::string field_b, const std::map<int, std::string> &flag_values_b, bool is_bitflag_b,
+                        IndexDomain domain);
+
 /**
  * Determine number of local flags hit with CountFlags, and send the value over MPI reducer 'channel'
  */
 void StartFlagReduce(MeshData<Real> *md, std::string field_name, const std::map<int, std::string> &flag_values, IndexDomain domain, bool is_bitflag, int channel);
 
 /**
- * Check a flag's MPI reduction and print any flags hit
+ * As StartFlagReduce, counting two fields with CountFlagPair and sending each
+ * on its own channel, to be checked separately with CheckFlagReduceAndPrintHits
+ */
+void StartFlagPairReduce(MeshData<Real> *md,
+                         std::string field_a, const std::map<int, std::string> &flag_values_a, bool is_bitflag_a, int channel_a,
+                         std::string field_b, const std::map<int, std::string> &flag_values_b, bool is_bitflag_b, int channel_b,
+                         IndexDomain domain);
+
+/**
+ * Count several fields with CountFlagFields, and send all the counts as one vector over
+ * reducer 'channel', so a single MPI reduction covers every flag field.
+ */
+void StartFlagCensus(MeshData<Real> *md, const std::vector<FlagField> &fields, IndexDomain domain, int channel);
+
+/**
+ * Check a reduction started with StartFlagCensus, print hits for each field,
+ * and return the counts split back up by field.
+ * Lazy reporting works as for CheckFlagReduceAndPrintHits.
+ */
+std::vector<std::vector<int>> CheckFlagCensusAndPrintHits(MeshData<Real> *md, const std::vector<FlagField> &fields,
+                                                          IndexDomain domain, int channel);
+
+/**
+ * Check a flag's MPI reduction and print any flags hit.
+ * With debug/lazy_flag_reports, reductions are instead checked & printed when the next
+ * one on the same channel is started (or at the end of the run), and this returns
+ * the most recent completed counts without waiting.
  */
 std::vector<int> CheckFlagReduceAndPrintHits(MeshData<Real> *md, std::string field_name, const std::map<int, std::string> &flag_values,
                                              IndexDomain domain, bool is_bitflag, int channel);
 
+/**
+ * Print the result of a flag count, as reduced over all ranks
+ */
+void PrintFlagHits(Mesh *pmesh, std::string field_name, const std::map<int, std::string> &flag_values,
+                   IndexDomain domain, const std::vector<int> &total_flag_counts);
+
+/**
+ * A flag count started with debug/lazy_flag_reports, to be printed once it's done
+ */
+struct LazyFlagReport {
+    std::vector<FlagField> fields;
+    IndexDomain domain = IndexDomain::interior;
+    bool pending = false;
+};
+
 } // namespace Reductions
 
 // See the file for why we do this
@@ -141,50 +141,316 @@ T Reductions::EHReduction(MeshData<Real> *md, UserHistoryOperation op, int zone)
     IndexRange ib = pmb0->cellbounds.GetBoundsI(IndexDomain::interior);
     IndexRange jb = pmb0->cellbounds.GetBoundsJ(IndexDomain::interior);
     IndexRange kb = pmb0->cellbounds.GetBoundsK(IndexDomain::interior);
-    IndexRange block = IndexRange{0, U.GetDim(5) - 1};
 
+    // Inner-edge blocks only for speed, all in one launch
+    int n_inner;
+    const auto inner_blocks = InnerX1Blocks(md, n_inner);
     T result(0);
-    int nb = pmesh->GetNumMeshBlocksThisRank();
-    for (int iblock=0; iblock < nb; iblock++) {
-        const auto &pmb = pmesh->block_list[iblock];
-        // Inner-edge blocks only for speed
-        if (pmb->boundary_flag[parthenon::BoundaryFace::inner_x1] == BoundaryFlag::user) {
-            const auto& G = pmb->coords;
-            T block_result;
-            switch(op) {
-            case UserHistoryOperation::sum: {
-                Kokkos::Sum<T> sum_reducer(block_result);
-                pmb->par_reduce("accretion_sum", iblock, iblock, kb.s, kb.e, jb.s, jb.e, ib.s+zone, ib.s+zone,
-                    KOKKOS_LAMBDA (const int &b, const int &k, const int &j, const int &i, T &local_result) {
-                        local_result += reduction_var<var>(REDUCE_FUNCTION_CALL) * G.Dxc<3>(k) * G.Dxc<2>(j);
-                    }
-                , sum_reducer);
-                result += block_result;
-                break;
+    if (n_inner == 0) {
+        EndFlag();
+        return result;
+    }
+    const IndexRange nblock = IndexRange{0, n_inner - 1};
+
+    switch(op) {
+    case UserHistoryOperation::sum: {
+        Kokkos::Sum<T> sum_reducer(result);
+        pmb0->par_reduce("accretion_sum", nblock.s, nblock.e, kb.s, kb.e, jb.s, jb.e, ib.s+zone, ib.s+zone,
+            KOKKOS_LAMBDA (const int &n, const int &k, const int &j, const int &i, T &local_result) {
+                const int b = inner_blocks(n);
+                const auto& G = U.GetCoords(b);
+                local_result += reduction_var<var>(REDUCE_FUNCTION_CALL) * G.Dxc<3>(k) * G.Dxc<2>(j);
             }
-            case UserHistoryOperation::max: {
-                Kokkos::Max<T> max_reducer(block_result);
-                pmb->par_reduce("accretion_sum", iblock, iblock, kb.s, kb.e, jb.s, jb.e, ib.s+zone, ib.s+zone,
-                    KOKKOS_LAMBDA (const int &b, const int &k, const int &j, const int &i, T &local_result) {
-                        const T val = reduction_var<var>(REDUCE_FUNCTION_CALL) * G.Dxc<3>(k) * G.Dxc<2>(j);
-                        if (val > local_result) local_result = val;
-                    }
-                , max_reducer);
-                if (block_result > result) result = block_result;
-                break;
+        , sum_reducer);
+        break;
+    }
+    case UserHistoryOperation::max: {
+        Kokkos::Max<T> max_reducer(result);
+        pmb0->par_reduce("accretion_max", nblock.s, nblock.e, kb.s, kb.e, jb.s, jb.e, ib.s+zone, ib.s+zone,
+            KOKKOS_LAMBDA (const int &n, const int &k, const int &j, const int &i, T &local_result) {
+                const int b = inner_blocks(n);
+                const auto& G = U.GetCoords(b);
+                const T val = reduction_var<var>(REDUCE_FUNCTION_CALL) * G.Dxc<3>(k) * G.Dxc<2>(j);
+                if (val > local_result) local_result = val;
             }
-            case UserHistoryOperation::min: {
-                Kokkos::Min<T> min_reducer(block_result);
-                pmb->par_reduce("accretion_sum", iblock, iblock, kb.s, kb.e, jb.s, jb.e, ib.s+zone, ib.s+zone,
-                    KOKKOS_LAMBDA (const int &b, const int &k, const int &j, const int &i, T &local_result) {
-                        const T val = reduction_var<var>(REDUCE_FUNCTION_CALL) * G.Dxc<3>(k) * G.Dxc<2>(j);
-                        if (val < local_result) local_result = val;
-                    }
-                , min_reducer);
-                if (block_result < result) result = block_result;
-                break;
+        , max_reducer);
+        break;
+    }
+    case UserHistoryOperation::min: {
+        Kokkos::Min<T> min_reducer(result);
+        pmb0->par_reduce("accretion_min", nblock.s, nblock.e, kb.s, kb.e, jb.s, jb.e, ib.s+zone, ib.s+zone,
+            KOKKOS_LAMBDA (const int &n, const int &k, const int &j, const int &i, T &local_result) {
+                const int b = inner_blocks(n);
+                const auto& G = U.GetCoords(b);
+                const T val = reduction_var<var>(REDUCE_FUNCTION_CALL) * G.Dxc<3>(k) * G.Dxc<2>(j);
+                if (val < local_result) local_result = val;
             }
+        , min_reducer);
+        break;
+    }
+    }
+
+    EndFlag();
+    return result;
+}
+
+template<Reductions::Var... vars>
+std::vector<Real> Reductions::EHReductions(MeshData<Real> *md, int zone, int channel)
+{
+    Flag("EHReductions");
+    auto pmesh = md->GetMeshPointer();
+    constexpr int N = sizeof...(vars);
+
+    const auto& pars = pmesh->packages.Get("GRMHD")->AllParams();
+    const Real gam = pars.Get<Real>("gamma");
+    const auto& emhd_params = EMHD::GetEMHDParameters(pmesh->packages);
+
+    PackIndexMap prims_map, cons_map;
+    const auto& P = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    const auto& U = md->PackVariablesAndFluxes(std::vector<MetadataFlag>{Metadata::Conserved}, cons_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+    const auto& cmax = md->PackVariables(std::vector<std::string>{"Flux.cmax"});
+    const auto& cmin = md->PackVariables(std::vector<std::string>{"Flux.cmin"});
+    // Empty unless GRMHD/cache_4vecs is set
+    const auto& D_cache = md->PackVariables(std::vector<std::string>{"fourvecs"});
+
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    IndexRange ib = pmb0->cellbounds.GetBoundsI(IndexDomain::interior);
+    IndexRange jb = pmb0->cellbounds.GetBoundsJ(IndexDomain::interior);
+    IndexRange kb = pmb0->cellbounds.GetBoundsK(IndexDomain::interior);
+
+    int n_inner;
+    const auto inner_blocks = InnerX1Blocks(md, n_inner);
+    // Accumulate in double even if Real is float, see decs.hpp
+    array_type<GReal, N> sums;
+    if (n_inner > 0) {
+        pmb0->par_reduce("accretion_sums", 0, n_inner - 1, kb.s, kb.e, jb.s, jb.e, ib.s+zone, ib.s+zone,
+            KOKKOS_LAMBDA (const int &n, const int &k, const int &j, const int &i, array_type<GReal, N> &local_result) {
+                const int b = inner_blocks(n);
+                const auto& G = U.GetCoords(b);
+                Real vals[N];
+                reduction_vars<vars...>(REDUCE_FUNCTION_CALL, D_cache(b), vals);
+                const GReal dA = G.Dxc<3>(k) * G.Dxc<2>(j);
+                for (int v=0; v < N; v++) local_result.my_array[v] += vals[v] * dA;
             }
+        , ArraySum<GReal, HostExecSpace, N>(sums));
+    }
+
+    std::vector<Real> result(sums.my_array, sums.my_array + N);
+    if (channel >= 0) {
+        Start<std::vector<Real>>(md, channel, result, MPI_SUM);
+    }
+
+    EndFlag();
+    return result;
+}
+
+template<Reductions::Var... vars>
+std::vector<Real> Reductions::DomainReductions(MeshData<Real> *md, int channel)
+{
+    Flag("DomainReductions");
+    auto pmesh = md->GetMeshPointer();
+    constexpr int N = sizeof...(vars);
+
+    const auto& pars = pmesh->packages.Get("GRMHD")->AllParams();
+    const Real gam = pars.Get<Real>("gamma");
+    const auto& emhd_params = EMHD::GetEMHDParameters(pmesh->packages);
+
+    PackIndexMap prims_map, cons_map;
+    const auto& P = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    const auto& U = md->PackVariablesAndFluxes(std::vector<MetadataFlag>{Metadata::Conserved}, cons_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+    const auto& cmax = md->PackVariables(std::vector<std::string>{"Flux.cmax"});
+    const auto& cmin = md->PackVariables(std::vector<std::string>{"Flux.cmin"});
+    // Empty unless GRMHD/cache_4vecs is set
+    const auto& D_cache = md->PackVariables(std::vector<std::string>{"fourvecs"});
+
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    IndexRange ib = pmb0->cellbounds.GetBoundsI(IndexDomain::interior);
+    IndexRange jb = pmb0->cellbounds.GetBoundsJ(IndexDomain::interior);
+    IndexRange kb = pmb0->cellbounds.GetBoundsK(IndexDomain::interior);
+    IndexRange block = IndexRange{0, U.GetDim(5) - 1};
+
+    // Accumulate in double even if Real is float, see decs.hpp
+    array_type<GReal, N> sums;
+    pmb0->par_reduce("domain_sums", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int &b, const int &k, const int &j, const int &i, array_type<GReal, N> &local_result) {
+            const auto& G = U.GetCoords(b);
+            Real vals[N];
+            reduction_vars<vars...>(REDUCE_FUNCTION_CALL, D_cache(b), vals);
+            const GReal dV = G.Dxc<3>(k) * G.Dxc<2>(j) * G.Dxc<1>(i);
+            for (int n=0; n < N; n++) local_result.my_array[n] += vals[n] * dV;
+        }
+    , ArraySum<GReal, HostExecSpace, N>(sums));
+
+    std::vector<Real> result(sums.my_array, sums.my_array + N);
+    if (channel >= 0) {
+        Start<std::vector<Real>>(md, channel, result, MPI_SUM);
+    }
+
+    EndFlag();
+    return result;
+}
+
+template<Reductions::Var... vars>
+std::vector<Real> Reductions::RadialProfiles(MeshData<Real> *md, int nbins1, int nbins2, int channel)
+{
+    Flag("RadialProfiles");
+    auto pmesh = md->GetMeshPointer();
+    constexpr int N = sizeof...(vars);
+    // Each bin holds the sums for each variable, then the proper volume of the bin
+    constexpr int NB = N + 1;
+
+    const auto& pars = pmesh->packages.Get("GRMHD")->AllParams();
+    const Real gam = pars.Get<Real>("gamma");
+    const auto& emhd_params = EMHD::GetEMHDParameters(pmesh->packages);
+
+    PackIndexMap prims_map, cons_map;
+    const auto& P = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    const auto& U = md->PackVariablesAndFluxes(std::vector<MetadataFlag>{Metadata::Conserved}, cons_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+    const auto& cmax = md->PackVariables(std::vector<std::string>{"Flux.cmax"});
+    const auto& cmin = md->PackVariables(std::vector<std::string>{"Flux.cmin"});
+    // Empty unless GRMHD/cache_4vecs is set
+    const auto& D_cache = md->PackVariables(std::vector<std::string>{"fourvecs"});
+
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    IndexRange ib = pmb0->cellbounds.GetBoundsI(IndexDomain::interior);
+    IndexRange jb = pmb0->cellbounds.GetBoundsJ(IndexDomain::interior);
+    IndexRange kb = pmb0->cellbounds.GetBoundsK(IndexDomain::interior);
+    IndexRange block = IndexRange{0, U.GetDim(5) - 1};
+
+    const GReal x1min = pmesh->mesh_size.xmin(X1DIR);
+    const GReal x2min = pmesh->mesh_size.xmin(X2DIR);
+    const GReal dbin1 = (pmesh->mesh_size.xmax(X1DIR) - x1min) / nbins1;
+    const GReal dbin2 = (pmesh->mesh_size.xmax(X2DIR) - x2min) / nbins2;
+    // Shell integrals are per unit width of the binned coordinates
+    const GReal dbin = dbin1 * ((nbins2 > 1) ? dbin2 : 1.);
+
+    // Zones from any block may land in the same bin, so accumulate atomically.
+    // The number of bins is small, so this is still far cheaper than writing a dump
+    const int nbins_all = NB * nbins1 * nbins2;
+    auto& red_pars = pmesh->packages.Get("Reductions")->AllParams();
+    const auto bins = red_pars.GetMutable<Allocations::PersistentArray<Real>>("profile_bins")->Get(nbins_all);
+    const auto bins_used = Kokkos::subview(bins, std::make_pair(0, nbins_all));
+    Kokkos::deep_copy(bins_used, 0.);
+    pmb0->par_for("radial_profiles", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int &b, const int &k, const int &j, const int &i) {
+            const auto& G = U.GetCoords(b);
+            const int bin1 = m::min(m::max(static_cast<int>((G.Xc<1>(i) - x1min) / dbin1), 0), nbins1 - 1);
+            const int bin2 = (nbins2 > 1) ? m::min(m::max(static_cast<int>((G.Xc<2>(j) - x2min) / dbin2), 0), nbins2 - 1) : 0;
+            const int bin = NB * (bin2 * nbins1 + bin1);
+
+            Real vals[N];
+            reduction_vars<vars...>(REDUCE_FUNCTION_CALL, D_cache(b), vals);
+            const bool shell_integral[N] = {includes_gdet<vars>()...};
+            const Real dV = G.Dxc<3>(k) * G.Dxc<2>(j) * G.Dxc<1>(i);
+            const Real gdV = G.gdet(Loci::center, j, i) * dV;
+            for (int v=0; v < N; v++)
+                Kokkos::atomic_add(&bins(bin + v), vals[v] * (shell_integral[v] ? dV : gdV));
+            Kokkos::atomic_add(&bins(bin + N), gdV);
+        }
+    );
+
+    std::vector<Real> bins_h(nbins_all);
+    Kokkos::deep_copy(Kokkos::View<Real*, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>(bins_h.data(), nbins_all), bins_used);
+    Start<std::vector<Real>>(md, channel, bins_h, MPI_SUM);
+    const std::vector<Real> sums = Check<std::vector<Real>>(md, channel);
+
+    // Normalize on the rank holding the result
+    std::vector<Real> result;
+    if (MPIRank0()) {
+        const bool shell_integral[N] = {includes_gdet<vars>()...};
+        result.resize(N * nbins1 * nbins2);
+        for (int bin=0; bin < nbins1 * nbins2; bin++) {
+            const Real vol = sums[NB * bin + N];
+            for (int v=0; v < N; v++) {
+                const Real sum = sums[NB * bin + v];
+                result[N * bin + v] = shell_integral[v] ? sum / dbin : ((vol > 0.) ? sum / vol : 0.);
+            }
+        }
+    }
+
+    EndFlag();
+    return result;
+}
+
+template<Reductions::Var... vars>
+std::vector<Real> Reductions::Slice(MeshData<Real> *md, int dir, GReal x0, const int nbins[3], int channel)
+{
+    Flag("Slice");
+    auto pmesh = md->GetMeshPointer();
+    constexpr int N = sizeof...(vars);
+    // Each bin holds the sums for each variable, then the proper volume of the bin
+    constexpr int NB = N + 1;
+
+    const auto& pars = pmesh->packages.Get("GRMHD")->AllParams();
+    const Real gam = pars.Get<Real>("gamma");
+    const auto& emhd_params = EMHD::GetEMHDParameters(pmesh->packages);
+
+    PackIndexMap prims_map, cons_map;
+    const auto& P = md->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    const auto& U = md->PackVariablesAndFluxes(std::vector<MetadataFlag>{Metadata::Conserved}, cons_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+    const auto& cmax = md->PackVariables(std::vector<std::string>{"Flux.cmax"});
+    const auto& cmin = md->PackVariables(std::vector<std::string>{"Flux.cmin"});
+    // Empty unless GRMHD/cache_4vecs is set
+    const auto& D_cache = md->PackVariables(std::vector<std::string>{"fourvecs"});
+
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    IndexRange ib = pmb0->cellbounds.GetBoundsI(IndexDomain::interior);
+    IndexRange jb = pmb0->cellbounds.GetBoundsJ(IndexDomain::interior);
+    IndexRange kb = pmb0->cellbounds.GetBoundsK(IndexDomain::interior);
+    IndexRange block = IndexRange{0, U.GetDim(5) - 1};
+
+    const int nbins1 = nbins[0], nbins2 = nbins[1], nbins3 = nbins[2];
+    const GReal x1min = pmesh->mesh_size.xmin(X1DIR);
+    const GReal x2min = pmesh->mesh_size.xmin(X2DIR);
+    const GReal x3min = pmesh->mesh_size.xmin(X3DIR);
+    const GReal dbin1 = (pmesh->mesh_size.xmax(X1DIR) - x1min) / nbins1;
+    const GReal dbin2 = (pmesh->mesh_size.xmax(X2DIR) - x2min) / nbins2;
+    const GReal dbin3 = (pmesh->mesh_size.xmax(X3DIR) - x3min) / nbins3;
+
+    // Every zone is visited, but only those in the plane evaluate any variables
+    const int nbins_all = NB * nbins1 * nbins2 * nbins3;
+    auto& red_pars = pmesh->packages.Get("Reductions")->AllParams();
+    const auto bins = red_pars.GetMutable<Allocations::PersistentArray<Real>>("slice_bins")->Get(nbins_all);
+    const auto bins_used = Kokkos::subview(bins, std::make_pair(0, nbins_all));
+    Kokkos::deep_copy(bins_used, 0.);
+    pmb0->par_for("slice", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA (const int &b, const int &k, const int &j, const int &i) {
+            const auto& G = U.GetCoords(b);
+            if ((dir == 1 && !(G.Xf<1>(i) <= x0 && x0 < G.Xf<1>(i+1))) ||
+                (dir == 2 && !(G.Xf<2>(j) <= x0 && x0 < G.Xf<2>(j+1))) ||
+                (dir == 3 && !(G.Xf<3>(k) <= x0 && x0 < G.Xf<3>(k+1)))) return;
+
+            const int bin1 = m::min(m::max(static_cast<int>((G.Xc<1>(i) - x1min) / dbin1), 0), nbins1 - 1);
+            const int bin2 = m::min(m::max(static_cast<int>((G.Xc<2>(j) - x2min) / dbin2), 0), nbins2 - 1);
+            const int bin3 = m::min(m::max(static_cast<int>((G.Xc<3>(k) - x3min) / dbin3), 0), nbins3 - 1);
+            const int bin = NB * ((bin3 * nbins2 + bin2) * nbins1 + bin1);
+
+            Real vals[N];
+            reduction_vars<vars...>(REDUCE_FUNCTION_CALL, D_cache(b), vals);
+            const Real gdV = G.gdet(Loci::center, j, i) * G.Dxc<3>(k) * G.Dxc<2>(j) * G.Dxc<1>(i);
+            for (int v=0; v < N; v++)
+                Kokkos::atomic_add(&bins(bin + v), vals[v] * gdV);
+            Kokkos::atomic_add(&bins(bin + N), gdV);
+        }
+    );
+
+    std::vector<Real> bins_h(nbins_all);
+    Kokkos::deep_copy(Kokkos::View<Real*, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>(bins_h.data(), nbins_all), bins_used);
+    Start<std::vector<Real>>(md, channel, bins_h, MPI_SUM);
+    const std::vector<Real> sums = Check<std::vector<Real>>(md, channel);
+
+    std::vector<Real> result;
+    if (MPIRank0()) {
+        const int nbins_tot = nbins1 * nbins2 * nbins3;
+        result.resize(N * nbins_tot);
+        for (int bin=0; bin < nbins_tot; bin++) {
+            const Real vol = sums[NB * bin + N];
+            for (int v=0; v < N; v++)
+                result[N * bin + v] = (vol > 0.) ? sums[NB * bin + v] / vol : 0.;
         }
     }
 
@@ -113,4 +113,47 @@ struct ArraySum {
   KOKKOS_INLINE_FUNCTION
   bool references_scalar() const { return true; }
 };
+
+// As ArraySum, keeping the maximum of each element instead.
+// Take minima by reducing the negative.
+template <class T, class Space, int N>
+struct ArrayMax {
+ public:
+  // Required
+  typedef ArrayMax reducer;
+  typedef array_type<T, N> value_type;
+  typedef Kokkos::View<value_type*, Space, Kokkos::MemoryUnmanaged>
+      result_view_type;
+
+ private:
+  value_type& value;
+
+ public:
+  KOKKOS_INLINE_FUNCTION
+  ArrayMax(value_type& value_) : value(value_) {}
+
+  // Required
+  KOKKOS_INLINE_FUNCTION
+  void join(value_type& dest, const value_type& src) const {
+    for (int i = 0; i < N; i++) {
+      if (src.my_array[i] > dest.my_array[i]) dest.my_array[i] = src.my_array[i];
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void init(value_type& val) const {
+    for (int i = 0; i < N; i++) {
+      val.my_array[i] = Kokkos::reduction_identity<T>::max();
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  value_type& reference() const { return value; }
+
+  KOKKOS_INLINE_FUNCTION
+  result_view_type view() const { return result_view_type(&value, 1); }
+
+  KOKKOS_INLINE_FUNCTION
+  bool references_scalar() const { return true; }
+};
 }
\ No newline at end of file
@@ -52,7 +52,7 @@ namespace Reductions {
 // Not elegant, but fast & portable.
 // HIPCC doesn't like passing function pointers as we used to do,
 // and it doesn't vectorize anyway. Look forward to more of this pattern in the code
-enum class Var{phi, bsq, gas_pressure, mag_pressure, beta,
+enum class Var{phi, rho, bsq, gas_pressure, mag_pressure, beta, sigma,
                mdot, edot, ldot, mdot_flux, edot_flux, ldot_flux, eht_lum, jet_lum,
                nan_ctop, zero_ctop, neg_rho, neg_u, neg_rhout};
 
@@ -68,6 +68,11 @@ KOKKOS_INLINE_FUNCTION Real reduction_var<Var::phi>(REDUCE_FUNCTION_ARGS)
     return 0.5 * m::abs(U(m_u.B1, k, j, i)); // factor of gdet already in cons.B
 }
 
+template <>
+KOKKOS_INLINE_FUNCTION Real reduction_var<Var::rho>(REDUCE_FUNCTION_ARGS)
+{
+    return P(m_p.RHO, k, j, i);
+}
 template <>
 KOKKOS_INLINE_FUNCTION Real reduction_var<Var::bsq>(REDUCE_FUNCTION_ARGS)
 {
@@ -81,12 +86,26 @@ KOKKOS_INLINE_FUNCTION Real reduction_var<Var::gas_pressure>(REDUCE_FUNCTION_ARG
     return (gam - 1) * P(m_p.UU, k, j, i);
 }
 template <>
+KOKKOS_INLINE_FUNCTION Real reduction_var<Var::mag_pressure>(REDUCE_FUNCTION_ARGS)
+{
+    FourVectors Dtmp;
+    GRMHD::calc_4vecs(G, P, m_p, k, j, i, Loci::center, Dtmp);
+    return 0.5 * dot(Dtmp.bcon, Dtmp.bcov);
+}
+template <>
 KOKKOS_INLINE_FUNCTION Real reduction_var<Var::beta>(REDUCE_FUNCTION_ARGS)
 {
     FourVectors Dtmp;
     GRMHD::calc_4vecs(G, P, m_p, k, j, i, Loci::center, Dtmp);
     return ((gam - 1) * P(m_p.UU, k, j, i))/(0.5*(dot(Dtmp.bcon, Dtmp.bcov) + SMALL));
 }
+template <>
+KOKKOS_INLINE_FUNCTION Real reduction_var<Var::sigma>(REDUCE_FUNCTION_ARGS)
+{
+    FourVectors Dtmp;
+    GRMHD::calc_4vecs(G, P, m_p, k, j, i, Loci::center, Dtmp);
+    return dot(Dtmp.bcon, Dtmp.bcov) / P(m_p.RHO, k, j, i);
+}
 
 // Accretion rates: return a zone's contribution to the surface integral
 // forming each rate measurement.
@@ -137,17 +156,22 @@ KOKKOS_INLINE_FUNCTION Real reduction_var<Var::ldot_flux>(REDUCE_FUNCTION_ARGS)
 }
 
 // Luminosity proxy from (for example) Porth et al 2019.
-template <>
-KOKKOS_INLINE_FUNCTION Real reduction_var<Var::eht_lum>(REDUCE_FUNCTION_ARGS)
+KOKKOS_INLINE_FUNCTION Real eht_lum(const VariablePack<Real>& P, const VarMap& m_p, const FourVectors& D,
+                                    const Real& gam, const int& k, const int& j, const int& i)
 {
-    FourVectors Dtmp;
-    GRMHD::calc_4vecs(G, P, m_p, k, j, i, Loci::center, Dtmp);
     Real rho = P(m_p.RHO, k, j, i);
     Real Pg = (gam - 1.) * P(m_p.UU, k, j, i);
-    Real Bmag = m::sqrt(dot(Dtmp.bcon, Dtmp.bcov));
+    Real Bmag = m::sqrt(dot(D.bcon, D.bcov));
     Real j_eht = rho*rho*rho/Pg/Pg * m::exp(-0.2 * m::cbrt(rho * rho / (Bmag * Pg * Pg)));
     return j_eht;
 }
+template <>
+KOKKOS_INLINE_FUNCTION Real reduction_var<Var::eht_lum>(REDUCE_FUNCTION_ARGS)
+{
+    FourVectors Dtmp;
+    GRMHD::calc_4vecs(G, P, m_p, k, j, i, Loci::center, Dtmp);
+    return eht_lum(P, m_p, Dtmp, gam, k, j, i);
+}
 
 // Example of checking extra conditions before adding local results:
 // sums total jet power only at exactly r=radius, for areas with sig > 1
@@ -247,6 +271,78 @@ KOKKOS_INLINE_FUNCTION Real reduction_var<Var::neg_rho>(REDUCE_FUNCTION_ARGS)
     return is_neg;
 }
 
+/**
+ * Whether a variable is already a zone's contribution to a surface integral (i.e. includes gdet),
+ * like the accretion rates.  Radial profiles of these are shell integrals, rather than averages.
+ */
+template<Var var>
+KOKKOS_INLINE_FUNCTION constexpr bool includes_gdet()
+{
+    return var == Var::phi || var == Var::mdot || var == Var::edot || var == Var::ldot ||
+           var == Var::mdot_flux || var == Var::edot_flux || var == Var::ldot_flux;
+}
+
+/**
+ * Version of reduction_var for fused reductions of several variables (see EHReductions),
+ * taking the four-vectors D and stress-energy column T1 = T^1_mu of the zone, computed
+ * once for all variables that need them.  Variables which don't use them fall through to reduction_var.
+ */
+template<Var var>
+KOKKOS_INLINE_FUNCTION constexpr bool needs_tensor()
+{
+    return var == Var::edot || var == Var::ldot || var == Var::jet_lum;
+}
+template<Var var>
+KOKKOS_INLINE_FUNCTION constexpr bool needs_4vecs()
+{
+    return needs_tensor<var>() || var == Var::bsq || var == Var::mag_pressure || var == Var::beta ||
+           var == Var::sigma || var == Var::eht_lum;
+}
+template<Var var>
+KOKKOS_INLINE_FUNCTION Real reduction_var_fused(REDUCE_FUNCTION_ARGS, const FourVectors& D, const Real T1[GR_DIM])
+{
+    if constexpr (var == Var::bsq) {
+        return dot(D.bcon, D.bcov);
+    } else if constexpr (var == Var::mag_pressure) {
+        return 0.5 * dot(D.bcon, D.bcov);
+    } else if constexpr (var == Var::beta) {
+        return ((gam - 1) * P(m_p.UU, k, j, i))/(0.5*(dot(D.bcon, D.bcov) + SMALL));
+    } else if constexpr (var == Var::sigma) {
+        return dot(D.bcon, D.bcov) / P(m_p.RHO, k, j, i);
+    } else if constexpr (var == Var::eht_lum) {
+        return eht_lum(P, m_p, D, gam, k, j, i);
+    } else if constexpr (var == Var::edot) {
+        return -T1[X0DIR] * G.gdet(Loci::center, j, i);
+    } else if constexpr (var == Var::ldot) {
+        return T1[X3DIR] * G.gdet(Loci::center, j, i);
+    } else if constexpr (var == Var::jet_lum) {
+        return ((dot(D.bcon, D.bcov) / P(m_p.RHO, k, j, i)) > 1.) ? -T1[X0DIR] : 0.;
+    } else {
+        return reduction_var<var>(G, P, m_p, U, m_u, cmax, cmin, emhd_params, gam, k, j, i);
+    }
+}
+
+/**
+ * Evaluate all of vars at a zone into result[0..N-1], in order.
+ * Four-vectors are read from D_cache if it is non-empty, see GRMHD::FillFourVectors
+ */
+template<Var... vars>
+KOKKOS_INLINE_FUNCTION void reduction_vars(REDUCE_FUNCTION_ARGS, const VariablePack<Real>& D_cache,
+                                           Real result[sizeof...(vars)])
+{
+    FourVectors D;
+    Real T1[GR_DIM] = {0};
+    if constexpr ((needs_4vecs<vars>() || ...)) {
+        if (D_cache.GetDim(4) > 0) GRMHD::load_4vecs(D_cache, k, j, i, D);
+        else GRMHD::calc_4vecs(G, P, m_p, k, j, i, Loci::center, D);
+    }
+    if constexpr ((needs_tensor<vars>() || ...)) {
+        Flux::calc_tensor(P, m_p, D, emhd_params, gam, k, j, i, X1DIR, T1);
+    }
+    int n = 0;
+    ((result[n++] = reduction_var_fused<vars>(G, P, m_p, U, m_u, cmax, cmin, emhd_params, gam, k, j, i, D, T1)), ...);
+}
+
 }
 
 #undef REDUCE_FUNCTION_ARGS
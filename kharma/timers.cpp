@@ -0,0 +1,188 @@
+/* 
+ *  File: timers.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2026, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "timers.hpp"
+
+#include "decs.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace Timers {
+
+bool enabled = false;
+
+// Phases in the order they're checked, so e.g. "FixUtoP" is fixup, not UtoP
+static const std::vector<std::pair<std::string, std::vector<std::string>>> phases = {
+    {"fixup", {"fix"}},
+    {"floors", {"floor"}},
+    {"UtoP", {"utop", "u_to_p"}},
+    {"sync", {"sync"}},
+    {"boundaries", {"boundar", "outflow", "checkinflow"}},
+    {"reductions", {"reduc", "census", "countflag"}},
+    {"sources", {"source", "heating", "implicit"}},
+    {"flux", {"flux"}}
+};
+static const int nphases = phases.size();
+
+using clock = std::chrono::steady_clock;
+struct Region {
+    std::string label;
+    int phase;
+    clock::time_point start;
+    std::string kernel;
+};
+struct KernelStats {
+    double time = 0., bytes = 0., flops = 0.;
+    long calls = 0;
+};
+static std::vector<Region> stack;
+static std::map<std::string, std::pair<double, long>> region_times;
+static std::map<std::string, KernelStats> kernel_stats;
+static std::vector<double> phase_times(nphases, 0.);
+static clock::time_point run_start;
+static bool fence = false;
+
+static int PhaseOf(const std::string &label)
+{
+    std::string lower = label;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    for (int i = 0; i < nphases; i++)
+        for (const auto &key : phases[i].second)
+            if (lower.find(key) != std::string::npos) return i;
+    return -1;
+}
+
+void Start(bool use_fence)
+{
+    enabled = true;
+    fence = use_fence;
+    run_start = clock::now();
+}
+
+void Push(const std::string &label)
+{
+    if (fence) Kokkos::fence();
+    stack.push_back({label, PhaseOf(label), clock::now(), ""});
+}
+
+void Pop()
+{
+    // Tolerate an unmatched EndFlag() rather than fail
+    if (stack.empty()) return;
+    if (fence) Kokkos::fence();
+    const Region region = stack.back();
+    stack.pop_back();
+    const double elapsed = std::chrono::duration<double>(clock::now() - region.start).count();
+
+    auto &entry = region_times[region.label];
+    entry.first += elapsed;
+    entry.second++;
+    if (!region.kernel.empty()) kernel_stats[region.kernel].time += elapsed;
+
+    if (region.phase >= 0 && std::none_of(stack.begin(), stack.end(),
+                                          [&](const Region &r) { return r.phase == region.phase; }))
+        phase_times[region.phase] += elapsed;
+}
+
+void CountKernel(const std::string &kernel, double nzones, double bytes_per_zone, double flops_per_zone)
+{
+    if (!enabled || stack.empty()) return;
+    auto &stats = kernel_stats[kernel];
+    stats.bytes += nzones * bytes_per_zone;
+    stats.flops += nzones * flops_per_zone;
+    stats.calls++;
+    stack.back().kernel = kernel;
+}
+
+void Report(int ncycle)
+{
+    std::vector<double> times = phase_times;
+    double wall = std::chrono::duration<double>(clock::now() - run_start).count();
+#ifdef MPI_PARALLEL
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, times.data(), nphases, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD));
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &wall, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD));
+#endif
+    if (!MPIRank0()) return;
+
+    double total = 0.;
+    for (const double t : times) total += t;
+    std::vector<int> order(nphases);
+    for (int i = 0; i < nphases; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return times[a] > times[b]; });
+
+    std::cout << "Timing breakdown at step " << ncycle << ", " << wall << "s wall"
+              << (fence ? "" : " (unfenced: kernel time may land in later regions)") << ":" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    for (const int i : order) {
+        std::cout << "  " << std::left << std::setw(12) << phases[i].first << std::right
+                  << std::setw(12) << times[i] << "s " << std::setw(6) << std::setprecision(1)
+                  << 100. * times[i] / wall << "%" << std::setprecision(3) << std::endl;
+    }
+    // Parthenon's boundary exchange tasks aren't flagged, so most sync time lands here
+    std::cout << "  " << std::left << std::setw(12) << "other" << std::right
+              << std::setw(12) << m::max(wall - total, 0.) << "s (incl. Parthenon boundary exchange, outputs)" << std::endl;
+
+    // Top regions by inclusive time on this rank
+    std::vector<std::pair<std::string, std::pair<double, long>>> sorted(region_times.begin(), region_times.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) { return a.second.first > b.second.first; });
+    const int ntop = m::min((int) sorted.size(), 10);
+    std::cout << "  Most expensive regions on rank 0:" << std::endl;
+    for (int i = 0; i < ntop; i++) {
+        std::cout << "    " << std::left << std::setw(32) << sorted[i].first << std::right
+                  << std::setw(12) << sorted[i].second.first << "s in " << sorted[i].second.second << " calls" << std::endl;
+    }
+
+    // Achieved rates of counted kernels, from the static per-zone estimates
+    if (!kernel_stats.empty()) {
+        std::cout << "  Kernel throughput on rank 0 (estimated bytes & FLOPs):" << std::endl;
+        std::cout << "    " << std::left << std::setw(20) << "kernel" << std::right << std::setw(12) << "time"
+                  << std::setw(10) << "GB/s" << std::setw(10) << "GFLOP/s" << std::setw(10) << "FLOP/B" << std::endl;
+        for (const auto &kernel : kernel_stats) {
+            const KernelStats &st = kernel.second;
+            if (st.time <= 0.) continue;
+            std::cout << "    " << std::left << std::setw(20) << kernel.first << std::right
+                      << std::setw(11) << st.time << "s" << std::setprecision(1)
+                      << std::setw(10) << st.bytes / st.time / 1.e9 << std::setw(10) << st.flops / st.time / 1.e9
+                      << std::setprecision(2) << std::setw(10) << ((st.bytes > 0.) ? st.flops / st.bytes : 0.)
+                      << std::setprecision(3) << std::endl;
+        }
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+}
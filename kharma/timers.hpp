@@ -0,0 +1,80 @@
+/* 
+ *  File: timers.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2026, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <string>
+
+/**
+ * A lightweight registry of wall-clock timers, keyed on the labels passed to Flag()/EndFlag().
+ * Always compiled in and off by default, enabled with debug/timers=true.
+ *
+ * Each region's time is inclusive of the regions inside it.  Regions are also binned into a
+ * few broad phases (flux, sync, UtoP, floors, ...), counting only the outermost region of
+ * each phase so nested calls aren't double-counted.
+ * Kernels launch asynchronously, so set debug/timers_fence=true to fence at each region boundary.
+ * This is accurate, but slows down the overall run.
+ *
+ * Major kernels are also counted with CountKernel(), alongside static estimates of the bytes
+ * they move & FLOPs they perform per zone, to report achieved bandwidth and FLOP rates.
+ */
+namespace Timers {
+
+extern bool enabled;
+
+/**
+ * Start timing regions from now, optionally with a fence at each region boundary
+ */
+void Start(bool use_fence);
+
+/**
+ * Start/stop timing a region. Called from Flag() and EndFlag(), rarely directly
+ */
+void Push(const std::string &label);
+void Pop();
+
+/**
+ * Count a launch of the named kernel over nzones zones, with static estimates of its memory
+ * traffic and FLOPs per zone.  The time of the innermost open region is credited to the kernel,
+ * so it should be the only (or at least the dominant) kernel in that region.
+ * Does nothing unless timers are enabled.
+ */
+void CountKernel(const std::string &kernel, double nzones, double bytes_per_zone, double flops_per_zone);
+
+/**
+ * Print the per-phase breakdown and the most expensive regions, accumulated since the start
+ * of the run.  Takes the MPI maximum over ranks, so must be called on all ranks.
+ */
+void Report(int ncycle);
+
+}
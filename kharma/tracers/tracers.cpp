@@ -0,0 +1,335 @@
+/* 
+ *  File: tracers.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "tracers.hpp"
+
+#include <cstdio>
+
+static constexpr char magic[8] = {'K', 'H', 'A', 'R', 'M', 'A', 'T', 'R'};
+// Fields recorded for each particle after its ID, in order
+static const std::vector<std::string> history_fields = {"X1", "X2", "X3", "rho", "u"};
+
+std::shared_ptr<KHARMAPackage> Tracers::Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages)
+{
+    auto pkg = std::make_shared<KHARMAPackage>("Tracers");
+    Params &params = pkg->AllParams();
+
+    // Options
+    // Particles seeded in each block, uniformly in native coordinates
+    int per_block = pin->GetOrAddInteger("tracers", "per_block", 64);
+    params.Add("per_block", per_block);
+    // Don't seed particles where the fluid is (probably) just floors
+    Real rho_min = pin->GetOrAddReal("tracers", "rho_min", 0.);
+    params.Add("rho_min", rho_min);
+    int seed = pin->GetOrAddInteger("tracers", "seed", 31337);
+    params.Add("seed", seed);
+    // Interval between history records in simulation time.  Records every step if <= 0
+    Real dt = pin->GetOrAddReal("tracers", "dt", 1.);
+    params.Add("dt", dt);
+    // Histories are <file>.<rank>.bin
+    std::string file = pin->GetOrAddString("tracers", "file", "tracers");
+    params.Add("file", file);
+
+    // Particles crossing a spherical pole come out the other side, at phi + pi if the mesh covers all of phi
+    const bool spherical = pin->GetBoolean("coordinates", "spherical");
+    params.Add("spherical", spherical);
+    const Real x3_range = pin->GetReal("parthenon/mesh", "x3max") - pin->GetReal("parthenon/mesh", "x3min");
+    params.Add("phi_shift", (spherical && m::abs(x3_range - 2*M_PI) < 1.e-6) ? (Real) M_PI : (Real) 0.);
+
+    // State
+    params.Add("seeded", false, true);
+    params.Add("next_time", (Real) 0., true);
+
+    // The swarm.  Positions x, y, z are in native coordinates X1, X2, X3
+    Metadata swarm_metadata({Metadata::Provides, Metadata::None});
+    pkg->AddSwarm("tracers", swarm_metadata);
+    Metadata real_swarmvalue_metadata({Metadata::Real});
+    pkg->AddSwarmValue("rho", "tracers", real_swarmvalue_metadata);
+    pkg->AddSwarmValue("u", "tracers", real_swarmvalue_metadata);
+    pkg->AddSwarmValue("id", "tracers", Metadata({Metadata::Integer}));
+
+    pkg->PreStepWork = Tracers::PreStepWork;
+    pkg->PostStepWork = Tracers::PostStepWork;
+
+    return pkg;
+}
+
+// Seed tracers/per_block particles at random in a block's interior
+static void SeedBlock(MeshBlock *pmb)
+{
+    auto rc = pmb->meshblock_data.Get();
+    auto swarm = rc->GetSwarmData()->Get("tracers");
+    const auto& pars = pmb->packages.Get("Tracers")->AllParams();
+    const int per_block = pars.Get<int>("per_block");
+    const Real rho_min = pars.Get<Real>("rho_min");
+    const uint64_t seed = pars.Get<int>("seed");
+    const int gid = pmb->gid;
+
+    PackIndexMap prims_map;
+    auto P = rc->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    const VarMap m_p(prims_map, false);
+    const auto& G = pmb->coords;
+    const IndexRange ib = pmb->cellbounds.GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = pmb->cellbounds.GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = pmb->cellbounds.GetBoundsK(IndexDomain::interior);
+    const IndexRange ib_e = pmb->cellbounds.GetBoundsI(IndexDomain::entire);
+    const IndexRange jb_e = pmb->cellbounds.GetBoundsJ(IndexDomain::entire);
+    const IndexRange kb_e = pmb->cellbounds.GetBoundsK(IndexDomain::entire);
+
+    auto new_particles = swarm->AddEmptyParticles(per_block);
+    auto &x = swarm->Get<Real>("x").Get();
+    auto &y = swarm->Get<Real>("y").Get();
+    auto &z = swarm->Get<Real>("z").Get();
+    auto &rho = swarm->Get<Real>("rho").Get();
+    auto &u = swarm->Get<Real>("u").Get();
+    auto &id = swarm->Get<int>("id").Get();
+    auto swarm_d = swarm->GetDeviceContext();
+    pmb->par_for("tracers_seed", 0, new_particles.GetNewParticlesMaxIndex(),
+        KOKKOS_LAMBDA (const int &new_n) {
+            const int n = new_particles.GetNewParticleIndex(new_n);
+            // splitmix64 of the seed, block & particle, as in DrivingModes
+            uint64_t s = seed + 0x9E3779B97F4A7C15ull * ((uint64_t) gid * per_block + new_n + 1);
+            s = (s ^ (s >> 30)) * 0xBF58476D1CE4E5B9ull;
+            s = (s ^ (s >> 27)) * 0x94D049BB133111EBull;
+            s = s ^ (s >> 31);
+            Kokkos::Random_XorShift64<DevExecSpace> rgen(s);
+
+            Real X[GR_DIM];
+            X[0] = 0.;
+            X[1] = G.Xf<1>(ib.s) + rgen.drand() * (G.Xf<1>(ib.e + 1) - G.Xf<1>(ib.s));
+            X[2] = G.Xf<2>(jb.s) + rgen.drand() * (G.Xf<2>(jb.e + 1) - G.Xf<2>(jb.s));
+            X[3] = G.Xf<3>(kb.s) + rgen.drand() * (G.Xf<3>(kb.e + 1) - G.Xf<3>(kb.s));
+            x(n) = X[1]; y(n) = X[2]; z(n) = X[3];
+            id(n) = gid * per_block + new_n;
+
+            Real vel[NVEC];
+            const Tracers::Stencil st = Tracers::get_stencil(G, X, ib, jb, kb, ib_e, jb_e, kb_e);
+            Tracers::interp_fluid(G, P, m_p, st, vel, rho(n), u(n));
+            if (rho(n) < rho_min) swarm_d.MarkParticleForRemoval(n);
+        }
+    );
+    swarm->RemoveMarkedParticles();
+}
+
+void Tracers::PreStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+    auto &params = pmesh->packages.Get("Tracers")->AllParams();
+    if (params.Get<bool>("seeded")) return;
+    params.Update<bool>("seeded", true);
+
+    // Only seed fresh runs: restarts may have brought their particles along
+    int nactive = 0;
+    for (auto &pmb : pmesh->block_list)
+        nactive += pmb->meshblock_data.Get()->GetSwarmData()->Get("tracers")->GetNumActive();
+#ifdef MPI_PARALLEL
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &nactive, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD));
+#endif
+    if (nactive > 0) return;
+
+    Flag("SeedTracers");
+    for (auto &pmb : pmesh->block_list) SeedBlock(pmb.get());
+    EndFlag();
+    // Start the histories with the end of this first step
+    params.Update<Real>("next_time", tm.time);
+}
+
+TaskStatus Tracers::PushBlock(MeshBlock *pmb, const Real dt)
+{
+    auto rc = pmb->meshblock_data.Get();
+    auto swarm = rc->GetSwarmData()->Get("tracers");
+    if (swarm->GetNumActive() == 0) return TaskStatus::complete;
+    const auto& pars = pmb->packages.Get("Tracers")->AllParams();
+    const bool spherical = pars.Get<bool>("spherical");
+    const Real phi_shift = pars.Get<Real>("phi_shift");
+
+    PackIndexMap prims_map;
+    auto P = rc->PackVariables(std::vector<MetadataFlag>{Metadata::GetUserFlag("Primitive")}, prims_map);
+    const VarMap m_p(prims_map, false);
+    const auto& G = pmb->coords;
+    const IndexRange ib = pmb->cellbounds.GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = pmb->cellbounds.GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = pmb->cellbounds.GetBoundsK(IndexDomain::interior);
+    const IndexRange ib_e = pmb->cellbounds.GetBoundsI(IndexDomain::entire);
+    const IndexRange jb_e = pmb->cellbounds.GetBoundsJ(IndexDomain::entire);
+    const IndexRange kb_e = pmb->cellbounds.GetBoundsK(IndexDomain::entire);
+
+    // Domain edges on this block which aren't periodic, i.e. KHARMA's "user" boundaries
+    const auto& msize = pmb->pmy_mesh->mesh_size;
+    const GReal x1min = msize.xmin(X1DIR), x1max = msize.xmax(X1DIR);
+    const GReal x2min = msize.xmin(X2DIR), x2max = msize.xmax(X2DIR);
+    const GReal x3min = msize.xmin(X3DIR), x3max = msize.xmax(X3DIR);
+    const bool edge_ix1 = pmb->boundary_flag[BoundaryFace::inner_x1] == BoundaryFlag::user;
+    const bool edge_ox1 = pmb->boundary_flag[BoundaryFace::outer_x1] == BoundaryFlag::user;
+    const bool edge_ix2 = pmb->boundary_flag[BoundaryFace::inner_x2] == BoundaryFlag::user;
+    const bool edge_ox2 = pmb->boundary_flag[BoundaryFace::outer_x2] == BoundaryFlag::user;
+    const bool edge_ix3 = pmb->boundary_flag[BoundaryFace::inner_x3] == BoundaryFlag::user;
+    const bool edge_ox3 = pmb->boundary_flag[BoundaryFace::outer_x3] == BoundaryFlag::user;
+
+    auto &x = swarm->Get<Real>("x").Get();
+    auto &y = swarm->Get<Real>("y").Get();
+    auto &z = swarm->Get<Real>("z").Get();
+    auto &rho = swarm->Get<Real>("rho").Get();
+    auto &u = swarm->Get<Real>("u").Get();
+    auto swarm_d = swarm->GetDeviceContext();
+    pmb->par_for("tracers_push", 0, swarm->GetMaxActiveIndex(),
+        KOKKOS_LAMBDA (const int &n) {
+            if (!swarm_d.IsActive(n)) return;
+            Real X[GR_DIM] = {0., x(n), y(n), z(n)};
+            Real vel[NVEC], rho_p, u_p;
+
+            // Midpoint rule, with the fluid state at the end of the step.
+            // The half step stays within a zone of the block, so the ghost zones cover it
+            Tracers::interp_fluid(G, P, m_p, Tracers::get_stencil(G, X, ib, jb, kb, ib_e, jb_e, kb_e), vel, rho_p, u_p);
+            Real Xh[GR_DIM];
+            Xh[0] = 0.;
+            VLOOP Xh[v+1] = X[v+1] + 0.5 * dt * vel[v];
+            Tracers::interp_fluid(G, P, m_p, Tracers::get_stencil(G, Xh, ib, jb, kb, ib_e, jb_e, kb_e), vel, rho_p, u_p);
+            VLOOP X[v+1] += dt * vel[v];
+
+            // Leaving the domain: through the poles of a spherical grid, reflect.  Otherwise remove
+            bool remove = (edge_ix1 && X[1] < x1min) || (edge_ox1 && X[1] > x1max) ||
+                          (edge_ix3 && X[3] < x3min) || (edge_ox3 && X[3] > x3max);
+            const bool past_ix2 = edge_ix2 && X[2] < x2min, past_ox2 = edge_ox2 && X[2] > x2max;
+            if (past_ix2 || past_ox2) {
+                if (spherical) {
+                    X[2] = past_ix2 ? 2*x2min - X[2] : 2*x2max - X[2];
+                    X[3] += phi_shift;
+                    if (phi_shift > 0. && X[3] >= x3max) X[3] -= x3max - x3min;
+                } else {
+                    remove = true;
+                }
+            }
+            if (remove) {
+                swarm_d.MarkParticleForRemoval(n);
+                return;
+            }
+            x(n) = X[1]; y(n) = X[2]; z(n) = X[3];
+
+            // Record the fluid state at the new position
+            Tracers::interp_fluid(G, P, m_p, Tracers::get_stencil(G, X, ib, jb, kb, ib_e, jb_e, kb_e), vel, rho(n), u(n));
+
+            bool on_current_mesh_block = true;
+            swarm_d.GetNeighborBlockIndex(n, x(n), y(n), z(n), on_current_mesh_block);
+        }
+    );
+    swarm->RemoveMarkedParticles();
+
+    return TaskStatus::complete;
+}
+
+void Tracers::SwarmDomainBoundary(std::shared_ptr<Swarm> &swarm) {}
+
+void Tracers::PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
+{
+    auto &params = pmesh->packages.Get("Tracers")->AllParams();
+
+    Flag("AdvectTracers");
+    // Launch every block's push before communicating, no fences needed in between
+    for (auto &pmb : pmesh->block_list) PushBlock(pmb.get(), tm.dt);
+
+    // Zone-crossing time bounds the step, so particles move at most one block per step,
+    // and a single exchange finds all of them homes
+    for (auto &pmb : pmesh->block_list)
+        pmb->meshblock_data.Get()->GetSwarmData()->Send(BoundaryCommSubset::all);
+    bool received = false;
+    while (!received) {
+        received = true;
+        for (auto &pmb : pmesh->block_list)
+            received &= (pmb->meshblock_data.Get()->GetSwarmData()->Receive(BoundaryCommSubset::all) == TaskStatus::complete);
+    }
+    EndFlag();
+
+    // tm.time is incremented after this call
+    const Real time = tm.time + tm.dt;
+    const Real dt = params.Get<Real>("dt");
+    if (time >= params.Get<Real>("next_time")) {
+        if (dt > 0.) params.Update<Real>("next_time", (m::floor(time / dt) + 1) * dt);
+        WriteHistory(pmesh, time);
+    }
+}
+
+void Tracers::WriteHistory(Mesh *pmesh, const Real time)
+{
+    Flag("WriteTracerHistory");
+    const auto& pars = pmesh->packages.Get("Tracers")->AllParams();
+    const std::string fname = pars.Get<std::string>("file") + "." + std::to_string(MPIRank()) + ".bin";
+
+    // Gather each block's active particles on host, in the record layout: ID, then the history fields
+    std::vector<int> ids;
+    std::vector<Real> fields;
+    const int nfields = history_fields.size();
+    for (auto &pmb : pmesh->block_list) {
+        auto swarm = pmb->meshblock_data.Get()->GetSwarmData()->Get("tracers");
+        if (swarm->GetNumActive() == 0) continue;
+        const int nmax = swarm->GetMaxActiveIndex() + 1;
+        auto swarm_d = swarm->GetDeviceContext();
+        ParArray1D<int> active("tracers_active", nmax);
+        pmb->par_for("tracers_active", 0, nmax - 1,
+            KOKKOS_LAMBDA (const int &n) {
+                active(n) = swarm_d.IsActive(n);
+            }
+        );
+        auto active_h = active.GetHostMirrorAndCopy();
+        auto id_h = swarm->Get<int>("id").Get().GetHostMirrorAndCopy();
+        std::vector<decltype(swarm->Get<Real>("x").Get().GetHostMirrorAndCopy())> vals;
+        for (auto& name : {"x", "y", "z", "rho", "u"})
+            vals.push_back(swarm->Get<Real>(name).Get().GetHostMirrorAndCopy());
+        for (int n = 0; n < nmax; n++) {
+            if (!active_h(n)) continue;
+            ids.push_back(id_h(n));
+            for (int f = 0; f < nfields; f++) fields.push_back(vals[f](n));
+        }
+    }
+
+    FILE *fp = fopen(fname.c_str(), "ab");
+    if (fp == nullptr) throw std::runtime_error("Could not open tracer history file "+fname);
+    if (ftell(fp) == 0) {
+        fwrite(magic, sizeof(char), 8, fp);
+        fwrite(&nfields, sizeof(int), 1, fp);
+        for (auto& name : history_fields) {
+            const int len = name.size();
+            fwrite(&len, sizeof(int), 1, fp);
+            fwrite(name.c_str(), sizeof(char), len, fp);
+        }
+    }
+    const double t = time;
+    const int n = ids.size();
+    fwrite(&t, sizeof(double), 1, fp);
+    fwrite(&n, sizeof(int), 1, fp);
+    for (int p = 0; p < n; p++) {
+        fwrite(&ids[p], sizeof(int), 1, fp);
+        fwrite(&fields[p * nfields], sizeof(Real), nfields, fp);
+    }
+    fclose(fp);
+    EndFlag();
+}
@@ -0,0 +1,149 @@
+/* 
+ *  File: tracers.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+#include "grmhd_functions.hpp"
+#include "types.hpp"
+
+#include <parthenon/parthenon.hpp>
+
+/**
+ * Passive Lagrangian tracer particles, carried on device as a Parthenon swarm "tracers".
+ *
+ * Each step, every particle is moved with the coordinate velocity dx^i/dt = u^i/u^0 of the fluid,
+ * trilinearly interpolated from zone centers (midpoint rule, field frozen over the step).
+ * Particles crossing a block face are migrated with Parthenon's swarm communication; those leaving
+ * through a radial or other non-periodic face are removed, and those crossing a spherical pole
+ * are reflected to the other side.
+ *
+ * Every tracers/dt, each rank appends the ID, position and interpolated rho, u of its particles
+ * to its own raw binary history <tracers/file>.<rank>.bin:
+ *   header: 'KHARMATR', int nfields, nfields*(int length, name)
+ *   then per record: double time, int n, n*(int id, nfields*Real)
+ * so thermodynamic histories needn't be reconstructed from full dumps.
+ *
+ * tracers/per_block particles are seeded at random in each block when a run starts with none,
+ * skipping zones with rho < tracers/rho_min.
+ */
+namespace Tracers {
+
+/**
+ * Initialize the tracers package, loaded if tracers/on is set
+ */
+std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages);
+
+/**
+ * Seed particles on the first step, if the mesh doesn't have any yet
+ */
+void PreStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+
+/**
+ * Advect all particles through the step just taken, migrate them, and record their histories if due
+ */
+void PostStepWork(Mesh *pmesh, ParameterInput *pin, const SimTime &tm);
+
+/**
+ * Move each particle on a block, and mark any leaving it for communication
+ */
+TaskStatus PushBlock(MeshBlock *pmb, const Real dt);
+
+/**
+ * Swarm boundary condition for KHARMA's "user" faces.  Particles leaving the domain are already
+ * removed or reflected in PushBlock, so this has nothing left to do
+ */
+void SwarmDomainBoundary(std::shared_ptr<Swarm> &swarm);
+
+/**
+ * Append a record of every local particle to this rank's history file
+ */
+void WriteHistory(Mesh *pmesh, const Real time);
+
+/**
+ * Indices & weights of the 8 zone centers around a position, trilinear in native coordinates.
+ * Positions within the ghost zones are valid, as are degenerate (2D/1D) directions
+ */
+struct Stencil {
+    int i[2], j[2], k[2];
+    Real wi[2], wj[2], wk[2];
+};
+KOKKOS_INLINE_FUNCTION void stencil_1d(const Real x, const Real xf0, const Real dx, const int is,
+                                       const int s, const int e, int idx[2], Real w[2])
+{
+    if (s == e) {
+        idx[0] = idx[1] = s;
+        w[0] = 1.; w[1] = 0.;
+        return;
+    }
+    // Fractional index, counting from the first zone center
+    const Real fi = (x - xf0) / dx - 0.5 + is;
+    const int i0 = clip((int) m::floor(fi), s, e - 1);
+    const Real frac = clip(fi - i0, 0., 1.);
+    idx[0] = i0; idx[1] = i0 + 1;
+    w[0] = 1. - frac; w[1] = frac;
+}
+KOKKOS_INLINE_FUNCTION Stencil get_stencil(const GRCoordinates& G, const Real X[GR_DIM],
+                                           const IndexRange& ib, const IndexRange& jb, const IndexRange& kb,
+                                           const IndexRange& ib_e, const IndexRange& jb_e, const IndexRange& kb_e)
+{
+    Stencil s;
+    stencil_1d(X[1], G.Xf<1>(ib.s), G.Dxc<1>(ib.s), ib.s, ib_e.s, ib_e.e, s.i, s.wi);
+    stencil_1d(X[2], G.Xf<2>(jb.s), G.Dxc<2>(jb.s), jb.s, jb_e.s, jb_e.e, s.j, s.wj);
+    stencil_1d(X[3], G.Xf<3>(kb.s), G.Dxc<3>(kb.s), kb.s, kb_e.s, kb_e.e, s.k, s.wk);
+    return s;
+}
+
+/**
+ * Interpolated coordinate velocity dx^i/dt, and rho, u, at a position
+ */
+template<typename Global>
+KOKKOS_INLINE_FUNCTION void interp_fluid(const GRCoordinates& G, const Global& P, const VarMap& m_p, const Stencil& s,
+                                         Real vel[NVEC], Real& rho, Real& u)
+{
+    VLOOP vel[v] = 0.;
+    rho = 0.; u = 0.;
+    for (int c = 0; c < 8; c++) {
+        const int a = c & 1, b = (c >> 1) & 1, d = (c >> 2) & 1;
+        const Real w = s.wi[a] * s.wj[b] * s.wk[d];
+        if (w == 0.) continue;
+        const int i = s.i[a], j = s.j[b], k = s.k[d];
+        Real ucon[GR_DIM];
+        GRMHD::calc_ucon(G, P, m_p, k, j, i, Loci::center, ucon);
+        VLOOP vel[v] += w * ucon[v+1] / ucon[0];
+        rho += w * P(m_p.RHO, k, j, i);
+        u += w * P(m_p.UU, k, j, i);
+    }
+}
+
+}
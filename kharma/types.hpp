@@ -38,6 +38,8 @@
 #include "boundaries/boundary_types.hpp"
 #include "kharma_package.hpp"
 #include "reductions/reductions_types.hpp"
+#include "allocations.hpp"
+#include "timers.hpp"
 
 #include <parthenon/parthenon.hpp>
 
@@ -125,6 +127,12 @@ class VarMap {
         int8_t PSI, Q, DP;
         // Total struct size ~20 bytes, < 1 vector of 4 doubles
 
+        // Empty map, for containers which fill it in later (e.g. Flux::FluxPacks)
+        VarMap() : RHO(-1), UU(-1), U1(-1), U2(-1), U3(-1), B1(-1), B2(-1), B3(-1), Bf1(-1), Bf2(-1), Bf3(-1),
+                   RHO_ADDED(-1), UU_ADDED(-1), PASSIVE(-1),
+                   KTOT(-1), K_CONSTANT(-1), K_HOWES(-1), K_KAWAZURA(-1), K_WERNER(-1), K_ROWAN(-1), K_SHARMA(-1),
+                   PSI(-1), Q(-1), DP(-1) {}
+
         VarMap(parthenon::PackIndexMap& name_map, bool is_cons)
         {
             if (is_cons) {
@@ -141,12 +149,13 @@ class VarMap {
                 UU_ADDED = name_map["cons.u_added"].first;
                 // Electrons
                 KTOT = name_map["cons.Ktot"].first;
-                K_CONSTANT = name_map["cons.Kel_Constant"].first;
-                K_HOWES = name_map["cons.Kel_Howes"].first;
-                K_KAWAZURA = name_map["cons.Kel_Kawazura"].first;
-                K_WERNER = name_map["cons.Kel_Werner"].first;
-                K_ROWAN = name_map["cons.Kel_Rowan"].first;
-                K_SHARMA = name_map["cons.Kel_Sharma"].first;
+                // Sparse electrons are named by model number instead, see Electrons::Initialize
+                K_CONSTANT = std::max(name_map["cons.Kel_Constant"].first, name_map["cons.Kel_0"].first);
+                K_HOWES = std::max(name_map["cons.Kel_Howes"].first, name_map["cons.Kel_1"].first);
+                K_KAWAZURA = std::max(name_map["cons.Kel_Kawazura"].first, name_map["cons.Kel_2"].first);
+                K_WERNER = std::max(name_map["cons.Kel_Werner"].first, name_map["cons.Kel_3"].first);
+                K_ROWAN = std::max(name_map["cons.Kel_Rowan"].first, name_map["cons.Kel_4"].first);
+                K_SHARMA = std::max(name_map["cons.Kel_Sharma"].first, name_map["cons.Kel_5"].first);
                 // Extended MHD
                 Q = name_map["cons.q"].first;
                 DP = name_map["cons.dP"].first;
@@ -164,12 +173,13 @@ class VarMap {
                 UU_ADDED = name_map["prims.u_added"].first;
                 // Electrons
                 KTOT = name_map["prims.Ktot"].first;
-                K_CONSTANT = name_map["prims.Kel_Constant"].first;
-                K_HOWES = name_map["prims.Kel_Howes"].first;
-                K_KAWAZURA = name_map["prims.Kel_Kawazura"].first;
-                K_WERNER = name_map["prims.Kel_Werner"].first;
-                K_ROWAN = name_map["prims.Kel_Rowan"].first;
-                K_SHARMA = name_map["prims.Kel_Sharma"].first;
+                // Sparse electrons are named by model number instead, see Electrons::Initialize
+                K_CONSTANT = std::max(name_map["prims.Kel_Constant"].first, name_map["prims.Kel_0"].first);
+                K_HOWES = std::max(name_map["prims.Kel_Howes"].first, name_map["prims.Kel_1"].first);
+                K_KAWAZURA = std::max(name_map["prims.Kel_Kawazura"].first, name_map["prims.Kel_2"].first);
+                K_WERNER = std::max(name_map["prims.Kel_Werner"].first, name_map["prims.Kel_3"].first);
+                K_ROWAN = std::max(name_map["prims.Kel_Rowan"].first, name_map["prims.Kel_4"].first);
+                K_SHARMA = std::max(name_map["prims.Kel_Sharma"].first, name_map["prims.Kel_5"].first);
                 // Extended MHD
                 Q = name_map["prims.q"].first;
                 DP = name_map["prims.dP"].first;
@@ -206,6 +216,75 @@ class VarMap {
         }
 };
 
+/**
+ * Whether variable p of pack q is present (p >= 0, as from a VarMap) and allocated.  Only sparse fields
+ * (see electrons/sparse) are ever unallocated, so anything else, e.g. scratch memory, just checks presence
+ */
+template<typename T>
+KOKKOS_FORCEINLINE_FUNCTION bool var_allocated(const T& q, const int& p) { return p >= 0; }
+KOKKOS_FORCEINLINE_FUNCTION bool var_allocated(const VariablePack<Real>& q, const int& p) { return p >= 0 && q.IsAllocated(p); }
+KOKKOS_FORCEINLINE_FUNCTION bool var_allocated(const VariableFluxPack<Real>& q, const int& p) { return p >= 0 && q.IsAllocated(p); }
+
+/**
+ * One zone of a VariablePack, indexed by variable alone like a subview of scratch memory.
+ * This lets the zone-local ("Local") device functions work straight from global memory,
+ * in kernels flattened over zones.  Only for dense packs, e.g. the Flux.Pl/Pr face states
+ */
+struct PackZone {
+    const VariablePack<Real>& q;
+    const int k, j, i;
+    KOKKOS_FORCEINLINE_FUNCTION Real& operator()(const int& p) const { return q(p, k, j, i); }
+};
+
+/**
+ * Compile-time version of VarMap, for the few common variable layouts.
+ * Members carry the same names as VarMap's, so device functions templated on the map type
+ * take either, and with one of these the index arithmetic & checks for loaded packages
+ * fold away.  Only use one after checking Matches() against the runtime VarMap, see MatchLayout
+ */
+template<int8_t rho, int8_t uu, int8_t u1, int8_t b1, int8_t q=-1, int8_t dp=-1>
+struct StaticVarMap {
+    static constexpr int8_t RHO = rho, UU = uu, U1 = u1, U2 = u1 + 1, U3 = u1 + 2;
+    static constexpr int8_t B1 = b1, B2 = (b1 >= 0) ? b1 + 1 : -1, B3 = (b1 >= 0) ? b1 + 2 : -1;
+    static constexpr int8_t Bf1 = -1, Bf2 = -1, Bf3 = -1;
+    static constexpr int8_t RHO_ADDED = -1, UU_ADDED = -1, PASSIVE = -1;
+    static constexpr int8_t KTOT = -1, K_CONSTANT = -1, K_HOWES = -1, K_KAWAZURA = -1,
+                            K_WERNER = -1, K_ROWAN = -1, K_SHARMA = -1;
+    static constexpr int8_t PSI = -1, Q = q, DP = dp;
+
+    static bool Matches(const VarMap& m)
+    {
+        return m.RHO == RHO && m.UU == UU && m.U1 == U1 && m.U2 == U2 && m.U3 == U3 &&
+               m.B1 == B1 && m.B2 == B2 && m.B3 == B3 && m.Bf1 == Bf1 && m.Bf2 == Bf2 && m.Bf3 == Bf3 &&
+               m.RHO_ADDED == RHO_ADDED && m.UU_ADDED == UU_ADDED && m.PASSIVE == PASSIVE &&
+               m.KTOT == KTOT && m.K_CONSTANT == K_CONSTANT && m.K_HOWES == K_HOWES && m.K_KAWAZURA == K_KAWAZURA &&
+               m.K_WERNER == K_WERNER && m.K_ROWAN == K_ROWAN && m.K_SHARMA == K_SHARMA &&
+               m.PSI == PSI && m.Q == Q && m.DP == DP;
+    }
+};
+
+// Fixed layouts.  Parthenon packs variables in order of their names, which for both
+// prims.* and cons.* gives B, dP, q, rho, u, uvec
+enum class Layout{none, grhd, grmhd, egrmhd};
+namespace Layouts {
+using GRHD   = StaticVarMap<0, 1, 2, -1>;
+using GRMHD  = StaticVarMap<3, 4, 5, 0>;
+using EGRMHD = StaticVarMap<5, 6, 7, 0, 4, 3>;
+}
+
+/**
+ * Find the compile-time layout which primitives m_p and conserved variables m_u *both* follow,
+ * or Layout::none if there isn't one and kernels should use the runtime VarMaps.
+ * Comparison is of every index VarMap knows, so kernels see the same variables either way.
+ */
+inline Layout MatchLayout(const VarMap& m_p, const VarMap& m_u)
+{
+    if (Layouts::GRMHD::Matches(m_p) && Layouts::GRMHD::Matches(m_u)) return Layout::grmhd;
+    if (Layouts::GRHD::Matches(m_p) && Layouts::GRHD::Matches(m_u)) return Layout::grhd;
+    if (Layouts::EGRMHD::Matches(m_p) && Layouts::EGRMHD::Matches(m_u)) return Layout::egrmhd;
+    return Layout::none;
+}
+
 #if DEBUG
 /**
  * Function to generate outputs wherever, whenever.
@@ -223,16 +302,31 @@ inline void OutputNow(Mesh *pmesh, std::string name)
 /**
  * Functions for "tracing" execution by printing strings at each entry/exit.
  * Normally, they profile the code, but they can print a nested execution trace.
+ * Either way, they also feed the wall-clock timers in timers.hpp when those are enabled.
  * 
  * Don't laugh at my dumb mutex, it works.
+ *
+ * Labels are best passed as literals, or as parts, e.g. Flag("GetFlux_", dir): either way, the
+ * std::string label is only built if something is listening, see FlagsActive.
  */
+
+/**
+ * Whether a Flag() has anywhere to go: a Kokkos tool is loaded, or timers or tracing are on.
+ * Tools load when Kokkos is initialized, so this is fixed before the first step
+ */
+inline bool FlagsActive()
+{
+    return TRACE || Timers::enabled || Kokkos::Profiling::profileLibraryLoaded();
+}
+
 #if TRACE
 // Can we namespace these?
 extern int kharma_debug_trace_indent;
 extern int kharma_debug_trace_mutex;
 #define MAX_INDENT_SPACES 80
-inline void Flag(std::string label)
+inline void Flag(const std::string& label)
 {
+    if (Timers::enabled) Timers::Push(label);
     if(MPIRank0()) {
         int& indent = kharma_debug_trace_indent;
         int& mutex = kharma_debug_trace_mutex;
@@ -254,6 +348,7 @@ inline void Flag(std::string label)
 }
 inline void EndFlag()
 {
+    if (Timers::enabled) Timers::Pop();
     if(MPIRank0()) {
         int& indent = kharma_debug_trace_indent;
         int& mutex = kharma_debug_trace_mutex;
@@ -267,12 +362,38 @@ inline void EndFlag()
     }
 }
 #else
-inline void Flag(std::string label)
+inline void Flag(const std::string& label)
 {
+    if (Timers::enabled) Timers::Push(label);
     Kokkos::Profiling::pushRegion(label);
 }
 inline void EndFlag()
 {
+    if (!FlagsActive()) return;
     Kokkos::Profiling::popRegion();
+    if (Timers::enabled) Timers::Pop();
 }
 #endif
+
+inline void Flag(const char* label)
+{
+    if (FlagsActive()) Flag(std::string(label));
+}
+
+namespace FlagLabel {
+inline void Append(std::string& label, const std::string& part) { label += part; }
+inline void Append(std::string& label, const char* part) { label += part; }
+inline void Append(std::string& label, const int& part) { label += std::to_string(part); }
+}
+/**
+ * Flag a region labelled by its parts run together, e.g. Flag("BlockUtoP_", package_name)
+ */
+template<typename Part, typename... Parts>
+inline void Flag(const char* first, const Part& part, const Parts&... parts)
+{
+    if (!FlagsActive()) return;
+    std::string label(first);
+    FlagLabel::Append(label, part);
+    (FlagLabel::Append(label, parts), ...);
+    Flag(label);
+}
@@ -59,24 +59,34 @@ std::shared_ptr<KHARMAPackage> Wind::Initialize(ParameterInput *pin, std::shared
     return pkg;
 }
 
-TaskStatus Wind::AddSource(MeshData<Real> *md, MeshData<Real> *mdudt)
+Wind::Source Wind::GetSource(Packages_t& packages)
 {
-    // Pointers
-    auto pmesh = mdudt->GetMeshPointer();
-    auto pmb0 = mdudt->GetBlockData(0)->GetBlockPointer();
     // Options
-    const auto& gpars = pmb0->packages.Get("GRMHD")->AllParams();
-    const auto& pars = pmb0->packages.Get("Wind")->AllParams();
-    const auto& globals = pmb0->packages.Get("Globals")->AllParams();
-    const Real gam = gpars.Get<Real>("gamma");
+    const auto& gpars = packages.Get("GRMHD")->AllParams();
+    const auto& pars = packages.Get("Wind")->AllParams();
+    const auto& globals = packages.Get("Globals")->AllParams();
     const Real n = pars.Get<Real>("ne");
-    const Real Tp = pars.Get<Real>("Tp");
-    const Real u1 = pars.Get<Real>("u1");
-    const int power = pars.Get<int>("power");
     const Real ramp_start = pars.Get<Real>("ramp_start");
     const Real ramp_end = pars.Get<Real>("ramp_end");
     const Real time = globals.Get<Real>("time");
 
+    Source src;
+    src.gam = gpars.Get<Real>("gamma");
+    src.n = n;
+    src.Tp = pars.Get<Real>("Tp");
+    src.u1 = pars.Get<Real>("u1");
+    src.power = pars.Get<int>("power");
+    // Set the wind via linear ramp-up with time, if enabled
+    src.current_n = (ramp_end > 0.0) ? m::min(m::max(time - ramp_start, 0.0) / (ramp_end - ramp_start), 1.0) * n : n;
+    return src;
+}
+
+TaskStatus Wind::AddSource(MeshData<Real> *md, MeshData<Real> *mdudt)
+{
+    // Pointers
+    auto pmb0 = mdudt->GetBlockData(0)->GetBlockPointer();
+    const Source wind = GetSource(pmb0->packages);
+
     // Pack variables
     PackIndexMap cons_map;
     auto dUdt = mdudt->PackVariables(std::vector<MetadataFlag>{Metadata::Conserved}, cons_map);
@@ -87,36 +97,16 @@ TaskStatus Wind::AddSource(MeshData<Real> *md, MeshData<Real> *mdudt)
     const IndexRange kb = mdudt->GetBoundsK(IndexDomain::interior);
     const IndexRange block = IndexRange{0, dUdt.GetDim(5) - 1};
 
-    // Set the wind via linear ramp-up with time, if enabled
-    const Real current_n = (ramp_end > 0.0) ? m::min(m::max(time - ramp_start, 0.0) / (ramp_end - ramp_start), 1.0) * n : n;
-
     pmb0->par_for("add_wind", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA (const int& b, const int &k, const int &j, const int &i) {
             const auto& G = dUdt.GetCoords(b);
-            // Need coordinates to evaluate particle addtn rate
-            // Note that makes the wind spherical-only, TODO ensure this
-            GReal Xembed[GR_DIM];
-            G.coord_embed(k, j, i, Loci::center, Xembed);
-            GReal r = Xembed[1], th = Xembed[2];
-
-            // Particle addition rate: concentrate at poles
-            Real drhopdt = current_n * m::pow(m::cos(th), power) / SQR(1. + r * r);
-
-            // Insert fluid moving in positive U1, without B field
-            // Ramp up like density, since we're not at a set proportion
-            const Real uvec[NVEC] = {current_n / n * u1, 0, 0};
-            const Real B_P[NVEC] = {0};
-
-            // Add plasma to the T^t_a component of the stress-energy tensor
-            // Notice that U already contains a factor of sqrt{-g}
-            Real rho_ut, T[GR_DIM];
-            GRMHD::p_to_u_mhd(G, drhopdt, drhopdt * Tp * 3., uvec, B_P, gam, k, j, i, rho_ut, T);
-
-            dUdt(b, m_u.RHO, k, j, i) += rho_ut;
-            dUdt(b, m_u.UU, k, j, i) += T[0];
-            dUdt(b, m_u.U1, k, j, i) += T[1];
-            dUdt(b, m_u.U2, k, j, i) += T[2];
-            dUdt(b, m_u.U3, k, j, i) += T[3];
+            Real dU[Source::nvar] = {0};
+            wind(G, k, j, i, dU);
+            dUdt(b, m_u.RHO, k, j, i) += dU[0];
+            dUdt(b, m_u.UU, k, j, i) += dU[1];
+            dUdt(b, m_u.U1, k, j, i) += dU[2];
+            dUdt(b, m_u.U2, k, j, i) += dU[3];
+            dUdt(b, m_u.U3, k, j, i) += dU[4];
         }
     );
 
@@ -45,7 +45,57 @@ namespace Wind {
 std::shared_ptr<KHARMAPackage> Initialize(ParameterInput *pin, std::shared_ptr<Packages_t>& packages);
 
 /**
- * Add the wind source term.  Applied in Flux::AddSource, just after the FluxDivergence calculation
+ * Wind source term in one zone, as a device-callable functor.  Holds everything it needs by value,
+ * so it can be composed into other source kernels: Flux::AddGeoSource applies it in the same sweep
+ * as the geometric source term.
+ */
+struct Source {
+    // rho u^t, T^t_t, T^t_i
+    static constexpr int nvar = 5;
+    Real gam, n, current_n, Tp, u1;
+    int power;
+
+    /**
+     * Add the wind contribution to dU = {rho u^t, T^t_t, T^t_1, T^t_2, T^t_3} in zone (k, j, i)
+     */
+    KOKKOS_INLINE_FUNCTION void operator()(const GRCoordinates& G, const int& k, const int& j, const int& i,
+                                           Real dU[nvar]) const
+    {
+        // Need coordinates to evaluate particle addtn rate
+        // Note that makes the wind spherical-only, TODO ensure this
+        GReal Xembed[GR_DIM];
+        G.coord_embed(k, j, i, Loci::center, Xembed);
+        GReal r = Xembed[1], th = Xembed[2];
+
+        // Particle addition rate: concentrate at poles
+        Real drhopdt = current_n * m::pow(m::cos(th), power) / SQR(1. + r * r);
+
+        // Insert fluid moving in positive U1, without B field
+        // Ramp up like density, since we're not at a set proportion
+        const Real uvec[NVEC] = {current_n / n * u1, 0, 0};
+        const Real B_P[NVEC] = {0};
+
+        // Add plasma to the T^t_a component of the stress-energy tensor
+        // Notice that U already contains a factor of sqrt{-g}
+        Real rho_ut, T[GR_DIM];
+        GRMHD::p_to_u_mhd(G, drhopdt, drhopdt * Tp * 3., uvec, B_P, gam, k, j, i, rho_ut, T);
+
+        dU[0] += rho_ut;
+        dU[1] += T[0];
+        dU[2] += T[1];
+        dU[3] += T[2];
+        dU[4] += T[3];
+    }
+};
+
+/**
+ * Build the wind source functor for the current time, including any linear ramp-up
+ */
+Source GetSource(Packages_t& packages);
+
+/**
+ * Add the wind source term in its own kernel.  Only registered with Parthenon when the wind
+ * can't be applied with the geometric source, see Flux::AddGeoSource
  */
 TaskStatus AddSource(MeshData<Real> *md, MeshData<Real> *mdudt);
 
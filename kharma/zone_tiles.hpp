@@ -0,0 +1,89 @@
+/* 
+ *  File: zone_tiles.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2024, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+#include "types.hpp"
+
+/**
+ * Zone-major tiles of variable packs, for per-zone solvers working in team scratch.
+ *
+ * Parthenon stores variables variable-major, so reading all nvar variables of one zone is
+ * nvar strided loads.  These copy a row of zones into a ScratchPad2D shaped (n1, nvar),
+ * flattening over (variable, zone) with zones fastest so that a team's global reads/writes
+ * coalesce, after which each thread can slice out its own zone as a contiguous vector.
+ * Tiles are indexed by the absolute i index, so a tile covering [is, ie] must have n1 > ie.
+ * Unallocated (sparse) variables load as zero and are not stored.
+ *
+ * Both functions must be called by the whole team, and neither includes a barrier.
+ */
+namespace ZoneTiles {
+
+/**
+ * Copy variables [0, nvar) of zones [is, ie] of row (k, j) of pack q into tile(i, ip)
+ */
+template<typename Pack>
+KOKKOS_INLINE_FUNCTION void load(const parthenon::team_mbr_t& member, const Pack& q, const int& nvar,
+                                 const int& k, const int& j, const int& is, const int& ie,
+                                 const ScratchPad2D<Real>& tile)
+{
+    const int n = ie - is + 1;
+    parthenon::par_for_inner(member, 0, n*nvar - 1,
+        [&](const int& idx) {
+            const int ip = idx / n;
+            const int i = is + idx % n;
+            tile(i, ip) = var_allocated(q, ip) ? q(ip, k, j, i) : 0.;
+        }
+    );
+}
+
+/**
+ * Copy tile(i, ip) back into variables [0, nvar) of zones [is, ie] of row (k, j) of pack q
+ */
+template<typename Pack>
+KOKKOS_INLINE_FUNCTION void store(const parthenon::team_mbr_t& member, const ScratchPad2D<Real>& tile, const int& nvar,
+                                  const int& k, const int& j, const int& is, const int& ie,
+                                  const Pack& q)
+{
+    const int n = ie - is + 1;
+    parthenon::par_for_inner(member, 0, n*nvar - 1,
+        [&](const int& idx) {
+            const int ip = idx / n;
+            const int i = is + idx % n;
+            if (var_allocated(q, ip)) q(ip, k, j, i) = tile(i, ip);
+        }
+    );
+}
+
+} // namespace ZoneTiles
@@ -22,6 +22,11 @@
 # noimplicit: Disable implicit solver, avoids pulling in Kokkos-kernels
 # nocleanup:  Disable magnetic field cleaning code for resizing, avoids
 #             pulling in some unofficial Parthenon code.
+# bench:      Also build the kernel micro-benchmarks, kharma_bench
+# single:     Evolve fields in single precision (geometry stays double).
+#             Run tests/mhdmodes with SINGLE_PRECISION=1 to check accuracy
+# tune:       Enable Kokkos' tuning interface, exposing MDRange tile sizes & team sizes
+#             of every kernel to a Kokkos Tools tuner.  Run with "run.sh tune"
 # Many machine files have additional options, check machines/machinename.sh
 
 # Make processes to use
@@ -72,6 +77,12 @@ fi
 if [[ "$ARGS" == *"nocleanup"* ]]; then
   EXTRA_FLAGS="-DKHARMA_DISABLE_CLEANUP=1 $EXTRA_FLAGS"
 fi
+if [[ "$ARGS" == *"single"* ]]; then
+  EXTRA_FLAGS="-DKHARMA_SINGLE_PRECISION=1 $EXTRA_FLAGS"
+fi
+if [[ "$ARGS" == *"tune"* ]]; then
+  EXTRA_FLAGS="-DKokkos_ENABLE_TUNING=ON $EXTRA_FLAGS"
+fi
 
 ### Enivoronment Prep ###
 if [[ "$(which python3 2>/dev/null)" == *"conda"* ]]; then
@@ -344,4 +355,8 @@ fi
 if [[ "$ARGS" != *"dryrun"* ]]; then
   make -j$NPROC
   cp kharma/kharma.* ..
+  if [[ "$ARGS" == *"bench"* ]]; then
+    make -j$NPROC kharma_bench
+    cp kharma/kharma_bench ..
+  fi
 fi
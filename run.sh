@@ -32,9 +32,10 @@ elif [ -f $KHARMA_DIR/kharma.hip ]; then
   EXE_NAME=kharma.hip
 elif [ -f $KHARMA_DIR/kharma.host ]; then
   EXE_NAME=kharma.host
-  # Enable OpenMP to use all threads only where not counterproductive
-  #export OMP_PROC_BIND=${OMP_PROC_BIND:-spread}
-  #export OMP_PLACES=${OMP_PLACES:-threads}
+  # Bind OpenMP threads, so arrays stay in the memory of the socket whose threads first touched them.
+  # KHARMA reports the binding at startup
+  export OMP_PROC_BIND=${OMP_PROC_BIND:-spread}
+  export OMP_PLACES=${OMP_PLACES:-threads}
   # Force a number of OpenMP threads if it doesn't autodetect
   #export OMP_NUM_THREADS=${OMP_NUM_THREADS:-28}
 else
@@ -63,6 +64,18 @@ if [[ "$1" == "nvprof" ]]; then
   export KOKKOS_TOOLS_LIBS=$KHARMA_DIR/../kokkos-tools/kp_nvprof_connector.so
   shift
 fi
+# Tune kernel tile & team sizes with a Kokkos Tools tuner, e.g. APEX, for builds with "./make.sh tune".
+# Point KOKKOS_TUNING_LIB at the tuner, and have it keep its results per machine to reuse them next run
+TUNE_ARGS=
+if [[ "$1" == "tune" ]]; then
+  if [[ -z "$KOKKOS_TUNING_LIB" ]]; then
+    echo "Set KOKKOS_TUNING_LIB to a Kokkos Tools tuning library to tune kernels!"
+    exit 1
+  fi
+  export KOKKOS_TOOLS_LIBS=$KOKKOS_TUNING_LIB
+  TUNE_ARGS="--kokkos-tune-internals"
+  shift
+fi
 
 # Override MPI_NUM_PROCS at user option "-n"
 # and OMP_NUM_THREADS at option "-nt"
@@ -87,9 +100,9 @@ fi
 
 # Run based on preferences
 if [ -z "$MPI_EXE" ]; then
-  echo "Running $KHARMA_DIR/$EXE_NAME $@"
-  exec $KHARMA_DIR/$EXE_NAME "$@"
+  echo "Running $KHARMA_DIR/$EXE_NAME $TUNE_ARGS $@"
+  exec $KHARMA_DIR/$EXE_NAME $TUNE_ARGS "$@"
 else
-  echo "Running $MPI_EXE -n $MPI_NUM_PROCS $MPI_EXTRA_ARGS $KHARMA_DIR/$EXE_NAME $@"
-  exec $MPI_EXE -n $MPI_NUM_PROCS $MPI_EXTRA_ARGS $KHARMA_DIR/$EXE_NAME "$@"
+  echo "Running $MPI_EXE -n $MPI_NUM_PROCS $MPI_EXTRA_ARGS $KHARMA_DIR/$EXE_NAME $TUNE_ARGS $@"
+  exec $MPI_EXE -n $MPI_NUM_PROCS $MPI_EXTRA_ARGS $KHARMA_DIR/$EXE_NAME $TUNE_ARGS "$@"
 fi
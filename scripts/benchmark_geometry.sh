@@ -0,0 +1,29 @@
+#!/bin/bash
+
+# Compare cached (double & single precision) vs. on-the-fly metric evaluation on the SANE benchmark
+# Usage: scripts/benchmark_geometry.sh [-- extra parameters]
+# e.g. scripts/benchmark_geometry.sh -- parthenon/time/nlim=100
+# Prints the zone-cycles/wallsecond reported by Parthenon for each mode, and the faster one
+
+KHARMA_DIR="$(dirname "${BASH_SOURCE[0]}")/.."
+
+[[ "$1" == "--" ]] && shift
+
+# Short runs, no dumps
+COMMON="parthenon/time/nlim=${NLIM:-100} parthenon/output0/dt=1e10 parthenon/output1/dt=1e10 debug/verbose=0"
+
+best=""
+best_zcps=0
+for mode in "compute_metric=false" "compute_metric=false geometry_precision=single" "compute_metric=true"; do
+  opts=""
+  for opt in $mode; do opts="$opts coordinates/$opt"; done
+  tag=$(echo $mode | tr ' =' '_-')
+  $KHARMA_DIR/run.sh -i $KHARMA_DIR/pars/benchmark/sane_perf.par $opts $COMMON "$@" > bench_geom_${tag}.txt 2>&1
+  zcps=$(grep "zone-cycles/wallsecond" bench_geom_${tag}.txt | tail -1 | awk '{print $NF}')
+  echo "$mode: ${zcps:-FAILED} zone-cycles/wallsecond"
+  if [[ -n "$zcps" ]] && awk "BEGIN {exit !($zcps > $best_zcps)}"; then
+    best=$mode
+    best_zcps=$zcps
+  fi
+done
+[[ -n "$best" ]] && echo "Fastest on this machine: $best"
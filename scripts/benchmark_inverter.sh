@@ -0,0 +1,27 @@
+#!/bin/bash
+
+# Compare the speed of different primitive variable inverters on the SANE benchmark
+# Usage: scripts/benchmark_inverter.sh [type1 type2 ...] [-- extra parameters]
+# e.g. scripts/benchmark_inverter.sh onedw onedw_analytic -- parthenon/time/nlim=100
+# Prints the zone-cycles/wallsecond reported by Parthenon for each inverter
+
+KHARMA_DIR="$(dirname "${BASH_SOURCE[0]}")/.."
+
+TYPES=()
+while [[ $# -gt 0 && "$1" != "--" ]]; do
+  TYPES+=("$1")
+  shift
+done
+[[ "$1" == "--" ]] && shift
+if [[ ${#TYPES[@]} -eq 0 ]]; then
+  TYPES=(onedw onedw_analytic kastaun)
+fi
+
+# Short runs, no dumps
+COMMON="parthenon/time/nlim=${NLIM:-100} parthenon/output0/dt=1e10 parthenon/output1/dt=1e10 debug/verbose=0"
+
+for type in "${TYPES[@]}"; do
+  $KHARMA_DIR/run.sh -i $KHARMA_DIR/pars/benchmark/sane_perf.par inverter/type=$type $COMMON "$@" > bench_inverter_${type}.txt 2>&1
+  zcps=$(grep "zone-cycles/wallsecond" bench_inverter_${type}.txt | tail -1 | awk '{print $NF}')
+  echo "$type: ${zcps:-FAILED} zone-cycles/wallsecond"
+done
@@ -0,0 +1,27 @@
+#!/bin/bash
+
+# Compare the speed of different reconstruction schemes on the SANE benchmark
+# Usage: scripts/benchmark_reconstruction.sh [recon1 recon2 ...] [-- extra parameters]
+# e.g. scripts/benchmark_reconstruction.sh weno5 weno5_batched -- parthenon/time/nlim=100
+# Prints the zone-cycles/wallsecond reported by Parthenon for each scheme
+
+KHARMA_DIR="$(dirname "${BASH_SOURCE[0]}")/.."
+
+RECONS=()
+while [[ $# -gt 0 && "$1" != "--" ]]; do
+  RECONS+=("$1")
+  shift
+done
+[[ "$1" == "--" ]] && shift
+if [[ ${#RECONS[@]} -eq 0 ]]; then
+  RECONS=(weno5 weno5_batched linear_mc)
+fi
+
+# Short runs, no dumps
+COMMON="parthenon/time/nlim=${NLIM:-100} parthenon/output0/dt=1e10 parthenon/output1/dt=1e10 debug/verbose=0"
+
+for recon in "${RECONS[@]}"; do
+  $KHARMA_DIR/run.sh -i $KHARMA_DIR/pars/benchmark/sane_perf.par driver/reconstruction=$recon $COMMON "$@" > bench_recon_${recon}.txt 2>&1
+  zcps=$(grep "zone-cycles/wallsecond" bench_recon_${recon}.txt | tail -1 | awk '{print $NF}')
+  echo "$recon: ${zcps:-FAILED} zone-cycles/wallsecond"
+done
@@ -0,0 +1,72 @@
+#!/bin/bash
+
+# Run an ensemble of small, independent simulations concurrently on one node/device
+# Usage: scripts/ensemble.sh -i input.par -f members.txt [-j concurrent] [-d outdir] [-- common parameters]
+#   members.txt: one member per line, as a name followed by its parameter overrides, e.g.
+#     a0.5_b100  coordinates/a=0.5 bondi/beta=100
+#     a0.9_b100  coordinates/a=0.9 bondi/beta=100
+#   Blank lines and lines starting with '#' are skipped.
+# Each member runs with run.sh in its own directory outdir/name, logging to outdir/name/kharma.log.
+# Up to -j members (default 4) run at once.  On NVIDIA devices, starting the CUDA MPS daemon
+# (ENSEMBLE_MPS=1) lets their kernels overlap, so small 2D runs together can fill the device.
+# Prints a table of each member's exit status and wall time once all have finished.
+# e.g. scripts/ensemble.sh -i pars/tori_2d/sane.par -f spins.txt -j 8 -- parthenon/time/tlim=1000
+
+KHARMA_DIR="$(readlink -f "$(dirname "${BASH_SOURCE[0]}")/..")"
+
+PARFILE=
+MEMBERS=
+NCONCURRENT=4
+OUTDIR=ensemble
+while [[ $# -gt 0 && "$1" != "--" ]]; do
+  case $1 in
+    -i) PARFILE=$(readlink -f $2); shift;;
+    -f) MEMBERS=$(readlink -f $2); shift;;
+    -j) NCONCURRENT=$2; shift;;
+    -d) OUTDIR=$2; shift;;
+  esac
+  shift
+done
+[[ "$1" == "--" ]] && shift
+if [[ -z "$PARFILE" || -z "$MEMBERS" ]]; then
+  echo "Usage: $0 -i input.par -f members.txt [-j concurrent] [-d outdir] [-- common parameters]"
+  exit 1
+fi
+
+if [[ "${ENSEMBLE_MPS:-0}" == "1" ]]; then
+  export CUDA_MPS_PIPE_DIRECTORY=${CUDA_MPS_PIPE_DIRECTORY:-/tmp/kharma-mps-pipe-$$}
+  export CUDA_MPS_LOG_DIRECTORY=${CUDA_MPS_LOG_DIRECTORY:-/tmp/kharma-mps-log-$$}
+  mkdir -p $CUDA_MPS_PIPE_DIRECTORY $CUDA_MPS_LOG_DIRECTORY
+  nvidia-cuda-mps-control -d
+  trap 'echo quit | nvidia-cuda-mps-control' EXIT
+fi
+
+mkdir -p $OUTDIR
+NAMES=()
+while read -r name overrides; do
+  [[ -z "$name" || "$name" == \#* ]] && continue
+  # Wait for a free slot
+  while (( $(jobs -rp | wc -l) >= NCONCURRENT )); do
+    wait -n
+  done
+  mkdir -p $OUTDIR/$name
+  echo "Starting $name: $overrides"
+  # Record each member's status & wall time itself, as 'wait -n' above can reap it early
+  (
+    cd $OUTDIR/$name
+    start=$(date +%s)
+    $KHARMA_DIR/run.sh -i $PARFILE $overrides "$@" </dev/null >kharma.log 2>&1
+    echo "$? $(( $(date +%s) - start ))" > status
+  ) &
+  NAMES+=($name)
+done < $MEMBERS
+wait
+
+exit_code=0
+printf "%-24s %8s %10s\n" "member" "status" "wall (s)"
+for name in "${NAMES[@]}"; do
+  read status wall < $OUTDIR/$name/status
+  printf "%-24s %8s %10s\n" $name $status $wall
+  [[ $status != 0 ]] && exit_code=1
+done
+exit $exit_code
@@ -0,0 +1,79 @@
+#!/bin/bash
+
+# Weak or strong scaling sweep of the torus in pars/benchmark/scaling_torus.par
+# Usage: scripts/scaling.sh weak|strong [-s size] [-r "1 2 4 8"] [-- extra parameters]
+#   strong: total mesh size^3, split evenly over the ranks
+#   weak: meshblocks of size^3, one per rank
+# Runs in benchmark mode (no outputs or extra checks), timing only steps after driver/benchmark_warmup,
+# then prints a table of throughput and parallel efficiency relative to the smallest run.
+# Ranks are launched with run.sh -n, so set MPI_EXE etc. as for run.sh (or in machines/*.sh)
+# e.g. scripts/scaling.sh strong -s 256 -r "1 8 64" -- parthenon/time/nlim=60
+
+KHARMA_DIR="$(dirname "${BASH_SOURCE[0]}")/.."
+
+MODE=$1
+shift
+if [[ "$MODE" != "weak" && "$MODE" != "strong" ]]; then
+  echo "Usage: $0 weak|strong [-s size] [-r \"ranks list\"] [-- extra parameters]"
+  exit 1
+fi
+SIZE=128
+RANKS="1 2 4 8"
+while [[ $# -gt 0 && "$1" != "--" ]]; do
+  case $1 in
+    -s) SIZE=$2; shift;;
+    -r) RANKS=$2; shift;;
+  esac
+  shift
+done
+[[ "$1" == "--" ]] && shift
+
+COMMON="driver/benchmark=true driver/benchmark_warmup=${WARMUP:-10} parthenon/time/nlim=${NLIM:-110}"
+
+# Split a power-of-two number of ranks into per-dimension factors, cycling through X3, X2, X1
+# as in scripts/batch/scaling_*.sb
+factors() {
+  local np=$1 m1=1 m2=1 m3=1 dim=3
+  while (( m1 * m2 * m3 < np )); do
+    case $dim in
+      3) m3=$(( m3 * 2 )); dim=2;;
+      2) m2=$(( m2 * 2 )); dim=1;;
+      1) m1=$(( m1 * 2 )); dim=3;;
+    esac
+  done
+  echo "$m1 $m2 $m3"
+}
+
+RESULTS=()
+for np in $RANKS; do
+  read m1 m2 m3 <<< $(factors $np)
+  if [[ "$MODE" == "strong" ]]; then
+    n1=$SIZE; n2=$SIZE; n3=$SIZE
+    b1=$(( SIZE / m1 )); b2=$(( SIZE / m2 )); b3=$(( SIZE / m3 ))
+  else
+    b1=$SIZE; b2=$SIZE; b3=$SIZE
+    n1=$(( SIZE * m1 )); n2=$(( SIZE * m2 )); n3=$(( SIZE * m3 ))
+  fi
+  out=scaling_${MODE}_${SIZE}_${np}.txt
+  $KHARMA_DIR/run.sh -n $np -i $KHARMA_DIR/pars/benchmark/scaling_torus.par $COMMON \
+    parthenon/mesh/nx1=$n1 parthenon/mesh/nx2=$n2 parthenon/mesh/nx3=$n3 \
+    parthenon/meshblock/nx1=$b1 parthenon/meshblock/nx2=$b2 parthenon/meshblock/nx3=$b3 "$@" > $out 2>&1
+  zcps=$(grep "^Benchmark:" $out | tail -1 | sed 's/.* zone-cycles\/s=\([^ ]*\).*/\1/')
+  RESULTS+=("$np ${n1}x${n2}x${n3} ${b1}x${b2}x${b3} ${zcps:-FAILED}")
+done
+
+# Efficiency: strong compares total throughput to ideal linear speedup, weak compares throughput per rank
+printf "%8s %16s %16s %16s %16s %12s\n" ranks mesh meshblock zone-cycles/s per-rank efficiency
+base=""
+for result in "${RESULTS[@]}"; do
+  read np mesh block zcps <<< "$result"
+  if [[ "$zcps" == "FAILED" ]]; then
+    printf "%8s %16s %16s %16s\n" $np $mesh $block FAILED
+    continue
+  fi
+  [[ -z "$base" ]] && base="$np $zcps"
+  read np0 zcps0 <<< "$base"
+  awk -v np=$np -v mesh=$mesh -v block=$block -v z=$zcps -v np0=$np0 -v z0=$zcps0 -v mode=$MODE 'BEGIN {
+    eff = (mode == "strong") ? (z / z0) / (np / np0) : (z / np) / (z0 / np0);
+    printf "%8d %16s %16s %16.4g %16.4g %11.1f%%\n", np, mesh, block, z, z / np, 100 * eff }'
+done
@@ -51,6 +51,25 @@ conv_2d linear_mc GRMHD/reconstruction=linear_mc "in 2D, linear recon with MC li
 conv_2d imex driver/type=imex "in 2D, with Imex driver"
 conv_2d imex_im "driver/type=imex GRMHD/implicit=true" "in 2D, semi-implicit stepping"
 
+# Divergence and geometric source in one kernel
+conv_2d fused_geo flux/fused_geo_source=true "in 2D, fused geometric source"
+# UtoP and floors in one kernel
+conv_2d fused_floors inverter/fuse_floors=true "in 2D, floors fused with inversion"
+# End-of-stage PtoU only in fixed zones
+conv_2d ptou_changed flux/ptou_changed_only=true "in 2D, PtoU only where primitives were fixed"
+# Geometric source from cached four-vectors
+conv_2d cache_4vecs GRMHD/cache_4vecs=true "in 2D, cached four-vectors"
+# Backup inversion from an advected entropy
+conv_2d entropy_fallback inverter/entropy_fallback=true "in 2D, with entropy backup inversion"
+# Passive tracer particles cross blocks & leave through the inner edge, without touching the fluid
+conv_2d tracers "tracers/on=true tracers/dt=10" "in 2D, with tracer particles"
+# In-situ snapshots, including an output-only geometry field
+conv_2d in_situ "in_situ/on=true in_situ/variables=prims.rho,prims.uvec,coords.r" "in 2D, with in-situ snapshots"
+conv_2d averages "averages/on=true averages/second_moments=true averages/cadence=2" "in 2D, with running averages"
+conv_2d analysis_grid "analysis_grid/on=true analysis_grid/dt=10 analysis_grid/variables=prims.rho,prims.u,prims.uvec" "in 2D, with analysis grid snapshots"
+# Ghost zones of the fluid primitives exchanged in float32
+conv_2d float_halo "float_halo/variables=prims.rho,prims.u,prims.uvec" "in 2D, with float32 halo exchange"
+
 # TODO 3D, esp magnetized w/flux, face CT
 
 exit $exit_code
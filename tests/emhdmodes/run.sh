@@ -36,6 +36,13 @@ ALL_RES="32,64,128"
 conv_2d emhd2d_weno driver/reconstruction=weno5 "EMHD mode in 2D, WENO5"
 # Test that higher-order terms don't mess anything up
 conv_2d emhd2d_higher_order emhd/higher_order_terms=true "EMHD mode in 2D, higher order terms enabled"
+conv_2d emhd2d_register "emhd/higher_order_terms=true implicit/register_solve=true" "EMHD mode in 2D, register-resident solve"
+conv_2d emhd2d_batched "emhd/higher_order_terms=true implicit/register_solve=true implicit/batched_solve=true" "EMHD mode in 2D, batched lockstep solve"
+conv_2d emhd2d_mixed "emhd/higher_order_terms=true implicit/register_solve=true implicit/mixed_precision=true implicit/max_nonlinear_iter=5" "EMHD mode in 2D, mixed-precision solve"
+conv_2d emhd2d_skip_converged "emhd/higher_order_terms=true implicit/skip_converged=true implicit/max_nonlinear_iter=5" "EMHD mode in 2D, skipping converged zones"
+conv_2d emhd2d_chord "emhd/higher_order_terms=true implicit/chord=true implicit/max_nonlinear_iter=5" "EMHD mode in 2D, chord iterations"
+conv_2d emhd2d_adaptive "GRMHD/implicit=false implicit/adaptive=true" "EMHD mode in 2D, explicit update of non-stiff zones"
+conv_2d emhd2d_subcycle emhd/subcycle=true "EMHD mode in 2D, subcycled explicit sources in KHARMA driver"
 # Test we can use imex/EMHD and face CT
 conv_2d emhd2d_face_ct b_field/solver=face_ct "EMHD mode in 2D w/Face CT"
 
@@ -26,7 +26,8 @@ print(DIR)
 NVAR = 8
 VARS = ['rho', 'u', 'u1', 'u2', 'u3', 'B1', 'B2', 'B3']
 
-amp = 1.e-4
+# Must match mhdmodes/amp in run.sh
+amp = float(os.environ.get("MHDMODES_AMP", "1.e-4"))
 k1 = 2.*np.pi
 k2 = 2.*np.pi
 if DIM == "3d" and DIR == 0:
@@ -43,5 +43,7 @@ ALL_RES="24,48,96,192"
 conv_2d slow mhdmodes/nmode=1 "slow mode in 2D"
 conv_2d alfven mhdmodes/nmode=2 "Alfven mode in 2D"
 conv_2d fast mhdmodes/nmode=3 "fast mode in 2D"
+# Divergence-preserving prolongation of face fields at refinement boundaries
+conv_2d slow_olivares "mhdmodes/nmode=1 b_field/lazy_prolongation=false" "slow mode in 2D w/Olivares prolongation"
 
 exit $exit_code
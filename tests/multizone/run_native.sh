@@ -0,0 +1,39 @@
+#!/bin/bash
+set -euo pipefail
+
+# Test an in-process multizone run: the same annuli as run.sh, cycled inside
+# one KHARMA run rather than with restarts.  See kharma/multizone/multizone.hpp
+
+KHARMA_DIR=../..
+NZONES=2
+BASE=8
+
+# Full domain covers every annulus
+r_in=1
+r_out=$((${BASE}**(${NZONES}+1)))
+
+# Two switches: outer -> inner -> outer
+run_native() {
+$KHARMA_DIR/run.sh -n 1 -i ./bondi_multizone.par \
+                    parthenon/job/problem_id=bondi \
+                    parthenon/time/tlim=30 \
+                    parthenon/mesh/nx1=64 parthenon/mesh/nx2=32 parthenon/mesh/nx3=1 \
+                    parthenon/meshblock/nx1=32 parthenon/meshblock/nx2=32 parthenon/meshblock/nx3=1 \
+                    coordinates/r_in=${r_in} coordinates/r_out=${r_out} coordinates/transform=exp \
+                    bondi/r_shell=$((${r_out}/2)) b_field/bz=5e-3 b_field/initial_cleanup=false \
+                    multizone/on=true multizone/nzones=$NZONES multizone/base=$BASE multizone/runtime=10 \
+                    parthenon/output0/dt=10 parthenon/output1/dt=1000 parthenon/output2/dt=1 \
+                    $2 -d bondi_multizone_$1 1> log_multizone_${1}_out 2> log_multizone_${1}_err
+
+# Each annulus switch is reported with debug/verbose=1
+switches=$(grep -c "Multizone: activating annulus" log_multizone_${1}_out || true)
+if [[ $switches -lt 3 ]]; then
+    echo "Native multizone test $1 FAIL: only $switches annuli activated"
+    exit 1
+fi
+echo "Native multizone test $1 success"
+}
+
+run_native native ""
+# Frozen state kept in host memory
+run_native native_host "multizone/frozen_on_host=true"
@@ -0,0 +1,54 @@
+#!/usr/bin/env python
+
+# Compare measured throughput against a per-machine baseline
+# Usage: check.py baseline.json log_steps.txt [log_kernels.txt]
+
+import os, sys, re, json
+
+baseline_file = sys.argv[1]
+threshold = float(os.environ.get("PERF_THRESHOLD", 0.1))
+update = os.environ.get("PERF_UPDATE", "0") == "1"
+
+results = {}
+
+# Single summary line printed in benchmark mode, see KHARMADriver::ReportBenchmark
+with open(sys.argv[2]) as f:
+    for line in f:
+        if line.startswith("Benchmark:"):
+            results["full_step"] = float(re.search(r"zone-cycles/s=(\S+)", line).group(1))
+if "full_step" not in results:
+    print("Benchmark run failed, see {}".format(sys.argv[2]))
+    sys.exit(1)
+
+# Table of kernel name, ms/call, zone-updates/s, GB/s from kharma_bench
+if len(sys.argv) > 3 and os.path.exists(sys.argv[3]):
+    table = re.compile(r"^(\S.*?)\s+([0-9.eE+-]+)\s+([0-9.eE+-]+)\s+([0-9.eE+-]+)$")
+    with open(sys.argv[3]) as f:
+        for line in f:
+            match = table.match(line.strip())
+            if match and match.group(1) != "kernel":
+                results[match.group(1)] = float(match.group(3))
+
+if update or not os.path.exists(baseline_file):
+    with open(baseline_file, "w") as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+    print("Wrote new baseline {}".format(baseline_file))
+    sys.exit(0)
+
+with open(baseline_file) as f:
+    baseline = json.load(f)
+
+fail = 0
+for name, base_zcps in sorted(baseline.items()):
+    if name not in results:
+        print("{}: not measured".format(name))
+        continue
+    ratio = results[name] / base_zcps
+    status = "FAIL" if ratio < 1 - threshold else "ok"
+    print("{:28} {:12.4g} zone-cycles/s, {:6.1f}% of baseline {}".format(name, results[name], 100 * ratio, status))
+    if status == "FAIL":
+        fail = 1
+
+if fail:
+    print("Performance dropped more than {}% below baseline in {}".format(100 * threshold, baseline_file))
+sys.exit(fail)
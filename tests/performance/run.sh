@@ -0,0 +1,30 @@
+#!/bin/bash
+set -euo pipefail
+
+# Performance regression test: time the kernel micro-benchmarks (if kharma_bench was built,
+# see make.sh "bench") and a short benchmark-mode run of the SANE torus, then compare
+# zone-cycles/s with the stored baseline for this machine.
+# Machine name defaults to the short hostname; set KHARMA_PERF_MACHINE to override.
+# With no baseline yet, or with PERF_UPDATE=1, the results are saved as the new baseline.
+# Fails if any throughput drops by more than PERF_THRESHOLD (default 0.1) below its baseline
+
+BASE=../..
+MACHINE=${KHARMA_PERF_MACHINE:-$(hostname -s)}
+
+exit_code=0
+
+# Kernel micro-benchmarks
+if [ -f $BASE/kharma_bench ]; then
+  $BASE/kharma_bench -i $BASE/pars/benchmark/sane_perf.par benchmark/nrep=${NREP:-20} > log_kernels.txt 2>&1
+else
+  echo "kharma_bench not found, timing full steps only"
+  rm -f log_kernels.txt
+fi
+
+# Full steps, excluding startup and warmup
+$BASE/run.sh -i $BASE/pars/benchmark/sane_perf.par driver/benchmark=true driver/benchmark_warmup=10 \
+                                                   parthenon/time/nlim=${NLIM:-60} > log_steps.txt 2>&1
+
+python check.py baselines/${MACHINE}.json log_steps.txt log_kernels.txt || exit_code=$?
+
+exit $exit_code
@@ -17,9 +17,15 @@ $KHARMADIR/run.sh -r torus.out1.00000.rhdf parthenon/time/nlim=5 >log_restart_2.
 
 mv torus.out0.final.phdf torus.out0.final.restart.phdf
 
+# Restart again with the full PostInitialize, which should make no difference
+$KHARMADIR/run.sh -r torus.out1.00000.rhdf parthenon/time/nlim=5 restart/fast=false >log_restart_3.txt 2>&1
+
+mv torus.out0.final.phdf torus.out0.final.restart_slow.phdf
+
 # Compare to some high degree of accuracy
 # TODO this was formerly 1e-11, we may need to clean up restarting & sequencing of the first steps
 pyharm diff --rel_tol 1e-9 torus.out0.final.init.phdf torus.out0.final.restart.phdf -o compare_restart
+pyharm diff --rel_tol 1e-9 torus.out0.final.restart.phdf torus.out0.final.restart_slow.phdf -o compare_restart_slow
 # Compare binary. Sometimes works but not worth keeping always
 #h5diff --exclude-path=/Info \
 #       --exclude-path=/Input \
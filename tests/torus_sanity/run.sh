@@ -13,5 +13,7 @@ check_sanity() {
 
 check_sanity imex driver/type=imex
 check_sanity harm driver/type=harm
+# Meshblocks covering all of phi, so the periodic boundary is exchanged within each block
+check_sanity whole_phi "driver/whole_phi_blocks=true debug/comm_report=true"
 
 exit $exit_code